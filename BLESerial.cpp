@@ -34,7 +34,16 @@ void BLESerial::onPassKeyNotify(uint32_t passkey) { bt_passkey_notify_callback(p
 bool BLESerial::onSecurityRequest() { return bt_security_request_callback(); }
 void BLESerial::onAuthenticationComplete(esp_ble_auth_cmpl_t auth_result) { bt_authentication_complete_callback(auth_result); }
 void BLESerial::onConnect(BLEServer *server) { bt_connect_callback(server); }
-void BLESerial::onDisconnect(BLEServer *server) { bt_disconnect_callback(server); ble_server->startAdvertising(); }
+void BLESerial::onDisconnect(BLEServer *server) { fastInterval = false; peerMTU = DEFAULT_MTU; bt_disconnect_callback(server); ble_server->startAdvertising(); }
+
+// Called by the BLE stack along with onConnect(server), the parameters carry the peer address
+void BLESerial::onConnect(BLEServer *server, esp_ble_gatts_cb_param_t *param) {
+  memcpy(peerAddress, param->connect.remote_bda, sizeof(esp_bd_addr_t));
+  peerMTU = DEFAULT_MTU;
+  fastInterval = false;
+  // Ask the controller for full size LL packets, the peer MTU is negotiated by the client up to REQUEST_MTU
+  esp_ble_gap_set_pkt_data_len(peerAddress, DLE_TX_OCTETS);
+}
 bool BLESerial::onConfirmPIN(uint32_t pin) { return bt_confirm_pin_callback(pin); };
 bool BLESerial::connected() { return ble_server->getConnectedCount() > 0; }
 
@@ -66,8 +75,16 @@ size_t BLESerial::print(const char *str) {
 }
 
 size_t BLESerial::write(const uint8_t *buffer, size_t bufferSize) {
-  if (ble_server->getConnectedCount() <= 0) { return 0; } else {
-    size_t written = 0; for (int i = 0; i < bufferSize; i++) { written += this->write(buffer[i]); }
+  if (!bt_client_authenticated() || ble_server->getConnectedCount() <= 0) { return 0; } else {
+    size_t written = 0;
+    while (written < bufferSize) {
+      size_t length = maxTransferSize - this->transmitBufferLength;
+      if (length > bufferSize - written) { length = bufferSize - written; }
+      memcpy(this->transmitBuffer + this->transmitBufferLength, buffer + written, length);
+      this->transmitBufferLength += length;
+      written += length;
+      if (this->transmitBufferLength == maxTransferSize) { flush(); }
+    }
     flush();
 
     return written;
@@ -89,13 +106,44 @@ size_t BLESerial::write(uint8_t byte) {
 
 void BLESerial::flush() {
   if (this->transmitBufferLength > 0) {
-    TxCharacteristic->setValue(this->transmitBuffer, this->transmitBufferLength);
+    checkMTU();
+    setFastInterval(true);
+    // Notifications are queued back to back so the controller can send several per connection event
+    size_t chunk = peerMTU - ATT_HEADER_SIZE;
+    for (size_t offset = 0; offset < this->transmitBufferLength; offset += chunk) {
+      size_t length = this->transmitBufferLength - offset;
+      if (length > chunk) { length = chunk; }
+      TxCharacteristic->setValue(this->transmitBuffer + offset, length);
+      TxCharacteristic->notify(true);
+    }
     this->transmitBufferLength = 0;
     this->lastFlushTime = millis();
-    TxCharacteristic->notify(true);
   }
 }
 
+bool BLESerial::checkMTU() {
+  if (ble_server->getConnectedCount() <= 0) { return false; }
+  uint16_t mtu = ble_server->getPeerMTU(ble_server->getConnId());
+  if (mtu < DEFAULT_MTU) { mtu = DEFAULT_MTU; }
+  if (mtu > BLE_BUFFER_SIZE + ATT_HEADER_SIZE) { mtu = BLE_BUFFER_SIZE + ATT_HEADER_SIZE; }
+  peerMTU = mtu;
+  return peerMTU >= MIN_MTU;
+}
+
+void BLESerial::setFastInterval(bool fast) {
+  if (fast != fastInterval && ble_server->getConnectedCount() > 0) {
+    if (fast) { ble_server->updateConnParams(peerAddress, FAST_INTERVAL_MIN, FAST_INTERVAL_MAX, 0, SUPERVISION_TIMEOUT); }
+    else      { ble_server->updateConnParams(peerAddress, IDLE_INTERVAL_MIN, IDLE_INTERVAL_MAX, 0, SUPERVISION_TIMEOUT); }
+    fastInterval = fast;
+  }
+}
+
+void BLESerial::updateConnection() {
+  unsigned long now = millis();
+  bool active = (now - this->lastFlushTime < FAST_INTERVAL_HOLD_MS) || (now - this->lastRxTime < FAST_INTERVAL_HOLD_MS);
+  if (active != fastInterval) { setFastInterval(active); }
+}
+
 void BLESerial::disconnect() {
   if (ble_server->getConnectedCount() > 0) {
     uint16_t conn_id = ble_server->getConnId();
@@ -110,6 +158,7 @@ void BLESerial::disconnect() {
 void BLESerial::begin(const char *name) {
   ConnectedDeviceCount = 0;
   BLEDevice::init(name);
+  BLEDevice::setMTU(REQUEST_MTU);
 
   esp_ble_tx_power_set(ESP_BLE_PWR_TYPE_DEFAULT, ESP_PWR_LVL_P9); 
   esp_ble_tx_power_set(ESP_BLE_PWR_TYPE_ADV, ESP_PWR_LVL_P9);
@@ -144,6 +193,7 @@ void BLESerial::onWrite(BLECharacteristic *characteristic) {
   if (characteristic->getUUID().toString() == BLE_RX_UUID) {
     auto value = characteristic->getValue();
     for (int i = 0; i < value.length(); i++) { rx_buffer.push(value[i]); }
+    lastRxTime = millis();
   }
 }
 
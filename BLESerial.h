@@ -71,6 +71,19 @@ public:
 #define RX_BUFFER_SIZE 6144
 #define BLE_BUFFER_SIZE 512 // Must fit in max GATT attribute length
 #define MIN_MTU 50
+#define DEFAULT_MTU 23
+#define ATT_HEADER_SIZE 3
+#define REQUEST_MTU 517      // Largest ATT MTU, lets a whole buffer go in one notification
+#define DLE_TX_OCTETS 251    // Largest LL payload with data length extension
+
+// Connection intervals in 1.25 ms units. The fast interval is requested while
+// data is flowing and relaxed again after FAST_INTERVAL_HOLD_MS of no traffic.
+#define FAST_INTERVAL_MIN 6
+#define FAST_INTERVAL_MAX 12
+#define IDLE_INTERVAL_MIN 24
+#define IDLE_INTERVAL_MAX 48
+#define SUPERVISION_TIMEOUT 400
+#define FAST_INTERVAL_HOLD_MS 2000
 
 class BLESerial : public BLECharacteristicCallbacks, public BLEServerCallbacks, public BLESecurityCallbacks, public Stream {
 public:
@@ -91,6 +104,7 @@ public:
   size_t print(const char *value);
   void flush();
   void onConnect(BLEServer *server);
+  void onConnect(BLEServer *server, esp_ble_gatts_cb_param_t *param);
   void onDisconnect(BLEServer *server);
 
   uint32_t onPassKeyRequest();
@@ -100,6 +114,8 @@ public:
   bool onConfirmPIN(uint32_t pin);
 
   bool connected();
+  // Relaxes the connection interval once traffic has stopped, call periodically
+  void updateConnection();
 
   BLEServer *ble_server;
   BLEAdvertising *ble_adv;
@@ -120,10 +136,14 @@ private:
   int ConnectedDeviceCount;
   void SetupSerialService();
 
-  uint16_t peerMTU;
+  uint16_t peerMTU = DEFAULT_MTU;
   uint16_t maxTransferSize = BLE_BUFFER_SIZE;
+  esp_bd_addr_t peerAddress;
+  bool fastInterval = false;
+  volatile unsigned long lastRxTime = 0;
 
   bool checkMTU();
+  void setFastInterval(bool fast);
 
   const char *BLE_SERIAL_SERVICE_UUID = "6e400001-b5a3-f393-e0a9-e50e24dcca9e";
   const char *BLE_RX_UUID = "6e400002-b5a3-f393-e0a9-e50e24dcca9e";
@@ -385,6 +385,7 @@ char bt_devname[11];
           bt_flush();
         }
       }
+      if (bt_state == BT_STATE_CONNECTED) { SerialBT.updateConnection(); }
     }
   #endif
 
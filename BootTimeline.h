@@ -0,0 +1,79 @@
+// Copyright (C) 2026, Boundary Mode Extension
+// Based on microReticulum_Firmware by Mark Qvist
+//
+// BootTimeline.h — Startup timeline.
+//
+// setup() marks the end of each boot stage with boot_stage(), which
+// records micros() since reset. When setup() returns the timeline is
+// printed as one serial line:
+//
+//   [Boot] serial=2.01s hw=2.03s modem=2.05s display=2.31s ... ready=3.42s
+//
+// and the time of the first packet Transport sends is added to it once
+// it happens. The host can read it at any time with CMD_STAT_BOOT:
+//
+//   stage_count(1) { us(4) } * stage_count
+//
+// all big-endian, stages in BootStage order, 0 for a stage not reached.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#ifndef BOOT_TIMELINE_H
+#define BOOT_TIMELINE_H
+
+enum BootStage : uint8_t {
+    BOOT_SERIAL = 0,     // Serial up, console wait done
+    BOOT_HW,             // WDT, EEPROM, PRNG, pins, buffers
+    BOOT_MODEM,          // Transceiver probed
+    BOOT_DISPLAY,        // Display initialised
+    BOOT_CONFIG,         // Boundary config loaded, portal not needed
+    BOOT_BT,             // Bluetooth and WiFi remote
+    BOOT_RADIO,          // EEPROM validated, radio started
+    BOOT_FS,             // Filesystem mounted
+    BOOT_INTERFACES,     // Interfaces registered, WiFi association started
+    BOOT_RETICULUM,      // reticulum.start(): identity, path and destination tables
+    BOOT_READY,          // setup() done
+    BOOT_FIRST_TX,       // First packet sent by Transport
+    BOOT_STAGE_COUNT
+};
+
+static const char* const boot_stage_names[BOOT_STAGE_COUNT] = {
+    "serial", "hw", "modem", "display", "config", "bt",
+    "radio", "fs", "ifaces", "reticulum", "ready", "first_tx"
+};
+
+uint32_t boot_timeline_us[BOOT_STAGE_COUNT] = {0};
+
+inline void boot_stage(BootStage stage) {
+    if (boot_timeline_us[stage] == 0) boot_timeline_us[stage] = micros();
+}
+
+inline void kiss_indicate_boot_timeline() {
+    serial_write(FEND);
+    serial_write(CMD_STAT_BOOT);
+    escaped_serial_write(BOOT_STAGE_COUNT);
+    for (uint8_t i = 0; i < BOOT_STAGE_COUNT; i++) {
+        uint32_t us = boot_timeline_us[i];
+        escaped_serial_write(us >> 24);
+        escaped_serial_write(us >> 16);
+        escaped_serial_write(us >> 8);
+        escaped_serial_write(us);
+    }
+    serial_write(FEND);
+}
+
+inline void boot_timeline_print() {
+    char line[256];
+    size_t pos = snprintf(line, sizeof(line), "[Boot]");
+    for (uint8_t i = 0; i < BOOT_STAGE_COUNT && pos < sizeof(line); i++) {
+        if (boot_timeline_us[i] == 0) continue;
+        pos += snprintf(line + pos, sizeof(line) - pos, " %s=%.2fs",
+                        boot_stage_names[i], boot_timeline_us[i] / 1000000.0);
+    }
+    Serial.printf("%s\r\n", line);
+}
+
+#endif // BOOT_TIMELINE_H
@@ -62,6 +62,160 @@
 #define BOUNDARY_TCP_PORT 4242
 #endif
 
+// ─── ESP-NOW Node Link ───────────────────────────────────────────────────────
+// Direct link to other RTNodes in WiFi range, without an AP (EspNowInterface.h)
+#ifndef BOUNDARY_ESPNOW
+#define BOUNDARY_ESPNOW 0
+#endif
+
+// Channel used when not joined to an AP, all linked nodes must match
+#ifndef BOUNDARY_ESPNOW_CHANNEL
+#define BOUNDARY_ESPNOW_CHANNEL 1
+#endif
+
+// ─── Light Sleep ─────────────────────────────────────────────────────────────
+// With WiFi disabled (LoRa-only repeater), light-sleep the CPU between
+// events. It wakes on the radio's DIO1 (RX/TX done), the button, or
+// after BOUNDARY_LIGHT_SLEEP_MAX_MS so Transport jobs keep running.
+// The USB serial console does not survive light sleep, so this is
+// opt-in for unattended nodes.
+#ifndef BOUNDARY_LIGHT_SLEEP
+#define BOUNDARY_LIGHT_SLEEP 0
+#endif
+#define BOUNDARY_LIGHT_SLEEP_MAX_MS   100   // longest single sleep
+#define BOUNDARY_LIGHT_SLEEP_IDLE_MS  50    // idle this long before sleeping
+
+// ─── Metrics Endpoint ────────────────────────────────────────────────────────
+// Prometheus text format at http://<station ip>:BOUNDARY_METRICS_PORT/metrics
+// (Metrics.h). Only answered on the WiFi station side, never on our own AP.
+#ifndef BOUNDARY_METRICS
+#define BOUNDARY_METRICS 1
+#endif
+#ifndef BOUNDARY_METRICS_PORT
+#define BOUNDARY_METRICS_PORT 9100
+#endif
+
+// ─── Status Server ───────────────────────────────────────────────────────────
+// Status page at http://<station ip>:BOUNDARY_STATUS_PORT/ (StatusServer.h),
+// served by ESPAsyncWebServer on its own task.
+#ifndef BOUNDARY_STATUS_SERVER
+#define BOUNDARY_STATUS_SERVER 1
+#endif
+#ifndef BOUNDARY_STATUS_PORT
+#define BOUNDARY_STATUS_PORT 80
+#endif
+// Snapshot refresh and WebSocket push interval, ms
+#ifndef BOUNDARY_STATUS_PUSH_MS
+#define BOUNDARY_STATUS_PUSH_MS 1000
+#endif
+// Concurrent WebSocket subscribers
+#ifndef BOUNDARY_STATUS_WS_CLIENTS
+#define BOUNDARY_STATUS_WS_CLIENTS 4
+#endif
+
+// ─── Loop Profiler ───────────────────────────────────────────────────────────
+// Per-stage latency histograms for loop() and Transport jobs, and a log of
+// the last slow iterations (LoopProfiler.h). Read with CMD_STAT_LOOP.
+#ifndef BOUNDARY_LOOP_PROFILE
+#define BOUNDARY_LOOP_PROFILE 1
+#endif
+// loop() or jobs() passes at least this long, in us, are logged
+#ifndef LOOP_PROFILE_SLOW_US
+#define LOOP_PROFILE_SLOW_US 50000
+#endif
+
+// ─── Task Stats ──────────────────────────────────────────────────────────────
+// Per-task CPU share, per-core idle time and stack high-water marks, sampled
+// every 10 s from the FreeRTOS task list (TaskStats.h). Read with
+// CMD_STAT_TASKS or on the metrics endpoint.
+#ifndef BOUNDARY_TASK_STATS
+#define BOUNDARY_TASK_STATS 1
+#endif
+
+// ─── Memory Pressure ─────────────────────────────────────────────────────────
+// Below the low watermark of free internal heap, caches and queues are shed
+// in priority order (MemoryPressure.h); below the critical one, known
+// destinations are culled and new link requests refused. The node only
+// reboots once nothing is left to shed and the heap stays under the floor.
+#ifndef BOUNDARY_MEMORY_PRESSURE
+#define BOUNDARY_MEMORY_PRESSURE 1
+#endif
+#ifndef MEM_PRESSURE_LOW_BYTES
+#define MEM_PRESSURE_LOW_BYTES      40000
+#endif
+#ifndef MEM_PRESSURE_CRITICAL_BYTES
+#define MEM_PRESSURE_CRITICAL_BYTES 28000
+#endif
+#ifndef MEM_PRESSURE_REBOOT_BYTES
+#define MEM_PRESSURE_REBOOT_BYTES   20000   // WiFi needs ~16KB for RX buffers
+#endif
+
+// ─── Statistics History ──────────────────────────────────────────────────────
+// Per-minute and per-hour records of airtime, channel load, noise floor and
+// packet counts, kept in ring files on flash (StatsLog.h). Each ring is
+// SEGMENTS files of 128 records: with 12 each, 25 hours of minutes and
+// 64 days of hours, 96 KB of flash. Read with CMD_STAT_HIST or from
+// /stats/minutes.bin and /stats/hours.bin on the status server.
+#ifndef BOUNDARY_STATS_LOG
+#define BOUNDARY_STATS_LOG 1
+#endif
+#ifndef STATS_LOG_MINUTE_SEGMENTS
+#define STATS_LOG_MINUTE_SEGMENTS 12
+#endif
+#ifndef STATS_LOG_HOUR_SEGMENTS
+#define STATS_LOG_HOUR_SEGMENTS 12
+#endif
+
+// ─── Live Configuration ──────────────────────────────────────────────────────
+// Radio and backbone settings changed at runtime over KISS or POST /config
+// on the status server (LiveConfig.h), applied without a reboot. New radio
+// settings wait up to LIVE_CONFIG_DRAIN_MS for the LoRa TX queue to empty.
+#ifndef BOUNDARY_LIVE_CONFIG
+#define BOUNDARY_LIVE_CONFIG 1
+#endif
+#ifndef LIVE_CONFIG_DRAIN_MS
+#define LIVE_CONFIG_DRAIN_MS 10000
+#endif
+
+// ─── Backbone → LoRa Announce Filter ─────────────────────────────────────────
+// Rules that announces heard on the backbone must pass before they are sent
+// on LoRa (see Utilities/AnnounceFilter.h). 0 disables a rule.
+
+// Drop announces from further than this many hops away
+#ifndef BOUNDARY_FILTER_MAX_HOPS
+#define BOUNDARY_FILTER_MAX_HOPS 0
+#endif
+
+// Forward at most this many announces per source transport node per window
+#ifndef BOUNDARY_FILTER_SOURCE_RATE
+#define BOUNDARY_FILTER_SOURCE_RATE 0
+#endif
+
+#ifndef BOUNDARY_FILTER_SOURCE_WINDOW
+#define BOUNDARY_FILTER_SOURCE_WINDOW 60   // seconds
+#endif
+
+// Only forward announces a local device asked for with a path request
+#ifndef BOUNDARY_FILTER_REQUESTED_ONLY
+#define BOUNDARY_FILTER_REQUESTED_ONLY 0
+#endif
+
+// Per-destination announce rate limit on the backbone, as the RNS interface
+// options announce_rate_target/_grace/_penalty: a destination announcing more
+// often than once per TARGET seconds more than GRACE times in a row has its
+// announces go unforwarded for TARGET + PENALTY seconds. 0 disables.
+#ifndef BOUNDARY_ANNOUNCE_RATE_TARGET
+#define BOUNDARY_ANNOUNCE_RATE_TARGET 0    // seconds
+#endif
+
+#ifndef BOUNDARY_ANNOUNCE_RATE_GRACE
+#define BOUNDARY_ANNOUNCE_RATE_GRACE 3
+#endif
+
+#ifndef BOUNDARY_ANNOUNCE_RATE_PENALTY
+#define BOUNDARY_ANNOUNCE_RATE_PENALTY 7200   // seconds
+#endif
+
 // ─── EEPROM Extension Addresses ──────────────────────────────────────────────
 // We use the CONFIG area (config_addr) for additional boundary mode settings.
 // These are after the existing WiFi SSID/PSK/IP/NM fields.
@@ -76,7 +230,7 @@
 #define ADDR_CONF_BTCP_PORT  0x4C  // TCP port (2 bytes, big-endian)
 #define ADDR_CONF_BHOST      0x4E  // Backbone host (64 bytes, null-terminated)
 #define ADDR_CONF_BHPORT     0x8E  // Backbone target port (2 bytes, big-endian)
-#define ADDR_CONF_AP_TCP_EN  0x90  // AP TCP server enable (1 byte, 0x73 = enabled)
+#define ADDR_CONF_AP_TCP_EN  0x90  // Local server enable (1 byte, 0x73 = TCP, 0x75 = UDP)
 #define ADDR_CONF_AP_TCP_PORT 0x91 // AP TCP server port (2 bytes, big-endian)
 #define ADDR_CONF_AP_SSID    0x93  // AP SSID (33 bytes, null-terminated)
 #define ADDR_CONF_AP_PSK     0xB4  // AP PSK (33 bytes, null-terminated)
@@ -88,10 +242,12 @@
 #define ADDR_CONF_APP_MARKER0 0x119 // RTNode app marker byte 0
 #define ADDR_CONF_APP_MARKER1 0x11A // RTNode app marker byte 1
 #define ADDR_CONF_APP_VERSION 0x11B // RTNode app config version
-// Total: 0x11C (284 bytes — extends beyond 256-byte CONFIG area into
+#define ADDR_CONF_CFG_TOKEN 0x11C  // POST /config token (33 bytes, null-terminated)
+// Total: 0x13D (317 bytes — extends beyond 256-byte CONFIG area into
 //         unused EEPROM gap; safe on ESP32 where EEPROM starts at 824)
 
 #define BOUNDARY_ENABLE_BYTE 0x73
+#define BOUNDARY_UDP_BYTE    0x75  // ADDR_CONF_AP_TCP_EN: local interface runs over UDP
 #define BOUNDARY_APP_MARKER0 0x52
 #define BOUNDARY_APP_MARKER1 0x54
 #define BOUNDARY_APP_VERSION 0x01
@@ -109,7 +265,8 @@ struct BoundaryState {
 
     // AP TCP server settings
     bool     ap_tcp_enabled;  // Whether to run a WiFi AP with TCP server
-    uint16_t ap_tcp_port;     // Port for the AP TCP server
+    bool     ap_udp;          // Serve the LAN over UDP broadcast instead of TCP
+    uint16_t ap_tcp_port;     // Port for the AP TCP server (or UDP port)
     char     ap_ssid[33];     // AP SSID
     char     ap_psk[33];      // AP PSK (empty = open)
 
@@ -118,6 +275,9 @@ struct BoundaryState {
     char     ifac_netname[33]; // Network name (empty = not set)
     char     ifac_passphrase[33]; // Passphrase (empty = not set)
 
+    // Live configuration over HTTP
+    char     config_token[33]; // X-Config-Token for POST /config (empty = refused)
+
     // Runtime state
     bool     wifi_connected;
     bool     tcp_connected;       // Backbone (WAN) connected
@@ -167,6 +327,7 @@ inline void boundary_load_config() {
         boundary_state.backbone_host[sizeof(boundary_state.backbone_host) - 1] = '\0';
         boundary_state.backbone_port = BOUNDARY_BACKBONE_PORT;
         boundary_state.ap_tcp_enabled = false;
+        boundary_state.ap_udp = false;
         boundary_state.ap_tcp_port = 4242;
         boundary_state.ap_ssid[0] = '\0';
         boundary_state.ap_psk[0] = '\0';
@@ -209,8 +370,10 @@ inline void boundary_load_config() {
     }
 
     // Load AP TCP server settings
+    uint8_t ap_en_byte = EEPROM.read(config_addr(ADDR_CONF_AP_TCP_EN));
     boundary_state.ap_tcp_enabled =
-        (EEPROM.read(config_addr(ADDR_CONF_AP_TCP_EN)) == BOUNDARY_ENABLE_BYTE);
+        (ap_en_byte == BOUNDARY_ENABLE_BYTE || ap_en_byte == BOUNDARY_UDP_BYTE);
+    boundary_state.ap_udp = (ap_en_byte == BOUNDARY_UDP_BYTE);
 
     boundary_state.ap_tcp_port =
         ((uint16_t)EEPROM.read(config_addr(ADDR_CONF_AP_TCP_PORT)) << 8) |
@@ -247,6 +410,12 @@ inline void boundary_load_config() {
     }
     boundary_state.ifac_passphrase[32] = '\0';
 
+    for (int i = 0; i < 32; i++) {
+        boundary_state.config_token[i] = EEPROM.read(config_addr(ADDR_CONF_CFG_TOKEN + i));
+        if (boundary_state.config_token[i] == (char)0xFF) boundary_state.config_token[i] = '\0';
+    }
+    boundary_state.config_token[32] = '\0';
+
     // Reset runtime state
     boundary_state.packets_bridged_lora_to_tcp = 0;
     boundary_state.packets_bridged_tcp_to_lora = 0;
@@ -272,7 +441,8 @@ inline void boundary_save_config() {
 
     // AP TCP server settings
     EEPROM.write(config_addr(ADDR_CONF_AP_TCP_EN),
-                 boundary_state.ap_tcp_enabled ? BOUNDARY_ENABLE_BYTE : 0x00);
+                 !boundary_state.ap_tcp_enabled ? 0x00 :
+                 boundary_state.ap_udp ? BOUNDARY_UDP_BYTE : BOUNDARY_ENABLE_BYTE);
     EEPROM.write(config_addr(ADDR_CONF_AP_TCP_PORT), (boundary_state.ap_tcp_port >> 8) & 0xFF);
     EEPROM.write(config_addr(ADDR_CONF_AP_TCP_PORT + 1), boundary_state.ap_tcp_port & 0xFF);
     for (int i = 0; i < 32; i++) {
@@ -295,6 +465,10 @@ inline void boundary_save_config() {
         EEPROM.write(config_addr(ADDR_CONF_IFAC_PASS + i), boundary_state.ifac_passphrase[i]);
     }
     EEPROM.write(config_addr(ADDR_CONF_IFAC_PASS + 32), 0x00);
+    for (int i = 0; i < 32; i++) {
+        EEPROM.write(config_addr(ADDR_CONF_CFG_TOKEN + i), boundary_state.config_token[i]);
+    }
+    EEPROM.write(config_addr(ADDR_CONF_CFG_TOKEN + 32), 0x00);
     EEPROM.write(config_addr(ADDR_CONF_APP_MARKER0), BOUNDARY_APP_MARKER0);
     EEPROM.write(config_addr(ADDR_CONF_APP_MARKER1), BOUNDARY_APP_MARKER1);
     EEPROM.write(config_addr(ADDR_CONF_APP_VERSION), BOUNDARY_APP_VERSION);
@@ -302,5 +476,24 @@ inline void boundary_save_config() {
     EEPROM.commit();
 }
 
+// LoRa settings go to the RNode config area, read back by eeprom_conf_load().
+// Written directly since hw_ready may not be set yet.
+inline void boundary_save_radio_config() {
+    eeprom_batch_begin();
+    eeprom_update(eeprom_addr(ADDR_CONF_SF), lora_sf);
+    eeprom_update(eeprom_addr(ADDR_CONF_CR), lora_cr);
+    eeprom_update(eeprom_addr(ADDR_CONF_TXP), lora_txp);
+    eeprom_update(eeprom_addr(ADDR_CONF_BW) + 0, lora_bw >> 24);
+    eeprom_update(eeprom_addr(ADDR_CONF_BW) + 1, lora_bw >> 16);
+    eeprom_update(eeprom_addr(ADDR_CONF_BW) + 2, lora_bw >> 8);
+    eeprom_update(eeprom_addr(ADDR_CONF_BW) + 3, lora_bw);
+    eeprom_update(eeprom_addr(ADDR_CONF_FREQ) + 0, lora_freq >> 24);
+    eeprom_update(eeprom_addr(ADDR_CONF_FREQ) + 1, lora_freq >> 16);
+    eeprom_update(eeprom_addr(ADDR_CONF_FREQ) + 2, lora_freq >> 8);
+    eeprom_update(eeprom_addr(ADDR_CONF_FREQ) + 3, lora_freq);
+    eeprom_update(eeprom_addr(ADDR_CONF_OK), CONF_OK_BYTE);
+    eeprom_batch_commit();
+}
+
 #endif // BOUNDARY_MODE
 #endif // BOUNDARY_MODE_H
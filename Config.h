@@ -92,6 +92,22 @@
 	#define LORA_LIMIT_THRESHOLD_BPS   60E3
 	#define LORA_GUARD_THRESHOLD_BPS   14E3
 	#define LORA_FAST_GUARD_MS         48
+
+	// Receive duty cycle, SX126x only. The modem listens for
+	// LORA_SNIFF_RX_SYMBOLS, sleeps LORA_SNIFF_SLEEP_RATIO times as long
+	// and repeats until it hears a preamble. Preambles are lengthened to
+	// span a whole cycle, and every node on the channel has to send them
+	// that long to be heard, so the setting is for a whole deployment.
+	#ifndef LORA_RX_DUTY_CYCLE
+	  #define LORA_RX_DUTY_CYCLE       false
+	#endif
+	#if MODEM != SX1262
+	  #undef LORA_RX_DUTY_CYCLE
+	  #define LORA_RX_DUTY_CYCLE       false
+	#endif
+	#define LORA_SNIFF_RX_SYMBOLS      8
+	#define LORA_SNIFF_SLEEP_RATIO     3
+	#define LORA_SNIFF_WAKE_US         2000  // Sleep to RX, TCXO start included
 	long lora_preamble_symbols      =  LORA_PREAMBLE_SYMBOLS_MIN;
 	long lora_preamble_time_ms      =  0;
 	long lora_header_time_ms        =  0;
@@ -117,6 +133,9 @@
 	#define CSMA_INFR_THRESHOLD_DB     11
 	#define CSMA_RFENV_RECAL_MS        2500
 	#define CSMA_RFENV_RECAL_LIMIT_DB -83
+	#define CSMA_CW_ADAPT_MAX          30   // Slots the window grows by at most under contention
+	#define CSMA_P_MIN                 64   // Lowest transmit persistence, out of 256
+	#define CSMA_P_OTHERS_MIN_UTIL     2    // % channel use by other nodes before persistence drops
 	bool interference_detected      =  false;
 	bool avoid_interference         =  true;
 	int csma_slot_ms                =  CSMA_SLOT_MIN_MS;
@@ -129,6 +148,39 @@
 	uint8_t cw_band                 =  1;
 	uint8_t cw_min                  =  0;
 	uint8_t cw_max                  =  CSMA_CW_PER_BAND_WINDOWS;
+	uint8_t cw_adapt                =  0;
+	uint16_t csma_p                 =  256;
+	bool csma_deferred              =  false;
+	uint16_t csma_band_tx[CSMA_CW_BANDS];
+	uint16_t csma_band_deferrals[CSMA_CW_BANDS];
+
+	// SX1280 only: run the radio as a GFSK link at this many bits/s
+	// instead of LoRa, for point-to-point backhaul. Both ends must use
+	// the same setting. 0 keeps LoRa.
+	#ifndef LORA_FSK_BITRATE
+		#define LORA_FSK_BITRATE       0
+	#endif
+	#define FSK_FRAME_OVERHEAD_BITS    (32+32+8+16)   // preamble, sync word, length, CRC
+
+	// LoRa frame aggregation. Small packets queued together are sent as
+	// one frame carrying FLAG_AGGR. Nodes that can de-aggregate set
+	// FLAG_AGGR_OK on everything they send, and aggregation is only used
+	// while no node without it has been heard for LORA_AGGR_PEER_TIMEOUT.
+	#ifndef LORA_AGGREGATION
+		#define LORA_AGGREGATION       0
+	#endif
+	#define LORA_AGGR_MAX_ITEM         100       // Largest packet that is aggregated
+	#define LORA_AGGR_MAX_PACKETS      8
+	#define LORA_AGGR_HOLD_MS          150       // A lone small packet waits this long for company
+	#define LORA_AGGR_PEER_TIMEOUT     1800000   // ms
+	bool lora_aggregate             =  LORA_AGGREGATION;
+	uint32_t aggr_heard_capable     =  0;
+	uint32_t aggr_heard_legacy      =  0;
+
+	// Second SX1262 modem run as its own interface, see Lora2Interface.h
+	#ifndef HAS_LORA2
+		#define HAS_LORA2              0
+	#endif
 
 	// LoRa settings
 	int  lora_sf   	                =  0;
@@ -159,7 +211,9 @@
 	#define NOISE_FLOOR_SAMPLES 128
 	int     noise_floor     = -292;
     int     current_rssi    = -292;
+	int     peak_rssi       = -292;   // Highest paced sample since the display last took it
 	int		last_rssi		= -292;
+	uint32_t last_rssi_at   = 0;      // millis() when last_rssi was taken from a received packet
 	uint8_t last_rssi_raw   = 0x00;
 	uint8_t last_snr_raw	= 0x80;
 	uint8_t seq				= 0xFF;
@@ -198,6 +252,15 @@
 		float airtime = 0.0;
 		float longterm_airtime = 0.0;
 		#define current_airtime_bin(void) (millis()%AIRTIME_LONGTERM_MS)/AIRTIME_BINLEN_MS
+		// Running totals of airtime_bins and longterm_bins, kept up to
+		// date as bins are filled and cleared
+		uint32_t airtime_bins_sum = 0;
+		float longterm_bins_sum = 0.0;
+		// Own airtime since boot in ms, wraps after 49 days on air
+		uint32_t airtime_ms_total = 0;
+		// On-air time in microseconds by frame length, rebuilt by
+		// updateBitrate() whenever the modulation changes
+		uint32_t airtime_table_us[SINGLE_MTU+1];
 	#endif
 	float st_airtime_limit = 0.0;
 	float lt_airtime_limit = 0.0;
@@ -215,6 +278,7 @@
 
 	uint32_t status_interval_ms = STATUS_INTERVAL_MS;
 	uint32_t last_status_update = 0;
+	uint32_t next_status_sample = 0;
 	uint32_t last_dcd = 0;
 
     // Power management
@@ -239,6 +303,10 @@
     bool firmware_update_mode = false;
     bool serial_in_frame = false;
 
+    // Host output buffer, fits a fully escaped MTU sized data frame
+    // along with the RSSI and SNR frames that precede it
+    #define SERIAL_TX_BUFFER_SIZE (MTU*2+64)
+
 	// Boot flags
 	#define START_FROM_BOOTLOADER 0x01
 	#define START_FROM_POWERON    0x02
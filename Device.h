@@ -20,6 +20,7 @@
 #include "esp_ota_ops.h"
 #include "esp_flash_partitions.h"
 #include "esp_partition.h"
+#include "esp_system.h"
 
 #elif MCU_VARIANT == MCU_NRF52
 #include "Adafruit_nRFCrypto.h"
@@ -44,6 +45,8 @@
 
 // Forward declaration from Utilities.h
 void eeprom_update(int mapped_addr, uint8_t byte);
+void eeprom_batch_begin();
+void eeprom_batch_commit();
 uint8_t eeprom_read(uint32_t addr);
 void hard_reset(void);
 
@@ -106,9 +109,11 @@ void device_validate_signature() {
 void device_save_signature() {
   device_validate_signature();
   if (dev_signature_validated) {
+    eeprom_batch_begin();
     for (uint8_t i = 0; i < DEV_SIG_LEN; i++) {
       eeprom_update(dev_sig_addr(i), dev_sig[i]);
     }
+    eeprom_batch_commit();
   }
 }
 
@@ -133,12 +138,11 @@ void device_load_firmware_hash() {
 }
 
 void device_save_firmware_hash() {
+  eeprom_batch_begin();
   for (uint8_t i = 0; i < DEV_HASH_LEN; i++) {
     eeprom_update(dev_fwhash_addr(i), dev_firmware_hash_target[i]);
   }
-  #if !HAS_EEPROM && MCU_VARIANT == MCU_NRF52
-    eeprom_flush();
-  #endif
+  eeprom_batch_commit();
   if (!fw_signature_validated) hard_reset();
 }
 
@@ -182,19 +186,75 @@ void calculate_region_hash(unsigned long long start, unsigned long long end, uin
 }
 #endif
 
+#if MCU_VARIANT == MCU_ESP32
+// Hashing the running app partition reads all of it from flash, which
+// takes seconds. The results are kept in RTC memory across software
+// resets and watchdog reboots, keyed by the app image's ELF SHA-256 and
+// the partition it runs from, so they are only recomputed after a power
+// cycle, a flash or an OTA update.
+#define DEV_HASH_CACHE_MAGIC 0x52484331
+typedef struct {
+  uint32_t magic;
+  uint32_t app_address;
+  uint8_t  app_elf_sha[DEV_HASH_LEN];
+  uint8_t  partition_table_hash[DEV_HASH_LEN];
+  uint8_t  bootloader_hash[DEV_HASH_LEN];
+  uint8_t  firmware_hash[DEV_HASH_LEN];
+  uint32_t check;
+} dev_hash_cache_t;
+RTC_NOINIT_ATTR dev_hash_cache_t dev_hash_cache;
+
+uint32_t device_hash_cache_check() {
+  // FNV-1a over everything before the check field
+  const uint8_t *p = (const uint8_t*)&dev_hash_cache;
+  uint32_t h = 2166136261UL;
+  for (size_t i = 0; i < offsetof(dev_hash_cache_t, check); i++) { h = (h ^ p[i]) * 16777619UL; }
+  return h;
+}
+
+bool device_hash_cache_load(const esp_partition_t *running) {
+  // RTC memory only holds valid data after a reset that kept it powered
+  esp_reset_reason_t reason = esp_reset_reason();
+  if (reason != ESP_RST_SW && reason != ESP_RST_PANIC && reason != ESP_RST_INT_WDT &&
+      reason != ESP_RST_TASK_WDT && reason != ESP_RST_WDT && reason != ESP_RST_DEEPSLEEP) return false;
+  if (dev_hash_cache.magic != DEV_HASH_CACHE_MAGIC || dev_hash_cache.check != device_hash_cache_check()) return false;
+  if (dev_hash_cache.app_address != running->address) return false;
+  if (memcmp(dev_hash_cache.app_elf_sha, esp_ota_get_app_description()->app_elf_sha256, DEV_HASH_LEN) != 0) return false;
+
+  memcpy(dev_partition_table_hash, dev_hash_cache.partition_table_hash, DEV_HASH_LEN);
+  memcpy(dev_bootloader_hash, dev_hash_cache.bootloader_hash, DEV_HASH_LEN);
+  memcpy(dev_firmware_hash, dev_hash_cache.firmware_hash, DEV_HASH_LEN);
+  return true;
+}
+
+void device_hash_cache_store(const esp_partition_t *running) {
+  dev_hash_cache.magic = DEV_HASH_CACHE_MAGIC;
+  dev_hash_cache.app_address = running->address;
+  memcpy(dev_hash_cache.app_elf_sha, esp_ota_get_app_description()->app_elf_sha256, DEV_HASH_LEN);
+  memcpy(dev_hash_cache.partition_table_hash, dev_partition_table_hash, DEV_HASH_LEN);
+  memcpy(dev_hash_cache.bootloader_hash, dev_bootloader_hash, DEV_HASH_LEN);
+  memcpy(dev_hash_cache.firmware_hash, dev_firmware_hash, DEV_HASH_LEN);
+  dev_hash_cache.check = device_hash_cache_check();
+}
+#endif
+
 void device_validate_partitions() {
   device_load_firmware_hash();
   #if MCU_VARIANT == MCU_ESP32
-  esp_partition_t partition;
-  partition.address   = ESP_PARTITION_TABLE_OFFSET;
-  partition.size      = ESP_PARTITION_TABLE_MAX_LEN;
-  partition.type      = ESP_PARTITION_TYPE_DATA;
-  esp_partition_get_sha256(&partition, dev_partition_table_hash);
-  partition.address   = ESP_BOOTLOADER_OFFSET;
-  partition.size      = ESP_PARTITION_TABLE_OFFSET;
-  partition.type      = ESP_PARTITION_TYPE_APP;
-  esp_partition_get_sha256(&partition, dev_bootloader_hash);
-  esp_partition_get_sha256(esp_ota_get_running_partition(), dev_firmware_hash);
+  const esp_partition_t *running = esp_ota_get_running_partition();
+  if (!device_hash_cache_load(running)) {
+    esp_partition_t partition;
+    partition.address   = ESP_PARTITION_TABLE_OFFSET;
+    partition.size      = ESP_PARTITION_TABLE_MAX_LEN;
+    partition.type      = ESP_PARTITION_TYPE_DATA;
+    esp_partition_get_sha256(&partition, dev_partition_table_hash);
+    partition.address   = ESP_BOOTLOADER_OFFSET;
+    partition.size      = ESP_PARTITION_TABLE_OFFSET;
+    partition.type      = ESP_PARTITION_TYPE_APP;
+    esp_partition_get_sha256(&partition, dev_bootloader_hash);
+    esp_partition_get_sha256(running, dev_firmware_hash);
+    device_hash_cache_store(running);
+  }
   #elif MCU_VARIANT == MCU_NRF52
   // todo, add bootloader, partition table, or softdevice?
   calculate_region_hash(APPLICATION_START, APPLICATION_START+retrieve_application_size(), dev_firmware_hash);
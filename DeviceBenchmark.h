@@ -0,0 +1,231 @@
+// Copyright (C) 2026, Boundary Mode Extension
+// Based on microReticulum_Firmware by Mark Qvist
+//
+// DeviceBenchmark.h — On-device microbenchmarks over KISS.
+//
+// CMD_BENCHMARK runs a fixed set of cases on the device itself and
+// answers with one KISS frame:
+//
+//   case_count(1) { id(1) iterations(2) ns_per_op(4) } * case_count
+//
+// all big-endian, cases in BenchCase order. A case that could not run
+// (no filesystem, radio offline or transmitting, modem without FIFO
+// access) reports 0 iterations. The same results are printed as:
+//
+//   [Bench] sha256=31.2us hmac=88.0us aes256_enc=40.1us ed25519_sign=9.41ms ...
+//
+// Everything runs inside loop(), so LoRa RX, TCP and serial stall for
+// the duration (about a second). The SPI cases put the modem in standby
+// and write its FIFO, a packet arriving meanwhile is lost. Hashes and
+// ciphers work on 256 bytes, Packet::unpack() on a 128 byte DATA
+// packet, and the path table case looks up keys in a table of the same
+// type and size as the live one, filled with random hashes, since the
+// live table belongs to the transport task. For the same reason inputs
+// and keys come from the hardware RNG (getRandom()), not the RNS
+// RandomPool.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#ifndef DEVICE_BENCHMARK_H
+#define DEVICE_BENCHMARK_H
+
+#ifdef HAS_RNS
+
+// Set to 0 to leave the benchmark out of the build
+#ifndef DEVICE_BENCHMARK
+#define DEVICE_BENCHMARK 1
+#endif
+
+#if DEVICE_BENCHMARK
+
+#define HAS_DEVICE_BENCHMARK true
+
+#include <Transport.h>
+#include <Packet.h>
+#include <Destination.h>
+#include <Bytes.h>
+#include <Cryptography/Hashes.h>
+#include <Cryptography/HMAC.h>
+#include <Cryptography/AES.h>
+#include <Cryptography/Ed25519.h>
+#include <Cryptography/X25519.h>
+#include <Utilities/HashTable.h>
+#include <Utilities/OS.h>
+#include <vector>
+
+enum BenchCase : uint8_t {
+    BENCH_SHA256 = 0,
+    BENCH_HMAC,
+    BENCH_AES256_ENCRYPT,
+    BENCH_AES256_DECRYPT,
+    BENCH_ED25519_SIGN,
+    BENCH_ED25519_VERIFY,
+    BENCH_X25519,
+    BENCH_PACKET_UNPACK,
+    BENCH_PATH_LOOKUP,
+    BENCH_FS_WRITE,
+    BENCH_SPI_FIFO_WRITE,
+    BENCH_SPI_FIFO_READ,
+    BENCH_CASE_COUNT
+};
+
+static const char* const bench_case_names[BENCH_CASE_COUNT] = {
+    "sha256", "hmac", "aes256_enc", "aes256_dec", "ed25519_sign",
+    "ed25519_verify", "x25519", "unpack", "path_lookup", "fs_write",
+    "fifo_write", "fifo_read"
+};
+
+#define BENCH_DATA_SIZE 256
+
+struct BenchResult {
+    uint16_t iterations;
+    uint32_t ns_per_op;
+};
+
+BenchResult bench_results[BENCH_CASE_COUNT];
+
+// Defined in RNode_Firmware.ino
+void lora_receive();
+
+// Times iterations calls of body(i) after one untimed warm-up call
+template <typename F>
+inline void bench_run(BenchCase id, uint16_t iterations, F body) {
+    body(0);
+    uint32_t start = micros();
+    for (uint16_t i = 0; i < iterations; i++) body(i);
+    uint32_t us = micros() - start;
+    bench_results[id].iterations = iterations;
+    bench_results[id].ns_per_op = (uint32_t)(((uint64_t)us * 1000) / iterations);
+    #if MCU_VARIANT == MCU_ESP32
+      esp_task_wdt_reset();
+    #endif
+}
+
+// Runs on loop(), where the RNS RandomPool must not be drawn from
+inline RNS::Bytes bench_random(size_t length) {
+    RNS::Bytes bytes;
+    uint8_t* p = bytes.writable(length);
+    for (size_t i = 0; i < length; i++) p[i] = getRandom();
+    return bytes;
+}
+
+inline void bench_crypto() {
+    RNS::Bytes data = bench_random(BENCH_DATA_SIZE);
+    RNS::Bytes key = bench_random(32);
+    RNS::Bytes iv = bench_random(16);
+
+    bench_run(BENCH_SHA256, 64, [&](uint16_t) { RNS::Cryptography::sha256(data); });
+    bench_run(BENCH_HMAC, 64, [&](uint16_t) { RNS::Cryptography::digest(key, data); });
+
+    bench_run(BENCH_AES256_ENCRYPT, 64, [&](uint16_t) {
+        RNS::Cryptography::AES_256_CBC::encrypt(data, key, iv);
+    });
+    RNS::Bytes ciphertext = RNS::Cryptography::AES_256_CBC::encrypt(data, key, iv);
+    bench_run(BENCH_AES256_DECRYPT, 64, [&](uint16_t) {
+        RNS::Cryptography::AES_256_CBC::decrypt(ciphertext, key, iv);
+    });
+
+    RNS::Cryptography::Ed25519PrivateKey::Ptr signer = RNS::Cryptography::Ed25519PrivateKey::from_private_bytes(bench_random(32));
+    RNS::Cryptography::Ed25519PublicKey::Ptr verifier = signer->public_key();
+    bench_run(BENCH_ED25519_SIGN, 4, [&](uint16_t) { signer->sign(data); });
+    RNS::Bytes signature = signer->sign(data);
+    bench_run(BENCH_ED25519_VERIFY, 4, [&](uint16_t) { verifier->verify(signature, data); });
+
+    RNS::Cryptography::X25519PrivateKey::Ptr own = RNS::Cryptography::X25519PrivateKey::from_private_bytes(bench_random(32));
+    RNS::Bytes peer = RNS::Cryptography::X25519PrivateKey::from_private_bytes(bench_random(32))->public_key()->public_bytes();
+    bench_run(BENCH_X25519, 4, [&](uint16_t) { own->exchange(peer); });
+}
+
+inline void bench_transport() {
+    // A HEADER_1 DATA packet for a SINGLE destination, as it arrives on air
+    RNS::Bytes raw;
+    raw << (uint8_t)((RNS::Type::Packet::HEADER_1 << 6) | (RNS::Type::Transport::BROADCAST << 4) |
+                     (RNS::Type::Destination::SINGLE << 2) | RNS::Type::Packet::DATA);
+    raw << (uint8_t)0;
+    raw << bench_random(RNS::Type::Reticulum::TRUNCATED_HASHLENGTH / 8);
+    raw << (uint8_t)RNS::Type::Packet::CONTEXT_NONE;
+    raw << bench_random(128);
+    bench_run(BENCH_PACKET_UNPACK, 64, [&](uint16_t) {
+        RNS::Packet packet(RNS::Destination(RNS::Type::NONE), raw);
+        packet.unpack();
+    });
+
+    size_t paths = transport_path_count.load(std::memory_order_relaxed);
+    if (paths < 16) paths = 16;
+    RNS::Utilities::HashTable<uint32_t> table(RNS::Transport::path_table_maxsize() + 1);
+    std::vector<RNS::Bytes> keys;
+    keys.reserve(paths);
+    for (size_t i = 0; i < paths; i++) {
+        keys.push_back(bench_random(RNS::Type::Reticulum::TRUNCATED_HASHLENGTH / 8));
+        table.insert({keys.back(), (uint32_t)i});
+    }
+    bench_run(BENCH_PATH_LOOKUP, 256, [&](uint16_t i) { table.find(keys[i % paths]); });
+}
+
+inline void bench_filesystem() {
+    char path[RNS::Type::Reticulum::FILEPATH_MAXSIZE];
+    snprintf(path, sizeof(path), "%s/bench", RNS::Reticulum::_storagepath);
+    RNS::Bytes data = bench_random(BENCH_DATA_SIZE);
+    if (RNS::Utilities::OS::write_file(path, data) != data.size()) return;
+    bench_run(BENCH_FS_WRITE, 4, [&](uint16_t) { RNS::Utilities::OS::write_file(path, data); });
+    RNS::Utilities::OS::remove_file(path);
+}
+
+inline void bench_spi() {
+    #if MODEM == SX1262
+      if (!radio_online || LoRa->transmitting()) return;
+      uint8_t buffer[BENCH_DATA_SIZE - 1];
+      for (size_t i = 0; i < sizeof(buffer); i++) buffer[i] = i;
+      // beginPacket() puts the modem in standby; the TX pointer wraps in the
+      // 256 byte FIFO, so every burst is a full packet's worth
+      LoRa->beginPacket();
+      bench_run(BENCH_SPI_FIFO_WRITE, 64, [&](uint16_t) { LoRa->writeBuffer(buffer, sizeof(buffer)); });
+      bench_run(BENCH_SPI_FIFO_READ, 64, [&](uint16_t) { LoRa->readBuffer(0, buffer, sizeof(buffer)); });
+      lora_receive();
+    #endif
+}
+
+inline void device_benchmark_run() {
+    memset(bench_results, 0, sizeof(bench_results));
+    bench_crypto();
+    bench_transport();
+    bench_filesystem();
+    bench_spi();
+
+    char line[320];
+    size_t pos = snprintf(line, sizeof(line), "[Bench]");
+    for (uint8_t i = 0; i < BENCH_CASE_COUNT && pos < sizeof(line); i++) {
+        if (bench_results[i].iterations == 0) continue;
+        uint32_t ns = bench_results[i].ns_per_op;
+        if (ns >= 1000000) pos += snprintf(line + pos, sizeof(line) - pos, " %s=%.2fms", bench_case_names[i], ns / 1000000.0);
+        else pos += snprintf(line + pos, sizeof(line) - pos, " %s=%.1fus", bench_case_names[i], ns / 1000.0);
+    }
+    Serial.printf("%s\r\n", line);
+}
+
+inline void kiss_indicate_benchmark() {
+    device_benchmark_run();
+    serial_write(FEND);
+    serial_write(CMD_BENCHMARK);
+    escaped_serial_write(BENCH_CASE_COUNT);
+    for (uint8_t i = 0; i < BENCH_CASE_COUNT; i++) {
+        const BenchResult& result = bench_results[i];
+        escaped_serial_write(i);
+        escaped_serial_write(result.iterations >> 8);
+        escaped_serial_write(result.iterations);
+        escaped_serial_write(result.ns_per_op >> 24);
+        escaped_serial_write(result.ns_per_op >> 16);
+        escaped_serial_write(result.ns_per_op >> 8);
+        escaped_serial_write(result.ns_per_op);
+    }
+    serial_write(FEND);
+}
+
+#endif // DEVICE_BENCHMARK
+
+#endif // HAS_RNS
+
+#endif // DEVICE_BENCHMARK_H
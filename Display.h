@@ -53,6 +53,7 @@ struct BoundaryState {
     char     backbone_host[64];
     uint16_t backbone_port;
     bool     ap_tcp_enabled;
+    bool     ap_udp;
     uint16_t ap_tcp_port;
     char     ap_ssid[33];
     char     ap_psk[33];
@@ -155,6 +156,24 @@ extern BoundaryState boundary_state;
   #define REFRESH_PERIOD 300000
 #else
   Adafruit_SSD1306 display(DISP_W, DISP_H, &Wire, DISP_RST);
+  // Only changed pages are sent to the SSD1306, see display_flush()
+  #define DISP_PARTIAL_FLUSH true
+  #if MCU_VARIANT == MCU_ESP32
+    #define DISP_FLUSH_TASK true
+  #endif
+#endif
+
+#ifdef BOUNDARY_MODE
+  // The status screen is drawn from a snapshot of the stats, see
+  // display_publish(). On ESP32 it is rendered by its own task.
+  #define DISP_SNAPSHOT true
+  #ifndef DISP_RENDER_TASK
+    #if MCU_VARIANT == MCU_ESP32
+      #define DISP_RENDER_TASK 1
+    #else
+      #define DISP_RENDER_TASK 0
+    #endif
+  #endif
 #endif
 
 float disp_target_fps = 7;
@@ -299,6 +318,106 @@ uint8_t display_contrast = 0x00;
   }
 #endif
 
+#if DISP_PARTIAL_FLUSH
+// What the panel currently shows. display_flush() compares the frame
+// buffer with it page by page and sends only the changed column span of
+// each page, which for the status screen is usually a few dozen bytes
+// instead of the whole 1 KB. On ESP32 the I2C transfer runs on its own
+// low-priority task, so the loop never waits for the bus; a new frame is
+// only drawn once the previous one has gone out.
+#define DISP_PAGES        (DISP_H/8)
+#define DISP_I2C_CHUNK    31
+#define DISP_I2C_CLK      400000UL
+#define DISP_I2C_CLK_IDLE 100000UL
+uint8_t disp_shadow[DISP_W*DISP_PAGES];
+bool disp_shadow_valid = false;
+uint8_t disp_dirty_lo[DISP_PAGES];
+uint8_t disp_dirty_hi[DISP_PAGES];
+uint8_t disp_i2c_addr = DISP_ADDR;
+volatile bool disp_flush_busy = false;
+#if DISP_FLUSH_TASK
+  TaskHandle_t disp_flush_task_handle = NULL;
+#endif
+#if DISP_RENDER_TASK
+  TaskHandle_t disp_render_task_handle = NULL;
+#endif
+
+void display_send_dirty() {
+  Wire.setClock(DISP_I2C_CLK);
+  for (uint8_t page = 0; page < DISP_PAGES; page++) {
+    if (disp_dirty_lo[page] > disp_dirty_hi[page]) { continue; }
+    Wire.beginTransmission(disp_i2c_addr);
+    Wire.write((uint8_t)0x00);
+    Wire.write(SSD1306_COLUMNADDR); Wire.write(disp_dirty_lo[page]); Wire.write(disp_dirty_hi[page]);
+    Wire.write(SSD1306_PAGEADDR);   Wire.write(page);                Wire.write(page);
+    Wire.endTransmission();
+
+    const uint8_t* src = disp_shadow + page*DISP_W + disp_dirty_lo[page];
+    uint16_t left = disp_dirty_hi[page] - disp_dirty_lo[page] + 1;
+    while (left > 0) {
+      uint8_t n = left > DISP_I2C_CHUNK ? DISP_I2C_CHUNK : left;
+      Wire.beginTransmission(disp_i2c_addr);
+      Wire.write((uint8_t)0x40);
+      Wire.write(src, n);
+      Wire.endTransmission();
+      src += n; left -= n;
+    }
+  }
+  Wire.setClock(DISP_I2C_CLK_IDLE);
+}
+
+#if DISP_FLUSH_TASK
+void display_flush_task(void* param) {
+  while (true) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    display_send_dirty();
+    disp_flush_busy = false;
+  }
+}
+#endif
+
+// Replaces display.display() for the SSD1306
+void display_flush() {
+  // Callers outside update_display() wait for the previous frame
+  while (disp_flush_busy) { delay(1); }
+
+  const uint8_t* buf = display.getBuffer();
+  bool dirty = false;
+  for (uint8_t page = 0; page < DISP_PAGES; page++) {
+    const uint8_t* row = buf + page*DISP_W;
+    uint8_t* shadow = disp_shadow + page*DISP_W;
+    int lo = 0, hi = DISP_W-1;
+    if (disp_shadow_valid) {
+      while (lo < DISP_W && row[lo] == shadow[lo]) { lo++; }
+      while (hi > lo && row[hi] == shadow[hi]) { hi--; }
+    }
+    if (lo >= DISP_W) {
+      disp_dirty_lo[page] = 0xFF; disp_dirty_hi[page] = 0x00;
+      continue;
+    }
+    memcpy(shadow + lo, row + lo, hi - lo + 1);
+    disp_dirty_lo[page] = lo; disp_dirty_hi[page] = hi;
+    dirty = true;
+  }
+  disp_shadow_valid = true;
+  if (!dirty) { return; }
+
+  #if DISP_FLUSH_TASK
+    // The render task is already off the loop and sends the frame itself
+    #if DISP_RENDER_TASK
+    if (disp_flush_task_handle && xTaskGetCurrentTaskHandle() != disp_render_task_handle) {
+    #else
+    if (disp_flush_task_handle) {
+    #endif
+      disp_flush_busy = true;
+      xTaskNotifyGive(disp_flush_task_handle);
+      return;
+    }
+  #endif
+  display_send_dirty();
+}
+#endif
+
 bool display_init() {
   #if HAS_DISPLAY
     #if BOARD_MODEL == BOARD_RNODE_NG_20 || BOARD_MODEL == BOARD_LORA32_V2_0
@@ -417,6 +536,15 @@ bool display_init() {
       return false;
     } else {
       set_contrast(&display, display_contrast);
+      #if DISP_PARTIAL_FLUSH
+        disp_i2c_addr = display_address;
+        disp_shadow_valid = false;
+      #endif
+      #if DISP_FLUSH_TASK
+        if (!disp_flush_task_handle) {
+          xTaskCreate(display_flush_task, "display", 2048, NULL, 1, &disp_flush_task_handle);
+        }
+      #endif
       if (display_rotation != 0xFF) {
         if (display_rotation == 0 || display_rotation == 2) {
           disp_mode = DISP_MODE_LANDSCAPE;
@@ -635,10 +763,57 @@ void draw_mw_icon(int px, int py) {
 }
 
 uint8_t charge_tick = 0;
+#if DISP_SNAPSHOT
+#include <atomic>
+
+// Everything the status screen shows that loop() updates. loop() fills
+// disp_snap_shared in display_publish(), the renderer copies it into
+// disp_snap under a sequence lock and draws from that copy only, so a
+// frame never mixes values from two different loop() passes and drawing
+// never holds anything loop() is waiting on.
+struct DisplaySnapshot {
+  bool     radio_online;
+  float    airtime;
+  uint32_t lora_freq;
+  uint32_t lora_bw;
+  int      lora_sf;
+  uint8_t  last_snr_raw;
+  int      last_rssi;
+  bool     pmu_ready;
+  bool     battery_ready;
+  bool     battery_installed;
+  bool     battery_indeterminate;
+  float    battery_percent;
+  uint8_t  battery_state;
+  bool     wifi_enabled;
+  bool     wifi_up;             // station associated
+  bool     wifi_connected;      // boundary_state, for the IP line
+  uint32_t wifi_ip;
+  uint8_t  tcp_mode;
+  bool     tcp_connected;
+  bool     ap_tcp_enabled;
+  bool     ap_tcp_connected;
+  uint16_t ap_tcp_port;
+  bool     lock_white;
+};
+
+DisplaySnapshot disp_snap_shared;
+DisplaySnapshot disp_snap;
+std::atomic<uint32_t> disp_snap_seq(0);
+uint32_t disp_last_publish = 0;
+
+#define DS(field) disp_snap.field
+#else
+#define DS(field) field
+#endif
+
 void draw_battery_bars(int px, int py) {
-  if (pmu_ready) {
-    if (battery_ready) {
-      if (battery_installed) {
+  if (DS(pmu_ready)) {
+    if (DS(battery_ready)) {
+      if (DS(battery_installed)) {
+        float battery_percent = DS(battery_percent);
+        bool battery_indeterminate = DS(battery_indeterminate);
+        uint8_t battery_state = DS(battery_state);
         float battery_value = battery_percent;
 
         // Disable charging state display for now, since
@@ -695,10 +870,10 @@ void draw_battery_bars(int px, int py) {
 #define Q_SNR_MAX 6.0
 void draw_quality_bars(int px, int py) {
   stat_area.fillRect(px, py, 13, 7, SSD1306_BLACK);
-  if (radio_online) {
-    signed char t_snr = (signed int)last_snr_raw;
+  if (DS(radio_online)) {
+    signed char t_snr = (signed int)DS(last_snr_raw);
     int snr_int = (int)t_snr;
-    float snr_min = Q_SNR_MIN_BASE-(int)lora_sf*Q_SNR_STEP;
+    float snr_min = Q_SNR_MIN_BASE-(int)DS(lora_sf)*Q_SNR_STEP;
     float snr_span = (Q_SNR_MAX-snr_min);
     float snr = ((int)snr_int) * 0.25;
     float quality = ((snr-snr_min)/(snr_span))*100;
@@ -727,8 +902,8 @@ void draw_quality_bars(int px, int py) {
 void draw_signal_bars(int px, int py) {
   stat_area.fillRect(px, py, 13, 7, SSD1306_BLACK);
 
-  if (radio_online) {
-    int rssi_val = last_rssi;
+  if (DS(radio_online)) {
+    int rssi_val = DS(last_rssi);
     if (rssi_val < S_RSSI_MIN) rssi_val = S_RSSI_MIN;
     if (rssi_val > S_RSSI_MAX) rssi_val = S_RSSI_MAX;
     int signal = ((rssi_val - S_RSSI_MIN)*(1.0/S_RSSI_SPAN))*100.0;
@@ -760,7 +935,9 @@ void draw_signal_bars(int px, int py) {
 #define WF_M_TX   0x01
 #define WF_M_NTFR 0x02
 void draw_waterfall(int px, int py) {
-  int rssi_val = current_rssi;
+  // Strongest signal sampled since the last line, not just whatever the
+  // channel held at the moment of drawing
+  int rssi_val = peak_rssi; peak_rssi = -292;
   if (rssi_val < WF_RSSI_MIN) rssi_val = WF_RSSI_MIN;
   if (rssi_val > WF_RSSI_MAX) rssi_val = WF_RSSI_MAX;
   int rssi_normalised = ((rssi_val - WF_RSSI_MIN)*(1.0/WF_RSSI_SPAN))*WF_PIXEL_WIDTH;
@@ -810,17 +987,17 @@ void draw_stat_area() {
     stat_area.setTextSize(1);
 
     // Row 1 — LORA
-    stat_area.fillCircle(4, 3, 3, radio_online ? SSD1306_WHITE : SSD1306_BLACK);
+    stat_area.fillCircle(4, 3, 3, DS(radio_online) ? SSD1306_WHITE : SSD1306_BLACK);
     stat_area.drawCircle(4, 3, 3, SSD1306_WHITE);
     stat_area.setCursor(10, 6);
-    stat_area.print(radio_online ? "LORA" : "lora");
+    stat_area.print(DS(radio_online) ? "LORA" : "lora");
 
     // Row 2 — WIFI
-    if (!boundary_state.wifi_enabled) {
+    if (!DS(wifi_enabled)) {
       stat_area.drawCircle(4, 13, 3, SSD1306_WHITE);
       stat_area.setCursor(10, 16);
       stat_area.print("wifi");
-    } else if (wifi_is_connected()) {
+    } else if (DS(wifi_up)) {
       stat_area.fillCircle(4, 13, 3, SSD1306_WHITE);
       stat_area.setCursor(10, 16);
       stat_area.print("WIFI");
@@ -831,11 +1008,11 @@ void draw_stat_area() {
     }
 
     // Row 3 — WAN / backbone TCP
-    if (boundary_state.tcp_mode == 0) {
+    if (DS(tcp_mode) == 0) {
       stat_area.drawCircle(4, 23, 3, SSD1306_WHITE);
       stat_area.setCursor(10, 26);
       stat_area.print("wan");
-    } else if (boundary_state.tcp_connected) {
+    } else if (DS(tcp_connected)) {
       stat_area.fillCircle(4, 23, 3, SSD1306_WHITE);
       stat_area.setCursor(10, 26);
       stat_area.print("WAN");
@@ -846,8 +1023,8 @@ void draw_stat_area() {
     }
 
     // Row 4 — LAN / local TCP server (hidden when disabled)
-    if (boundary_state.ap_tcp_enabled) {
-      if (boundary_state.ap_tcp_connected) {
+    if (DS(ap_tcp_enabled)) {
+      if (DS(ap_tcp_connected)) {
         stat_area.fillCircle(4, 33, 3, SSD1306_WHITE);
       } else {
         stat_area.drawCircle(4, 33, 3, SSD1306_WHITE);
@@ -861,13 +1038,13 @@ void draw_stat_area() {
 
     // Airtime — below LAN
     stat_area.setCursor(2, 49);
-    if (radio_online) {
-      stat_area.printf("Air:%.1f%%", airtime * 100.0);
+    if (DS(radio_online)) {
+      stat_area.printf("Air:%.1f%%", DS(airtime) * 100.0);
     }
 
     // Battery + signal — bottom
     draw_battery_bars(4, 56);
-    if (radio_online) {
+    if (DS(radio_online)) {
       draw_quality_bars(28, 56);
       draw_signal_bars(44, 56);
     }
@@ -950,15 +1127,15 @@ void draw_disp_area() {
 
       // Radio info
       disp_area.setCursor(2, 18);
-      if (radio_online) {
-        disp_area.printf("%.3fMHz", (float)lora_freq / 1000000.0);
+      if (DS(radio_online)) {
+        disp_area.printf("%.3fMHz", (float)DS(lora_freq) / 1000000.0);
       } else {
         disp_area.print("Radio OFF");
       }
 
       disp_area.setCursor(2, 29);
-      if (radio_online) {
-        disp_area.printf("SF%d %.0fk", lora_sf, (float)lora_bw / 1000.0);
+      if (DS(radio_online)) {
+        disp_area.printf("SF%d %.0fk", DS(lora_sf), (float)DS(lora_bw) / 1000.0);
       }
 
       // 1px separator after SF line
@@ -966,16 +1143,16 @@ void draw_disp_area() {
 
       // WiFi IP address
       disp_area.setCursor(2, 44);
-      if (boundary_state.wifi_connected) {
-        disp_area.print(wr_device_ip);
+      if (DS(wifi_connected)) {
+        disp_area.print(IPAddress(DS(wifi_ip)));
       } else {
         disp_area.print("No WiFi");
       }
 
       // Local TCP server port (shown only when enabled)
       disp_area.setCursor(2, 55);
-      if (boundary_state.ap_tcp_enabled) {
-        disp_area.printf("Port:%u", boundary_state.ap_tcp_port);
+      if (DS(ap_tcp_enabled)) {
+        disp_area.printf("Port:%u", DS(ap_tcp_port));
       }
 
       // 1px separator after Port line
@@ -1203,9 +1380,13 @@ bool epd_blanked = false;
 extern bool display_lock_white;
 #endif
 
-void update_display(bool blank = false) {
+void display_render(bool blank) {
   #ifdef BOUNDARY_MODE
-  if (display_lock_white) return;
+  if (DS(lock_white)) return;
+  #endif
+  #if DISP_PARTIAL_FLUSH
+    // Previous frame still on the bus, draw the next one on a later pass
+    if (disp_flush_busy) return;
   #endif
   display_updating = true;
   if (blank == true) {
@@ -1244,6 +1425,9 @@ void update_display(bool blank = false) {
       #if BOARD_MODEL == BOARD_HELTEC_T114
         display.clear();
         display.display();
+      #elif DISP_PARTIAL_FLUSH
+        display.clearDisplay();
+        display_flush();
       #elif BOARD_MODEL != BOARD_TDECK && BOARD_MODEL != BOARD_TECHO
         display.clearDisplay();
         display.display();
@@ -1289,6 +1473,8 @@ void update_display(bool blank = false) {
           last_epd_refresh = millis();
           epd_blanked = false;
         }
+      #elif DISP_PARTIAL_FLUSH
+        display_flush();
       #elif BOARD_MODEL != BOARD_TDECK
         display.display();
       #endif
@@ -1299,6 +1485,115 @@ void update_display(bool blank = false) {
   display_updating = false;
 }
 
+#if DISP_SNAPSHOT
+// Runs on loop(): odd sequence while the shared copy is being written
+void display_publish() {
+  DisplaySnapshot s;
+  s.radio_online          = radio_online;
+  s.airtime               = airtime;
+  s.lora_freq             = lora_freq;
+  s.lora_bw               = lora_bw;
+  s.lora_sf               = lora_sf;
+  s.last_snr_raw          = last_snr_raw;
+  s.last_rssi             = last_rssi;
+  s.pmu_ready             = pmu_ready;
+  s.battery_ready         = battery_ready;
+  s.battery_installed     = battery_installed;
+  s.battery_indeterminate = battery_indeterminate;
+  s.battery_percent       = battery_percent;
+  s.battery_state         = battery_state;
+  s.wifi_enabled          = boundary_state.wifi_enabled;
+  s.wifi_up               = wifi_is_connected();
+  s.wifi_connected        = boundary_state.wifi_connected;
+  s.wifi_ip               = (uint32_t)wr_device_ip;
+  s.tcp_mode              = boundary_state.tcp_mode;
+  s.tcp_connected         = boundary_state.tcp_connected;
+  s.ap_tcp_enabled        = boundary_state.ap_tcp_enabled;
+  s.ap_tcp_connected      = boundary_state.ap_tcp_connected;
+  s.ap_tcp_port           = boundary_state.ap_tcp_port;
+  s.lock_white            = display_lock_white;
+
+  uint32_t seq = disp_snap_seq.load(std::memory_order_relaxed);
+  disp_snap_seq.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  memcpy(&disp_snap_shared, &s, sizeof(s));
+  disp_snap_seq.store(seq + 2, std::memory_order_release);
+  disp_last_publish = millis();
+}
+
+// Runs on the renderer: retry until a copy was taken between two writes
+void display_snapshot_read() {
+  while (true) {
+    uint32_t seq = disp_snap_seq.load(std::memory_order_acquire);
+    if (seq & 1) { continue; }
+    memcpy(&disp_snap, &disp_snap_shared, sizeof(disp_snap));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (disp_snap_seq.load(std::memory_order_relaxed) == seq) { return; }
+  }
+}
+#endif
+
+#if DISP_RENDER_TASK
+// The renderer re-reads the snapshot this often; display_render() still
+// only redraws every disp_update_interval
+#define DISP_RENDER_TICK_MS     20
+#define DISP_SNAPSHOT_MS        20
+#define DISP_RENDER_TASK_STACK  4096
+#ifndef ARDUINO_RUNNING_CORE
+#define ARDUINO_RUNNING_CORE 1
+#endif
+#define DISP_RENDER_TASK_CORE   (ARDUINO_RUNNING_CORE == 0 ? 1 : 0)
+volatile bool disp_render_blank = false;
+
+void display_render_task(void* param) {
+  bool white_drawn = false;
+  while (true) {
+    vTaskDelay(pdMS_TO_TICKS(DISP_RENDER_TICK_MS));
+    display_snapshot_read();
+    if (disp_snap.lock_white) {
+      // Hold-to-reset indicator, drawn once
+      if (!white_drawn) {
+        display.fillScreen(SSD1306_WHITE);
+        display_flush();
+        white_drawn = true;
+      }
+      continue;
+    }
+    bool blank = disp_render_blank;
+    disp_render_blank = false;
+    display_render(blank);
+  }
+}
+
+// Called once setup() is done; before that frames are drawn inline
+void display_render_task_start() {
+  if (disp_render_task_handle || !disp_ready) return;
+  display_publish();
+  // Lowest priority, on the core loop() does not run on, so drawing only
+  // takes time the transport task and WiFi leave idle
+  if (xTaskCreatePinnedToCore(display_render_task, "render", DISP_RENDER_TASK_STACK, NULL,
+                              tskIDLE_PRIORITY, &disp_render_task_handle, DISP_RENDER_TASK_CORE) != pdPASS) {
+    disp_render_task_handle = NULL;
+    Serial.println("[Display] Failed to create render task, drawing from loop()");
+  }
+}
+#endif
+
+void update_display(bool blank = false) {
+  #if DISP_SNAPSHOT
+    #if DISP_RENDER_TASK
+      if (disp_render_task_handle) {
+        if (blank) disp_render_blank = true;
+        if (blank || millis()-disp_last_publish >= DISP_SNAPSHOT_MS) display_publish();
+        return;
+      }
+    #endif
+    display_publish();
+    display_snapshot_read();
+  #endif
+  display_render(blank);
+}
+
 void display_unblank() {
   last_unblank_event = millis();
 }
@@ -0,0 +1,418 @@
+// Copyright (C) 2026, Boundary Mode Extension
+// Based on microReticulum_Firmware by Mark Qvist
+//
+// EspNowInterface — An RNS InterfaceImpl that links RTNodes within
+// WiFi range of each other directly over ESP-NOW, without a shared
+// access point. ESP-NOW frames carry at most 250 bytes, so packets are
+// split into fragments of up to EN_IF_FRAG_PAYLOAD bytes and put back
+// together per sending node. Nodes find each other through a broadcast
+// beacon and every packet is sent unicast to each known peer, which
+// gets MAC-level retries.
+//
+// All nodes have to be on the same WiFi channel: the channel of the AP
+// when joined to one, otherwise BOUNDARY_ESPNOW_CHANNEL.
+//
+// Fragment:  'F' | packet id | index << 4 | count | payload
+// Beacon:    'B' | EN_IF_VERSION
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#ifndef ESPNOW_INTERFACE_H
+#define ESPNOW_INTERFACE_H
+
+#ifdef HAS_RNS
+#ifdef BOUNDARY_MODE
+
+#include <WiFi.h>
+#include <esp_now.h>
+#include <esp_wifi.h>
+#include <atomic>
+#include <Interface.h>
+#include <Transport.h>
+#include <Bytes.h>
+#include "TransportTask.h"
+
+// ─── ESP-NOW Interface Configuration ─────────────────────────────────────────
+#define EN_IF_HW_MTU             508     // same as the LoRa interface
+#define EN_IF_FRAME_MAX          ESP_NOW_MAX_DATA_LEN   // 250 bytes
+#define EN_IF_FRAG_HEADER        3
+#define EN_IF_FRAG_PAYLOAD       (EN_IF_FRAME_MAX - EN_IF_FRAG_HEADER)
+#define EN_IF_MAX_PEERS          4
+#define EN_IF_RX_RING            16      // received frames buffered for loop(), power of two
+#define EN_IF_TX_INFLIGHT        12      // frames handed to the driver and not yet reported sent
+#define EN_IF_BEACON_INTERVAL    5000    // ms
+#define EN_IF_PEER_TIMEOUT       30000   // ms without a beacon or data before a peer is dropped
+#define EN_IF_REASSEMBLY_TIMEOUT 500     // ms to wait for the rest of a packet
+#define EN_IF_BITRATE            1000000 // bps, well above LoRa so Transport prefers it
+#define EN_IF_VERSION            1
+
+#define EN_IF_TYPE_FRAGMENT      'F'
+#define EN_IF_TYPE_BEACON        'B'
+
+#if (EN_IF_HW_MTU + EN_IF_FRAG_PAYLOAD - 1) / EN_IF_FRAG_PAYLOAD > 15
+#error "EN_IF_HW_MTU needs more fragments than the header can count"
+#endif
+
+// ─── Frame received in the WiFi task, handed to loop() ──────────────────────
+struct EspNowRxFrame {
+    uint8_t  mac[6];
+    uint8_t  len;
+    uint8_t  data[EN_IF_FRAME_MAX];
+};
+
+// ─── Known node and its reassembly state ────────────────────────────────────
+struct EspNowPeer {
+    bool     active;
+    uint8_t  mac[6];
+    uint32_t last_seen;
+    // Packet being reassembled
+    uint8_t  rx_id;
+    uint8_t  rx_count;
+    uint16_t rx_mask;       // fragments received so far
+    uint16_t rx_len;        // known once the last fragment is in
+    uint32_t rx_started;
+    uint8_t  rx_buf[EN_IF_HW_MTU];
+};
+
+class EspNowInterface;
+// Driver callbacks carry no context
+static EspNowInterface* espnow_interface_instance = nullptr;
+static const uint8_t espnow_broadcast_mac[6] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+
+// ─── EspNowInterface Class ──────────────────────────────────────────────────
+class EspNowInterface : public RNS::InterfaceImpl, public TransportEndpoint {
+public:
+    EspNowInterface(uint8_t channel = 1, const char* name = "EspNowInterface")
+        : RNS::InterfaceImpl(name),
+          _channel(channel),
+          _tx_id(0),
+          _last_beacon(0),
+          _started(false)
+    {
+        _IN = true;
+        _OUT = true;
+        _HW_MTU = EN_IF_HW_MTU;
+        _FIXED_MTU = true;
+        _bitrate = EN_IF_BITRATE;
+        for (int i = 0; i < EN_IF_MAX_PEERS; i++) {
+            _peers[i].active = false;
+        }
+    }
+
+    virtual ~EspNowInterface() {
+        stop();
+    }
+
+    // ─── Lifecycle ───────────────────────────────────────────────────────────
+    bool start() {
+        if (_started) return true;
+
+        // ESP-NOW needs the WiFi driver running, joined to an AP or not
+        wifi_mode_t mode = WIFI_MODE_NULL;
+        esp_wifi_get_mode(&mode);
+        if (mode == WIFI_MODE_NULL) {
+            WiFi.mode(WIFI_STA);
+        }
+        if (WiFi.status() != WL_CONNECTED && mode != WIFI_MODE_AP) {
+            esp_wifi_set_channel(_channel, WIFI_SECOND_CHAN_NONE);
+        }
+
+        if (esp_now_init() != ESP_OK) {
+            Serial.println("[EspNowIF] esp_now_init() failed");
+            return false;
+        }
+        espnow_interface_instance = this;
+        esp_now_register_recv_cb(&EspNowInterface::_on_recv);
+        esp_now_register_send_cb(&EspNowInterface::_on_sent);
+        _add_peer(espnow_broadcast_mac);
+
+        _started = true;
+        _last_beacon = 0;
+        uint8_t primary = 0;
+        wifi_second_chan_t second;
+        esp_wifi_get_channel(&primary, &second);
+        Serial.printf("[EspNowIF] Started on channel %d\r\n", primary);
+        return true;
+    }
+
+    void stop() {
+        if (!_started) return;
+        esp_now_unregister_recv_cb();
+        esp_now_unregister_send_cb();
+        esp_now_deinit();
+        for (int i = 0; i < EN_IF_MAX_PEERS; i++) {
+            _peers[i].active = false;
+        }
+        _inflight = 0;
+        _started = false;
+    }
+
+    // ─── Main loop — call from Arduino loop() ────────────────────────────────
+    void loop() {
+        if (!_started) return;
+
+        // A WiFi reconnect restarts the driver and ESP-NOW goes with it,
+        // the peer list is the cheapest thing to check
+        wifi_mode_t mode = WIFI_MODE_NULL;
+        if (esp_wifi_get_mode(&mode) != ESP_OK || mode == WIFI_MODE_NULL) return;
+        if (!esp_now_is_peer_exist(espnow_broadcast_mac)) {
+            stop();
+            start();
+            return;
+        }
+
+        uint32_t now = millis();
+        EspNowRxFrame frame;
+        while (_rx_pop(frame)) {
+            _handle_frame(frame, now);
+        }
+
+        if (_last_beacon == 0 || now - _last_beacon >= EN_IF_BEACON_INTERVAL) {
+            _last_beacon = now;
+            static const uint8_t beacon[] = { EN_IF_TYPE_BEACON, EN_IF_VERSION };
+            _inflight++;
+            if (esp_now_send(espnow_broadcast_mac, beacon, sizeof(beacon)) != ESP_OK) _inflight--;
+        }
+
+        for (int i = 0; i < EN_IF_MAX_PEERS; i++) {
+            EspNowPeer& p = _peers[i];
+            if (p.active && now - p.last_seen >= EN_IF_PEER_TIMEOUT) {
+                Serial.printf("[EspNowIF] Peer %02x:%02x:%02x:%02x:%02x:%02x timed out\r\n",
+                              p.mac[0], p.mac[1], p.mac[2], p.mac[3], p.mac[4], p.mac[5]);
+                esp_now_del_peer(p.mac);
+                p.active = false;
+            }
+        }
+    }
+
+    // ─── Stats ───────────────────────────────────────────────────────────────
+    bool isStarted()   const { return _started; }
+    bool isConnected() const { return peerCount() > 0; }
+    int  peerCount()   const {
+        int n = 0;
+        for (int i = 0; i < EN_IF_MAX_PEERS; i++) if (_peers[i].active) n++;
+        return n;
+    }
+    uint32_t txDrops() const { return _tx_drops; }
+    uint32_t rxDrops() const { return _rx_drops; }
+
+protected:
+    // ─── TransportEndpoint: runs on the transport task ───────────────────────
+    virtual void deliver_incoming(const RNS::Bytes& data, int8_t client) override {
+        handle_incoming(data);
+    }
+
+    // ─── TransportEndpoint: runs on loop() ───────────────────────────────────
+    virtual void transmit_now(const RNS::Bytes& data, int8_t client) override {
+        _send_packet(data);
+    }
+
+    // ─── RNS InterfaceImpl: outgoing packet from RNS Transport ───────────────
+    virtual void send_outgoing(const RNS::Bytes& data) override {
+        if (!_started || !isConnected()) return;
+
+        if (transport_task_is_current()) {
+            // Driver calls stay on loop(); hand the packet over
+            transport_task_submit_tx(this, data, -1);
+        } else {
+            _send_packet(data);
+        }
+
+        // Post-send housekeeping
+        InterfaceImpl::handle_outgoing(data);
+    }
+
+    // ─── RNS InterfaceImpl: incoming packet to RNS Transport ─────────────────
+    virtual void handle_incoming(const RNS::Bytes& data) override {
+        TRACEF("EspNowInterface.handle_incoming: (%u bytes)", data.size());
+        InterfaceImpl::handle_incoming(data);
+    }
+
+private:
+    // ─── Send: fragment once, unicast the fragments to every peer ────────────
+    void _send_packet(const RNS::Bytes& data) {
+        if (!_started || data.size() == 0 || data.size() > EN_IF_HW_MTU) return;
+
+        uint8_t count = (data.size() + EN_IF_FRAG_PAYLOAD - 1) / EN_IF_FRAG_PAYLOAD;
+        int peers = peerCount();
+        // Whole packets only: a packet missing a fragment is lost anyway
+        if (_inflight.load() + count * peers > EN_IF_TX_INFLIGHT) {
+            _tx_drops++;
+            return;
+        }
+
+        uint8_t id = _tx_id++;
+        uint8_t frame[EN_IF_FRAME_MAX];
+        for (uint8_t idx = 0; idx < count; idx++) {
+            size_t offset = (size_t)idx * EN_IF_FRAG_PAYLOAD;
+            size_t len = data.size() - offset;
+            if (len > EN_IF_FRAG_PAYLOAD) len = EN_IF_FRAG_PAYLOAD;
+            frame[0] = EN_IF_TYPE_FRAGMENT;
+            frame[1] = id;
+            frame[2] = (idx << 4) | count;
+            memcpy(frame + EN_IF_FRAG_HEADER, data.data() + offset, len);
+            for (int i = 0; i < EN_IF_MAX_PEERS; i++) {
+                if (!_peers[i].active) continue;
+                _inflight++;
+                if (esp_now_send(_peers[i].mac, frame, EN_IF_FRAG_HEADER + len) != ESP_OK) {
+                    _inflight--;
+                    _tx_drops++;
+                }
+            }
+        }
+    }
+
+    // ─── Receive: runs on loop() ─────────────────────────────────────────────
+    void _handle_frame(const EspNowRxFrame& f, uint32_t now) {
+        if (f.len < 2) return;
+        EspNowPeer* p = _find_peer(f.mac);
+
+        if (f.data[0] == EN_IF_TYPE_BEACON) {
+            if (p == nullptr) p = _new_peer(f.mac, now);
+            if (p != nullptr) p->last_seen = now;
+            return;
+        }
+        if (f.data[0] != EN_IF_TYPE_FRAGMENT || f.len <= EN_IF_FRAG_HEADER) return;
+        // Data from a node whose beacon we haven't heard yet
+        if (p == nullptr) p = _new_peer(f.mac, now);
+        if (p == nullptr) return;
+        p->last_seen = now;
+
+        uint8_t id    = f.data[1];
+        uint8_t idx   = f.data[2] >> 4;
+        uint8_t count = f.data[2] & 0x0F;
+        size_t  len   = f.len - EN_IF_FRAG_HEADER;
+        size_t  offset = (size_t)idx * EN_IF_FRAG_PAYLOAD;
+        if (count == 0 || idx >= count || offset + len > EN_IF_HW_MTU) return;
+        if (idx + 1 < count && len != EN_IF_FRAG_PAYLOAD) return;
+
+        if (count == 1) {
+            _deliver(RNS::Bytes(f.data + EN_IF_FRAG_HEADER, len));
+            return;
+        }
+
+        // A new packet id, or a stale one, starts over
+        if (p->rx_mask == 0 || p->rx_id != id || p->rx_count != count ||
+            now - p->rx_started >= EN_IF_REASSEMBLY_TIMEOUT) {
+            p->rx_id = id;
+            p->rx_count = count;
+            p->rx_mask = 0;
+            p->rx_len = 0;
+            p->rx_started = now;
+        }
+        memcpy(p->rx_buf + offset, f.data + EN_IF_FRAG_HEADER, len);
+        p->rx_mask |= (1 << idx);
+        if (idx + 1 == count) p->rx_len = offset + len;
+
+        if (p->rx_mask == (uint16_t)((1 << count) - 1)) {
+            _deliver(RNS::Bytes(p->rx_buf, p->rx_len));
+            p->rx_mask = 0;
+        }
+    }
+
+    void _deliver(const RNS::Bytes& data) {
+        if (transport_task_running()) {
+            transport_task_submit_rx(this, data, -1);
+        } else {
+            handle_incoming(data);
+        }
+    }
+
+    EspNowPeer* _find_peer(const uint8_t* mac) {
+        for (int i = 0; i < EN_IF_MAX_PEERS; i++) {
+            if (_peers[i].active && memcmp(_peers[i].mac, mac, 6) == 0) return &_peers[i];
+        }
+        return nullptr;
+    }
+
+    EspNowPeer* _new_peer(const uint8_t* mac, uint32_t now) {
+        for (int i = 0; i < EN_IF_MAX_PEERS; i++) {
+            EspNowPeer& p = _peers[i];
+            if (p.active) continue;
+            if (!_add_peer(mac)) return nullptr;
+            memcpy(p.mac, mac, 6);
+            p.active = true;
+            p.last_seen = now;
+            p.rx_mask = 0;
+            Serial.printf("[EspNowIF] New peer %02x:%02x:%02x:%02x:%02x:%02x\r\n",
+                          mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+            return &p;
+        }
+        return nullptr;
+    }
+
+    bool _add_peer(const uint8_t* mac) {
+        if (esp_now_is_peer_exist(mac)) return true;
+        esp_now_peer_info_t info;
+        memset(&info, 0, sizeof(info));
+        memcpy(info.peer_addr, mac, 6);
+        info.channel = 0;     // whatever channel the driver is on
+        info.ifidx = WIFI_IF_STA;
+        info.encrypt = false;
+        return esp_now_add_peer(&info) == ESP_OK;
+    }
+
+    // ─── Driver callbacks: run in the WiFi task ──────────────────────────────
+    #if ESP_IDF_VERSION_MAJOR >= 5
+    static void _on_recv(const esp_now_recv_info_t* info, const uint8_t* data, int len) {
+        const uint8_t* mac = info->src_addr;
+    #else
+    static void _on_recv(const uint8_t* mac, const uint8_t* data, int len) {
+    #endif
+        EspNowInterface* self = espnow_interface_instance;
+        if (self == nullptr || len <= 0 || len > EN_IF_FRAME_MAX) return;
+        self->_rx_push(mac, data, len);
+    }
+
+    static void _on_sent(const uint8_t* mac, esp_now_send_status_t status) {
+        EspNowInterface* self = espnow_interface_instance;
+        if (self != nullptr && self->_inflight.load() > 0) self->_inflight--;
+    }
+
+    // Single producer (WiFi task), single consumer (loop())
+    void _rx_push(const uint8_t* mac, const uint8_t* data, int len) {
+        uint32_t head = _rx_head.load(std::memory_order_relaxed);
+        if (head - _rx_tail.load(std::memory_order_acquire) >= EN_IF_RX_RING) {
+            _rx_drops++;
+            return;
+        }
+        EspNowRxFrame& slot = _rx_ring[head & (EN_IF_RX_RING - 1)];
+        memcpy(slot.mac, mac, 6);
+        memcpy(slot.data, data, len);
+        slot.len = len;
+        _rx_head.store(head + 1, std::memory_order_release);
+    }
+
+    bool _rx_pop(EspNowRxFrame& frame) {
+        uint32_t tail = _rx_tail.load(std::memory_order_relaxed);
+        if (tail == _rx_head.load(std::memory_order_acquire)) return false;
+        const EspNowRxFrame& slot = _rx_ring[tail & (EN_IF_RX_RING - 1)];
+        memcpy(frame.mac, slot.mac, 6);
+        frame.len = slot.len;
+        memcpy(frame.data, slot.data, slot.len);
+        _rx_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    static_assert((EN_IF_RX_RING & (EN_IF_RX_RING - 1)) == 0, "EN_IF_RX_RING must be a power of two");
+
+    // ─── Member variables ────────────────────────────────────────────────────
+    uint8_t       _channel;
+    EspNowPeer    _peers[EN_IF_MAX_PEERS];
+    EspNowRxFrame _rx_ring[EN_IF_RX_RING];
+    std::atomic<uint32_t> _rx_head{0};
+    std::atomic<uint32_t> _rx_tail{0};
+    std::atomic<int>      _inflight{0};
+    uint8_t       _tx_id;
+    uint32_t      _last_beacon;
+    bool          _started;
+    uint32_t      _tx_drops = 0;
+    uint32_t      _rx_drops = 0;
+};
+
+#endif // BOUNDARY_MODE
+#endif // HAS_RNS
+#endif // ESPNOW_INTERFACE_H
@@ -19,6 +19,7 @@
 		inline virtual const char* name() { return _file->name(); }
 		inline virtual size_t size() { return _file->size(); }
 		inline virtual void close() { _closed = true; _file->close(); }
+		inline virtual bool seek(size_t position) { return _file->seek(position); }
 
 		// Print overrides
 		inline virtual size_t write(uint8_t byte) { return _file->write(byte); }
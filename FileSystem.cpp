@@ -55,6 +55,98 @@ SPIFlash_Device_t g_RAK15001 {
 
 #endif
 
+#if FS_WRITE_BEHIND
+
+#include <map>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+// Pending writes, one per file, newest data wins. An entry stays in the
+// map while its flash write is in flight, so reads keep being served
+// from RAM until the file on flash is complete.
+#define FS_WB_DIRTY_MAX     32768   // bytes held back before write_file() writes through
+#define FS_WB_DELAY_MS      1000    // coalescing window after the first pending write
+#define FS_WB_TASK_STACK    6144
+#define FS_WB_TASK_PRIORITY 1
+
+struct WriteBehindEntry {
+	RNS::Bytes data;
+	uint32_t   generation;
+};
+
+static std::map<std::string, WriteBehindEntry> wb_pending;
+static size_t            wb_dirty_bytes = 0;
+static uint32_t          wb_generation = 0;
+static SemaphoreHandle_t wb_lock = nullptr;      // wb_pending and counters
+static SemaphoreHandle_t wb_io_lock = nullptr;   // flash writes vs remove/rename/list
+static TaskHandle_t      wb_task_handle = nullptr;
+
+class WbLock {
+public:
+	WbLock(SemaphoreHandle_t lock) : _lock(lock) { xSemaphoreTakeRecursive(_lock, portMAX_DELAY); }
+	~WbLock() { xSemaphoreGiveRecursive(_lock); }
+private:
+	SemaphoreHandle_t _lock;
+};
+
+// Drops a pending write, the caller holds wb_lock
+static void wb_forget(const char* file_path) {
+	auto iter = wb_pending.find(file_path);
+	if (iter == wb_pending.end()) return;
+	wb_dirty_bytes -= iter->second.data.size();
+	wb_pending.erase(iter);
+}
+
+// Writes out every pending file, returns once the map is empty
+static void wb_flush_all(FileSystem* fs) {
+	WbLock io(wb_io_lock);
+	while (true) {
+		std::string path;
+		RNS::Bytes data;
+		uint32_t generation;
+		{
+			WbLock lock(wb_lock);
+			if (wb_pending.empty()) return;
+			auto iter = wb_pending.begin();
+			path = iter->first;
+			data = iter->second.data;
+			generation = iter->second.generation;
+		}
+		fs->write_file_now(path.c_str(), data);
+		{
+			WbLock lock(wb_lock);
+			auto iter = wb_pending.find(path);
+			// Rewritten while in flight: leave the newer data for the next pass
+			if (iter != wb_pending.end() && iter->second.generation == generation) {
+				wb_dirty_bytes -= iter->second.data.size();
+				wb_pending.erase(iter);
+			}
+		}
+	}
+}
+
+static void wb_task(void* param) {
+	FileSystem* fs = (FileSystem*)param;
+	while (true) {
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		vTaskDelay(pdMS_TO_TICKS(FS_WB_DELAY_MS));
+		wb_flush_all(fs);
+	}
+}
+
+static void wb_start(FileSystem* fs) {
+	if (wb_task_handle != nullptr) return;
+	wb_lock = xSemaphoreCreateRecursiveMutex();
+	wb_io_lock = xSemaphoreCreateRecursiveMutex();
+	if (xTaskCreate(wb_task, "fs_flush", FS_WB_TASK_STACK, fs, FS_WB_TASK_PRIORITY, &wb_task_handle) != pdPASS) {
+		wb_task_handle = nullptr;
+		ERROR("FileSystem: failed to create flush task, writing through");
+	}
+}
+
+#endif
+
 
 bool FileSystem::init() {
 	TRACE("Initializing filesystem...");
@@ -105,6 +197,9 @@ bool FileSystem::init() {
 		else {
 			remove_file("/test");
 		}
+#if FS_WRITE_BEHIND
+		wb_start(this);
+#endif
 	}
 	catch (std::exception& e) {
 		//ERROR("FileSystem init Exception: " + std::string(e.what()));
@@ -267,11 +362,27 @@ void FileSystem::dumpDir(const char* dir) {
 	}
 	return false;
 */
+#if FS_WRITE_BEHIND
+	if (wb_task_handle != nullptr) {
+		WbLock lock(wb_lock);
+		if (wb_pending.count(file_path) > 0) return true;
+	}
+#endif
 	return FS.exists(file_path);
 }
 
 /*virtua*/ size_t FileSystem::read_file(const char* file_path, RNS::Bytes& data) {
 	TRACEF("read_file: reading from file %s", file_path);
+#if FS_WRITE_BEHIND
+	if (wb_task_handle != nullptr) {
+		WbLock lock(wb_lock);
+		auto iter = wb_pending.find(file_path);
+		if (iter != wb_pending.end()) {
+			data = iter->second.data;
+			return data.size();
+		}
+	}
+#endif
 	size_t read = 0;
 #if FS_TYPE == FS_TYPE_INTERNALFS || FS_TYPE == FS_TYPE_FLASHFS
 	File file(FS);
@@ -297,6 +408,31 @@ void FileSystem::dumpDir(const char* dir) {
 }
 
 /*virtua*/ size_t FileSystem::write_file(const char* file_path, const RNS::Bytes& data) {
+#if FS_WRITE_BEHIND
+	if (wb_task_handle != nullptr) {
+		WbLock lock(wb_lock);
+		auto iter = wb_pending.find(file_path);
+		size_t replaced = (iter != wb_pending.end()) ? iter->second.data.size() : 0;
+		if (wb_dirty_bytes - replaced + data.size() <= FS_WB_DIRTY_MAX) {
+			TRACEF("write_file: queued %u bytes for file %s", data.size(), file_path);
+			bool was_clean = wb_pending.empty();
+			// Bytes share their buffer, the caller's copy is not duplicated
+			WriteBehindEntry& entry = wb_pending[file_path];
+			entry.data = data;
+			entry.generation = ++wb_generation;
+			wb_dirty_bytes += data.size() - replaced;
+			if (was_clean) xTaskNotifyGive(wb_task_handle);
+			return data.size();
+		}
+		// Over the dirty limit: this file is written through
+		wb_forget(file_path);
+	}
+	WbLock io(wb_io_lock);
+#endif
+	return write_file_now(file_path, data);
+}
+
+size_t FileSystem::write_file_now(const char* file_path, const RNS::Bytes& data) {
 	TRACEF("write_file: writing to file %s", file_path);
 	// CBA TODO Replace remove with working truncation
 	if (FS.exists(file_path)) {
@@ -329,6 +465,17 @@ void FileSystem::dumpDir(const char* dir) {
 
 /*virtual*/ RNS::FileStream FileSystem::open_file(const char* file_path, RNS::FileStream::MODE file_mode) {
 	TRACEF("open_file: opening file %s", file_path);
+#if FS_WRITE_BEHIND
+	// Streams go straight to flash, any pending write of the file lands first
+	if (wb_task_handle != nullptr) {
+		bool pending;
+		{
+			WbLock lock(wb_lock);
+			pending = wb_pending.count(file_path) > 0;
+		}
+		if (pending) sync();
+	}
+#endif
 #if FS_TYPE == FS_TYPE_INTERNALFS || FS_TYPE == FS_TYPE_FLASHFS
 	int mode;
 	if (file_mode == RNS::FileStream::MODE_READ) {
@@ -390,11 +537,30 @@ void FileSystem::dumpDir(const char* dir) {
 
 /*virtua*/ bool FileSystem::remove_file(const char* file_path) {
 	TRACEF("remove_file: removing file %s", file_path);
+#if FS_WRITE_BEHIND
+	if (wb_task_handle != nullptr) {
+		WbLock io(wb_io_lock);
+		bool pending;
+		{
+			WbLock lock(wb_lock);
+			pending = wb_pending.count(file_path) > 0;
+			wb_forget(file_path);
+		}
+		return FS.remove(file_path) || pending;
+	}
+#endif
 	return FS.remove(file_path);
 }
 
 /*virtua*/ bool FileSystem::rename_file(const char* from_file_path, const char* to_file_path) {
 	TRACEF("rename_file: renaming file %s to %s", from_file_path, to_file_path);
+#if FS_WRITE_BEHIND
+	if (wb_task_handle != nullptr) {
+		sync();
+		WbLock io(wb_io_lock);
+		return FS.rename(from_file_path, to_file_path);
+	}
+#endif
 	return FS.rename(from_file_path, to_file_path);
 }
 
@@ -425,6 +591,9 @@ void FileSystem::dumpDir(const char* dir) {
 
 /*virtua*/ bool FileSystem::remove_directory(const char* directory_path) {
 	TRACEF("remove_directory: removing directory %s", directory_path);
+#if FS_WRITE_BEHIND
+	if (wb_task_handle != nullptr) sync();
+#endif
 #if FS_TYPE == FS_TYPE_INTERNALFS || FS_TYPE == FS_TYPE_FLASHFS
 	if (!FS.rmdir_r(directory_path)) {
 #else
@@ -438,6 +607,10 @@ void FileSystem::dumpDir(const char* dir) {
 
 /*virtua*/ std::list<std::string> FileSystem::list_directory(const char* directory_path) {
 	TRACEF("list_directory: listing directory %s", directory_path);
+#if FS_WRITE_BEHIND
+	// Files still pending are listed once they are on flash
+	if (wb_task_handle != nullptr) sync();
+#endif
 	std::list<std::string> files;
 	File root = FS.open(directory_path);
 	if (!root) {
@@ -475,4 +648,12 @@ void FileSystem::dumpDir(const char* dir) {
 #endif
 }
 
+/*virtual*/ void FileSystem::sync() {
+#if FS_WRITE_BEHIND
+	if (wb_task_handle != nullptr) {
+		wb_flush_all(this);
+	}
+#endif
+}
+
 #endif
@@ -9,6 +9,16 @@
 
 #include <Stream.h>
 
+// Write-behind: write_file() only queues the data, a background task
+// writes it to flash, coalescing repeated writes of the same file
+#ifndef FS_WRITE_BEHIND
+	#if defined(ESP32)
+		#define FS_WRITE_BEHIND 1
+	#else
+		#define FS_WRITE_BEHIND 0
+	#endif
+#endif
+
 class FileSystem : public RNS::FileSystemImpl {
 
 public:
@@ -35,6 +45,10 @@ public:
 	virtual std::list<std::string> list_directory(const char* directory_path);
 	virtual size_t storage_size();
 	virtual size_t storage_available();
+	virtual void sync();
+
+	// Writes to flash immediately, bypassing write-behind
+	size_t write_file_now(const char* file_path, const RNS::Bytes& data);
 
 };
 
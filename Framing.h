@@ -47,7 +47,15 @@
   #define CMD_STAT_BAT    0x27
   #define CMD_STAT_CSMA   0x28
   #define CMD_STAT_TEMP   0x29
+  #define CMD_STAT_MEM    0x2A
+  #define CMD_STAT_BOOT   0x2B
+  #define CMD_STAT_LOOP   0x2C
+  #define CMD_BENCHMARK   0x2D
+  #define CMD_PROFILE     0x2E
+  #define CMD_STAT_HIST   0x2F
   #define CMD_BLINK       0x30
+  #define CMD_BACKBONE    0x31
+  #define CMD_STAT_TASKS  0x32
   #define CMD_RANDOM      0x40
 
   #define CMD_FB_EXT      0x41
@@ -105,6 +113,8 @@
   #define NIBBLE_SEQ      0xF0
   #define NIBBLE_FLAGS    0x0F
   #define FLAG_SPLIT      0x01
+  #define FLAG_AGGR       0x02    // Frame carries several length-prefixed packets
+  #define FLAG_AGGR_OK    0x04    // Sender can receive aggregated frames
   #define SEQ_UNSET       0xFF
 
   #define CMD_ERROR           0x90
@@ -91,9 +91,18 @@
         if (held > 5000 && !display_lock_white) {
           display_lock_white = true;
           #if HAS_DISPLAY
+          #if DISP_RENDER_TASK
+          // The render task picks it up from the next snapshot
+          if (disp_ready && !disp_render_task_handle) {
+          #else
           if (disp_ready) {
+          #endif
             display.fillScreen(SSD1306_WHITE);
+            #if DISP_PARTIAL_FLUSH
+            display_flush();
+            #else
             display.display();
+            #endif
           }
           #endif
           headless_led_fast_blink();
@@ -0,0 +1,266 @@
+// Copyright (C) 2026, Boundary Mode Extension
+// Based on microReticulum_Firmware by Mark Qvist
+//
+// LiveConfig.h — Radio and backbone settings changed without a reboot.
+//
+// The captive portal takes a reboot into setup and back, which costs the
+// warm path table, every link and the boot itself. The settings that are
+// safe to swap under a running Transport are taken here instead:
+//
+//   frequency, bandwidth, SF, CR, TX power   KISS CMD_FREQUENCY ..
+//                                            CMD_CR, POST /config
+//   backbone host list and port              KISS CMD_BACKBONE,
+//                                            POST /config
+//
+// Requests are merged into one pending change on loop(). A radio change
+// first lets the LoRa TX queue drain: the LoRa interface refuses new
+// frames (Transport holds announces, as under backpressure), and once the
+// queue and the transport task's handoff rings are empty and nothing is
+// on air or being received, or after
+// LIVE_CONFIG_DRAIN_MS, the settings are applied through the same
+// setFrequency() .. updateBitrate() path as at boot and saved. A backbone
+// change swaps the upstream list of the running TcpInterface, which
+// reconnects; Transport, its paths and its links are untouched.
+//
+// Only the backbone of a node booted with the TCP client enabled can be
+// swapped; otherwise the target is saved and used from the next boot.
+//
+// CMD_BACKBONE payload, also the reply:
+//
+//   port(2, big-endian) host list, NUL terminated
+//
+// and a frame of a single 0x00 asks for the current target; it is answered
+// when the frame ends, since a set may start with a 0x00 port byte. POST /config takes the
+// portal's field names (freq in MHz, bw, sf, cr, txp, bb_host, bb_port),
+// any subset of them, and the config token set in the portal in an
+// X-Config-Token header. Browsers will not send a custom header cross-site
+// without a CORS preflight, which the status server never answers, so a
+// page on another origin cannot post to it. With no token set every
+// request is refused.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#ifndef LIVE_CONFIG_H
+#define LIVE_CONFIG_H
+
+#ifdef HAS_RNS
+#ifdef BOUNDARY_MODE
+#if BOUNDARY_LIVE_CONFIG
+
+#define HAS_LIVE_CONFIG true
+
+#include <algorithm>
+#include <atomic>
+
+// Defined in RNode_Firmware.ino
+extern TxQueue tx_queue;
+extern TcpInterface* tcp_interface_ptr;
+bool lora_tx_active();
+void lora_receive();
+
+// ─── Pending Change ──────────────────────────────────────────────────────────
+#define LIVE_FREQ      0x01
+#define LIVE_BW        0x02
+#define LIVE_SF        0x04
+#define LIVE_CR        0x08
+#define LIVE_TXP       0x10
+#define LIVE_RADIO     (LIVE_FREQ | LIVE_BW | LIVE_SF | LIVE_CR | LIVE_TXP)
+#define LIVE_BACKBONE  0x20
+
+struct LiveConfigRequest {
+    uint8_t  fields;
+    uint32_t freq;
+    uint32_t bw;
+    uint8_t  sf;
+    uint8_t  cr;
+    uint8_t  txp;
+    char     host[sizeof(boundary_state.backbone_host)];
+    uint16_t port;
+};
+
+static LiveConfigRequest live_pending;          // loop() only
+static LiveConfigRequest live_posted;           // handed over by the async_tcp task
+static std::atomic<bool> live_posted_ready{false};
+static std::atomic<bool> live_radio_hold{false};
+static uint32_t          live_drain_started = 0;
+
+// Read by the LoRa interface, from the transport task too
+inline bool live_config_holding_tx() {
+    return live_radio_hold.load(std::memory_order_relaxed);
+}
+
+// Same limits as the KISS CMD_TXPOWER handler
+inline uint8_t live_config_txp_max() {
+    #if MODEM == SX1262
+        #if HAS_LORA_PA
+            return PA_MAX_OUTPUT;
+        #else
+            return 22;
+        #endif
+    #elif MODEM == SX1280
+        #if HAS_PA
+            return 20;
+        #else
+            return 13;
+        #endif
+    #else
+        return 17;
+    #endif
+}
+
+// Also clamps the TX power to what this board can put out
+inline bool live_config_valid(LiveConfigRequest& r) {
+    if ((r.fields & LIVE_FREQ) && r.freq == 0) return false;
+    if ((r.fields & LIVE_BW) && r.bw == 0) return false;
+    if ((r.fields & LIVE_SF) && (r.sf < 5 || r.sf > 12)) return false;
+    if ((r.fields & LIVE_CR) && (r.cr < 5 || r.cr > 8)) return false;
+    if ((r.fields & LIVE_TXP) && r.txp < 2) return false;
+    if ((r.fields & LIVE_TXP) && r.txp > live_config_txp_max()) r.txp = live_config_txp_max();
+    if ((r.fields & LIVE_BACKBONE) && (r.host[0] == '\0' || r.port == 0)) return false;
+    return true;
+}
+
+// Runs on the async_tcp task. The token is only written by the portal,
+// which runs before the status server exists. Compared in constant time.
+inline bool live_config_token_ok(const char* given) {
+    const char* token = boundary_state.config_token;
+    size_t len = strlen(token);
+    if (len == 0 || strlen(given) != len) return false;
+    uint8_t diff = 0;
+    for (size_t i = 0; i < len; i++) diff |= (uint8_t)(token[i] ^ given[i]);
+    return diff == 0;
+}
+
+// Runs on the async_tcp task. False while an earlier request has not been
+// taken by loop() yet.
+inline bool live_config_post(const LiveConfigRequest& r) {
+    if (live_posted_ready.load(std::memory_order_acquire)) return false;
+    live_posted = r;
+    live_posted_ready.store(true, std::memory_order_release);
+    return true;
+}
+
+// Runs on loop()
+inline void live_config_merge(const LiveConfigRequest& r) {
+    if (r.fields & LIVE_FREQ) live_pending.freq = r.freq;
+    if (r.fields & LIVE_BW)   live_pending.bw   = r.bw;
+    if (r.fields & LIVE_SF)   live_pending.sf   = r.sf;
+    if (r.fields & LIVE_CR)   live_pending.cr   = r.cr;
+    if (r.fields & LIVE_TXP)  live_pending.txp  = r.txp;
+    if (r.fields & LIVE_BACKBONE) {
+        memcpy(live_pending.host, r.host, sizeof(live_pending.host));
+        live_pending.port = r.port;
+    }
+    if ((r.fields & LIVE_RADIO) && !(live_pending.fields & LIVE_RADIO)) {
+        live_drain_started = millis();
+        live_radio_hold.store(true, std::memory_order_relaxed);
+    }
+    live_pending.fields |= r.fields;
+}
+
+// Runs on loop(), for the KISS radio commands
+inline void live_config_radio(uint8_t field, uint32_t value) {
+    LiveConfigRequest r;
+    memset(&r, 0, sizeof(r));
+    r.fields = field;
+    if (field == LIVE_FREQ) r.freq = value;
+    if (field == LIVE_BW)   r.bw   = value;
+    if (field == LIVE_SF)   r.sf   = (uint8_t)value;
+    if (field == LIVE_CR)   r.cr   = (uint8_t)value;
+    if (field == LIVE_TXP)  r.txp  = (uint8_t)value;
+    live_config_merge(r);
+}
+
+// ─── Apply ───────────────────────────────────────────────────────────────────
+inline void live_config_apply_backbone() {
+    memcpy(boundary_state.backbone_host, live_pending.host, sizeof(boundary_state.backbone_host));
+    boundary_state.backbone_host[sizeof(boundary_state.backbone_host) - 1] = '\0';
+    boundary_state.backbone_port = live_pending.port;
+    boundary_save_config();
+    if (tcp_interface_ptr) {
+        tcp_interface_ptr->setUpstreams(boundary_state.backbone_host, boundary_state.backbone_port);
+        ringlog_printf("[Config] Backbone -> %s:%u\r\n", boundary_state.backbone_host, boundary_state.backbone_port);
+    } else {
+        ringlog_printf("[Config] Backbone %s:%u saved, used from the next boot\r\n",
+                       boundary_state.backbone_host, boundary_state.backbone_port);
+    }
+}
+
+inline void live_config_apply_radio() {
+    uint8_t f = live_pending.fields;
+    if (f & LIVE_FREQ) { lora_freq = live_pending.freq; setFrequency(); }
+    if (f & LIVE_BW)   { lora_bw   = live_pending.bw;   setBandwidth(); }
+    if (f & LIVE_SF)   { lora_sf   = live_pending.sf;   setSpreadingFactor(); }
+    if (f & LIVE_CR)   { lora_cr   = live_pending.cr;   setCodingRate(); }
+    if (f & LIVE_TXP)  { lora_txp  = live_pending.txp;  setTXPower(); }
+    if (radio_online) lora_receive();
+    boundary_save_radio_config();
+
+    if (f & LIVE_FREQ) kiss_indicate_frequency();
+    if (f & LIVE_BW)   kiss_indicate_bandwidth();
+    if (f & LIVE_SF)   kiss_indicate_spreadingfactor();
+    if (f & LIVE_CR)   kiss_indicate_codingrate();
+    if (f & LIVE_TXP)  kiss_indicate_txpower();
+    ringlog_printf("[Config] Radio %lu Hz, %lu Hz BW, SF%d, CR4/%d, %d dBm\r\n",
+                   (unsigned long)lora_freq, (unsigned long)lora_bw, lora_sf, lora_cr, lora_txp);
+}
+
+// Called from loop(). Returns true when new radio settings were applied,
+// so the LoRa interface can let held frames go again.
+inline bool live_config_service() {
+    if (live_posted_ready.load(std::memory_order_acquire)) {
+        live_config_merge(live_posted);
+        live_posted_ready.store(false, std::memory_order_release);
+    }
+    if (live_pending.fields == 0) return false;
+
+    if (live_pending.fields & LIVE_BACKBONE) {
+        live_config_apply_backbone();
+        live_pending.fields &= ~LIVE_BACKBONE;
+    }
+
+    if (!(live_pending.fields & LIVE_RADIO)) return false;
+    // A frame the transport task has handed over is not in tx_queue yet
+    bool drained = tx_queue.height() == 0 && transport_task_idle() && !lora_tx_active() && !dcd;
+    if (!drained && millis() - live_drain_started < LIVE_CONFIG_DRAIN_MS) return false;
+    live_config_apply_radio();
+    live_pending.fields = 0;
+    live_radio_hold.store(false, std::memory_order_relaxed);
+    return true;
+}
+
+// ─── KISS ────────────────────────────────────────────────────────────────────
+inline void kiss_indicate_backbone() {
+    serial_write(FEND);
+    serial_write(CMD_BACKBONE);
+    escaped_serial_write((uint8_t)(boundary_state.backbone_port >> 8));
+    escaped_serial_write((uint8_t)boundary_state.backbone_port);
+    escaped_serial_write((const uint8_t*)boundary_state.backbone_host, strlen(boundary_state.backbone_host));
+    escaped_serial_write((uint8_t)0x00);
+    serial_write(FEND);
+}
+
+// cmd holds port(2) and the host list, len bytes with the NUL. The reply
+// carries the target in use, so a rejected set reads back unchanged.
+inline void kiss_backbone_command(const uint8_t* cmd, size_t len) {
+    LiveConfigRequest r;
+    memset(&r, 0, sizeof(r));
+    r.fields = LIVE_BACKBONE;
+    r.port = (uint16_t)cmd[0] << 8 | cmd[1];
+    size_t host_len = std::min(len - 3, sizeof(r.host) - 1);
+    memcpy(r.host, cmd + 2, host_len);
+    if (live_config_valid(r)) {
+        live_config_merge(r);
+        live_config_apply_backbone();
+        live_pending.fields &= ~LIVE_BACKBONE;
+    }
+    kiss_indicate_backbone();
+}
+
+#endif // BOUNDARY_LIVE_CONFIG
+#endif // BOUNDARY_MODE
+#endif // HAS_RNS
+#endif // LIVE_CONFIG_H
@@ -0,0 +1,274 @@
+// Copyright (C) 2026, Boundary Mode Extension
+// Based on microReticulum_Firmware by Mark Qvist
+//
+// LoopProfiler.h — Per-stage latency histograms and slow-iteration log.
+//
+// loop() and Transport::jobs() are split into stages. Each stage is
+// timed with the CPU cycle counter and counted into a log2 histogram of
+// microseconds (bucket n holds 2^(n-1) .. 2^n - 1 us, the last bucket
+// everything longer). An iteration that takes longer than
+// LOOP_PROFILE_SLOW_US in total is kept, with its stage breakdown, in a
+// ring of the last LOOP_PROFILE_SLOW_RECORDS, and printed:
+//
+//   [Slow] loop 312.4 ms: transport=0.1 tcp=305.2 radio=4.8 ...
+//
+// CMD_STAT_LOOP returns one KISS frame per profiler:
+//
+//   id(1) stage_count(1) bucket_count(1)
+//   { max_us(4) count(4) buckets(4) * bucket_count } * stage_count
+//   slow_count(1) { at_ms(4) total_us(4) stage_us(4) * stage_count } * slow_count
+//
+// all big-endian, id 0 for loop() and 1 for Transport jobs, slow
+// iterations oldest first. The same histograms are exported on the
+// metrics endpoint.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#ifndef LOOP_PROFILER_H
+#define LOOP_PROFILER_H
+
+#if defined(HAS_RNS) && defined(BOUNDARY_MODE) && BOUNDARY_LOOP_PROFILE
+
+#define HAS_LOOP_PROFILE true
+
+// ─── Profiler Configuration ──────────────────────────────────────────────────
+#define LOOP_PROFILE_BUCKETS       20      // up to 2^18 us, then 262 ms and over
+#define LOOP_PROFILE_MAX_STAGES    12
+#define LOOP_PROFILE_SLOW_RECORDS  8
+#ifndef LOOP_PROFILE_SLOW_US
+#define LOOP_PROFILE_SLOW_US       50000   // iterations this long are recorded
+#endif
+
+enum LoopStage : uint8_t {
+    LOOP_TRANSPORT = 0,  // reticulum.loop() or the transport task's TX ring
+    LOOP_WATCHDOG,       // heap/WiFi watchdog, memory report, metrics
+    LOOP_TCP,            // TCP backbone, local TCP server and UDP
+    LOOP_ESPNOW,
+    LOOP_LORA2,
+    LOOP_RADIO,          // LoRa RX handoff, TX queue, channel sampling
+    LOOP_SERIAL,         // buffer_serial()
+    LOOP_DISPLAY,        // update_display()
+    LOOP_PERIPHERALS,    // PMU, Bluetooth, WiFi, button
+    LOOP_STAGE_COUNT
+};
+
+static const char* const loop_stage_names[LOOP_STAGE_COUNT] = {
+    "transport", "watchdog", "tcp", "espnow", "lora2",
+    "radio", "serial", "display", "peripherals"
+};
+
+// In RNS::Transport::job_types order, plus what jobs() does after them
+#define JOBS_STAGE_COUNT 13
+static const char* const jobs_stage_names[JOBS_STAGE_COUNT] = {
+    "pending_links", "active_links", "receipts", "announces",
+    "reverse_cull", "link_cull", "path_cull", "discovery_cull",
+    "path_request_cull", "local_request_cull", "tunnel_cull", "path_warm",
+    "tail"
+};
+
+struct SlowIteration {
+    uint32_t at_ms;
+    uint32_t total_us;
+    uint32_t stage_us[LOOP_PROFILE_MAX_STAGES];
+};
+
+// Written by one task only; readers on other tasks may see a histogram
+// mid-update, which only matters to the bucket being incremented.
+class StageProfiler {
+public:
+    StageProfiler(uint8_t id, const char* name, const char* const* stage_names, uint8_t stage_count)
+        : _id(id), _name(name), _stage_names(stage_names),
+          _stage_count(stage_count > LOOP_PROFILE_MAX_STAGES ? LOOP_PROFILE_MAX_STAGES : stage_count) {}
+
+    inline void begin() {
+        _mhz = ESP.getCpuFreqMHz();
+        _start = _last = ESP.getCycleCount();
+        memset(_current, 0, sizeof(_current));
+        _marked = 0;
+        _running = true;
+    }
+
+    // Time since the previous mark (or begin) was spent in stage
+    inline void mark(uint8_t stage) {
+        if (!_running || stage >= _stage_count) return;
+        uint32_t now = ESP.getCycleCount();
+        uint32_t us = (now - _last) / _mhz;
+        _last = now;
+        _current[stage] += us;
+        _marked |= 1UL << stage;
+    }
+
+    inline void end() {
+        if (!_running) return;
+        _running = false;
+        uint32_t total = (ESP.getCycleCount() - _start) / _mhz;
+        for (uint8_t i = 0; i < _stage_count; i++) {
+            // Stages that did not run this pass are left out of the histograms
+            if (!(_marked & (1UL << i))) continue;
+            uint32_t us = _current[i];
+            _buckets[i][bucket_for(us)]++;
+            _count[i]++;
+            if (us > _max_us[i]) _max_us[i] = us;
+        }
+        if (total >= LOOP_PROFILE_SLOW_US) _record_slow(total);
+    }
+
+    static inline uint8_t bucket_for(uint32_t us) {
+        uint8_t b = us == 0 ? 0 : 32 - __builtin_clz(us);
+        return b >= LOOP_PROFILE_BUCKETS ? LOOP_PROFILE_BUCKETS - 1 : b;
+    }
+
+    // Upper bound of bucket b in microseconds, 0 for the open last bucket
+    static inline uint32_t bucket_limit(uint8_t b) {
+        return b >= LOOP_PROFILE_BUCKETS - 1 ? 0 : (1UL << b) - 1;
+    }
+
+    inline void kiss_indicate() const {
+        serial_write(FEND);
+        serial_write(CMD_STAT_LOOP);
+        escaped_serial_write(_id);
+        escaped_serial_write(_stage_count);
+        escaped_serial_write(LOOP_PROFILE_BUCKETS);
+        for (uint8_t i = 0; i < _stage_count; i++) {
+            _write32(_max_us[i]);
+            _write32(_count[i]);
+            for (uint8_t b = 0; b < LOOP_PROFILE_BUCKETS; b++) _write32(_buckets[i][b]);
+        }
+        escaped_serial_write(_slow_count);
+        for (uint8_t n = 0; n < _slow_count; n++) {
+            const SlowIteration& s = _slow[(_slow_next + LOOP_PROFILE_SLOW_RECORDS - _slow_count + n) % LOOP_PROFILE_SLOW_RECORDS];
+            _write32(s.at_ms);
+            _write32(s.total_us);
+            for (uint8_t i = 0; i < _stage_count; i++) _write32(s.stage_us[i]);
+        }
+        serial_write(FEND);
+    }
+
+    const char*  name() const { return _name; }
+    const char*  stage_name(uint8_t i) const { return _stage_names[i]; }
+    uint8_t      stage_count() const { return _stage_count; }
+    uint32_t     bucket(uint8_t stage, uint8_t b) const { return _buckets[stage][b]; }
+    uint32_t     count(uint8_t stage) const { return _count[stage]; }
+    uint32_t     max_us(uint8_t stage) const { return _max_us[stage]; }
+    uint32_t     slow_total() const { return _slow_total; }
+
+private:
+    void _record_slow(uint32_t total) {
+        SlowIteration& s = _slow[_slow_next];
+        s.at_ms = millis();
+        s.total_us = total;
+        memcpy(s.stage_us, _current, sizeof(s.stage_us));
+        _slow_next = (_slow_next + 1) % LOOP_PROFILE_SLOW_RECORDS;
+        if (_slow_count < LOOP_PROFILE_SLOW_RECORDS) _slow_count++;
+        _slow_total++;
+
+        char line[256];
+        size_t pos = snprintf(line, sizeof(line), "[Slow] %s %.1f ms:", _name, total / 1000.0);
+        for (uint8_t i = 0; i < _stage_count && pos < sizeof(line); i++) {
+            if (!(_marked & (1UL << i))) continue;
+            pos += snprintf(line + pos, sizeof(line) - pos, " %s=%.1f", _stage_names[i], _current[i] / 1000.0);
+        }
+        Serial.printf("%s\r\n", line);
+    }
+
+    static void _write32(uint32_t value) {
+        escaped_serial_write(value >> 24);
+        escaped_serial_write(value >> 16);
+        escaped_serial_write(value >> 8);
+        escaped_serial_write(value);
+    }
+
+    const uint8_t            _id;
+    const char*              _name;
+    const char* const*       _stage_names;
+    const uint8_t            _stage_count;
+    uint32_t                 _mhz = 240;
+    uint32_t                 _start = 0;
+    uint32_t                 _last = 0;
+    bool                     _running = false;
+    uint32_t                 _marked = 0;
+    uint32_t                 _current[LOOP_PROFILE_MAX_STAGES] = {0};
+    uint32_t                 _buckets[LOOP_PROFILE_MAX_STAGES][LOOP_PROFILE_BUCKETS] = {{0}};
+    uint32_t                 _count[LOOP_PROFILE_MAX_STAGES] = {0};
+    uint32_t                 _max_us[LOOP_PROFILE_MAX_STAGES] = {0};
+    SlowIteration            _slow[LOOP_PROFILE_SLOW_RECORDS];
+    uint8_t                  _slow_next = 0;
+    uint8_t                  _slow_count = 0;
+    uint32_t                 _slow_total = 0;
+};
+
+StageProfiler loop_profiler(0, "loop", loop_stage_names, LOOP_STAGE_COUNT);
+#define LOOP_PROFILE_BEGIN()      loop_profiler.begin()
+#define LOOP_PROFILE_MARK(stage)  loop_profiler.mark(stage)
+#define LOOP_PROFILE_END()        loop_profiler.end()
+StageProfiler jobs_profiler(1, "jobs", jobs_stage_names, JOBS_STAGE_COUNT);
+
+// Transport::jobs() callback, runs on whichever task runs jobs()
+inline void jobs_profile_mark(int8_t stage) {
+    if (stage < 0) { jobs_profiler.begin(); return; }
+    jobs_profiler.mark(stage < JOBS_STAGE_COUNT - 1 ? stage : JOBS_STAGE_COUNT - 1);
+    if (stage >= JOBS_STAGE_COUNT - 1) jobs_profiler.end();
+}
+
+inline void kiss_indicate_loop_profile() {
+    loop_profiler.kiss_indicate();
+    jobs_profiler.kiss_indicate();
+}
+
+#ifdef HAS_METRICS
+// ─── Metrics export ──────────────────────────────────────────────────────────
+// Cumulative log2 buckets, le in microseconds
+inline void loop_profile_write(MetricsWriter& w, const char* name, const StageProfiler& p) {
+    char labels[64];
+    for (uint8_t i = 0; i < p.stage_count(); i++) {
+        uint32_t total = 0;
+        for (uint8_t b = 0; b < LOOP_PROFILE_BUCKETS; b++) {
+            total += p.bucket(i, b);
+            uint32_t le = StageProfiler::bucket_limit(b);
+            if (le) snprintf(labels, sizeof(labels), "stage=\"%s\",le=\"%u\"", p.stage_name(i), (unsigned)le);
+            else    snprintf(labels, sizeof(labels), "stage=\"%s\",le=\"+Inf\"", p.stage_name(i));
+            char bucket_name[48];
+            snprintf(bucket_name, sizeof(bucket_name), "%s_bucket", name);
+            w.value(bucket_name, labels, total);
+        }
+        snprintf(labels, sizeof(labels), "stage=\"%s\"", p.stage_name(i));
+        char count_name[48];
+        snprintf(count_name, sizeof(count_name), "%s_count", name);
+        w.value(count_name, labels, p.count(i));
+    }
+}
+
+inline void loop_profile_collect(MetricsWriter& w) {
+    w.family("rnode_loop_stage_us", "histogram", "Time spent per loop() stage, microseconds");
+    loop_profile_write(w, "rnode_loop_stage_us", loop_profiler);
+    w.family("rnode_jobs_stage_us", "histogram", "Time spent per Transport job, microseconds");
+    loop_profile_write(w, "rnode_jobs_stage_us", jobs_profiler);
+    w.family("rnode_loop_slow_total", "counter", "Iterations over the slow threshold");
+    char labels[24];
+    snprintf(labels, sizeof(labels), "profile=\"loop\"");
+    w.value("rnode_loop_slow_total", labels, loop_profiler.slow_total());
+    snprintf(labels, sizeof(labels), "profile=\"jobs\"");
+    w.value("rnode_loop_slow_total", labels, jobs_profiler.slow_total());
+}
+#endif
+
+// Called once Reticulum is up
+inline void loop_profile_setup() {
+    RNS::Transport::set_jobs_profile_callback(jobs_profile_mark);
+#ifdef HAS_METRICS
+    metrics_add_collector(loop_profile_collect);
+#endif
+}
+
+#endif
+
+#ifndef LOOP_PROFILE_BEGIN
+#define LOOP_PROFILE_BEGIN()
+#define LOOP_PROFILE_MARK(stage)
+#define LOOP_PROFILE_END()
+#endif
+
+#endif // LOOP_PROFILER_H
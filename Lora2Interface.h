@@ -0,0 +1,319 @@
+// Copyright (C) 2026, Boundary Mode Extension
+// Based on microReticulum_Firmware by Mark Qvist
+//
+// Lora2Interface — A second LoRa interface for boards carrying two
+// SX1262 modems, e.g. one on a long-range channel and one on a fast
+// SF7 channel. The primary radio stays with the RNode firmware core
+// (the global LoRa modem, tx_queue, airtime and CSMA state); this
+// interface owns everything for the second one: its sx126x instance,
+// its own TxQueue and a small CSMA state machine. Both are registered
+// with Transport and run concurrently.
+//
+// Frames use the standard RNode 1-byte header and two-frame split, so
+// plain RNodes on the second channel interoperate with it.
+//
+// Both modems sit on the one SPI bus, which has no lock. Every access to
+// the second modem (polling, receive callback, CSMA and transmit) runs on
+// loop(), like the primary's; frames from the transport task come over
+// the TX ring and are queued in transmit_now().
+//
+// Build with -DHAS_LORA2=1 and the second modem's pins:
+//   -DLORA2_PIN_CS=.. -DLORA2_PIN_RESET=.. -DLORA2_PIN_DIO=.. -DLORA2_PIN_BUSY=..
+// and optionally LORA2_FREQ, LORA2_BW, LORA2_SF, LORA2_CR, LORA2_TXP.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#ifndef LORA2_INTERFACE_H
+#define LORA2_INTERFACE_H
+
+#ifdef HAS_RNS
+#if HAS_LORA2
+
+#include <Interface.h>
+#include <Transport.h>
+#include <Bytes.h>
+#include "sx126x.h"
+#include "TxQueue.h"
+#include "TransportTask.h"
+
+#if MODEM != SX1262
+#error "The second LoRa interface needs an SX1262 board"
+#endif
+#if !defined(LORA2_PIN_CS) || !defined(LORA2_PIN_RESET) || !defined(LORA2_PIN_DIO) || !defined(LORA2_PIN_BUSY)
+#error "HAS_LORA2 needs LORA2_PIN_CS, LORA2_PIN_RESET, LORA2_PIN_DIO and LORA2_PIN_BUSY"
+#endif
+
+// ─── Second Radio Configuration ──────────────────────────────────────────────
+#ifndef LORA2_FREQ
+#define LORA2_FREQ               868100000
+#endif
+#ifndef LORA2_BW
+#define LORA2_BW                 125000
+#endif
+#ifndef LORA2_SF
+#define LORA2_SF                 7
+#endif
+#ifndef LORA2_CR
+#define LORA2_CR                 5
+#endif
+#ifndef LORA2_TXP
+#define LORA2_TXP                14
+#endif
+#define LORA2_HW_MTU             508
+#define LORA2_CW_SLOTS           15      // contention window, in slots
+
+class Lora2Interface;
+// The modem's receive callback carries no context
+static Lora2Interface* lora2_interface_instance = nullptr;
+
+// ─── Lora2Interface Class ───────────────────────────────────────────────────
+class Lora2Interface : public RNS::InterfaceImpl, public TransportEndpoint {
+public:
+    Lora2Interface(const char* name = "Lora2Interface")
+        : RNS::InterfaceImpl(name),
+          _started(false),
+          _tx_active(false),
+          _tx_slot(0),
+          _tx_data(nullptr),
+          _tx_length(0),
+          _tx_offset(0),
+          _tx_header(0),
+          _wait_start(0),
+          _wait_target(0),
+          _rx_seq(SEQ_UNSET),
+          _rx_len(0)
+    {
+        _IN = true;
+        _OUT = true;
+        _HW_MTU = LORA2_HW_MTU;
+        _announce_cap = RNS::Type::Reticulum::ANNOUNCE_CAP / 100.0;
+
+        // Same formulas as updateBitrate() for the primary radio
+        float symbol_rate = (float)LORA2_BW / (float)(1 << LORA2_SF);
+        float symbol_time_ms = 1000.0 / symbol_rate;
+        _bitrate = (uint32_t)(LORA2_SF * ((4.0 / (float)LORA2_CR) / ((float)(1 << LORA2_SF) / ((float)LORA2_BW / 1000.0))) * 1000.0);
+        _slot_ms = (uint32_t)(symbol_time_ms * CSMA_SLOT_SYMBOLS);
+        if (_slot_ms < CSMA_SLOT_MIN_MS) _slot_ms = CSMA_SLOT_MIN_MS;
+        if (_slot_ms > CSMA_SLOT_MAX_MS) _slot_ms = CSMA_SLOT_MAX_MS;
+        _dcd_window_ms = (long)ceil((LORA_PREAMBLE_SYMBOLS_MIN + PHY_HEADER_LORA_SYMBOLS) * symbol_time_ms);
+    }
+
+    virtual ~Lora2Interface() {
+        stop();
+    }
+
+    // ─── Lifecycle ───────────────────────────────────────────────────────────
+    bool start() {
+        if (_started) return true;
+
+        _modem.setPins(LORA2_PIN_CS, LORA2_PIN_RESET, LORA2_PIN_DIO, LORA2_PIN_BUSY);
+        if (!_modem.begin(LORA2_FREQ)) {
+            Serial.println("[Lora2IF] Second radio did not start");
+            return false;
+        }
+        _modem.setTxPower(LORA2_TXP);
+        _modem.setSignalBandwidth(LORA2_BW);
+        _modem.setSpreadingFactor(LORA2_SF);
+        _modem.setCodingRate4(LORA2_CR);
+        _modem.setPreambleLength(LORA_PREAMBLE_SYMBOLS_MIN);
+        _modem.setDcdWindow(_dcd_window_ms);
+        _modem.enableCrc();
+
+        lora2_interface_instance = this;
+        _modem.onReceive(&Lora2Interface::_on_receive);
+        _modem.receive();
+
+        _started = true;
+        writable();
+        Serial.printf("[Lora2IF] Started at %lu Hz, SF%d, %lu Hz, %lu bps\r\n",
+                      (unsigned long)LORA2_FREQ, LORA2_SF, (unsigned long)LORA2_BW, (unsigned long)_bitrate);
+        return true;
+    }
+
+    // The modem is put to sleep but the shared SPI bus is left running
+    void stop() {
+        if (!_started) return;
+        _modem.onReceive(NULL);
+        _modem.sleep();
+        if (_tx_active) {
+            _queue.release(_tx_slot);
+            _tx_active = false;
+        }
+        _started = false;
+    }
+
+    // ─── Main loop — call from Arduino loop() ────────────────────────────────
+    void loop() {
+        // SPI is only driven from loop(), see above
+        if (!_started || transport_task_is_current()) return;
+        _modem.pollDio0();
+        _service_tx();
+    }
+
+    // ─── Stats ───────────────────────────────────────────────────────────────
+    bool isStarted() const { return _started; }
+    uint8_t queued() const { return _queue.height(); }
+
+protected:
+    // ─── TransportEndpoint: runs on the transport task ───────────────────────
+    virtual void deliver_incoming(const RNS::Bytes& data, int8_t client) override {
+        handle_incoming(data);
+    }
+
+    // ─── TransportEndpoint: runs on loop() ───────────────────────────────────
+    virtual void transmit_now(const RNS::Bytes& data, int8_t client) override {
+        _queue.push(data.data(), data.size());
+    }
+
+    // ─── RNS InterfaceImpl: outgoing packet from RNS Transport ───────────────
+    // Whole frames only, as the primary LoRa interface (advisory from the transport task)
+    virtual bool can_send(const RNS::Bytes& data) const override {
+        return _started && _queue.accepts(data.data(), data.size());
+    }
+
+    virtual uint16_t queue_depth() const override { return _queue.height(); }
+
+    virtual void send_outgoing(const RNS::Bytes& data) override {
+        if (!_started) return;
+
+        if (transport_task_is_current()) {
+            // Radio work stays on loop(); hand the packet over
+            transport_task_submit_tx(this, data, -1);
+        } else {
+            _queue.push(data.data(), data.size());
+        }
+
+        // Post-send housekeeping
+        InterfaceImpl::handle_outgoing(data);
+    }
+
+    // ─── RNS InterfaceImpl: incoming packet to RNS Transport ─────────────────
+    virtual void handle_incoming(const RNS::Bytes& data) override {
+        TRACEF("Lora2Interface.handle_incoming: (%u bytes)", data.size());
+        InterfaceImpl::handle_incoming(data);
+    }
+
+private:
+    // ─── Receive ─────────────────────────────────────────────────────────────
+    static void _on_receive(int packet_size) {
+        if (lora2_interface_instance) lora2_interface_instance->_receive(packet_size);
+    }
+
+    void _receive(int packet_size) {
+        if (packet_size < 1) return;
+        uint8_t header = _modem.read(); packet_size--;
+        uint8_t sequence = packetSequence(header);
+
+        if (isSplitPacket(header)) {
+            if (_rx_seq == sequence) {
+                // Second half
+                _rx_len += _modem.readPayload(_rx_buf + _rx_len, min(packet_size, LORA2_HW_MTU - _rx_len));
+                _rx_seq = SEQ_UNSET;
+                _deliver(_rx_buf, _rx_len);
+            } else {
+                // First half, anything older in the buffer is lost
+                _rx_seq = sequence;
+                _rx_len = _modem.readPayload(_rx_buf, min(packet_size, LORA2_HW_MTU));
+            }
+            return;
+        }
+
+        _rx_seq = SEQ_UNSET;
+        // Received straight into the Bytes handed to Transport
+        RNS::Bytes data;
+        uint8_t* buf = data.writable(packet_size);
+        data.resize(_modem.readPayload(buf, packet_size));
+        _submit(data);
+    }
+
+    void _deliver(const uint8_t* buf, uint16_t len) {
+        RNS::Bytes data(buf, len);
+        _submit(data);
+    }
+
+    void _submit(const RNS::Bytes& data) {
+        if (data.size() == 0) return;
+        if (transport_task_running()) {
+            transport_task_submit_rx(this, data, -1);
+        } else {
+            handle_incoming(data);
+        }
+    }
+
+    // ─── Transmit ────────────────────────────────────────────────────────────
+    // DIFS and a random contention window of free channel before each
+    // packet; the window is counted while the channel stays free
+    void _service_tx() {
+        if (_tx_active) {
+            int result = _modem.pollTransmit();
+            if (result == 0) return;
+            if (result < 0) {
+                Serial.println("[Lora2IF] Transmit timed out");
+                _tx_offset = _tx_length;
+            }
+            if (_tx_offset < _tx_length) { _transmit_part(); return; }
+            _queue.release(_tx_slot);
+            _tx_active = false;
+            writable();
+            _modem.receive();
+            return;
+        }
+
+        if (_queue.height() == 0) return;
+        uint32_t now = millis();
+        if (_modem.dcd()) { _wait_start = 0; return; }
+        if (_wait_start == 0) {
+            _wait_start = now;
+            _wait_target = 2 * _slot_ms + random(LORA2_CW_SLOTS) * _slot_ms;
+            return;
+        }
+        if (now - _wait_start < _wait_target) return;
+        _wait_start = 0;
+
+        if (!_queue.pop(_tx_slot, _tx_data, _tx_length)) return;
+        _tx_active = true;
+        _tx_offset = 0;
+        _tx_header = random(256) & 0xF0;
+        if (_tx_length > SINGLE_MTU - HEADER_L) _tx_header |= FLAG_SPLIT;
+        _transmit_part();
+    }
+
+    void _transmit_part() {
+        uint16_t size = _tx_length - _tx_offset;
+        if (size > SINGLE_MTU - HEADER_L) size = SINGLE_MTU - HEADER_L;
+        uint8_t frame[SINGLE_MTU];
+        frame[0] = _tx_header;
+        memcpy(frame + HEADER_L, _tx_data + _tx_offset, size);
+        _modem.beginPacket();
+        _modem.write(frame, size + HEADER_L);
+        _modem.startTransmit();
+        _tx_offset += size;
+    }
+
+    // ─── Member variables ────────────────────────────────────────────────────
+    sx126x          _modem;
+    TxQueue         _queue;
+    bool            _started;
+    uint32_t        _slot_ms;
+    long            _dcd_window_ms;
+
+    bool            _tx_active;
+    uint8_t         _tx_slot;
+    const uint8_t*  _tx_data;
+    uint16_t        _tx_length;
+    uint16_t        _tx_offset;
+    uint8_t         _tx_header;
+    uint32_t        _wait_start;
+    uint32_t        _wait_target;
+
+    uint8_t         _rx_seq;
+    uint16_t        _rx_len;
+    uint8_t         _rx_buf[LORA2_HW_MTU];
+};
+
+#endif // HAS_LORA2
+#endif // HAS_RNS
+#endif // LORA2_INTERFACE_H
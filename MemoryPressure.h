@@ -0,0 +1,237 @@
+// Copyright (C) 2026, Boundary Mode Extension
+// Based on microReticulum_Firmware by Mark Qvist
+//
+// MemoryPressure.h — Sheds memory under heap pressure before rebooting.
+//
+// Once a second the free internal heap is compared with two watermarks
+// (BoundaryMode.h). Below MEM_PRESSURE_LOW_BYTES the registered shed
+// actions for that level run in priority order, stopping as soon as the
+// heap is back above the low watermark; below MEM_PRESSURE_CRITICAL_BYTES
+// the critical actions run as well. When the heap recovers, actions that
+// restrict the node (refusing link requests) are undone.
+//
+// A reboot is the last resort: only when every action has run and the
+// heap stays below MEM_PRESSURE_REBOOT_BYTES for MEM_PRESSURE_REBOOT_MS.
+//
+// Shed actions touch Transport state, so memory_pressure_service() runs
+// on the transport task while there is one and from loop() otherwise.
+// Each action's runs and dropped entries are exported as metrics:
+//
+//   rnode_memory_shed_runs_total{action="held_announces"} 3
+//   rnode_memory_shed_entries_total{action="held_announces"} 41
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#ifndef MEMORY_PRESSURE_H
+#define MEMORY_PRESSURE_H
+
+#ifdef HAS_RNS
+#ifdef BOUNDARY_MODE
+#if BOUNDARY_MEMORY_PRESSURE
+
+#define HAS_MEMORY_PRESSURE true
+
+#include <Transport.h>
+#include <Identity.h>
+#include <Utilities/OS.h>
+
+// ─── Memory Pressure Configuration ───────────────────────────────────────────
+#define MEM_PRESSURE_INTERVAL     1000    // ms between checks
+#define MEM_PRESSURE_REBOOT_MS    10000   // below the floor this long, nothing left to shed
+#define MEM_PRESSURE_MAX_ACTIONS  8
+#define MEM_PRESSURE_KNOWN_FLOOR  32      // known destinations kept at critical
+
+enum MemPressureLevel : uint8_t {
+    MEM_LEVEL_NORMAL = 0,
+    MEM_LEVEL_LOW,
+    MEM_LEVEL_CRITICAL,
+};
+
+// Returns the number of entries dropped
+typedef size_t (*MemShedFn)(uint8_t level);
+// Pressure is gone, lift whatever the action restricted
+typedef void (*MemRelieveFn)();
+
+struct MemShedAction {
+    const char*  name;
+    uint8_t      level;                  // lowest level the action runs at
+    uint8_t      priority;               // lower runs first
+    MemShedFn    shed;
+    MemRelieveFn relieve;
+    bool         applied;
+    uint32_t     runs;
+    uint32_t     dropped;
+};
+
+static MemShedAction mem_actions[MEM_PRESSURE_MAX_ACTIONS];
+static uint8_t       mem_action_count = 0;
+static uint8_t       mem_level = MEM_LEVEL_NORMAL;
+static uint32_t      mem_last_check = 0;
+static uint32_t      mem_floor_since = 0;     // millis() the heap went under the reboot floor
+
+// ─── Registry ────────────────────────────────────────────────────────────────
+inline bool memory_pressure_register(const char* name, uint8_t level, uint8_t priority, MemShedFn shed, MemRelieveFn relieve = nullptr) {
+    if (mem_action_count >= MEM_PRESSURE_MAX_ACTIONS) {
+        Serial.printf("[Memory] Shed registry full, %s not registered\r\n", name);
+        return false;
+    }
+    // kept sorted by priority
+    uint8_t i = mem_action_count++;
+    while (i > 0 && mem_actions[i - 1].priority > priority) {
+        mem_actions[i] = mem_actions[i - 1];
+        i--;
+    }
+    mem_actions[i] = { name, level, priority, shed, relieve, false, 0, 0 };
+    return true;
+}
+
+// ─── Service ─────────────────────────────────────────────────────────────────
+inline uint8_t memory_pressure_level(uint32_t free_heap) {
+    if (free_heap < MEM_PRESSURE_CRITICAL_BYTES) return MEM_LEVEL_CRITICAL;
+    if (free_heap < MEM_PRESSURE_LOW_BYTES) return MEM_LEVEL_LOW;
+    return MEM_LEVEL_NORMAL;
+}
+
+inline void memory_pressure_relieve() {
+    for (uint8_t i = 0; i < mem_action_count; i++) {
+        MemShedAction& action = mem_actions[i];
+        if (action.applied && action.relieve) action.relieve();
+        action.applied = false;
+    }
+}
+
+inline void memory_pressure_service() {
+    uint32_t now = millis();
+    if (now - mem_last_check < MEM_PRESSURE_INTERVAL) return;
+    mem_last_check = now;
+
+    uint32_t free_heap = ESP.getFreeHeap();
+    uint8_t level = memory_pressure_level(free_heap);
+    if (level == MEM_LEVEL_NORMAL) {
+        if (mem_level != MEM_LEVEL_NORMAL) {
+            memory_pressure_relieve();
+            ringlog_printf("[Memory] Pressure relieved, free heap %u\r\n", (unsigned)free_heap);
+        }
+        mem_level = MEM_LEVEL_NORMAL;
+        mem_floor_since = 0;
+        return;
+    }
+    if (level > mem_level) {
+        ringlog_printf("[Memory] %s pressure, free heap %u\r\n",
+                       level == MEM_LEVEL_CRITICAL ? "Critical" : "Low", (unsigned)free_heap);
+    }
+    mem_level = level;
+
+    for (uint8_t i = 0; i < mem_action_count; i++) {
+        MemShedAction& action = mem_actions[i];
+        if (action.level > level) continue;
+        size_t dropped = action.shed(level);
+        action.applied = true;
+        action.runs++;
+        action.dropped += dropped;
+        if (dropped > 0) {
+            ringlog_printf("[Memory] Shed %s: %u entries\r\n", action.name, (unsigned)dropped);
+        }
+        if (ESP.getFreeHeap() >= MEM_PRESSURE_LOW_BYTES) break;
+    }
+
+    // ── Last resort ─────────────────────────────────────────────────────────
+    free_heap = ESP.getFreeHeap();
+    if (free_heap >= MEM_PRESSURE_REBOOT_BYTES) {
+        mem_floor_since = 0;
+        return;
+    }
+    if (mem_floor_since == 0) {
+        mem_floor_since = now;
+        return;
+    }
+    if (now - mem_floor_since >= MEM_PRESSURE_REBOOT_MS) {
+        ringlog_printf("\r\n[WATCHDOG] CRITICAL: Free heap %u < %u after shedding — REBOOTING\r\n",
+                       (unsigned)free_heap, (unsigned)MEM_PRESSURE_REBOOT_BYTES);
+        ringlog_printf("[WATCHDOG] Min free: %u  Max alloc: %u\r\n",
+                       ESP.getMinFreeHeap(), ESP.getMaxAllocHeap());
+        ringlog_flush();
+        RNS::Utilities::OS::sync_filesystem();
+        delay(100);
+        ESP.restart();
+    }
+}
+
+// ─── Shed Actions ────────────────────────────────────────────────────────────
+static size_t mem_shed_held_announces(uint8_t level) {
+    return RNS::Transport::shed_held_announces();
+}
+
+// Half the announce validation queue at low pressure, all of it at critical
+static size_t mem_shed_announce_queue(uint8_t level) {
+    return RNS::Transport::shed_announce_queue(level == MEM_LEVEL_CRITICAL ? 0 : RNS::Type::Transport::ANNOUNCE_VALIDATION_MAXSIZE / 2);
+}
+
+// Cached announces move to the spill file on flash
+static size_t mem_shed_packet_cache(uint8_t level) {
+    return RNS::Transport::shed_packet_cache();
+}
+
+static size_t mem_shed_recalled_identities(uint8_t level) {
+    return RNS::Identity::clear_recalled_identities();
+}
+
+static size_t mem_shed_known_destinations(uint8_t level) {
+    return RNS::Identity::cull_known_destinations(MEM_PRESSURE_KNOWN_FLOOR);
+}
+
+static size_t mem_shed_link_requests(uint8_t level) {
+    if (!RNS::Transport::accept_link_requests()) return 0;
+    RNS::Transport::accept_link_requests(false);
+    ringlog_printf("[Memory] Refusing new link requests\r\n");
+    return 1;
+}
+
+static void mem_relieve_link_requests() {
+    RNS::Transport::accept_link_requests(true);
+    ringlog_printf("[Memory] Accepting link requests again\r\n");
+}
+
+#ifdef HAS_METRICS
+// ─── Metrics export ──────────────────────────────────────────────────────────
+inline void memory_pressure_collect(MetricsWriter& w) {
+    char labels[48];
+    w.family("rnode_memory_pressure_level", "gauge", "0 normal, 1 low, 2 critical");
+    w.value("rnode_memory_pressure_level", nullptr, (uint32_t)mem_level);
+    w.family("rnode_memory_shed_runs_total", "counter", "Times each shed action ran");
+    for (uint8_t i = 0; i < mem_action_count; i++) {
+        snprintf(labels, sizeof(labels), "action=\"%s\"", mem_actions[i].name);
+        w.value("rnode_memory_shed_runs_total", labels, mem_actions[i].runs);
+    }
+    w.family("rnode_memory_shed_entries_total", "counter", "Entries dropped by each shed action");
+    for (uint8_t i = 0; i < mem_action_count; i++) {
+        snprintf(labels, sizeof(labels), "action=\"%s\"", mem_actions[i].name);
+        w.value("rnode_memory_shed_entries_total", labels, mem_actions[i].dropped);
+    }
+    w.family("rnode_link_requests_rejected_total", "counter", "Link requests refused under memory pressure");
+    w.value("rnode_link_requests_rejected_total", nullptr, RNS::Transport::link_requests_rejected());
+}
+#endif
+
+// Called once Reticulum is up, before the transport task starts
+inline void memory_pressure_setup() {
+    memory_pressure_register("held_announces",      MEM_LEVEL_LOW,      10, mem_shed_held_announces);
+    memory_pressure_register("announce_queue",      MEM_LEVEL_LOW,      20, mem_shed_announce_queue);
+    memory_pressure_register("packet_cache",        MEM_LEVEL_LOW,      25, mem_shed_packet_cache);
+    memory_pressure_register("recalled_identities", MEM_LEVEL_LOW,      30, mem_shed_recalled_identities);
+    memory_pressure_register("link_requests",       MEM_LEVEL_CRITICAL, 40, mem_shed_link_requests, mem_relieve_link_requests);
+    memory_pressure_register("known_destinations",  MEM_LEVEL_CRITICAL, 50, mem_shed_known_destinations);
+    transport_task_service_hook = memory_pressure_service;
+#ifdef HAS_METRICS
+    metrics_add_collector(memory_pressure_collect);
+#endif
+}
+
+#endif // BOUNDARY_MEMORY_PRESSURE
+#endif // BOUNDARY_MODE
+#endif // HAS_RNS
+
+#endif // MEMORY_PRESSURE_H
@@ -0,0 +1,108 @@
+// Copyright (C) 2026, Boundary Mode Extension
+// Based on microReticulum_Firmware by Mark Qvist
+//
+// MemoryReport.h — Periodic compact memory report.
+//
+// Every MEMORY_REPORT_INTERVAL the allocator totals, TLSF pool
+// fragmentation and (with RNS_USE_ALLOC_TAGS) the live bytes and high
+// water mark of each tagged subsystem are printed as one serial line:
+//
+//   [Memory] live=61.2K peak=74.0K tlsf free=1.71M max=1.69M frag=1%
+//   [Memory] path_table=18.4K/20.1K known_dests=6.2K/6.9K ...
+//
+// and sent to the host as a CMD_STAT_MEM KISS frame:
+//
+//   live_size(4) high_water(4) pool_free(4) pool_max_free(4)
+//   fragmentation(1) tag_count(1) { size(4) high_water(4) } * tag_count
+//
+// all big-endian, tags in RNS::Utilities::OS::AllocTag order.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#ifndef MEMORY_REPORT_H
+#define MEMORY_REPORT_H
+
+#if defined(HAS_RNS) && defined(RNS_USE_ALLOCATOR)
+
+#include <Utilities/OS.h>
+
+#define MEMORY_REPORT_INTERVAL  60000   // ms
+
+// Human readable size: 912, 61.2K, 1.71M
+static const char* memory_report_size(char* buf, size_t len, uint32_t size) {
+    if (size < 1024)            snprintf(buf, len, "%u", (unsigned)size);
+    else if (size < 1048576)    snprintf(buf, len, "%.1fK", size / 1024.0);
+    else                        snprintf(buf, len, "%.2fM", size / 1048576.0);
+    return buf;
+}
+
+static void memory_report_write32(uint32_t value) {
+    escaped_serial_write(value >> 24);
+    escaped_serial_write(value >> 16);
+    escaped_serial_write(value >> 8);
+    escaped_serial_write(value);
+}
+
+inline void kiss_indicate_memory_stats(const RNS::Utilities::OS::AllocatorReport& report) {
+    serial_write(FEND);
+    serial_write(CMD_STAT_MEM);
+    memory_report_write32(report.live_size);
+    memory_report_write32(report.high_water);
+    memory_report_write32(report.pool_free);
+    memory_report_write32(report.pool_max_free);
+    escaped_serial_write(report.fragmentation);
+#if defined(RNS_USE_ALLOC_TAGS)
+    escaped_serial_write(RNS::Utilities::OS::TAG_COUNT);
+    for (uint8_t tag = 0; tag < RNS::Utilities::OS::TAG_COUNT; tag++) {
+        RNS::Utilities::OS::AllocTagStats stats = RNS::Utilities::OS::alloc_tag_stats(tag);
+        memory_report_write32(stats.size);
+        memory_report_write32(stats.high_water);
+    }
+#else
+    escaped_serial_write(0);
+#endif
+    serial_write(FEND);
+}
+
+// Called from loop()
+inline void memory_report_service() {
+    static uint32_t last_report = 0;
+    if (millis() - last_report < MEMORY_REPORT_INTERVAL) return;
+    last_report = millis();
+
+    RNS::Utilities::OS::AllocatorReport report;
+    RNS::Utilities::OS::allocator_report(report);
+
+    char a[12], b[12], c[12], d[12];
+    Serial.printf("[Memory] live=%s peak=%s tlsf free=%s max=%s frag=%u%% faults=%u\r\n",
+                  memory_report_size(a, sizeof(a), report.live_size),
+                  memory_report_size(b, sizeof(b), report.high_water),
+                  memory_report_size(c, sizeof(c), report.pool_free),
+                  memory_report_size(d, sizeof(d), report.pool_max_free),
+                  report.fragmentation, report.faults);
+#if defined(RNS_USE_ALLOC_TAGS)
+    char line[256];
+    size_t pos = snprintf(line, sizeof(line), "[Memory]");
+    for (uint8_t tag = 0; tag < RNS::Utilities::OS::TAG_COUNT && pos < sizeof(line); tag++) {
+        RNS::Utilities::OS::AllocTagStats stats = RNS::Utilities::OS::alloc_tag_stats(tag);
+        pos += snprintf(line + pos, sizeof(line) - pos, " %s=%s/%s",
+                        RNS::Utilities::OS::alloc_tag_name(tag),
+                        memory_report_size(a, sizeof(a), stats.size),
+                        memory_report_size(b, sizeof(b), stats.high_water));
+    }
+    Serial.printf("%s\r\n", line);
+#endif
+
+    kiss_indicate_memory_stats(report);
+}
+
+#else
+
+inline void memory_report_service() {}
+
+#endif
+
+#endif // MEMORY_REPORT_H
@@ -0,0 +1,339 @@
+// Copyright (C) 2026, Boundary Mode Extension
+// Based on microReticulum_Firmware by Mark Qvist
+//
+// Metrics.h — Metrics registry and Prometheus /metrics endpoint.
+//
+// Code on the hot path owns MetricCounter, MetricGauge and
+// MetricHistogram objects as statics and updates them with relaxed
+// atomics; nothing is allocated and nothing is locked. They are listed
+// once at startup with metrics_register(). Figures that already live
+// elsewhere (interface traffic, queue depths, heap) are not copied on
+// every change, a collector registered with metrics_add_collector()
+// reads them when a scrape comes in.
+//
+// Histograms have fixed bucket bounds, so the same metric from every
+// node in a fleet can be summed bucket by bucket on the Prometheus side.
+// Counters are 32 bits and wrap, which Prometheus treats as a reset.
+//
+// Served on the WiFi station address only:
+//
+//   scrape_configs:
+//     - job_name: rtnode
+//       static_configs:
+//         - targets: ['10.0.0.42:9100']
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#ifdef HAS_RNS
+#ifdef BOUNDARY_MODE
+#if BOUNDARY_METRICS
+
+#include <WiFi.h>
+#include <lwip/sockets.h>
+#include <errno.h>
+#include <atomic>
+
+#define HAS_METRICS true
+
+// ─── Metrics Configuration ───────────────────────────────────────────────────
+#define METRICS_MAX_ENTRIES      16
+#define METRICS_MAX_COLLECTORS   4
+#define METRICS_HIST_MAX_BUCKETS 12      // bounds per histogram, +Inf is extra
+#define METRICS_REQ_TIMEOUT      1000    // ms to receive the request headers
+#define METRICS_SEND_TIMEOUT     5000    // ms to get the response out
+#define METRICS_OUT_BUFFER       512     // bytes written to the socket per loop() pass
+#define METRICS_OUT_MAX          16384   // response size limit, the rest is cut
+
+// ─── Metric types ────────────────────────────────────────────────────────────
+struct MetricCounter {
+    std::atomic<uint32_t> value{0};
+    inline void inc(uint32_t n = 1) { value.fetch_add(n, std::memory_order_relaxed); }
+    inline uint32_t get() const { return value.load(std::memory_order_relaxed); }
+};
+
+struct MetricGauge {
+    std::atomic<int32_t> value{0};
+    inline void set(int32_t v) { value.store(v, std::memory_order_relaxed); }
+    inline void add(int32_t d) { value.fetch_add(d, std::memory_order_relaxed); }
+    inline int32_t get() const { return value.load(std::memory_order_relaxed); }
+};
+
+// bounds are ascending upper bucket limits (le), count at most
+// METRICS_HIST_MAX_BUCKETS; buckets[] are per bucket, summed when written
+struct MetricHistogram {
+    MetricHistogram(const int32_t* bounds, uint8_t count)
+        : bounds(bounds), bound_count(count > METRICS_HIST_MAX_BUCKETS ? METRICS_HIST_MAX_BUCKETS : count) {}
+
+    inline void observe(int32_t v) {
+        uint8_t i = 0;
+        while (i < bound_count && v > bounds[i]) i++;
+        buckets[i].fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(v, std::memory_order_relaxed);
+    }
+
+    const int32_t*        bounds;
+    const uint8_t         bound_count;
+    std::atomic<uint32_t> buckets[METRICS_HIST_MAX_BUCKETS + 1] = {};
+    std::atomic<int32_t>  sum{0};
+};
+
+// ─── Text format writer ──────────────────────────────────────────────────────
+// Formats the whole response into a heap buffer, grown METRICS_OUT_BUFFER
+// at a time up to METRICS_OUT_MAX; metrics_service() sends it out
+// without blocking. release() hands the buffer over.
+class MetricsWriter {
+public:
+    MetricsWriter() : _buf(nullptr), _len(0), _cap(0) {}
+    ~MetricsWriter() { free(_buf); }
+
+    void family(const char* name, const char* type, const char* help) {
+        print("# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+    }
+
+    // labels without braces, e.g. "interface=\"lora\"", or nullptr
+    void value(const char* name, const char* labels, uint32_t v) {
+        if (labels) print("%s{%s} %u\n", name, labels, (unsigned)v);
+        else        print("%s %u\n", name, (unsigned)v);
+    }
+
+    void value(const char* name, const char* labels, int32_t v) {
+        if (labels) print("%s{%s} %d\n", name, labels, (int)v);
+        else        print("%s %d\n", name, (int)v);
+    }
+
+    void value(const char* name, const char* labels, float v) {
+        if (labels) print("%s{%s} %.4f\n", name, labels, v);
+        else        print("%s %.4f\n", name, v);
+    }
+
+    void histogram(const char* name, const MetricHistogram& h) {
+        uint32_t total = 0;
+        for (uint8_t i = 0; i <= h.bound_count; i++) {
+            total += h.buckets[i].load(std::memory_order_relaxed);
+            if (i < h.bound_count) print("%s_bucket{le=\"%d\"} %u\n", name, (int)h.bounds[i], (unsigned)total);
+            else                   print("%s_bucket{le=\"+Inf\"} %u\n", name, (unsigned)total);
+        }
+        print("%s_sum %d\n%s_count %u\n", name, (int)h.sum.load(std::memory_order_relaxed), name, (unsigned)total);
+    }
+
+    void text(const char* s) { append(s, strlen(s)); }
+
+    char* release(size_t& len) {
+        char* buf = _buf;
+        len = _len;
+        _buf = nullptr;
+        _len = _cap = 0;
+        return buf;
+    }
+
+private:
+    void print(const char* fmt, ...) {
+        char line[160];
+        va_list args;
+        va_start(args, fmt);
+        int n = vsnprintf(line, sizeof(line), fmt, args);
+        va_end(args);
+        if (n <= 0) return;
+        if (n >= (int)sizeof(line)) n = sizeof(line) - 1;
+        append(line, n);
+    }
+
+    void append(const char* data, size_t n) {
+        if (_len + n > _cap) {
+            size_t cap = _cap;
+            while (cap < _len + n) cap += METRICS_OUT_BUFFER;
+            if (cap > METRICS_OUT_MAX) return;
+            char* grown = (char*)realloc(_buf, cap);
+            if (!grown) return;
+            _buf = grown;
+            _cap = cap;
+        }
+        memcpy(_buf + _len, data, n);
+        _len += n;
+    }
+
+    char*  _buf;
+    size_t _len;
+    size_t _cap;
+};
+
+// ─── Registry ────────────────────────────────────────────────────────────────
+enum MetricType : uint8_t {
+    METRIC_COUNTER,
+    METRIC_GAUGE,
+    METRIC_HISTOGRAM,
+};
+
+struct MetricEntry {
+    const char* name;
+    const char* help;
+    MetricType  type;
+    const void* metric;
+};
+
+typedef void (*MetricsCollector)(MetricsWriter& w);
+
+static MetricEntry      metrics_entries[METRICS_MAX_ENTRIES];
+static uint8_t          metrics_entry_count = 0;
+static MetricsCollector metrics_collectors[METRICS_MAX_COLLECTORS];
+static uint8_t          metrics_collector_count = 0;
+
+inline bool metrics_add_entry(const char* name, const char* help, MetricType type, const void* metric) {
+    if (metrics_entry_count >= METRICS_MAX_ENTRIES) {
+        Serial.printf("[Metrics] Registry full, %s not exported\r\n", name);
+        return false;
+    }
+    metrics_entries[metrics_entry_count++] = { name, help, type, metric };
+    return true;
+}
+
+inline bool metrics_register(const char* name, const char* help, const MetricCounter& m)   { return metrics_add_entry(name, help, METRIC_COUNTER, &m); }
+inline bool metrics_register(const char* name, const char* help, const MetricGauge& m)     { return metrics_add_entry(name, help, METRIC_GAUGE, &m); }
+inline bool metrics_register(const char* name, const char* help, const MetricHistogram& m) { return metrics_add_entry(name, help, METRIC_HISTOGRAM, &m); }
+
+inline bool metrics_add_collector(MetricsCollector collector) {
+    if (metrics_collector_count >= METRICS_MAX_COLLECTORS) return false;
+    metrics_collectors[metrics_collector_count++] = collector;
+    return true;
+}
+
+inline void metrics_write(MetricsWriter& w) {
+    for (uint8_t i = 0; i < metrics_entry_count; i++) {
+        const MetricEntry& e = metrics_entries[i];
+        switch (e.type) {
+            case METRIC_COUNTER:
+                w.family(e.name, "counter", e.help);
+                w.value(e.name, nullptr, ((const MetricCounter*)e.metric)->get());
+                break;
+            case METRIC_GAUGE:
+                w.family(e.name, "gauge", e.help);
+                w.value(e.name, nullptr, ((const MetricGauge*)e.metric)->get());
+                break;
+            case METRIC_HISTOGRAM:
+                w.family(e.name, "histogram", e.help);
+                w.histogram(e.name, *(const MetricHistogram*)e.metric);
+                break;
+        }
+    }
+    for (uint8_t i = 0; i < metrics_collector_count; i++) {
+        metrics_collectors[i](w);
+    }
+}
+
+// ─── HTTP endpoint ───────────────────────────────────────────────────────────
+// One client at a time. The request is read a little on every loop()
+// pass; only the request line matters, the headers are skipped. The
+// response is then sent METRICS_OUT_BUFFER bytes per pass with
+// MSG_DONTWAIT, so a slow scraper never holds up loop().
+static WiFiServer* metrics_server = nullptr;
+static WiFiClient  metrics_client;
+static uint32_t    metrics_client_at = 0;
+static char        metrics_request[32];
+static uint8_t     metrics_request_len = 0;
+static bool        metrics_line_done = false;
+static uint32_t    metrics_tail = 0;          // last four bytes, "\r\n\r\n" ends the headers
+static char*       metrics_out = nullptr;     // response being sent
+static size_t      metrics_out_len = 0;
+static size_t      metrics_out_sent = 0;
+
+inline void metrics_close() {
+    metrics_client.stop();
+    free(metrics_out);
+    metrics_out = nullptr;
+    metrics_out_len = 0;
+    metrics_out_sent = 0;
+}
+
+inline void metrics_respond() {
+    bool found = strncmp(metrics_request, "GET /metrics", 12) == 0 &&
+                 (metrics_request[12] == ' ' || metrics_request[12] == '?');
+    MetricsWriter w;
+    if (!found) {
+        w.text("HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+    } else {
+        w.text("HTTP/1.1 200 OK\r\n"
+               "Content-Type: text/plain; version=0.0.4\r\n"
+               "Connection: close\r\n\r\n");
+        metrics_write(w);
+    }
+    metrics_out = w.release(metrics_out_len);
+    metrics_out_sent = 0;
+    metrics_client_at = millis();
+}
+
+// Returns true once the response is out or the client is gone
+inline bool metrics_send() {
+    if (!metrics_out) return true;
+    int fd = metrics_client.fd();
+    if (fd < 0) return true;
+    size_t chunk = metrics_out_len - metrics_out_sent;
+    if (chunk > METRICS_OUT_BUFFER) chunk = METRICS_OUT_BUFFER;
+    ssize_t sent = send(fd, metrics_out + metrics_out_sent, chunk, MSG_DONTWAIT);
+    if (sent < 0) return (errno != EAGAIN && errno != EWOULDBLOCK);
+    metrics_out_sent += sent;
+    return metrics_out_sent >= metrics_out_len;
+}
+
+// Called from loop()
+inline void metrics_service() {
+    if (WiFi.status() != WL_CONNECTED) return;
+
+    if (!metrics_server) {
+        metrics_server = new WiFiServer(BOUNDARY_METRICS_PORT);
+        metrics_server->begin();
+        Serial.printf("[Metrics] Serving http://%s:%d/metrics\r\n",
+                      WiFi.localIP().toString().c_str(), BOUNDARY_METRICS_PORT);
+    }
+
+    if (metrics_out) {
+        if (metrics_send() || millis() - metrics_client_at > METRICS_SEND_TIMEOUT) metrics_close();
+        return;
+    }
+
+    if (!metrics_client) {
+        metrics_client = metrics_server->available();
+        if (!metrics_client) return;
+        // Our own AP shares the socket, scrapes come from the station side
+        if (metrics_client.localIP() != WiFi.localIP()) {
+            metrics_client.stop();
+            return;
+        }
+        metrics_client_at = millis();
+        metrics_request_len = 0;
+        metrics_line_done = false;
+        metrics_tail = 0;
+    }
+
+    while (metrics_client.available()) {
+        char c = metrics_client.read();
+        if (!metrics_line_done) {
+            if (c == '\r' || c == '\n') {
+                metrics_request[metrics_request_len] = 0;
+                metrics_line_done = true;
+            } else if (metrics_request_len < sizeof(metrics_request) - 1) {
+                metrics_request[metrics_request_len++] = c;
+            }
+        }
+        metrics_tail = (metrics_tail << 8) | (uint8_t)c;
+        if (metrics_tail == 0x0D0A0D0A) {
+            metrics_respond();
+            if (metrics_send()) metrics_close();
+            return;
+        }
+    }
+
+    if (!metrics_client.connected() || millis() - metrics_client_at > METRICS_REQ_TIMEOUT) {
+        metrics_client.stop();
+    }
+}
+
+#endif // BOUNDARY_METRICS
+#endif // BOUNDARY_MODE
+#endif // HAS_RNS
+#endif // METRICS_H
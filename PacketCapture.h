@@ -0,0 +1,355 @@
+// Copyright (C) 2026, Boundary Mode Extension
+// Based on microReticulum_Firmware by Mark Qvist
+//
+// PacketCapture.h — Asynchronous packet capture in PCAP format.
+//
+// Transport's receive and transmit callbacks copy each raw frame and
+// its metadata into a fixed ring of slots and return; a background
+// task writes the ring out, so tracing no longer stalls the stack on
+// SD writes. When the ring is full the frame is counted as dropped
+// rather than waited for. Two sinks, either or both:
+//
+//   SD card   /capture.pcap, rotated to /capture.1.pcap at
+//             PCAP_FILE_MAXSIZE (HAS_SDCARD builds)
+//   TCP       port PCAP_TCP_PORT on the WiFi station address, one
+//             client at a time, live:
+//               nc 10.0.0.42 7634 | wireshark -k -i -
+//
+// Records use the classic PCAP format, microsecond timestamps, link
+// type LINKTYPE_USER0 (147) as there is no registered Reticulum link
+// type. Each record starts with an 8 byte pseudo-header:
+//
+//   version(1)=1 flags(1) interface_id(1) reserved(1)
+//   rssi(2, dBm, big-endian) snr(1, quarter dB) reserved(1)
+//
+// flags bit 0 is set for transmitted frames, bit 1 when rssi and snr
+// hold the radio's figures for a received LoRa frame. The Reticulum
+// frame follows, as Transport saw it, cut at PCAP_SNAPLEN bytes.
+// Wireshark's DLT_USER table can hand the frame to a dissector with a
+// header size of 8.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#ifndef PACKET_CAPTURE_H
+#define PACKET_CAPTURE_H
+
+#ifdef HAS_RNS
+
+// Set to 0 to leave packet capture out of the build
+#ifndef PACKET_CAPTURE
+#if MCU_VARIANT == MCU_ESP32
+#define PACKET_CAPTURE 1
+#else
+#define PACKET_CAPTURE 0
+#endif
+#endif
+
+#if PACKET_CAPTURE
+
+#define HAS_PACKET_CAPTURE true
+
+#include <WiFi.h>
+#include <Transport.h>
+#include <Interface.h>
+#include <Bytes.h>
+#include <Utilities/OS.h>
+#include <atomic>
+#include <new>
+#ifdef HAS_SDCARD
+#include <SD.h>
+#endif
+
+// ─── Capture Configuration ───────────────────────────────────────────────────
+#define PCAP_RING_SIZE        16        // slots, power of two
+#define PCAP_SNAPLEN          508       // frame bytes kept per slot
+#define PCAP_TCP_PORT         7634
+#define PCAP_FILE             "/capture.pcap"
+#define PCAP_FILE_OLD         "/capture.1.pcap"
+#define PCAP_FILE_MAXSIZE     (16UL * 1024 * 1024)
+#define PCAP_FLUSH_MS         1000      // SD flush interval while frames arrive
+#define PCAP_DROP_LOG_MS      10000     // at most one drop report per interval
+#define PCAP_TASK_STACK       4096
+#define PCAP_TASK_PRIORITY    0         // below loopTask and the transport task
+#define PCAP_TASK_IDLE_MS     20
+#define PCAP_LINKTYPE         147       // LINKTYPE_USER0
+#define PCAP_HEADER_VERSION   1
+#define PCAP_FLAG_TX          0x01
+#define PCAP_FLAG_RADIO       0x02
+
+struct CaptureSlot {
+    std::atomic<bool> ready{false};
+    uint64_t us;
+    uint16_t orig_len;
+    uint16_t len;
+    uint8_t  flags;
+    uint8_t  interface_id;
+    int16_t  rssi;
+    int8_t   snr;
+    uint8_t  data[PCAP_SNAPLEN];
+};
+
+// ─── Lock-free MPSC ring ─────────────────────────────────────────────────────
+// Producers reserve a slot by advancing the head and publish it with the
+// slot's ready flag, so a capture from loop() and one from the transport
+// task cannot tear each other. The capture task is the only consumer.
+class CaptureRing {
+public:
+    bool begin() {
+        if (_slots) return true;
+        _slots = new (std::nothrow) CaptureSlot[PCAP_RING_SIZE];
+        return _slots != nullptr;
+    }
+
+    CaptureSlot* reserve() {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        do {
+            if (head - _tail.load(std::memory_order_acquire) >= PCAP_RING_SIZE) {
+                _drops.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+        } while (!_head.compare_exchange_weak(head, head + 1, std::memory_order_acq_rel, std::memory_order_relaxed));
+        return &_slots[head & (PCAP_RING_SIZE - 1)];
+    }
+
+    inline void publish(CaptureSlot* slot) {
+        slot->ready.store(true, std::memory_order_release);
+        _captured.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // The oldest slot once its producer has published it
+    CaptureSlot* front() {
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _head.load(std::memory_order_acquire)) return nullptr;
+        CaptureSlot* slot = &_slots[tail & (PCAP_RING_SIZE - 1)];
+        return slot->ready.load(std::memory_order_acquire) ? slot : nullptr;
+    }
+
+    void pop() {
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        _slots[tail & (PCAP_RING_SIZE - 1)].ready.store(false, std::memory_order_relaxed);
+        _tail.store(tail + 1, std::memory_order_release);
+    }
+
+    inline uint32_t drops() const { return _drops.load(std::memory_order_relaxed); }
+    inline uint32_t captured() const { return _captured.load(std::memory_order_relaxed); }
+
+private:
+    CaptureSlot*          _slots = nullptr;
+    std::atomic<uint32_t> _head{0};
+    std::atomic<uint32_t> _tail{0};
+    std::atomic<uint32_t> _drops{0};
+    std::atomic<uint32_t> _captured{0};
+};
+
+// ─── Capture State ───────────────────────────────────────────────────────────
+static CaptureRing       capture_ring;
+static TaskHandle_t      capture_task_handle = nullptr;
+static std::atomic<bool> capture_active{false};     // a sink is open
+static WiFiServer*       capture_server = nullptr;
+static WiFiClient        capture_client;
+#ifdef HAS_SDCARD
+static File              capture_file;
+#endif
+
+struct __attribute__((packed)) PcapFileHeader {
+    uint32_t magic;
+    uint16_t version_major;
+    uint16_t version_minor;
+    int32_t  thiszone;
+    uint32_t sigfigs;
+    uint32_t snaplen;
+    uint32_t network;
+};
+
+struct __attribute__((packed)) PcapRecordHeader {
+    uint32_t ts_sec;
+    uint32_t ts_usec;
+    uint32_t incl_len;
+    uint32_t orig_len;
+    uint8_t  version;
+    uint8_t  flags;
+    uint8_t  interface_id;
+    uint8_t  reserved;
+    uint8_t  rssi[2];
+    int8_t   snr;
+    uint8_t  reserved2;
+};
+
+#define PCAP_PSEUDO_HEADER_LEN 8
+
+static const PcapFileHeader capture_file_header = {
+    0xa1b2c3d4, 2, 4, 0, 0, PCAP_SNAPLEN + PCAP_PSEUDO_HEADER_LEN, PCAP_LINKTYPE
+};
+
+// ─── Producer side ───────────────────────────────────────────────────────────
+// Called from Transport's packet callbacks. rssi and snr are only
+// recorded when radio is set.
+inline void packet_capture_frame(const RNS::Bytes& raw, const RNS::Interface& interface, bool tx,
+                                 bool radio = false, int16_t rssi = 0, int8_t snr = 0) {
+    if (!capture_active.load(std::memory_order_relaxed)) return;
+    CaptureSlot* slot = capture_ring.reserve();
+    if (!slot) return;
+    slot->us = RNS::Utilities::OS::ltime() * 1000 + (micros() % 1000);
+    slot->orig_len = raw.size();
+    slot->len = (raw.size() > PCAP_SNAPLEN) ? PCAP_SNAPLEN : raw.size();
+    memcpy(slot->data, raw.data(), slot->len);
+    slot->flags = (tx ? PCAP_FLAG_TX : 0) | (radio ? PCAP_FLAG_RADIO : 0);
+    slot->interface_id = interface ? RNS::Transport::interface_id_from_hash(interface.get_hash()) : 0;
+    slot->rssi = radio ? rssi : 0;
+    slot->snr = radio ? snr : 0;
+    capture_ring.publish(slot);
+}
+
+// ─── Capture task ────────────────────────────────────────────────────────────
+inline void capture_update_active() {
+    bool active = capture_client.connected();
+#ifdef HAS_SDCARD
+    active = active || (bool)capture_file;
+#endif
+    capture_active.store(active, std::memory_order_relaxed);
+}
+
+#ifdef HAS_SDCARD
+inline void capture_open_file() {
+    capture_file = SD.open(PCAP_FILE, FILE_WRITE);
+    if (!capture_file) {
+        Serial.println("[PCAP] Cannot open " PCAP_FILE);
+        return;
+    }
+    capture_file.write((const uint8_t*)&capture_file_header, sizeof(capture_file_header));
+    Serial.println("[PCAP] Capturing to SD " PCAP_FILE);
+}
+
+inline void capture_rotate_file() {
+    capture_file.close();
+    SD.remove(PCAP_FILE_OLD);
+    SD.rename(PCAP_FILE, PCAP_FILE_OLD);
+    capture_open_file();
+}
+#endif
+
+// One client at a time, on the station address only like the metrics
+// endpoint; a new client is taken once the current one has gone
+inline void capture_accept() {
+    if (WiFi.status() != WL_CONNECTED) {
+        if (capture_client) capture_client.stop();
+        return;
+    }
+    if (!capture_server) {
+        capture_server = new WiFiServer(PCAP_TCP_PORT, 1);
+        capture_server->begin();
+        Serial.printf("[PCAP] Streaming on tcp://%s:%d\r\n", WiFi.localIP().toString().c_str(), PCAP_TCP_PORT);
+    }
+    if (capture_client && !capture_client.connected()) capture_client.stop();
+    if (capture_client) return;
+    capture_client = capture_server->available();
+    if (!capture_client) return;
+    if (capture_client.localIP() != WiFi.localIP()) {
+        capture_client.stop();
+        return;
+    }
+    capture_client.setNoDelay(true);
+    capture_client.write((const uint8_t*)&capture_file_header, sizeof(capture_file_header));
+    Serial.printf("[PCAP] Client %s connected\r\n", capture_client.remoteIP().toString().c_str());
+}
+
+inline void capture_write(const CaptureSlot& slot) {
+    PcapRecordHeader header;
+    header.ts_sec = slot.us / 1000000;
+    header.ts_usec = slot.us % 1000000;
+    header.incl_len = slot.len + PCAP_PSEUDO_HEADER_LEN;
+    header.orig_len = slot.orig_len + PCAP_PSEUDO_HEADER_LEN;
+    header.version = PCAP_HEADER_VERSION;
+    header.flags = slot.flags;
+    header.interface_id = slot.interface_id;
+    header.reserved = 0;
+    header.rssi[0] = (uint16_t)slot.rssi >> 8;
+    header.rssi[1] = (uint16_t)slot.rssi;
+    header.snr = slot.snr;
+    header.reserved2 = 0;
+
+#ifdef HAS_SDCARD
+    if (capture_file) {
+        if (capture_file.size() + sizeof(header) + slot.len > PCAP_FILE_MAXSIZE) capture_rotate_file();
+        if (capture_file) {
+            capture_file.write((const uint8_t*)&header, sizeof(header));
+            capture_file.write(slot.data, slot.len);
+        }
+    }
+#endif
+    if (capture_client.connected()) {
+        // a client too slow to keep up blocks this task only, the ring
+        // fills and the producers count drops
+        if (capture_client.write((const uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+            capture_client.write(slot.data, slot.len) != slot.len) {
+            Serial.println("[PCAP] Client write failed, disconnecting");
+            capture_client.stop();
+        }
+    }
+}
+
+static void capture_task(void* param) {
+    uint32_t last_flush = millis();
+    uint32_t last_drop_log = millis();
+    uint32_t drops_logged = 0;
+    while (true) {
+        capture_accept();
+        capture_update_active();
+
+        bool wrote = false;
+        CaptureSlot* slot;
+        while ((slot = capture_ring.front()) != nullptr) {
+            capture_write(*slot);
+            capture_ring.pop();
+            wrote = true;
+        }
+#ifdef HAS_SDCARD
+        if (capture_file && wrote && millis() - last_flush >= PCAP_FLUSH_MS) {
+            capture_file.flush();
+            last_flush = millis();
+        }
+#endif
+
+        uint32_t drops = capture_ring.drops();
+        if (drops != drops_logged && millis() - last_drop_log >= PCAP_DROP_LOG_MS) {
+            Serial.printf("[PCAP] Ring full, %u frames dropped (%u captured)\r\n",
+                          (unsigned)(drops - drops_logged), (unsigned)capture_ring.captured());
+            drops_logged = drops;
+            last_drop_log = millis();
+        }
+        if (!wrote) vTaskDelay(pdMS_TO_TICKS(PCAP_TASK_IDLE_MS));
+    }
+}
+
+// Called from setup() once the SD card and RNS are up
+inline bool packet_capture_start() {
+    if (capture_task_handle != nullptr) return true;
+    if (!capture_ring.begin()) {
+        Serial.println("[PCAP] No memory for the capture ring");
+        return false;
+    }
+#ifdef HAS_SDCARD
+    capture_open_file();
+#endif
+    capture_update_active();
+    BaseType_t ok = xTaskCreatePinnedToCore(capture_task, "capture", PCAP_TASK_STACK, nullptr,
+                                            PCAP_TASK_PRIORITY, &capture_task_handle, ARDUINO_RUNNING_CORE);
+    if (ok != pdPASS) {
+        capture_task_handle = nullptr;
+        capture_active.store(false, std::memory_order_relaxed);
+        Serial.println("[PCAP] Failed to create capture task");
+        return false;
+    }
+    return true;
+}
+
+inline uint32_t packet_capture_drops() { return capture_ring.drops(); }
+
+#endif // PACKET_CAPTURE
+
+#endif // HAS_RNS
+
+#endif // PACKET_CAPTURE_H
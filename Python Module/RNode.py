@@ -51,6 +51,13 @@ class KISS():
     CMD_STAT_TX     = 0x22
     CMD_STAT_RSSI   = 0x23
     CMD_STAT_SNR    = 0x24
+    CMD_STAT_CHTM   = 0x25
+    CMD_STAT_PHYPRM = 0x26
+    CMD_STAT_BAT    = 0x27
+    CMD_STAT_CSMA   = 0x28
+    CMD_STAT_TEMP   = 0x29
+    CMD_BENCHMARK   = 0x2D
+    CMD_PROFILE     = 0x2E
     CMD_BLINK       = 0x30
     CMD_RANDOM      = 0x40
     CMD_FW_VERSION  = 0x50
@@ -73,11 +80,22 @@ class KISS():
         data = data.replace(bytes([0xdb]), bytes([0xdb, 0xdd]))
         data = data.replace(bytes([0xc0]), bytes([0xdb, 0xdc]))
         return data
+
+    @staticmethod
+    def unescape(data):
+        # TFEND first, an escaped FESC followed by a literal TFEND must not
+        # turn into FEND
+        data = data.replace(bytes([0xdb, 0xdc]), bytes([0xc0]))
+        data = data.replace(bytes([0xdb, 0xdd]), bytes([0xdb]))
+        return data
     
 
 class RNodeInterface():
     MTU       = 500
     MAX_CHUNK = 32768
+    # Longest escaped frame kept while waiting for its FEND
+    MAX_FRAME = 2*MTU+16
+    READ_TIMEOUT = 0.05
     FREQ_MIN  = 137000000
     FREQ_MAX  = 1020000000
 
@@ -97,6 +115,10 @@ class RNodeInterface():
 
     CALLSIGN_MAX_LEN    = 32
 
+    BENCHMARK_CASES = ["sha256", "hmac", "aes256_enc", "aes256_dec", "ed25519_sign",
+                       "ed25519_verify", "x25519", "unpack", "path_lookup", "fs_write",
+                       "fifo_write", "fifo_read"]
+
     def __init__(self, callback, name, port, frequency = None, bandwidth = None, txpower = None, sf = None, cr = None, loglevel = LOG_NOTICE, flow_control = False, id_interval = None, id_callsign = None):
         self.serial      = None
         self.loglevel    = loglevel
@@ -132,6 +154,30 @@ class RNodeInterface():
         self.r_stat_rssi = None
         self.r_stat_snr  = None
         self.r_random    = None
+        self.r_benchmark = None
+        self.r_profile   = {}
+
+        self.r_airtime_short      = None
+        self.r_airtime_long       = None
+        self.r_channel_load_short = None
+        self.r_channel_load_long  = None
+        self.r_current_rssi       = None
+        self.r_noise_floor        = None
+        self.r_interference       = None
+        self.r_symbol_time_ms     = None
+        self.r_symbol_rate        = None
+        self.r_preamble_symbols   = None
+        self.r_preamble_time_ms   = None
+        self.r_csma_slot_time_ms  = None
+        self.r_difs_ms            = None
+        self.r_csma               = None
+        self.r_battery_state      = None
+        self.r_battery_percent    = None
+        self.r_temperature        = None
+
+        self.tx_lock     = threading.Lock()
+        self.tx_event    = threading.Event()
+        self.tx_pending  = bytearray()
 
         self.packet_queue    = []
         self.flow_control    = flow_control
@@ -183,7 +229,7 @@ class RNodeInterface():
                 stopbits = self.stopbits,
                 xonxoff = False,
                 rtscts = False,
-                timeout = 0,
+                timeout = RNodeInterface.READ_TIMEOUT,
                 inter_byte_timeout = None,
                 write_timeout = None,
                 dsrdtr = False,
@@ -197,6 +243,9 @@ class RNodeInterface():
             thread = threading.Thread(target=self.readLoop)
             thread.setDaemon(True)
             thread.start()
+            thread = threading.Thread(target=self.writeLoop)
+            thread.setDaemon(True)
+            thread.start()
             self.online = True
             self.log("Serial port "+self.port+" is now open")
             self.log("Configuring RNode interface...", RNodeInterface.LOG_VERBOSE)
@@ -307,6 +356,32 @@ class RNodeInterface():
         if written != len(kiss_command):
             raise IOError("An IO error occurred while configuring promiscuous mode for "+self(str))
 
+    def requestBenchmark(self):
+        # The device answers after about a second, readLoop() fills r_benchmark
+        self.r_benchmark = None
+        kiss_command = bytes([KISS.FEND, KISS.CMD_BENCHMARK, KISS.FEND])
+        written = self.serial.write(kiss_command)
+        if written != len(kiss_command):
+            raise IOError("An IO error occurred while requesting benchmark from "+str(self))
+
+    def profileCommand(self, argument):
+        kiss_command = bytes([KISS.FEND, KISS.CMD_PROFILE, argument, KISS.FEND])
+        written = self.serial.write(kiss_command)
+        if written != len(kiss_command):
+            raise IOError("An IO error occurred while sending profiler command to "+str(self))
+
+    def startProfile(self):
+        self.r_profile = {}
+        self.profileCommand(0x01)
+
+    def stopProfile(self):
+        self.profileCommand(0x00)
+
+    def requestProfile(self):
+        # readLoop() fills r_profile with one entry per core
+        self.r_profile = {}
+        self.profileCommand(0x02)
+
 
     def updateBitrate(self):
         try:
@@ -335,15 +410,36 @@ class RNodeInterface():
                         self.last_id = time.time()
                         frame = bytes([0xc0])+bytes([0x00])+KISS.escape(self.id_callsign.encode("utf-8"))+bytes([0xc0])
 
-                data    = KISS.escape(data)
-                frame  += bytes([0xc0])+bytes([0x00])+data+bytes([0xc0])
-                written = self.serial.write(frame)
-
-                if written != len(frame):
-                    raise IOError("Serial interface only wrote "+str(written)+" bytes of "+str(len(data)))
+                frame += bytes([0xc0])+bytes([0x00])+KISS.escape(data)+bytes([0xc0])
+                self.write(frame)
             else:
                 self.queue(data)
 
+    # Frames are collected and written by writeLoop(), everything sent while
+    # a write is in progress goes out together in the next one
+    def write(self, frame):
+        with self.tx_lock:
+            self.tx_pending += frame
+        self.tx_event.set()
+
+    def writeLoop(self):
+        try:
+            while self.serial.is_open:
+                self.tx_event.wait()
+                with self.tx_lock:
+                    self.tx_event.clear()
+                    pending = bytes(self.tx_pending)
+                    self.tx_pending.clear()
+                if len(pending) > 0:
+                    written = self.serial.write(pending)
+                    if written != len(pending):
+                        raise IOError("Serial interface only wrote "+str(written)+" bytes of "+str(len(pending)))
+
+        except Exception as e:
+            self.online = False
+            self.log("A serial port error occurred, the contained exception was: "+str(e), RNodeInterface.LOG_ERROR)
+            self.log("The interface "+str(self.name)+" is now offline.", RNodeInterface.LOG_ERROR)
+
     def queue(self, data):
         self.packet_queue.append(data)
 
@@ -355,150 +451,177 @@ class RNodeInterface():
         elif len(self.packet_queue) == 0:
             self.interface_ready = True
 
+    # Reads whatever the port has, at least one byte or READ_TIMEOUT, and
+    # splits it on FEND. The bytes after the last FEND are kept for the
+    # next read; a partial frame is dropped after self.timeout ms without
+    # data. Several frames arriving in one USB transfer, as the firmware
+    # batches them (RSSI, SNR and data; channel and CSMA stats), are
+    # handled in the order they were sent.
     def readLoop(self):
         try:
             in_frame = False
-            escape = False
-            command = KISS.CMD_UNKNOWN
-            data_buffer = b""
-            command_buffer = b""
+            tail = b""
             last_read_ms = int(time.time()*1000)
 
             while self.serial.is_open:
-                if self.serial.in_waiting:
-                    byte = ord(self.serial.read(1))
+                chunk = self.serial.read(max(1, self.serial.in_waiting))
+                if len(chunk) > 0:
                     last_read_ms = int(time.time()*1000)
-
-                    if (in_frame and byte == KISS.FEND and command == KISS.CMD_DATA):
-                        in_frame = False
-                        self.processIncoming(data_buffer)
-                        data_buffer = b""
-                        command_buffer = b""
-                    elif (byte == KISS.FEND):
+                    parts = (tail+chunk).split(bytes([KISS.FEND]))
+                    tail = parts.pop()
+                    if len(parts) > 0:
+                        # Anything before the first FEND since startup or a
+                        # dropped frame is not a frame
+                        if not in_frame:
+                            parts.pop(0)
                         in_frame = True
-                        command = KISS.CMD_UNKNOWN
-                        data_buffer = b""
-                        command_buffer = b""
-                    elif (in_frame and len(data_buffer) < RNodeInterface.MTU):
-                        if (len(data_buffer) == 0 and command == KISS.CMD_UNKNOWN):
-                            command = byte
-                        elif (command == KISS.CMD_DATA):
-                            if (byte == KISS.FESC):
-                                escape = True
-                            else:
-                                if (escape):
-                                    if (byte == KISS.TFEND):
-                                        byte = KISS.FEND
-                                    if (byte == KISS.TFESC):
-                                        byte = KISS.FESC
-                                    escape = False
-                                data_buffer = data_buffer+bytes([byte])
-                        elif (command == KISS.CMD_FREQUENCY):
-                            if (byte == KISS.FESC):
-                                escape = True
-                            else:
-                                if (escape):
-                                    if (byte == KISS.TFEND):
-                                        byte = KISS.FEND
-                                    if (byte == KISS.TFESC):
-                                        byte = KISS.FESC
-                                    escape = False
-                                command_buffer = command_buffer+bytes([byte])
-                                if (len(command_buffer) == 4):
-                                    self.r_frequency = command_buffer[0] << 24 | command_buffer[1] << 16 | command_buffer[2] << 8 | command_buffer[3]
-                                    self.log(str(self)+" Radio reporting frequency is "+str(self.r_frequency/1000000.0)+" MHz", RNodeInterface.LOG_DEBUG)
-                                    self.updateBitrate()
-
-                        elif (command == KISS.CMD_BANDWIDTH):
-                            if (byte == KISS.FESC):
-                                escape = True
-                            else:
-                                if (escape):
-                                    if (byte == KISS.TFEND):
-                                        byte = KISS.FEND
-                                    if (byte == KISS.TFESC):
-                                        byte = KISS.FESC
-                                    escape = False
-                                command_buffer = command_buffer+bytes([byte])
-                                if (len(command_buffer) == 4):
-                                    self.r_bandwidth = command_buffer[0] << 24 | command_buffer[1] << 16 | command_buffer[2] << 8 | command_buffer[3]
-                                    self.log(str(self)+" Radio reporting bandwidth is "+str(self.r_bandwidth/1000.0)+" KHz", RNodeInterface.LOG_DEBUG)
-                                    self.updateBitrate()
-
-                        elif (command == KISS.CMD_TXPOWER):
-                            self.r_txpower = byte
-                            self.log(str(self)+" Radio reporting TX power is "+str(self.r_txpower)+" dBm", RNodeInterface.LOG_DEBUG)
-                        elif (command == KISS.CMD_SF):
-                            self.r_sf = byte
-                            self.log(str(self)+" Radio reporting spreading factor is "+str(self.r_sf), RNodeInterface.LOG_DEBUG)
-                            self.updateBitrate()
-                        elif (command == KISS.CMD_CR):
-                            self.r_cr = byte
-                            self.log(str(self)+" Radio reporting coding rate is "+str(self.r_cr), RNodeInterface.LOG_DEBUG)
-                            self.updateBitrate()
-                        elif (command == KISS.CMD_RADIO_STATE):
-                            self.r_state = byte
-                        elif (command == KISS.CMD_RADIO_LOCK):
-                            self.r_lock = byte
-                        elif (command == KISS.CMD_STAT_RX):
-                            if (byte == KISS.FESC):
-                                escape = True
-                            else:
-                                if (escape):
-                                    if (byte == KISS.TFEND):
-                                        byte = KISS.FEND
-                                    if (byte == KISS.TFESC):
-                                        byte = KISS.FESC
-                                    escape = False
-                                command_buffer = command_buffer+bytes([byte])
-                                if (len(command_buffer) == 4):
-                                    self.r_stat_rx = ord(command_buffer[0]) << 24 | ord(command_buffer[1]) << 16 | ord(command_buffer[2]) << 8 | ord(command_buffer[3])
-
-                        elif (command == KISS.CMD_STAT_TX):
-                            if (byte == KISS.FESC):
-                                escape = True
-                            else:
-                                if (escape):
-                                    if (byte == KISS.TFEND):
-                                        byte = KISS.FEND
-                                    if (byte == KISS.TFESC):
-                                        byte = KISS.FESC
-                                    escape = False
-                                command_buffer = command_buffer+bytes([byte])
-                                if (len(command_buffer) == 4):
-                                    self.r_stat_tx = ord(command_buffer[0]) << 24 | ord(command_buffer[1]) << 16 | ord(command_buffer[2]) << 8 | ord(command_buffer[3])
-
-                        elif (command == KISS.CMD_STAT_RSSI):
-                            self.r_stat_rssi = byte-RNodeInterface.RSSI_OFFSET
-                        elif (command == KISS.CMD_STAT_SNR):
-                            self.r_stat_snr = int.from_bytes(bytes([byte]), byteorder="big", signed=True) * 0.25
-                        elif (command == KISS.CMD_RANDOM):
-                            self.r_random = byte
-                        elif (command == KISS.CMD_ERROR):
-                            if (byte == KISS.ERROR_INITRADIO):
-                                self.log(str(self)+" hardware initialisation error (code "+RNS.hexrep(byte)+")", RNodeInterface.LOG_ERROR)
-                            elif (byte == KISS.ERROR_INITRADIO):
-                                self.log(str(self)+" hardware TX error (code "+RNS.hexrep(byte)+")", RNodeInterface.LOG_ERROR)
-                            else:
-                                self.log(str(self)+" hardware error (code "+RNS.hexrep(byte)+")", RNodeInterface.LOG_ERROR)
-                        elif (command == KISS.CMD_READY):
-                            self.process_queue()
-                        
-                else:
+                        for frame in parts:
+                            if len(frame) > 0:
+                                self.processFrame(frame[0], KISS.unescape(frame[1:]))
+                    elif not in_frame:
+                        tail = b""
+
+                    if len(tail) > RNodeInterface.MAX_FRAME:
+                        self.log(str(self)+" dropping oversized KISS frame", RNodeInterface.LOG_DEBUG)
+                        tail = b""
+                        in_frame = False
+
+                elif len(tail) > 0:
                     time_since_last = int(time.time()*1000) - last_read_ms
-                    if len(data_buffer) > 0 and time_since_last > self.timeout:
+                    if time_since_last > self.timeout:
                         self.log(str(self)+" serial read timeout", RNodeInterface.LOG_DEBUG)
-                        data_buffer = b""
+                        tail = b""
                         in_frame = False
-                        command = KISS.CMD_UNKNOWN
-                        escape = False
-                    sleep(0.08)
 
         except Exception as e:
             self.online = False
             self.log("A serial port error occurred, the contained exception was: "+str(e), RNodeInterface.LOG_ERROR)
             self.log("The interface "+str(self.name)+" is now offline.", RNodeInterface.LOG_ERROR)
 
+    def processFrame(self, command, data):
+        if (command == KISS.CMD_DATA):
+            if (len(data) <= RNodeInterface.MTU):
+                self.processIncoming(data)
+
+        elif (command == KISS.CMD_FREQUENCY and len(data) == 4):
+            self.r_frequency = int.from_bytes(data, "big")
+            self.log(str(self)+" Radio reporting frequency is "+str(self.r_frequency/1000000.0)+" MHz", RNodeInterface.LOG_DEBUG)
+            self.updateBitrate()
+        elif (command == KISS.CMD_BANDWIDTH and len(data) == 4):
+            self.r_bandwidth = int.from_bytes(data, "big")
+            self.log(str(self)+" Radio reporting bandwidth is "+str(self.r_bandwidth/1000.0)+" KHz", RNodeInterface.LOG_DEBUG)
+            self.updateBitrate()
+        elif (command == KISS.CMD_TXPOWER and len(data) >= 1):
+            self.r_txpower = data[0]
+            self.log(str(self)+" Radio reporting TX power is "+str(self.r_txpower)+" dBm", RNodeInterface.LOG_DEBUG)
+        elif (command == KISS.CMD_SF and len(data) >= 1):
+            self.r_sf = data[0]
+            self.log(str(self)+" Radio reporting spreading factor is "+str(self.r_sf), RNodeInterface.LOG_DEBUG)
+            self.updateBitrate()
+        elif (command == KISS.CMD_CR and len(data) >= 1):
+            self.r_cr = data[0]
+            self.log(str(self)+" Radio reporting coding rate is "+str(self.r_cr), RNodeInterface.LOG_DEBUG)
+            self.updateBitrate()
+        elif (command == KISS.CMD_RADIO_STATE and len(data) >= 1):
+            self.r_state = data[0]
+        elif (command == KISS.CMD_RADIO_LOCK and len(data) >= 1):
+            self.r_lock = data[0]
+
+        elif (command == KISS.CMD_STAT_RX and len(data) == 4):
+            self.r_stat_rx = int.from_bytes(data, "big")
+        elif (command == KISS.CMD_STAT_TX and len(data) == 4):
+            self.r_stat_tx = int.from_bytes(data, "big")
+        elif (command == KISS.CMD_STAT_RSSI and len(data) >= 1):
+            self.r_stat_rssi = data[0]-RNodeInterface.RSSI_OFFSET
+        elif (command == KISS.CMD_STAT_SNR and len(data) >= 1):
+            self.r_stat_snr = int.from_bytes(data[0:1], byteorder="big", signed=True) * 0.25
+
+        elif (command == KISS.CMD_STAT_CHTM and len(data) >= 11):
+            # airtime short(2) long(2) channel load short(2) long(2), in 1/100 %,
+            # then current RSSI(1) noise floor(1) interference(1, 0xFF = none)
+            self.r_airtime_short      = int.from_bytes(data[0:2], "big")/100.0
+            self.r_airtime_long       = int.from_bytes(data[2:4], "big")/100.0
+            self.r_channel_load_short = int.from_bytes(data[4:6], "big")/100.0
+            self.r_channel_load_long  = int.from_bytes(data[6:8], "big")/100.0
+            self.r_current_rssi       = data[8]-RNodeInterface.RSSI_OFFSET
+            self.r_noise_floor        = data[9]-RNodeInterface.RSSI_OFFSET
+            self.r_interference       = None if data[10] == 0xFF else data[10]-RNodeInterface.RSSI_OFFSET
+        elif (command == KISS.CMD_STAT_PHYPRM and len(data) >= 12):
+            # symbol time(2, us) symbol rate(2) preamble symbols(2),
+            # preamble time(2, ms) CSMA slot(2, ms) DIFS(2, ms)
+            self.r_symbol_time_ms    = int.from_bytes(data[0:2], "big")/1000.0
+            self.r_symbol_rate       = int.from_bytes(data[2:4], "big")
+            self.r_preamble_symbols  = int.from_bytes(data[4:6], "big")
+            self.r_preamble_time_ms  = int.from_bytes(data[6:8], "big")
+            self.r_csma_slot_time_ms = int.from_bytes(data[8:10], "big")
+            self.r_difs_ms           = int.from_bytes(data[10:12], "big")
+        elif (command == KISS.CMD_STAT_CSMA and len(data) >= 5):
+            # band(1) cw_min(1) cw_max(1) adapt(1) p(1), then per band
+            # transmissions(2) deferrals(2)
+            bands = []
+            for i in range(5, len(data)-3, 4):
+                bands.append((int.from_bytes(data[i:i+2], "big"), int.from_bytes(data[i+2:i+4], "big")))
+            self.r_csma = {
+                "band": data[0],
+                "cw_min": data[1],
+                "cw_max": data[2],
+                "adapt": data[3],
+                "p": data[4],
+                "bands": bands,
+            }
+        elif (command == KISS.CMD_STAT_BAT and len(data) >= 2):
+            self.r_battery_state   = data[0]
+            self.r_battery_percent = data[1]
+        elif (command == KISS.CMD_STAT_TEMP and len(data) >= 1):
+            self.r_temperature = data[0]
+
+        elif (command == KISS.CMD_BENCHMARK):
+            # case_count(1) { id(1) iterations(2) ns_per_op(4) } * case_count
+            if (len(data) > 0 and len(data) == 1+data[0]*7):
+                results = {}
+                for i in range(data[0]):
+                    record = data[1+i*7:8+i*7]
+                    case_id = record[0]
+                    name = RNodeInterface.BENCHMARK_CASES[case_id] if case_id < len(RNodeInterface.BENCHMARK_CASES) else str(case_id)
+                    iterations = record[1] << 8 | record[2]
+                    if iterations > 0:
+                        results[name] = record[3] << 24 | record[4] << 16 | record[5] << 8 | record[6]
+                self.r_benchmark = results
+                self.log(str(self)+" Benchmark (ns/op): "+str(results), RNodeInterface.LOG_DEBUG)
+
+        elif (command == KISS.CMD_PROFILE):
+            # running(1) core(1) samples(4) idle(4) lost(4) bucket_bytes(2)
+            # entry_count(2) { address(4) count(4) } * entry_count
+            if (len(data) >= 18):
+                entry_count = int.from_bytes(data[16:18], "big")
+                if (len(data) == 18+entry_count*8):
+                    entries = {}
+                    for i in range(entry_count):
+                        record = data[18+i*8:26+i*8]
+                        entries[int.from_bytes(record[0:4], "big")] = int.from_bytes(record[4:8], "big")
+                    core = data[1]
+                    self.r_profile[core] = {
+                        "running": data[0] == 1,
+                        "samples": int.from_bytes(data[2:6], "big"),
+                        "idle": int.from_bytes(data[6:10], "big"),
+                        "lost": int.from_bytes(data[10:14], "big"),
+                        "bucket_bytes": int.from_bytes(data[14:16], "big"),
+                        "entries": entries,
+                    }
+
+        elif (command == KISS.CMD_RANDOM and len(data) >= 1):
+            self.r_random = data[0]
+        elif (command == KISS.CMD_ERROR and len(data) >= 1):
+            code = data[0]
+            if (code == KISS.ERROR_INITRADIO):
+                self.log(str(self)+" hardware initialisation error (code "+"{:02x}".format(code)+")", RNodeInterface.LOG_ERROR)
+            elif (code == KISS.ERROR_TXFAILED):
+                self.log(str(self)+" hardware TX error (code "+"{:02x}".format(code)+")", RNodeInterface.LOG_ERROR)
+            else:
+                self.log(str(self)+" hardware error (code "+"{:02x}".format(code)+")", RNodeInterface.LOG_ERROR)
+        elif (command == KISS.CMD_READY):
+            self.process_queue()
+
     def log(self, msg, level=3):
         logtimefmt   = "%Y-%m-%d %H:%M:%S"
         if self.loglevel >= level:
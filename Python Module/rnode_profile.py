@@ -0,0 +1,146 @@
+# Sampling profiler client for RNode firmware built with SamplingProfiler.h
+#
+# Starts the on-device profiler, lets it sample for a while, dumps the
+# per-core address histograms and resolves them against the firmware ELF:
+#
+#   python3 rnode_profile.py /dev/ttyUSB0 .pio/build/<env>/firmware.elf --seconds 30
+#
+# addr2line from the Xtensa toolchain is looked up on PATH, pass
+# --addr2line to point at it, e.g.
+#   ~/.platformio/packages/toolchain-xtensa-esp32s3/bin/xtensa-esp32s3-elf-addr2line
+#
+# Output is one table per core, and one for both cores together, of the
+# functions with the most samples. Idle samples are counted separately.
+
+import argparse
+import shutil
+import subprocess
+import sys
+import time
+
+import serial
+
+FEND  = 0xC0
+FESC  = 0xDB
+TFEND = 0xDC
+TFESC = 0xDD
+
+CMD_PROFILE = 0x2E
+PROF_STOP   = 0x00
+PROF_START  = 0x01
+PROF_DUMP   = 0x02
+
+def send(port, argument):
+    port.write(bytes([FEND, CMD_PROFILE, argument, FEND]))
+
+def read_frames(port, wanted, timeout):
+    # Collects CMD_PROFILE frames until wanted cores have answered
+    frames = {}
+    frame = None
+    escape = False
+    deadline = time.time() + timeout
+    while time.time() < deadline and len(frames) < wanted:
+        chunk = port.read(port.in_waiting or 1)
+        for byte in chunk:
+            if byte == FEND:
+                if frame and frame[0] == CMD_PROFILE and len(frame) >= 19:
+                    data = bytes(frame[1:])
+                    count = int.from_bytes(data[16:18], "big")
+                    if len(data) == 18 + count * 8:
+                        frames[data[1]] = data
+                frame = []
+            elif frame is not None:
+                if byte == FESC:
+                    escape = True
+                    continue
+                if escape:
+                    byte = FEND if byte == TFEND else FESC if byte == TFESC else byte
+                    escape = False
+                frame.append(byte)
+    return frames
+
+def parse(data):
+    count = int.from_bytes(data[16:18], "big")
+    entries = {}
+    for i in range(count):
+        record = data[18 + i * 8:26 + i * 8]
+        entries[int.from_bytes(record[0:4], "big")] = int.from_bytes(record[4:8], "big")
+    return {
+        "samples": int.from_bytes(data[2:6], "big"),
+        "idle": int.from_bytes(data[6:10], "big"),
+        "lost": int.from_bytes(data[10:14], "big"),
+        "entries": entries,
+    }
+
+def symbolize(addr2line, elf, addresses):
+    # One addr2line run for every address, -f prints the function before file:line
+    if not addresses:
+        return {}
+    result = subprocess.run([addr2line, "-f", "-C", "-e", elf] + ["0x%08x" % a for a in addresses],
+                            stdout=subprocess.PIPE, universal_newlines=True, check=True)
+    lines = result.stdout.splitlines()
+    symbols = {}
+    for i, address in enumerate(addresses):
+        function = lines[2 * i] if 2 * i < len(lines) else "??"
+        location = lines[2 * i + 1] if 2 * i + 1 < len(lines) else "??:0"
+        symbols[address] = (function, location)
+    return symbols
+
+def report(title, cores, symbols, top):
+    samples = sum(c["samples"] for c in cores)
+    idle = sum(c["idle"] for c in cores)
+    lost = sum(c["lost"] for c in cores)
+    functions = {}
+    for core in cores:
+        for address, count in core["entries"].items():
+            function, location = symbols.get(address, ("??", "??:0"))
+            if function == "??":
+                function = "0x%08x" % address
+            entry = functions.setdefault(function, [0, location])
+            entry[0] += count
+    busy = samples - idle
+    print("%s: %d samples, %.1f%% idle, %d lost" % (title, samples, 100.0 * idle / samples if samples else 0, lost))
+    for function, (count, location) in sorted(functions.items(), key=lambda f: -f[1][0])[:top]:
+        print("  %6d %5.1f%%  %s  (%s)" % (count, 100.0 * count / busy if busy else 0, function, location.split(" ")[0]))
+    print("")
+
+def main():
+    parser = argparse.ArgumentParser(description="Sample where an RNode spends its CPU time")
+    parser.add_argument("port", help="serial port of the RNode")
+    parser.add_argument("elf", help="firmware ELF the device is running")
+    parser.add_argument("--seconds", type=float, default=10, help="sampling time (10)")
+    parser.add_argument("--top", type=int, default=25, help="functions per table (25)")
+    parser.add_argument("--addr2line", default=None, help="addr2line of the Xtensa toolchain")
+    parser.add_argument("--baud", type=int, default=115200)
+    args = parser.parse_args()
+
+    addr2line = args.addr2line
+    if addr2line is None:
+        for name in ("xtensa-esp32-elf-addr2line", "xtensa-esp32s3-elf-addr2line", "addr2line"):
+            addr2line = shutil.which(name)
+            if addr2line:
+                break
+    if not addr2line:
+        sys.exit("addr2line not found, pass --addr2line")
+
+    port = serial.Serial(args.port, args.baud, timeout=0.1)
+    send(port, PROF_START)
+    time.sleep(args.seconds)
+    send(port, PROF_STOP)
+    time.sleep(0.2)
+    port.reset_input_buffer()
+    send(port, PROF_DUMP)
+    frames = read_frames(port, 2, 10)
+    port.close()
+    if not frames:
+        sys.exit("no profile from the device, is it built with SamplingProfiler.h?")
+
+    cores = {core: parse(data) for core, data in sorted(frames.items())}
+    addresses = sorted({a for core in cores.values() for a in core["entries"]})
+    symbols = symbolize(addr2line, args.elf, addresses)
+    for core, data in cores.items():
+        report("core %d" % core, [data], symbols, args.top)
+    report("both cores", list(cores.values()), symbols, args.top)
+
+if __name__ == "__main__":
+    main()
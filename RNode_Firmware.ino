@@ -26,6 +26,8 @@
 #include <Arduino.h>
 #include <SPI.h>
 #include "Utilities.h"
+#include "TxQueue.h"
+#include "RingLog.h"
 
 // CBA Boundary Mode
 // NOTE: Boundary Mode is the legacy name. This firmware branch intends to
@@ -34,10 +36,31 @@
 #ifdef BOUNDARY_MODE
 #include "BoundaryMode.h"
 #include "TcpInterface.h"
+#include "UdpInterface.h"
+#include "EspNowInterface.h"
 #include "BoundaryConfig.h"
 #include "esp_bt.h"
+#include "esp_sleep.h"
+#include "driver/gpio.h"
 #endif
 
+#ifdef HAS_RNS
+#include "TransportTask.h"
+#include "Lora2Interface.h"
+#include "MemoryReport.h"
+#include "Metrics.h"
+#include "StatsLog.h"
+#include "LiveConfig.h"
+#include "StatusServer.h"
+#include "MemoryPressure.h"
+#endif
+#include "BootTimeline.h"
+#include "LoopProfiler.h"
+#include "TaskStats.h"
+#include "DeviceBenchmark.h"
+#include "SamplingProfiler.h"
+#include "PacketCapture.h"
+
 // CBA FileSystem
 #if defined(RNS_USE_FS)
 #include "FileSystem.h"
@@ -58,21 +81,19 @@ SPIClass SDSPI(HSPI);
 // WDT timeout
 #define WDT_TIMEOUT 60  // seconds
 
+#if MCU_VARIANT == MCU_ESP32
+  // The serial driver's RX ring (sized to CONFIG_UART_BUFFER_SIZE in setup)
+  // is read in chunks and deframed directly, see buffer_serial()
+  #define SERIAL_READ_CHUNK      256
+  #define SERIAL_READ_MAX_CHUNKS 8
+#else
 FIFOBuffer serialFIFO;
 uint8_t serialBuffer[CONFIG_UART_BUFFER_SIZE+1];
+#endif
 
-FIFOBuffer16 packet_starts;
-uint16_t packet_starts_buf[CONFIG_QUEUE_MAX_LENGTH+1];
-
-FIFOBuffer16 packet_lengths;
-uint16_t packet_lengths_buf[CONFIG_QUEUE_MAX_LENGTH+1];
-
-uint8_t packet_queue[CONFIG_QUEUE_SIZE];
+// Outgoing LoRa packets, see TxQueue.h
+TxQueue tx_queue;
 
-volatile uint8_t queue_height = 0;
-volatile uint16_t queued_bytes = 0;
-volatile uint16_t queue_cursor = 0;
-volatile uint16_t current_packet_start = 0;
 volatile bool serial_buffering = false;
 #if HAS_BLUETOOTH || HAS_BLE == true
   bool bt_init_ran = false;
@@ -84,83 +105,142 @@ volatile bool serial_buffering = false;
 
 #if PLATFORM == PLATFORM_ESP32 || PLATFORM == PLATFORM_NRF52
   #define MODEM_QUEUE_SIZE 8
+  #define LORA_REASM_SLOTS 4                        // split packets reassembled at once
+  #define LORA_REASM_MARGIN_MS 250
+  #define MODEM_POOL_SIZE  (MODEM_QUEUE_SIZE+LORA_REASM_SLOTS+2)   // queued + reassembling + being received + being handled
   typedef struct {
           size_t len;
           int rssi;
           int snr_raw;
-          uint8_t data[];
+          bool aggregated;   // data holds length-prefixed packets
+          uint8_t data[MTU];
   } modem_packet_t;
   static xQueueHandle modem_packet_queue = NULL;
-#endif
 
-char sbuf[128];
+  // Received frames are read from the modem FIFO straight into a
+  // pre-allocated slot, and only the slot pointer goes through
+  // modem_packet_queue. Free slots are kept in modem_packet_pool.
+  static modem_packet_t modem_packet_slots[MODEM_POOL_SIZE];
+  static xQueueHandle modem_packet_pool = NULL;
+  static modem_packet_t* modem_rx_slot = NULL;   // frame currently being received
+  static uint32_t modem_pool_exhausted = 0;       // frames dropped for lack of a free slot
+
+  inline modem_packet_t* modem_packet_take() {
+    modem_packet_t* slot = NULL;
+    if (!modem_packet_pool || xQueueReceiveFromISR(modem_packet_pool, &slot, NULL) != pdTRUE) {
+      modem_pool_exhausted++;
+      return NULL;
+    }
+    return slot;
+  }
 
-#if MCU_VARIANT == MCU_ESP32 || MCU_VARIANT == MCU_NRF52
-  bool packet_ready = false;
+  inline void modem_packet_release(modem_packet_t* slot) {
+    if (slot && modem_packet_pool) { xQueueSend(modem_packet_pool, &slot, 0); }
+  }
 #endif
 
+char sbuf[128];
+
 #if MCU_VARIANT == MCU_ESP32 || MCU_VARIANT == MCU_NRF52
 void update_csma_parameters();
 #endif
 
 #ifdef HAS_RNS
 // CBA LoRa interface
-class LoRaInterface : public RNS::InterfaceImpl {
+class LoRaInterface : public RNS::InterfaceImpl, public TransportEndpoint {
 public:
 	LoRaInterface() : RNS::InterfaceImpl("LoRaInterface") {
 		_IN = true;
 		_OUT = true;
 		_HW_MTU = 508;
+		_announce_cap = RNS::Type::Reticulum::ANNOUNCE_CAP / 100.0;
 	}
 	LoRaInterface(const char *name) : RNS::InterfaceImpl(name) {
 		_IN = true;
 		_OUT = true;
 		_HW_MTU = 508;
+		_announce_cap = RNS::Type::Reticulum::ANNOUNCE_CAP / 100.0;
 	}
 	virtual ~LoRaInterface() {
 		_name = "deleted";
 	}
+	// CBA Received frame from kiss_write_packet(), queued to the transport task when it is running
+	void receive(const RNS::Bytes& data) {
+    if (transport_task_running()) {
+      transport_task_submit_rx(this, data, -1);
+    }
+    else {
+      handle_incoming(data);
+    }
+  }
+	virtual void deliver_incoming(const RNS::Bytes& data, int8_t client) {
+    handle_incoming(data);
+  }
+	virtual void transmit_now(const RNS::Bytes& data, int8_t client) {
+    queue_outgoing(data);
+  }
+	// CBA Frame fully on air: the rate over its airtime, and the time since it was queued as
+	// the first-hop delay
+	void transmitted(uint16_t length, uint32_t started, uint32_t queued) {
+    uint32_t now = millis();
+    throughput_sample(length, (now - started) / 1000.0);
+    rtt_sample((now - queued) / 1000.0);
+  }
+  // CBA Frames left the queue, announces held by a refused frame may go again
+  void tx_released() {
+    writable();
+  }
 protected:
+	// CBA Keeps the announce cap in step with the current radio settings
+	virtual void loop() {
+    _bitrate = lora_bitrate;
+    _online = radio_online;
+  }
 	virtual void handle_incoming(const RNS::Bytes& data) {
     TRACEF("LoRaInterface.handle_incoming: (%u bytes) data: %s", data.size(), data.toHex().c_str());
     TRACE("LoRaInterface.handle_incoming: sending packet to rns...");
     InterfaceImpl::handle_incoming(data);
+  }
+	// CBA Whole frames only: refused when tx_queue would drop it rather than queue it. From the
+	// transport task this reads tx_queue while loop() drains it, frames still in the handoff
+	// ring are not counted, so queue_outgoing() can still drop one.
+	virtual bool can_send(const RNS::Bytes& data) const {
+    #if HAS_LIVE_CONFIG
+      // CBA The queue drains ahead of new radio settings
+      if (live_config_holding_tx()) return false;
+    #endif
+    return tx_queue.accepts(data.data(), data.size());
+  }
+	virtual uint16_t queue_depth() const {
+    return tx_queue.height();
+  }
+	virtual bool tx_held() const {
+    #if HAS_LIVE_CONFIG
+      return live_config_holding_tx();
+    #else
+      return false;
+    #endif
   }
 	virtual void send_outgoing(const RNS::Bytes& data) {
     // CBA NOTE header will be addded later by transmit function
     TRACEF("LoRaInterface.send_outgoing: (%u bytes) data: %s", data.size(), data.toHex().c_str());
-    TRACE("LoRaInterface.send_outgoing: adding packet to outgoing queue...");
-    for (size_t i = 0; i < data.size(); i++) {
-        if (queue_height < CONFIG_QUEUE_MAX_LENGTH && queued_bytes < CONFIG_QUEUE_SIZE) {
-            queued_bytes++;
-            packet_queue[queue_cursor++] = data.data()[i];
-            if (queue_cursor == CONFIG_QUEUE_SIZE) queue_cursor = 0;
-        }
+    // CBA The packet queue belongs to loop(), so the transport task hands the frame over
+    if (transport_task_is_current()) {
+      transport_task_submit_tx(this, data, -1);
     }
-    if (!fifo16_isfull(&packet_starts) && queued_bytes < CONFIG_QUEUE_SIZE) {
-        uint16_t s = current_packet_start;
-        int16_t e = queue_cursor-1; if (e == -1) e = CONFIG_QUEUE_SIZE-1;
-        uint16_t l;
-
-        if (s != e) {
-            l = (s < e) ? e - s + 1 : CONFIG_QUEUE_SIZE - s + e + 1;
-        } else {
-            l = 1;
-        }
-
-        if (l >= MIN_L) {
-            queue_height++;
-
-            fifo16_push(&packet_starts, s);
-            fifo16_push(&packet_lengths, l);
-
-            current_packet_start = queue_cursor;
-        }
-
+    else {
+      queue_outgoing(data);
     }
     // Perform post-send housekeeping
     InterfaceImpl::handle_outgoing(data);
   }
+private:
+	void queue_outgoing(const RNS::Bytes& data) {
+    TRACE("LoRaInterface.send_outgoing: adding packet to outgoing queue...");
+    if (!tx_queue.push(data.data(), data.size())) {
+      TRACEF("LoRaInterface.send_outgoing: queue full, dropped %u byte packet", data.size());
+    }
+  }
 };
 
 // CBA logger callback
@@ -173,6 +253,9 @@ void on_log(const char* msg, RNS::LogLevel level) {
 	Serial.println(msg);
 	Serial.flush();
 */
+#if HAS_RING_LOG
+  ringlog_text(level, msg);
+#else
   String line = RNS::getTimeString() + String(" [") + RNS::getLevelName(level) + "] " + msg + "\n";
 	Serial.print(line);
 	Serial.flush();
@@ -184,55 +267,45 @@ void on_log(const char* msg, RNS::LogLevel level) {
     file.close();
   }
 #endif  // HAS_SDCARD
+#endif  // HAS_RING_LOG
 }
 
+// Defined below, received LoRa frames are captured with the radio's RSSI/SNR
+extern RNS::Interface lora_interface;
+
+// last_rssi belongs to whichever packet the radio received last, so only
+// attach it to a capture when that packet arrived recently enough to be
+// the one Transport is now handing us. Otherwise the frame goes out
+// without the RSSI/SNR flag rather than carrying a value from long ago.
+#define CAPTURE_RSSI_MAX_AGE 2000
+
 // CBA receive packet callback
 void on_receive_packet(const RNS::Bytes& raw, const RNS::Interface& interface) {
-#ifdef HAS_SDCARD
-  TRACE("Logging receive packet to SD");
-  String line = RNS::getTimeString() + String(" recv: ") + String(raw.toHex().c_str()) + "\n";
-	File file = SD.open("/tracefile.txt", FILE_APPEND);
-	if (file) {
-    file.write((uint8_t*)line.c_str(), line.length());
-    file.close();
-  }
-	RNS::Packet packet({RNS::Type::NONE}, raw);
-	if (packet.unpack()) {
-    String line = RNS::getTimeString() + String(" recv: ") + String(packet.dumpString().c_str()) + "\n";
-    File file = SD.open("/tracedetails.txt", FILE_APPEND);
-    if (file) {
-      file.write((uint8_t*)line.c_str(), line.length());
-      file.close();
-    }
-	}
-#endif  // HAS_SDCARD
+#if HAS_PACKET_CAPTURE
+  // Copied into the capture ring, written out by the capture task
+  bool radio = interface && lora_interface && interface == lora_interface &&
+               last_rssi_at != 0 && millis() - last_rssi_at < CAPTURE_RSSI_MAX_AGE;
+  packet_capture_frame(raw, interface, false, radio, last_rssi, (int8_t)last_snr_raw);
+#endif
 }
 
 // CBA transmit packet callback
 void on_transmit_packet(const RNS::Bytes& raw, const RNS::Interface& interface) {
-#ifdef HAS_SDCARD
-  TRACE("Logging transmit packet to SD");
-  String line = RNS::getTimeString() + String(" send: ") + String(raw.toHex().c_str()) + "\n";
-	File file = SD.open("/tracefile.txt", FILE_APPEND);
-	if (file) {
-    file.write((uint8_t*)line.c_str(), line.length());
-    file.close();
-  }
-	RNS::Packet packet({RNS::Type::NONE}, raw);
-	if (packet.unpack()) {
-    String line = RNS::getTimeString() + String(" send: ") + String(packet.dumpString().c_str()) + "\n";
-    File file = SD.open("/tracedetails.txt", FILE_APPEND);
-    if (file) {
-      file.write((uint8_t*)line.c_str(), line.length());
-      file.close();
-    }
-	}
-#endif  // HAS_SDCARD
+  boot_stage(BOOT_FIRST_TX);
+#if HAS_PACKET_CAPTURE
+  packet_capture_frame(raw, interface, true);
+#endif
 }
 
 // CBA RNS
 RNS::Reticulum reticulum(RNS::Type::NONE);
 RNS::Interface lora_interface(RNS::Type::NONE);
+LoRaInterface* lora_interface_ptr = nullptr;
+#if HAS_LORA2
+// Second LoRa modem on its own channel
+RNS::Interface lora2_rns_interface(RNS::Type::NONE);
+Lora2Interface* lora2_interface_ptr = nullptr;
+#endif
 RNS::FileSystem filesystem(RNS::Type::NONE);
 
 #ifdef BOUNDARY_MODE
@@ -243,6 +316,13 @@ TcpInterface*  tcp_interface_ptr = nullptr;
 // Local TCP server (MODE_ACCESS_POINT, doesn't forward announces)
 RNS::Interface local_tcp_rns_interface(RNS::Type::NONE);
 TcpInterface*  local_tcp_interface_ptr = nullptr;
+// Local UDP broadcast interface, used instead of the TCP server when selected
+UdpInterface*  local_udp_interface_ptr = nullptr;
+#if BOUNDARY_ESPNOW
+// Direct node-to-node link over ESP-NOW
+RNS::Interface espnow_rns_interface(RNS::Type::NONE);
+EspNowInterface* espnow_interface_ptr = nullptr;
+#endif
 // RTC memory flag — survives software reset but not power cycle
 RTC_NOINIT_ATTR uint32_t boundary_config_request;
 #define BOUNDARY_CONFIG_MAGIC 0xC0F19A7E
@@ -268,13 +348,148 @@ RTC_NOINIT_ATTR uint32_t rtc_node_hash_magic;
 RTC_NOINIT_ATTR char     rtc_node_hash_hex[33];  // 32 hex chars + NUL
 #endif
 
+#if HAS_METRICS
+// Updated on the LoRa RX/TX paths, everything else is read at scrape time
+MetricCounter metric_lora_rx_frames;
+MetricCounter metric_lora_tx_frames;
+static const int32_t metric_rssi_bounds[] = { -130, -120, -110, -100, -90, -80, -70, -60 };
+MetricHistogram metric_lora_rx_rssi(metric_rssi_bounds, sizeof(metric_rssi_bounds)/sizeof(metric_rssi_bounds[0]));
+static const int32_t metric_size_bounds[] = { 32, 64, 128, 192, 254, 381, 508 };
+MetricHistogram metric_lora_tx_size(metric_size_bounds, sizeof(metric_size_bounds)/sizeof(metric_size_bounds[0]));
+extern uint32_t lora_reasm_dropped;
+
+struct MetricsInterface {
+  const char*     labels;
+  RNS::Interface* interface;
+};
+
+static void metrics_collect(MetricsWriter& w) {
+  const MetricsInterface ifs[] = {
+    { "interface=\"lora\"",     &lora_interface },
+  #if HAS_LORA2
+    { "interface=\"lora2\"",    &lora2_rns_interface },
+  #endif
+    { "interface=\"backbone\"", &tcp_rns_interface },
+    { "interface=\"local\"",    &local_tcp_rns_interface },
+  #if BOUNDARY_ESPNOW
+    { "interface=\"espnow\"",   &espnow_rns_interface },
+  #endif
+  };
+  const size_t n = sizeof(ifs)/sizeof(ifs[0]);
+
+  w.family("rnode_interface_rx_packets_total", "counter", "Packets received per interface");
+  for (size_t i = 0; i < n; i++) if (*ifs[i].interface) w.value("rnode_interface_rx_packets_total", ifs[i].labels, (uint32_t)ifs[i].interface->rxp());
+  w.family("rnode_interface_tx_packets_total", "counter", "Packets sent per interface");
+  for (size_t i = 0; i < n; i++) if (*ifs[i].interface) w.value("rnode_interface_tx_packets_total", ifs[i].labels, (uint32_t)ifs[i].interface->txp());
+  w.family("rnode_interface_rx_bytes_total", "counter", "Bytes received per interface");
+  for (size_t i = 0; i < n; i++) if (*ifs[i].interface) w.value("rnode_interface_rx_bytes_total", ifs[i].labels, (uint32_t)ifs[i].interface->rxb());
+  w.family("rnode_interface_tx_bytes_total", "counter", "Bytes sent per interface");
+  for (size_t i = 0; i < n; i++) if (*ifs[i].interface) w.value("rnode_interface_tx_bytes_total", ifs[i].labels, (uint32_t)ifs[i].interface->txb());
+  w.family("rnode_interface_announces_dropped_total", "counter", "Announces dropped from the per-interface announce queue");
+  for (size_t i = 0; i < n; i++) if (*ifs[i].interface) w.value("rnode_interface_announces_dropped_total", ifs[i].labels, (uint32_t)ifs[i].interface->announces_dropped());
+  w.family("rnode_interface_refused_total", "counter", "Frames refused whole by an interface without room for them");
+  for (size_t i = 0; i < n; i++) if (*ifs[i].interface) w.value("rnode_interface_refused_total", ifs[i].labels, ifs[i].interface->refused());
+
+  w.family("rnode_interface_bitrate", "gauge", "Measured throughput per interface in bit/s, the configured bitrate until measured");
+  for (size_t i = 0; i < n; i++) if (*ifs[i].interface) w.value("rnode_interface_bitrate", ifs[i].labels, ifs[i].interface->effective_bitrate());
+  w.family("rnode_interface_rtt_seconds", "gauge", "Measured first-hop round trip per interface, 0 until measured");
+  for (size_t i = 0; i < n; i++) if (*ifs[i].interface) w.value("rnode_interface_rtt_seconds", ifs[i].labels, (float)ifs[i].interface->rtt());
+
+  w.family("rnode_drops_total", "counter", "Packets dropped, by reason");
+  w.value("rnode_drops_total", "reason=\"txq_control\"",  (uint32_t)tx_queue.drops(TXQ_CONTROL));
+  w.value("rnode_drops_total", "reason=\"txq_link\"",     (uint32_t)tx_queue.drops(TXQ_LINK));
+  w.value("rnode_drops_total", "reason=\"txq_path\"",     (uint32_t)tx_queue.drops(TXQ_PATH));
+  w.value("rnode_drops_total", "reason=\"txq_announce\"", (uint32_t)tx_queue.drops(TXQ_ANNOUNCE));
+  w.value("rnode_drops_total", "reason=\"lora_reassembly\"", (uint32_t)lora_reasm_dropped);
+  w.value("rnode_drops_total", "reason=\"announce_shed\"", (uint32_t)RNS::Transport::announces_shed());
+  w.value("rnode_drops_total", "reason=\"announce_rate\"", RNS::Transport::announces_rate_blocked());
+  w.value("rnode_drops_total", "reason=\"prefilter_ifac\"",      RNS::Transport::prefilter_rejects(RNS::Transport::PREFILTER_IFAC));
+  w.value("rnode_drops_total", "reason=\"prefilter_malformed\"", RNS::Transport::prefilter_rejects(RNS::Transport::PREFILTER_MALFORMED));
+  w.value("rnode_drops_total", "reason=\"prefilter_scope\"",     RNS::Transport::prefilter_rejects(RNS::Transport::PREFILTER_SCOPE));
+  w.value("rnode_drops_total", "reason=\"prefilter_duplicate\"", RNS::Transport::prefilter_rejects(RNS::Transport::PREFILTER_DUPLICATE));
+  w.value("rnode_drops_total", "reason=\"prefilter_blocked\"",   RNS::Transport::prefilter_rejects(RNS::Transport::PREFILTER_BLOCKED));
+  #if BOUNDARY_TRANSPORT_TASK && MCU_VARIANT == MCU_ESP32
+  w.value("rnode_drops_total", "reason=\"transport_rx_ring\"", (uint32_t)transport_rx_ring.drops());
+  w.value("rnode_drops_total", "reason=\"transport_tx_ring\"", (uint32_t)transport_tx_ring.drops());
+  #endif
+  if (tcp_interface_ptr)       w.value("rnode_drops_total", "reason=\"backbone_tx\"", (uint32_t)tcp_interface_ptr->txDrops());
+  if (local_tcp_interface_ptr) w.value("rnode_drops_total", "reason=\"local_tx\",interface=\"local_tcp\"", (uint32_t)local_tcp_interface_ptr->txDrops());
+  if (local_udp_interface_ptr) w.value("rnode_drops_total", "reason=\"local_tx\",interface=\"local_udp\"", (uint32_t)local_udp_interface_ptr->txDrops());
+  #if BOUNDARY_ESPNOW
+  if (espnow_interface_ptr) {
+    w.value("rnode_drops_total", "reason=\"espnow_tx\"", (uint32_t)espnow_interface_ptr->txDrops());
+    w.value("rnode_drops_total", "reason=\"espnow_rx\"", (uint32_t)espnow_interface_ptr->rxDrops());
+  }
+  #endif
+
+  w.family("rnode_queue_depth", "gauge", "Frames waiting, by queue");
+  w.value("rnode_queue_depth", "queue=\"lora_tx\"", (uint32_t)tx_queue.height());
+  #if HAS_LORA2
+  if (lora2_interface_ptr) w.value("rnode_queue_depth", "queue=\"lora2_tx\"", (uint32_t)lora2_interface_ptr->queued());
+  #endif
+  #if BOUNDARY_TRANSPORT_TASK && MCU_VARIANT == MCU_ESP32
+  w.value("rnode_queue_depth", "queue=\"transport_rx\"", transport_rx_ring.size());
+  w.value("rnode_queue_depth", "queue=\"transport_tx\"", transport_tx_ring.size());
+  #endif
+
+  w.family("rnode_transport_packets_sent_total", "counter", "Packets sent by Transport");
+  w.value("rnode_transport_packets_sent_total", nullptr, RNS::Transport::packets_sent());
+  w.family("rnode_transport_packets_received_total", "counter", "Packets received by Transport");
+  w.value("rnode_transport_packets_received_total", nullptr, RNS::Transport::packets_received());
+  w.family("rnode_transport_packets_fast_forwarded_total", "counter", "Packets forwarded on the fast path");
+  w.value("rnode_transport_packets_fast_forwarded_total", nullptr, RNS::Transport::packets_fast_forwarded());
+  w.family("rnode_transport_paths_warmed_total", "counter", "Path requests sent ahead of clients for hot destinations");
+  w.value("rnode_transport_paths_warmed_total", nullptr, RNS::Transport::paths_warmed());
+  w.family("rnode_transport_path_announces_promoted_total", "counter", "Announces of hot destinations read back into RAM");
+  w.value("rnode_transport_path_announces_promoted_total", nullptr, RNS::Transport::path_announces_promoted());
+  w.family("rnode_transport_destinations_added_total", "counter", "Destinations added to the path table");
+  w.value("rnode_transport_destinations_added_total", nullptr, RNS::Transport::destinations_added());
+  w.family("rnode_transport_table_entries", "gauge", "Entries in the Transport tables");
+  // The tables belong to the transport task, it publishes their sizes
+  w.value("rnode_transport_table_entries", "table=\"path\"", transport_path_count.load(std::memory_order_relaxed));
+  w.value("rnode_transport_table_entries", "table=\"link\"", transport_link_count.load(std::memory_order_relaxed));
+
+  w.family("rnode_lora_airtime_ratio", "gauge", "Own airtime, short and long term");
+  w.value("rnode_lora_airtime_ratio", "window=\"short\"", airtime);
+  w.value("rnode_lora_airtime_ratio", "window=\"long\"",  longterm_airtime);
+  w.family("rnode_lora_channel_util_ratio", "gauge", "Channel utilisation, short and long term");
+  w.value("rnode_lora_channel_util_ratio", "window=\"short\"", total_channel_util);
+  w.value("rnode_lora_channel_util_ratio", "window=\"long\"",  longterm_channel_util);
+  w.family("rnode_lora_noise_floor_dbm", "gauge", "Measured noise floor");
+  w.value("rnode_lora_noise_floor_dbm", nullptr, (int32_t)noise_floor);
+
+  w.family("rnode_heap_free_bytes", "gauge", "Free internal heap");
+  w.value("rnode_heap_free_bytes", nullptr, (uint32_t)ESP.getFreeHeap());
+  w.family("rnode_heap_min_free_bytes", "gauge", "Lowest free internal heap since boot");
+  w.value("rnode_heap_min_free_bytes", nullptr, (uint32_t)ESP.getMinFreeHeap());
+  w.family("rnode_heap_max_alloc_bytes", "gauge", "Largest free internal heap block");
+  w.value("rnode_heap_max_alloc_bytes", nullptr, (uint32_t)ESP.getMaxAllocHeap());
+  if (psramFound()) {
+    w.family("rnode_psram_free_bytes", "gauge", "Free PSRAM");
+    w.value("rnode_psram_free_bytes", nullptr, (uint32_t)ESP.getFreePsram());
+  }
+  w.family("rnode_uptime_seconds", "counter", "Seconds since boot");
+  w.value("rnode_uptime_seconds", nullptr, (uint32_t)(millis()/1000));
+}
+
+void metrics_setup() {
+  metrics_register("rnode_lora_rx_frames_total", "LoRa frames received", metric_lora_rx_frames);
+  metrics_register("rnode_lora_tx_frames_total", "LoRa frames sent", metric_lora_tx_frames);
+  metrics_register("rnode_lora_rx_rssi_dbm", "RSSI of received LoRa frames", metric_lora_rx_rssi);
+  metrics_register("rnode_lora_tx_size_bytes", "Size of LoRa frames handed to the modem", metric_lora_tx_size);
+  metrics_add_collector(metrics_collect);
+}
+#endif
+
 #endif  // HAS_RNS
 
 void setup() {
 
   // Initialise serial communication
-  memset(serialBuffer, 0, sizeof(serialBuffer));
-  fifo_init(&serialFIFO, serialBuffer, CONFIG_UART_BUFFER_SIZE);
+  #if MCU_VARIANT != MCU_ESP32
+    memset(serialBuffer, 0, sizeof(serialBuffer));
+    fifo_init(&serialFIFO, serialBuffer, CONFIG_UART_BUFFER_SIZE);
+  #endif
 
   Serial.begin(serial_baudrate);
 
@@ -286,7 +501,20 @@ void setup() {
     delay(10);
   }
   // CBA Test
-  delay(2000);
+  // Gives a serial monitor time to attach after power-on, a software
+  // or watchdog reset goes straight on to bring the radio back up
+  #if MCU_VARIANT == MCU_ESP32
+    esp_reset_reason_t reset_reason = esp_reset_reason();
+    if (reset_reason == ESP_RST_POWERON || reset_reason == ESP_RST_EXT || reset_reason == ESP_RST_UNKNOWN) { delay(2000); }
+  #else
+    delay(2000);
+  #endif
+  boot_stage(BOOT_SERIAL);
+  #if HAS_RING_LOG
+    // Log lines go through the ring from here on, after a crash the
+    // lines before it are printed first
+    ringlog_begin();
+  #endif
 
   // Configure WDT
   #if MCU_VARIANT == MCU_ESP32
@@ -394,17 +622,19 @@ void setup() {
   memset(pbuf, 0, sizeof(pbuf));
   memset(cmdbuf, 0, sizeof(cmdbuf));
   
-  memset(packet_queue, 0, sizeof(packet_queue));
-
-  memset(packet_starts_buf, 0, sizeof(packet_starts_buf));
-  fifo16_init(&packet_starts, packet_starts_buf, CONFIG_QUEUE_MAX_LENGTH);
-  
-  memset(packet_lengths_buf, 0, sizeof(packet_starts_buf));
-  fifo16_init(&packet_lengths, packet_lengths_buf, CONFIG_QUEUE_MAX_LENGTH);
+  tx_queue.clear();
 
   #if PLATFORM == PLATFORM_ESP32 || PLATFORM == PLATFORM_NRF52
     modem_packet_queue = xQueueCreate(MODEM_QUEUE_SIZE, sizeof(modem_packet_t*));
+    modem_packet_pool = xQueueCreate(MODEM_POOL_SIZE, sizeof(modem_packet_t*));
+    if (modem_packet_pool) {
+      for (int i = 0; i < MODEM_POOL_SIZE; i++) {
+        modem_packet_t* slot = &modem_packet_slots[i];
+        xQueueSend(modem_packet_pool, &slot, 0);
+      }
+    }
   #endif
+  boot_stage(BOOT_HW);
 
   // Set chip select, reset and interrupt
   // pins for the LoRa module
@@ -466,6 +696,7 @@ void setup() {
     // so assume that to be the case for now.
     modem_installed = true;
   #endif
+  boot_stage(BOOT_MODEM);
 
   #if HAS_DISPLAY
     #if HAS_EEPROM
@@ -473,12 +704,14 @@ void setup() {
     #elif MCU_VARIANT == MCU_NRF52
     if (eeprom_read(eeprom_addr(ADDR_CONF_DSET)) != CONF_OK_BYTE) {
     #endif
+      eeprom_batch_begin();
       eeprom_update(eeprom_addr(ADDR_CONF_DSET), CONF_OK_BYTE);
       #if BOARD_MODEL == BOARD_TECHO
         eeprom_update(eeprom_addr(ADDR_CONF_DINT), 0x03);
       #else
         eeprom_update(eeprom_addr(ADDR_CONF_DINT), 0xFF);
       #endif
+      eeprom_batch_commit();
     }
     #if BOARD_MODEL == BOARD_TECHO
       display_add_callback(work_while_waiting);
@@ -498,6 +731,7 @@ void setup() {
   #if BOARD_MODEL == BOARD_HELTEC32_V4 || BOARD_MODEL == BOARD_HELTEC32_V3
     headless_led_solid();
   #endif
+  boot_stage(BOOT_DISPLAY);
 
   // ── Boundary Mode: check if config portal is needed ──
   #ifdef BOUNDARY_MODE
@@ -604,6 +838,7 @@ void setup() {
       ESP.restart();
     }
   }
+  boot_stage(BOOT_CONFIG);
   #endif
 
   #if MCU_VARIANT == MCU_ESP32 || MCU_VARIANT == MCU_NRF52
@@ -656,6 +891,7 @@ void setup() {
       kiss_indicate_reset();
     }
   #endif
+  boot_stage(BOOT_BT);
 
   #if MCU_VARIANT == MCU_ESP32 || MCU_VARIANT == MCU_NRF52
     #if MODEM == SX1280
@@ -680,6 +916,7 @@ void setup() {
 
   // Validate board health, EEPROM and config
   validate_status();
+  boot_stage(BOOT_RADIO);
 
   if (op_mode != MODE_TNC) LoRa->setFrequency(0);
 
@@ -700,6 +937,8 @@ void setup() {
       SD.remove("/tracedetails");
       SD.remove("/tracefile.txt");
       SD.remove("/tracedetails.txt");
+      SD.remove("/capture.pcap");
+      SD.remove("/capture.1.pcap");
       Serial.println("DIR: /");
       File root = SD.open("/");
       File file = root.openNextFile();
@@ -735,6 +974,10 @@ void setup() {
 
     HEAD("Registering filesystem...", RNS::LOG_TRACE);
     RNS::Utilities::OS::register_filesystem(filesystem);
+    #if HAS_STATS_LOG
+      stats_log_begin();
+    #endif
+    boot_stage(BOOT_FS);
 
 #ifndef NDEBUG
     //filesystem.remove_directory("/cache");
@@ -778,6 +1021,9 @@ void setup() {
       RNS::setLogCallback(&on_log);
       RNS::Transport::set_receive_packet_callback(on_receive_packet);
       RNS::Transport::set_transmit_packet_callback(on_transmit_packet);
+      #if HAS_PACKET_CAPTURE
+        packet_capture_start();
+      #endif
 
       Serial.write("Starting RNS...\r\n");
       RNS::loglevel(RNS::LOG_VERBOSE);
@@ -785,9 +1031,22 @@ void setup() {
       //RNS::loglevel(RNS::LOG_MEM);
 
       HEAD("Registering LoRA Interface...", RNS::LOG_TRACE);
-      lora_interface = new LoRaInterface();
+      #if MODEM == SX1280 && LORA_FSK_BITRATE > 0
+        // A different name, and so a different interface hash, from LoRa
+        lora_interface_ptr = new LoRaInterface("FskInterface");
+      #else
+        lora_interface_ptr = new LoRaInterface();
+      #endif
+      lora_interface = lora_interface_ptr;
       lora_interface.mode(RNS::Type::Interface::MODE_ACCESS_POINT);
       RNS::Transport::register_interface(lora_interface);
+#if HAS_LORA2
+      lora2_interface_ptr = new Lora2Interface();
+      lora2_rns_interface = lora2_interface_ptr;
+      lora2_rns_interface.mode(RNS::Type::Interface::MODE_ACCESS_POINT);
+      RNS::Transport::register_interface(lora2_rns_interface);
+      HEAD("Second LoRa interface registered", RNS::LOG_TRACE);
+#endif
 
 #ifdef BOUNDARY_MODE
       // ── Boundary Mode: Load config and optionally set up WiFi + TCP ──
@@ -798,8 +1057,27 @@ void setup() {
       // cull_path_table() evicts backbone paths first, preserving local ones.
       RNS::Transport::path_table_maxsize(24);
       RNS::Transport::path_table_maxpersist(12);
+      // Packet hashlist is a fixed ring of 16-byte hashes (~23 bytes/entry incl.
+      // index and Bloom filter). With PSRAM it can hold enough history to stop
+      // backbone duplicates leaking onto LoRa; without it keep it modest.
+      RNS::Transport::hashlist_maxsize(ESP.getPsramSize() > 0 ? 4096 : 512);
+      // Known destinations live in PSRAM (cold heap) when present, with the
+      // link and reverse tables kept in internal SRAM for forwarding.
+      RNS::Identity::known_destinations_maxsize(ESP.getPsramSize() > 0 ? 1024 : 100);
       boundary_load_config();
 
+      // Backbone announces must pass the announce filter before going out on LoRa
+      lora_interface.filter_announces(true);
+      if (BOUNDARY_FILTER_MAX_HOPS > 0) {
+        RNS::Transport::announce_filter().add_hops_rule(BOUNDARY_FILTER_MAX_HOPS);
+      }
+      if (BOUNDARY_FILTER_SOURCE_RATE > 0) {
+        RNS::Transport::announce_filter().add_source_rate_rule(BOUNDARY_FILTER_SOURCE_RATE, BOUNDARY_FILTER_SOURCE_WINDOW);
+      }
+      if (BOUNDARY_FILTER_REQUESTED_ONLY) {
+        RNS::Transport::announce_filter().add_requested_rule();
+      }
+
       // Set up IFAC on the LoRa interface if configured
       if (boundary_state.ifac_enabled &&
           (boundary_state.ifac_netname[0] != '\0' || boundary_state.ifac_passphrase[0] != '\0')) {
@@ -839,6 +1117,7 @@ void setup() {
         tcp_rns_interface = tcp_interface_ptr;
         tcp_rns_interface.mode(RNS::Type::Interface::MODE_BOUNDARY);
         tcp_rns_interface.is_backbone(true);
+        tcp_rns_interface.announce_rate(BOUNDARY_ANNOUNCE_RATE_TARGET, BOUNDARY_ANNOUNCE_RATE_GRACE, BOUNDARY_ANNOUNCE_RATE_PENALTY);
         RNS::Transport::register_interface(tcp_rns_interface);
 
         {
@@ -856,7 +1135,20 @@ void setup() {
       // can discover each other and receive backbone announces.
       // (MODE_ACCESS_POINT blocks all announce broadcasts in outbound(),
       //  which prevented local clients from finding paths to each other.)
-      if (boundary_state.wifi_enabled && boundary_state.ap_tcp_enabled) {
+      if (boundary_state.wifi_enabled && boundary_state.ap_tcp_enabled && boundary_state.ap_udp) {
+        local_udp_interface_ptr = new UdpInterface(boundary_state.ap_tcp_port);
+        local_tcp_rns_interface = local_udp_interface_ptr;
+        local_tcp_rns_interface.mode(RNS::Type::Interface::MODE_GATEWAY);
+        RNS::Transport::register_interface(local_tcp_rns_interface);
+        RNS::Transport::register_local_client_interface(local_tcp_rns_interface);
+
+        {
+          char _bm_msg[128];
+          snprintf(_bm_msg, sizeof(_bm_msg), "Local UDP interface: port %d (GATEWAY mode)",
+                   boundary_state.ap_tcp_port);
+          HEAD(_bm_msg, RNS::LOG_TRACE);
+        }
+      } else if (boundary_state.wifi_enabled && boundary_state.ap_tcp_enabled) {
         local_tcp_interface_ptr = new TcpInterface(
             TCP_IF_MODE_SERVER,
             boundary_state.ap_tcp_port,
@@ -867,6 +1159,9 @@ void setup() {
         // rnsd can be quiet for long stretches — use 10 min timeout
         // to prevent unnecessary reconnection cycles that leak lwIP memory
         local_tcp_interface_ptr->setReadTimeout(600000);
+        // Client slots are allocated on accept, from PSRAM when present,
+        // so boards with PSRAM can take the full slot table
+        local_tcp_interface_ptr->setMaxClients(psramFound() ? TCP_IF_MAX_CLIENTS : TCP_IF_DEFAULT_CLIENTS);
         local_tcp_rns_interface = local_tcp_interface_ptr;
         local_tcp_rns_interface.mode(RNS::Type::Interface::MODE_GATEWAY);
         RNS::Transport::register_interface(local_tcp_rns_interface);
@@ -881,7 +1176,18 @@ void setup() {
           HEAD(_bm_msg, RNS::LOG_TRACE);
         }
       }
+
+#if BOUNDARY_ESPNOW
+      // Works with or without WiFi, announces travel both ways between nodes
+      espnow_interface_ptr = new EspNowInterface(BOUNDARY_ESPNOW_CHANNEL);
+      espnow_rns_interface = espnow_interface_ptr;
+      espnow_rns_interface.mode(RNS::Type::Interface::MODE_FULL);
+      RNS::Transport::register_interface(espnow_rns_interface);
+      HEAD("ESP-NOW node link registered", RNS::LOG_TRACE);
 #endif
+#endif
+
+      boot_stage(BOOT_INTERFACES);
 
       // Feed WDT before Reticulum instance creation (loads caches, generates keys)
       #if MCU_VARIANT == MCU_ESP32
@@ -898,6 +1204,12 @@ void setup() {
 #endif
       reticulum.probe_destination_enabled(true);
       reticulum.start();
+      boot_stage(BOOT_RETICULUM);
+#if HAS_LORA2
+      if (lora2_interface_ptr && !lora2_interface_ptr->start()) {
+        HEAD("Second LoRa radio failed to start", RNS::LOG_WARNING);
+      }
+#endif
 
 #ifdef BOUNDARY_MODE
       // Start TCP interfaces after Reticulum is running
@@ -910,9 +1222,29 @@ void setup() {
           local_tcp_interface_ptr->start();
           HEAD("Boundary Mode: Local TCP server started", RNS::LOG_TRACE);
         }
+        if (local_udp_interface_ptr && local_udp_interface_ptr->start()) {
+          HEAD("Boundary Mode: Local UDP interface started", RNS::LOG_TRACE);
+        }
       } else if (boundary_state.wifi_enabled) {
         HEAD("Boundary Mode: Waiting for WiFi before starting TCP interfaces", RNS::LOG_WARNING);
       }
+#if BOUNDARY_ESPNOW
+      if (espnow_interface_ptr && espnow_interface_ptr->start()) {
+        HEAD("Boundary Mode: ESP-NOW node link started", RNS::LOG_TRACE);
+      }
+#endif
+#if HAS_METRICS
+      metrics_setup();
+#endif
+#if HAS_LOOP_PROFILE
+      loop_profile_setup();
+#endif
+#if HAS_TASK_STATS
+      task_stats_setup();
+#endif
+#if HAS_MEMORY_PRESSURE
+      memory_pressure_setup();
+#endif
 #endif
 
       // CBA load/create local destination for admin node
@@ -947,6 +1279,8 @@ void setup() {
 
       HEAD("RNS is READY!", RNS::LOG_TRACE);
 #ifdef BOUNDARY_MODE
+      // From here on Transport runs on its own task (see TransportTask.h)
+      transport_task_start();
       HEAD("*** BOUNDARY MODE ACTIVE ***", RNS::LOG_TRACE);
       HEAD("RNS transport mode is ENABLED (boundary)", RNS::LOG_TRACE);
       HEAD("LoRa Interface: MODE_ACCESS_POINT", RNS::LOG_TRACE);
@@ -960,8 +1294,8 @@ void setup() {
           HEAD("TCP Backbone: DISABLED", RNS::LOG_TRACE);
         }
         if (boundary_state.ap_tcp_enabled) {
-          snprintf(_bm_info, sizeof(_bm_info), "Local TCP Server: port %d (MODE_ACCESS_POINT)",
-                   boundary_state.ap_tcp_port);
+          snprintf(_bm_info, sizeof(_bm_info), "Local %s Server: port %d (MODE_ACCESS_POINT)",
+                   boundary_state.ap_udp ? "UDP" : "TCP", boundary_state.ap_tcp_port);
           HEAD(_bm_info, RNS::LOG_TRACE);
         }
         if (!boundary_state.wifi_enabled) {
@@ -994,6 +1328,13 @@ void setup() {
     ERROR("RNS startup failed: " + std::string(e.what()));
   }
 #endif  // HAS_RNS
+
+  #if HAS_DISPLAY && DISP_RENDER_TASK
+    display_render_task_start();
+  #endif
+
+  boot_stage(BOOT_READY);
+  boot_timeline_print();
 }
 
 void lora_receive() {
@@ -1004,51 +1345,34 @@ void lora_receive() {
   }
 }
 
-inline void kiss_write_packet() {
+// Reading the channel RSSI wakes an SX126x out of its receive duty cycle,
+// so while it sniffs, carrier sense rests on preamble detection alone
+inline bool lora_rssi_available() {
+  #if LORA_RX_DUTY_CYCLE
+    return !LoRa->sniffing();
+  #else
+    return true;
+  #endif
+}
+
+inline void kiss_write_packet(const uint8_t* buf = pbuf) {
 
 #ifdef HAS_RNS
   TRACEF("Received %d byte packet", host_write_len);
   // CBA send packet received over LoRa to RNS in addition to connected client
-  // CBA RESERVE
-  //RNS::Bytes data();
-  RNS::Bytes data(512);
-  for (uint16_t i = 0; i < host_write_len; i++) {
-    #if MCU_VARIANT == MCU_NRF52
-      portENTER_CRITICAL();
-      uint8_t byte = pbuf[i];
-      portEXIT_CRITICAL();
-    #else
-      uint8_t byte = pbuf[i];
-    #endif
-    data << byte;
-  }
-  lora_interface.handle_incoming(data);
+  RNS::Bytes data(buf, host_write_len);
+  if (lora_interface_ptr) lora_interface_ptr->receive(data);
 #endif
 
   serial_write(FEND);
   serial_write(CMD_DATA);
-  
-  for (uint16_t i = 0; i < host_write_len; i++) {
-    #if MCU_VARIANT == MCU_NRF52
-      portENTER_CRITICAL();
-      uint8_t byte = pbuf[i];
-      portEXIT_CRITICAL();
-    #else
-      uint8_t byte = pbuf[i];
-    #endif
 
-    if (byte == FEND) { serial_write(FESC); byte = TFEND; }
-    if (byte == FESC) { serial_write(FESC); byte = TFESC; }
-    serial_write(byte);
-  }
+  // Escaped in one pass straight into the host output buffer
+  escaped_serial_write(buf, host_write_len);
 
   serial_write(FEND);
   host_write_len = 0;
 
-  #if MCU_VARIANT == MCU_ESP32 || MCU_VARIANT == MCU_NRF52
-    packet_ready = false;
-  #endif
-
   #if MCU_VARIANT == MCU_ESP32
     #if HAS_BLE
       bt_flush();
@@ -1056,25 +1380,128 @@ inline void kiss_write_packet() {
   #endif
 }
 
-inline void getPacketData(uint16_t len) {
-  #if MCU_VARIANT != MCU_NRF52
-    while (len-- && read_len < MTU) {
-      pbuf[read_len++] = LoRa->read();
-    }  
+// Buffer the frame being received is assembled in. A pool slot
+// belongs to the receiver until it is queued and to the main loop
+// after that, so neither side needs a lock around the frame.
+inline uint8_t* rx_buffer() {
+  #if MCU_VARIANT == MCU_ESP32 || MCU_VARIANT == MCU_NRF52
+    if (!modem_rx_slot) { modem_rx_slot = modem_packet_take(); }
+    return modem_rx_slot ? modem_rx_slot->data : NULL;
   #else
-    BaseType_t int_mask = taskENTER_CRITICAL_FROM_ISR();
-    while (len-- && read_len < MTU) {
-      pbuf[read_len++] = LoRa->read();
-    }
-    taskEXIT_CRITICAL_FROM_ISR(int_mask);
+    return pbuf;
   #endif
 }
 
-void ISR_VECT receive_callback(int packet_size) {
-  #if MCU_VARIANT == MCU_ESP32 || MCU_VARIANT == MCU_NRF52
-    BaseType_t int_mask;
-  #endif
+#if MCU_VARIANT == MCU_ESP32 || MCU_VARIANT == MCU_NRF52
+// Hands a received frame to the host, one packet at a time if the
+// sender aggregated several into it
+void kiss_write_modem_packet(modem_packet_t* modem_packet) {
+  if (!modem_packet->aggregated) {
+    host_write_len = modem_packet->len;
+    kiss_write_packet(modem_packet->data);
+    return;
+  }
+  size_t i = 0;
+  while (i < modem_packet->len) {
+    uint8_t len = modem_packet->data[i++];
+    if (len == 0 || i + len > modem_packet->len) { break; }
+    host_write_len = len;
+    kiss_write_packet(modem_packet->data + i);
+    i += len;
+  }
+}
+#endif
+
+inline uint16_t readPacketData(uint8_t* buf, uint16_t offset, uint16_t len) {
+  if (len > MTU - offset) { len = MTU - offset; }
+  // One FIFO burst instead of an SPI command per byte
+  return LoRa->readPayload(buf + offset, len);
+}
+
+inline void getPacketData(uint16_t len) {
+  uint8_t* buf = rx_buffer();
+  if (!buf) { memory_low = true; return; }
+  read_len += readPacketData(buf, read_len, len);
+}
+
+#if MCU_VARIANT == MCU_ESP32 || MCU_VARIANT == MCU_NRF52
+// Sends a complete frame in its pool slot to the event queue, or
+// returns it to the pool if the queue is full
+void modem_packet_deliver(modem_packet_t* modem_packet, bool aggregated) {
+  // Get packet RSSI and SNR while they still belong to this frame
+  modem_packet->snr_raw = LoRa->packetSnrRaw();
+  modem_packet->rssi = LoRa->packetRssi(modem_packet->snr_raw);
+  modem_packet->aggregated = aggregated;
+  if (!modem_packet_queue || xQueueSendFromISR(modem_packet_queue, &modem_packet, NULL) != pdPASS) {
+      modem_packet_release(modem_packet);
+  }
+}
+
+// Split packets are reassembled in a small table keyed by sequence
+// number, so halves from two transmitters can interleave, and a lost
+// half only costs its own packet. Each entry holds a pool slot.
+typedef struct {
+  modem_packet_t* packet;   // NULL if the entry is free
+  uint8_t seq;
+  uint32_t started;
+} lora_reasm_t;
+static lora_reasm_t lora_reasm[LORA_REASM_SLOTS];
+uint32_t lora_reasm_dropped = 0;
+
+// The second half follows the first straight away; allow for a few
+// frames of someone else's traffic in between
+uint32_t lora_reasm_timeout_ms() {
+  return (3*airtime_table_us[SINGLE_MTU])/1000 + LORA_REASM_MARGIN_MS;
+}
+
+void lora_reasm_free(lora_reasm_t* entry) {
+  modem_packet_release(entry->packet);
+  entry->packet = NULL;
+}
+
+void lora_reasm_clear() {
+  for (uint8_t i = 0; i < LORA_REASM_SLOTS; i++) {
+    if (lora_reasm[i].packet) { lora_reasm_free(&lora_reasm[i]); }
+  }
+}
 
+void lora_reasm_fragment(uint8_t sequence, int packet_size) {
+  uint32_t now = millis();
+  uint32_t timeout = lora_reasm_timeout_ms();
+  lora_reasm_t* entry = NULL;
+  lora_reasm_t* spare = NULL;
+  for (uint8_t i = 0; i < LORA_REASM_SLOTS; i++) {
+    lora_reasm_t* e = &lora_reasm[i];
+    if (e->packet && now - e->started > timeout) { lora_reasm_free(e); lora_reasm_dropped++; }
+    if (!e->packet) { if (!spare || spare->packet) spare = e; continue; }
+    if (e->seq == sequence) { entry = e; }
+    else if (!spare || (spare->packet && e->started < spare->started)) { spare = e; }
+  }
+
+  if (entry) {
+    // Second half, the packet is complete
+    modem_packet_t* modem_packet = entry->packet;
+    entry->packet = NULL;
+    modem_packet->len += readPacketData(modem_packet->data, modem_packet->len, packet_size);
+    modem_packet_deliver(modem_packet, false);
+    return;
+  }
+
+  // The first half always fills a whole frame, anything shorter is a
+  // second half whose first one was lost
+  if (packet_size < SINGLE_MTU - HEADER_L) { lora_reasm_dropped++; return; }
+
+  // Table full, give up on the oldest reassembly
+  if (spare->packet) { lora_reasm_free(spare); lora_reasm_dropped++; }
+  spare->packet = modem_packet_take();
+  if (!spare->packet) { memory_low = true; return; }
+  spare->seq = sequence;
+  spare->started = now;
+  spare->packet->len = readPacketData(spare->packet->data, 0, packet_size);
+}
+#endif
+
+void ISR_VECT receive_callback(int packet_size) {
   if (!promisc) {
     // The standard operating mode allows large
     // packets with a payload up to 500 bytes,
@@ -1085,20 +1512,28 @@ void ISR_VECT receive_callback(int packet_size) {
     uint8_t sequence = packetSequence(header);
     bool    ready    = false;
 
+    // Track whether every node we hear can take aggregated frames
+    if (header & FLAG_AGGR_OK) { aggr_heard_capable = millis(); }
+    else                       { aggr_heard_legacy  = millis(); }
+
+    #if MCU_VARIANT == MCU_ESP32 || MCU_VARIANT == MCU_NRF52
+      if (isSplitPacket(header)) {
+        lora_reasm_fragment(sequence, packet_size);
+        return;
+      }
+    #endif
+
     if (isSplitPacket(header) && seq == SEQ_UNSET) {
       // This is the first part of a split
       // packet, so we set the seq variable
       // and add the data to the buffer
-      #if MCU_VARIANT == MCU_NRF52
-        int_mask = taskENTER_CRITICAL_FROM_ISR(); read_len = 0; taskEXIT_CRITICAL_FROM_ISR(int_mask);
-      #else
-        read_len = 0;
-      #endif
+      read_len = 0;
       
       seq = sequence;
 
       #if MCU_VARIANT != MCU_ESP32 && MCU_VARIANT != MCU_NRF52
         last_rssi = LoRa->packetRssi();
+        last_rssi_at = millis();
         last_snr_raw = LoRa->packetSnrRaw();
       #endif
 
@@ -1110,6 +1545,7 @@ void ISR_VECT receive_callback(int packet_size) {
       // and set the ready flag.
       #if MCU_VARIANT != MCU_ESP32 && MCU_VARIANT != MCU_NRF52
         last_rssi = (last_rssi+LoRa->packetRssi())/2;
+        last_rssi_at = millis();
         last_snr_raw = (last_snr_raw+LoRa->packetSnrRaw())/2;
       #endif
 
@@ -1122,15 +1558,12 @@ void ISR_VECT receive_callback(int packet_size) {
       // same sequence id, so we must assume
       // that we are seeing the first part of
       // a new split packet.
-      #if MCU_VARIANT == MCU_NRF52
-        int_mask = taskENTER_CRITICAL_FROM_ISR(); read_len = 0; taskEXIT_CRITICAL_FROM_ISR(int_mask);
-      #else
-        read_len = 0;
-      #endif
+      read_len = 0;
       seq = sequence;
 
       #if MCU_VARIANT != MCU_ESP32 && MCU_VARIANT != MCU_NRF52
         last_rssi = LoRa->packetRssi();
+        last_rssi_at = millis();
         last_snr_raw = LoRa->packetSnrRaw();
       #endif
 
@@ -1144,16 +1577,13 @@ void ISR_VECT receive_callback(int packet_size) {
       if (seq != SEQ_UNSET) {
         // If we already had part of a split
         // packet in the buffer, we clear it.
-        #if MCU_VARIANT == MCU_NRF52
-          int_mask = taskENTER_CRITICAL_FROM_ISR(); read_len = 0; taskEXIT_CRITICAL_FROM_ISR(int_mask);
-        #else
-          read_len = 0;
-        #endif
+        read_len = 0;
         seq = SEQ_UNSET;
       }
 
       #if MCU_VARIANT != MCU_ESP32 && MCU_VARIANT != MCU_NRF52
         last_rssi = LoRa->packetRssi();
+        last_rssi_at = millis();
         last_snr_raw = LoRa->packetSnrRaw();
       #endif
 
@@ -1165,33 +1595,25 @@ void ISR_VECT receive_callback(int packet_size) {
       #if MCU_VARIANT != MCU_ESP32 && MCU_VARIANT != MCU_NRF52
         // We first signal the RSSI of the
         // recieved packet to the host.
+        serial_batch_begin();
         kiss_indicate_stat_rssi();
         kiss_indicate_stat_snr();
 
         // And then write the entire packet
         host_write_len = read_len;
         kiss_write_packet(); read_len = 0;
+        serial_batch_end();
       
       #else
-        // Allocate packet struct, but abort if there
-        // is not enough memory available.
-        modem_packet_t *modem_packet = (modem_packet_t*)malloc(sizeof(modem_packet_t) + read_len);
-        if(!modem_packet) { memory_low = true; return; }
-
-        // Get packet RSSI and SNR
-        #if MCU_VARIANT == MCU_ESP32
-          modem_packet->snr_raw = LoRa->packetSnrRaw();
-          modem_packet->rssi = LoRa->packetRssi(modem_packet->snr_raw);
-        #endif
-
-        // Send packet to event queue, but free the
-        // allocated memory again if the queue is
-        // unable to receive the packet.
-        modem_packet->len = read_len;
-        memcpy(modem_packet->data, pbuf, read_len); read_len = 0;
-        if (!modem_packet_queue || xQueueSendFromISR(modem_packet_queue, &modem_packet, NULL) != pdPASS) {
-            free(modem_packet);
-        }
+        // The frame was read straight into the current
+        // pool slot. If no slot was available, getPacketData()
+        // has already flagged memory_low and the frame is lost.
+        modem_packet_t *modem_packet = modem_rx_slot;
+        if (!modem_packet) { read_len = 0; return; }
+        modem_rx_slot = NULL;
+
+        modem_packet->len = read_len; read_len = 0;
+        modem_packet_deliver(modem_packet, isAggregatedPacket(header));
       #endif
     }  
   } else {
@@ -1201,20 +1623,29 @@ void ISR_VECT receive_callback(int packet_size) {
 
     #if MCU_VARIANT != MCU_ESP32 && MCU_VARIANT != MCU_NRF52
       last_rssi = LoRa->packetRssi();
+      last_rssi_at = millis();
       last_snr_raw = LoRa->packetSnrRaw();
       getPacketData(packet_size);
 
       // We first signal the RSSI of the
       // recieved packet to the host.
+      serial_batch_begin();
       kiss_indicate_stat_rssi();
       kiss_indicate_stat_snr();
 
       // And then write the entire packet
       kiss_write_packet();
+      serial_batch_end();
 
     #else
+      // Queued like any other frame, the main loop writes it out
       getPacketData(packet_size);
-      packet_ready = true;
+      modem_packet_t *modem_packet = modem_rx_slot;
+      if (!modem_packet) { read_len = 0; return; }
+      modem_rx_slot = NULL;
+
+      modem_packet->len = read_len; read_len = 0;
+      modem_packet_deliver(modem_packet, false);
     #endif
   }
 }
@@ -1223,6 +1654,9 @@ bool startRadio() {
   update_radio_lock();
   if (!radio_online && !console_active) {
     if (!radio_locked && hw_ready) {
+      #if MODEM == SX1280
+        LoRa->setFskMode(LORA_FSK_BITRATE);
+      #endif
       if (!LoRa->begin(lora_freq)) {
         // The radio could not be started.
         // Indicate this failure over both the
@@ -1271,6 +1705,10 @@ bool startRadio() {
 }
 
 void stopRadio() {
+  lora_tx_abort();
+  #if MCU_VARIANT == MCU_ESP32 || MCU_VARIANT == MCU_NRF52
+    lora_reasm_clear();
+  #endif
   LoRa->end();
   radio_online = false;
 }
@@ -1283,76 +1721,122 @@ void update_radio_lock() {
   }
 }
 
-bool queue_full() { return (queue_height >= CONFIG_QUEUE_MAX_LENGTH || queued_bytes >= CONFIG_QUEUE_SIZE); }
+bool queue_full() { return tx_queue.full(); }
 
 volatile bool queue_flushing = false;
-void flush_queue(void) {
-  if (!queue_flushing) {
-    queue_flushing = true;
-    led_tx_on();
 
-    #if MCU_VARIANT == MCU_ESP32 || MCU_VARIANT == MCU_NRF52
-    while (!fifo16_isempty(&packet_starts)) {
-    #else
-    while (!fifo16_isempty_locked(&packet_starts)) {
-    #endif
+// Non-blocking LoRa transmit. The packet popped from tx_queue stays in its
+// slot while it is on air; lora_tx_service() is called from loop() and puts
+// the second half of a split packet, and with flush_queue() the following
+// packets, on air as each one completes.
+struct LoRaTx {
+  bool           active;
+  bool           flush;      // keep going until the queue is empty
+  uint8_t        slot;
+  const uint8_t* data;
+  uint16_t       length;
+  uint32_t       started;    // millis() the frame was taken off the queue
+  uint16_t       offset;     // payload bytes already handed to the modem
+  uint16_t       written;    // bytes in the part on air, header included
+  uint8_t        header;
+  uint8_t        aggr_count; // packets combined into data, 0 if not aggregated
+  uint8_t        aggr_slots[LORA_AGGR_MAX_PACKETS];
+};
+LoRaTx lora_tx = {};
+uint8_t lora_aggr_buf[SINGLE_MTU - HEADER_L];
 
-      uint16_t start = fifo16_pop(&packet_starts);
-      uint16_t length = fifo16_pop(&packet_lengths);
+bool lora_tx_active() { return lora_tx.active; }
 
-      if (length >= MIN_L && length <= MTU) {
-        for (uint16_t i = 0; i < length; i++) {
-          uint16_t pos = (start+i)%CONFIG_QUEUE_SIZE;
-          tbuf[i] = packet_queue[pos];
-        }
+// Aggregation is enabled and everyone in range has said they can take it
+bool lora_aggregation_active() {
+  if (!lora_aggregate || promisc || implicit) { return false; }
+  uint32_t now = millis();
+  if (aggr_heard_capable == 0 || now - aggr_heard_capable > LORA_AGGR_PEER_TIMEOUT) { return false; }
+  return aggr_heard_legacy == 0 || now - aggr_heard_legacy > LORA_AGGR_PEER_TIMEOUT;
+}
 
-        transmit(length);
-      }
+// Packs further small packets from the queue in behind the one just
+// popped, as [length][packet] records
+void lora_tx_aggregate() {
+  lora_tx.aggr_count = 0;
+  if (!lora_aggregation_active() || lora_tx.length > LORA_AGGR_MAX_ITEM) { return; }
+
+  uint16_t used = 0;
+  uint8_t slot = lora_tx.slot; const uint8_t* data = lora_tx.data; uint16_t length = lora_tx.length;
+  while (true) {
+    lora_aggr_buf[used++] = length;
+    memcpy(lora_aggr_buf + used, data, length); used += length;
+    lora_tx.aggr_slots[lora_tx.aggr_count++] = slot;
+
+    if (lora_tx.aggr_count == LORA_AGGR_MAX_PACKETS || tx_queue.height() == 0) { break; }
+    if (!tx_queue.pop(slot, data, length)) { break; }
+    if (length > LORA_AGGR_MAX_ITEM || used + 1 + length > sizeof(lora_aggr_buf)) {
+      tx_queue.unpop(slot);
+      break;
     }
-
-    lora_receive(); led_tx_off();
   }
 
-  queue_height = 0;
-  queued_bytes = 0;
+  // Nothing to combine it with, send the packet as it is
+  if (lora_tx.aggr_count < 2) { lora_tx.aggr_count = 0; return; }
+  lora_tx.data = lora_aggr_buf;
+  lora_tx.length = used;
+}
 
-  #if MCU_VARIANT == MCU_ESP32 || MCU_VARIANT == MCU_NRF52
-    update_airtime();
+bool lora_tx_next() {
+  if (!tx_queue.pop(lora_tx.slot, lora_tx.data, lora_tx.length)) { return false; }
+  lora_tx.started = millis();
+  lora_tx_aggregate();
+  #if HAS_METRICS
+    metric_lora_tx_frames.inc();
+    metric_lora_tx_size.observe(lora_tx.length);
   #endif
+  return true;
+}
 
-  queue_flushing = false;
-
-  #if HAS_DISPLAY
-    display_tx = true;
+void lora_tx_release() {
+  if (lora_tx.aggr_count) {
+    for (uint8_t i = 0; i < lora_tx.aggr_count; i++) { tx_queue.release(lora_tx.aggr_slots[i]); }
+    lora_tx.aggr_count = 0;
+  } else {
+    tx_queue.release(lora_tx.slot);
+  }
+  #ifdef HAS_RNS
+    if (lora_interface_ptr) { lora_interface_ptr->tx_released(); }
   #endif
 }
 
-void pop_queue() {
-  if (!queue_flushing) {
-    queue_flushing = true; led_tx_on();
-
-    #if MCU_VARIANT == MCU_ESP32 || MCU_VARIANT == MCU_NRF52
-    if (!fifo16_isempty(&packet_starts)) {
-    #else
-    if (!fifo16_isempty_locked(&packet_starts)) {
-    #endif
-
-      uint16_t start = fifo16_pop(&packet_starts);
-      uint16_t length = fifo16_pop(&packet_lengths);
-      if (length >= MIN_L && length <= MTU) {
-        for (uint16_t i = 0; i < length; i++) {
-          uint16_t pos = (start+i)%CONFIG_QUEUE_SIZE;
-          tbuf[i] = packet_queue[pos];
-        }
-
-        transmit(length);
+void lora_tx_begin(bool flush) {
+  if (!queue_flushing && !lora_tx.active) {
+    if (lora_tx_next()) {
+      if (!radio_online) {
+        lora_tx_release();
+        kiss_indicate_error(ERROR_TXFAILED); led_indicate_error(5);
+        return;
       }
-      queue_height -= 1;
-      queued_bytes -= length;
+      queue_flushing = true; led_tx_on();
+      lora_tx.active = true;
+      lora_tx.flush = flush;
+      start_transmit();
     }
+  }
+}
 
-    lora_receive(); led_tx_off();
+// The packet on air, if any, is lost with the radio
+void lora_tx_abort() {
+  if (lora_tx.active) {
+    lora_tx_release();
+    lora_tx.active = false;
+    queue_flushing = false;
+    led_tx_off();
   }
+}
+
+void flush_queue(void) { lora_tx_begin(true); }
+void pop_queue()       { lora_tx_begin(false); }
+
+void lora_tx_finish() {
+  lora_tx.active = false;
+  lora_receive(); led_tx_off();
 
   #if MCU_VARIANT == MCU_ESP32 || MCU_VARIANT == MCU_NRF52
     update_airtime();
@@ -1365,41 +1849,63 @@ void pop_queue() {
   #endif
 }
 
+void lora_tx_service() {
+  if (!lora_tx.active) return;
+
+  int result = LoRa->pollTransmit();
+  if (result == 0) return;
+  if (result < 0) {
+    kiss_indicate_error(ERROR_MODEM_TIMEOUT);
+    kiss_indicate_error(ERROR_TXFAILED);
+    led_indicate_error(5);
+    hard_reset();
+  }
+  add_airtime(lora_tx.written);
+
+  // Second half of a split packet
+  if (lora_tx.offset < lora_tx.length) { transmit_part(); return; }
+
+  #ifdef HAS_RNS
+    if (lora_interface_ptr) { lora_interface_ptr->transmitted(lora_tx.length, lora_tx.started, tx_queue.queued_at(lora_tx.slot)); }
+  #endif
+  lora_tx_release();
+  if (lora_tx.flush && lora_tx_next()) {
+    start_transmit();
+    return;
+  }
+  lora_tx_finish();
+}
+
+#if MCU_VARIANT == MCU_ESP32 || MCU_VARIANT == MCU_NRF52
+// Bins are cleared one ahead of the current one as time moves on, the
+// running sums drop what the cleared bin held
+inline void clear_airtime_bin(uint16_t bin) {
+  airtime_bins_sum -= airtime_bins[bin];
+  airtime_bins[bin] = 0;
+}
+
+inline void clear_longterm_bin(uint16_t bin) {
+  longterm_bins_sum -= longterm_bins[bin];
+  longterm_bins[bin] = 0.0;
+  // Resynchronise the float sum once per rotation so rounding can't build up
+  if (bin == 0) {
+    longterm_bins_sum = 0.0;
+    for (uint16_t lb = 0; lb < AIRTIME_BINS; lb++) { longterm_bins_sum += longterm_bins[lb]; }
+  }
+}
+#endif
+
 void add_airtime(uint16_t written) {
   #if MCU_VARIANT == MCU_ESP32 || MCU_VARIANT == MCU_NRF52
-    float lora_symbols = 0;
-    float packet_cost_ms = 0.0;
-    int ldr_opt = 0; if (lora_low_datarate) ldr_opt = 1;
-
-    #if MODEM == SX1276 || MODEM == SX1278
-      lora_symbols += (8*written + PHY_CRC_LORA_BITS - 4*lora_sf + 8 + PHY_HEADER_LORA_SYMBOLS);
-      lora_symbols /=                          4*(lora_sf-2*ldr_opt);
-      lora_symbols *= lora_cr;
-      lora_symbols += lora_preamble_symbols + 0.25 + 8;
-      packet_cost_ms += lora_symbols * lora_symbol_time_ms;
-      
-    #elif MODEM == SX1262 || MODEM == SX1280
-      if (lora_sf < 7) {
-        lora_symbols += (8*written + PHY_CRC_LORA_BITS - 4*lora_sf + PHY_HEADER_LORA_SYMBOLS);
-        lora_symbols /=                              4*lora_sf;
-        lora_symbols *= lora_cr;
-        lora_symbols += lora_preamble_symbols + 2.25 + 8;
-        packet_cost_ms += lora_symbols * lora_symbol_time_ms;
-
-      } else {
-        lora_symbols += (8*written + PHY_CRC_LORA_BITS - 4*lora_sf + 8 + PHY_HEADER_LORA_SYMBOLS);
-        lora_symbols /=                         4*(lora_sf-2*ldr_opt);
-        lora_symbols *= lora_cr;
-        lora_symbols += lora_preamble_symbols + 0.25 + 8;
-        packet_cost_ms += lora_symbols * lora_symbol_time_ms;
-      }
-    
-    #endif
+    if (written > SINGLE_MTU) { written = SINGLE_MTU; }
+    uint16_t packet_cost_ms = (airtime_table_us[written]+500)/1000;
 
     uint16_t cb = current_airtime_bin();
     uint16_t nb = cb+1; if (nb == AIRTIME_BINS) { nb = 0; }
     airtime_bins[cb] += packet_cost_ms;
-    airtime_bins[nb] = 0;
+    airtime_bins_sum += packet_cost_ms;
+    airtime_ms_total += packet_cost_ms;
+    clear_airtime_bin(nb);
 
   #endif
 }
@@ -1409,94 +1915,78 @@ void update_airtime() {
     uint16_t cb = current_airtime_bin();
     uint16_t pb = cb-1; if (cb-1 < 0) { pb = AIRTIME_BINS-1; }
     uint16_t nb = cb+1; if (nb == AIRTIME_BINS) { nb = 0; }
-    airtime_bins[nb] = 0; airtime = (float)(airtime_bins[cb]+airtime_bins[pb])/(2.0*AIRTIME_BINLEN_MS);
-
-    uint32_t longterm_airtime_sum = 0;
-    for (uint16_t bin = 0; bin < AIRTIME_BINS; bin++) { longterm_airtime_sum += airtime_bins[bin]; }
-    longterm_airtime = (float)longterm_airtime_sum/(float)AIRTIME_LONGTERM_MS;
+    clear_airtime_bin(nb); airtime = (float)(airtime_bins[cb]+airtime_bins[pb])/(2.0*AIRTIME_BINLEN_MS);
 
-    float longterm_channel_util_sum = 0.0;
-    for (uint16_t bin = 0; bin < AIRTIME_BINS; bin++) { longterm_channel_util_sum += longterm_bins[bin]; }
-    longterm_channel_util = (float)longterm_channel_util_sum/(float)AIRTIME_BINS;
+    longterm_airtime = (float)airtime_bins_sum/(float)AIRTIME_LONGTERM_MS;
+    if (longterm_bins_sum < 0.0) { longterm_bins_sum = 0.0; }
+    longterm_channel_util = longterm_bins_sum/(float)AIRTIME_BINS;
 
+    // CSMA and channel stats go out to the host in one write
+    serial_batch_begin();
     #if MCU_VARIANT == MCU_ESP32 || MCU_VARIANT == MCU_NRF52
       update_csma_parameters();
     #endif
 
     kiss_indicate_channel_stats();
+    serial_batch_end();
   #endif
 }
 
-void transmit(uint16_t size) {
-  if (radio_online) {
-    if (!promisc) {
-      uint16_t  written = 0;
-      uint8_t header  = random(256) & 0xF0;
-      if (size > SINGLE_MTU - HEADER_L) { header = header | FLAG_SPLIT; }
-
-      LoRa->beginPacket();
-      LoRa->write(header); written++;
-
-      for (uint16_t i=0; i < size; i++) {
-        LoRa->write(tbuf[i]); written++;
-
-        if (written == 255 && isSplitPacket(header)) {
-          if (!LoRa->endPacket()) {
-            kiss_indicate_error(ERROR_MODEM_TIMEOUT);
-            kiss_indicate_error(ERROR_TXFAILED);
-            led_indicate_error(5);
-            hard_reset();
-          }
-
-          add_airtime(written);
-          LoRa->beginPacket();
-          LoRa->write(header);
-          written = 1;
-        }
-      }
+// Starts the packet in lora_tx on air
+void start_transmit() {
+  lora_tx.offset = 0;
+  lora_tx.header = getRandom() & 0xF0;
+  if (!promisc && lora_tx.length > SINGLE_MTU - HEADER_L) { lora_tx.header = lora_tx.header | FLAG_SPLIT; }
+  if (lora_tx.aggr_count) { lora_tx.header = lora_tx.header | FLAG_AGGR; }
+  if (lora_aggregate)     { lora_tx.header = lora_tx.header | FLAG_AGGR_OK; }
+  transmit_part();
+}
 
-      if (!LoRa->endPacket()) {
-        kiss_indicate_error(ERROR_MODEM_TIMEOUT);
-        kiss_indicate_error(ERROR_TXFAILED);
-        led_indicate_error(5);
-        hard_reset();
-      }
+// Writes the next part of the packet in lora_tx to the modem and starts
+// it, a split packet goes out as two parts of at most 255 bytes
+void transmit_part() {
+  const uint8_t* tbuf = lora_tx.data + lora_tx.offset;
+  uint16_t size = lora_tx.length - lora_tx.offset;
 
-      add_airtime(written);
+  if (!promisc) {
+    if (size > SINGLE_MTU - HEADER_L) { size = SINGLE_MTU - HEADER_L; }
+    // Header and payload go to the radio FIFO as one burst
+    uint8_t frame[SINGLE_MTU];
+    frame[0] = lora_tx.header;
+    memcpy(frame + HEADER_L, tbuf, size);
+    LoRa->beginPacket();
+    LoRa->write(frame, size + HEADER_L);
+    lora_tx.written = size + HEADER_L;
 
-    } else {
-      led_tx_on(); uint16_t written = 0;
-      if (size > SINGLE_MTU) { size = SINGLE_MTU; }
-      if (!implicit) { LoRa->beginPacket(); }
-      else           { LoRa->beginPacket(size); }
-      for (uint16_t i=0; i < size; i++) { LoRa->write(tbuf[i]); written++; }
-      LoRa->endPacket(); add_airtime(written);
-    }
+  } else {
+    if (size > SINGLE_MTU) { size = SINGLE_MTU; }
+    if (!implicit) { LoRa->beginPacket(); }
+    else           { LoRa->beginPacket(size); }
+    LoRa->write(tbuf, size);
+    lora_tx.written = size;
+    // Anything beyond a single frame is not sent in promiscuous mode
+    size = lora_tx.length - lora_tx.offset;
+  }
 
-  } else { kiss_indicate_error(ERROR_TXFAILED); led_indicate_error(5); }
+  lora_tx.offset += size;
+  LoRa->startTransmit();
 }
 
 void serial_callback(uint8_t sbyte) {
   if (IN_FRAME && sbyte == FEND && command == CMD_DATA) {
     IN_FRAME = false;
 
-    if (!fifo16_isfull(&packet_starts) && queued_bytes < CONFIG_QUEUE_SIZE) {
-        uint16_t s = current_packet_start;
-        int16_t e = queue_cursor-1; if (e == -1) e = CONFIG_QUEUE_SIZE-1;
-        uint16_t l;
-
-        if (s != e) { l = (s < e) ? e - s + 1 : CONFIG_QUEUE_SIZE - s + e + 1; }
-        else        { l = 1; }
-
-        if (l >= MIN_L) {
-            queue_height++;
-            fifo16_push(&packet_starts, s);
-            fifo16_push(&packet_lengths, l);
-            current_packet_start = queue_cursor;
-        }
-    }
+    // The frame was collected in tbuf, queue it in one go
+    tx_queue.push(tbuf, frame_len);
 
   } else if (sbyte == FEND) {
+    #if HAS_LIVE_CONFIG
+    // A CMD_BACKBONE frame holding just one 0x00 is a query; it can only be
+    // told apart from a set with a zero high port byte once the frame ends
+    if (IN_FRAME && command == CMD_BACKBONE && frame_len == 1 && cmdbuf[0] == 0x00) {
+      kiss_indicate_backbone();
+    }
+    #endif
     IN_FRAME = true;
     command = CMD_UNKNOWN;
     frame_len = 0;
@@ -1516,11 +2006,7 @@ void serial_callback(uint8_t sbyte) {
                 if (sbyte == TFESC) sbyte = FESC;
                 ESCAPE = false;
             }
-            if (queue_height < CONFIG_QUEUE_MAX_LENGTH && queued_bytes < CONFIG_QUEUE_SIZE) {
-              queued_bytes++;
-              packet_queue[queue_cursor++] = sbyte;
-              if (queue_cursor == CONFIG_QUEUE_SIZE) queue_cursor = 0;
-            }
+            tbuf[frame_len++] = sbyte;
         }
     } else if (command == CMD_FREQUENCY) {
       if (sbyte == FESC) {
@@ -1539,6 +2025,11 @@ void serial_callback(uint8_t sbyte) {
 
           if (freq == 0) {
             kiss_indicate_frequency();
+          #if HAS_LIVE_CONFIG
+          } else if (op_mode == MODE_TNC) {
+            // Applied once the TX queue has drained, and indicated then
+            live_config_radio(LIVE_FREQ, freq);
+          #endif
           } else {
             lora_freq = freq;
             if (op_mode == MODE_HOST) setFrequency();
@@ -1562,6 +2053,10 @@ void serial_callback(uint8_t sbyte) {
 
           if (bw == 0) {
             kiss_indicate_bandwidth();
+          #if HAS_LIVE_CONFIG
+          } else if (op_mode == MODE_TNC) {
+            live_config_radio(LIVE_BW, bw);
+          #endif
           } else {
             lora_bw = bw;
             if (op_mode == MODE_HOST) setBandwidth();
@@ -1589,9 +2084,14 @@ void serial_callback(uint8_t sbyte) {
           if (txp > 17) txp = 17;
         #endif
 
-        lora_txp = txp;
-        if (op_mode == MODE_HOST) setTXPower();
-        kiss_indicate_txpower();
+        #if HAS_LIVE_CONFIG
+        if (op_mode == MODE_TNC) { live_config_radio(LIVE_TXP, txp); } else
+        #endif
+        {
+          lora_txp = txp;
+          if (op_mode == MODE_HOST) setTXPower();
+          kiss_indicate_txpower();
+        }
       }
     } else if (command == CMD_SF) {
       if (sbyte == 0xFF) {
@@ -1601,9 +2101,14 @@ void serial_callback(uint8_t sbyte) {
         if (sf < 5) sf = 5;
         if (sf > 12) sf = 12;
 
-        lora_sf = sf;
-        if (op_mode == MODE_HOST) setSpreadingFactor();
-        kiss_indicate_spreadingfactor();
+        #if HAS_LIVE_CONFIG
+        if (op_mode == MODE_TNC) { live_config_radio(LIVE_SF, sf); } else
+        #endif
+        {
+          lora_sf = sf;
+          if (op_mode == MODE_HOST) setSpreadingFactor();
+          kiss_indicate_spreadingfactor();
+        }
       }
     } else if (command == CMD_CR) {
       if (sbyte == 0xFF) {
@@ -1613,9 +2118,14 @@ void serial_callback(uint8_t sbyte) {
         if (cr < 5) cr = 5;
         if (cr > 8) cr = 8;
 
-        lora_cr = cr;
-        if (op_mode == MODE_HOST) setCodingRate();
-        kiss_indicate_codingrate();
+        #if HAS_LIVE_CONFIG
+        if (op_mode == MODE_TNC) { live_config_radio(LIVE_CR, cr); } else
+        #endif
+        {
+          lora_cr = cr;
+          if (op_mode == MODE_HOST) setCodingRate();
+          kiss_indicate_codingrate();
+        }
       }
     } else if (command == CMD_IMPLICIT) {
       set_implicit_length(sbyte);
@@ -1626,6 +2136,7 @@ void serial_callback(uint8_t sbyte) {
         cable_state   = CABLE_STATE_DISCONNECTED;
         current_rssi  = -292;
         last_rssi     = -292;
+        last_rssi_at  = 0;
         last_rssi_raw = 0x00;
         last_snr_raw  = 0x80;
       }
@@ -1749,6 +2260,46 @@ void serial_callback(uint8_t sbyte) {
         }
     } else if (command == CMD_FW_VERSION) {
       kiss_indicate_version();
+    } else if (command == CMD_STAT_BOOT) {
+      kiss_indicate_boot_timeline();
+    #if HAS_LOOP_PROFILE
+    } else if (command == CMD_STAT_LOOP) {
+      kiss_indicate_loop_profile();
+    #endif
+    #if HAS_DEVICE_BENCHMARK
+    } else if (command == CMD_BENCHMARK) {
+      kiss_indicate_benchmark();
+    #endif
+    #if HAS_SAMPLING_PROFILER
+    } else if (command == CMD_PROFILE) {
+      kiss_profile_command(sbyte);
+    #endif
+    #if HAS_STATS_LOG
+    } else if (command == CMD_STAT_HIST) {
+      kiss_indicate_stats_history(sbyte);
+    #endif
+    #if HAS_TASK_STATS
+    } else if (command == CMD_STAT_TASKS) {
+      kiss_indicate_task_stats();
+    #endif
+    #if HAS_LIVE_CONFIG
+    } else if (command == CMD_BACKBONE) {
+      if (sbyte == FESC) { ESCAPE = true; }
+      else {
+        if (ESCAPE) {
+          if (sbyte == TFEND) sbyte = FEND;
+          if (sbyte == TFESC) sbyte = FESC;
+          ESCAPE = false;
+        }
+        if (frame_len < CMD_L) cmdbuf[frame_len++] = sbyte;
+      }
+
+      // Two port bytes, which may be 0x00 themselves, then the host list up
+      // to its NUL. A host list too long for cmdbuf is dropped.
+      if (sbyte == 0x00 && frame_len > 2 && cmdbuf[frame_len - 1] == 0x00) {
+        kiss_backbone_command(cmdbuf, frame_len);
+      }
+    #endif
     } else if (command == CMD_PLATFORM) {
       kiss_indicate_platform();
     } else if (command == CMD_MCU) {
@@ -1882,10 +2433,12 @@ void serial_callback(uint8_t sbyte) {
         }
 
         if (sbyte == 0x00) {
+          eeprom_batch_begin();
           for (uint8_t i = 0; i<33; i++) {
             if (i<frame_len && i<32) { eeprom_update(config_addr(ADDR_CONF_SSID+i), cmdbuf[i]); }
             else                     { eeprom_update(config_addr(ADDR_CONF_SSID+i), 0x00); }
           }
+          eeprom_batch_commit();
         }
       #endif
     } else if (command == CMD_WIFI_PSK) {
@@ -1901,10 +2454,12 @@ void serial_callback(uint8_t sbyte) {
         }
 
         if (sbyte == 0x00) {
+          eeprom_batch_begin();
           for (uint8_t i = 0; i<33; i++) {
             if (i<frame_len && i<32) { eeprom_update(config_addr(ADDR_CONF_PSK+i), cmdbuf[i]); }
             else                     { eeprom_update(config_addr(ADDR_CONF_PSK+i), 0x00); }
           }
+          eeprom_batch_commit();
         }
       #endif
     } else if (command == CMD_WIFI_IP) {
@@ -1919,7 +2474,11 @@ void serial_callback(uint8_t sbyte) {
           if (frame_len < CMD_L) cmdbuf[frame_len++] = sbyte;
         }
 
-        if (frame_len == 4) { for (uint8_t i = 0; i<4; i++) { eeprom_update(config_addr(ADDR_CONF_IP+i), cmdbuf[i]); } }
+        if (frame_len == 4) {
+          eeprom_batch_begin();
+          for (uint8_t i = 0; i<4; i++) { eeprom_update(config_addr(ADDR_CONF_IP+i), cmdbuf[i]); }
+          eeprom_batch_commit();
+        }
       #endif
     } else if (command == CMD_WIFI_NM) {
       #if HAS_WIFI
@@ -1933,7 +2492,11 @@ void serial_callback(uint8_t sbyte) {
           if (frame_len < CMD_L) cmdbuf[frame_len++] = sbyte;
         }
 
-        if (frame_len == 4) { for (uint8_t i = 0; i<4; i++) { eeprom_update(config_addr(ADDR_CONF_NM+i), cmdbuf[i]); } }
+        if (frame_len == 4) {
+          eeprom_batch_begin();
+          for (uint8_t i = 0; i<4; i++) { eeprom_update(config_addr(ADDR_CONF_NM+i), cmdbuf[i]); }
+          eeprom_batch_commit();
+        }
       #endif
     } else if (command == CMD_BT_CTRL) {
       #if HAS_BLUETOOTH || HAS_BLE
@@ -2072,9 +2635,10 @@ bool medium_free() {
 bool noise_floor_sampled = false;
 int  noise_floor_sample  = 0;
 int  noise_floor_buffer[NOISE_FLOOR_SAMPLES] = {0};
+long noise_floor_sum     = 0;
 void update_noise_floor() {
   #if MCU_VARIANT == MCU_ESP32 || MCU_VARIANT == MCU_NRF52
-    if (!dcd) {
+    if (!dcd && lora_rssi_available()) {
       #if BOARD_MODEL != BOARD_HELTEC32_V4
       if (!noise_floor_sampled || current_rssi < noise_floor + CSMA_INFR_THRESHOLD_DB) {
       #else
@@ -2085,20 +2649,17 @@ void update_noise_floor() {
           // during LoRa LNA re-calibration
           if (current_rssi < noise_floor-LORA_LNA_GVT) { return; }
         #endif
-        bool sum_noise_floor = false;
+        // The window sum follows each sample in and out, so once the
+        // window has filled the floor tracks every new sample
+        noise_floor_sum += current_rssi - noise_floor_buffer[noise_floor_sample];
         noise_floor_buffer[noise_floor_sample] = current_rssi;
         noise_floor_sample = noise_floor_sample+1;
         if (noise_floor_sample >= NOISE_FLOOR_SAMPLES) {
           noise_floor_sample %= NOISE_FLOOR_SAMPLES;
           noise_floor_sampled = true;
-          sum_noise_floor = true;
         }
 
-        if (noise_floor_sampled && sum_noise_floor) {
-          noise_floor = 0;
-          for (int ni = 0; ni < NOISE_FLOOR_SAMPLES; ni++) { noise_floor += noise_floor_buffer[ni]; }
-          noise_floor /= NOISE_FLOOR_SAMPLES;
-        }
+        if (noise_floor_sampled) { noise_floor = noise_floor_sum / NOISE_FLOOR_SAMPLES; }
       }
     }
   #endif
@@ -2116,7 +2677,8 @@ void update_modem_status() {
   #endif
 
   bool carrier_detected = LoRa->dcd();
-  current_rssi = LoRa->currentRssi();
+  bool rssi_sampled = lora_rssi_available();
+  if (rssi_sampled) { current_rssi = LoRa->currentRssi(); }
   last_status_update = millis();
 
   #if MCU_VARIANT == MCU_ESP32
@@ -2131,6 +2693,7 @@ void update_modem_status() {
   #else
     interference_detected = !carrier_detected && (current_rssi > (noise_floor+CSMA_INFR_THRESHOLD_DB));
   #endif
+  if (!rssi_sampled) { interference_detected = false; }
 
   if (interference_detected) { if (led_id_filter < LED_ID_TRIG) { led_id_filter += 1; } }
   else                       { if (led_id_filter > 0) {led_id_filter -= 1; } }
@@ -2159,10 +2722,17 @@ void update_modem_status() {
   }
 }
 
+// Channel samples are taken on a fixed schedule. Status reads from
+// medium_free() in between don't push the next sample back, and a loop
+// that fell behind resumes the schedule instead of bursting.
 void check_modem_status() {
-  if (millis()-last_status_update >= status_interval_ms) {
+  uint32_t now = millis();
+  if ((int32_t)(now - next_status_sample) >= 0) {
+    next_status_sample += status_interval_ms;
+    if ((int32_t)(now - next_status_sample) >= 0) { next_status_sample = now + status_interval_ms; }
     update_modem_status();
     update_noise_floor();
+    if (current_rssi > peak_rssi) { peak_rssi = current_rssi; }
 
     #if MCU_VARIANT == MCU_ESP32 || MCU_VARIANT == MCU_NRF52
       if (dcd) {
@@ -2183,8 +2753,11 @@ void check_modem_status() {
 
         int16_t cb = current_airtime_bin();
         uint16_t nb = cb+1; if (nb == AIRTIME_BINS) { nb = 0; }
-        if (total_channel_util > longterm_bins[cb]) longterm_bins[cb] = total_channel_util;
-        longterm_bins[nb] = 0.0;
+        if (total_channel_util > longterm_bins[cb]) {
+          longterm_bins_sum += total_channel_util - longterm_bins[cb];
+          longterm_bins[cb] = total_channel_util;
+        }
+        clear_longterm_bin(nb);
 
         update_airtime();
       }
@@ -2375,16 +2948,47 @@ void validate_status() {
       cw_band = (uint8_t)(new_cw_band);
       cw_min  = (cw_band-1) * CSMA_CW_PER_BAND_WINDOWS;
       cw_max  = (cw_band) * CSMA_CW_PER_BAND_WINDOWS - 1;
-      kiss_indicate_csma_stats();
     }
+
+    // p-persistence: the larger our own share of what is heard on the
+    // channel, the more often a free slot is left to the other nodes
+    float others = local_channel_util;
+    if (others*100 < CSMA_P_OTHERS_MIN_UTIL) { csma_p = 256; }
+    else {
+      float own_share = airtime/(airtime+others);
+      csma_p = 256 - (uint16_t)(own_share*(256-CSMA_P_MIN));
+    }
+
+    kiss_indicate_csma_stats();
   }
 #endif
 
+// The channel went busy while we were waiting for it. The first time
+// this happens in an attempt, the contention window is widened.
+void csma_defer() {
+  if (csma_deferred) { return; }
+  csma_deferred = true;
+  csma_band_deferrals[cw_band-1]++;
+  uint16_t adapt = cw_adapt*2 + 1;
+  cw_adapt = adapt > CSMA_CW_ADAPT_MAX ? CSMA_CW_ADAPT_MAX : adapt;
+}
+
+// An attempt ended in a transmission. Got through without contention,
+// the window shrinks back towards the band.
+void csma_transmitted() {
+  csma_band_tx[cw_band-1]++;
+  if (!csma_deferred) { cw_adapt /= 2; }
+  csma_deferred = false;
+}
+
+uint32_t aggr_hold_start = 0;
 void tx_queue_handler() {
-  if (!airtime_lock && queue_height > 0) {
+  if (lora_tx.active) { lora_tx_service(); return; }
+  if (!airtime_lock && tx_queue.height() > 0) {
     if (csma_cw == -1) {
-      csma_cw = random(cw_min, cw_max);
+      csma_cw = random(cw_min, cw_max + cw_adapt);
       cw_wait_target = csma_cw * csma_slot_ms;
+      aggr_hold_start = millis();
     }
 
     if (difs_wait_start == -1) {                                                  // DIFS wait not yet started
@@ -2392,7 +2996,8 @@ void tx_queue_handler() {
       else               { return; } }                                            // Medium not yet free, continue waiting
     
     else {                                                                        // We are waiting for DIFS or CW to pass
-      if (!medium_free()) { difs_wait_start = -1; cw_wait_start = -1; return; }   // Medium became occupied while in DIFS wait, restart waiting when free again
+      if (!medium_free()) { difs_wait_start = -1; cw_wait_start = -1;             // Medium became occupied while in DIFS wait, restart waiting when free again
+                            csma_defer(); return; }
       else {                                                                      // Medium is free, so continue waiting
         if (millis() < difs_wait_start+difs_ms) { return; }                       // DIFS has not yet passed, continue waiting
         else {                                                                    // DIFS has passed, and we are now in CW wait
@@ -2401,6 +3006,11 @@ void tx_queue_handler() {
             cw_wait_passed += millis()-cw_wait_start; cw_wait_start   = millis();
             if (cw_wait_passed < cw_wait_target) { return; }                      // Contention window wait time has not yet passed, continue waiting
             else {                                                                // Wait time has passed, flush the queue
+              if (random(256) >= csma_p) { cw_wait_target += csma_slot_ms; return; } // Not persisting this slot, wait one more
+              if (tx_queue.height() == 1 && tx_queue.bytes() <= LORA_AGGR_MAX_ITEM &&
+                  millis() - aggr_hold_start < LORA_AGGR_HOLD_MS &&
+                  lora_aggregation_active()) { return; }                          // Give a lone small packet a moment to be aggregated
+              csma_transmitted();
               bool should_flush = !lora_limit_rate && !lora_guard_rate;
               if (should_flush) { flush_queue(); } else { pop_queue(); }
               cw_wait_passed = 0; csma_cw = -1; difs_wait_start = -1; }
@@ -2414,12 +3024,21 @@ void tx_queue_handler() {
 void work_while_waiting() { loop(); }
 
 void loop() {
+  LOOP_PROFILE_BEGIN();
 
 #ifdef HAS_RNS
   // CBA
   if (reticulum) {
-	  reticulum.loop();
+    if (transport_task_running()) {
+      // Transport runs on its own task, just perform the writes it queued
+      transport_task_service_tx();
+    }
+    else {
+	    reticulum.loop();
+	    transport_publish_counts();
+    }
   }
+  LOOP_PROFILE_MARK(LOOP_TRANSPORT);
 
 #ifdef BOUNDARY_MODE
   // ── Clear bootloop counter once we reach a stable loop iteration ──────────
@@ -2430,26 +3049,33 @@ void loop() {
   }
 
   // ── Heap + WiFi watchdog ───────────────────────────────────────────────────
-  // Monitor heap and WiFi health. Auto-reboot on critical conditions:
-  //  1) Internal heap drops below 20KB (WiFi needs ~16KB for RX buffers)
+  // Monitor heap and WiFi health:
+  //  1) Low internal heap sheds caches and queues, rebooting only once
+  //     nothing is left to shed (MemoryPressure.h)
   //  2) WiFi down for >15s after having been connected (unrecoverable)
   {
     static bool     _wifi_watchdog_armed  = false;  // armed once WiFi first connects
     static uint32_t _wifi_lost_at         = 0;      // millis() when WiFi first lost
     static const uint32_t WIFI_GRACE_MS   = 15000;  // 15s grace before reboot
-    static const uint32_t HEAP_CRITICAL   = 20000;  // 20KB minimum internal heap
 
     // ── Heap pressure check (runs always) ─────────────────────────────────
+    // on the transport task instead while it owns Transport
+    #if HAS_MEMORY_PRESSURE
+      if (!transport_task_running()) memory_pressure_service();
+    #endif
     uint32_t free_heap = ESP.getFreeHeap();
-    if (free_heap < HEAP_CRITICAL) {
-      Serial.printf("\r\n[WATCHDOG] CRITICAL: Free heap %u < %u — REBOOTING\r\n",
-                    free_heap, HEAP_CRITICAL);
-      Serial.printf("[WATCHDOG] Min free: %u  Max alloc: %u\r\n",
-                    ESP.getMinFreeHeap(), ESP.getMaxAllocHeap());
-      Serial.flush();
-      delay(100);
-      ESP.restart();
-    }
+    #if !HAS_MEMORY_PRESSURE
+      if (free_heap < MEM_PRESSURE_REBOOT_BYTES) {
+        ringlog_printf("\r\n[WATCHDOG] CRITICAL: Free heap %u < %u — REBOOTING\r\n",
+                       free_heap, MEM_PRESSURE_REBOOT_BYTES);
+        ringlog_printf("[WATCHDOG] Min free: %u  Max alloc: %u  Modem pool misses: %u\r\n",
+                       ESP.getMinFreeHeap(), ESP.getMaxAllocHeap(), modem_pool_exhausted);
+        ringlog_flush();
+        RNS::Utilities::OS::sync_filesystem();
+        delay(100);
+        ESP.restart();
+      }
+    #endif
 
     bool wifi_now = wifi_is_connected();
 
@@ -2462,32 +3088,54 @@ void loop() {
     if (_wifi_watchdog_armed && !wifi_now) {
       if (_wifi_lost_at == 0) {
         _wifi_lost_at = millis();
-        Serial.printf("\r\n[WATCHDOG] WiFi lost at %lu ms (grace %lu ms)\r\n",
-                      _wifi_lost_at, WIFI_GRACE_MS);
-        Serial.printf("[WATCHDOG] WiFi.status()=%d heap=%u min_heap=%u\r\n",
-                      (int)WiFi.status(), free_heap, ESP.getMinFreeHeap());
-        Serial.flush();
+        ringlog_printf("\r\n[WATCHDOG] WiFi lost at %lu ms (grace %lu ms)\r\n",
+                       _wifi_lost_at, WIFI_GRACE_MS);
+        ringlog_printf("[WATCHDOG] WiFi.status()=%d heap=%u min_heap=%u\r\n",
+                       (int)WiFi.status(), free_heap, ESP.getMinFreeHeap());
       }
       // Check if grace period expired — unrecoverable, reboot
       if ((millis() - _wifi_lost_at) >= WIFI_GRACE_MS) {
-        Serial.printf("\r\n[WATCHDOG] WiFi down %lu ms — REBOOTING\r\n",
-                      millis() - _wifi_lost_at);
-        Serial.printf("[WATCHDOG] WiFi.status()=%d heap=%u\r\n",
-                      (int)WiFi.status(), ESP.getFreeHeap());
-        Serial.printf("[WATCHDOG] Bridged: L→T=%lu T→L=%lu\r\n",
-                      boundary_state.packets_bridged_lora_to_tcp,
-                      boundary_state.packets_bridged_tcp_to_lora);
-        Serial.flush();
+        ringlog_printf("\r\n[WATCHDOG] WiFi down %lu ms — REBOOTING\r\n",
+                       millis() - _wifi_lost_at);
+        ringlog_printf("[WATCHDOG] WiFi.status()=%d heap=%u\r\n",
+                       (int)WiFi.status(), ESP.getFreeHeap());
+        ringlog_printf("[WATCHDOG] Bridged: L→T=%lu T→L=%lu\r\n",
+                       boundary_state.packets_bridged_lora_to_tcp,
+                       boundary_state.packets_bridged_tcp_to_lora);
+        ringlog_flush();
+        RNS::Utilities::OS::sync_filesystem();
         delay(100);
         ESP.restart();
       }
     } else if (_wifi_watchdog_armed && wifi_now && _wifi_lost_at != 0) {
       // WiFi recovered within grace period
-      Serial.printf("[WATCHDOG] WiFi back after %lu ms\r\n", millis() - _wifi_lost_at);
+      ringlog_printf("[WATCHDOG] WiFi back after %lu ms\r\n", millis() - _wifi_lost_at);
       _wifi_lost_at = 0;
     }
   }
 
+  // Periodic per-subsystem memory report (serial + CMD_STAT_MEM)
+  memory_report_service();
+  #if HAS_TASK_STATS
+    task_stats_service();
+  #endif
+  #if HAS_STATS_LOG
+    stats_log_service();
+  #endif
+  #if HAS_LIVE_CONFIG
+    // Held announces go again once the radio runs on its new settings
+    if (live_config_service() && lora_interface_ptr) { lora_interface_ptr->tx_released(); }
+  #endif
+
+  #if HAS_METRICS
+    // Prometheus scrapes on the station address
+    metrics_service();
+  #endif
+  #if HAS_STATUS_SERVER
+    status_server_service();
+  #endif
+  LOOP_PROFILE_MARK(LOOP_WATCHDOG);
+
   // Boundary Mode: poll TCP interfaces for incoming data
   if (boundary_state.wifi_enabled) {
     // Start TCP interfaces if WiFi just connected and not yet started
@@ -2500,6 +3148,10 @@ void loop() {
         local_tcp_interface_ptr->start();
         Serial.println("[Boundary] WiFi connected, local TCP server started");
       }
+      if (local_udp_interface_ptr && !local_udp_interface_ptr->isStarted() &&
+          local_udp_interface_ptr->start()) {
+        Serial.println("[Boundary] WiFi connected, local UDP interface started");
+      }
     }
     if (tcp_interface_ptr) {
       tcp_interface_ptr->loop();
@@ -2507,13 +3159,31 @@ void loop() {
     if (local_tcp_interface_ptr) {
       local_tcp_interface_ptr->loop();
     }
+    if (local_udp_interface_ptr) {
+      local_udp_interface_ptr->loop();
+    }
     boundary_state.tcp_connected    = (tcp_interface_ptr && tcp_interface_ptr->isConnected());
-    boundary_state.ap_tcp_connected  = (local_tcp_interface_ptr && local_tcp_interface_ptr->isConnected());
+    boundary_state.ap_tcp_connected  = (local_tcp_interface_ptr && local_tcp_interface_ptr->isConnected()) ||
+                                       (local_udp_interface_ptr && local_udp_interface_ptr->isConnected());
     boundary_state.wifi_connected    = wifi_is_connected();
   }
+  LOOP_PROFILE_MARK(LOOP_TCP);
+#if BOUNDARY_ESPNOW
+  if (espnow_interface_ptr) {
+    espnow_interface_ptr->loop();
+  }
+  LOOP_PROFILE_MARK(LOOP_ESPNOW);
+#endif
+
+#endif
 
 #endif
 
+#if defined(HAS_RNS) && HAS_LORA2
+  if (lora2_interface_ptr) {
+    lora2_interface_ptr->loop();
+  }
+  LOOP_PROFILE_MARK(LOOP_LORA2);
 #endif
 
   if (radio_online) {
@@ -2525,14 +3195,20 @@ void loop() {
       if(modem_packet_queue && xQueueReceive(modem_packet_queue, &modem_packet, 0) == pdTRUE && modem_packet) {
         host_write_len = modem_packet->len;
         last_rssi      = modem_packet->rssi;
+        last_rssi_at   = millis();
         last_snr_raw   = modem_packet->snr_raw;
-        memcpy(&pbuf, modem_packet->data, modem_packet->len);
-        free(modem_packet);
-        modem_packet = NULL;
+        #if HAS_METRICS
+          metric_lora_rx_frames.inc();
+          metric_lora_rx_rssi.observe(last_rssi);
+        #endif
 
+        serial_batch_begin();
         kiss_indicate_stat_rssi();
         kiss_indicate_stat_snr();
-        kiss_write_packet();
+        kiss_write_modem_packet(modem_packet);
+        serial_batch_end();
+        modem_packet_release(modem_packet);
+        modem_packet = NULL;
       }
 
       airtime_lock = false;
@@ -2542,18 +3218,18 @@ void loop() {
     #elif MCU_VARIANT == MCU_NRF52
       modem_packet_t *modem_packet = NULL;
       if(modem_packet_queue && xQueueReceive(modem_packet_queue, &modem_packet, 0) == pdTRUE && modem_packet) {
-        memcpy(&pbuf, modem_packet->data, modem_packet->len);
         host_write_len = modem_packet->len;
-        free(modem_packet);
-        modem_packet = NULL;
+        last_rssi      = modem_packet->rssi;
+        last_rssi_at   = millis();
+        last_snr_raw   = modem_packet->snr_raw;
 
-        portENTER_CRITICAL();
-        last_rssi = LoRa->packetRssi();
-        last_snr_raw = LoRa->packetSnrRaw();
-        portEXIT_CRITICAL();
+        serial_batch_begin();
         kiss_indicate_stat_rssi();
         kiss_indicate_stat_snr();
-        kiss_write_packet();
+        kiss_write_modem_packet(modem_packet);
+        serial_batch_end();
+        modem_packet_release(modem_packet);
+        modem_packet = NULL;
       }
 
       airtime_lock = false;
@@ -2563,7 +3239,8 @@ void loop() {
     #endif
 
     tx_queue_handler();
-    check_modem_status();
+    // Channel sampling is meaningless while our own packet is on air
+    if (!lora_tx_active()) { check_modem_status(); }
   
   } else {
     if (hw_ready) {
@@ -2580,17 +3257,22 @@ void loop() {
       stopRadio();
     }
   }
+  LOOP_PROFILE_MARK(LOOP_RADIO);
 
-  #if MCU_VARIANT == MCU_ESP32 || MCU_VARIANT == MCU_NRF52
+  #if MCU_VARIANT == MCU_ESP32
+      buffer_serial();
+  #elif MCU_VARIANT == MCU_NRF52
       buffer_serial();
       if (!fifo_isempty(&serialFIFO)) serial_poll();
   #else
     if (!fifo_isempty_locked(&serialFIFO)) serial_poll();
   #endif
+  LOOP_PROFILE_MARK(LOOP_SERIAL);
 
   #if HAS_DISPLAY
     if (disp_ready && !display_updating) update_display();
   #endif
+  LOOP_PROFILE_MARK(LOOP_DISPLAY);
 
   // LED solid when operational on V3/V4 boards (yield to fast blink during white screen)
   #if BOARD_MODEL == BOARD_HELTEC32_V4 || BOARD_MODEL == BOARD_HELTEC32_V3
@@ -2614,6 +3296,8 @@ void loop() {
   #if HAS_INPUT
     input_read();
   #endif
+  LOOP_PROFILE_MARK(LOOP_PERIPHERALS);
+  LOOP_PROFILE_END();
 
   // Feed WDT
 #if MCU_VARIANT == MCU_ESP32
@@ -2633,10 +3317,56 @@ void loop() {
       kiss_indicate_error(ERROR_MEMORY_LOW); memory_low = false;
     #endif
   }
+
+  #if defined(BOUNDARY_MODE) && BOUNDARY_LIGHT_SLEEP && MODEM == SX1262 && !HAS_LORA2
+    light_sleep_service();
+  #endif
 }
 
+#if defined(BOUNDARY_MODE) && BOUNDARY_LIGHT_SLEEP && MODEM == SX1262 && !HAS_LORA2
+// LoRa-only repeater: sleep the CPU while nothing is pending. The modem
+// keeps receiving on its own and DIO1 rising on RX done wakes us, so the
+// packet is read out as soon as the CPU is back. With LORA_RX_DUTY_CYCLE
+// the modem sleeps as well and DIO1 also rises on a detected preamble.
+void light_sleep_service() {
+  static uint32_t idle_since = 0;
+  bool idle = !boundary_state.wifi_enabled && radio_online &&
+              !lora_tx_active() && tx_queue.height() == 0 &&
+              uxQueueMessagesWaiting(modem_packet_queue) == 0 &&
+              transport_task_idle() && Serial.available() == 0 &&
+              digitalRead(pin_dio) == LOW;
+  if (!idle) { idle_since = 0; return; }
+  if (idle_since == 0) { idle_since = millis(); return; }
+  if (millis() - idle_since < BOUNDARY_LIGHT_SLEEP_IDLE_MS) return;
+
+  // The edge interrupt is swapped for a level wakeup while asleep, leaving
+  // it enabled would make the level trigger fire continuously on wake
+  gpio_intr_disable((gpio_num_t)pin_dio);
+  gpio_wakeup_enable((gpio_num_t)pin_dio, GPIO_INTR_HIGH_LEVEL);
+  #if HAS_INPUT
+    gpio_wakeup_enable((gpio_num_t)pin_btn_usr1, GPIO_INTR_LOW_LEVEL);
+  #endif
+  esp_sleep_enable_gpio_wakeup();
+  esp_sleep_enable_timer_wakeup(BOUNDARY_LIGHT_SLEEP_MAX_MS * 1000ULL);
+
+  esp_light_sleep_start();
+
+  gpio_wakeup_disable((gpio_num_t)pin_dio);
+  #if HAS_INPUT
+    gpio_wakeup_disable((gpio_num_t)pin_btn_usr1);
+  #endif
+  gpio_set_intr_type((gpio_num_t)pin_dio, GPIO_INTR_POSEDGE);
+  gpio_intr_enable((gpio_num_t)pin_dio);
+  LoRa->checkDio0();
+  idle_since = 0;
+}
+#endif
+
 void sleep_now() {
   #if HAS_SLEEP == true
+    #ifdef HAS_RNS
+      RNS::Utilities::OS::sync_filesystem();
+    #endif
     stopRadio(); // TODO: Check this on all platforms
     #if PLATFORM == PLATFORM_ESP32
       #if BOARD_MODEL == BOARD_T3S3 || BOARD_MODEL == BOARD_XIAO_S3
@@ -2698,6 +3428,7 @@ void button_event(uint8_t event, unsigned long duration) {
       if (duration > 5000) {
         Serial.println("[Boundary] Button hold >5s — rebooting into config mode");
         boundary_config_request = BOUNDARY_CONFIG_MAGIC;
+        RNS::Utilities::OS::sync_filesystem();
         delay(100);
         ESP.restart();
       } else if (duration > 700) {
@@ -2743,6 +3474,70 @@ void button_event(uint8_t event, unsigned long duration) {
   #endif
 }
 
+// Feeds a chunk of host input to the KISS state machine. Data frame payload is
+// copied into tbuf in runs up to the next FEND or FESC, only those and other
+// commands take the per-byte path through serial_callback().
+void serial_deframe(const uint8_t* buf, size_t len) {
+  size_t i = 0;
+  while (i < len) {
+    if (IN_FRAME && command == CMD_DATA && !ESCAPE) {
+      size_t run = 0;
+      while (i + run < len && buf[i + run] != FEND && buf[i + run] != FESC) { run++; }
+      if (run > 0) {
+        if (bt_state != BT_STATE_CONNECTED) { cable_state = CABLE_STATE_CONNECTED; }
+        // Bytes past the MTU are dropped, like serial_callback() does
+        size_t copy = (run < (size_t)(MTU - frame_len)) ? run : (size_t)(MTU - frame_len);
+        memcpy(tbuf + frame_len, buf + i, copy);
+        frame_len += copy;
+        i += run;
+      }
+      if (i < len) { serial_callback(buf[i++]); }
+    } else {
+      serial_callback(buf[i++]);
+    }
+  }
+}
+
+#if MCU_VARIANT == MCU_ESP32
+// Reads what is waiting on the active host connection, up to len bytes
+size_t serial_read_bulk(uint8_t* buf, size_t len) {
+  int available;
+  #if HAS_BLUETOOTH || HAS_BLE == true
+    if (bt_state == BT_STATE_CONNECTED) {
+      available = SerialBT.available();
+      if (available <= 0) { return 0; }
+      return SerialBT.readBytes(buf, ((size_t)available < len) ? (size_t)available : len);
+    }
+  #endif
+  #if HAS_WIFI
+    if (wr_state >= WR_STATE_ON && wifi_host_is_connected()) {
+      if (!wifi_remote_available()) { return 0; }
+      return wifi_remote_read(buf, len);
+    }
+  #endif
+  available = Serial.available();
+  if (available <= 0) { return 0; }
+  return Serial.readBytes(buf, ((size_t)available < len) ? (size_t)available : len);
+}
+
+void buffer_serial() {
+  if (!serial_buffering) {
+    serial_buffering = true;
+
+    // Full chunks straight from the driver ring, bounded per pass so a
+    // flooding host can't starve the rest of the loop
+    uint8_t chunk[SERIAL_READ_CHUNK];
+    for (uint8_t c = 0; c < SERIAL_READ_MAX_CHUNKS; c++) {
+      size_t len = serial_read_bulk(chunk, sizeof(chunk));
+      if (len == 0) { break; }
+      serial_deframe(chunk, len);
+      if (len < sizeof(chunk)) { break; }
+    }
+
+    serial_buffering = false;
+  }
+}
+#else
 volatile bool serial_polling = false;
 void serial_poll() {
   serial_polling = true;
@@ -2806,6 +3601,7 @@ void buffer_serial() {
     serial_buffering = false;
   }
 }
+#endif
 
 void serial_interrupt_init() {
   #if MCU_VARIANT == MCU_1284P
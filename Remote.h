@@ -75,13 +75,65 @@ void wifi_remote_start_ap() {
   wifi_initialized = true;
 }
 
+#ifdef BOUNDARY_MODE
+// Fast reconnect: the access point of the last good association is kept
+// in RTC memory, which survives the WiFi and heap watchdog reboots. The
+// next association goes straight to that BSSID and channel without a
+// scan; addressing still comes from DHCP, so a lease that has moved on
+// is never pinned as a static address. If it has not connected within
+// WR_FAST_CONNECT_TIMEOUT_MS the cache is dropped and a normal scan
+// follows.
+#define WR_FAST_CACHE_MAGIC        0x57464332
+#define WR_FAST_CONNECT_TIMEOUT_MS 4000
+
+typedef struct {
+  uint32_t magic;
+  char     ssid[33];
+  uint8_t  bssid[6];
+  uint8_t  channel;
+  uint32_t check;
+} wr_fast_cache_t;
+RTC_NOINIT_ATTR wr_fast_cache_t wr_fast_cache;
+bool wr_fast_attempt = false;
+bool wr_fast_stored = false;
+
+uint32_t wr_fast_cache_check() {
+  // FNV-1a over everything before the check field
+  const uint8_t *p = (const uint8_t*)&wr_fast_cache;
+  uint32_t h = 2166136261UL;
+  for (size_t i = 0; i < offsetof(wr_fast_cache_t, check); i++) { h = (h ^ p[i]) * 16777619UL; }
+  return h;
+}
+
+bool wr_fast_cache_valid() {
+  return wr_fast_cache.magic == WR_FAST_CACHE_MAGIC &&
+         wr_fast_cache.check == wr_fast_cache_check() &&
+         wr_fast_cache.channel >= 1 && wr_fast_cache.channel <= 14 &&
+         strncmp(wr_fast_cache.ssid, wr_ssid, sizeof(wr_fast_cache.ssid)) == 0;
+}
+
+void wr_fast_cache_clear() { wr_fast_cache.magic = 0; }
+
+void wr_fast_cache_store() {
+  const uint8_t *bssid = WiFi.BSSID();
+  if (bssid == NULL) return;
+  memcpy(wr_fast_cache.ssid, wr_ssid, sizeof(wr_fast_cache.ssid));
+  memcpy(wr_fast_cache.bssid, bssid, sizeof(wr_fast_cache.bssid));
+  wr_fast_cache.channel = WiFi.channel();
+  wr_fast_cache.magic   = WR_FAST_CACHE_MAGIC;
+  wr_fast_cache.check   = wr_fast_cache_check();
+}
+#endif
+
 void wifi_remote_start_sta() {
   WiFi.mode(WIFI_STA);
 
 #ifdef BOUNDARY_MODE
   // Boundary mode does not expose static STA addressing in its config flow.
-  // Always return the station interface to DHCP so stale legacy EEPROM data
+  // Return the station interface to DHCP, so stale legacy EEPROM data
   // cannot pin the node to an unintended address.
+  wr_fast_attempt = wr_ssid[0] != 0x00 && wr_fast_cache_valid();
+  wr_fast_stored = false;
   WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
 #else
 
@@ -107,6 +159,12 @@ void wifi_remote_start_sta() {
 #endif
 
   delay(100);
+#ifdef BOUNDARY_MODE
+  if (wr_fast_attempt) {
+    wifi_dbg("Reconnecting to cached access point on channel "+String(wr_fast_cache.channel));
+    WiFi.begin(wr_ssid, wr_psk[0] != 0x00 ? wr_psk : NULL, wr_fast_cache.channel, wr_fast_cache.bssid);
+  } else
+#endif
   if (wr_ssid[0] != 0x00) {
     if (wr_psk[0] != 0x00) { WiFi.begin(wr_ssid, wr_psk); }
     else                   { WiFi.begin(wr_ssid); }
@@ -189,6 +247,10 @@ bool wifi_remote_available() {
     else {
       // wifi_dbg("Client connected"); // TODO: Remove debug
       connection = client;
+      // Host output is written a whole KISS frame (or batch of frames) at
+      // a time, so there is nothing for Nagle to coalesce; without this a
+      // frame can wait for the ACK of the previous one
+      connection.setNoDelay(true);
       wr_state = WR_STATE_CONNECTED;
       wr_last_read = millis();
       if (connection.available()) { return true; }
@@ -206,12 +268,50 @@ uint8_t wifi_remote_read() {
   }
 }
 
+// Copies out of the client's receive buffer, which is refilled with one
+// recv() of up to a segment, so a frame costs one socket call, not one
+// per byte
+size_t wifi_remote_read(uint8_t* buf, size_t len) {
+  if (!connection) { return 0; }
+  int available = connection.available();
+  if (available <= 0) { return 0; }
+  int received = connection.read(buf, ((size_t)available < len) ? (size_t)available : len);
+  if (received > 0) { wr_last_read = millis(); return (size_t)received; }
+  return 0;
+}
+
 void wifi_remote_write(uint8_t byte) { if (connection) { connection.write(byte); } }
 
+// Called with whole frames by serial_write_frame(). WiFiClient retries
+// until everything is queued, so a short write means the socket failed
+// or the host stopped reading; it is dropped so the host can reconnect.
+void wifi_remote_write(const uint8_t* buf, size_t len) {
+  if (!connection) { return; }
+  if (connection.write(buf, len) != len) {
+    wifi_remote_close_all();
+    host_disconnected();
+  }
+}
+
 void wifi_update_status() {
   wr_wifi_status = WiFi.status();
   if (wr_wifi_status == WL_CONNECTED) { wr_device_ip = WiFi.localIP(); }
   if (wifi_mode == WR_WIFI_AP && wifi_initialized) { wr_device_ip = WiFi.softAPIP(); wr_wifi_status = WL_CONNECTED; }
+#ifdef BOUNDARY_MODE
+  if (wifi_mode == WR_WIFI_STA && wr_wifi_status == WL_CONNECTED && !wr_fast_stored) {
+    wr_fast_cache_store();
+    wr_fast_stored = true;
+  }
+  if (wifi_init_ran && wifi_mode == WR_WIFI_STA && wr_wifi_status != WL_CONNECTED && wr_fast_attempt) {
+    if (millis()-wr_last_connect_try >= WR_FAST_CONNECT_TIMEOUT_MS) {
+      // Access point moved, do a full scan instead
+      wifi_dbg("Cached access point not reachable, scanning");
+      wr_fast_cache_clear();
+      wifi_remote_init();
+      return;
+    }
+  }
+#endif
   if (wifi_init_ran && wifi_mode == WR_WIFI_STA && wr_wifi_status != WL_CONNECTED) {
     if (millis()-wr_last_connect_try >= WR_RECONNECT_INTERVAL_MS) { wifi_remote_init(); }
   }
@@ -0,0 +1,591 @@
+// Copyright (C) 2026, Boundary Mode Extension
+// Based on microReticulum_Firmware by Mark Qvist
+//
+// RingLog.h — Binary log ring with a deferred drain task.
+//
+// Log calls no longer format or write anything on the caller's task.
+// RNS log lines (through on_log) and the firmware's own printf style
+// lines are stored as compact records in a byte ring and return; a low
+// priority task formats the records and writes them out, so a busy
+// serial port or SD card no longer stalls the packet path. A printf
+// record holds only the format string's address and its arguments,
+// %s arguments copied up to RINGLOG_STRING_MAX bytes:
+//
+//   len(2) kind(1) level(1) ms(4) { format(4) args } | text
+//
+// padded to 8 bytes. When the ring is full the oldest records are
+// overwritten; records lost before they were drained are reported by
+// the drain task. Sinks:
+//
+//   Serial    always, as before
+//   SD card   appended to /logfile.txt (HAS_SDCARD builds)
+//   TCP       port RINGLOG_TCP_PORT on the WiFi station address, one
+//             client at a time:  nc 10.0.0.42 7635
+//
+// The ring lives in RTC memory, which survives a panic or watchdog
+// reset. After such a reset ringlog_begin() prints the records still in
+// the ring, the last lines before the crash, ahead of the new boot's
+// output. Format records from a different firmware image cannot be
+// decoded and are shown as such.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#ifndef RING_LOG_H
+#define RING_LOG_H
+
+// Set to 0 to write log lines synchronously as before
+#ifndef RING_LOG
+#if MCU_VARIANT == MCU_ESP32 && defined(HAS_RNS)
+#define RING_LOG 1
+#else
+#define RING_LOG 0
+#endif
+#endif
+
+#if RING_LOG
+
+#define HAS_RING_LOG true
+
+#include <WiFi.h>
+#include <Log.h>
+#include <Utilities/OS.h>
+#include <esp_ota_ops.h>
+#include <stdarg.h>
+#include <stddef.h>
+#ifdef HAS_SDCARD
+#include <SD.h>
+#endif
+
+// ─── Log Configuration ───────────────────────────────────────────────────────
+#define RINGLOG_SIZE           4096      // ring bytes in RTC memory, power of two
+#define RINGLOG_RECORD_MAX     256       // header included
+#define RINGLOG_STRING_MAX     96        // bytes kept of each %s argument
+#define RINGLOG_LINE_MAX       384       // formatted line, longer ones are cut
+#define RINGLOG_TCP_PORT       7635
+#define RINGLOG_FILE           "/logfile.txt"
+#define RINGLOG_TASK_STACK     4096
+#define RINGLOG_TASK_PRIORITY  0         // below loopTask and the transport task
+#define RINGLOG_TASK_IDLE_MS   20
+#define RINGLOG_FLUSH_WAIT_MS  1000
+#define RINGLOG_MAGIC          0x52474C31
+
+#define RINGLOG_RAW            0         // level of printf lines, written as is
+#define RINGLOG_KIND_TEXT      0
+#define RINGLOG_KIND_FORMAT    1
+#define RINGLOG_KIND_PAD       2         // fills the end of the ring, skipped
+
+struct RingLogHeader {
+    uint16_t len;                        // whole record, header and padding included
+    uint8_t  kind;
+    uint8_t  level;
+    uint32_t ms;                         // OS::ltime() when logged
+};
+
+// Positions are free running byte counts, taken modulo RINGLOG_SIZE.
+// tail <= drained <= head at all times.
+struct RingLogState {
+    uint32_t magic;
+    uint32_t image;                      // firmware the format addresses belong to
+    uint32_t head;                       // next record written
+    uint32_t tail;                       // oldest record kept
+    uint32_t drained;                    // next record for the sinks
+    uint32_t lost;                       // overwritten before they were drained
+    uint8_t  data[RINGLOG_SIZE];
+};
+
+RTC_NOINIT_ATTR static RingLogState ringlog;
+
+static portMUX_TYPE      ringlog_mux = portMUX_INITIALIZER_UNLOCKED;
+static SemaphoreHandle_t ringlog_drain_lock = nullptr;
+static TaskHandle_t      ringlog_task_handle = nullptr;
+static volatile bool     ringlog_ready = false;
+static uint32_t          ringlog_boot_mark = 0;     // head at boot
+static bool              ringlog_prior_image = false;
+static WiFiServer*       ringlog_server = nullptr;
+static WiFiClient        ringlog_client;
+
+// ─── Ring ────────────────────────────────────────────────────────────────────
+// The ring survives resets, so a length read back from it is checked
+// before it is used: at least a header, at most a record, a multiple of
+// 8, not wrapping and not past head. A pad record is always shorter
+// than a record.
+static inline bool ringlog_len_ok(const RingLogHeader& header, uint32_t position) {
+    return header.len >= sizeof(RingLogHeader) && header.len <= RINGLOG_RECORD_MAX &&
+           (header.len & 7) == 0 && header.len <= ringlog.head - position &&
+           position % RINGLOG_SIZE + header.len <= RINGLOG_SIZE;
+}
+
+// Called with ringlog_mux held, when a length is found corrupt
+static void ringlog_reset_ring() {
+    ringlog.tail = ringlog.head;
+    ringlog.drained = ringlog.head;
+}
+
+// Called with ringlog_mux held. Drops the oldest records until need bytes
+// fit behind head.
+static void ringlog_make_room(uint32_t need) {
+    while (ringlog.head + need - ringlog.tail > RINGLOG_SIZE) {
+        RingLogHeader oldest;
+        memcpy(&oldest, &ringlog.data[ringlog.tail % RINGLOG_SIZE], sizeof(oldest));
+        if (!ringlog_len_ok(oldest, ringlog.tail)) { ringlog_reset_ring(); break; }
+        if (ringlog.drained == ringlog.tail) {
+            ringlog.drained += oldest.len;
+            if (oldest.kind != RINGLOG_KIND_PAD) ringlog.lost++;
+        }
+        ringlog.tail += oldest.len;
+    }
+}
+
+// A record never wraps: the rest of the ring is padded out first
+static void ringlog_put(uint8_t kind, uint8_t level, const uint8_t* payload, size_t size) {
+    RingLogHeader header;
+    header.len = (sizeof(header) + size + 7) & ~7;
+    header.kind = kind;
+    header.level = level;
+    header.ms = (uint32_t)RNS::Utilities::OS::ltime();
+    portENTER_CRITICAL(&ringlog_mux);
+    uint32_t offset = ringlog.head % RINGLOG_SIZE;
+    if (offset + header.len > RINGLOG_SIZE) {
+        RingLogHeader pad = { (uint16_t)(RINGLOG_SIZE - offset), RINGLOG_KIND_PAD, 0, 0 };
+        ringlog_make_room(pad.len);
+        memcpy(&ringlog.data[offset], &pad, sizeof(pad));
+        ringlog.head += pad.len;
+        offset = 0;
+    }
+    ringlog_make_room(header.len);
+    memcpy(&ringlog.data[offset], &header, sizeof(header));
+    memcpy(&ringlog.data[offset + sizeof(header)], payload, size);
+    memset(&ringlog.data[offset + sizeof(header) + size], 0, header.len - sizeof(header) - size);
+    ringlog.head += header.len;
+    portEXIT_CRITICAL(&ringlog_mux);
+}
+
+// Copies out the record at drained and advances past it, pad records are
+// skipped. Returns the position it was at, or false when none is left.
+static bool ringlog_take(uint8_t* record, uint32_t& position) {
+    bool taken = false;
+    portENTER_CRITICAL(&ringlog_mux);
+    while (ringlog.drained != ringlog.head) {
+        RingLogHeader header;
+        memcpy(&header, &ringlog.data[ringlog.drained % RINGLOG_SIZE], sizeof(header));
+        if (!ringlog_len_ok(header, ringlog.drained)) { ringlog_reset_ring(); break; }
+        position = ringlog.drained;
+        ringlog.drained += header.len;
+        if (header.kind == RINGLOG_KIND_PAD) continue;
+        memcpy(record, &ringlog.data[position % RINGLOG_SIZE], header.len);
+        taken = true;
+        break;
+    }
+    portEXIT_CRITICAL(&ringlog_mux);
+    return taken;
+}
+
+// ─── Format Encoding ─────────────────────────────────────────────────────────
+// The format string is walked once when logging, to store the arguments,
+// and again when draining, to print them one conversion at a time.
+struct RingLogSpec {
+    const char* length_at;               // length modifier, or conversion if none
+    uint8_t     stars;                   // '*' width and precision arguments
+    char        length;                  // 0, 'h', 'l', 'q' (ll, j), 'z', 't', 'L'
+    char        conv;
+};
+
+// p points just past the '%', returns the end of the conversion
+static const char* ringlog_parse_spec(const char* p, RingLogSpec& spec) {
+    spec.stars = 0;
+    spec.length = 0;
+    while (*p && strchr("-+ #0", *p)) p++;
+    if (*p == '*') { spec.stars++; p++; } else while (isdigit((unsigned char)*p)) p++;
+    if (*p == '.') {
+        p++;
+        if (*p == '*') { spec.stars++; p++; } else while (isdigit((unsigned char)*p)) p++;
+    }
+    spec.length_at = p;
+    if (*p == 'h') { spec.length = 'h'; p++; if (*p == 'h') p++; }
+    else if (*p == 'l') { p++; if (*p == 'l') { spec.length = 'q'; p++; } else spec.length = 'l'; }
+    else if (*p == 'j') { spec.length = 'q'; p++; }
+    else if (*p == 'z' || *p == 't' || *p == 'L') spec.length = *p++;
+    spec.conv = *p;
+    if (*p) p++;
+    return p;
+}
+
+static inline bool ringlog_is_int(char conv) { return conv && strchr("diuoxXc", conv); }
+static inline bool ringlog_is_float(char conv) { return conv && strchr("fFeEgGaA", conv); }
+
+static inline size_t ringlog_int_size(char length) {
+    switch (length) {
+        case 'q': return sizeof(long long);
+        case 'l': return sizeof(long);
+        case 'z': return sizeof(size_t);
+        case 't': return sizeof(ptrdiff_t);
+        default:  return sizeof(int);
+    }
+}
+
+// Stores the arguments fmt consumes, stops at the first conversion it
+// does not know or once out is full. Returns the bytes used.
+static size_t ringlog_encode(uint8_t* out, size_t cap, const char* fmt, va_list ap) {
+    size_t n = 0;
+    const char* p = fmt;
+    while (*p) {
+        if (*p++ != '%') continue;
+        if (*p == '%') { p++; continue; }
+        RingLogSpec spec;
+        p = ringlog_parse_spec(p, spec);
+        size_t need = spec.stars * sizeof(int);
+        if (ringlog_is_int(spec.conv)) need += ringlog_int_size(spec.length);
+        else if (ringlog_is_float(spec.conv)) need += sizeof(double);
+        else if (spec.conv == 'p') need += sizeof(void*);
+        else if (spec.conv == 's') need += 1;
+        else break;
+        if (n + need > cap) break;
+        for (uint8_t i = 0; i < spec.stars; i++) {
+            int star = va_arg(ap, int);
+            memcpy(out + n, &star, sizeof(star));
+            n += sizeof(star);
+        }
+        if (ringlog_is_int(spec.conv)) {
+            long long v;
+            switch (spec.length) {
+                case 'q': v = va_arg(ap, long long); break;
+                case 'l': v = va_arg(ap, long); break;
+                case 'z': v = va_arg(ap, size_t); break;
+                case 't': v = va_arg(ap, ptrdiff_t); break;
+                default:  v = va_arg(ap, int); break;
+            }
+            size_t size = ringlog_int_size(spec.length);
+            if (size == sizeof(int)) { int narrow = (int)v; memcpy(out + n, &narrow, size); }
+            else memcpy(out + n, &v, size);
+            n += size;
+        } else if (ringlog_is_float(spec.conv)) {
+            double v = (spec.length == 'L') ? (double)va_arg(ap, long double) : va_arg(ap, double);
+            memcpy(out + n, &v, sizeof(v));
+            n += sizeof(v);
+        } else if (spec.conv == 'p') {
+            void* v = va_arg(ap, void*);
+            memcpy(out + n, &v, sizeof(v));
+            n += sizeof(v);
+        } else {
+            const char* s = va_arg(ap, const char*);
+            if (!s) s = "(null)";
+            size_t len = strnlen(s, RINGLOG_STRING_MAX);
+            if (n + 1 + len > cap) len = cap - n - 1;
+            out[n++] = (uint8_t)len;
+            memcpy(out + n, s, len);
+            n += len;
+        }
+    }
+    return n;
+}
+
+template <typename T>
+static void ringlog_append(char* out, size_t cap, size_t& n, const char* spec, const int* stars, uint8_t count, T value) {
+    if (n + 1 >= cap) return;
+    int written;
+    if (count == 0) written = snprintf(out + n, cap - n, spec, value);
+    else if (count == 1) written = snprintf(out + n, cap - n, spec, stars[0], value);
+    else written = snprintf(out + n, cap - n, spec, stars[0], stars[1], value);
+    if (written > 0) n = std::min(n + (size_t)written, cap - 1);
+}
+
+// Prints fmt with the stored arguments. Text after the last argument
+// that could be stored is dropped.
+static size_t ringlog_decode(char* out, size_t cap, const char* fmt, const uint8_t* args, size_t size) {
+    size_t n = 0;
+    size_t used = 0;
+    const char* p = fmt;
+    while (*p && n + 1 < cap) {
+        if (*p != '%') { out[n++] = *p++; continue; }
+        const char* start = p++;
+        if (*p == '%') { out[n++] = '%'; p++; continue; }
+        RingLogSpec spec;
+        p = ringlog_parse_spec(p, spec);
+        // the conversion again, with ll for any integer and no L for floats
+        char format[24];
+        size_t prefix = spec.length_at - start;
+        if (prefix + 4 > sizeof(format)) break;
+        memcpy(format, start, prefix);
+        size_t f = prefix;
+        if (ringlog_is_int(spec.conv) && spec.length != 'h' && spec.conv != 'c') { format[f++] = 'l'; format[f++] = 'l'; }
+        else if (spec.length == 'h') { memcpy(format + f, spec.length_at, p - 1 - spec.length_at); f += p - 1 - spec.length_at; }
+        format[f++] = spec.conv;
+        format[f] = 0;
+
+        int stars[2] = { 0, 0 };
+        if (used + spec.stars * sizeof(int) > size) break;
+        for (uint8_t i = 0; i < spec.stars; i++) {
+            memcpy(&stars[i], args + used, sizeof(int));
+            used += sizeof(int);
+        }
+        if (ringlog_is_int(spec.conv)) {
+            size_t width = ringlog_int_size(spec.length);
+            if (used + width > size) break;
+            long long v;
+            if (width == sizeof(int)) {
+                int narrow;
+                memcpy(&narrow, args + used, sizeof(narrow));
+                bool is_signed = (spec.conv == 'd' || spec.conv == 'i');
+                v = is_signed ? (long long)narrow : (long long)(unsigned)narrow;
+            } else {
+                memcpy(&v, args + used, sizeof(v));
+            }
+            used += width;
+            if (spec.length == 'h' || spec.conv == 'c') ringlog_append(out, cap, n, format, stars, spec.stars, (int)v);
+            else ringlog_append(out, cap, n, format, stars, spec.stars, v);
+        } else if (ringlog_is_float(spec.conv)) {
+            double v;
+            if (used + sizeof(v) > size) break;
+            memcpy(&v, args + used, sizeof(v));
+            used += sizeof(v);
+            ringlog_append(out, cap, n, format, stars, spec.stars, v);
+        } else if (spec.conv == 'p') {
+            void* v;
+            if (used + sizeof(v) > size) break;
+            memcpy(&v, args + used, sizeof(v));
+            used += sizeof(v);
+            ringlog_append(out, cap, n, format, stars, spec.stars, v);
+        } else if (spec.conv == 's') {
+            if (used + 1 > size) break;
+            size_t len = args[used++];
+            if (used + len > size) break;
+            char text[RINGLOG_STRING_MAX + 1];
+            memcpy(text, args + used, len);
+            text[len] = 0;
+            used += len;
+            ringlog_append(out, cap, n, format, stars, spec.stars, (const char*)text);
+        } else {
+            break;
+        }
+    }
+    out[n] = 0;
+    return n;
+}
+
+// ─── Logging ─────────────────────────────────────────────────────────────────
+// Before ringlog_begin() the ring may hold anything, lines are written
+// straight to Serial until then
+
+// printf style line, written as is once drained
+static void ringlog_printf(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+static void ringlog_printf(const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    if (!ringlog_ready) {
+        char line[RINGLOG_LINE_MAX];
+        vsnprintf(line, sizeof(line), fmt, ap);
+        va_end(ap);
+        Serial.print(line);
+        return;
+    }
+    uint8_t payload[RINGLOG_RECORD_MAX - sizeof(RingLogHeader)];
+    memcpy(payload, &fmt, sizeof(fmt));
+    size_t size = sizeof(fmt) + ringlog_encode(payload + sizeof(fmt), sizeof(payload) - sizeof(fmt), fmt, ap);
+    va_end(ap);
+    ringlog_put(RINGLOG_KIND_FORMAT, RINGLOG_RAW, payload, size);
+}
+
+// An RNS log message, printed with time and level like on_log() did
+static void ringlog_text(RNS::LogLevel level, const char* msg) {
+    if (!ringlog_ready) {
+        Serial.printf("%s [%s] %s\n", RNS::getTimeString(), RNS::getLevelName(level), msg);
+        return;
+    }
+    size_t size = strnlen(msg, RINGLOG_RECORD_MAX - sizeof(RingLogHeader));
+    ringlog_put(RINGLOG_KIND_TEXT, (uint8_t)level, (const uint8_t*)msg, size);
+}
+
+// ─── Drain ───────────────────────────────────────────────────────────────────
+static size_t ringlog_format(char* line, size_t cap, const uint8_t* record, uint32_t position) {
+    RingLogHeader header;
+    memcpy(&header, record, sizeof(header));
+    const uint8_t* payload = record + sizeof(header);
+    size_t size = header.len - sizeof(header);
+    if (header.kind == RINGLOG_KIND_TEXT) {
+        // padding is zero bytes after the text
+        size = strnlen((const char*)payload, size);
+        uint32_t t = header.ms;
+        int n;
+        if (t < 86400000) n = snprintf(line, cap, "%02d:%02d:%02d.%03d [%s] ", (int)(t/3600000), (int)((t/60000)%60), (int)((t/1000)%60), (int)(t%1000), RNS::getLevelName((RNS::LogLevel)header.level));
+        else n = snprintf(line, cap, "%02d-%02d:%02d:%02d.%03d [%s] ", (int)(t/86400000), (int)((t/3600000)%24), (int)((t/60000)%60), (int)((t/1000)%60), (int)(t%1000), RNS::getLevelName((RNS::LogLevel)header.level));
+        size_t len = std::min((size_t)n, cap - 2);
+        size = std::min(size, cap - 2 - len);
+        memcpy(line + len, payload, size);
+        len += size;
+        line[len++] = '\n';
+        line[len] = 0;
+        return len;
+    }
+    if ((int32_t)(position - ringlog_boot_mark) < 0 && !ringlog_prior_image) {
+        return snprintf(line, cap, "[RingLog] (record from previous firmware)\r\n");
+    }
+    const char* fmt;
+    memcpy(&fmt, payload, sizeof(fmt));
+    return ringlog_decode(line, cap, fmt, payload + sizeof(fmt), size - sizeof(fmt));
+}
+
+// One client at a time, on the station address only like the metrics
+// endpoint; a new client is taken once the current one has gone
+static void ringlog_accept() {
+    if (WiFi.status() != WL_CONNECTED) {
+        if (ringlog_client) ringlog_client.stop();
+        return;
+    }
+    if (!ringlog_server) {
+        ringlog_server = new WiFiServer(RINGLOG_TCP_PORT, 1);
+        ringlog_server->begin();
+        ringlog_printf("[RingLog] Streaming on tcp://%s:%d\r\n", WiFi.localIP().toString().c_str(), RINGLOG_TCP_PORT);
+    }
+    if (ringlog_client && !ringlog_client.connected()) ringlog_client.stop();
+    if (ringlog_client) return;
+    ringlog_client = ringlog_server->available();
+    if (!ringlog_client) return;
+    if (ringlog_client.localIP() != WiFi.localIP()) {
+        ringlog_client.stop();
+        return;
+    }
+    ringlog_printf("[RingLog] Client %s connected\r\n", ringlog_client.remoteIP().toString().c_str());
+}
+
+// Formats and writes out everything logged so far, on the calling task
+static bool ringlog_drain() {
+    static uint32_t lost_reported = 0;
+    uint8_t record[RINGLOG_RECORD_MAX];
+    char line[RINGLOG_LINE_MAX];
+    uint32_t position;
+    bool wrote = false;
+#ifdef HAS_SDCARD
+    File file;
+#endif
+    while (ringlog_take(record, position)) {
+        if (ringlog.lost != lost_reported) {
+            int n = snprintf(line, sizeof(line), "[RingLog] %u records lost\r\n", (unsigned)(ringlog.lost - lost_reported));
+            lost_reported = ringlog.lost;
+            Serial.write((const uint8_t*)line, n);
+        }
+        size_t len = ringlog_format(line, sizeof(line), record, position);
+        Serial.write((const uint8_t*)line, len);
+        if (ringlog_client.connected() && ringlog_client.write((const uint8_t*)line, len) != len) {
+            ringlog_client.stop();
+        }
+#ifdef HAS_SDCARD
+        if (!wrote) file = SD.open(RINGLOG_FILE, FILE_APPEND);
+        if (file) file.write((const uint8_t*)line, len);
+#endif
+        wrote = true;
+    }
+#ifdef HAS_SDCARD
+    if (file) file.close();
+#endif
+    return wrote;
+}
+
+static void ringlog_task(void* param) {
+    while (true) {
+        ringlog_accept();
+        xSemaphoreTake(ringlog_drain_lock, portMAX_DELAY);
+        bool wrote = ringlog_drain();
+        xSemaphoreGive(ringlog_drain_lock);
+        if (!wrote) vTaskDelay(pdMS_TO_TICKS(RINGLOG_TASK_IDLE_MS));
+    }
+}
+
+// Writes out the pending records before returning, for the lines that
+// come right before a deliberate restart
+inline void ringlog_flush() {
+    if (ringlog_ready && xSemaphoreTake(ringlog_drain_lock, pdMS_TO_TICKS(RINGLOG_FLUSH_WAIT_MS)) == pdTRUE) {
+        ringlog_drain();
+        xSemaphoreGive(ringlog_drain_lock);
+    }
+    Serial.flush();
+}
+
+// ─── Boot ────────────────────────────────────────────────────────────────────
+inline uint32_t ringlog_image_id() {
+    uint32_t id;
+    memcpy(&id, esp_ota_get_app_description()->app_elf_sha256, sizeof(id));
+    return id;
+}
+
+inline const char* ringlog_reset_name(esp_reset_reason_t reason) {
+    switch (reason) {
+        case ESP_RST_PANIC:    return "panic";
+        case ESP_RST_INT_WDT:  return "interrupt watchdog";
+        case ESP_RST_TASK_WDT: return "task watchdog";
+        case ESP_RST_WDT:      return "watchdog";
+        case ESP_RST_BROWNOUT: return "brownout";
+        default:               return nullptr;
+    }
+}
+
+// Walks the records left in RTC memory from tail to head, checking each
+// length and that drained falls on a record boundary
+static bool ringlog_valid() {
+    if (ringlog.magic != RINGLOG_MAGIC) return false;
+    uint32_t used = ringlog.head - ringlog.tail;
+    if (used > RINGLOG_SIZE || ringlog.drained - ringlog.tail > used || (ringlog.tail & 7)) return false;
+    bool drained_found = ringlog.drained == ringlog.head;
+    for (uint32_t position = ringlog.tail; position != ringlog.head; ) {
+        if (position == ringlog.drained) drained_found = true;
+        RingLogHeader header;
+        memcpy(&header, &ringlog.data[position % RINGLOG_SIZE], sizeof(header));
+        if (!ringlog_len_ok(header, position)) return false;
+        position += header.len;
+    }
+    return drained_found;
+}
+
+// Prints every record still in the ring, straight to Serial
+static void ringlog_postmortem(const char* reason) {
+    uint8_t record[RINGLOG_RECORD_MAX];
+    char line[RINGLOG_LINE_MAX];
+    uint32_t position;
+    Serial.printf("\r\n[RingLog] Reset by %s, last log lines before it:\r\n", reason);
+    ringlog.drained = ringlog.tail;
+    while (ringlog_take(record, position)) {
+        Serial.write((const uint8_t*)line, ringlog_format(line, sizeof(line), record, position));
+    }
+    Serial.println("[RingLog] End of log before reset");
+}
+
+// Called from setup() once Serial is up, before anything logs through
+// the ring
+inline bool ringlog_begin() {
+    if (ringlog_task_handle != nullptr) return true;
+    uint32_t image = ringlog_image_id();
+    bool valid = ringlog_valid();
+    if (!valid) {
+        memset(&ringlog, 0, sizeof(ringlog));
+        ringlog.magic = RINGLOG_MAGIC;
+    }
+    ringlog_boot_mark = ringlog.head;
+    ringlog_prior_image = valid && ringlog.image == image;
+    ringlog.image = image;
+    const char* reason = ringlog_reset_name(esp_reset_reason());
+    if (valid && reason) ringlog_postmortem(reason);
+
+    ringlog_drain_lock = xSemaphoreCreateMutex();
+    if (!ringlog_drain_lock) return false;
+    ringlog_ready = true;
+    BaseType_t ok = xTaskCreatePinnedToCore(ringlog_task, "ringlog", RINGLOG_TASK_STACK, nullptr,
+                                            RINGLOG_TASK_PRIORITY, &ringlog_task_handle, ARDUINO_RUNNING_CORE);
+    if (ok != pdPASS) {
+        ringlog_ready = false;
+        ringlog_task_handle = nullptr;
+        Serial.println("[RingLog] Failed to create drain task");
+        return false;
+    }
+    return true;
+}
+
+#else
+
+#define ringlog_printf(...)  Serial.printf(__VA_ARGS__)
+#define ringlog_flush()      Serial.flush()
+
+#endif // RING_LOG
+
+#endif // RING_LOG_H
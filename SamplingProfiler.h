@@ -0,0 +1,203 @@
+// Copyright (C) 2026, Boundary Mode Extension
+// Based on microReticulum_Firmware by Mark Qvist
+//
+// SamplingProfiler.h — Statistical PC sampling on both cores.
+//
+// While running, a FreeRTOS tick hook on each core (1 kHz per core)
+// reads the program counter of the code the tick interrupted and counts
+// it into that core's histogram, keyed by address in PROF_BUCKET_BYTES
+// steps. The histograms are open addressed tables in internal RAM; a
+// sample that finds no free slot within PROF_PROBES is counted as lost.
+// Samples taken while the core's idle task ran are only counted.
+//
+// CMD_PROFILE takes one byte: 0x01 clears the histograms and starts
+// sampling, 0x00 stops, 0x02 dumps. Start and stop are answered with the
+// header only, a dump with one frame per core:
+//
+//   running(1) core(1) samples(4) idle(4) lost(4) bucket_bytes(2)
+//   entry_count(2) { address(4) count(4) } * entry_count
+//
+// all big-endian. "Python Module/rnode_profile.py" drives a run and resolves
+// the addresses against the firmware ELF with addr2line.
+//
+// Reading the interrupted PC relies on the Xtensa port saving the task's
+// exception frame at pxTopOfStack on interrupt entry, so the profiler is
+// only built for Xtensa targets (ESP32, ESP32-S3).
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#ifndef SAMPLING_PROFILER_H
+#define SAMPLING_PROFILER_H
+
+// Set to 0 to leave the profiler out of the build
+#ifndef SAMPLING_PROFILER
+#if MCU_VARIANT == MCU_ESP32 && CONFIG_IDF_TARGET_ARCH_XTENSA
+#define SAMPLING_PROFILER 1
+#else
+#define SAMPLING_PROFILER 0
+#endif
+#endif
+
+#if SAMPLING_PROFILER
+
+#define HAS_SAMPLING_PROFILER true
+
+#include <esp_freertos_hooks.h>
+#include <esp_heap_caps.h>
+
+// ─── Profiler Configuration ──────────────────────────────────────────────────
+#define PROF_CORES          2
+#define PROF_TABLE_BITS     9
+#define PROF_TABLE_SIZE     (1 << PROF_TABLE_BITS)     // buckets per core
+#define PROF_BUCKET_SHIFT   4
+#define PROF_BUCKET_BYTES   (1 << PROF_BUCKET_SHIFT)
+#define PROF_PROBES         8
+#define PROF_FRAME_PC       4       // offset of pc in XtExcFrame, after exit
+
+#define PROF_STOP           0x00
+#define PROF_START          0x01
+#define PROF_DUMP           0x02
+
+struct ProfileBucket {
+    uint32_t key;                   // address >> PROF_BUCKET_SHIFT, 0 when free
+    uint32_t count;
+};
+
+struct ProfileCore {
+    ProfileBucket* table;
+    volatile uint32_t samples;
+    volatile uint32_t idle;
+    volatile uint32_t lost;
+};
+
+static ProfileCore   prof_cores[PROF_CORES] = {};
+static volatile bool prof_running = false;
+static bool          prof_hooked = false;
+
+// ─── Sampling ────────────────────────────────────────────────────────────────
+// Runs in the tick interrupt, possibly while the flash cache is off, so
+// it and the tables stay in internal RAM
+static void IRAM_ATTR prof_sample(uint8_t core) {
+    if (!prof_running) return;
+    ProfileCore& prof = prof_cores[core];
+    prof.samples++;
+    TaskHandle_t task = xTaskGetCurrentTaskHandleForCPU(core);
+    if (task == nullptr) return;
+    if (task == xTaskGetIdleTaskHandleForCPU(core)) {
+        prof.idle++;
+        return;
+    }
+    // pxTopOfStack is the first member of the TCB and points at the
+    // interrupted task's exception frame
+    uint8_t* frame = *(uint8_t**)task;
+    uint32_t key = *(uint32_t*)(frame + PROF_FRAME_PC) >> PROF_BUCKET_SHIFT;
+    if (key == 0) return;
+    uint32_t slot = (key * 2654435761u) >> (32 - PROF_TABLE_BITS);
+    for (uint8_t probe = 0; probe < PROF_PROBES; probe++) {
+        ProfileBucket& bucket = prof.table[(slot + probe) & (PROF_TABLE_SIZE - 1)];
+        if (bucket.key == key) { bucket.count++; return; }
+        if (bucket.key == 0) { bucket.key = key; bucket.count = 1; return; }
+    }
+    prof.lost++;
+}
+
+static void IRAM_ATTR prof_tick_core0() { prof_sample(0); }
+static void IRAM_ATTR prof_tick_core1() { prof_sample(1); }
+
+// ─── Control ─────────────────────────────────────────────────────────────────
+inline bool profiler_start() {
+    prof_running = false;
+    for (uint8_t core = 0; core < PROF_CORES; core++) {
+        ProfileCore& prof = prof_cores[core];
+        if (!prof.table) {
+            prof.table = (ProfileBucket*)heap_caps_malloc(PROF_TABLE_SIZE * sizeof(ProfileBucket), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+            if (!prof.table) {
+                Serial.println("[Profile] No memory for histograms");
+                return false;
+            }
+        }
+        memset(prof.table, 0, PROF_TABLE_SIZE * sizeof(ProfileBucket));
+        prof.samples = 0;
+        prof.idle = 0;
+        prof.lost = 0;
+    }
+    if (!prof_hooked) {
+        if (esp_register_freertos_tick_hook_for_cpu(prof_tick_core0, 0) != ESP_OK ||
+            esp_register_freertos_tick_hook_for_cpu(prof_tick_core1, 1) != ESP_OK) {
+            esp_deregister_freertos_tick_hook_for_cpu(prof_tick_core0, 0);
+            Serial.println("[Profile] Cannot register tick hooks");
+            return false;
+        }
+        prof_hooked = true;
+    }
+    prof_running = true;
+    Serial.println("[Profile] Sampling started");
+    return true;
+}
+
+// The hooks stay registered, they return at once while stopped
+inline void profiler_stop() {
+    if (!prof_running) return;
+    prof_running = false;
+    uint32_t samples = prof_cores[0].samples + prof_cores[1].samples;
+    uint32_t idle = prof_cores[0].idle + prof_cores[1].idle;
+    Serial.printf("[Profile] Sampling stopped, %u samples, %u%% idle\r\n",
+                  (unsigned)samples, samples ? (unsigned)(idle * 100 / samples) : 0);
+}
+
+// ─── KISS ────────────────────────────────────────────────────────────────────
+inline void profile_write_u32(uint32_t v) {
+    escaped_serial_write(v >> 24);
+    escaped_serial_write(v >> 16);
+    escaped_serial_write(v >> 8);
+    escaped_serial_write(v);
+}
+
+inline void kiss_indicate_profile_core(uint8_t core, bool entries) {
+    const ProfileCore& prof = prof_cores[core];
+    uint16_t count = 0;
+    if (entries && prof.table) {
+        for (uint16_t i = 0; i < PROF_TABLE_SIZE; i++) if (prof.table[i].key) count++;
+    }
+    serial_write(FEND);
+    serial_write(CMD_PROFILE);
+    escaped_serial_write(prof_running ? 1 : 0);
+    escaped_serial_write(core);
+    profile_write_u32(prof.samples);
+    profile_write_u32(prof.idle);
+    profile_write_u32(prof.lost);
+    escaped_serial_write(PROF_BUCKET_BYTES >> 8);
+    escaped_serial_write(PROF_BUCKET_BYTES);
+    escaped_serial_write(count >> 8);
+    escaped_serial_write(count);
+    for (uint16_t i = 0; i < PROF_TABLE_SIZE && count > 0; i++) {
+        // a running profiler may add buckets meanwhile, only the ones
+        // counted above are sent
+        const ProfileBucket& bucket = prof.table[i];
+        if (!bucket.key) continue;
+        profile_write_u32(bucket.key << PROF_BUCKET_SHIFT);
+        profile_write_u32(bucket.count);
+        count--;
+    }
+    serial_write(FEND);
+}
+
+// Called from serial_callback() with the command's argument byte
+inline void kiss_profile_command(uint8_t arg) {
+    if (arg == PROF_START) {
+        profiler_start();
+        kiss_indicate_profile_core(0, false);
+    } else if (arg == PROF_STOP) {
+        profiler_stop();
+        kiss_indicate_profile_core(0, false);
+    } else if (arg == PROF_DUMP) {
+        for (uint8_t core = 0; core < PROF_CORES; core++) kiss_indicate_profile_core(core, true);
+    }
+}
+
+#endif // SAMPLING_PROFILER
+
+#endif // SAMPLING_PROFILER_H
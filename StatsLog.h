@@ -0,0 +1,416 @@
+// Copyright (C) 2026, Boundary Mode Extension
+// Based on microReticulum_Firmware by Mark Qvist
+//
+// StatsLog.h — Per-minute and per-hour statistics history on flash.
+//
+// airtime_bins and longterm_bins cover the last hour, in RAM. For
+// capacity planning the node also keeps a history that survives reboots:
+// every minute loop() closes a record of own airtime, channel load, noise
+// floor and packet counts, and every 60 minute records are folded into an
+// hour record. Each kind of record goes to its own ring on LittleFS.
+//
+// A ring is a fixed set of segment files, /stats/m00.bin .. and
+// /stats/h00.bin .., of STATS_LOG_SEGMENT_RECORDS records each, one
+// flash block. Records are appended to the current segment; once it is
+// full the oldest segment is truncated and written from the start. No
+// file is ever rewritten in place, and LittleFS places every new block
+// where its allocator sees least wear. At boot the segment holding the
+// highest sequence number is found and appended to.
+//
+// New records wait in RTC memory and are appended in batches, every
+// STATS_LOG_MINUTE_FLUSH minute records and STATS_LOG_HOUR_FLUSH hour
+// records, so the segment's last block is rewritten a few times per
+// segment rather than every minute. RTC memory survives a watchdog
+// reset or a panic, the records still waiting are written at the next
+// boot; a power cut loses them. Reads see the waiting records after
+// the current segment's file.
+//
+// Records are 32 bytes, little-endian, as stored:
+//
+//   seq(4) uptime(4) rx(4) tx(4) lora_to_tcp(4) tcp_to_lora(4)
+//   airtime(2) channel_util(2) noise_floor(1) minutes(1) crc(2)
+//
+// seq counts up per ring and orders the records, uptime is the seconds
+// since boot at the end of the record (it steps back across a reboot),
+// minutes the time covered. Counts are the packets in the period,
+// airtime and channel_util in 1/10000, noise_floor the mean in dBm
+// (-128 if the radio was off). crc is the low half of the CRC-32 of the
+// bytes before it.
+//
+// CMD_STAT_HIST with ring 0 (minutes) or 1 (hours) returns one KISS
+// frame per segment, oldest first:
+//
+//   ring(1) segment(1) records
+//
+// and a frame of just ring(1) at the end. Over HTTP the segments are
+// sent the same way, concatenated, as application/octet-stream.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#ifndef STATS_LOG_H
+#define STATS_LOG_H
+
+#if defined(HAS_RNS) && defined(BOUNDARY_MODE) && BOUNDARY_STATS_LOG && \
+    defined(RNS_USE_FS) && !defined(USE_FLASHFS) && MCU_VARIANT == MCU_ESP32
+
+#define HAS_STATS_LOG true
+
+#include <LittleFS.h>
+#include <Utilities/Crc.h>
+#include <algorithm>
+
+// ─── Stats Log Configuration ─────────────────────────────────────────────────
+#define STATS_LOG_DIR              "/stats"
+#define STATS_LOG_SEGMENT_RECORDS  128     // 4 KB, one LittleFS block
+#define STATS_LOG_MINUTE_FLUSH     16      // records per append, divide the segment
+#define STATS_LOG_HOUR_FLUSH       4
+#define STATS_LOG_PENDING_MAX      16
+#define STATS_LOG_PENDING_MAGIC    0x53544C50
+#define STATS_LOG_SAMPLE_MS        1000    // channel load and noise floor
+#define STATS_LOG_MINUTE_MS        60000
+#define STATS_LOG_HOUR_MINUTES     60
+#define STATS_LOG_NOISE_NONE       -128
+
+#define STATS_RING_MINUTES         0
+#define STATS_RING_HOURS           1
+
+struct __attribute__((packed)) StatsRecord {
+    uint32_t seq;
+    uint32_t uptime;
+    uint32_t rx;
+    uint32_t tx;
+    uint32_t lora_to_tcp;
+    uint32_t tcp_to_lora;
+    uint16_t airtime;
+    uint16_t channel_util;
+    int8_t   noise_floor;
+    uint8_t  minutes;
+    uint16_t crc;
+};
+static_assert(sizeof(StatsRecord) == 32, "StatsRecord is stored as is");
+
+struct StatsRing {
+    char     prefix;
+    uint8_t  segments;
+    uint8_t  flush;             // records written per append
+    uint8_t  segment;           // appended to
+    uint16_t count;             // records in it, waiting ones included
+    uint16_t flushed;           // of those, on flash
+    uint32_t seq;               // of the next record
+    uint32_t written;
+    uint32_t errors;
+};
+
+static StatsRing stats_rings[2] = {
+    {'m', STATS_LOG_MINUTE_SEGMENTS, STATS_LOG_MINUTE_FLUSH, 0, 0, 0, 0, 0, 0},
+    {'h', STATS_LOG_HOUR_SEGMENTS,   STATS_LOG_HOUR_FLUSH,   0, 0, 0, 0, 0, 0},
+};
+
+// Records not yet on flash, per ring. Read from the async_tcp task as well,
+// so changes and copies are made under stats_pending_mux.
+struct StatsPending {
+    uint32_t    magic;
+    uint8_t     count[2];
+    StatsRecord records[2][STATS_LOG_PENDING_MAX];
+};
+
+RTC_NOINIT_ATTR static StatsPending stats_pending;
+static portMUX_TYPE stats_pending_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// Totals at the start of the open minute, and what the minute has sampled
+struct StatsMinute {
+    uint32_t rx, tx, lora_to_tcp, tcp_to_lora, airtime_ms;
+    float    channel_util;
+    int32_t  noise_floor;
+    uint16_t samples;
+    uint16_t noise_samples;
+};
+
+// The open hour, summed from its minute records
+struct StatsHour {
+    uint32_t rx, tx, lora_to_tcp, tcp_to_lora;
+    uint32_t airtime, channel_util;     // 1/10000 * minutes
+    int32_t  noise_floor;               // dBm * minutes with a noise floor
+    uint8_t  minutes;
+    uint8_t  noise_minutes;
+};
+
+static StatsMinute stats_minute;
+static StatsHour   stats_hour;
+static uint32_t    stats_sample_at = 0;
+static uint32_t    stats_minute_at = 0;
+static bool        stats_log_ready = false;
+
+// ─── Ring files ──────────────────────────────────────────────────────────────
+inline void stats_segment_path(char* buf, size_t len, const StatsRing& ring, uint8_t segment) {
+    snprintf(buf, len, STATS_LOG_DIR "/%c%02u.bin", ring.prefix, segment);
+}
+
+inline uint16_t stats_record_crc(const StatsRecord& r) {
+    return (uint16_t)RNS::Utilities::Crc::crc32(0, (const uint8_t*)&r, offsetof(StatsRecord, crc));
+}
+
+// Finds the segment with the newest record and carries on after it
+inline void stats_ring_open(StatsRing& ring) {
+    char path[24];
+    bool found = false;
+    for (uint8_t segment = 0; segment < ring.segments; segment++) {
+        stats_segment_path(path, sizeof(path), ring, segment);
+        File file = LittleFS.open(path, "r");
+        if (!file) continue;
+        size_t size = file.size();
+        StatsRecord last;
+        if (size >= sizeof(last) && file.seek(size - size % sizeof(last) - sizeof(last)) &&
+            file.read((uint8_t*)&last, sizeof(last)) == sizeof(last) &&
+            last.crc == stats_record_crc(last) && (!found || last.seq >= ring.seq)) {
+            found = true;
+            ring.segment = segment;
+            ring.seq = last.seq + 1;
+            // A torn last record closes the segment, appends stay aligned
+            ring.count = (size % sizeof(last)) ? STATS_LOG_SEGMENT_RECORDS : size / sizeof(last);
+        }
+        file.close();
+    }
+    if (!found) {
+        // Segment 0 is truncated on the first append
+        ring.segment = 0;
+        ring.count = 0;
+        ring.seq = 0;
+    }
+    ring.flushed = ring.count;
+}
+
+// Appends the waiting records of ring id to the current segment
+inline void stats_ring_flush(uint8_t id) {
+    StatsRing& ring = stats_rings[id];
+    uint8_t count = stats_pending.count[id];
+    if (count == 0) return;
+    char path[24];
+    stats_segment_path(path, sizeof(path), ring, ring.segment);
+    // Truncating frees the oldest segment's block, the records start a new one
+    File file = LittleFS.open(path, ring.flushed == 0 ? "w" : "a");
+    size_t size = count * sizeof(StatsRecord);
+    if (file && file.write((const uint8_t*)stats_pending.records[id], size) == size) {
+        ring.written += count;
+    } else {
+        ring.errors++;
+    }
+    if (file) file.close();
+    portENTER_CRITICAL(&stats_pending_mux);
+    ring.flushed += count;
+    stats_pending.count[id] = 0;
+    portEXIT_CRITICAL(&stats_pending_mux);
+}
+
+// record has its seq and crc set
+inline void stats_ring_push(uint8_t id, const StatsRecord& record) {
+    StatsRing& ring = stats_rings[id];
+    portENTER_CRITICAL(&stats_pending_mux);
+    if (ring.count >= STATS_LOG_SEGMENT_RECORDS) {
+        ring.segment = (ring.segment + 1) % ring.segments;
+        ring.count = 0;
+        ring.flushed = 0;
+    }
+    stats_pending.records[id][stats_pending.count[id]++] = record;
+    ring.count++;
+    portEXIT_CRITICAL(&stats_pending_mux);
+    if (stats_pending.count[id] >= ring.flush || ring.count >= STATS_LOG_SEGMENT_RECORDS) stats_ring_flush(id);
+}
+
+inline void stats_ring_append(uint8_t id, StatsRecord& record) {
+    record.seq = stats_rings[id].seq++;
+    record.crc = stats_record_crc(record);
+    stats_ring_push(id, record);
+}
+
+// Records left waiting by a reset are kept if they carry on where the
+// ring ends, and written out
+inline void stats_ring_recover(uint8_t id) {
+    StatsRing& ring = stats_rings[id];
+    StatsRecord waiting[STATS_LOG_PENDING_MAX];
+    uint8_t count = stats_pending.count[id];
+    if (count > ring.flush) count = 0;
+    memcpy(waiting, stats_pending.records[id], count * sizeof(StatsRecord));
+    stats_pending.count[id] = 0;
+    uint8_t kept = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (waiting[i].crc != stats_record_crc(waiting[i]) || waiting[i].seq != ring.seq) break;
+        ring.seq++;
+        stats_ring_push(id, waiting[i]);
+        kept++;
+    }
+    stats_ring_flush(id);
+    if (kept > 0) Serial.printf("[Stats] Wrote %u records kept over the reset\r\n", kept);
+}
+
+// Reads up to len bytes of whole records of segment n (0 the oldest) from
+// offset, returns 0 past its end. The current segment is what is on flash
+// of it, then the records still waiting.
+inline size_t stats_ring_read(const StatsRing& ring, uint8_t n, uint32_t offset, uint8_t* buf, size_t len) {
+    char path[24];
+    uint8_t id = &ring - stats_rings;
+    portENTER_CRITICAL(&stats_pending_mux);
+    uint8_t segment = (ring.segment + 1 + n) % ring.segments;
+    bool current = segment == ring.segment;
+    size_t on_flash = current ? ring.flushed * sizeof(StatsRecord) : SIZE_MAX;
+    portEXIT_CRITICAL(&stats_pending_mux);
+    size_t got = 0;
+    len -= len % sizeof(StatsRecord);
+    if (len == 0) return 0;
+    if (on_flash > 0) {
+        stats_segment_path(path, sizeof(path), ring, segment);
+        File file = LittleFS.open(path, "r");
+        if (!file) return 0;
+        on_flash = std::min(on_flash, (size_t)file.size());
+        on_flash -= on_flash % sizeof(StatsRecord);
+        if (offset < on_flash && file.seek(offset)) {
+            got = file.read(buf, std::min(len, on_flash - offset));
+            got -= got % sizeof(StatsRecord);
+        }
+        file.close();
+    }
+    if (current && got < len && offset + got >= on_flash) {
+        portENTER_CRITICAL(&stats_pending_mux);
+        // A flush meanwhile moved the records to flash, they are read there next time
+        if (segment == ring.segment && on_flash == ring.flushed * sizeof(StatsRecord)) {
+            size_t from = offset + got - on_flash;
+            size_t waiting = stats_pending.count[id] * sizeof(StatsRecord);
+            if (from < waiting) {
+                size_t take = std::min(len - got, waiting - from);
+                memcpy(buf + got, (const uint8_t*)stats_pending.records[id] + from, take);
+                got += take;
+            }
+        }
+        portEXIT_CRITICAL(&stats_pending_mux);
+    }
+    return got;
+}
+
+// ─── Records ─────────────────────────────────────────────────────────────────
+inline void stats_minute_start() {
+    stats_minute.rx           = stat_rx;
+    stats_minute.tx           = stat_tx;
+    stats_minute.lora_to_tcp  = boundary_state.packets_bridged_lora_to_tcp;
+    stats_minute.tcp_to_lora  = boundary_state.packets_bridged_tcp_to_lora;
+    stats_minute.airtime_ms   = airtime_ms_total;
+    stats_minute.channel_util = 0;
+    stats_minute.noise_floor  = 0;
+    stats_minute.samples      = 0;
+    stats_minute.noise_samples = 0;
+}
+
+inline void stats_hour_close() {
+    StatsRecord r = {};
+    r.uptime       = millis() / 1000;
+    r.rx           = stats_hour.rx;
+    r.tx           = stats_hour.tx;
+    r.lora_to_tcp  = stats_hour.lora_to_tcp;
+    r.tcp_to_lora  = stats_hour.tcp_to_lora;
+    r.airtime      = stats_hour.airtime / stats_hour.minutes;
+    r.channel_util = stats_hour.channel_util / stats_hour.minutes;
+    r.noise_floor  = stats_hour.noise_minutes ? stats_hour.noise_floor / stats_hour.noise_minutes : STATS_LOG_NOISE_NONE;
+    r.minutes      = stats_hour.minutes;
+    stats_ring_append(STATS_RING_HOURS, r);
+    memset(&stats_hour, 0, sizeof(stats_hour));
+}
+
+inline void stats_minute_close(uint32_t elapsed_ms) {
+    StatsRecord r = {};
+    r.uptime       = millis() / 1000;
+    r.rx           = stat_rx - stats_minute.rx;
+    r.tx           = stat_tx - stats_minute.tx;
+    r.lora_to_tcp  = boundary_state.packets_bridged_lora_to_tcp - stats_minute.lora_to_tcp;
+    r.tcp_to_lora  = boundary_state.packets_bridged_tcp_to_lora - stats_minute.tcp_to_lora;
+    r.airtime      = (uint16_t)std::min<uint64_t>((uint64_t)(airtime_ms_total - stats_minute.airtime_ms) * 10000 / elapsed_ms, 10000);
+    r.channel_util = stats_minute.samples ? (uint16_t)(stats_minute.channel_util / stats_minute.samples * 10000) : 0;
+    r.noise_floor  = stats_minute.noise_samples ? stats_minute.noise_floor / stats_minute.noise_samples : STATS_LOG_NOISE_NONE;
+    r.minutes      = 1;
+    stats_ring_append(STATS_RING_MINUTES, r);
+
+    stats_hour.rx           += r.rx;
+    stats_hour.tx           += r.tx;
+    stats_hour.lora_to_tcp  += r.lora_to_tcp;
+    stats_hour.tcp_to_lora  += r.tcp_to_lora;
+    stats_hour.airtime      += r.airtime;
+    stats_hour.channel_util += r.channel_util;
+    if (r.noise_floor != STATS_LOG_NOISE_NONE) {
+        stats_hour.noise_floor += r.noise_floor;
+        stats_hour.noise_minutes++;
+    }
+    if (++stats_hour.minutes >= STATS_LOG_HOUR_MINUTES) stats_hour_close();
+    stats_minute_start();
+}
+
+// ─── Service ─────────────────────────────────────────────────────────────────
+// Called from setup() once the filesystem is mounted
+inline void stats_log_begin() {
+    if (!LittleFS.exists(STATS_LOG_DIR) && !LittleFS.mkdir(STATS_LOG_DIR)) {
+        Serial.println("[Stats] Could not create " STATS_LOG_DIR);
+        return;
+    }
+    stats_ring_open(stats_rings[STATS_RING_MINUTES]);
+    stats_ring_open(stats_rings[STATS_RING_HOURS]);
+    if (stats_pending.magic != STATS_LOG_PENDING_MAGIC) {
+        memset(&stats_pending, 0, sizeof(stats_pending));
+        stats_pending.magic = STATS_LOG_PENDING_MAGIC;
+    }
+    stats_ring_recover(STATS_RING_MINUTES);
+    stats_ring_recover(STATS_RING_HOURS);
+    memset(&stats_hour, 0, sizeof(stats_hour));
+    stats_minute_start();
+    stats_sample_at = stats_minute_at = millis();
+    stats_log_ready = true;
+    Serial.printf("[Stats] History from minute %lu, hour %lu\r\n",
+                  (unsigned long)stats_rings[STATS_RING_MINUTES].seq,
+                  (unsigned long)stats_rings[STATS_RING_HOURS].seq);
+}
+
+// Called from loop()
+inline void stats_log_service() {
+    if (!stats_log_ready) return;
+    uint32_t now = millis();
+    if (now - stats_sample_at < STATS_LOG_SAMPLE_MS) return;
+    stats_sample_at = now;
+    stats_minute.channel_util += total_channel_util;
+    stats_minute.samples++;
+    if (radio_online) {
+        stats_minute.noise_floor += noise_floor;
+        stats_minute.noise_samples++;
+    }
+    uint32_t elapsed = now - stats_minute_at;
+    if (elapsed < STATS_LOG_MINUTE_MS) return;
+    stats_minute_at = now;
+    stats_minute_close(elapsed);
+}
+
+// ─── KISS ────────────────────────────────────────────────────────────────────
+inline void kiss_indicate_stats_history(uint8_t ring_id) {
+    if (ring_id > STATS_RING_HOURS) return;
+    const StatsRing& ring = stats_rings[ring_id];
+    uint8_t buf[256];
+    for (uint8_t n = 0; stats_log_ready && n < ring.segments; n++) {
+        uint32_t offset = 0;
+        size_t got = stats_ring_read(ring, n, offset, buf, sizeof(buf));
+        if (got == 0) continue;
+        serial_write(FEND);
+        serial_write(CMD_STAT_HIST);
+        escaped_serial_write(ring_id);
+        escaped_serial_write((ring.segment + 1 + n) % ring.segments);
+        while (got > 0) {
+            escaped_serial_write(buf, got);
+            offset += got;
+            got = stats_ring_read(ring, n, offset, buf, sizeof(buf));
+        }
+        serial_write(FEND);
+    }
+    serial_write(FEND);
+    serial_write(CMD_STAT_HIST);
+    escaped_serial_write(ring_id);
+    serial_write(FEND);
+}
+
+#endif // BOUNDARY_STATS_LOG
+#endif // STATS_LOG_H
@@ -0,0 +1,368 @@
+// Copyright (C) 2026, Boundary Mode Extension
+// Based on microReticulum_Firmware by Mark Qvist
+//
+// StatusServer.h — Runtime status page on the WiFi station address.
+//
+// ESPAsyncWebServer answers on its own task, so a browser on the page
+// never holds up loop(). The page itself is a static asset (status.html,
+// WebAssets.h). The figures in it live on loop() and in Transport, so
+// loop() copies them into a StatusSnapshot every BOUNDARY_STATUS_PUSH_MS
+// and the handlers format only that copy. The copy is taken under a
+// spinlock rather than the display's sequence lock: async_tcp runs above
+// loop()'s priority and may share its core, so a reader retrying until
+// the writer finishes could spin for good.
+//
+// The page subscribes on the /ws WebSocket. A subscriber gets the whole
+// snapshot when it connects, then once per publish only the fields that
+// changed, as a JSON object with the keys of /status.json. The delta is
+// formatted once and the one buffer is queued to every subscriber, so a
+// publish costs the same with one open page or several. At most
+// BOUNDARY_STATUS_WS_CLIENTS subscribe at a time; pages beyond that, and
+// browsers without WebSocket, poll /status.json instead.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#ifndef STATUS_SERVER_H
+#define STATUS_SERVER_H
+
+#ifdef HAS_RNS
+#ifdef BOUNDARY_MODE
+#if BOUNDARY_STATUS_SERVER
+
+#include <WiFi.h>
+#include <atomic>
+#include <memory>
+#include <stdarg.h>
+#include "WebAssets.h"
+
+#define HAS_STATUS_SERVER true
+
+// Defined in RNode_Firmware.ino
+extern TxQueue tx_queue;
+
+// ─── Status Server Configuration ─────────────────────────────────────────────
+#define STATUS_JSON_MAX     640     // longest /status.json or delta
+
+// ─── Snapshot ────────────────────────────────────────────────────────────────
+struct StatusSnapshot {
+    uint32_t uptime;              // seconds
+    uint32_t heap_free;
+    uint32_t heap_min;
+    uint32_t psram_free;
+    bool     radio_online;
+    uint32_t lora_freq;
+    uint32_t lora_bw;
+    uint8_t  lora_sf;
+    uint8_t  lora_cr;
+    int8_t   lora_txp;
+    int16_t  last_rssi;
+    int8_t   last_snr;            // quarter dB
+    int16_t  noise_floor;
+    float    airtime;
+    float    airtime_lt;
+    float    channel_util;
+    float    channel_util_lt;
+    uint32_t stat_rx;
+    uint32_t stat_tx;
+    uint32_t tx_queue;
+    bool     wifi_connected;
+    uint32_t wifi_ip;
+    bool     tcp_connected;
+    bool     ap_tcp_connected;
+    uint32_t bridged_lora_to_tcp;
+    uint32_t bridged_tcp_to_lora;
+    uint32_t paths;
+    uint32_t links;
+};
+
+static StatusSnapshot        status_snap_shared;
+static portMUX_TYPE          status_snap_mux = portMUX_INITIALIZER_UNLOCKED;
+static StatusSnapshot        status_snap_pushed;     // loop() only, last delta base
+static AsyncWebServer*       status_server = nullptr;
+static AsyncWebSocket*       status_ws = nullptr;
+static uint32_t              status_last_publish = 0;
+
+// Runs on loop()
+inline void status_publish(StatusSnapshot& s) {
+    s.uptime              = millis() / 1000;
+    s.heap_free           = ESP.getFreeHeap();
+    s.heap_min            = ESP.getMinFreeHeap();
+    s.psram_free          = psramFound() ? ESP.getFreePsram() : 0;
+    s.radio_online        = radio_online;
+    s.lora_freq           = lora_freq;
+    s.lora_bw             = lora_bw;
+    s.lora_sf             = (uint8_t)lora_sf;
+    s.lora_cr             = (uint8_t)lora_cr;
+    s.lora_txp            = (int8_t)lora_txp;
+    s.last_rssi           = (int16_t)last_rssi;
+    s.last_snr            = (int8_t)last_snr_raw;
+    s.noise_floor         = (int16_t)noise_floor;
+    s.airtime             = airtime;
+    s.airtime_lt          = longterm_airtime;
+    s.channel_util        = total_channel_util;
+    s.channel_util_lt     = longterm_channel_util;
+    s.stat_rx             = stat_rx;
+    s.stat_tx             = stat_tx;
+    s.tx_queue            = (uint32_t)tx_queue.height();
+    s.wifi_connected      = boundary_state.wifi_connected;
+    s.wifi_ip             = (uint32_t)WiFi.localIP();
+    s.tcp_connected       = boundary_state.tcp_connected;
+    s.ap_tcp_connected    = boundary_state.ap_tcp_connected;
+    s.bridged_lora_to_tcp = boundary_state.packets_bridged_lora_to_tcp;
+    s.bridged_tcp_to_lora = boundary_state.packets_bridged_tcp_to_lora;
+    // Kept by the task that runs Transport
+    s.paths               = transport_path_count.load(std::memory_order_relaxed);
+    s.links               = transport_link_count.load(std::memory_order_relaxed);
+
+    portENTER_CRITICAL(&status_snap_mux);
+    memcpy(&status_snap_shared, &s, sizeof(s));
+    portEXIT_CRITICAL(&status_snap_mux);
+    status_last_publish = millis();
+}
+
+// Runs on the async_tcp task
+inline void status_snapshot_read(StatusSnapshot& s) {
+    portENTER_CRITICAL(&status_snap_mux);
+    memcpy(&s, &status_snap_shared, sizeof(s));
+    portEXIT_CRITICAL(&status_snap_mux);
+}
+
+// ─── JSON ────────────────────────────────────────────────────────────────────
+// Appends "key":value pairs to a fixed buffer; output past the end is
+// dropped and reported by finish()
+class StatusJson {
+public:
+    StatusJson(char* buf, size_t size) : _buf(buf), _size(size) { put("{"); }
+
+    void u(const char* key, unsigned long v)   { field(key); put("%lu", v); }
+    void i(const char* key, long v)            { field(key); put("%ld", v); }
+    void f(const char* key, double v, int dig) { field(key); put("%.*f", dig, v); }
+    void b(const char* key, bool v)            { field(key); put(v ? "true" : "false"); }
+    void ip(const char* key, uint32_t v) {
+        IPAddress a(v);
+        field(key);
+        put("\"%u.%u.%u.%u\"", a[0], a[1], a[2], a[3]);
+    }
+    void s(const char* key, const char* v) {
+        // only the hex node hash goes through here, nothing to escape
+        field(key);
+        put("\"%s\"", v);
+    }
+
+    // Length of the object, 0 if it didn't fit
+    size_t finish() {
+        put("}");
+        return (_len < _size) ? _len : 0;
+    }
+
+private:
+    void field(const char* key) {
+        put(_fields++ ? ",\"%s\":" : "\"%s\":", key);
+    }
+    void put(const char* fmt, ...) {
+        if (_len >= _size) return;
+        va_list args;
+        va_start(args, fmt);
+        int n = vsnprintf(_buf + _len, _size - _len, fmt, args);
+        va_end(args);
+        _len += (n > 0) ? n : 0;
+    }
+
+    char*    _buf;
+    size_t   _size;
+    size_t   _len = 0;
+    uint16_t _fields = 0;
+};
+
+// The whole snapshot if prev is null, else the fields that differ from prev
+inline size_t status_format(char* buf, size_t size, const StatusSnapshot& s, const StatusSnapshot* prev) {
+    StatusJson w(buf, size);
+    #define STATUS_CHANGED(field) (!prev || s.field != prev->field)
+    if (!prev) w.s("hash", rtc_node_hash_magic == NODE_HASH_RTC_MAGIC ? rtc_node_hash_hex : "");
+    if (STATUS_CHANGED(uptime))              w.u("uptime", s.uptime);
+    if (STATUS_CHANGED(heap_free))           w.u("heap", s.heap_free);
+    if (STATUS_CHANGED(heap_min))            w.u("heap_min", s.heap_min);
+    if (STATUS_CHANGED(psram_free))          w.u("psram", s.psram_free);
+    if (STATUS_CHANGED(radio_online))        w.b("radio", s.radio_online);
+    if (STATUS_CHANGED(lora_freq))           w.u("freq", s.lora_freq);
+    if (STATUS_CHANGED(lora_bw))             w.u("bw", s.lora_bw);
+    if (STATUS_CHANGED(lora_sf))             w.u("sf", s.lora_sf);
+    if (STATUS_CHANGED(lora_cr))             w.u("cr", s.lora_cr);
+    if (STATUS_CHANGED(lora_txp))            w.i("txp", s.lora_txp);
+    if (STATUS_CHANGED(last_rssi))           w.i("rssi", s.last_rssi);
+    if (STATUS_CHANGED(last_snr))            w.f("snr", s.last_snr * 0.25, 2);
+    if (STATUS_CHANGED(noise_floor))         w.i("noise", s.noise_floor);
+    if (STATUS_CHANGED(airtime))             w.f("airtime", s.airtime, 4);
+    if (STATUS_CHANGED(airtime_lt))          w.f("airtime_lt", s.airtime_lt, 4);
+    if (STATUS_CHANGED(channel_util))        w.f("load", s.channel_util, 4);
+    if (STATUS_CHANGED(channel_util_lt))     w.f("load_lt", s.channel_util_lt, 4);
+    if (STATUS_CHANGED(stat_rx))             w.u("rx", s.stat_rx);
+    if (STATUS_CHANGED(stat_tx))             w.u("tx", s.stat_tx);
+    if (STATUS_CHANGED(tx_queue))            w.u("txq", s.tx_queue);
+    if (STATUS_CHANGED(wifi_connected))      w.b("wifi", s.wifi_connected);
+    if (STATUS_CHANGED(wifi_ip))             w.ip("ip", s.wifi_ip);
+    if (STATUS_CHANGED(tcp_connected))       w.b("backbone", s.tcp_connected);
+    if (STATUS_CHANGED(ap_tcp_connected))    w.b("local", s.ap_tcp_connected);
+    if (STATUS_CHANGED(bridged_lora_to_tcp)) w.u("lora_to_tcp", s.bridged_lora_to_tcp);
+    if (STATUS_CHANGED(bridged_tcp_to_lora)) w.u("tcp_to_lora", s.bridged_tcp_to_lora);
+    if (STATUS_CHANGED(paths))               w.u("paths", s.paths);
+    if (STATUS_CHANGED(links))               w.u("links", s.links);
+    #undef STATUS_CHANGED
+    return w.finish();
+}
+
+// ─── GET /status.json ────────────────────────────────────────────────────────
+// Runs on the async_tcp task
+static void status_send_json(AsyncWebServerRequest* request) {
+    StatusSnapshot s;
+    char buf[STATUS_JSON_MAX];
+    status_snapshot_read(s);
+    size_t len = status_format(buf, sizeof(buf), s, nullptr);
+
+    AsyncResponseStream* out = request->beginResponseStream("application/json");
+    out->addHeader("Cache-Control", "no-store");
+    out->write((const uint8_t*)buf, len);
+    request->send(out);
+}
+
+#if HAS_STATS_LOG
+// ─── GET /stats/minutes.bin, /stats/hours.bin ────────────────────────────────
+// Runs on the async_tcp task. The ring's segments are read a chunk at a
+// time, oldest first, in whole records (StatsLog.h); a segment the loop()
+// task starts over meanwhile ends early, seq tells the records apart.
+static void status_send_stats(AsyncWebServerRequest* request, uint8_t ring_id) {
+    struct Cursor { uint8_t segment; uint32_t offset; };
+    std::shared_ptr<Cursor> cursor = std::make_shared<Cursor>(Cursor{0, 0});
+    const StatsRing& ring = stats_rings[ring_id];
+    AsyncWebServerResponse* response = request->beginChunkedResponse("application/octet-stream",
+        [cursor, &ring](uint8_t* buf, size_t max_len, size_t index) -> size_t {
+            if (max_len < sizeof(StatsRecord)) return RESPONSE_TRY_AGAIN;
+            while (cursor->segment < ring.segments) {
+                size_t got = stats_ring_read(ring, cursor->segment, cursor->offset, buf, max_len);
+                if (got > 0) {
+                    cursor->offset += got;
+                    return got;
+                }
+                cursor->segment++;
+                cursor->offset = 0;
+            }
+            return 0;
+        });
+    response->addHeader("Cache-Control", "no-store");
+    request->send(response);
+}
+#endif
+
+#if HAS_LIVE_CONFIG
+// ─── POST /config ────────────────────────────────────────────────────────────
+// Runs on the async_tcp task. Only the fields given change; the request is
+// handed to loop() and applied there (LiveConfig.h). 403 without the
+// configured X-Config-Token, 202 when taken, 400 for out of range values,
+// 503 while the previous one is still pending.
+static void status_handle_config(AsyncWebServerRequest* request) {
+    const AsyncWebHeader* token = request->getHeader("X-Config-Token");
+    if (!token || !live_config_token_ok(token->value().c_str())) {
+        request->send(403, "application/json", "{\"error\":\"forbidden\"}");
+        return;
+    }
+
+    LiveConfigRequest r;
+    memset(&r, 0, sizeof(r));
+    if (request->hasArg("freq")) { r.fields |= LIVE_FREQ; r.freq = (uint32_t)(atof(request->arg("freq").c_str()) * 1000000.0); }
+    if (request->hasArg("bw"))   { r.fields |= LIVE_BW;   r.bw   = (uint32_t)request->arg("bw").toInt(); }
+    if (request->hasArg("sf"))   { r.fields |= LIVE_SF;   r.sf   = (uint8_t)request->arg("sf").toInt(); }
+    if (request->hasArg("cr"))   { r.fields |= LIVE_CR;   r.cr   = (uint8_t)request->arg("cr").toInt(); }
+    if (request->hasArg("txp"))  { r.fields |= LIVE_TXP;  r.txp  = (uint8_t)request->arg("txp").toInt(); }
+    if (request->hasArg("bb_host") || request->hasArg("bb_port")) {
+        r.fields |= LIVE_BACKBONE;
+        const String& host = request->hasArg("bb_host") ? request->arg("bb_host") : String(boundary_state.backbone_host);
+        strncpy(r.host, host.c_str(), sizeof(r.host) - 1);
+        r.port = request->hasArg("bb_port") ? (uint16_t)request->arg("bb_port").toInt() : boundary_state.backbone_port;
+    }
+
+    if (r.fields == 0 || !live_config_valid(r)) {
+        request->send(400, "application/json", "{\"error\":\"invalid\"}");
+    } else if (!live_config_post(r)) {
+        request->send(503, "application/json", "{\"error\":\"busy\"}");
+    } else {
+        bool reboot = (r.fields & LIVE_BACKBONE) && tcp_interface_ptr == nullptr;
+        request->send(202, "application/json", reboot ? "{\"pending\":true,\"reboot\":true}" : "{\"pending\":true}");
+    }
+}
+#endif
+
+// ─── /ws ─────────────────────────────────────────────────────────────────────
+// Runs on the async_tcp task
+static void status_ws_event(AsyncWebSocket* ws, AsyncWebSocketClient* client,
+                            AwsEventType type, void* arg, uint8_t* data, size_t len) {
+    if (type != WS_EVT_CONNECT) return;
+    if (ws->count() > BOUNDARY_STATUS_WS_CLIENTS) {
+        // 1013: try again later, the page falls back to polling
+        client->close(1013);
+        return;
+    }
+    StatusSnapshot s;
+    char buf[STATUS_JSON_MAX];
+    status_snapshot_read(s);
+    size_t n = status_format(buf, sizeof(buf), s, nullptr);
+    if (n) client->text(buf, n);
+}
+
+// Runs on loop(), right after a publish
+inline void status_ws_push(const StatusSnapshot& s) {
+    status_ws->cleanupClients(BOUNDARY_STATUS_WS_CLIENTS);
+    if (status_ws->count() > 0) {
+        char buf[STATUS_JSON_MAX];
+        size_t n = status_format(buf, sizeof(buf), s, &status_snap_pushed);
+        // "{}" when nothing changed
+        if (n > 2) status_ws->textAll(buf, n);
+    }
+    status_snap_pushed = s;
+}
+
+// ─── Service ─────────────────────────────────────────────────────────────────
+// Called from loop(). The server starts with the first station connection
+// and stays up; it listens on every address, so WiFi reconnects don't
+// need a restart.
+inline void status_server_service() {
+    if (!status_server) {
+        if (WiFi.status() != WL_CONNECTED) return;
+        status_publish(status_snap_pushed);
+        status_server = new AsyncWebServer(BOUNDARY_STATUS_PORT);
+        status_ws = new AsyncWebSocket("/ws");
+        status_ws->onEvent(status_ws_event);
+        status_server->addHandler(status_ws);
+        web_serve(status_server, "/status.html", "/");
+        web_serve(status_server, "/status.js");
+        web_serve(status_server, "/style.css");
+        status_server->on("/status.json", HTTP_GET, status_send_json);
+        #if HAS_STATS_LOG
+        status_server->on("/stats/minutes.bin", HTTP_GET, [](AsyncWebServerRequest* request) {
+            status_send_stats(request, STATS_RING_MINUTES);
+        });
+        status_server->on("/stats/hours.bin", HTTP_GET, [](AsyncWebServerRequest* request) {
+            status_send_stats(request, STATS_RING_HOURS);
+        });
+        #endif
+        #if HAS_LIVE_CONFIG
+        status_server->on("/config", HTTP_POST, status_handle_config);
+        #endif
+        status_server->begin();
+        Serial.printf("[Status] Serving http://%s:%d/\r\n",
+                      WiFi.localIP().toString().c_str(), BOUNDARY_STATUS_PORT);
+        return;
+    }
+    if (millis() - status_last_publish >= BOUNDARY_STATUS_PUSH_MS) {
+        StatusSnapshot s;
+        status_publish(s);
+        status_ws_push(s);
+    }
+}
+
+#endif // BOUNDARY_STATUS_SERVER
+#endif // BOUNDARY_MODE
+#endif // HAS_RNS
+#endif // STATUS_SERVER_H
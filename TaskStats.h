@@ -0,0 +1,201 @@
+// Copyright (C) 2026, Boundary Mode Extension
+// Based on microReticulum_Firmware by Mark Qvist
+//
+// TaskStats.h — Per-task CPU share and stack high-water marks.
+//
+// loop(), the transport task, the WiFi and lwIP tasks, async_tcp, the
+// Bluetooth stack and the logging and capture tasks share two cores.
+// Every TASK_STATS_INTERVAL_MS loop() takes uxTaskGetSystemState() and
+// works out, per task, the share of one core it ran since the previous
+// sample (from the FreeRTOS run time counters) and the least stack it has
+// had free since it started. The idle tasks' shares give the idle time
+// of each core. A task with less than TASK_STATS_STACK_WARN bytes of
+// stack left is logged once per sample.
+//
+// Run time counters need CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS in the
+// SDK configuration; without them shares read 0xFFFF and only the stack
+// figures are exported.
+//
+// CMD_STAT_TASKS returns one KISS frame:
+//
+//   interval_ms(4) core_count(1) idle(2) * core_count task_count(1)
+//   { core(1) priority(1) share(2) stack_free(4) name(16) } * task_count
+//
+// all big-endian. Shares are in 1/10000 of a core, core is 0xFF for a
+// task free to run on either, and names are NUL padded. On the metrics
+// endpoint:
+//
+//   rnode_task_cpu_ratio{task="loopTask",core="1"} 0.1832
+//   rnode_task_stack_free_bytes{task="loopTask",core="1"} 3412
+//   rnode_core_idle_ratio{core="0"} 0.8810
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#ifndef TASK_STATS_H
+#define TASK_STATS_H
+
+#if defined(HAS_RNS) && defined(BOUNDARY_MODE) && BOUNDARY_TASK_STATS && MCU_VARIANT == MCU_ESP32
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#if configUSE_TRACE_FACILITY
+
+#define HAS_TASK_STATS true
+
+// ─── Task Stats Configuration ────────────────────────────────────────────────
+#define TASK_STATS_MAX          32      // uxTaskGetSystemState() fails if there are more
+#define TASK_STATS_INTERVAL_MS  10000
+#define TASK_STATS_STACK_WARN   512     // bytes
+#define TASK_STATS_NAME_LEN     16
+#define TASK_STATS_NO_SHARE     0xFFFF
+
+struct TaskStatsEntry {
+    char     name[TASK_STATS_NAME_LEN];
+    uint32_t stack_free;                // bytes, least since the task started
+    uint16_t share;                     // 1/10000 of a core over the interval
+    uint8_t  core;                      // 0xFF for no affinity
+    uint8_t  priority;
+};
+
+static TaskStatus_t   task_stats_status[TASK_STATS_MAX];
+static TaskStatsEntry task_stats[TASK_STATS_MAX];
+static uint8_t        task_stats_count = 0;
+static uint16_t       task_stats_idle[portNUM_PROCESSORS];
+// Previous sample, to difference the run time counters against
+static UBaseType_t    task_stats_prev_number[TASK_STATS_MAX];
+static uint32_t       task_stats_prev_runtime[TASK_STATS_MAX];
+static uint8_t        task_stats_prev_count = 0;
+static uint32_t       task_stats_prev_total = 0;
+static uint32_t       task_stats_sampled_at = 0;
+
+inline uint16_t task_stats_share(uint32_t runtime, uint32_t elapsed) {
+    if (elapsed == 0) return TASK_STATS_NO_SHARE;
+    uint64_t share = (uint64_t)runtime * 10000 / elapsed;
+    return share > 10000 ? 10000 : (uint16_t)share;
+}
+
+// Called from loop(), the status array is static to keep it off loop()'s stack
+inline void task_stats_sample() {
+    uint32_t total = 0;
+    UBaseType_t n = uxTaskGetSystemState(task_stats_status, TASK_STATS_MAX, &total);
+    if (n == 0) return;
+    bool have_runtime = total != 0 && task_stats_prev_total != 0;
+    uint32_t elapsed = total - task_stats_prev_total;
+
+    for (uint8_t c = 0; c < portNUM_PROCESSORS; c++) task_stats_idle[c] = TASK_STATS_NO_SHARE;
+    for (UBaseType_t i = 0; i < n; i++) {
+        const TaskStatus_t& t = task_stats_status[i];
+        TaskStatsEntry& e = task_stats[i];
+        strncpy(e.name, t.pcTaskName, sizeof(e.name) - 1);
+        e.name[sizeof(e.name) - 1] = '\0';
+        e.stack_free = t.usStackHighWaterMark * sizeof(StackType_t);
+        e.priority = (uint8_t)t.uxCurrentPriority;
+        #if configTASKLIST_INCLUDE_COREID
+            e.core = (t.xCoreID == tskNO_AFFINITY) ? 0xFF : (uint8_t)t.xCoreID;
+        #else
+            e.core = 0xFF;
+        #endif
+
+        // A task started since the last sample ran all of its time in it
+        uint32_t ran = t.ulRunTimeCounter;
+        for (uint8_t j = 0; j < task_stats_prev_count; j++) {
+            if (task_stats_prev_number[j] == t.xTaskNumber) { ran -= task_stats_prev_runtime[j]; break; }
+        }
+        e.share = have_runtime ? task_stats_share(ran, elapsed) : TASK_STATS_NO_SHARE;
+        for (uint8_t c = 0; c < portNUM_PROCESSORS; c++) {
+            if (t.xHandle == xTaskGetIdleTaskHandleForCPU(c)) task_stats_idle[c] = e.share;
+        }
+
+        if (e.stack_free < TASK_STATS_STACK_WARN) {
+            ringlog_printf("[Tasks] %s stack low: %u bytes free\r\n", e.name, (unsigned)e.stack_free);
+        }
+        task_stats_prev_number[i] = t.xTaskNumber;
+        task_stats_prev_runtime[i] = t.ulRunTimeCounter;
+    }
+    task_stats_count = n;
+    task_stats_prev_count = n;
+    task_stats_prev_total = total;
+}
+
+// Called from loop()
+inline void task_stats_service() {
+    if (task_stats_sampled_at != 0 && millis() - task_stats_sampled_at < TASK_STATS_INTERVAL_MS) return;
+    task_stats_sampled_at = millis();
+    task_stats_sample();
+}
+
+// ─── KISS ────────────────────────────────────────────────────────────────────
+inline void kiss_indicate_task_stats() {
+    serial_write(FEND);
+    serial_write(CMD_STAT_TASKS);
+    uint32_t interval = TASK_STATS_INTERVAL_MS;
+    escaped_serial_write(interval >> 24);
+    escaped_serial_write(interval >> 16);
+    escaped_serial_write(interval >> 8);
+    escaped_serial_write(interval);
+    escaped_serial_write(portNUM_PROCESSORS);
+    for (uint8_t c = 0; c < portNUM_PROCESSORS; c++) {
+        escaped_serial_write(task_stats_idle[c] >> 8);
+        escaped_serial_write(task_stats_idle[c]);
+    }
+    escaped_serial_write(task_stats_count);
+    for (uint8_t i = 0; i < task_stats_count; i++) {
+        const TaskStatsEntry& e = task_stats[i];
+        escaped_serial_write(e.core);
+        escaped_serial_write(e.priority);
+        escaped_serial_write(e.share >> 8);
+        escaped_serial_write(e.share);
+        escaped_serial_write(e.stack_free >> 24);
+        escaped_serial_write(e.stack_free >> 16);
+        escaped_serial_write(e.stack_free >> 8);
+        escaped_serial_write(e.stack_free);
+        uint8_t name[TASK_STATS_NAME_LEN] = {0};
+        memcpy(name, e.name, strlen(e.name));
+        escaped_serial_write(name, sizeof(name));
+    }
+    serial_write(FEND);
+}
+
+#ifdef HAS_METRICS
+// ─── Metrics export ──────────────────────────────────────────────────────────
+inline void task_stats_collect(MetricsWriter& w) {
+    if (task_stats_count == 0) return;
+    char labels[48];
+    w.family("rnode_task_cpu_ratio", "gauge", "Share of one core each task ran over the last sample interval");
+    for (uint8_t i = 0; i < task_stats_count; i++) {
+        const TaskStatsEntry& e = task_stats[i];
+        if (e.share == TASK_STATS_NO_SHARE) continue;
+        if (e.core == 0xFF) snprintf(labels, sizeof(labels), "task=\"%s\",core=\"any\"", e.name);
+        else                snprintf(labels, sizeof(labels), "task=\"%s\",core=\"%u\"", e.name, e.core);
+        w.value("rnode_task_cpu_ratio", labels, e.share / 10000.0f);
+    }
+    w.family("rnode_task_stack_free_bytes", "gauge", "Least stack each task has had free since it started");
+    for (uint8_t i = 0; i < task_stats_count; i++) {
+        const TaskStatsEntry& e = task_stats[i];
+        if (e.core == 0xFF) snprintf(labels, sizeof(labels), "task=\"%s\",core=\"any\"", e.name);
+        else                snprintf(labels, sizeof(labels), "task=\"%s\",core=\"%u\"", e.name, e.core);
+        w.value("rnode_task_stack_free_bytes", labels, e.stack_free);
+    }
+    w.family("rnode_core_idle_ratio", "gauge", "Share of each core spent in its idle task over the last sample interval");
+    for (uint8_t c = 0; c < portNUM_PROCESSORS; c++) {
+        if (task_stats_idle[c] == TASK_STATS_NO_SHARE) continue;
+        snprintf(labels, sizeof(labels), "core=\"%u\"", c);
+        w.value("rnode_core_idle_ratio", labels, task_stats_idle[c] / 10000.0f);
+    }
+}
+#endif
+
+// Called once Reticulum is up
+inline void task_stats_setup() {
+#ifdef HAS_METRICS
+    metrics_add_collector(task_stats_collect);
+#endif
+}
+
+#endif // configUSE_TRACE_FACILITY
+#endif // BOUNDARY_TASK_STATS
+#endif // TASK_STATS_H
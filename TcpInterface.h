@@ -18,25 +18,46 @@
 
 #include <WiFi.h>
 #include <lwip/sockets.h>   // SO_LINGER — force RST to free lwIP PCBs immediately
+#include <lwip/dns.h>
+#include <lwip/tcpip.h>
+#include <fcntl.h>
+#include <errno.h>
 #include <Interface.h>
 #include <Transport.h>
 #include <Bytes.h>
+#include <Utilities/OS.h>
+#include <new>
+#include <atomic>
+#include "TransportTask.h"
 
 // ─── TCP Interface Configuration ─────────────────────────────────────────────
 #define TCP_IF_DEFAULT_PORT      4242
+// Slot table size; slots are allocated on accept, so the cap costs a pointer
+// each. setMaxClients() picks the runtime limit up to this.
 #ifdef BOUNDARY_MODE
-#define TCP_IF_MAX_CLIENTS       8
+#define TCP_IF_MAX_CLIENTS       32
+#define TCP_IF_DEFAULT_CLIENTS   8
 #else
 #define TCP_IF_MAX_CLIENTS       4
+#define TCP_IF_DEFAULT_CLIENTS   4
 #endif
 #define TCP_IF_HW_MTU            1064
 #define TCP_IF_CONNECT_TIMEOUT   6000    // ms
-#define TCP_IF_WRITE_TIMEOUT     2000    // ms — short to avoid WDT
+#define TCP_IF_WRITE_TIMEOUT     2000    // ms — drop a client whose send queue makes no progress for this long
 #define TCP_IF_READ_TIMEOUT      120000  // ms — 2 minutes (backbone can go quiet)
 #define TCP_IF_RECONNECT_MIN     10000   // ms — initial reconnect interval
 #define TCP_IF_RECONNECT_MAX     120000  // ms — max backoff (2 minutes)
 #define TCP_IF_KEEPALIVE_INTERVAL 30000  // ms — send empty HDLC frames to keep link alive
 #define TCP_IF_POLL_INTERVAL     10      // ms
+#define TCP_IF_RX_CHUNK          512     // bytes pulled from lwIP per read()
+#define TCP_IF_TX_QUEUE          16      // framed packets queued per client
+#define TCP_IF_TX_ANNOUNCE_LIMIT 8       // stop queueing announces to a client beyond this backlog
+#define TCP_IF_TX_IOV            8       // frames coalesced into one sendmsg()
+#define TCP_IF_MAX_UPSTREAMS     4       // backbone hosts in a client-mode target list
+#define TCP_IF_UPSTREAM_RTT_DEFAULT 500  // ms — rank of an upstream not connected to yet
+#define TCP_IF_WARM_INTERVAL     300000  // ms — re-resolve every standby upstream this often
+#define TCP_IF_RATE_MIN_MS       50      // ms — shorter send backlogs are too coarse for a throughput sample
+#define TCP_IF_DNS_SLOTS         4       // interfaces that can have a DNS lookup outstanding
 
 // HDLC-like framing for TCP (matches Reticulum-rust tcp_interface)
 #define HDLC_FLAG  0x7E
@@ -49,21 +70,80 @@ enum TcpIfMode {
     TCP_IF_MODE_CLIENT = 1,  // Connect out to a backbone rnsd TCP server
 };
 
+// ─── Client-mode connect state ───────────────────────────────────────────────
+// The outbound connection is advanced one non-blocking step per loop() so a
+// slow or dead backbone never stalls the rest of the firmware.
+enum TcpConnectState {
+    TCP_CONNECT_IDLE       = 0,
+    TCP_CONNECT_RESOLVING  = 1,  // async DNS lookup in flight
+    TCP_CONNECT_CONNECTING = 2,  // non-blocking connect() in flight
+};
+
+// ─── Client-mode upstream ────────────────────────────────────────────────────
+// One entry of the backbone target list. The connection goes to the upstream
+// with the fewest recent failures and the lowest connect RTT, the others are
+// kept resolved so failing over to them costs no DNS round trip.
+struct TcpUpstream {
+    char      host[64];
+    uint16_t  port;
+    IPAddress ip;          // cached address, 0 = resolve first
+    uint32_t  rtt_ms;      // smoothed TCP handshake time, 0 = not measured
+    uint8_t   failures;    // consecutive failed attempts or short-lived sessions
+};
+
+// ─── Outbound frame ──────────────────────────────────────────────────────────
+// The HDLC framed buffer is shared by every client it is queued to.
+struct TcpTxFrame {
+    RNS::Bytes data;
+    bool       announce;
+};
+
 // ─── Client connection state ─────────────────────────────────────────────────
+// Allocated when a connection is accepted (PSRAM first) and freed when it
+// closes, so idle slots cost nothing.
 struct TcpClient {
     WiFiClient client;
     uint32_t   last_activity;
-    bool       active;
+    uint8_t    list_pos;       // index in TcpInterface::_active
     // HDLC deframe state
     bool       in_frame;
     bool       escape;
     bool       truncated;
-    uint8_t    rxbuf[TCP_IF_HW_MTU];
+    // Frames are unescaped straight into the storage of the Bytes that is
+    // handed to Transport, rxbuf points into it while a frame is open.
+    RNS::Bytes frame;
+    uint8_t*   rxbuf;
     uint16_t   rxlen;
+    // Outbound queue, flushed without blocking from loop()
+    TcpTxFrame txq[TCP_IF_TX_QUEUE];
+    uint8_t    tx_head;
+    uint8_t    tx_count;
+    uint16_t   tx_offset;      // bytes of the head frame already sent
+    uint32_t   tx_progress;    // millis() of the last successful send
+    // Throughput is only sampled while the socket pushes back, otherwise
+    // it measures how much there was to send rather than the link
+    uint32_t   tx_backlog_at;  // millis() the socket first pushed back, 0 = not backlogged
+    uint32_t   tx_backlog_bytes;
 };
 
+// ─── DNS callback slots ──────────────────────────────────────────────────────
+// lwIP keeps the callback argument of a lookup until it answers, which can
+// be after the interface that asked is gone. It is given a slot index and
+// generation instead of the interface pointer; the destructor clears the
+// slot and bumps the generation under tcp_dns_mux, so a late answer finds
+// no owner and is dropped.
+class TcpInterface;
+
+struct TcpDnsSlot {
+    TcpInterface* owner;
+    uint32_t      generation;
+};
+
+static TcpDnsSlot  tcp_dns_slots[TCP_IF_DNS_SLOTS] = {};
+static portMUX_TYPE tcp_dns_mux = portMUX_INITIALIZER_UNLOCKED;
+
 // ─── TcpInterface Class ─────────────────────────────────────────────────────
-class TcpInterface : public RNS::InterfaceImpl {
+class TcpInterface : public RNS::InterfaceImpl, public TransportEndpoint {
 public:
     TcpInterface(TcpIfMode mode, uint16_t port = TCP_IF_DEFAULT_PORT,
                  const char* target_host = nullptr, uint16_t target_port = 0,
@@ -71,15 +151,30 @@ public:
         : RNS::InterfaceImpl(name),
           _mode(mode),
           _port(port),
-          _target_port(target_port),
           _server(nullptr),
           _num_clients(0),
+          _max_clients(TCP_IF_DEFAULT_CLIENTS),
           _last_reconnect(0),
           _last_keepalive(0),
           _reconnect_interval(TCP_IF_RECONNECT_MIN),
           _read_timeout(TCP_IF_READ_TIMEOUT),
-          _resolved_ip((uint32_t)0),
           _consecutive_failures(0),
+          _num_upstreams(0),
+          _upstream(0),
+          _round_failures(0),
+          _failover_pending(false),
+          _session_proven(false),
+          _connected_at(0),
+          _warming(false),
+          _warm_index(0),
+          _last_warm(0),
+          _connect_state(TCP_CONNECT_IDLE),
+          _connect_fd(-1),
+          _connect_started(0),
+          _connect_cached(false),
+          _dns_done(false),
+          _dns_pending(false),
+          _dns_ip(0),
           _started(false)
     {
         _IN = true;
@@ -90,28 +185,25 @@ public:
         _FIXED_MTU = true;
         // TCP links are effectively 10 Mbps+. Setting a realistic
         // bitrate lets Transport prefer TCP paths over LoRa when
-        // both exist for the same destination.
+        // both exist for the same destination. It stands in until the
+        // send backlog and the connect RTT give measured estimates.
         // announce_cap = 2% keeps backbone announce flooding in check.
         _bitrate = 10000000;
-        _announce_cap = 2.0;
-        if (target_host != nullptr) {
-            strncpy(_target_host, target_host, sizeof(_target_host) - 1);
-            _target_host[sizeof(_target_host) - 1] = '\0';
-        } else {
-            _target_host[0] = '\0';
-        }
+        _announce_cap = RNS::Type::Reticulum::ANNOUNCE_CAP / 100.0;
+        _parse_upstreams(target_host, target_port);
         for (int i = 0; i < TCP_IF_MAX_CLIENTS; i++) {
-            _clients[i].active = false;
-            _clients[i].in_frame = false;
-            _clients[i].escape = false;
-            _clients[i].truncated = false;
-            _clients[i].rxlen = 0;
-            _clients[i].last_activity = 0;
+            _clients[i] = nullptr;
         }
     }
 
     virtual ~TcpInterface() {
         stop();
+        if (_dns_slot >= 0) {
+            portENTER_CRITICAL(&tcp_dns_mux);
+            tcp_dns_slots[_dns_slot].owner = nullptr;
+            tcp_dns_slots[_dns_slot].generation++;
+            portEXIT_CRITICAL(&tcp_dns_mux);
+        }
     }
 
     // ─── Lifecycle ───────────────────────────────────────────────────────────
@@ -119,10 +211,10 @@ public:
         if (_started) return true;
 
         if (_mode == TCP_IF_MODE_SERVER) {
-            _server = new WiFiServer(_port, TCP_IF_MAX_CLIENTS);
+            _server = new WiFiServer(_port, _max_clients);
             _server->begin();
             _server->setNoDelay(true);
-            Serial.printf("[TcpIF] Server listening on port %d\r\n", _port);
+            ringlog_printf("[TcpIF] Server listening on port %d\r\n", _port);
             _started = true;
         } else {
             // Client mode — try initial connection
@@ -133,20 +225,19 @@ public:
     }
 
     void stop() {
-        for (int i = 0; i < TCP_IF_MAX_CLIENTS; i++) {
-            if (_clients[i].active) {
-                // Force RST to free lwIP PCBs immediately (no TIME_WAIT)
-                int fd = _clients[i].client.fd();
-                if (fd >= 0) {
-                    struct linger lin;
-                    lin.l_onoff = 1;
-                    lin.l_linger = 0;
-                    setsockopt(fd, SOL_SOCKET, SO_LINGER, &lin, sizeof(lin));
-                }
-                _clients[i].client.stop();
-                _clients[i].client = WiFiClient();
-                _clients[i].active = false;
+        _abort_connect();
+        while (_num_clients > 0) {
+            int i = _active[_num_clients - 1];
+            // Force RST to free lwIP PCBs immediately (no TIME_WAIT)
+            int fd = _clients[i]->client.fd();
+            if (fd >= 0) {
+                struct linger lin;
+                lin.l_onoff = 1;
+                lin.l_linger = 0;
+                setsockopt(fd, SOL_SOCKET, SO_LINGER, &lin, sizeof(lin));
             }
+            _clients[i]->client.stop();
+            _free_client(i);
         }
         if (_server) {
             _server->end();
@@ -154,11 +245,14 @@ public:
             _server = nullptr;
         }
         _started = false;
-        _num_clients = 0;
     }
 
     // ─── Main loop — call from Arduino loop() ────────────────────────────────
     void loop() {
+        if (_upstreams_pending.load(std::memory_order_acquire)) {
+            _upstreams_pending.store(false, std::memory_order_relaxed);
+            _apply_upstreams(_pending_hosts, _pending_port);
+        }
         if (!_started) return;
 
         // Accept new connections in server mode
@@ -172,7 +266,9 @@ public:
         // Client mode reconnection (with WiFi check + exponential backoff)
         if (_mode == TCP_IF_MODE_CLIENT && _num_clients == 0) {
             uint32_t now = millis();
-            if (now - _last_reconnect >= _reconnect_interval) {
+            if (_connect_state != TCP_CONNECT_IDLE) {
+                _advance_connect();
+            } else if (_failover_pending || now - _last_reconnect >= _reconnect_interval) {
                 if (WiFi.status() == WL_CONNECTED) {
                     _connect_client();
                 } else {
@@ -181,110 +277,325 @@ public:
                 }
             }
         }
+        if (_mode == TCP_IF_MODE_CLIENT) {
+            if (_num_clients > 0) _check_session();
+            _warm_upstreams();
+        }
+        // Lets Transport fall back to other paths while nobody is connected
+        _online = (_num_clients > 0);
 
-        // Send keepalive (empty HDLC frames) to prevent read timeout on both sides
+        // Send keepalive (empty HDLC frames) to prevent read timeout on both sides.
+        // A client with frames still queued doesn't need one.
         if (_num_clients > 0) {
             uint32_t now = millis();
             if (now - _last_keepalive >= TCP_IF_KEEPALIVE_INTERVAL) {
                 _last_keepalive = now;
-                uint8_t ka[] = { HDLC_FLAG, HDLC_FLAG };
-                for (int i = 0; i < TCP_IF_MAX_CLIENTS; i++) {
-                    if (_clients[i].active && _clients[i].client.connected()) {
-                        _clients[i].client.write(ka, 2);
+                static const uint8_t ka[] = { HDLC_FLAG, HDLC_FLAG };
+                RNS::Bytes frame(ka, sizeof(ka));
+                for (int n = 0; n < _num_clients; n++) {
+                    if (_clients[_active[n]]->tx_count == 0) {
+                        _enqueue(_active[n], frame, false);
                     }
                 }
             }
 
         }
 
-        // Process incoming data from all active clients
-        for (int i = 0; i < TCP_IF_MAX_CLIENTS; i++) {
-            if (!_clients[i].active) continue;
+        // Process incoming data from all active clients. Walked backwards:
+        // a client closed on the way is replaced by one already visited.
+        for (int n = _num_clients - 1; n >= 0; n--) {
+            int i = _active[n];
+            TcpClient& c = *_clients[i];
 
-            if (!_clients[i].client.connected()) {
+            if (!c.client.connected()) {
                 _cleanup_client(i, "disconnected");
                 continue;
             }
 
             // Check read timeout (0 = disabled)
             if (_read_timeout > 0 &&
-                _clients[i].last_activity > 0 &&
-                (millis() - _clients[i].last_activity) > _read_timeout) {
+                c.last_activity > 0 &&
+                (millis() - c.last_activity) > _read_timeout) {
                 _cleanup_client(i, "read timeout");
                 continue;
             }
 
-            // Read available bytes and deframe
-            while (_clients[i].client.available()) {
-                uint8_t byte = _clients[i].client.read();
-                _clients[i].last_activity = millis();
-                _hdlc_deframe(i, byte);
+            // Read available bytes in bulk and deframe
+            int avail = c.client.available();
+            while (avail > 0) {
+                int len = c.client.read(_rx_chunk, avail < TCP_IF_RX_CHUNK ? avail : TCP_IF_RX_CHUNK);
+                if (len <= 0) break;
+                c.last_activity = millis();
+                _hdlc_deframe(i, _rx_chunk, len);
+                if (_clients[i] == nullptr) break;
+                avail = c.client.available();
+            }
+        }
+
+        // Flush everything queued during this loop() iteration, several
+        // frames per sendmsg() so small packets share TCP segments
+        for (int n = _num_clients - 1; n >= 0; n--) {
+            if (_clients[_active[n]]->tx_count > 0) {
+                _flush_client(_active[n]);
             }
         }
     }
 
     // ─── Stats ───────────────────────────────────────────────────────────────
     int  clientCount() const { return _num_clients; }
+    // Client mode: swaps the upstream list at runtime. The list is only
+    // copied here and handed to loop(), which resets the session in use
+    // and dials the new targets before it touches the sockets again; the
+    // interface stays registered, so Transport keeps its paths and links
+    // over it. A DNS lookup lwIP still owes a callback for is left to land.
+    void setUpstreams(const char* target_host, uint16_t target_port) {
+        if (_mode != TCP_IF_MODE_CLIENT) return;
+        strncpy(_pending_hosts, target_host != nullptr ? target_host : "", sizeof(_pending_hosts) - 1);
+        _pending_hosts[sizeof(_pending_hosts) - 1] = '\0';
+        _pending_port = target_port;
+        _upstreams_pending.store(true, std::memory_order_release);
+    }
+
     bool isStarted()   const { return _started; }
     bool isConnected() const { return _num_clients > 0; }
+    // Accepted connections, up to TCP_IF_MAX_CLIENTS; set before start()
+    void setMaxClients(int max_clients) {
+        _max_clients = (max_clients < 1) ? 1 : (max_clients > TCP_IF_MAX_CLIENTS ? TCP_IF_MAX_CLIENTS : max_clients);
+    }
+    int  maxClients() const { return _max_clients; }
+    int  upstreamCount() const { return _num_upstreams; }
+    // Upstream in use, or the one the next attempt goes to
+    const char* upstreamHost() const { return _num_upstreams > 0 ? _upstreams[_upstream].host : ""; }
+    uint16_t upstreamPort()    const { return _num_upstreams > 0 ? _upstreams[_upstream].port : 0; }
     void setReadTimeout(uint32_t timeout_ms) { _read_timeout = timeout_ms; }
+    uint32_t txDrops() const { return _tx_drops; }
 
 protected:
+    // ─── TransportEndpoint: runs on the transport task ───────────────────────
+    virtual void deliver_incoming(const RNS::Bytes& data, int8_t client) override {
+        // Same echo-prevention context as the synchronous path below: any
+        // send_outgoing() triggered by this inbound packet skips its sender.
+        _last_rx_client_idx = client;
+        handle_incoming(data);
+        _last_rx_client_idx = -1;
+    }
+
+    // ─── TransportEndpoint: runs on loop() ───────────────────────────────────
+    virtual void transmit_now(const RNS::Bytes& data, int8_t client) override {
+        _write_frame(data, client);
+    }
+
     // ─── RNS InterfaceImpl: outgoing packet from RNS Transport ───────────────
     virtual void send_outgoing(const RNS::Bytes& data) override {
         if (!_started || _num_clients == 0) return;
 
-        // HDLC frame the data
-        uint8_t frame_buf[TCP_IF_HW_MTU * 2 + 4]; // worst case: every byte escaped + 2 flags
-        uint16_t flen = 0;
+        if (transport_task_is_current()) {
+            // Socket writes stay on loop(); hand the frame over
+            transport_task_submit_tx(this, data, _last_rx_client_idx);
+        } else {
+            _write_frame(data, _last_rx_client_idx);
+            yield(); // feed WDT between TCP writes and RNS processing
+        }
+
+        // Post-send housekeeping
+        InterfaceImpl::handle_outgoing(data);
+    }
+
+    // ─── RNS InterfaceImpl: incoming packet to RNS Transport ─────────────────
+    virtual void handle_incoming(const RNS::Bytes& data) override {
+        TRACEF("TcpInterface.handle_incoming: (%u bytes)", data.size());
+        InterfaceImpl::handle_incoming(data);
+    }
+
+private:
+    // ─── HDLC frame and queue to all clients except skip_idx ─────────────────
+    // The frame is built once and shared by every client queue, the actual
+    // socket writes happen in _flush_client() from loop().
+    void _write_frame(const RNS::Bytes& data, int skip_idx) {
+        if (!_started || _num_clients == 0) return;
+
+        // HDLC frame the data. Escapes are counted first so the frame, which
+        // stays in the client queues until written, is allocated at its exact
+        // size; the bytes between escapes are copied in runs.
+        const uint8_t* src = data.data();
+        size_t escapes = 0;
+        for (size_t i = 0; i < data.size(); i++) {
+            if (src[i] == HDLC_FLAG || src[i] == HDLC_ESC) escapes++;
+        }
+        RNS::Bytes frame;
+        uint8_t* frame_buf = frame.writable(data.size() + escapes + 2);
+        size_t flen = 0;
 
         frame_buf[flen++] = HDLC_FLAG;
+        size_t run = 0;
         for (size_t i = 0; i < data.size(); i++) {
-            uint8_t b = data.data()[i];
-            if (b == HDLC_FLAG || b == HDLC_ESC) {
-                frame_buf[flen++] = HDLC_ESC;
-                frame_buf[flen++] = b ^ HDLC_ESC_MASK;
-            } else {
-                frame_buf[flen++] = b;
-            }
-            if (flen >= sizeof(frame_buf) - 4) break; // safety
+            uint8_t b = src[i];
+            if (b != HDLC_FLAG && b != HDLC_ESC) continue;
+            memcpy(frame_buf + flen, src + run, i - run);
+            flen += i - run;
+            frame_buf[flen++] = HDLC_ESC;
+            frame_buf[flen++] = b ^ HDLC_ESC_MASK;
+            run = i + 1;
         }
+        memcpy(frame_buf + flen, src + run, data.size() - run);
+        flen += data.size() - run;
         frame_buf[flen++] = HDLC_FLAG;
 
-        // Send to all connected clients EXCEPT the one that sent this packet.
+        // Announces are the first thing to go when a client falls behind.
+        // With IFAC the header is masked, so those frames are never classed
+        // as announces.
+        bool announce = data.size() > 0 && (data.data()[0] & 0x80) == 0 &&
+                        (data.data()[0] & 0x03) == RNS::Type::Packet::ANNOUNCE;
+
+        // Queue to all connected clients EXCEPT the one that sent this packet.
         // v1.0.10: Echo prevention — if this send_outgoing was triggered by
         // Transport forwarding a packet received from client N, skip client N
         // to prevent echo-back that floods TCP buffers and stalls resource transfers.
-        for (int i = 0; i < TCP_IF_MAX_CLIENTS; i++) {
-            if (i == _last_rx_client_idx) {
+        for (int n = 0; n < _num_clients; n++) {
+            int i = _active[n];
+            if (i == skip_idx) {
                 continue;  // Don't echo back to sender
             }
-            if (_clients[i].active && _clients[i].client.connected()) {
-                size_t written = _clients[i].client.write(frame_buf, flen);
-                if (written == 0) {
-                    _cleanup_client(i, "write failed");
-                } else if (written < flen) {
-                    Serial.printf("[TcpIF] PARTIAL write to client %d: %u/%u bytes\r\n", i, (unsigned)written, (unsigned)flen);
-                }
+            _enqueue(i, frame, announce);
+        }
+    }
+
+    // ─── Per-client send queue ───────────────────────────────────────────────
+    // When the queue fills up, announces are dropped before anything else:
+    // new announces once the backlog reaches TCP_IF_TX_ANNOUNCE_LIMIT, and
+    // queued (not yet started) announces to make room for other traffic.
+    bool _enqueue(int idx, const RNS::Bytes& frame, bool announce) {
+        TcpClient& c = *_clients[idx];
+        if (announce && c.tx_count >= TCP_IF_TX_ANNOUNCE_LIMIT) {
+            _tx_drops++;
+            return false;
+        }
+        if (c.tx_count >= TCP_IF_TX_QUEUE && !_evict_announce(c)) {
+            _tx_drops++;
+            ringlog_printf("[TcpIF] Client %d send queue full, dropped %u byte frame\r\n",
+                           idx, (unsigned)frame.size());
+            return false;
+        }
+        if (c.tx_count == 0) {
+            // Stall timer starts when the queue becomes non-empty
+            c.tx_progress = millis();
+        }
+        TcpTxFrame& slot = c.txq[(c.tx_head + c.tx_count) % TCP_IF_TX_QUEUE];
+        slot.data = frame;
+        slot.announce = announce;
+        c.tx_count++;
+        return true;
+    }
+
+    bool _evict_announce(TcpClient& c) {
+        // The head frame may be partially written and has to stay
+        for (uint8_t k = (c.tx_offset > 0) ? 1 : 0; k < c.tx_count; k++) {
+            if (!c.txq[(c.tx_head + k) % TCP_IF_TX_QUEUE].announce) continue;
+            for (; k + 1 < c.tx_count; k++) {
+                c.txq[(c.tx_head + k) % TCP_IF_TX_QUEUE] = c.txq[(c.tx_head + k + 1) % TCP_IF_TX_QUEUE];
             }
+            c.txq[(c.tx_head + k) % TCP_IF_TX_QUEUE].data.clear();
+            c.tx_count--;
+            _tx_drops++;
+            return true;
         }
-        yield(); // feed WDT between TCP writes and RNS processing
+        return false;
+    }
 
-        // Post-send housekeeping
-        InterfaceImpl::handle_outgoing(data);
+    void _reset_tx(TcpClient& c) {
+        for (int k = 0; k < TCP_IF_TX_QUEUE; k++) {
+            c.txq[k].data.clear();
+        }
+        c.tx_head = 0;
+        c.tx_count = 0;
+        c.tx_offset = 0;
+        c.tx_progress = 0;
+        c.tx_backlog_at = 0;
+        c.tx_backlog_bytes = 0;
     }
 
-    // ─── RNS InterfaceImpl: incoming packet to RNS Transport ─────────────────
-    virtual void handle_incoming(const RNS::Bytes& data) override {
-        TRACEF("TcpInterface.handle_incoming: (%u bytes)", data.size());
-        InterfaceImpl::handle_incoming(data);
+    // ─── Non-blocking flush of a client's send queue ─────────────────────────
+    void _flush_client(int idx) {
+        TcpClient& c = *_clients[idx];
+        int fd = c.client.fd();
+        if (fd < 0) return;
+
+        while (c.tx_count > 0) {
+            // Gather up to TCP_IF_TX_IOV queued frames into one write
+            struct iovec iov[TCP_IF_TX_IOV];
+            int iovcnt = 0;
+            size_t total = 0;
+            for (uint8_t k = 0; k < c.tx_count && iovcnt < TCP_IF_TX_IOV; k++) {
+                const RNS::Bytes& data = c.txq[(c.tx_head + k) % TCP_IF_TX_QUEUE].data;
+                size_t offset = (k == 0) ? c.tx_offset : 0;
+                iov[iovcnt].iov_base = (void*)(data.data() + offset);
+                iov[iovcnt].iov_len = data.size() - offset;
+                total += iov[iovcnt].iov_len;
+                iovcnt++;
+            }
+            struct msghdr msg;
+            memset(&msg, 0, sizeof(msg));
+            msg.msg_iov = iov;
+            msg.msg_iovlen = iovcnt;
+
+            ssize_t sent = sendmsg(fd, &msg, MSG_DONTWAIT);
+            if (sent < 0) {
+                if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                    _cleanup_client(idx, "write failed");
+                    return;
+                }
+                sent = 0;
+            }
+            if (sent == 0) {
+                // Socket buffer is full — retry on the next loop()
+                if (c.tx_backlog_at == 0) {
+                    c.tx_backlog_at = millis();
+                    c.tx_backlog_bytes = 0;
+                }
+                if (millis() - c.tx_progress > TCP_IF_WRITE_TIMEOUT) {
+                    _cleanup_client(idx, "write stalled");
+                }
+                return;
+            }
+            c.tx_progress = millis();
+            if (c.tx_backlog_at != 0) c.tx_backlog_bytes += sent;
+
+            // Retire completely written frames
+            size_t remaining = (size_t)sent;
+            while (remaining > 0) {
+                TcpTxFrame& head = c.txq[c.tx_head];
+                size_t left = head.data.size() - c.tx_offset;
+                if (remaining < left) {
+                    c.tx_offset += remaining;
+                    break;
+                }
+                remaining -= left;
+                head.data.clear();
+                c.tx_head = (c.tx_head + 1) % TCP_IF_TX_QUEUE;
+                c.tx_count--;
+                c.tx_offset = 0;
+            }
+            if ((size_t)sent < total) {
+                // Partial write, the rest goes out on the next loop()
+                if (c.tx_backlog_at == 0) {
+                    c.tx_backlog_at = c.tx_progress;
+                    c.tx_backlog_bytes = 0;
+                }
+                return;
+            }
+        }
+        // Backlog drained, the rate it drained at is what the link achieved
+        if (c.tx_backlog_at != 0) {
+            uint32_t elapsed = millis() - c.tx_backlog_at;
+            if (elapsed >= TCP_IF_RATE_MIN_MS) throughput_sample(c.tx_backlog_bytes, elapsed / 1000.0);
+            c.tx_backlog_at = 0;
+        }
     }
 
-private:
     // ─── Cleanup a client slot, freeing all lwIP resources ───────────────────
     void _cleanup_client(int idx, const char* reason) {
-        TcpClient& c = _clients[idx];
-        if (!c.active) return;
+        if (_clients[idx] == nullptr) return;
+        TcpClient& c = *_clients[idx];
 
         uint32_t heap_before = ESP.getFreeHeap();
 
@@ -300,187 +611,560 @@ private:
         }
 
         c.client.stop();
-        c.client = WiFiClient();  // Release any residual shared_ptr state
-        c.active = false;
-        c.in_frame = false;
-        c.escape = false;
-        c.truncated = false;
-        c.rxlen = 0;
-        _num_clients--;
+        // Releases the WiFiClient state, the queued frames and the slot itself
+        _free_client(idx);
 
         uint32_t heap_after = ESP.getFreeHeap();
-        Serial.printf("[TcpIF] Client %d %s (heap: %u -> %u, delta: %+d)\r\n",
-                      idx, reason, heap_before, heap_after,
-                      (int)(heap_after - heap_before));
-    }
-
-    // ─── HDLC byte-level deframing ──────────────────────────────────────────
-    void _hdlc_deframe(int idx, uint8_t byte) {
-        TcpClient& c = _clients[idx];
-
-        if (byte == HDLC_FLAG) {
-            if (c.in_frame && c.rxlen > 0) {
-                // v1.0.12: If the frame exceeded the buffer, drop it entirely
-                // instead of delivering a truncated/corrupt packet to Transport.
-                if (c.truncated) {
-                    Serial.printf("[TcpIF] DROPPED oversized frame from client %d (>%d bytes, buffered %u)\r\n",
-                                  idx, TCP_IF_HW_MTU, c.rxlen);
-                    c.truncated = false;
-                    c.rxlen = 0;
-                } else {
-                    // End of frame — deliver to RNS
-                    // v1.0.10: Set _last_rx_client_idx so send_outgoing() can
-                    // skip echoing this packet back to the client that sent it.
-                    // The entire call chain (handle_incoming → Transport::inbound
-                    // → transmit → send_outgoing) is synchronous, so this is safe.
-                    RNS::Bytes data(c.rxbuf, c.rxlen);
-                    _last_rx_client_idx = idx;
-                    handle_incoming(data);
-                    _last_rx_client_idx = -1;
-                    c.rxlen = 0;
-                }
+        ringlog_printf("[TcpIF] Client %d %s (heap: %u -> %u, delta: %+d)\r\n",
+                       idx, reason, heap_before, heap_after,
+                       (int)(heap_after - heap_before));
+
+        if (_mode == TCP_IF_MODE_CLIENT && _started) {
+            if (_session_proven) {
+                // Hot failover: reconnect right away, to the best upstream
+                _failover_pending = true;
+                _last_reconnect = millis();
+            } else {
+                // Dropped before it settled, count it against the upstream
+                _upstream_failed();
+            }
+        }
+    }
+
+    // ─── HDLC deframing ─────────────────────────────────────────────────────
+    // Scans each chunk for HDLC_FLAG/HDLC_ESC with memchr() and copies the
+    // plain runs in between with a single memcpy(), instead of handling the
+    // stream one byte at a time.
+    void _hdlc_deframe(int idx, const uint8_t* data, size_t len) {
+        TcpClient& c = *_clients[idx];
+        const uint8_t* p = data;
+        const uint8_t* end = data + len;
+        const uint8_t* flag = (const uint8_t*)memchr(p, HDLC_FLAG, len);
+
+        while (p < end) {
+            if (!c.in_frame) {
+                // Anything before the first flag is not part of a frame
+                if (flag == nullptr) break;
+                p = flag;
+            }
+            if (p == flag) {
+                _hdlc_frame_boundary(idx);
+                p++;
+                flag = (const uint8_t*)memchr(p, HDLC_FLAG, end - p);
+                continue;
             }
-            c.in_frame = true;
-            c.escape = false;
-            c.truncated = false;
-            c.rxlen = 0;
-        } else if (c.in_frame) {
             if (c.escape) {
-                byte ^= HDLC_ESC_MASK;
+                uint8_t byte = *p++ ^ HDLC_ESC_MASK;
                 c.escape = false;
-                if (c.rxlen < TCP_IF_HW_MTU) {
-                    c.rxbuf[c.rxlen++] = byte;
-                } else {
-                    c.truncated = true;
-                }
-            } else if (byte == HDLC_ESC) {
+                _hdlc_append(c, &byte, 1);
+                continue;
+            }
+            const uint8_t* stop = (flag != nullptr) ? flag : end;
+            const uint8_t* esc = (const uint8_t*)memchr(p, HDLC_ESC, stop - p);
+            if (esc != nullptr) stop = esc;
+            _hdlc_append(c, p, stop - p);
+            p = stop;
+            if (esc != nullptr) {
                 c.escape = true;
+                p++;
+            }
+        }
+    }
+
+    void _hdlc_append(TcpClient& c, const uint8_t* src, size_t len) {
+        if (len == 0) return;
+        if (c.rxbuf == nullptr) {
+            // Allocated on the first payload byte so keepalive flags cost nothing
+            c.rxbuf = c.frame.writable(TCP_IF_HW_MTU);
+        }
+        size_t room = TCP_IF_HW_MTU - c.rxlen;
+        if (len > room) {
+            len = room;
+            c.truncated = true;
+        }
+        memcpy(c.rxbuf + c.rxlen, src, len);
+        c.rxlen += len;
+    }
+
+    // A flag closes the current frame (if any) and opens the next one
+    void _hdlc_frame_boundary(int idx) {
+        TcpClient& c = *_clients[idx];
+        if (c.in_frame && c.rxlen > 0) {
+            // v1.0.12: If the frame exceeded the buffer, drop it entirely
+            // instead of delivering a truncated/corrupt packet to Transport.
+            if (c.truncated) {
+                ringlog_printf("[TcpIF] DROPPED oversized frame from client %d (>%d bytes, buffered %u)\r\n",
+                               idx, TCP_IF_HW_MTU, c.rxlen);
             } else {
-                if (c.rxlen < TCP_IF_HW_MTU) {
-                    c.rxbuf[c.rxlen++] = byte;
+                // End of frame — deliver to RNS
+                // v1.0.10: Set _last_rx_client_idx so send_outgoing() can
+                // skip echoing this packet back to the client that sent it.
+                // The entire call chain (handle_incoming → Transport::inbound
+                // → transmit → send_outgoing) is synchronous, so this is safe.
+                // With the transport task running, the frame is queued
+                // together with idx and the context is restored in
+                // deliver_incoming().
+                // The frame buffer itself is handed over, the next frame gets
+                // a fresh one.
+                c.frame.resize(c.rxlen);
+                RNS::Bytes data(c.frame);
+                c.frame.clear();
+                c.rxbuf = nullptr;
+                if (transport_task_running()) {
+                    transport_task_submit_rx(this, data, idx);
                 } else {
-                    c.truncated = true;
+                    _last_rx_client_idx = idx;
+                    handle_incoming(data);
+                    _last_rx_client_idx = -1;
                 }
             }
         }
+        c.in_frame = true;
+        c.escape = false;
+        c.truncated = false;
+        c.rxlen = 0;
+    }
+
+    // ─── Client slot pool ───────────────────────────────────────────────────
+    // A slot is allocated per connection, from PSRAM on boards that have it
+    // (placed_allocate() falls back to the default heap). _active lists the
+    // slots in use so the per-loop() work is O(active clients). Returns
+    // nullptr when neither heap has room, the caller drops the connection.
+    TcpClient* _alloc_client(int idx) {
+        void* mem = RNS::Utilities::OS::placed_allocate(sizeof(TcpClient), RNS::Utilities::OS::PLACE_COLD);
+        if (mem == nullptr) return nullptr;
+        TcpClient* c = new (mem) TcpClient();
+        c->in_frame = false;
+        c->escape = false;
+        c->truncated = false;
+        c->rxbuf = nullptr;
+        c->rxlen = 0;
+        _reset_tx(*c);
+        c->last_activity = millis();
+        c->list_pos = _num_clients;
+        _active[_num_clients++] = idx;
+        _clients[idx] = c;
+        return c;
+    }
+
+    void _free_client(int idx) {
+        TcpClient* c = _clients[idx];
+        uint8_t last = _active[--_num_clients];
+        _active[c->list_pos] = last;
+        _clients[last]->list_pos = c->list_pos;
+        _clients[idx] = nullptr;
+        c->~TcpClient();
+        ::operator delete(c);
     }
 
     // ─── Accept a new server-mode client ─────────────────────────────────────
     void _accept_client(WiFiClient& newClient) {
-        // Find a free slot
-        for (int i = 0; i < TCP_IF_MAX_CLIENTS; i++) {
-            if (!_clients[i].active) {
-                // Defensive: force-release any residual lwIP resources in this slot
-                // before assigning the new client (prevents PCB/buffer leaks)
-                int fd = _clients[i].client.fd();
-                if (fd >= 0) {
-                    struct linger lin;
-                    lin.l_onoff = 1;
-                    lin.l_linger = 0;
-                    setsockopt(fd, SOL_SOCKET, SO_LINGER, &lin, sizeof(lin));
-                    _clients[i].client.stop();
+        if (_num_clients < _max_clients) {
+            for (int i = 0; i < TCP_IF_MAX_CLIENTS; i++) {
+                if (_clients[i] != nullptr) continue;
+                TcpClient* slot = _alloc_client(i);
+                if (slot == nullptr) {
+                    ringlog_printf("[TcpIF] No memory for client slot, rejecting connection\r\n");
+                    newClient.stop();
+                    return;
                 }
-                _clients[i].client = WiFiClient();  // Reset to clean state
-
-                _clients[i].client = newClient;
-                _clients[i].client.setNoDelay(true);
-                _clients[i].client.setTimeout(TCP_IF_WRITE_TIMEOUT / 1000);
-                _clients[i].active = true;
-                _clients[i].in_frame = false;
-                _clients[i].escape = false;
-                _clients[i].truncated = false;
-                _clients[i].rxlen = 0;
-                _clients[i].last_activity = millis();
-                _num_clients++;
-                Serial.printf("[TcpIF] Client %d connected from %s\r\n",
-                              i, _clients[i].client.remoteIP().toString().c_str());
+                TcpClient& c = *slot;
+                c.client = newClient;
+                c.client.setNoDelay(true);
+                c.client.setTimeout(TCP_IF_WRITE_TIMEOUT / 1000);
+                ringlog_printf("[TcpIF] Client %d connected from %s (%d/%d)\r\n",
+                               i, c.client.remoteIP().toString().c_str(), _num_clients, _max_clients);
                 return;
             }
         }
         // No free slots — reject
-        Serial.println("[TcpIF] Max clients reached, rejecting connection");
+        ringlog_printf("[TcpIF] Max clients reached, rejecting connection\r\n");
         newClient.stop();
     }
 
+    // ─── Client-mode upstream list ──────────────────────────────────────────
+    // Runs at the top of loop() for a list handed over by setUpstreams()
+    void _apply_upstreams(const char* target_host, uint16_t target_port) {
+        bool started = _started;
+        stop();
+        _parse_upstreams(target_host, target_port);
+        _upstream = 0;
+        _round_failures = 0;
+        _consecutive_failures = 0;
+        _reconnect_interval = TCP_IF_RECONNECT_MIN;
+        _session_proven = false;
+        _warm_index = 0;
+        if (started) start();
+    }
+
+    // The target host is a comma separated list of host[:port] entries, a
+    // missing port falls back to the configured backbone port.
+    void _parse_upstreams(const char* list, uint16_t default_port) {
+        _num_upstreams = 0;
+        if (list == nullptr) return;
+        const char* p = list;
+        while (*p != '\0' && _num_upstreams < TCP_IF_MAX_UPSTREAMS) {
+            const char* end = strchr(p, ',');
+            if (end == nullptr) end = p + strlen(p);
+            while (p < end && *p == ' ') p++;
+            const char* last = end;
+            while (last > p && last[-1] == ' ') last--;
+            const char* colon = (const char*)memchr(p, ':', last - p);
+            const char* host_end = (colon != nullptr) ? colon : last;
+            size_t len = host_end - p;
+            if (len > 0 && len < sizeof(_upstreams[0].host)) {
+                TcpUpstream& u = _upstreams[_num_upstreams];
+                memcpy(u.host, p, len);
+                u.host[len] = '\0';
+                u.port = (colon != nullptr) ? (uint16_t)atoi(colon + 1) : default_port;
+                if (u.port == 0) u.port = default_port;
+                u.ip = IPAddress((uint32_t)0);
+                u.rtt_ms = 0;
+                u.failures = 0;
+                _num_upstreams++;
+            }
+            p = (*end == ',') ? end + 1 : end;
+        }
+    }
+
+    static uint32_t _upstream_rank(const TcpUpstream& u) {
+        return u.rtt_ms != 0 ? u.rtt_ms : TCP_IF_UPSTREAM_RTT_DEFAULT;
+    }
+
+    // Fewest consecutive failures first, then lowest connect RTT
+    uint8_t _select_upstream() const {
+        uint8_t best = 0;
+        for (uint8_t i = 1; i < _num_upstreams; i++) {
+            const TcpUpstream& u = _upstreams[i];
+            const TcpUpstream& b = _upstreams[best];
+            if (u.failures < b.failures ||
+                (u.failures == b.failures && _upstream_rank(u) < _upstream_rank(b))) {
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    // Keeps standby upstreams resolved while connected, one lookup at a time
+    void _warm_upstreams() {
+        if (_warming) {
+            if (!_dns_done) return;
+            TcpUpstream& w = _upstreams[_warm_index];
+            if (_dns_ip != 0) w.ip = IPAddress(_dns_ip);
+            _warming = false;
+            return;
+        }
+        if (_num_upstreams < 2 || _num_clients == 0) return;
+        uint32_t now = millis();
+        if (now - _last_warm < TCP_IF_WARM_INTERVAL / _num_upstreams) return;
+        _last_warm = now;
+        _warm_index = (_warm_index + 1) % _num_upstreams;
+        if (_warm_index == _upstream) _warm_index = (_warm_index + 1) % _num_upstreams;
+        _warming = _start_dns(_upstreams[_warm_index].host);
+    }
+
     // ─── Client-mode outbound connection ─────────────────────────────────────
+    // Starts a connection attempt to the best upstream, cached IP first, then
+    // DNS. The attempt is carried on by _advance_connect() from loop().
     void _connect_client() {
-        if (_target_host[0] == '\0') {
-            Serial.println("[TcpIF] No target host configured for client mode");
+        if (_num_upstreams == 0) {
+            ringlog_printf("[TcpIF] No target host configured for client mode\r\n");
+            _last_reconnect = millis();
             return;
         }
+        if (_connect_state != TCP_CONNECT_IDLE) return;
+        // A standby lookup has to land first, lwIP owns the callback until then
+        if (_dns_pending) return;
+        if (_warming) _warm_upstreams();
 
-        WiFiClient client;
-        client.setTimeout(TCP_IF_CONNECT_TIMEOUT / 1000);
+        _failover_pending = false;
+        _upstream = _select_upstream();
+        TcpUpstream& u = _upstreams[_upstream];
+        if (u.ip != (uint32_t)0) {
+            ringlog_printf("[TcpIF] Connecting to %s:%d (cached IP)...\r\n", u.host, u.port);
+            _connect_cached = true;
+            if (_begin_connect(u.ip)) return;
+            u.ip = (uint32_t)0;
+            ringlog_printf("[TcpIF] Cached IP failed, retrying with DNS\r\n");
+        }
+        _connect_cached = false;
+        _begin_resolve();
+    }
 
-        bool connected = false;
+    static void _dns_found(const char* name, const ip_addr_t* ipaddr, void* arg) {
+        // Runs in the lwIP thread. arg is the slot in the low byte and its
+        // generation above, see tcp_dns_slots
+        uint32_t token = (uint32_t)(uintptr_t)arg;
+        uint8_t slot = token & 0xFF;
+        if (slot >= TCP_IF_DNS_SLOTS) return;
+        portENTER_CRITICAL(&tcp_dns_mux);
+        TcpInterface* self = tcp_dns_slots[slot].owner;
+        if (self != nullptr && (tcp_dns_slots[slot].generation & 0xFFFFFF) == (token >> 8)) {
+            self->_dns_ip = (ipaddr != nullptr) ? ip4_addr_get_u32(ip_2_ip4(ipaddr)) : 0;
+            self->_dns_done = true;
+            self->_dns_pending = false;
+        }
+        portEXIT_CRITICAL(&tcp_dns_mux);
+    }
 
-        // Try cached IP first (avoids DNS lookup on every reconnect)
-        if (_resolved_ip != (uint32_t)0) {
-            Serial.printf("[TcpIF] Connecting to %s:%d (cached IP)...\r\n", _target_host, _target_port);
-            connected = client.connect(_resolved_ip, _target_port);
-            if (!connected) {
-                // Cached IP failed — clear cache and try fresh DNS
-                _resolved_ip = (uint32_t)0;
-                Serial.println("[TcpIF] Cached IP failed, retrying with DNS");
+    // Claims a callback slot on first use, -1 when all are taken
+    int8_t _dns_token_slot() {
+        if (_dns_slot >= 0) return _dns_slot;
+        portENTER_CRITICAL(&tcp_dns_mux);
+        for (int8_t i = 0; i < TCP_IF_DNS_SLOTS; i++) {
+            if (tcp_dns_slots[i].owner == nullptr) {
+                tcp_dns_slots[i].owner = this;
+                _dns_slot = i;
+                break;
             }
         }
+        portEXIT_CRITICAL(&tcp_dns_mux);
+        return _dns_slot;
+    }
 
-        if (!connected) {
-            Serial.printf("[TcpIF] Connecting to %s:%d (DNS)...\r\n", _target_host, _target_port);
-            IPAddress resolved;
-            if (WiFi.hostByName(_target_host, resolved)) {
-                _resolved_ip = resolved;
-                Serial.printf("[TcpIF] Resolved %s -> %s\r\n", _target_host, resolved.toString().c_str());
-                connected = client.connect(resolved, _target_port);
-            } else {
-                Serial.printf("[TcpIF] DNS failed for %s\r\n", _target_host);
+    // Returns true if the result is still to come from the lwIP thread,
+    // otherwise _dns_done/_dns_ip already hold it
+    bool _start_dns(const char* host) {
+        ip_addr_t addr;
+        _dns_done = false;
+        _dns_ip = 0;
+        int8_t slot = _dns_token_slot();
+        if (slot < 0) {
+            ringlog_printf("[TcpIF] No DNS callback slot free\r\n");
+            _dns_done = true;
+            return false;
+        }
+        void* token = (void*)(uintptr_t)(((tcp_dns_slots[slot].generation & 0xFFFFFF) << 8) | (uint32_t)slot);
+        _dns_pending = true;
+        #if LWIP_TCPIP_CORE_LOCKING
+            LOCK_TCPIP_CORE();
+        #endif
+        err_t err = dns_gethostbyname(host, &addr, &TcpInterface::_dns_found, token);
+        #if LWIP_TCPIP_CORE_LOCKING
+            UNLOCK_TCPIP_CORE();
+        #endif
+        if (err == ERR_INPROGRESS) return true;
+        _dns_pending = false;
+        if (err == ERR_OK) {
+            // Cached by lwIP or a literal address, no callback follows
+            _dns_ip = ip4_addr_get_u32(ip_2_ip4(&addr));
+        }
+        _dns_done = true;
+        return false;
+    }
+
+    void _begin_resolve() {
+        TcpUpstream& u = _upstreams[_upstream];
+        ringlog_printf("[TcpIF] Connecting to %s:%d (DNS)...\r\n", u.host, u.port);
+        _connect_state = TCP_CONNECT_RESOLVING;
+        _connect_started = millis();
+        _start_dns(u.host);
+    }
+
+    bool _begin_connect(const IPAddress& ip) {
+        int fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (fd < 0) {
+            ringlog_printf("[TcpIF] socket() failed, errno %d\r\n", errno);
+            return false;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = (uint32_t)ip;
+        addr.sin_port = htons(_upstreams[_upstream].port);
+        int res = connect(fd, (struct sockaddr*)&addr, sizeof(addr));
+        if (res < 0 && errno != EINPROGRESS) {
+            ringlog_printf("[TcpIF] connect() failed, errno %d\r\n", errno);
+            close(fd);
+            return false;
+        }
+        _connect_fd = fd;
+        _connect_state = TCP_CONNECT_CONNECTING;
+        _connect_started = millis();
+        return true;
+    }
+
+    // One non-blocking step of the attempt in progress
+    void _advance_connect() {
+        TcpUpstream& u = _upstreams[_upstream];
+
+        if (_connect_state == TCP_CONNECT_RESOLVING) {
+            // No local timeout, lwIP always reports back and a lookup still
+            // in flight would otherwise land on the next one
+            if (_dns_done) {
+                if (_dns_ip != 0) {
+                    u.ip = IPAddress(_dns_ip);
+                    ringlog_printf("[TcpIF] Resolved %s -> %s\r\n", u.host, u.ip.toString().c_str());
+                    if (!_begin_connect(u.ip)) _connect_failed();
+                } else {
+                    ringlog_printf("[TcpIF] DNS failed for %s\r\n", u.host);
+                    _connect_failed();
+                }
             }
+            return;
         }
 
-        if (connected) {
-            client.setNoDelay(true);
-            client.setTimeout(TCP_IF_WRITE_TIMEOUT / 1000);
-            _clients[0].client = client;
-            _clients[0].active = true;
-            _clients[0].in_frame = false;
-            _clients[0].escape = false;
-            _clients[0].truncated = false;
-            _clients[0].rxlen = 0;
-            _clients[0].last_activity = millis();
-            _num_clients = 1;
-            _consecutive_failures = 0;
-            _reconnect_interval = TCP_IF_RECONNECT_MIN;
-            Serial.printf("[TcpIF] Connected to backbone at %s:%d\r\n",
-                          _target_host, _target_port);
-        } else {
-            _consecutive_failures++;
-            // Exponential backoff: 10s -> 20s -> 40s -> 80s -> 120s (max)
-            _reconnect_interval = _reconnect_interval * 2;
-            if (_reconnect_interval > TCP_IF_RECONNECT_MAX) {
-                _reconnect_interval = TCP_IF_RECONNECT_MAX;
+        if (_connect_state == TCP_CONNECT_CONNECTING) {
+            bool timed_out = (millis() - _connect_started >= TCP_IF_CONNECT_TIMEOUT);
+            fd_set wfds;
+            FD_ZERO(&wfds);
+            FD_SET(_connect_fd, &wfds);
+            struct timeval tv = {0, 0};
+            int ready = select(_connect_fd + 1, nullptr, &wfds, nullptr, &tv);
+            if (ready > 0) {
+                int so_error = 0;
+                socklen_t len = sizeof(so_error);
+                getsockopt(_connect_fd, SOL_SOCKET, SO_ERROR, &so_error, &len);
+                if (so_error == 0) {
+                    _connect_succeeded();
+                    return;
+                }
+                ringlog_printf("[TcpIF] Connect to %s:%d failed, error %d\r\n", u.host, u.port, so_error);
+            } else if (ready == 0 && !timed_out) {
+                return;
             }
-            Serial.printf("[TcpIF] Failed to connect to %s:%d (attempt %d, next retry in %ds)\r\n",
-                          _target_host, _target_port, _consecutive_failures,
-                          _reconnect_interval / 1000);
+            close(_connect_fd);
+            _connect_fd = -1;
+            _connect_state = TCP_CONNECT_IDLE;
+            if (_connect_cached) {
+                // Cached IP failed — clear cache and try fresh DNS
+                u.ip = (uint32_t)0;
+                _connect_cached = false;
+                ringlog_printf("[TcpIF] Cached IP failed, retrying with DNS\r\n");
+                _begin_resolve();
+            } else {
+                _connect_failed();
+            }
+        }
+    }
+
+    void _connect_succeeded() {
+        int fd = _connect_fd;
+        _connect_fd = -1;
+        _connect_state = TCP_CONNECT_IDLE;
+        // WiFiClient expects a blocking socket, as after its own connect()
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) & ~O_NONBLOCK);
+
+        // Handshake time, smoothed 1/4 like the RNS link RTT
+        TcpUpstream& u = _upstreams[_upstream];
+        uint32_t rtt = millis() - _connect_started;
+        if (rtt == 0) rtt = 1;
+        u.rtt_ms = (u.rtt_ms == 0) ? rtt : (u.rtt_ms * 3 + rtt) / 4;
+        // The handshake is the one round trip seen from here
+        rtt_sample(rtt / 1000.0);
+
+        TcpClient* slot = _alloc_client(0);
+        if (slot == nullptr) {
+            ringlog_printf("[TcpIF] No memory for client slot, dropping connection\r\n");
+            close(fd);
+            _connect_failed();
+            return;
         }
+        TcpClient& c = *slot;
+        c.client = WiFiClient(fd);
+        c.client.setNoDelay(true);
+        c.client.setTimeout(TCP_IF_WRITE_TIMEOUT / 1000);
+        // Backoff and failure counts are only reset once the session has
+        // lasted TCP_IF_RECONNECT_MIN, see _check_session()
+        _session_proven = false;
+        _connected_at = millis();
         _last_reconnect = millis();
+        ringlog_printf("[TcpIF] Connected to backbone at %s:%d (rtt %ums)\r\n",
+                       u.host, u.port, rtt);
+    }
+
+    // Called from loop() while connected
+    void _check_session() {
+        if (_session_proven || millis() - _connected_at < TCP_IF_RECONNECT_MIN) return;
+        _session_proven = true;
+        _upstreams[_upstream].failures = 0;
+        _round_failures = 0;
+        _consecutive_failures = 0;
+        _reconnect_interval = TCP_IF_RECONNECT_MIN;
+    }
+
+    void _connect_failed() {
+        if (_connect_fd >= 0) {
+            close(_connect_fd);
+            _connect_fd = -1;
+        }
+        _connect_state = TCP_CONNECT_IDLE;
+        _upstream_failed();
+    }
+
+    // Moves straight on to the next upstream, backs off once all have failed
+    void _upstream_failed() {
+        TcpUpstream& u = _upstreams[_upstream];
+        if (u.failures < 255) u.failures++;
+        _consecutive_failures++;
+        _last_reconnect = millis();
+        if (++_round_failures < _num_upstreams) {
+            _failover_pending = true;
+            ringlog_printf("[TcpIF] Upstream %s:%d failed, failing over\r\n", u.host, u.port);
+            return;
+        }
+        _round_failures = 0;
+        _failover_pending = false;
+        // Exponential backoff: 10s -> 20s -> 40s -> 80s -> 120s (max)
+        _reconnect_interval = _reconnect_interval * 2;
+        if (_reconnect_interval > TCP_IF_RECONNECT_MAX) {
+            _reconnect_interval = TCP_IF_RECONNECT_MAX;
+        }
+        ringlog_printf("[TcpIF] Failed to connect to %s:%d (attempt %d, next retry in %ds)\r\n",
+                       u.host, u.port, _consecutive_failures,
+                       _reconnect_interval / 1000);
+    }
+
+    void _abort_connect() {
+        if (_connect_fd >= 0) {
+            close(_connect_fd);
+            _connect_fd = -1;
+        }
+        // A DNS callback still in flight only sets _dns_done, which is ignored once idle
+        _connect_state = TCP_CONNECT_IDLE;
+        _failover_pending = false;
+        _warming = false;
     }
 
     // ─── Member variables ────────────────────────────────────────────────────
     TcpIfMode   _mode;
     uint16_t    _port;
-    char        _target_host[64];
-    uint16_t    _target_port;
     WiFiServer* _server;
-    TcpClient   _clients[TCP_IF_MAX_CLIENTS];
+    TcpClient*  _clients[TCP_IF_MAX_CLIENTS];  // nullptr = free slot
+    uint8_t     _active[TCP_IF_MAX_CLIENTS];   // slots in use, _num_clients of them
+    uint8_t     _rx_chunk[TCP_IF_RX_CHUNK];  // shared read staging, only used from loop()
     int         _num_clients;
+    int         _max_clients;
     uint32_t    _last_reconnect;
     uint32_t    _last_keepalive;
     uint32_t    _reconnect_interval;
     uint32_t    _read_timeout;
-    IPAddress   _resolved_ip;
     uint16_t    _consecutive_failures;
+    TcpUpstream _upstreams[TCP_IF_MAX_UPSTREAMS];
+    uint8_t     _num_upstreams;
+    uint8_t     _upstream;           // index of the upstream in use / being tried
+    uint8_t     _round_failures;     // upstreams failed since the last good session
+    bool        _failover_pending;   // try the next upstream without waiting out the interval
+    bool        _session_proven;
+    uint32_t    _connected_at;
+    bool        _warming;            // standby lookup of _warm_index in flight
+    uint8_t     _warm_index;
+    uint32_t    _last_warm;
+    TcpConnectState _connect_state;
+    int         _connect_fd;
+    uint32_t    _connect_started;
+    bool        _connect_cached;
+    volatile bool     _dns_done;     // set from the lwIP thread
+    volatile bool     _dns_pending;  // lwIP still owes a callback
+    volatile uint32_t _dns_ip;
+    int8_t      _dns_slot = -1;      // entry in tcp_dns_slots, claimed on the first lookup
     bool        _started;
+    uint32_t    _tx_drops = 0;
+    char        _pending_hosts[sizeof(TcpUpstream::host)];  // setUpstreams() list for loop()
+    uint16_t    _pending_port = 0;
+    std::atomic<bool> _upstreams_pending{false};
     int         _last_rx_client_idx = -1;  // v1.0.10: echo prevention — tracks which client is currently delivering an inbound frame
 };
 
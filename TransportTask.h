@@ -0,0 +1,235 @@
+// Copyright (C) 2026, Boundary Mode Extension
+// Based on microReticulum_Firmware by Mark Qvist
+//
+// TransportTask.h — Runs RNS Transport (inbound packet processing and
+// Transport::jobs()) in its own FreeRTOS task, pinned to the core that
+// the Arduino loop() does NOT run on. Radio polling, TCP socket I/O,
+// display, serial and WiFi housekeeping stay in loop().
+//
+// The two sides only exchange packets through a pair of lock-free
+// single-producer/single-consumer rings:
+//
+//   RX ring: loop() (LoRa + TCP receive)  →  transport task (inbound)
+//   TX ring: transport task (outbound)    →  loop() (LoRa queue + TCP write)
+//
+// so every interface's hardware/socket state is only ever touched from
+// loop(), exactly as before. The task runs Reticulum::transport_loop(),
+// which leaves the interface loops out; loop() polls the interfaces
+// itself. A slow jobs() pass (path table cull, write_path_table()) can no
+// longer delay LoRa RX servicing or TCP reads.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#ifndef TRANSPORT_TASK_H
+#define TRANSPORT_TASK_H
+
+#ifdef HAS_RNS
+
+// Set to 0 to run Transport cooperatively from loop() as before
+#ifndef BOUNDARY_TRANSPORT_TASK
+#ifdef BOUNDARY_MODE
+#define BOUNDARY_TRANSPORT_TASK 1
+#else
+#define BOUNDARY_TRANSPORT_TASK 0
+#endif
+#endif
+
+#include <Reticulum.h>
+#include <Bytes.h>
+#include <atomic>
+
+// ─── Transport Task Configuration ────────────────────────────────────────────
+#ifndef ARDUINO_RUNNING_CORE
+#define ARDUINO_RUNNING_CORE 1
+#endif
+#define TRANSPORT_TASK_CORE      (ARDUINO_RUNNING_CORE == 0 ? 1 : 0)
+#define TRANSPORT_TASK_STACK     12288   // bytes — inbound() + announce validation is stack hungry
+#define TRANSPORT_TASK_PRIORITY  1       // same as loopTask
+#define TRANSPORT_TASK_IDLE_MS   2       // sleep when both rings are empty
+#define TRANSPORT_RING_SIZE      32      // frames per direction, power of two
+
+// Runs after every Transport pass on whichever task runs Transport, for
+// housekeeping that touches Transport state (MemoryPressure.h)
+static void (*transport_task_service_hook)() = nullptr;
+
+// Table sizes for readers on other tasks (status page, metrics), stored
+// after every Transport pass by whichever task runs Transport
+static std::atomic<uint32_t> transport_path_count{0};
+static std::atomic<uint32_t> transport_link_count{0};
+
+inline void transport_publish_counts() {
+    transport_path_count.store((uint32_t)RNS::Transport::get_destination_table().size(), std::memory_order_relaxed);
+    transport_link_count.store((uint32_t)RNS::Transport::get_link_table().size(), std::memory_order_relaxed);
+}
+
+// ─── Endpoint interface ──────────────────────────────────────────────────────
+// Implemented by the firmware interfaces (LoRaInterface, TcpInterface).
+// deliver_incoming() runs on the transport task and hands the frame to
+// InterfaceImpl::handle_incoming(); transmit_now() runs on loop() and
+// performs the actual hardware/socket write.
+class TransportEndpoint {
+public:
+    virtual ~TransportEndpoint() {}
+    virtual void deliver_incoming(const RNS::Bytes& data, int8_t client) = 0;
+    virtual void transmit_now(const RNS::Bytes& data, int8_t client) = 0;
+};
+
+struct TransportFrame {
+    TransportEndpoint* endpoint = nullptr;
+    RNS::Bytes         data;
+    int8_t             client = -1;   // TCP: receiving client (RX) / client to skip (TX)
+};
+
+// ─── Lock-free SPSC ring ─────────────────────────────────────────────────────
+// Exactly one task may push and exactly one other task may pop.
+template <size_t N>
+class TransportRing {
+public:
+    bool push(TransportEndpoint* endpoint, const RNS::Bytes& data, int8_t client) {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) >= N) {
+            _drops++;
+            return false;
+        }
+        TransportFrame& slot = _slots[head & (N - 1)];
+        slot.endpoint = endpoint;
+        slot.data     = data;
+        slot.client   = client;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(TransportFrame& frame) {
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        TransportFrame& slot = _slots[tail & (N - 1)];
+        frame = slot;
+        slot.data.clear();   // drop our reference so the buffer is freed by the consumer
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool     empty() const { return _tail.load(std::memory_order_acquire) == _head.load(std::memory_order_acquire); }
+    uint32_t size()  const { return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire); }
+    uint32_t drops() const { return _drops; }
+
+private:
+    static_assert((N & (N - 1)) == 0, "TransportRing size must be a power of two");
+    TransportFrame        _slots[N];
+    std::atomic<uint32_t> _head{0};
+    std::atomic<uint32_t> _tail{0};
+    uint32_t              _drops = 0;
+};
+
+#if BOUNDARY_TRANSPORT_TASK && MCU_VARIANT == MCU_ESP32
+
+#include <esp_task_wdt.h>
+
+extern RNS::Reticulum reticulum;
+
+static TransportRing<TRANSPORT_RING_SIZE> transport_rx_ring;
+static TransportRing<TRANSPORT_RING_SIZE> transport_tx_ring;
+static TaskHandle_t transport_task_handle = nullptr;
+
+// True once Transport processing has moved off loop()
+inline bool transport_task_running() {
+    return transport_task_handle != nullptr;
+}
+
+// True when called from the transport task itself
+inline bool transport_task_is_current() {
+    return transport_task_handle != nullptr && xTaskGetCurrentTaskHandle() == transport_task_handle;
+}
+
+// loop() → transport task
+inline bool transport_task_submit_rx(TransportEndpoint* endpoint, const RNS::Bytes& data, int8_t client) {
+    if (!transport_rx_ring.push(endpoint, data, client)) {
+        Serial.printf("[Transport] RX ring full, dropped %u byte frame\r\n", (unsigned)data.size());
+        return false;
+    }
+    xTaskNotifyGive(transport_task_handle);
+    return true;
+}
+
+// transport task → loop()
+inline bool transport_task_submit_tx(TransportEndpoint* endpoint, const RNS::Bytes& data, int8_t client) {
+    if (!transport_tx_ring.push(endpoint, data, client)) {
+        Serial.printf("[Transport] TX ring full, dropped %u byte frame\r\n", (unsigned)data.size());
+        return false;
+    }
+    return true;
+}
+
+// Nothing waiting in either direction
+inline bool transport_task_idle() {
+    return transport_rx_ring.empty() && transport_tx_ring.empty();
+}
+
+// Called from loop() to perform the writes queued by the transport task
+inline void transport_task_service_tx() {
+    TransportFrame frame;
+    while (transport_tx_ring.pop(frame)) {
+        frame.endpoint->transmit_now(frame.data, frame.client);
+    }
+}
+
+static void transport_task(void* param) {
+    esp_task_wdt_add(NULL);
+    TransportFrame frame;
+    while (true) {
+        while (transport_rx_ring.pop(frame)) {
+            try {
+                frame.endpoint->deliver_incoming(frame.data, frame.client);
+            }
+            catch (std::exception& e) {
+                ERRORF("Transport task: inbound failed, the contained exception was: %s", e.what());
+            }
+            frame.data.clear();
+        }
+        // Interface loops stay on loop(), which owns the sockets and radios
+        if (reticulum) {
+            reticulum.transport_loop();
+            transport_publish_counts();
+        }
+        if (transport_task_service_hook) transport_task_service_hook();
+        esp_task_wdt_reset();
+        if (transport_rx_ring.empty()) {
+            // woken early by transport_task_submit_rx()
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(TRANSPORT_TASK_IDLE_MS));
+        }
+    }
+}
+
+inline bool transport_task_start() {
+    if (transport_task_handle != nullptr) return true;
+    BaseType_t ok = xTaskCreatePinnedToCore(transport_task, "transport", TRANSPORT_TASK_STACK,
+                                            nullptr, TRANSPORT_TASK_PRIORITY,
+                                            &transport_task_handle, TRANSPORT_TASK_CORE);
+    if (ok != pdPASS) {
+        transport_task_handle = nullptr;
+        Serial.println("[Transport] Failed to create transport task, staying on loop()");
+        return false;
+    }
+    Serial.printf("[Transport] Transport task started on core %d\r\n", TRANSPORT_TASK_CORE);
+    return true;
+}
+
+#else
+
+inline bool transport_task_running() { return false; }
+inline bool transport_task_is_current() { return false; }
+inline bool transport_task_submit_rx(TransportEndpoint*, const RNS::Bytes&, int8_t) { return false; }
+inline bool transport_task_submit_tx(TransportEndpoint*, const RNS::Bytes&, int8_t) { return false; }
+inline bool transport_task_idle() { return true; }
+inline void transport_task_service_tx() {}
+inline bool transport_task_start() { return false; }
+
+#endif
+
+#endif // HAS_RNS
+#endif // TRANSPORT_TASK_H
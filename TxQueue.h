@@ -0,0 +1,313 @@
+// Copyright (C) 2026, Boundary Mode Extension
+// Based on microReticulum_Firmware by Mark Qvist
+//
+// TxQueue.h — Priority classed LoRa transmit queue.
+//
+// Replaces the packet_queue byte ring and its packet_starts/packet_lengths
+// FIFOs. Packets are stored contiguously in a byte arena, so they can be
+// handed to transmit() as-is, and are described by a slot that records
+// where they live, when they were queued and their priority class:
+//
+//   TXQ_CONTROL   link requests, proofs and link control (RTT, close, ...)
+//   TXQ_LINK      link data and any other traffic
+//   TXQ_PATH      path requests and path responses
+//   TXQ_ANNOUNCE  forwarded and local announces
+//
+// The highest class is always sent first, oldest first within a class.
+// Announces that waited longer than TXQ_ANNOUNCE_MAX_AGE are dropped
+// instead of being sent, and when the queue is full, packets of a lower
+// class are dropped to make room, the lowest class and oldest first,
+// wherever they sit in the queue.
+//
+// accepts() answers whether push() would take a packet, including the
+// room it would make by dropping, so an interface can refuse a frame
+// whole instead of queueing what will be dropped.
+//
+// Slots are kept in queue (insertion) order and the arena is used as a
+// ring in the same order. Sending out of order leaves holes which are
+// reclaimed once the older packets in front of them are gone. Dropping
+// a packet inside the queue frees no arena room, so such a packet only
+// makes way by handing its slot and bytes to the new one, which needs it
+// to be at least as long; packets at either end are simply dropped.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#ifndef TX_QUEUE_H
+#define TX_QUEUE_H
+
+#include <stdint.h>
+#include <string.h>
+
+// ─── TX Queue Configuration ──────────────────────────────────────────────────
+#define TXQ_SLOTS             CONFIG_QUEUE_MAX_LENGTH
+#define TXQ_ARENA_SIZE        CONFIG_QUEUE_SIZE
+#define TXQ_ANNOUNCE_MAX_AGE  30000   // ms — stale announces are dropped, not sent
+
+enum TxClass {
+    TXQ_CONTROL  = 0,
+    TXQ_LINK     = 1,
+    TXQ_PATH     = 2,
+    TXQ_ANNOUNCE = 3,
+    TXQ_CLASSES  = 4,
+};
+
+// Reticulum header fields used for classification (see RNS Packet.py)
+#define TXQ_HDR_IFAC          0x80
+#define TXQ_HDR_HEADER_2      0x40
+#define TXQ_PT_DATA           0x00
+#define TXQ_PT_ANNOUNCE       0x01
+#define TXQ_PT_LINKREQUEST    0x02
+#define TXQ_PT_PROOF          0x03
+#define TXQ_DT_PLAIN          0x02
+#define TXQ_DT_LINK           0x03
+#define TXQ_CTX_PATH_RESPONSE 0x0B
+#define TXQ_CTX_KEEPALIVE     0xFA    // KEEPALIVE .. LRPROOF are link control
+
+class TxQueue {
+public:
+    struct Slot {
+        uint16_t offset;
+        uint16_t length;
+        uint32_t queued;
+        uint8_t  cls;
+        bool     pending;    // false once sent or dropped
+        bool     sending;    // handed out by pop(), not released yet
+    };
+
+    TxQueue() { clear(); }
+
+    void clear() {
+        _first = 0;
+        _count = 0;
+        _pending = 0;
+        _pending_bytes = 0;
+    }
+
+    // ─── Classification ───────────────────────────────────────────────────────
+    static uint8_t classify(const uint8_t* raw, uint16_t length) {
+        // With IFAC the header is masked and can't be inspected
+        if (length < 2 || (raw[0] & TXQ_HDR_IFAC)) return TXQ_LINK;
+        uint8_t packet_type = raw[0] & 0x03;
+        uint8_t dest_type   = (raw[0] >> 2) & 0x03;
+        uint16_t context_pos = 2 + ((raw[0] & TXQ_HDR_HEADER_2) ? 32 : 16);
+        uint8_t context = (length > context_pos) ? raw[context_pos] : 0;
+
+        switch (packet_type) {
+            case TXQ_PT_LINKREQUEST:
+            case TXQ_PT_PROOF:
+                return TXQ_CONTROL;
+            case TXQ_PT_ANNOUNCE:
+                return (context == TXQ_CTX_PATH_RESPONSE) ? TXQ_PATH : TXQ_ANNOUNCE;
+            default:
+                if (dest_type == TXQ_DT_LINK) {
+                    return (context >= TXQ_CTX_KEEPALIVE) ? TXQ_CONTROL : TXQ_LINK;
+                }
+                // Path requests are sent to a plain destination
+                if (dest_type == TXQ_DT_PLAIN) return TXQ_PATH;
+                return TXQ_LINK;
+        }
+    }
+
+    // ─── Producer side ────────────────────────────────────────────────────────
+    bool push(const uint8_t* data, uint16_t length) {
+        if (length < MIN_L || length > MTU) return false;
+        uint8_t cls = classify(data, length);
+        bool drop[TXQ_SLOTS];
+        int16_t replace;
+        if (!_plan(cls, length, drop, replace)) {
+            _drops[cls]++;
+            return false;
+        }
+        for (uint16_t k = 0; k < _count; k++) {
+            uint8_t i = (_first + k) % TXQ_SLOTS;
+            if (!drop[i]) continue;
+            _drops[_slots[i].cls]++;
+            _discard(i);
+        }
+        _reclaim();
+
+        if (replace >= 0) {
+            // Takes over the dropped packet's place in the arena
+            Slot& slot = _slots[replace];
+            _drops[slot.cls]++;
+            _pending_bytes -= slot.length;
+            memcpy(_arena + slot.offset, data, length);
+            slot.length  = length;
+            slot.queued  = millis();
+            slot.cls     = cls;
+            _pending_bytes += length;
+            return true;
+        }
+
+        uint16_t offset = 0;
+        _fits(length, offset);
+        memcpy(_arena + offset, data, length);
+        Slot& slot = _slots[(_first + _count) % TXQ_SLOTS];
+        slot.offset  = offset;
+        slot.length  = length;
+        slot.queued  = millis();
+        slot.cls     = cls;
+        slot.pending = true;
+        slot.sending = false;
+        _count++;
+        _pending++;
+        _pending_bytes += length;
+        return true;
+    }
+
+    // Whether push() would take the packet, dropping what it would to make room
+    bool accepts(const uint8_t* data, uint16_t length) const {
+        if (length < MIN_L || length > MTU) return false;
+        bool drop[TXQ_SLOTS];
+        int16_t replace;
+        return _plan(classify(data, length), length, drop, replace);
+    }
+
+    // ─── Consumer side ────────────────────────────────────────────────────────
+    // Pick the next packet to send. The data stays valid until release().
+    bool pop(uint8_t& slot_index, const uint8_t*& data, uint16_t& length) {
+        uint32_t now = millis();
+        int16_t best = -1;
+        for (uint8_t k = 0; k < _count; k++) {
+            uint8_t i = (_first + k) % TXQ_SLOTS;
+            Slot& slot = _slots[i];
+            if (!slot.pending || slot.sending) continue;
+            if (slot.cls >= TXQ_PATH && now - slot.queued > TXQ_ANNOUNCE_MAX_AGE) {
+                _discard(i);
+                _expired++;
+                continue;
+            }
+            // Queue order is not age order for a packet that took over a slot
+            if (best < 0 || slot.cls < _slots[best].cls ||
+                (slot.cls == _slots[best].cls && (int32_t)(slot.queued - _slots[best].queued) < 0)) {
+                best = i;
+            }
+        }
+        _reclaim();
+        if (best < 0) return false;
+        _slots[best].sending = true;
+        slot_index = (uint8_t)best;
+        data = _arena + _slots[best].offset;
+        length = _slots[best].length;
+        return true;
+    }
+
+    // Put a packet taken with pop() back, unsent
+    void unpop(uint8_t slot_index) {
+        _slots[slot_index].sending = false;
+    }
+
+    void release(uint8_t slot_index) {
+        _slots[slot_index].sending = false;
+        if (_slots[slot_index].pending) {
+            _discard(slot_index);
+        }
+        _reclaim();
+    }
+
+    // ─── Stats ────────────────────────────────────────────────────────────────
+    uint8_t  height() const { return _pending; }
+    uint16_t bytes()  const { return _pending_bytes; }
+    bool     full()   const { uint16_t offset; return _count >= TXQ_SLOTS || !_fits(MTU, offset); }
+    uint32_t drops(uint8_t cls) const { return _drops[cls]; }
+    uint32_t expired() const { return _expired; }
+    // millis() a packet taken with pop() was queued at, valid until release()
+    uint32_t queued_at(uint8_t slot_index) const { return _slots[slot_index].queued; }
+
+private:
+    // Find length contiguous free bytes at the write position
+    bool _fits(uint16_t length, uint16_t& offset) const { return _fits(length, offset, _first, _count); }
+    bool _fits(uint16_t length, uint16_t& offset, uint16_t first, uint16_t count) const {
+        if (count == 0) {
+            offset = 0;
+            return length <= TXQ_ARENA_SIZE;
+        }
+        const Slot& oldest = _slots[first];
+        const Slot& newest = _slots[(first + count - 1) % TXQ_SLOTS];
+        uint16_t end = newest.offset + newest.length;
+        if (end > oldest.offset) {
+            // Not wrapped: room after the newest packet, else at the arena start
+            if (TXQ_ARENA_SIZE - end >= length) {
+                offset = end;
+                return true;
+            }
+            offset = 0;
+            return oldest.offset >= length;
+        }
+        offset = end;
+        return oldest.offset - end >= length;
+    }
+
+    // Which packets push() drops to take a packet of class cls, marked in
+    // drop[], and whether it takes over a dropped one's slot (replace >= 0)
+    // instead of being appended. False if there is no way to take it.
+    bool _plan(uint8_t cls, uint16_t length, bool* drop, int16_t& replace) const {
+        uint16_t first = _first;
+        uint16_t count = _count;
+        uint16_t offset;
+        replace = -1;
+        for (uint16_t k = 0; k < _count; k++) drop[(_first + k) % TXQ_SLOTS] = false;
+        while (count >= TXQ_SLOTS || !_fits(length, offset, first, count)) {
+            // Lowest class first, oldest first within it
+            int16_t victim = -1;
+            bool at_end = false;
+            for (int8_t c = TXQ_CLASSES - 1; c > cls && victim < 0; c--) {
+                for (uint16_t k = 0; k < count; k++) {
+                    uint8_t i = (first + k) % TXQ_SLOTS;
+                    const Slot& slot = _slots[i];
+                    if (slot.cls != c || !slot.pending || slot.sending || drop[i]) continue;
+                    at_end = (k == 0 || k == count - 1);
+                    if (at_end || slot.length >= length) { victim = i; break; }
+                }
+            }
+            if (victim < 0) return false;
+            if (!at_end) {
+                replace = victim;
+                return true;
+            }
+            // As _discard() and _reclaim() would, past finished packets at both ends
+            drop[victim] = true;
+            while (count > 0 && (!_slots[first].pending || drop[first])) {
+                first = (first + 1) % TXQ_SLOTS;
+                count--;
+            }
+            while (count > 0) {
+                uint8_t last = (first + count - 1) % TXQ_SLOTS;
+                if (_slots[last].pending && !drop[last]) break;
+                count--;
+            }
+        }
+        return true;
+    }
+
+    void _discard(uint8_t i) {
+        _slots[i].pending = false;
+        _pending--;
+        _pending_bytes -= _slots[i].length;
+    }
+
+    // Forget sent/dropped packets at both ends of the queue
+    void _reclaim() {
+        while (_count > 0 && !_slots[_first].pending) {
+            _first = (_first + 1) % TXQ_SLOTS;
+            _count--;
+        }
+        while (_count > 0 && !_slots[(_first + _count - 1) % TXQ_SLOTS].pending) {
+            _count--;
+        }
+    }
+
+    Slot     _slots[TXQ_SLOTS];
+    uint8_t  _arena[TXQ_ARENA_SIZE];
+    uint16_t _first;
+    uint16_t _count;
+    uint16_t _pending;
+    uint16_t _pending_bytes;
+    uint32_t _drops[TXQ_CLASSES] = {0};
+    uint32_t _expired = 0;
+};
+
+#endif // TX_QUEUE_H
@@ -0,0 +1,230 @@
+// Copyright (C) 2026, Boundary Mode Extension
+// Based on microReticulum_Firmware by Mark Qvist
+//
+// UdpInterface — An RNS InterfaceImpl that serves the local network
+// over UDP instead of one TCP connection per device. Every outgoing
+// packet is sent exactly once, as a single datagram to the subnet
+// broadcast address (or a multicast group), and every device on the
+// LAN picks it up. Datagrams carry the raw RNS packet with no framing,
+// the same as Reticulum's UDPInterface, so a host rnsd can listen with
+//
+//   [[RTNode LAN]]
+//     type = UDPInterface
+//     listen_ip = 0.0.0.0
+//     listen_port = 4242
+//     forward_ip = 255.255.255.255
+//     forward_port = 4242
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#ifndef UDP_INTERFACE_H
+#define UDP_INTERFACE_H
+
+#ifdef HAS_RNS
+#ifdef BOUNDARY_MODE
+
+#include <WiFi.h>
+#include <lwip/sockets.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <Interface.h>
+#include <Transport.h>
+#include <Bytes.h>
+#include "TransportTask.h"
+
+// ─── UDP Interface Configuration ─────────────────────────────────────────────
+#define UDP_IF_DEFAULT_PORT      4242
+#define UDP_IF_HW_MTU            1064
+#define UDP_IF_RX_BURST          8       // datagrams taken per loop()
+#define UDP_IF_PEER_TIMEOUT      600000  // ms — LAN counts as in use this long after the last datagram
+
+// ─── UdpInterface Class ─────────────────────────────────────────────────────
+class UdpInterface : public RNS::InterfaceImpl, public TransportEndpoint {
+public:
+    // forward_ip: multicast group or unicast/broadcast target, nullptr or ""
+    // sends to the directed broadcast address of the WiFi subnet
+    UdpInterface(uint16_t port = UDP_IF_DEFAULT_PORT,
+                 const char* forward_ip = nullptr,
+                 const char* name = "LocalUdpInterface")
+        : RNS::InterfaceImpl(name),
+          _port(port),
+          _fd(-1),
+          _forward((uint32_t)0),
+          _local((uint32_t)0),
+          _multicast(false),
+          _last_rx(0),
+          _started(false)
+    {
+        _IN = true;
+        _OUT = true;
+        _HW_MTU = UDP_IF_HW_MTU;
+        _FIXED_MTU = true;
+        _bitrate = 10000000;
+        if (forward_ip != nullptr && forward_ip[0] != '\0') {
+            _forward.fromString(forward_ip);
+            _multicast = (_forward[0] >= 224 && _forward[0] <= 239);
+        }
+    }
+
+    virtual ~UdpInterface() {
+        stop();
+    }
+
+    // ─── Lifecycle ───────────────────────────────────────────────────────────
+    bool start() {
+        if (_started) return true;
+
+        // Station address if joined to a network, otherwise our own AP
+        IPAddress mask;
+        if (WiFi.status() == WL_CONNECTED) {
+            _local = WiFi.localIP();
+            mask = WiFi.subnetMask();
+        } else {
+            _local = WiFi.softAPIP();
+            mask = IPAddress(255, 255, 255, 0);
+        }
+        if (_local == (uint32_t)0) return false;
+
+        int fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        if (fd < 0) {
+            Serial.printf("[UdpIF] socket() failed, errno %d\r\n", errno);
+            return false;
+        }
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        setsockopt(fd, SOL_SOCKET, SO_BROADCAST, &one, sizeof(one));
+
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons(_port);
+        if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+            Serial.printf("[UdpIF] bind() to port %d failed, errno %d\r\n", _port, errno);
+            close(fd);
+            return false;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+        if (_multicast) {
+            struct ip_mreq mreq;
+            mreq.imr_multiaddr.s_addr = (uint32_t)_forward;
+            mreq.imr_interface.s_addr = (uint32_t)_local;
+            if (setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0) {
+                Serial.printf("[UdpIF] Joining %s failed, errno %d\r\n", _forward.toString().c_str(), errno);
+            }
+            uint8_t loop = 0;
+            setsockopt(fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+        } else if (_forward == (uint32_t)0) {
+            _forward = IPAddress((uint32_t)_local | ~(uint32_t)mask);
+        }
+
+        _fd = fd;
+        _started = true;
+        Serial.printf("[UdpIF] Listening on port %d, forwarding to %s:%d\r\n",
+                      _port, _forward.toString().c_str(), _port);
+        return true;
+    }
+
+    void stop() {
+        if (_fd >= 0) {
+            close(_fd);
+            _fd = -1;
+        }
+        _started = false;
+    }
+
+    // ─── Main loop — call from Arduino loop() ────────────────────────────────
+    void loop() {
+        if (!_started) return;
+
+        for (int n = 0; n < UDP_IF_RX_BURST; n++) {
+            struct sockaddr_in src;
+            socklen_t srclen = sizeof(src);
+            // Staged in _rx_buf, so an empty poll allocates nothing and
+            // the Bytes handed to Transport is just the datagram's size
+            int len = recvfrom(_fd, _rx_buf, sizeof(_rx_buf), 0, (struct sockaddr*)&src, &srclen);
+            if (len <= 0) break;
+            // Our own broadcasts come back on some networks
+            if (src.sin_addr.s_addr == (uint32_t)_local) continue;
+            RNS::Bytes data(_rx_buf, len);
+            _last_rx = millis();
+            if (transport_task_running()) {
+                transport_task_submit_rx(this, data, -1);
+            } else {
+                handle_incoming(data);
+            }
+        }
+    }
+
+    // ─── Stats ───────────────────────────────────────────────────────────────
+    bool isStarted()   const { return _started; }
+    // Datagrams from the LAN seen recently
+    bool isConnected() const { return _started && _last_rx != 0 && millis() - _last_rx < UDP_IF_PEER_TIMEOUT; }
+    uint32_t txDrops() const { return _tx_drops; }
+
+protected:
+    // ─── TransportEndpoint: runs on the transport task ───────────────────────
+    virtual void deliver_incoming(const RNS::Bytes& data, int8_t client) override {
+        handle_incoming(data);
+    }
+
+    // ─── TransportEndpoint: runs on loop() ───────────────────────────────────
+    virtual void transmit_now(const RNS::Bytes& data, int8_t client) override {
+        _send_datagram(data);
+    }
+
+    // ─── RNS InterfaceImpl: outgoing packet from RNS Transport ───────────────
+    virtual void send_outgoing(const RNS::Bytes& data) override {
+        if (!_started) return;
+
+        if (transport_task_is_current()) {
+            // Socket writes stay on loop(); hand the packet over
+            transport_task_submit_tx(this, data, -1);
+        } else {
+            _send_datagram(data);
+        }
+
+        // Post-send housekeeping
+        InterfaceImpl::handle_outgoing(data);
+    }
+
+    // ─── RNS InterfaceImpl: incoming packet to RNS Transport ─────────────────
+    virtual void handle_incoming(const RNS::Bytes& data) override {
+        TRACEF("UdpInterface.handle_incoming: (%u bytes)", data.size());
+        InterfaceImpl::handle_incoming(data);
+    }
+
+private:
+    // One sendto() per packet, however many devices are listening
+    void _send_datagram(const RNS::Bytes& data) {
+        if (_fd < 0) return;
+        struct sockaddr_in dst;
+        memset(&dst, 0, sizeof(dst));
+        dst.sin_family = AF_INET;
+        dst.sin_addr.s_addr = (uint32_t)_forward;
+        dst.sin_port = htons(_port);
+        if (sendto(_fd, data.data(), data.size(), 0, (struct sockaddr*)&dst, sizeof(dst)) < 0) {
+            // ENOMEM when lwIP is out of pbufs, the packet is lost as on air
+            _tx_drops++;
+        }
+    }
+
+    // ─── Member variables ────────────────────────────────────────────────────
+    uint16_t    _port;
+    int         _fd;
+    IPAddress   _forward;
+    IPAddress   _local;
+    bool        _multicast;
+    uint32_t    _last_rx;
+    uint8_t     _rx_buf[UDP_IF_HW_MTU];  // receive staging, only used from loop()
+    bool        _started;
+    uint32_t    _tx_drops = 0;
+};
+
+#endif // BOUNDARY_MODE
+#endif // HAS_RNS
+#endif // UDP_INTERFACE_H
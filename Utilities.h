@@ -466,6 +466,9 @@ void hard_reset(void) {
 			led_tx_on(); led_rx_off();
 		}
 	#elif MCU_VARIANT == MCU_ESP32
+		#ifdef HAS_RNS
+			RNS::Utilities::OS::sync_filesystem();
+		#endif
 		ESP.restart();
 	#elif MCU_VARIANT == MCU_NRF52
     NVIC_SystemReset();
@@ -883,30 +886,96 @@ int8_t  led_standby_direction = 0;
 	#endif
 #endif
 
-void serial_write(uint8_t byte) {
+// Submits buffered host output with a single write call on the active host connection
+void serial_write_frame(const uint8_t* frame, size_t len) {
 	#ifdef BOUNDARY_MODE
-		// No KISS serial output in boundary mode - serial is used for debug logging only
 		return;
 	#endif
 	#if HAS_BLUETOOTH || HAS_BLE == true
 		if (bt_state != BT_STATE_CONNECTED) {
 			#if HAS_WIFI
-				if (wifi_host_is_connected()) { wifi_remote_write(byte); }
-				else                          { Serial.write(byte); }
+				if (wifi_host_is_connected()) { wifi_remote_write(frame, len); }
+				else                          { Serial.write(frame, len); }
 			#else
-				Serial.write(byte);
+				Serial.write(frame, len);
 			#endif
 		} else {
-			SerialBT.write(byte);
+			SerialBT.write(frame, len);
       #if MCU_VARIANT == MCU_NRF52 && HAS_BLE
-	      // This ensures that the TX buffer is flushed after a frame is queued in serial.
-	      // serial_in_frame is used to ensure that the flush only happens at the end of the frame
-	      if (serial_in_frame && byte == FEND) { SerialBT.flushTXD(); serial_in_frame = false; }
-	      else if (!serial_in_frame && byte == FEND) { serial_in_frame = true; }
+	      // Output is submitted at frame boundaries, so the TX buffer is flushed right away
+	      SerialBT.flushTXD();
       #endif
 		}
+	#elif HAS_WIFI
+		if (wifi_host_is_connected()) { wifi_remote_write(frame, len); }
+		else                          { Serial.write(frame, len); }
+	#else
+		Serial.write(frame, len);
+	#endif
+}
+
+#ifndef BOUNDARY_MODE
+// KISS output is assembled here and submitted once a frame closes, or once
+// a batch of frames opened with serial_batch_begin() has been written
+static uint8_t serial_tx_buf[SERIAL_TX_BUFFER_SIZE];
+static size_t serial_tx_len = 0;
+static uint8_t serial_tx_batch = 0;
+#endif
+
+void serial_flush() {
+	#ifndef BOUNDARY_MODE
+		if (serial_tx_len > 0) {
+			serial_write_frame(serial_tx_buf, serial_tx_len);
+			serial_tx_len = 0;
+		}
+	#endif
+}
+
+// Frames written until the matching serial_batch_end() go out in one write
+void serial_batch_begin() {
+	#ifndef BOUNDARY_MODE
+		serial_tx_batch++;
+	#endif
+}
+
+void serial_batch_end() {
+	#ifndef BOUNDARY_MODE
+		if (serial_tx_batch > 0) { serial_tx_batch--; }
+		if (serial_tx_batch == 0 && !serial_in_frame) { serial_flush(); }
+	#endif
+}
+
+void serial_write(uint8_t byte) {
+	#ifdef BOUNDARY_MODE
+		// No KISS serial output in boundary mode - serial is used for debug logging only
+		return;
 	#else
-		Serial.write(byte);
+		if (serial_tx_len == SERIAL_TX_BUFFER_SIZE) { serial_flush(); }
+		serial_tx_buf[serial_tx_len++] = byte;
+		if (byte == FEND) {
+			// serial_in_frame tells opening and closing FENDs apart, so every
+			// payload byte must go through escaped_serial_write
+			if (serial_in_frame) {
+				serial_in_frame = false;
+				if (serial_tx_batch == 0) { serial_flush(); }
+			} else {
+				serial_in_frame = true;
+			}
+		}
+	#endif
+}
+
+// KISS-escapes a whole buffer straight into the output buffer
+void escaped_serial_write(const uint8_t* buf, size_t len) {
+	#ifndef BOUNDARY_MODE
+		for (size_t i = 0; i < len; i++) {
+			// worst case two bytes per input byte
+			if (serial_tx_len >= SERIAL_TX_BUFFER_SIZE - 1) { serial_flush(); }
+			uint8_t byte = buf[i];
+			if      (byte == FEND) { serial_tx_buf[serial_tx_len++] = FESC; serial_tx_buf[serial_tx_len++] = TFEND; }
+			else if (byte == FESC) { serial_tx_buf[serial_tx_len++] = FESC; serial_tx_buf[serial_tx_len++] = TFESC; }
+			else                   { serial_tx_buf[serial_tx_len++] = byte; }
+		}
 	#endif
 }
 
@@ -926,14 +995,14 @@ void kiss_indicate_reset() {
 void kiss_indicate_error(uint8_t error_code) {
 	serial_write(FEND);
 	serial_write(CMD_ERROR);
-	serial_write(error_code);
+	escaped_serial_write(error_code);
 	serial_write(FEND);
 }
 
 void kiss_indicate_radiostate() {
 	serial_write(FEND);
 	serial_write(CMD_RADIO_STATE);
-	serial_write(radio_online);
+	escaped_serial_write(radio_online);
 	serial_write(FEND);
 }
 
@@ -975,35 +1044,35 @@ void kiss_indicate_stat_snr() {
 void kiss_indicate_radio_lock() {
 	serial_write(FEND);
 	serial_write(CMD_RADIO_LOCK);
-	serial_write(radio_locked);
+	escaped_serial_write(radio_locked);
 	serial_write(FEND);
 }
 
 void kiss_indicate_spreadingfactor() {
 	serial_write(FEND);
 	serial_write(CMD_SF);
-	serial_write((uint8_t)lora_sf);
+	escaped_serial_write((uint8_t)lora_sf);
 	serial_write(FEND);
 }
 
 void kiss_indicate_codingrate() {
 	serial_write(FEND);
 	serial_write(CMD_CR);
-	serial_write((uint8_t)lora_cr);
+	escaped_serial_write((uint8_t)lora_cr);
 	serial_write(FEND);
 }
 
 void kiss_indicate_implicit_length() {
 	serial_write(FEND);
 	serial_write(CMD_IMPLICIT);
-	serial_write(implicit_l);
+	escaped_serial_write(implicit_l);
 	serial_write(FEND);
 }
 
 void kiss_indicate_txpower() {
 	serial_write(FEND);
 	serial_write(CMD_TXPOWER);
-	serial_write((uint8_t)lora_txp);
+	escaped_serial_write((uint8_t)lora_txp);
 	serial_write(FEND);
 }
 
@@ -1078,6 +1147,14 @@ void kiss_indicate_csma_stats() {
 		escaped_serial_write(cw_band);
 		escaped_serial_write(cw_min);
 		escaped_serial_write(cw_max);
+		escaped_serial_write(cw_adapt);
+		escaped_serial_write(csma_p > 255 ? 255 : csma_p);
+		for (uint8_t band = 0; band < CSMA_CW_BANDS; band++) {
+			escaped_serial_write(csma_band_tx[band]>>8);
+			escaped_serial_write(csma_band_tx[band]);
+			escaped_serial_write(csma_band_deferrals[band]>>8);
+			escaped_serial_write(csma_band_deferrals[band]);
+		}
 		serial_write(FEND);
 	#endif
 }
@@ -1140,7 +1217,7 @@ void kiss_indicate_btpin() {
 void kiss_indicate_random(uint8_t byte) {
 	serial_write(FEND);
 	serial_write(CMD_RANDOM);
-	serial_write(byte);
+	escaped_serial_write(byte);
 	serial_write(FEND);
 }
 
@@ -1286,21 +1363,21 @@ void kiss_indicate_version() {
 void kiss_indicate_platform() {
 	serial_write(FEND);
 	serial_write(CMD_PLATFORM);
-	serial_write(PLATFORM);
+	escaped_serial_write(PLATFORM);
 	serial_write(FEND);
 }
 
 void kiss_indicate_board() {
 	serial_write(FEND);
 	serial_write(CMD_BOARD);
-	serial_write(BOARD_MODEL);
+	escaped_serial_write(BOARD_MODEL);
 	serial_write(FEND);
 }
 
 void kiss_indicate_mcu() {
 	serial_write(FEND);
 	serial_write(CMD_MCU);
-	serial_write(MCU_VARIANT);
+	escaped_serial_write(MCU_VARIANT);
 	serial_write(FEND);
 }
 
@@ -1308,6 +1385,10 @@ inline bool isSplitPacket(uint8_t header) {
 	return (header & FLAG_SPLIT);
 }
 
+inline bool isAggregatedPacket(uint8_t header) {
+	return (header & FLAG_AGGR) && !(header & FLAG_SPLIT);
+}
+
 inline uint8_t packetSequence(uint8_t header) {
 	return header >> 4;
 }
@@ -1317,6 +1398,57 @@ void setPreamble() {
 	kiss_indicate_phy_stats();
 }
 
+void update_airtime_model() {
+	#if MCU_VARIANT == MCU_ESP32 || MCU_VARIANT == MCU_NRF52
+		if (!radio_online) { memset(airtime_table_us, 0, sizeof(airtime_table_us)); return; }
+		#if MODEM == SX1280
+			if (LoRa->getFskBitrate()) {
+				uint32_t bitrate = LoRa->getFskBitrate();
+				for (uint16_t written = 0; written <= SINGLE_MTU; written++) {
+					airtime_table_us[written] = (uint32_t)(((uint64_t)(FSK_FRAME_OVERHEAD_BITS + 8*written) * 1000000) / bitrate);
+				}
+				return;
+			}
+		#endif
+		int ldr_opt = 0; if (lora_low_datarate) ldr_opt = 1;
+		for (uint16_t written = 0; written <= SINGLE_MTU; written++) {
+			float lora_symbols = 0;
+			#if MODEM == SX1262 || MODEM == SX1280
+			if (lora_sf < 7) {
+				lora_symbols += (8*written + PHY_CRC_LORA_BITS - 4*lora_sf + PHY_HEADER_LORA_SYMBOLS);
+				lora_symbols /=                              4*lora_sf;
+				lora_symbols *= lora_cr;
+				lora_symbols += lora_preamble_symbols + 2.25 + 8;
+			} else
+			#endif
+			{
+				lora_symbols += (8*written + PHY_CRC_LORA_BITS - 4*lora_sf + 8 + PHY_HEADER_LORA_SYMBOLS);
+				lora_symbols /=                         4*(lora_sf-2*ldr_opt);
+				lora_symbols *= lora_cr;
+				lora_symbols += lora_preamble_symbols + 0.25 + 8;
+			}
+			airtime_table_us[written] = (uint32_t)(lora_symbols * lora_symbol_time_ms * 1000.0);
+		}
+	#endif
+}
+
+// Time on air in microseconds for a packet of length bytes as queued
+// for transmission, including the split into two frames if needed
+uint32_t predict_airtime(uint16_t length) {
+	#if MCU_VARIANT == MCU_ESP32 || MCU_VARIANT == MCU_NRF52
+		if (length == 0) { return 0; }
+		if (promisc) {
+			if (length > SINGLE_MTU) { length = SINGLE_MTU; }
+			return airtime_table_us[length];
+		}
+		if (length > MTU) { length = MTU; }
+		if (length <= SINGLE_MTU - HEADER_L) { return airtime_table_us[length + HEADER_L]; }
+		return airtime_table_us[SINGLE_MTU] + airtime_table_us[length - (SINGLE_MTU - HEADER_L) + HEADER_L];
+	#else
+		return 0;
+	#endif
+}
+
 void updateBitrate() {
 	#if MCU_VARIANT == MCU_ESP32 || MCU_VARIANT == MCU_NRF52
 		if (!radio_online) { lora_bitrate = 0; }
@@ -1324,6 +1456,15 @@ void updateBitrate() {
 			lora_symbol_rate = (float)lora_bw/(float)(pow(2, lora_sf));
 			lora_symbol_time_ms = (1.0/lora_symbol_rate)*1000.0;
 			lora_bitrate = (uint32_t)(lora_sf * ( (4.0/(float)lora_cr) / ((float)(pow(2, lora_sf))/((float)lora_bw/1000.0)) ) * 1000.0);
+			#if MODEM == SX1280
+				if (LoRa->getFskBitrate()) {
+					// One bit per symbol; CSMA slots and preamble targets
+					// below fall back to their minimums at these rates
+					lora_bitrate = LoRa->getFskBitrate();
+					lora_symbol_rate = (float)lora_bitrate;
+					lora_symbol_time_ms = 1000.0/lora_symbol_rate;
+				}
+			#endif
 			lora_us_per_byte = 1000000.0/((float)lora_bitrate/8.0);
 			
 			bool fast_rate   = lora_bitrate > LORA_FAST_THRESHOLD_BPS;
@@ -1343,11 +1484,24 @@ void updateBitrate() {
 			float target_preamble_symbols = lora_preamble_target_ms/lora_symbol_time_ms;
 			if (target_preamble_symbols < LORA_PREAMBLE_SYMBOLS_MIN) { target_preamble_symbols = LORA_PREAMBLE_SYMBOLS_MIN; }
 			else { target_preamble_symbols = (ceil)(target_preamble_symbols); }
+
+			#if LORA_RX_DUTY_CYCLE
+				// A preamble is only sure to be heard if it covers two listening
+				// windows and the sleep between them
+				float sniff_rx_ms    = LORA_SNIFF_RX_SYMBOLS*lora_symbol_time_ms;
+				float sniff_sleep_ms = sniff_rx_ms*LORA_SNIFF_SLEEP_RATIO;
+				float sniff_preamble_symbols = (ceil)((2*sniff_rx_ms + sniff_sleep_ms + LORA_SNIFF_WAKE_US/1000.0)/lora_symbol_time_ms);
+				if (target_preamble_symbols < sniff_preamble_symbols) { target_preamble_symbols = sniff_preamble_symbols; }
+			#endif
 			
 			lora_preamble_symbols = (long)target_preamble_symbols; setPreamble();
 			lora_preamble_time_ms = (ceil)(lora_preamble_symbols * lora_symbol_time_ms);
 			lora_header_time_ms   = (ceil)(PHY_HEADER_LORA_SYMBOLS * lora_symbol_time_ms);
+			#if LORA_RX_DUTY_CYCLE
+				LoRa->setRxDutyCycle((uint32_t)(sniff_rx_ms*1000.0), (uint32_t)(sniff_sleep_ms*1000.0));
+			#endif
 		}
+		update_airtime_model();
 	#endif
 }
 
@@ -1503,7 +1657,9 @@ void setFrequency() {
 	}
 }
 
-uint8_t getRandom() { return random(0xFF); }
+// Straight from the hardware RNG: this runs on loop(), and the RNS
+// RandomPool is not locked and belongs to the transport task
+uint8_t getRandom() { return random(256); }
 
 void promisc_enable() {
 	promisc = true;
@@ -1641,13 +1797,35 @@ void eeprom_flush() {
 }
 #endif
 
+// Batched writes: between eeprom_batch_begin() and eeprom_batch_commit()
+// eeprom_update() only changes the buffered bytes, and the commit writes
+// them out to flash once. Batches nest, only the outermost one commits.
+uint8_t eeprom_batch_depth = 0;
+bool eeprom_batch_dirty = false;
+
+void eeprom_batch_begin() {
+	eeprom_batch_depth++;
+}
+
+void eeprom_batch_commit() {
+	if (eeprom_batch_depth == 0 || --eeprom_batch_depth > 0) { return; }
+	if (!eeprom_batch_dirty) { return; }
+	eeprom_batch_dirty = false;
+	#if MCU_VARIANT == MCU_ESP32
+		EEPROM.commit();
+	#elif !HAS_EEPROM && MCU_VARIANT == MCU_NRF52
+		eeprom_flush();
+	#endif
+}
+
 void eeprom_update(int mapped_addr, uint8_t byte) {
 	#if MCU_VARIANT == MCU_1284P || MCU_VARIANT == MCU_2560
 		EEPROM.update(mapped_addr, byte);
 	#elif MCU_VARIANT == MCU_ESP32
 		if (EEPROM.read(mapped_addr) != byte) {
 			EEPROM.write(mapped_addr, byte);
-			EEPROM.commit();
+			if (eeprom_batch_depth > 0) { eeprom_batch_dirty = true; }
+			else                        { EEPROM.commit(); }
 		}
     #elif !HAS_EEPROM && MCU_VARIANT == MCU_NRF52
         // todo: clean up this implementation, writing one byte and syncing
@@ -1660,6 +1838,12 @@ void eeprom_update(int mapped_addr, uint8_t byte) {
         if (read_byte != byte) {
             file.write(byte);
         }
+
+        if (eeprom_batch_depth > 0) {
+            // Synced once by eeprom_batch_commit()
+            eeprom_batch_dirty = true;
+            return;
+        }
         written_bytes++;
 
         if ((mapped_addr - eeprom_addr(0)) == ADDR_INFO_LOCK) {
@@ -1691,9 +1875,11 @@ void eeprom_erase() {
 	#if !HAS_EEPROM && MCU_VARIANT == MCU_NRF52
 		InternalFS.format();
 	#else
+		eeprom_batch_begin();
 		for (int addr = 0; addr < EEPROM_RESERVED; addr++) {
 			eeprom_update(eeprom_addr(addr), 0xFF);
 		}
+		eeprom_batch_commit();
 	#endif
 	#ifdef HAS_RNS
 		reticulum.clear_caches();
@@ -1834,27 +2020,16 @@ bool eeprom_checksum_valid() {
 }
 
 void wr_conf_save(uint8_t mode) {
+	// A batch of one, so it is synced on nRF52 rather than after 4 writes
+	eeprom_batch_begin();
 	eeprom_update(eeprom_addr(ADDR_CONF_WIFI), mode);
-  #if !HAS_EEPROM && MCU_VARIANT == MCU_NRF52
-    // have to do a flush because we're only writing 1 byte and it syncs after 8
-    eeprom_flush();
-  #endif
+	eeprom_batch_commit();
 }
 
 void bt_conf_save(bool is_enabled) {
-	if (is_enabled) {
-		eeprom_update(eeprom_addr(ADDR_CONF_BT), BT_ENABLE_BYTE);
-      #if !HAS_EEPROM && MCU_VARIANT == MCU_NRF52
-        // have to do a flush because we're only writing 1 byte and it syncs after 8
-        eeprom_flush();
-      #endif
-	} else {
-		eeprom_update(eeprom_addr(ADDR_CONF_BT), 0x00);
-    #if !HAS_EEPROM && MCU_VARIANT == MCU_NRF52
-      // have to do a flush because we're only writing 1 byte and it syncs after 8
-      eeprom_flush();
-    #endif
-	}
+	eeprom_batch_begin();
+	eeprom_update(eeprom_addr(ADDR_CONF_BT), is_enabled ? BT_ENABLE_BYTE : 0x00);
+	eeprom_batch_commit();
 }
 
 void di_conf_save(uint8_t dint) {
@@ -1874,8 +2049,10 @@ void db_conf_save(uint8_t val) {
 			display_blanking_enabled = true;
 			display_blanking_timeout = (uint32_t)val * 60UL * 1000UL;
 		}
+		eeprom_batch_begin();
 		eeprom_update(eeprom_addr(ADDR_CONF_BSET), CONF_OK_BYTE);
 		eeprom_update(eeprom_addr(ADDR_CONF_DBLK), val);
+		eeprom_batch_commit();
 	#endif
 }
 
@@ -1895,8 +2072,10 @@ void dia_conf_save(uint8_t val) {
 }
 
 void np_int_conf_save(uint8_t p_int) {
+	eeprom_batch_begin();
 	eeprom_update(eeprom_addr(ADDR_CONF_PSET), CONF_OK_BYTE);
 	eeprom_update(eeprom_addr(ADDR_CONF_PINT), p_int);
+	eeprom_batch_commit();
 }
 
 
@@ -1932,6 +2111,7 @@ void eeprom_conf_load() {
 
 void eeprom_conf_save() {
 	if (hw_ready && radio_online) {
+		eeprom_batch_begin();
 		eeprom_update(eeprom_addr(ADDR_CONF_SF), lora_sf);
 		eeprom_update(eeprom_addr(ADDR_CONF_CR), lora_cr);
 		eeprom_update(eeprom_addr(ADDR_CONF_TXP), lora_txp);
@@ -1947,6 +2127,7 @@ void eeprom_conf_save() {
 		eeprom_update(eeprom_addr(ADDR_CONF_FREQ)+0x03, lora_freq);
 
 		eeprom_update(eeprom_addr(ADDR_CONF_OK), CONF_OK_BYTE);
+		eeprom_batch_commit();
 		led_indicate_info(10);
 	} else {
 		led_indicate_warning(10);
@@ -1967,6 +2148,12 @@ void init_channel_stats() {
 		memset(util_samples, 0, DCD_BITFIELD_SIZE);
 		for (uint16_t ai = 0; ai < AIRTIME_BINS; ai++) { airtime_bins[ai] = 0; }
 		for (uint16_t ai = 0; ai < AIRTIME_BINS; ai++) { longterm_bins[ai] = 0.0; }
+		airtime_bins_sum = 0;
+		longterm_bins_sum = 0.0;
+		memset(csma_band_tx, 0, sizeof(csma_band_tx));
+		memset(csma_band_deferrals, 0, sizeof(csma_band_deferrals));
+		cw_adapt = 0;
+		csma_p = 256;
 		local_channel_util = 0.0;
 		total_channel_util = 0.0;
 		airtime = 0.0;
@@ -2146,6 +2333,7 @@ void host_disconnected() {
 	cable_state   = CABLE_STATE_DISCONNECTED;
 	current_rssi  = -292;
 	last_rssi     = -292;
+	last_rssi_at  = 0;
 	last_rssi_raw = 0x00;
 	last_snr_raw  = 0x80;
 }
\ No newline at end of file
@@ -0,0 +1,16 @@
+// Fills the setup form with the stored settings from /config.json
+fetch('/config.json').then(function(r) { return r.json(); }).then(function(c) {
+  var f = document.getElementById('cfg');
+  var hash = document.getElementById('hash');
+  if (c.hash) {
+    hash.textContent = c.hash;
+  } else {
+    hash.innerHTML = "<span class='unset'>Not yet assigned &mdash; will be set on first normal boot</span>";
+  }
+  f.txp.max = c.txp_max;
+  document.getElementById('txp_note').textContent = 'Max output for this board: ' + c.txp_max + ' dBm (with PA)';
+  for (var k in c) {
+    var e = f.elements[k];
+    if (e) e.value = c[k];
+  }
+});
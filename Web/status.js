@@ -0,0 +1,67 @@
+// Renders /status.json into the tables of status.html
+function $(id) { return document.getElementById(id); }
+function pct(v) { return (v * 100).toFixed(1) + '%'; }
+function kb(v) { return (v / 1024).toFixed(1) + ' KB'; }
+function state(id, up, text) { var e = $(id); e.textContent = text; e.className = up ? 'up' : 'down'; }
+
+function uptime(s) {
+  var d = Math.floor(s / 86400), h = Math.floor(s / 3600) % 24, m = Math.floor(s / 60) % 60;
+  return (d ? d + 'd ' : '') + h + 'h ' + m + 'm';
+}
+
+function render(s) {
+  $('hash').textContent = s.hash;
+  state('radio', s.radio, s.radio ? 'Online' : 'Offline');
+  $('freq').textContent = (s.freq / 1e6).toFixed(3) + ' MHz';
+  $('mod').textContent = 'SF' + s.sf + ' / ' + (s.bw / 1e3) + ' kHz / 4/' + s.cr + ' / ' + s.txp + ' dBm';
+  $('signal').textContent = s.rssi + ' dBm / ' + s.snr.toFixed(2) + ' dB';
+  $('noise').textContent = s.noise + ' dBm';
+  $('airtime').textContent = pct(s.airtime) + ' / ' + pct(s.airtime_lt);
+  $('load').textContent = pct(s.load) + ' / ' + pct(s.load_lt);
+  $('frames').textContent = s.rx + ' / ' + s.tx;
+  $('txq').textContent = s.txq;
+  state('wifi', s.wifi, s.wifi ? s.ip : 'Disconnected');
+  state('backbone', s.backbone, s.backbone ? 'Connected' : 'Down');
+  state('local', s.local, s.local ? 'Client connected' : 'Idle');
+  $('l2t').textContent = s.lora_to_tcp;
+  $('t2l').textContent = s.tcp_to_lora;
+  $('tables').textContent = s.paths + ' / ' + s.links;
+  $('uptime').textContent = uptime(s.uptime);
+  $('heap').textContent = kb(s.heap) + ' (' + kb(s.heap_min) + ')';
+  $('psram').textContent = s.psram ? kb(s.psram) : 'none';
+  $('age').textContent = 'Updated ' + new Date().toLocaleTimeString();
+}
+
+// Live updates come as deltas on /ws, merged into the last full state.
+// Without a socket (refused when the node has enough subscribers) the
+// page polls /status.json, and tries the socket again now and then.
+var state = {};
+var polling = null;
+
+function merge(delta) {
+  for (var k in delta) state[k] = delta[k];
+  render(state);
+}
+
+function poll() {
+  fetch('/status.json').then(function(r) { return r.json(); }).then(merge).catch(function() {});
+}
+
+function connect() {
+  var ws = new WebSocket('ws://' + location.host + '/ws');
+  ws.onmessage = function(e) {
+    if (polling) { clearInterval(polling); polling = null; }
+    merge(JSON.parse(e.data));
+  };
+  ws.onclose = function() {
+    if (!polling) { poll(); polling = setInterval(poll, 5000); }
+    setTimeout(connect, 30000);
+  };
+}
+
+if (window.WebSocket) {
+  connect();
+} else {
+  poll();
+  polling = setInterval(poll, 5000);
+}
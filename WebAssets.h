@@ -0,0 +1,92 @@
+// Copyright (C) 2026, Boundary Mode Extension
+// Based on microReticulum_Firmware by Mark Qvist
+//
+// WebAssets.h — Static pages of the config portal and the status server.
+//
+// The pages live in Web/ and are gzipped into flash at build time by
+// web_assets.py (WebAssetsData.h). They are sent as they are stored,
+// with Content-Encoding: gzip, streamed from flash by the async server
+// a TCP segment at a time, so serving a page allocates nothing the size
+// of the page. Each asset carries an ETag of its compressed bytes; a
+// browser revalidating with If-None-Match gets an empty 304.
+//
+// Anything that changes at runtime is fetched by the page as JSON from
+// a small handler instead of being templated into the HTML.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+#ifdef BOUNDARY_MODE
+
+// Console.h still includes the synchronous WebServer.h; ESPAsyncWebServer
+// 3.x takes its HTTP method enum from the same HTTP_Method.h, so both can
+// be included in one build.
+#include <ESPAsyncWebServer.h>
+
+struct WebAsset {
+    const char*    path;
+    const char*    content_type;
+    const uint8_t* data;          // gzipped, in flash
+    size_t         len;
+    const char*    etag;          // quoted, as sent
+};
+
+#include "WebAssetsData.h"
+
+inline const WebAsset* web_asset_find(const char* path) {
+    for (uint8_t i = 0; i < WEB_ASSET_COUNT; i++) {
+        if (strcmp(WEB_ASSETS[i].path, path) == 0) return &WEB_ASSETS[i];
+    }
+    return nullptr;
+}
+
+// Runs on the async_tcp task
+inline void web_send_asset(AsyncWebServerRequest* request, const WebAsset* asset) {
+    const AsyncWebHeader* match = request->getHeader("If-None-Match");
+    if (match && strcmp(match->value().c_str(), asset->etag) == 0) {
+        AsyncWebServerResponse* response = request->beginResponse(304);
+        response->addHeader("ETag", asset->etag);
+        request->send(response);
+        return;
+    }
+    AsyncWebServerResponse* response = request->beginResponse(200, asset->content_type, asset->data, asset->len);
+    response->addHeader("Content-Encoding", "gzip");
+    response->addHeader("ETag", asset->etag);
+    // Cached, but revalidated on every load so a firmware update shows at once
+    response->addHeader("Cache-Control", "no-cache");
+    request->send(response);
+}
+
+// Serves the asset at path, under as if given ("/" for the index page)
+inline void web_serve(AsyncWebServer* server, const char* path, const char* as = nullptr) {
+    const WebAsset* asset = web_asset_find(path);
+    if (!asset) return;
+    server->on(as ? as : path, HTTP_GET, [asset](AsyncWebServerRequest* request) {
+        web_send_asset(request, asset);
+    });
+}
+
+// Writes s as a quoted JSON string
+inline void web_json_string(Print& out, const char* s) {
+    out.write('"');
+    for (; *s; s++) {
+        char c = *s;
+        if (c == '"' || c == '\\') {
+            out.write('\\');
+            out.write(c);
+        } else if ((uint8_t)c < 0x20) {
+            out.printf("\\u%04x", (uint8_t)c);
+        } else {
+            out.write(c);
+        }
+    }
+    out.write('"');
+}
+
+#endif // BOUNDARY_MODE
+#endif // WEB_ASSETS_H
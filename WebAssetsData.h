@@ -0,0 +1,338 @@
+// Generated by web_assets.py from the files in Web/, do not edit.
+#pragma once
+
+// portal.html, 4703 bytes, 1682 gzipped
+static const uint8_t WEB_PORTAL_HTML[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xa5, 0x58, 0x5b, 0x4f, 0xe3, 0x38,
+    0x14, 0x7e, 0xe7, 0x57, 0x78, 0xb5, 0xd2, 0xa4, 0x48, 0x90, 0x34, 0xe9, 0x85, 0xb2, 0xb4, 0x95,
+    0x86, 0x9b, 0x18, 0x89, 0x01, 0x04, 0x8c, 0x76, 0xe6, 0x09, 0x39, 0x89, 0xd3, 0x78, 0x9b, 0xda,
+    0x59, 0xdb, 0xa1, 0x74, 0x7e, 0xfd, 0x9e, 0xe3, 0xa4, 0x2d, 0xbd, 0x24, 0xec, 0xec, 0xbe, 0xb4,
+    0x4d, 0xfc, 0xf9, 0xf8, 0x9c, 0xef, 0x5c, 0xdd, 0xe1, 0x6f, 0x97, 0xf7, 0x17, 0xcf, 0x3f, 0x1e,
+    0xae, 0x48, 0x6a, 0x66, 0xd9, 0x78, 0x58, 0x7d, 0x32, 0x1a, 0x8f, 0x0f, 0x86, 0x33, 0x66, 0x28,
+    0x11, 0x74, 0xc6, 0x46, 0xce, 0x2b, 0x67, 0xf3, 0x5c, 0x2a, 0xe3, 0x90, 0x48, 0x0a, 0xc3, 0x84,
+    0x19, 0x39, 0x73, 0x1e, 0x9b, 0x74, 0x14, 0xb3, 0x57, 0x1e, 0xb1, 0x63, 0xfb, 0x70, 0xc4, 0x05,
+    0x37, 0x9c, 0x66, 0xc7, 0x3a, 0xa2, 0x19, 0x1b, 0xf9, 0x0e, 0xc8, 0x30, 0xdc, 0x64, 0x6c, 0xfc,
+    0x78, 0x27, 0x63, 0x46, 0xce, 0x65, 0x21, 0x62, 0xaa, 0x16, 0xe4, 0x89, 0x99, 0x22, 0x1f, 0x7a,
+    0xe5, 0xda, 0xc1, 0x30, 0xe3, 0x62, 0x4a, 0x14, 0xcb, 0x46, 0x8e, 0x36, 0x8b, 0x8c, 0xe9, 0x94,
+    0x31, 0x38, 0x28, 0x55, 0x2c, 0x19, 0x39, 0x9e, 0x7d, 0xe5, 0x46, 0x5a, 0xa3, 0x34, 0xcf, 0x6a,
+    0x36, 0x0c, 0x65, 0xbc, 0x80, 0xa7, 0xd4, 0x1f, 0x7f, 0xfa, 0xfd, 0xcd, 0x4f, 0xba, 0xcc, 0x3f,
+    0x23, 0x5b, 0x47, 0xe0, 0x13, 0xc0, 0x7d, 0x80, 0xc5, 0xfc, 0x95, 0x44, 0x19, 0xd5, 0x7a, 0xe4,
+    0x08, 0x78, 0x7b, 0x9c, 0x52, 0x9d, 0x3a, 0xe3, 0xa1, 0xce, 0xa9, 0x58, 0xbd, 0x4f, 0x8f, 0x33,
+    0x1a, 0xb2, 0xcc, 0x29, 0x05, 0xf6, 0x7c, 0x10, 0x68, 0xe5, 0xdd, 0x00, 0x96, 0xb4, 0x1e, 0x99,
+    0xe1, 0x51, 0x91, 0x15, 0x33, 0x12, 0x33, 0x6d, 0xb8, 0xa0, 0x86, 0x4b, 0x71, 0x38, 0xf4, 0x50,
+    0xc4, 0x78, 0x18, 0x21, 0x90, 0xc7, 0x23, 0xa7, 0x12, 0xec, 0xe1, 0x0b, 0xf8, 0x82, 0x73, 0xe1,
+    0xf4, 0x44, 0xaa, 0x99, 0x5d, 0x8d, 0x92, 0x89, 0x43, 0x80, 0xd2, 0x54, 0xc2, 0xc3, 0xc3, 0xfd,
+    0xd3, 0xb3, 0x43, 0x68, 0x84, 0x82, 0xd0, 0x48, 0xfa, 0xca, 0xc0, 0x3e, 0x30, 0x29, 0xa8, 0x4c,
+    0x4a, 0xfa, 0x67, 0xe4, 0x4f, 0x7e, 0xcd, 0xc9, 0x1d, 0x33, 0x73, 0xa9, 0xa6, 0x60, 0x4b, 0x80,
+    0x54, 0xa1, 0x96, 0x63, 0x5c, 0x18, 0x7a, 0xe5, 0xef, 0x83, 0xa1, 0x66, 0x19, 0x8b, 0x4c, 0xe5,
+    0xa8, 0x39, 0x4f, 0xf8, 0x0b, 0x13, 0x48, 0x96, 0xcc, 0x51, 0x3a, 0x79, 0xa5, 0x59, 0x01, 0x0b,
+    0xe0, 0x8d, 0x2b, 0x41, 0xc3, 0x8c, 0xc5, 0x43, 0xaf, 0x5c, 0xd9, 0x81, 0xb4, 0x9d, 0xf1, 0x25,
+    0xd7, 0x16, 0x43, 0x5a, 0xb7, 0xf2, 0x91, 0x1e, 0x4b, 0x91, 0x2d, 0xc0, 0x33, 0x39, 0xa3, 0x86,
+    0xa9, 0xc3, 0x77, 0x1b, 0xbd, 0xf2, 0xd0, 0x95, 0x46, 0x4f, 0x4f, 0x5f, 0x2e, 0xd7, 0x1a, 0x71,
+    0x91, 0x17, 0x4b, 0x85, 0xb4, 0xe6, 0x31, 0xd8, 0x4d, 0xdf, 0x32, 0x26, 0x26, 0x10, 0x30, 0x4e,
+    0x27, 0x70, 0x48, 0x9e, 0xd1, 0x88, 0xa5, 0x32, 0x8b, 0x99, 0x1a, 0x39, 0x3f, 0x64, 0xa1, 0x4a,
+    0x5b, 0x45, 0x69, 0xab, 0xb3, 0x12, 0xfb, 0x00, 0xde, 0x81, 0x37, 0xf1, 0x7e, 0xd1, 0xb9, 0x9e,
+    0x3a, 0xc4, 0x2c, 0x72, 0xfc, 0x59, 0x01, 0x9b, 0x4f, 0xb2, 0x87, 0xac, 0xa0, 0xef, 0xf9, 0xee,
+    0xf8, 0xed, 0x33, 0xf2, 0x7c, 0xf1, 0x40, 0xce, 0x69, 0x34, 0x0d, 0xa5, 0x60, 0x1b, 0x7c, 0x7f,
+    0xb5, 0xc1, 0xb4, 0x97, 0x6f, 0x13, 0xe5, 0x2f, 0x33, 0x58, 0x76, 0x9a, 0xd8, 0xac, 0x65, 0x1c,
+    0x9c, 0x72, 0x91, 0x71, 0x48, 0x27, 0xd2, 0x82, 0xbc, 0x12, 0x28, 0xd6, 0x48, 0x12, 0x56, 0x3a,
+    0x34, 0x11, 0xbe, 0xd4, 0x93, 0xdc, 0x48, 0x6d, 0x5a, 0xfa, 0x70, 0x3f, 0x43, 0x61, 0xf8, 0x92,
+    0xc2, 0xfa, 0x06, 0x2b, 0xfd, 0xce, 0x16, 0x2b, 0xcc, 0x9d, 0xb8, 0xc4, 0x3f, 0x0d, 0x5c, 0xbf,
+    0x3f, 0x70, 0x7d, 0xd7, 0x6f, 0xb7, 0x8f, 0xac, 0x0a, 0x45, 0xee, 0xb2, 0x37, 0x3a, 0xcb, 0x21,
+    0xfd, 0xa4, 0x9a, 0xfc, 0xd1, 0x3d, 0xed, 0xf7, 0x9c, 0xdd, 0xf3, 0x1f, 0xa0, 0x2a, 0xd4, 0x1e,
+    0x5e, 0x96, 0x8c, 0xd2, 0x45, 0xa2, 0x98, 0x85, 0x4c, 0x81, 0x2a, 0x5c, 0xa0, 0xe1, 0xa8, 0x12,
+    0x28, 0xd3, 0xeb, 0x75, 0x7a, 0x9b, 0x91, 0x8f, 0xc9, 0x7c, 0x2b, 0xa1, 0x82, 0x40, 0x99, 0x50,
+    0xaf, 0x4c, 0x91, 0x56, 0x49, 0x02, 0xcd, 0x0e, 0x2b, 0xa7, 0xe4, 0xeb, 0x74, 0x36, 0x40, 0xbc,
+    0x85, 0x91, 0xcc, 0x6e, 0x29, 0xcb, 0x91, 0x26, 0x40, 0xb1, 0x49, 0x19, 0xd1, 0xa0, 0xc8, 0x46,
+    0x68, 0x11, 0x89, 0x12, 0xd1, 0xd1, 0x52, 0x91, 0x6f, 0x97, 0x0f, 0x2e, 0xf9, 0xa6, 0x01, 0xfe,
+    0x39, 0x82, 0x4d, 0x1a, 0x6c, 0xe1, 0xe0, 0x0a, 0x74, 0x27, 0x69, 0xc5, 0x12, 0xde, 0xc3, 0x01,
+    0x04, 0x12, 0x78, 0x4e, 0x55, 0x4c, 0xa8, 0x10, 0x50, 0x5c, 0x00, 0x77, 0xe8, 0x0e, 0xbd, 0x7c,
+    0x45, 0xc4, 0x7b, 0x55, 0x6b, 0x62, 0x84, 0xe6, 0x2f, 0x18, 0x26, 0xfb, 0xb2, 0xf2, 0x5f, 0x06,
+    0x09, 0x2a, 0xac, 0xab, 0x23, 0x6a, 0x50, 0x81, 0x33, 0x06, 0x7b, 0x48, 0xa8, 0x24, 0x8d, 0x23,
+    0xaa, 0xcd, 0xde, 0xd8, 0xd9, 0x62, 0x0e, 0x37, 0x68, 0x26, 0x62, 0x4d, 0x18, 0x8d, 0x52, 0xc8,
+    0x8c, 0x68, 0xca, 0x0c, 0x70, 0x17, 0x31, 0x0c, 0x43, 0x24, 0x70, 0x0e, 0x41, 0xc2, 0xc8, 0xed,
+    0xe7, 0xbb, 0x23, 0x52, 0x68, 0x46, 0x28, 0x59, 0x97, 0x42, 0xd8, 0xfc, 0x05, 0x5a, 0x81, 0x4a,
+    0x20, 0x94, 0x36, 0xf8, 0x46, 0xa7, 0x2f, 0x5f, 0x54, 0xfe, 0xd8, 0x60, 0xac, 0x3e, 0x62, 0x2a,
+    0xa2, 0xfe, 0x4b, 0xd4, 0x24, 0x21, 0x46, 0xcd, 0x23, 0x28, 0x48, 0x63, 0x2e, 0x37, 0xb2, 0xf7,
+    0x5a, 0xb1, 0xbf, 0x0b, 0x26, 0xa2, 0x05, 0x69, 0x7d, 0xbd, 0xf9, 0x59, 0x93, 0x29, 0x09, 0x80,
+    0x96, 0x67, 0x1a, 0xf6, 0x66, 0xb6, 0x72, 0xe4, 0xd4, 0xef, 0xba, 0x83, 0x13, 0x1b, 0xff, 0x5b,
+    0x1c, 0xda, 0xec, 0xa9, 0x96, 0x8f, 0xc8, 0x00, 0x52, 0xa8, 0x8d, 0x09, 0xd4, 0xed, 0x74, 0xf0,
+    0xc7, 0x7b, 0xbb, 0xcf, 0xa9, 0x88, 0x6d, 0x9f, 0xac, 0x09, 0x93, 0x70, 0xbe, 0x1b, 0x1f, 0x27,
+    0x83, 0x36, 0x84, 0xc8, 0x89, 0x3b, 0x20, 0xd3, 0x9b, 0x9f, 0xf5, 0x11, 0xd2, 0xee, 0x22, 0xcc,
+    0x6f, 0xbb, 0xdd, 0x66, 0x5c, 0xaf, 0x6f, 0x71, 0x3d, 0xb7, 0xdf, 0x88, 0x0b, 0xda, 0xf6, 0xd8,
+    0xa0, 0xfd, 0xc1, 0xb9, 0x1d, 0x3f, 0xe8, 0x01, 0xae, 0xe3, 0xbb, 0x41, 0xaf, 0x11, 0xd8, 0xf5,
+    0x4f, 0x50, 0x60, 0xd7, 0x77, 0x4f, 0x1a, 0x71, 0x7d, 0x90, 0x07, 0xb8, 0x7e, 0xe0, 0x36, 0xcb,
+    0xc3, 0x73, 0xad, 0x25, 0x1f, 0x9c, 0x6b, 0x61, 0x68, 0x49, 0xaf, 0xdd, 0x88, 0xb3, 0x30, 0xc0,
+    0xc1, 0xf7, 0x16, 0x6e, 0xa7, 0xd1, 0xe5, 0x0a, 0x46, 0x10, 0x2e, 0x26, 0xe4, 0x1a, 0xba, 0xb7,
+    0xac, 0x4b, 0x79, 0x9d, 0xec, 0xfa, 0x12, 0xa2, 0xe7, 0xe9, 0xba, 0xb7, 0x92, 0xbd, 0x6d, 0x3a,
+    0xae, 0xf6, 0x6b, 0x35, 0x3c, 0xc1, 0xe5, 0x93, 0xba, 0xcd, 0x03, 0x5c, 0x1d, 0xd4, 0x6e, 0x3e,
+    0xc5, 0xe5, 0xd3, 0xba, 0xcd, 0x7e, 0x1b, 0x97, 0xfd, 0x76, 0x3d, 0xdb, 0xbe, 0x05, 0xf8, 0xb5,
+    0x02, 0x02, 0xbb, 0x1e, 0x34, 0xd0, 0x76, 0x21, 0x2d, 0x67, 0x8f, 0x30, 0x47, 0xd4, 0x30, 0x16,
+    0xa9, 0xbd, 0x8c, 0x75, 0xbd, 0x26, 0xc6, 0xba, 0x5e, 0x23, 0x63, 0x5d, 0xaf, 0x89, 0xb1, 0xae,
+    0x37, 0x68, 0xd0, 0xf8, 0xf9, 0x3b, 0xb4, 0x83, 0x39, 0xb6, 0x9f, 0xf8, 0x7c, 0x56, 0x53, 0x34,
+    0xcc, 0x5b, 0xbe, 0xb7, 0x4e, 0x05, 0x55, 0x9d, 0x0a, 0x82, 0xdd, 0x82, 0x61, 0x67, 0x41, 0xd8,
+    0xf8, 0x52, 0x96, 0x0f, 0x5b, 0x20, 0xd6, 0x75, 0xac, 0xe7, 0x07, 0x67, 0xcb, 0x91, 0x6f, 0xd9,
+    0x95, 0x5a, 0x5f, 0xae, 0x3f, 0x5f, 0xd4, 0xf6, 0x3e, 0x03, 0x45, 0x79, 0xd9, 0xdc, 0x50, 0x2b,
+    0xe8, 0x53, 0xb1, 0x07, 0xcd, 0x0d, 0xc7, 0x9c, 0x3c, 0x55, 0x54, 0xdb, 0x5a, 0xae, 0x60, 0x6e,
+    0x55, 0x1c, 0xc8, 0xb6, 0x35, 0x92, 0xaf, 0xea, 0x36, 0xb5, 0x47, 0xb8, 0xe4, 0x1e, 0x07, 0x3d,
+    0x9c, 0x8e, 0x35, 0x99, 0x73, 0x93, 0x82, 0xfa, 0x26, 0x4a, 0xd1, 0x63, 0x9a, 0x19, 0x18, 0x78,
+    0x27, 0x9a, 0x44, 0x38, 0x2d, 0xcb, 0xd9, 0xac, 0x10, 0x3c, 0x02, 0x2f, 0xba, 0x30, 0x6a, 0x03,
+    0x2e, 0xe1, 0x2c, 0x83, 0xf6, 0x41, 0x15, 0xb4, 0x80, 0xaa, 0x4b, 0x6f, 0xd4, 0x7a, 0x54, 0xbd,
+    0xc6, 0xe1, 0x1c, 0x14, 0xf8, 0x3f, 0x3d, 0x71, 0x77, 0x9a, 0xdd, 0x76, 0xe1, 0x92, 0xc7, 0x3b,
+    0x38, 0x6f, 0xbf, 0x03, 0xad, 0x0e, 0xf8, 0xb3, 0x79, 0x6e, 0xb4, 0x35, 0xfe, 0xeb, 0xe2, 0x6e,
+    0xdf, 0x78, 0x5a, 0x72, 0xdc, 0x20, 0x1e, 0x1d, 0xf1, 0x6b, 0x63, 0xea, 0x53, 0x0a, 0x7c, 0xc6,
+    0x40, 0x7d, 0xa4, 0xe0, 0x22, 0xb4, 0x0e, 0x8f, 0xa0, 0x7f, 0x7a, 0x7a, 0x46, 0xee, 0xad, 0xb9,
+    0x7a, 0xa3, 0xc5, 0x01, 0x5f, 0x20, 0x61, 0x41, 0xce, 0x33, 0x2a, 0xa6, 0xe0, 0xae, 0x1a, 0xca,
+    0x63, 0x80, 0xbd, 0x84, 0x88, 0xd9, 0xcb, 0xfa, 0x1d, 0x6b, 0x1a, 0x30, 0x80, 0x72, 0x1f, 0xc3,
+    0xbb, 0xc0, 0x14, 0xae, 0xab, 0xa3, 0x50, 0x42, 0x2b, 0x8c, 0x6e, 0xe8, 0x56, 0xd8, 0xaa, 0x3e,
+    0x84, 0x75, 0xb0, 0xb3, 0x7c, 0x0c, 0xeb, 0x63, 0xbf, 0xd8, 0x07, 0xab, 0x9d, 0x7a, 0x9e, 0x0b,
+    0x25, 0x88, 0x4c, 0x12, 0x12, 0x57, 0xac, 0xd1, 0x04, 0xd2, 0x01, 0x92, 0x02, 0xaf, 0x63, 0xaf,
+    0xdc, 0x2c, 0x30, 0x61, 0xf0, 0x46, 0x06, 0x93, 0xcc, 0x1c, 0x09, 0xc9, 0x77, 0x78, 0xbe, 0x57,
+    0x38, 0xb4, 0xdb, 0x6b, 0x60, 0x13, 0xd5, 0x4a, 0x9a, 0xbd, 0x44, 0xdf, 0x42, 0x8e, 0xc2, 0x1d,
+    0x39, 0x67, 0x4d, 0x64, 0xe3, 0x98, 0xa4, 0x28, 0x37, 0x4d, 0x13, 0xdf, 0x4a, 0x10, 0xb9, 0xce,
+    0x78, 0x9e, 0x37, 0x24, 0x4c, 0x67, 0x2d, 0x70, 0x0f, 0xb6, 0x96, 0xab, 0x8b, 0x54, 0x4a, 0xac,
+    0x20, 0x30, 0xca, 0xc9, 0xb5, 0xcd, 0xf0, 0x4c, 0x4d, 0x59, 0x23, 0xa0, 0x60, 0x2c, 0xf0, 0xfe,
+    0x76, 0x7f, 0x7b, 0x75, 0x09, 0x93, 0x73, 0x21, 0xb0, 0x5a, 0xb8, 0x64, 0xad, 0xd8, 0xcc, 0x16,
+    0x15, 0x1b, 0xdf, 0x56, 0x0c, 0xa4, 0x10, 0xd1, 0x20, 0xa6, 0x80, 0x97, 0x54, 0xc0, 0x12, 0xdc,
+    0x0f, 0x19, 0x09, 0x17, 0xf6, 0xfb, 0xcc, 0x0e, 0x8f, 0x56, 0xc9, 0x72, 0x1f, 0x20, 0xa3, 0x29,
+    0xee, 0x9b, 0x6d, 0x94, 0x95, 0x0b, 0x29, 0x12, 0x3e, 0x21, 0xcf, 0x72, 0xca, 0xc4, 0xfe, 0xd4,
+    0x83, 0xdb, 0xf6, 0x8b, 0xc1, 0xe5, 0x5f, 0x4b, 0xbd, 0xab, 0x59, 0x0e, 0xfe, 0x1f, 0x91, 0x8c,
+    0x83, 0xfb, 0xa3, 0x94, 0x8a, 0x09, 0x5e, 0x26, 0x92, 0xc4, 0xd9, 0x47, 0x0d, 0xac, 0x62, 0x89,
+    0x54, 0x38, 0x71, 0x62, 0xd9, 0x5d, 0x5d, 0xdc, 0xd6, 0x55, 0x13, 0x8b, 0xa9, 0x2c, 0xb0, 0x46,
+    0x2b, 0x16, 0x4a, 0xb8, 0x4d, 0xb4, 0xf0, 0xe6, 0x4f, 0xbc, 0xa8, 0x34, 0x60, 0x39, 0x36, 0x97,
+    0x7c, 0x94, 0x13, 0xfe, 0x21, 0x94, 0x73, 0x06, 0x35, 0xd5, 0xa4, 0x1c, 0x3e, 0xd0, 0x04, 0x08,
+    0x4d, 0x10, 0x4f, 0xbe, 0x1f, 0x97, 0x66, 0x1f, 0x5b, 0xb3, 0x09, 0xfe, 0x15, 0xc2, 0x14, 0x50,
+    0xcd, 0x30, 0x54, 0x81, 0x31, 0x66, 0x75, 0xb7, 0xc5, 0x3e, 0xb1, 0xc3, 0x7a, 0x96, 0x11, 0x5d,
+    0xc0, 0x5c, 0x6f, 0xe7, 0x5f, 0x6d, 0xaa, 0x29, 0xfc, 0x60, 0x18, 0x16, 0xc6, 0xe0, 0xc9, 0x96,
+    0x17, 0x5d, 0x84, 0x33, 0x0e, 0x61, 0xfa, 0x84, 0x52, 0x3e, 0xc1, 0x75, 0xef, 0x0c, 0x66, 0x7c,
+    0x54, 0x75, 0xe8, 0x95, 0x38, 0x0c, 0x0f, 0xfc, 0x13, 0x03, 0x23, 0x3c, 0x52, 0x3c, 0x37, 0x44,
+    0xab, 0x68, 0xe4, 0x78, 0xe8, 0x29, 0xa8, 0xf6, 0x7f, 0x69, 0x6c, 0x62, 0xe5, 0x0a, 0x42, 0xed,
+    0x7f, 0x33, 0x50, 0x9c, 0xf0, 0x8f, 0xa4, 0x83, 0x7f, 0x00, 0xcc, 0xba, 0xea, 0x87, 0x5f, 0x12,
+    0x00, 0x00,
+};
+
+// portal.js, 628 bytes, 369 gzipped
+static const uint8_t WEB_PORTAL_JS[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x7d, 0x91, 0xc1, 0x4a, 0xc4, 0x40,
+    0x0c, 0x86, 0xef, 0xfb, 0x14, 0xc1, 0x83, 0xd3, 0x22, 0xcc, 0xde, 0xdd, 0x55, 0x50, 0x51, 0x14,
+    0x54, 0x3c, 0x78, 0x13, 0x91, 0x3a, 0xcd, 0xb4, 0xa3, 0x6d, 0x66, 0x99, 0x49, 0x75, 0x45, 0xf6,
+    0xdd, 0x4d, 0x5a, 0xc5, 0x55, 0xd0, 0x43, 0x21, 0x4d, 0xbe, 0xfc, 0x99, 0xfc, 0x99, 0xcf, 0xe1,
+    0x2c, 0x74, 0x5d, 0x06, 0x6e, 0x11, 0x32, 0xf2, 0xb0, 0x02, 0x1f, 0x53, 0x0f, 0xaf, 0x81, 0xdb,
+    0x29, 0xc7, 0x31, 0x61, 0xad, 0x25, 0x0e, 0xd4, 0x64, 0xf0, 0x29, 0xf6, 0x30, 0x77, 0x91, 0x7c,
+    0x68, 0xec, 0x53, 0x8e, 0x34, 0xf3, 0xc8, 0xae, 0x2d, 0xcc, 0x76, 0xce, 0x94, 0x56, 0x7a, 0xa9,
+    0xf0, 0x03, 0x39, 0x0e, 0x91, 0x8a, 0x54, 0xc2, 0x3b, 0x24, 0x91, 0x4f, 0x04, 0x69, 0x44, 0x8a,
+    0x72, 0x01, 0x9b, 0xdf, 0x98, 0x13, 0x6c, 0x06, 0xf0, 0x52, 0x25, 0xf0, 0x70, 0x00, 0x75, 0x74,
+    0x43, 0x8f, 0xc4, 0xb6, 0x41, 0x3e, 0xed, 0x50, 0xc3, 0xe3, 0xb7, 0x8b, 0xba, 0x30, 0xce, 0x37,
+    0xa6, 0x5c, 0x7c, 0x92, 0x6d, 0x95, 0xdb, 0xff, 0x60, 0xad, 0x4f, 0x74, 0xf0, 0x50, 0x38, 0xab,
+    0xff, 0xd3, 0x1c, 0x18, 0x7b, 0x2d, 0xe3, 0x9a, 0x4f, 0x22, 0xb1, 0x74, 0x88, 0xce, 0x04, 0x28,
+    0xbe, 0x01, 0xec, 0x32, 0x6e, 0x93, 0x81, 0x08, 0xd3, 0xf9, 0xed, 0xd5, 0xa5, 0x70, 0x3b, 0xcb,
+    0xbc, 0xaa, 0x08, 0x5c, 0x57, 0xe5, 0x7c, 0x60, 0x06, 0x12, 0x87, 0xcc, 0xe1, 0x75, 0x64, 0x78,
+    0x43, 0x06, 0xc9, 0x85, 0x86, 0xc4, 0xb7, 0xdd, 0xbe, 0x56, 0x35, 0xf1, 0xb3, 0xeb, 0xe0, 0x71,
+    0xb4, 0x18, 0x22, 0x81, 0x0f, 0x29, 0x33, 0x90, 0x38, 0x5d, 0x49, 0x3a, 0x46, 0x5e, 0xce, 0x55,
+    0xed, 0x70, 0x67, 0x9c, 0x2b, 0x9f, 0xb7, 0xbc, 0x5e, 0xd9, 0xbe, 0x5a, 0x8f, 0x2f, 0x92, 0xf8,
+    0x41, 0x62, 0x2d, 0xfe, 0xb9, 0xa6, 0x32, 0x14, 0x19, 0xd5, 0xfb, 0x1f, 0x0b, 0x99, 0x2b, 0x51,
+    0x89, 0x03, 0xaf, 0x06, 0xd6, 0xdb, 0xca, 0x55, 0x43, 0x96, 0x99, 0x55, 0xaa, 0xf7, 0xc1, 0xc0,
+    0xde, 0xb7, 0xbc, 0xc4, 0x06, 0xea, 0xe3, 0x1e, 0x8a, 0xf1, 0xfa, 0x37, 0x47, 0xa5, 0xd1, 0x89,
+    0xda, 0x53, 0xa8, 0xd1, 0xcf, 0x10, 0x64, 0xdf, 0x2f, 0xeb, 0x34, 0x83, 0x22, 0xef, 0x2d, 0x4e,
+    0xcf, 0xc8, 0x77, 0xcf, 0xf7, 0x8b, 0xb1, 0xa4, 0x3e, 0x63, 0x09, 0x68, 0x5f, 0xaa, 0x6e, 0x50,
+    0xc6, 0x7d, 0x96, 0x36, 0xb3, 0x8d, 0x1c, 0xe2, 0x03, 0x25, 0x90, 0x78, 0x02, 0x74, 0x02, 0x00,
+    0x00,
+};
+
+// saved.html, 446 bytes, 328 gzipped
+static const uint8_t WEB_SAVED_HTML[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x3d, 0x51, 0xcf, 0x4b, 0xc3, 0x30,
+    0x14, 0xbe, 0xef, 0xaf, 0x78, 0x32, 0x30, 0x07, 0xd7, 0x75, 0x53, 0x36, 0x65, 0x4b, 0x7a, 0xd9,
+    0x14, 0x3c, 0x29, 0x28, 0x88, 0xc7, 0x2c, 0x79, 0xb5, 0x61, 0x69, 0x52, 0x92, 0xd7, 0xd6, 0xf9,
+    0xd7, 0x9b, 0xd6, 0xe2, 0x25, 0xf0, 0xbd, 0x97, 0x7c, 0xbf, 0xc2, 0xaf, 0x8e, 0x2f, 0x87, 0xf7,
+    0xcf, 0xd7, 0x47, 0xa8, 0xa8, 0xb6, 0x05, 0x9f, 0x4e, 0x94, 0xba, 0x98, 0xf1, 0x1a, 0x49, 0x82,
+    0x93, 0x35, 0x0a, 0xd6, 0x19, 0xec, 0x1b, 0x1f, 0x88, 0x81, 0xf2, 0x8e, 0xd0, 0x91, 0x60, 0xbd,
+    0xd1, 0x54, 0x09, 0x8d, 0x9d, 0x51, 0x98, 0x8d, 0x60, 0x61, 0x9c, 0x21, 0x23, 0x6d, 0x16, 0x95,
+    0xb4, 0x28, 0xd6, 0x2c, 0x71, 0x90, 0x21, 0x8b, 0xc5, 0x9b, 0xec, 0x50, 0xf3, 0xfc, 0x0f, 0xcc,
+    0xb8, 0x35, 0xee, 0x0c, 0x01, 0xad, 0x60, 0x91, 0x2e, 0x16, 0x63, 0x85, 0x98, 0x98, 0xab, 0x80,
+    0xa5, 0x60, 0xf9, 0x38, 0x5a, 0xaa, 0x18, 0x87, 0xe7, 0xf9, 0x68, 0x85, 0x9f, 0xbc, 0xbe, 0x24,
+    0xa4, 0x4d, 0x07, 0xca, 0xca, 0x18, 0x05, 0xf3, 0xe7, 0x61, 0x5d, 0xad, 0x8b, 0xeb, 0xf9, 0xf7,
+    0xed, 0xfd, 0x6a, 0xb3, 0x87, 0x83, 0x77, 0xa5, 0xf9, 0x6a, 0x83, 0x24, 0xe3, 0x1d, 0x4c, 0x8a,
+    0xe9, 0xc2, 0x8c, 0x37, 0xc5, 0x71, 0x74, 0x09, 0xbd, 0xb1, 0x36, 0xe9, 0x9e, 0xbc, 0x27, 0x30,
+    0x0e, 0xee, 0x20, 0x62, 0x8a, 0xa3, 0x23, 0x48, 0xa7, 0x87, 0x60, 0x0e, 0x15, 0x01, 0x79, 0xb8,
+    0xf8, 0x36, 0xc0, 0x87, 0x79, 0x32, 0xe0, 0x90, 0x7a, 0x1f, 0xce, 0x4b, 0x9e, 0x37, 0x03, 0x11,
+    0x8c, 0xe6, 0x04, 0x53, 0xde, 0xfa, 0xb0, 0x9b, 0x6f, 0xb7, 0xdb, 0x7d, 0x99, 0xfa, 0xc8, 0xa2,
+    0xf9, 0xc1, 0xdd, 0x6a, 0xf9, 0xb0, 0xc1, 0x7a, 0xcf, 0x8a, 0xe7, 0x12, 0xa8, 0x42, 0xf8, 0xab,
+    0x06, 0x94, 0x74, 0x2e, 0xe9, 0x4d, 0xf4, 0x0b, 0xa8, 0xbc, 0xd5, 0xe3, 0xfe, 0xd4, 0x12, 0x25,
+    0xa7, 0xa5, 0x0f, 0xb0, 0xb9, 0xf9, 0xb7, 0x92, 0xe4, 0x03, 0x66, 0xa9, 0x61, 0x0c, 0x69, 0x46,
+    0x6d, 0x33, 0x69, 0xe7, 0x29, 0x7c, 0xc1, 0xf3, 0xb1, 0x89, 0x94, 0x6b, 0xf8, 0xa7, 0xd9, 0x2f,
+    0xb3, 0xef, 0x56, 0x46, 0xbe, 0x01, 0x00, 0x00,
+};
+
+// status.html, 1529 bytes, 636 gzipped
+static const uint8_t WEB_STATUS_HTML[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x7d, 0x54, 0xef, 0x6f, 0xd3, 0x30,
+    0x10, 0xfd, 0xde, 0xbf, 0xc2, 0x08, 0x69, 0xd9, 0x24, 0xba, 0x90, 0xf2, 0x43, 0x9a, 0x9a, 0x44,
+    0xda, 0x06, 0x08, 0xa4, 0x6d, 0x54, 0x69, 0x11, 0xe3, 0xa3, 0x1b, 0x5f, 0x1b, 0x33, 0xc7, 0x0e,
+    0xf6, 0xa5, 0x5d, 0xff, 0x7b, 0xce, 0x49, 0xd9, 0x70, 0x95, 0xee, 0x4b, 0xd3, 0xdc, 0xbd, 0xf7,
+    0x7c, 0x7a, 0x7e, 0xb9, 0xf4, 0xd5, 0xa7, 0xef, 0xd7, 0x8b, 0x5f, 0xb3, 0xcf, 0xac, 0xc2, 0x5a,
+    0xe5, 0xe9, 0xfe, 0x17, 0xb8, 0xc8, 0x47, 0x69, 0x0d, 0xc8, 0x99, 0xe6, 0x35, 0x64, 0xd1, 0x46,
+    0xc2, 0xb6, 0x31, 0x16, 0x23, 0x56, 0x1a, 0x8d, 0xa0, 0x31, 0x8b, 0xb6, 0x52, 0x60, 0x95, 0x09,
+    0xd8, 0xc8, 0x12, 0xc6, 0xdd, 0xcb, 0x1b, 0xa9, 0x25, 0x4a, 0xae, 0xc6, 0xae, 0xe4, 0x0a, 0xb2,
+    0x24, 0x22, 0x0d, 0x94, 0xa8, 0x20, 0x2f, 0xee, 0x8c, 0x00, 0x76, 0x65, 0x5a, 0x2d, 0xb8, 0xdd,
+    0xb1, 0x39, 0x72, 0x6c, 0x5d, 0x1a, 0xf7, 0xcd, 0x51, 0xaa, 0xa4, 0x7e, 0x60, 0x16, 0x54, 0x16,
+    0x39, 0xdc, 0x29, 0x70, 0x15, 0x00, 0x9d, 0x54, 0x59, 0x58, 0x65, 0x51, 0xdc, 0x95, 0xce, 0x4b,
+    0xe7, 0xbc, 0x5c, 0xdc, 0x8d, 0x96, 0x2e, 0x8d, 0xd8, 0xe5, 0xa9, 0x90, 0x1b, 0x56, 0x2a, 0xee,
+    0x5c, 0x16, 0x35, 0x7c, 0x0d, 0xbe, 0x5f, 0x25, 0xf9, 0xc9, 0xeb, 0xc7, 0x64, 0xf5, 0x1e, 0x92,
+    0x29, 0x3b, 0x38, 0xd5, 0xbf, 0x91, 0x40, 0x42, 0xb0, 0xff, 0x98, 0x9a, 0xaa, 0xe3, 0x8a, 0xbb,
+    0x2a, 0xca, 0x53, 0xd7, 0x70, 0xfd, 0x54, 0xaf, 0xc6, 0x8a, 0x2f, 0x41, 0x45, 0xbd, 0xe0, 0x87,
+    0x84, 0x04, 0x3b, 0xbd, 0xaf, 0x84, 0x65, 0xa7, 0x05, 0xa0, 0x2c, 0x5b, 0xd5, 0xd6, 0x4c, 0x80,
+    0x43, 0xa9, 0x39, 0x4a, 0xa3, 0xcf, 0xd2, 0xd8, 0x4b, 0xe4, 0x69, 0xe9, 0x81, 0x52, 0x64, 0xd1,
+    0x5e, 0x38, 0xf6, 0x05, 0x7a, 0xd0, 0xb9, 0xf9, 0x88, 0xa6, 0x9c, 0xec, 0xa7, 0x5c, 0x2d, 0xa7,
+    0xec, 0xc6, 0x14, 0x9c, 0x15, 0x5c, 0x48, 0x43, 0xc3, 0x4d, 0xbc, 0x65, 0x7c, 0xd9, 0xb9, 0x82,
+    0x36, 0x4f, 0x51, 0xe4, 0xfb, 0x16, 0xfd, 0xa3, 0xb7, 0x4e, 0xd4, 0xfa, 0x8a, 0x57, 0xf5, 0xb5,
+    0x98, 0x60, 0x4f, 0xd8, 0x2f, 0x16, 0xfe, 0xb4, 0xa0, 0xcb, 0x5d, 0x80, 0x5f, 0x51, 0x75, 0x10,
+    0x7e, 0x6b, 0x44, 0xab, 0xba, 0xc9, 0x03, 0x7c, 0x6d, 0xc4, 0x20, 0xfc, 0x86, 0x3b, 0x64, 0xc5,
+    0x7c, 0xfe, 0x8d, 0xc5, 0x6c, 0x7e, 0x57, 0x04, 0x1c, 0x27, 0xd7, 0x9a, 0xab, 0x41, 0xda, 0x9d,
+    0x91, 0x0e, 0xd8, 0x4a, 0x19, 0x63, 0x03, 0x8a, 0xf6, 0xf5, 0x41, 0xc6, 0xa5, 0xb4, 0x28, 0x6b,
+    0x60, 0xa7, 0xae, 0xa2, 0xcc, 0xd1, 0x69, 0xca, 0xe8, 0xf5, 0x59, 0x40, 0xe6, 0x3d, 0x64, 0x90,
+    0x7e, 0x5d, 0x71, 0xad, 0x41, 0x11, 0x8b, 0x8b, 0x97, 0x34, 0x7c, 0xff, 0x88, 0x8d, 0x14, 0x7a,
+    0xc7, 0x8a, 0x7b, 0xa2, 0x2d, 0xee, 0x0f, 0xbc, 0xf4, 0xad, 0x41, 0xd6, 0xe2, 0x9e, 0x91, 0xf9,
+    0x2d, 0x04, 0x78, 0x7c, 0x3c, 0xb0, 0x3e, 0xde, 0x5f, 0xef, 0x73, 0x0a, 0xde, 0x25, 0x6f, 0x29,
+    0x5a, 0x80, 0x5b, 0x63, 0x1f, 0x86, 0x23, 0xf0, 0x53, 0x7e, 0x91, 0x81, 0xea, 0x56, 0xae, 0xe4,
+    0xe0, 0x0c, 0x57, 0xbc, 0x7c, 0x58, 0x1a, 0x1d, 0xce, 0xb0, 0xdc, 0x17, 0x87, 0x2f, 0xd5, 0xd0,
+    0xc7, 0xca, 0x1c, 0xd8, 0x0d, 0xd8, 0x03, 0x77, 0xca, 0x23, 0x17, 0x7a, 0x65, 0xa5, 0x58, 0x83,
+    0xe8, 0x93, 0x7b, 0x62, 0xb9, 0xb5, 0x53, 0xb6, 0xb8, 0x9e, 0x85, 0xec, 0x09, 0xbe, 0xc8, 0x25,
+    0xfc, 0x3f, 0xaa, 0x97, 0x09, 0x3d, 0x9b, 0x0c, 0x9f, 0x3b, 0xe3, 0x58, 0x39, 0x7f, 0x93, 0xb4,
+    0x2e, 0x5c, 0xc8, 0xf0, 0x7e, 0xb9, 0x97, 0x8d, 0x9e, 0x7c, 0xbc, 0xb8, 0x98, 0xb2, 0xf9, 0xce,
+    0x21, 0xd4, 0xc3, 0x36, 0xff, 0x68, 0x7c, 0xa4, 0x02, 0xe1, 0xb6, 0x39, 0x9a, 0x32, 0xfa, 0xd6,
+    0x80, 0xd1, 0x3a, 0x6a, 0xd8, 0x69, 0x2d, 0x75, 0x98, 0x2c, 0x5f, 0x3e, 0x4e, 0x9a, 0xcd, 0x8b,
+    0xcb, 0xdb, 0x00, 0xdf, 0x38, 0x8a, 0xd5, 0xf0, 0xf8, 0x69, 0xf3, 0xbc, 0xa9, 0x10, 0xa2, 0x3e,
+    0xfc, 0xeb, 0x6e, 0xa4, 0xc6, 0xc3, 0xba, 0x95, 0x92, 0xba, 0xd2, 0xca, 0x06, 0x99, 0xb3, 0x65,
+    0xb7, 0x31, 0xfd, 0x7a, 0x3d, 0xff, 0xdd, 0x19, 0xd2, 0x77, 0x3c, 0xb2, 0x5f, 0x9a, 0x71, 0xb7,
+    0xe2, 0x47, 0x7f, 0x01, 0x47, 0x6f, 0xc4, 0x40, 0xf9, 0x05, 0x00, 0x00,
+};
+
+// status.js, 2580 bytes, 1096 gzipped
+static const uint8_t WEB_STATUS_JS[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x7d, 0x56, 0xdb, 0x8e, 0xdb, 0x36,
+    0x10, 0x7d, 0xdf, 0xaf, 0x98, 0x02, 0x09, 0x44, 0x35, 0x86, 0xec, 0x78, 0xb7, 0x46, 0x11, 0x23,
+    0x28, 0xb0, 0x49, 0x83, 0x6c, 0x9b, 0x64, 0x81, 0x6e, 0x8b, 0x3c, 0x14, 0xc5, 0x82, 0x16, 0x29,
+    0x8b, 0x35, 0x4d, 0x2a, 0x24, 0x65, 0xb9, 0x09, 0xf6, 0xdf, 0x3b, 0x43, 0x5d, 0x2c, 0x5f, 0xda,
+    0x27, 0x53, 0x73, 0x39, 0x73, 0xe6, 0xc2, 0xa1, 0xa7, 0x53, 0xf8, 0x4d, 0x1a, 0x21, 0x9d, 0x87,
+    0xa9, 0x0f, 0x3c, 0xd4, 0x3e, 0xfb, 0xdb, 0x5b, 0x03, 0xca, 0x04, 0x0b, 0xa1, 0x94, 0x10, 0xf8,
+    0x4a, 0x4b, 0x0f, 0xb6, 0x80, 0x4e, 0x5d, 0x86, 0xad, 0xbe, 0x2a, 0x6a, 0x93, 0x07, 0x85, 0x76,
+    0xcf, 0x98, 0x12, 0x29, 0x7c, 0x03, 0x27, 0x43, 0xed, 0x0c, 0x08, 0x9b, 0xd7, 0x5b, 0x69, 0x42,
+    0xb6, 0x96, 0xe1, 0x67, 0x2d, 0xe9, 0x78, 0xfb, 0xcf, 0x9d, 0x20, 0xa3, 0x25, 0x3c, 0x1d, 0xdc,
+    0xaa, 0x3c, 0xb0, 0xdd, 0xc8, 0x8f, 0xed, 0xe0, 0x7b, 0x78, 0x39, 0x9b, 0xa5, 0x59, 0xb0, 0xef,
+    0xd4, 0x5e, 0x0a, 0xf6, 0x32, 0x85, 0x17, 0x90, 0x3c, 0x4f, 0x8e, 0xdc, 0x36, 0xab, 0x53, 0xaf,
+    0x29, 0x7a, 0xcd, 0x6f, 0x4e, 0xdd, 0xe0, 0xd7, 0xdb, 0x63, 0x47, 0xe2, 0x2e, 0x91, 0xc5, 0x04,
+    0xea, 0x6a, 0x02, 0x41, 0xee, 0x03, 0xc1, 0xec, 0xb8, 0x03, 0x09, 0xaf, 0xdb, 0x24, 0x96, 0x20,
+    0x33, 0x52, 0xbc, 0xb1, 0x26, 0x20, 0x6d, 0x14, 0xd3, 0x17, 0x49, 0x73, 0xcd, 0xbd, 0xff, 0xc4,
+    0xb7, 0x64, 0x5a, 0x57, 0xf0, 0x13, 0x24, 0x75, 0x95, 0xc0, 0x2b, 0x48, 0x84, 0x6d, 0x4c, 0x8c,
+    0x73, 0x08, 0x54, 0x57, 0x41, 0x6d, 0x25, 0xf3, 0x08, 0x7f, 0x05, 0x31, 0x80, 0x40, 0xaf, 0x8f,
+    0x3c, 0x94, 0x59, 0xa1, 0xad, 0x75, 0x0c, 0xeb, 0x0c, 0x3f, 0x2e, 0x6e, 0x30, 0xd5, 0x09, 0x94,
+    0xe7, 0xaa, 0xeb, 0x05, 0x6a, 0xe0, 0x39, 0xcc, 0x6f, 0x26, 0xb0, 0x3d, 0x57, 0x2f, 0xa2, 0x72,
+    0x31, 0x5b, 0x22, 0x78, 0x5f, 0x04, 0x81, 0x8c, 0x04, 0x65, 0x2d, 0x20, 0xb2, 0x4a, 0xa8, 0x04,
+    0x25, 0x09, 0x4a, 0x14, 0xbc, 0x40, 0x18, 0x3c, 0x6e, 0x93, 0xe5, 0xd5, 0x98, 0xa7, 0x8b, 0x4d,
+    0xef, 0x79, 0x3e, 0x63, 0x49, 0xc9, 0x7d, 0x99, 0xa4, 0x27, 0x15, 0xc0, 0x6e, 0xa3, 0x98, 0x82,
+    0xb5, 0x05, 0x4c, 0x1c, 0x17, 0xca, 0x26, 0x13, 0x54, 0xc4, 0xd3, 0x70, 0xa0, 0xa2, 0xdc, 0x1b,
+    0xad, 0x8c, 0x8c, 0x14, 0xee, 0x8b, 0x22, 0x9e, 0xd3, 0x65, 0x0b, 0x5e, 0x38, 0xf9, 0xe5, 0x0c,
+    0x9c, 0xf9, 0x8c, 0xe4, 0xd4, 0x42, 0xb9, 0x38, 0x74, 0xf0, 0xba, 0xed, 0xe0, 0xc7, 0xf7, 0x5f,
+    0x93, 0xce, 0x7b, 0x6b, 0xc5, 0x99, 0x73, 0xf2, 0xf0, 0x8e, 0x72, 0xf3, 0x99, 0x2f, 0xa2, 0xf9,
+    0x34, 0xa6, 0x8a, 0x90, 0xab, 0x26, 0x02, 0x76, 0x28, 0x9b, 0xf7, 0x5f, 0xf1, 0xf3, 0x66, 0xda,
+    0xda, 0xe6, 0x6e, 0x64, 0xeb, 0xb3, 0xb0, 0xaf, 0xe2, 0xb7, 0xb8, 0xdd, 0xf6, 0xa1, 0xbc, 0x5a,
+    0x1b, 0xae, 0x2f, 0xd4, 0xc1, 0x79, 0xaf, 0x7a, 0xe3, 0x01, 0xc0, 0x1b, 0x37, 0xd0, 0x9e, 0xa7,
+    0x9d, 0xba, 0x87, 0x32, 0x56, 0x79, 0x79, 0x01, 0x29, 0xca, 0x4f, 0xe3, 0x72, 0xe5, 0x68, 0x6e,
+    0xce, 0xcc, 0xe9, 0x9e, 0xf8, 0xac, 0xd3, 0xa6, 0x23, 0xf6, 0x47, 0x8a, 0x47, 0x1d, 0xfa, 0x4a,
+    0x6b, 0xcb, 0xc5, 0x7f, 0xa0, 0x90, 0xea, 0x1c, 0x82, 0xa4, 0x23, 0xff, 0xc2, 0xe1, 0x9c, 0xfb,
+    0x4b, 0x05, 0xd8, 0x9f, 0xd4, 0xae, 0x73, 0x08, 0xfb, 0x2f, 0x17, 0xac, 0x51, 0x3a, 0x9a, 0x9a,
+    0x46, 0x15, 0x2a, 0x0e, 0x0d, 0x1d, 0xfa, 0x5f, 0x1c, 0x19, 0x9f, 0xa9, 0x8a, 0xc6, 0xe5, 0xad,
+    0xf2, 0xb9, 0x35, 0x46, 0xe6, 0x41, 0x8a, 0x76, 0x66, 0x3a, 0xc7, 0x15, 0xcf, 0x37, 0x2b, 0x8b,
+    0x83, 0x44, 0x4e, 0xfd, 0xc7, 0xf8, 0x4c, 0x73, 0xf7, 0x66, 0x70, 0x8d, 0x58, 0x74, 0x27, 0xc7,
+    0x18, 0xda, 0xe6, 0xd8, 0x51, 0x72, 0x8a, 0xa7, 0xe1, 0x10, 0x5d, 0xb5, 0x22, 0xc6, 0xf9, 0x11,
+    0xc2, 0x9d, 0xd0, 0x87, 0xc9, 0xd5, 0xf3, 0x70, 0x21, 0x3d, 0x6d, 0x1d, 0x7f, 0x0c, 0xf6, 0x31,
+    0xe4, 0x55, 0x5f, 0x86, 0xf9, 0xa5, 0xa9, 0x41, 0x3d, 0x99, 0x91, 0x79, 0x6f, 0x17, 0xd7, 0xe9,
+    0x05, 0xd3, 0x0a, 0x2f, 0xba, 0x3f, 0x2a, 0x31, 0xde, 0xa0, 0x8d, 0xef, 0xdc, 0xda, 0xb5, 0x72,
+    0xe6, 0xd6, 0x6f, 0x9b, 0xac, 0x3d, 0xf4, 0xa4, 0x4b, 0xc9, 0xab, 0x33, 0x5b, 0xdc, 0x9d, 0x78,
+    0x9d, 0x51, 0xd3, 0xce, 0x00, 0xa3, 0x20, 0x83, 0xec, 0x71, 0xab, 0x4c, 0x94, 0xa7, 0xfd, 0x44,
+    0x56, 0x1e, 0x27, 0xe1, 0x12, 0x4f, 0x92, 0x63, 0xed, 0xa2, 0x6b, 0xfc, 0x48, 0xa9, 0x68, 0x86,
+    0xba, 0xd4, 0x0f, 0xf3, 0xfa, 0x9c, 0x69, 0xf2, 0x47, 0x25, 0xb0, 0x1d, 0x22, 0xe6, 0x66, 0x64,
+    0x03, 0x6f, 0xa9, 0x39, 0x74, 0xeb, 0x3f, 0x50, 0x33, 0xe4, 0xef, 0x48, 0xff, 0x21, 0x38, 0x65,
+    0xd6, 0x2c, 0x8d, 0x9b, 0x6a, 0x3a, 0x85, 0x0f, 0x6a, 0x27, 0x31, 0x45, 0xf2, 0xf3, 0xd8, 0x23,
+    0xdc, 0xbf, 0xdc, 0x83, 0x90, 0x3a, 0xe0, 0x0f, 0xae, 0xb0, 0x69, 0xe3, 0x71, 0x47, 0x4a, 0xb7,
+    0x46, 0xd4, 0xe1, 0xb9, 0xc2, 0x55, 0x1d, 0xa0, 0xa8, 0xb5, 0x6e, 0xdb, 0x9f, 0x11, 0xce, 0x67,
+    0x15, 0x4a, 0x5b, 0x07, 0xe0, 0xe0, 0x6d, 0xbe, 0x91, 0x01, 0x98, 0x93, 0x45, 0xed, 0xd1, 0xad,
+    0x29, 0xa5, 0x89, 0x6e, 0xc6, 0x0a, 0x09, 0xb8, 0xeb, 0x40, 0x1a, 0x5b, 0xaf, 0x4b, 0xf0, 0xf5,
+    0xca, 0xe7, 0x4e, 0xad, 0xf0, 0x5d, 0x4c, 0xc9, 0x80, 0x60, 0x2a, 0xcc, 0x0b, 0x2a, 0xab, 0xf5,
+    0xf1, 0x53, 0x39, 0x01, 0x6e, 0x04, 0x20, 0x75, 0x24, 0x49, 0x50, 0x5d, 0x0c, 0xbe, 0xe6, 0xca,
+    0x20, 0x6e, 0xd3, 0xaa, 0x31, 0x50, 0x76, 0x45, 0xcf, 0x41, 0xa4, 0x85, 0x05, 0xf9, 0xf6, 0xb4,
+    0x8c, 0xdf, 0x04, 0x88, 0x59, 0xa3, 0xc4, 0x20, 0xeb, 0xe5, 0x68, 0x45, 0xc7, 0xd4, 0x58, 0xcc,
+    0xb7, 0xdd, 0xd2, 0x85, 0x75, 0xf8, 0xe4, 0xa1, 0xcf, 0x06, 0xf3, 0x85, 0x4e, 0x11, 0xf1, 0xfe,
+    0xdc, 0xfc, 0x85, 0x00, 0x51, 0x82, 0xc7, 0xf6, 0x71, 0x68, 0xf7, 0x3b, 0x69, 0xd3, 0xe3, 0xd5,
+    0x4f, 0x11, 0x59, 0x87, 0x28, 0x43, 0x5e, 0xb2, 0x64, 0x9c, 0x0e, 0x75, 0x0e, 0xc9, 0xb2, 0xde,
+    0x9c, 0xb9, 0xd1, 0x83, 0xeb, 0xa2, 0x09, 0xa3, 0xb7, 0xbc, 0x33, 0x8b, 0x24, 0xd3, 0x2c, 0xe7,
+    0x04, 0x34, 0xf8, 0xa0, 0xcb, 0xd3, 0x49, 0xd4, 0xee, 0x8e, 0xb1, 0xc3, 0xc3, 0xd8, 0x78, 0x4a,
+    0x1a, 0x47, 0xe1, 0xb3, 0x5c, 0x3d, 0xc4, 0xa2, 0xe1, 0xa6, 0xf0, 0xaf, 0xa6, 0x71, 0x59, 0xd3,
+    0x15, 0x25, 0xbf, 0xac, 0xb4, 0xd8, 0x50, 0x1c, 0x4c, 0xec, 0x76, 0x7b, 0x29, 0x1b, 0x9f, 0x59,
+    0x83, 0x3b, 0xca, 0x53, 0x3b, 0x5e, 0xc3, 0x10, 0x53, 0xb6, 0xc8, 0x00, 0xaa, 0x00, 0xd6, 0x55,
+    0x95, 0xa8, 0xe7, 0x5a, 0x72, 0x77, 0x87, 0x73, 0xe8, 0x76, 0x5c, 0x0f, 0x8a, 0xe5, 0x69, 0xe1,
+    0xf1, 0x15, 0x27, 0xe7, 0xb6, 0xe8, 0xbf, 0x3c, 0xdc, 0x7f, 0xc2, 0x1b, 0xe9, 0xbc, 0x64, 0x32,
+    0xc3, 0xf9, 0xe3, 0x69, 0x0c, 0xfd, 0x34, 0xc4, 0xcf, 0xb5, 0xf5, 0x47, 0xd1, 0xc7, 0xc1, 0xbf,
+    0x1b, 0x45, 0x6f, 0x8b, 0x3d, 0x8e, 0xe6, 0x65, 0x38, 0x62, 0x33, 0x81, 0x1f, 0x66, 0xf8, 0xe6,
+    0xf7, 0x04, 0x50, 0x4d, 0x77, 0x01, 0xe7, 0x95, 0x75, 0x25, 0x9b, 0xc0, 0xf5, 0x2c, 0x5a, 0xb4,
+    0x0c, 0xb0, 0xa8, 0x14, 0xa4, 0x51, 0x06, 0xff, 0x7e, 0x64, 0x43, 0xed, 0x5a, 0x02, 0x43, 0x95,
+    0xd1, 0x0e, 0xa4, 0x46, 0x8e, 0x24, 0xed, 0x48, 0x74, 0xa7, 0xff, 0xa7, 0x81, 0xf8, 0xff, 0x02,
+    0xf3, 0x7d, 0x75, 0x1a, 0x14, 0x0a, 0x00, 0x00,
+};
+
+// style.css, 1625 bytes, 663 gzipped
+static const uint8_t WEB_STYLE_CSS[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x7d, 0x54, 0xed, 0x8e, 0xab, 0x20,
+    0x10, 0xfd, 0xbf, 0x4f, 0x61, 0x72, 0x73, 0xff, 0xad, 0x06, 0x5a, 0xdb, 0x75, 0x31, 0xb9, 0xef,
+    0x82, 0x32, 0x2a, 0x29, 0x82, 0x01, 0xdc, 0xb6, 0x97, 0xf4, 0xdd, 0x2f, 0xf8, 0xd1, 0x62, 0xb7,
+    0x7b, 0xd3, 0xa4, 0x51, 0x64, 0xe6, 0xcc, 0x9c, 0x73, 0x66, 0x2a, 0xc5, 0xae, 0xae, 0x51, 0xd2,
+    0xa6, 0x0d, 0xed, 0xb9, 0xb8, 0x12, 0x43, 0xa5, 0x49, 0x0d, 0x68, 0xde, 0x94, 0x15, 0xad, 0x4f,
+    0xad, 0x56, 0xa3, 0x64, 0xe4, 0x17, 0xa6, 0x98, 0xee, 0xa0, 0xac, 0x95, 0x50, 0x9a, 0xfc, 0x02,
+    0x14, 0x7e, 0x65, 0x4f, 0x75, 0xcb, 0x25, 0x41, 0xe5, 0x40, 0x19, 0xe3, 0xb2, 0x25, 0xf8, 0x38,
+    0x5c, 0xca, 0xdb, 0x5b, 0x87, 0xdd, 0x7a, 0xf1, 0x33, 0x3f, 0x1c, 0x51, 0x39, 0x01, 0x18, 0xfe,
+    0x17, 0x08, 0xce, 0x72, 0xe8, 0xef, 0x81, 0x09, 0x4a, 0x8a, 0x39, 0x62, 0xb7, 0x46, 0xa0, 0x66,
+    0x9f, 0xfb, 0x88, 0x18, 0x7b, 0x41, 0x5b, 0x41, 0x3c, 0x46, 0x82, 0x91, 0x0f, 0x5b, 0xb2, 0x60,
+    0x9f, 0x22, 0x49, 0xc3, 0xc9, 0x7c, 0x1c, 0x81, 0x79, 0xa8, 0x4a, 0x69, 0x06, 0x3a, 0xd5, 0x94,
+    0xf1, 0xd1, 0x90, 0x7c, 0x42, 0x6b, 0x94, 0xee, 0xdf, 0xb3, 0x81, 0xb6, 0xe0, 0x7a, 0x7a, 0x49,
+    0xcf, 0x9c, 0xd9, 0x8e, 0xe4, 0x45, 0x94, 0x13, 0x25, 0x74, 0xb4, 0xca, 0x5f, 0x15, 0xb4, 0x02,
+    0xe1, 0x18, 0x37, 0x83, 0xa0, 0x57, 0x52, 0x09, 0x55, 0x9f, 0xd6, 0x3b, 0x01, 0x16, 0x25, 0xbb,
+    0x0d, 0x22, 0xca, 0x3e, 0x3d, 0xe6, 0xd2, 0x0a, 0xa5, 0xd4, 0x67, 0xe0, 0x72, 0x18, 0xed, 0xbb,
+    0x01, 0x01, 0xb5, 0x75, 0x33, 0x14, 0x46, 0xe8, 0xf7, 0xbd, 0x9d, 0xe2, 0x81, 0xba, 0x9b, 0x32,
+    0x06, 0x0e, 0x2b, 0x75, 0x09, 0x09, 0xc3, 0xf7, 0xa5, 0x01, 0x7f, 0xb2, 0x15, 0xe4, 0xb8, 0xc3,
+    0x7b, 0x58, 0xda, 0x23, 0xd8, 0x47, 0x1a, 0x25, 0x38, 0x4b, 0x56, 0x02, 0xb7, 0x4a, 0x7d, 0x67,
+    0x61, 0x53, 0xf3, 0xc1, 0x17, 0xbd, 0x54, 0x4a, 0x1a, 0x55, 0x8f, 0x66, 0xa9, 0x77, 0x7e, 0x71,
+    0x4b, 0xf4, 0x56, 0x53, 0x35, 0x5a, 0xc1, 0x25, 0x10, 0xa9, 0x24, 0xf8, 0xe0, 0x4c, 0xab, 0xf3,
+    0x9d, 0xa7, 0x46, 0xc0, 0xa5, 0x6c, 0xe9, 0x40, 0x26, 0x41, 0x6e, 0xe1, 0xdb, 0x1f, 0xc6, 0xbf,
+    0x5c, 0x38, 0x27, 0x38, 0xdc, 0x96, 0xca, 0x82, 0x8b, 0x6b, 0x28, 0x1e, 0xbc, 0x1d, 0x8f, 0xc7,
+    0x2d, 0x23, 0xb3, 0x47, 0xaa, 0xd1, 0x5a, 0x25, 0x5f, 0x51, 0x88, 0x77, 0x11, 0x87, 0xc1, 0x07,
+    0x4f, 0xfe, 0x99, 0x0b, 0x5e, 0xb2, 0x37, 0x4d, 0xb3, 0xb2, 0x36, 0x95, 0xfe, 0x3f, 0x6a, 0x70,
+    0x16, 0x2c, 0x54, 0x8f, 0xda, 0xf8, 0xc8, 0x41, 0x71, 0x69, 0x41, 0xdf, 0x2b, 0x21, 0x9d, 0xfa,
+    0x02, 0xed, 0x62, 0xa4, 0xfa, 0x63, 0x0f, 0x87, 0x3c, 0xf4, 0xa7, 0x4e, 0xee, 0x85, 0x5a, 0x6b,
+    0xc1, 0x7b, 0x34, 0x69, 0x1c, 0x03, 0x4f, 0x3d, 0x58, 0xb8, 0xd8, 0x94, 0x0a, 0xde, 0x4a, 0x52,
+    0xc3, 0x04, 0x16, 0xf9, 0x13, 0x45, 0xfe, 0xcc, 0x43, 0x97, 0x8b, 0x45, 0x3d, 0x56, 0xf2, 0x98,
+    0xb8, 0xbc, 0xa6, 0xcd, 0x61, 0x1d, 0x4d, 0xef, 0x1a, 0x5f, 0x69, 0xbf, 0xce, 0x65, 0xb8, 0x39,
+    0xb8, 0x8d, 0x3b, 0xbd, 0x10, 0x0c, 0xd2, 0x8e, 0x9a, 0x6e, 0x53, 0x2f, 0x6a, 0x30, 0xdd, 0xa3,
+    0x9f, 0xdd, 0xb5, 0xad, 0x3d, 0x64, 0xbf, 0x6b, 0x31, 0xcd, 0x61, 0x1e, 0x8f, 0x12, 0x4a, 0x56,
+    0xfc, 0x3b, 0x58, 0x92, 0xc9, 0x2e, 0x7d, 0x35, 0x5b, 0xb1, 0x25, 0x3e, 0x0e, 0x0f, 0x4f, 0x14,
+    0x45, 0xf1, 0xd4, 0x53, 0xfe, 0x9c, 0xb2, 0xf6, 0x4f, 0x9b, 0x55, 0xd6, 0x2b, 0xa9, 0xcc, 0x40,
+    0x6b, 0xf8, 0x6e, 0xf6, 0x25, 0xeb, 0x07, 0xd4, 0xc1, 0x0e, 0x67, 0xdf, 0x4d, 0x5a, 0x69, 0xa0,
+    0x27, 0x32, 0xfd, 0x7b, 0x09, 0x44, 0x29, 0xc0, 0x7a, 0x01, 0xd2, 0x90, 0x20, 0xf4, 0x85, 0x32,
+    0x34, 0x4f, 0x49, 0xdc, 0xc4, 0x28, 0x0d, 0x58, 0x17, 0x95, 0x38, 0x03, 0xd9, 0xab, 0x00, 0xc2,
+    0xad, 0x17, 0xb2, 0x2e, 0x7f, 0xd8, 0xad, 0xb7, 0x37, 0x4b, 0x2b, 0x01, 0xb1, 0x9b, 0x1f, 0x53,
+    0x26, 0xe8, 0x60, 0x80, 0xac, 0x0f, 0xdf, 0xd6, 0x8b, 0x8f, 0x65, 0x6e, 0xe5, 0xdb, 0xd3, 0x30,
+    0xed, 0xa0, 0xfb, 0x9a, 0x98, 0x05, 0x7f, 0x28, 0xb6, 0x58, 0x2f, 0x04, 0x11, 0x41, 0x8d, 0x4d,
+    0xeb, 0x8e, 0x0b, 0xe6, 0x22, 0xab, 0x69, 0xde, 0x76, 0xb6, 0x7c, 0xcd, 0xdc, 0x96, 0x28, 0xdf,
+    0xfd, 0x38, 0x3c, 0x39, 0xed, 0x96, 0x31, 0x75, 0x96, 0x4f, 0x0b, 0xff, 0xf6, 0xf6, 0x0f, 0x21,
+    0x89, 0xf0, 0x40, 0x59, 0x06, 0x00, 0x00,
+};
+
+static const WebAsset WEB_ASSETS[] = {
+    { "/portal.html", "text/html", WEB_PORTAL_HTML, sizeof(WEB_PORTAL_HTML), "\"2c8450c5ac765fd2\"" },
+    { "/portal.js", "application/javascript", WEB_PORTAL_JS, sizeof(WEB_PORTAL_JS), "\"17dacde99507401d\"" },
+    { "/saved.html", "text/html", WEB_SAVED_HTML, sizeof(WEB_SAVED_HTML), "\"55f692a3cbc26003\"" },
+    { "/status.html", "text/html", WEB_STATUS_HTML, sizeof(WEB_STATUS_HTML), "\"e7ee5b713e406914\"" },
+    { "/status.js", "application/javascript", WEB_STATUS_JS, sizeof(WEB_STATUS_JS), "\"4722e51ff86a6851\"" },
+    { "/style.css", "text/css", WEB_STYLE_CSS, sizeof(WEB_STYLE_CSS), "\"a10632f22f173f71\"" },
+};
+static const uint8_t WEB_ASSET_COUNT = sizeof(WEB_ASSETS) / sizeof(WEB_ASSETS[0]);
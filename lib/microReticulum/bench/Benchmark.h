@@ -0,0 +1,66 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdio.h>
+#include <stdint.h>
+
+// CBA Minimal benchmark harness.
+//
+// Each case runs its body once to warm up, then REPEATS rounds of the given number
+// of iterations, and reports the fastest and median round as nanoseconds per
+// iteration. Results are printed as one JSON document whose shape never depends on
+// the results, so two runs can be diffed or compared by a script.
+namespace Bench {
+
+	static const uint8_t REPEATS = 5;
+
+	struct Result {
+		std::string name;
+		std::string params;		// JSON object body, e.g. "\"paths\":256"
+		uint32_t iterations;
+		double min_ns;
+		double median_ns;
+	};
+
+	inline std::vector<Result>& results() {
+		static std::vector<Result> _results;
+		return _results;
+	}
+
+	// body(i) performs iteration i; setup(), when given, runs untimed before each round
+	inline void run(const std::string& name, const std::string& params, uint32_t iterations,
+	                const std::function<void(uint32_t)>& body, const std::function<void()>& setup = nullptr) {
+		using clock = std::chrono::steady_clock;
+		if (setup) setup();
+		body(0);
+		std::vector<double> rounds;
+		for (uint8_t r = 0; r < REPEATS; r++) {
+			if (setup) setup();
+			clock::time_point start = clock::now();
+			for (uint32_t i = 0; i < iterations; i++) {
+				body(i);
+			}
+			double ns = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+			rounds.push_back(ns / iterations);
+		}
+		std::sort(rounds.begin(), rounds.end());
+		results().push_back({name, params, iterations, rounds.front(), rounds[rounds.size() / 2]});
+		fprintf(stderr, "%-32s %-24s %12.0f ns/op\n", name.c_str(), params.c_str(), rounds[rounds.size() / 2]);
+	}
+
+	inline void write_json(FILE* out, const char* version) {
+		fprintf(out, "{\n  \"suite\": \"microReticulum\",\n  \"version\": \"%s\",\n  \"repeats\": %u,\n  \"results\": [\n", version, REPEATS);
+		for (size_t i = 0; i < results().size(); i++) {
+			const Result& result = results()[i];
+			fprintf(out, "    {\"name\": \"%s\", \"params\": {%s}, \"iterations\": %u, \"min_ns\": %.1f, \"median_ns\": %.1f, \"ops_per_s\": %.1f}%s\n",
+			        result.name.c_str(), result.params.c_str(), result.iterations, result.min_ns, result.median_ns,
+			        (result.median_ns > 0) ? 1e9 / result.median_ns : 0.0, (i + 1 < results().size()) ? "," : "");
+		}
+		fprintf(out, "  ]\n}\n");
+	}
+
+}
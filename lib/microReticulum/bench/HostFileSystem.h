@@ -0,0 +1,146 @@
+#pragma once
+
+#include <FileSystem.h>
+#include <FileStream.h>
+#include <Bytes.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <string.h>
+
+// CBA RAM-backed FileSystemImpl for host builds.
+//
+// Files live in a map of path to shared buffer, so save and load timings measure
+// the stack's serialization and not the disk. Directories are implied by the
+// files under them, plus any created explicitly.
+class HostFileSystem : public RNS::FileSystemImpl {
+
+public:
+	using Buffer = std::shared_ptr<RNS::Bytes>;
+
+	class HostFileStream : public RNS::FileStreamImpl {
+	public:
+		HostFileStream(const std::string& name, Buffer buffer, RNS::FileStream::MODE mode) :
+			_name(name), _buffer(buffer), _position(0)
+		{
+			if (mode == RNS::FileStream::MODE_WRITE) {
+				_buffer->clear();
+			}
+			else if (mode == RNS::FileStream::MODE_APPEND) {
+				_position = _buffer->size();
+			}
+		}
+
+	protected:
+		virtual const char* name() { return _name.c_str(); }
+		virtual size_t size() { return _buffer->size(); }
+		virtual void close() {}
+		virtual bool seek(size_t position) {
+			if (position > _buffer->size()) return false;
+			_position = position;
+			return true;
+		}
+
+		virtual size_t write(uint8_t byte) { return write(&byte, 1); }
+		virtual size_t write(const uint8_t* buffer, size_t size) {
+			// writes after a seek overwrite, the way LittleFS behaves
+			if (_position < _buffer->size()) {
+				RNS::Bytes head = _buffer->left(_position);
+				size_t tail_start = _position + size;
+				RNS::Bytes tail = (tail_start < _buffer->size()) ? _buffer->mid(tail_start) : RNS::Bytes();
+				head.append(buffer, size);
+				head.append(tail);
+				*_buffer = head;
+			}
+			else {
+				_buffer->append(buffer, size);
+			}
+			_position += size;
+			return size;
+		}
+
+		virtual int available() { return (int)(_buffer->size() - _position); }
+		virtual int read() { return (_position < _buffer->size()) ? _buffer->data()[_position++] : -1; }
+		virtual int peek() { return (_position < _buffer->size()) ? _buffer->data()[_position] : -1; }
+		virtual void flush() {}
+
+	private:
+		std::string _name;
+		Buffer _buffer;
+		size_t _position;
+	};
+
+public:
+	HostFileSystem() {}
+
+	// Total bytes held in files
+	size_t used() const {
+		size_t total = 0;
+		for (auto& [path, buffer] : _files) total += buffer->size();
+		return total;
+	}
+
+protected:
+	virtual bool file_exists(const char* file_path) { return _files.find(file_path) != _files.end(); }
+
+	virtual size_t read_file(const char* file_path, RNS::Bytes& data) {
+		auto iter = _files.find(file_path);
+		if (iter == _files.end()) return 0;
+		data = *(*iter).second;
+		return data.size();
+	}
+
+	virtual size_t write_file(const char* file_path, const RNS::Bytes& data) {
+		_files[file_path] = std::make_shared<RNS::Bytes>(data.data(), data.size());
+		return data.size();
+	}
+
+	virtual RNS::FileStream open_file(const char* file_path, RNS::FileStream::MODE file_mode) {
+		auto iter = _files.find(file_path);
+		if (iter == _files.end()) {
+			if (file_mode == RNS::FileStream::MODE_READ) return {RNS::Type::NONE};
+			iter = _files.insert({file_path, std::make_shared<RNS::Bytes>()}).first;
+		}
+		return RNS::FileStream(new HostFileStream(file_path, (*iter).second, file_mode));
+	}
+
+	virtual bool remove_file(const char* file_path) { return _files.erase(file_path) > 0; }
+
+	virtual bool rename_file(const char* from_file_path, const char* to_file_path) {
+		auto iter = _files.find(from_file_path);
+		if (iter == _files.end()) return false;
+		Buffer buffer = (*iter).second;
+		_files.erase(iter);
+		_files[to_file_path] = buffer;
+		return true;
+	}
+
+	virtual bool directory_exists(const char* directory_path) {
+		if (_directories.find(directory_path) != _directories.end()) return true;
+		std::string prefix = std::string(directory_path) + "/";
+		auto iter = _files.lower_bound(prefix);
+		return iter != _files.end() && (*iter).first.compare(0, prefix.size(), prefix) == 0;
+	}
+
+	virtual bool create_directory(const char* directory_path) { _directories[directory_path] = true; return true; }
+	virtual bool remove_directory(const char* directory_path) { return _directories.erase(directory_path) > 0; }
+
+	virtual std::list<std::string> list_directory(const char* directory_path) {
+		std::list<std::string> names;
+		std::string prefix = std::string(directory_path) + "/";
+		for (auto iter = _files.lower_bound(prefix); iter != _files.end() && (*iter).first.compare(0, prefix.size(), prefix) == 0; ++iter) {
+			std::string name = (*iter).first.substr(prefix.size());
+			if (name.find('/') == std::string::npos) names.push_back(name);
+		}
+		return names;
+	}
+
+	virtual size_t storage_size() { return 16 * 1024 * 1024; }
+	virtual size_t storage_available() { return storage_size() - used(); }
+
+private:
+	std::map<std::string, Buffer> _files;
+	std::map<std::string, bool> _directories;
+
+};
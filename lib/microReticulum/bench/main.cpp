@@ -0,0 +1,473 @@
+// CBA Host benchmarks for the microReticulum stack.
+//
+// Build and run on Linux from lib/microReticulum:
+//
+//   pio run -e native_bench && .pio/build/native_bench/program > bench.json
+//
+// Progress goes to stderr, the JSON document to stdout. Transport cases are run at
+// growing path table sizes; every announce and packet fed to inbound() is unique
+// so the duplicate filter and announce caches do not short-circuit the work.
+
+#ifdef RNS_BENCHMARK
+
+#include "Benchmark.h"
+#include "HostFileSystem.h"
+
+#include <Reticulum.h>
+#include <Transport.h>
+#include <Interface.h>
+#include <Identity.h>
+#include <Destination.h>
+#include <Packet.h>
+#include <Link.h>
+#include <Bytes.h>
+#include <Log.h>
+#include <Cryptography/Token.h>
+#include <Cryptography/Fast25519.h>
+#include <Cryptography/Random.h>
+#include <Utilities/Compression.h>
+#include <Utilities/OS.h>
+
+#include <Ed25519.h>
+#include <Curve25519.h>
+
+#include <initializer_list>
+#include <vector>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef MICRORETICULUM_VERSION
+#define MICRORETICULUM_VERSION "0.2.4"
+#endif
+
+using namespace RNS;
+
+// ─── Bench interface ─────────────────────────────────────────────────────────
+// Counts what Transport sends and drops it
+class BenchInterface : public InterfaceImpl {
+public:
+	BenchInterface() : InterfaceImpl("BenchInterface") {
+		_IN = true;
+		_OUT = true;
+		_HW_MTU = 508;
+		_bitrate = 1000000;
+	}
+	uint32_t sent_packets = 0;
+	uint32_t sent_bytes = 0;
+protected:
+	virtual void send_outgoing(const Bytes& data) {
+		++sent_packets;
+		sent_bytes += data.size();
+		InterfaceImpl::handle_outgoing(data);
+	}
+};
+
+static Interface bench_interface({Type::NONE});
+static FileSystem host_filesystem({Type::NONE});
+
+// ─── Traffic generation ──────────────────────────────────────────────────────
+struct RemoteNode {
+	Bytes destination_hash;
+	Bytes announce_raw;
+};
+
+// A SINGLE destination's announce as it arrives from the wire. The destination
+// is deregistered again so Transport treats it as a remote one.
+static RemoteNode make_remote_node() {
+	Identity identity;
+	Destination destination(identity, Type::Destination::IN, Type::Destination::SINGLE, "bench", "node");
+	Packet announce = destination.announce(Bytes("bench"), false, {Type::NONE}, {}, false);
+	announce.pack();
+	RemoteNode node = { destination.hash(), announce.raw() };
+	Transport::deregister_destination(destination);
+	return node;
+}
+
+// HEADER_2 frame addressed through us as the next transport hop
+static Bytes make_transport_frame(uint8_t packet_type, const Bytes& destination_hash, const Bytes& payload) {
+	Bytes raw;
+	uint8_t flags = (Type::Packet::HEADER_2 << 6) | (Type::Transport::TRANSPORT << 4) | (Type::Destination::SINGLE << 2) | packet_type;
+	raw << flags;
+	raw << (uint8_t)0;
+	raw << Transport::identity().hash();
+	raw << destination_hash;
+	raw << (uint8_t)Type::Packet::CONTEXT_NONE;
+	raw << payload;
+	return raw;
+}
+
+static Bytes make_link_frame(const Bytes& link_id, const Bytes& payload) {
+	Bytes raw;
+	uint8_t flags = (Type::Packet::HEADER_1 << 6) | (Type::Transport::BROADCAST << 4) | (Type::Destination::LINK << 2) | Type::Packet::DATA;
+	raw << flags;
+	raw << (uint8_t)0;
+	raw << link_id;
+	raw << (uint8_t)Type::Packet::CONTEXT_NONE;
+	raw << payload;
+	return raw;
+}
+
+static Bytes numbered_payload(uint32_t n, size_t size) {
+	Bytes payload = Cryptography::random(size);
+	uint8_t* data = payload.writable(size);
+	memcpy(data, &n, sizeof(n));
+	return payload;
+}
+
+static std::vector<RemoteNode> nodes;
+static uint32_t next_node = 0;
+static uint32_t next_serial = 0;
+
+static void add_nodes(size_t count) {
+	while (count-- > 0) nodes.push_back(make_remote_node());
+}
+
+// Feeds announces until the path table holds at least paths entries
+static void fill_path_table(size_t paths) {
+	while (Transport::get_destination_table().size() < paths) {
+		if (next_node >= nodes.size()) add_nodes(16);
+		Transport::inbound(nodes[next_node++].announce_raw, bench_interface);
+		Transport::loop();
+	}
+	// drain anything still waiting for validation
+	for (uint8_t i = 0; i < Type::Transport::ANNOUNCE_VALIDATION_MAXSIZE; i++) Transport::loop();
+}
+
+static std::string param(const char* name, size_t value) {
+	return "\"" + std::string(name) + "\": " + std::to_string(value);
+}
+
+// ─── Bytes ───────────────────────────────────────────────────────────────────
+static void bench_bytes() {
+	// inline up to Bytes::INLINE_MAXSIZE, shared data above
+	for (size_t size : std::initializer_list<size_t>{10, 16, 32, 64}) {
+		Bytes source = Cryptography::random(size);
+		Bench::run("bytes.copy_append", param("size", size), 5000, [&](uint32_t n) {
+			Bytes copy(source.data(), size - 1);
+			copy.append((uint8_t)n);
+			Bytes other = copy;
+			if (other == source) other.clear();
+		});
+	}
+}
+
+// ─── Packet ──────────────────────────────────────────────────────────────────
+static void bench_packet() {
+	Destination plain({Type::NONE}, Type::Destination::OUT, Type::Destination::PLAIN, "bench", "plain");
+	for (size_t size : std::initializer_list<size_t>{32, 128, 400}) {
+		Bytes payload = Cryptography::random(size);
+		Bench::run("packet.pack", param("payload", size), 2000, [&](uint32_t) {
+			Packet packet(plain, payload, Type::Packet::DATA, Type::Packet::CONTEXT_NONE, Type::Transport::BROADCAST, Type::Packet::HEADER_1, {Bytes::NONE}, false);
+			packet.pack();
+		});
+
+		Packet packed(plain, payload, Type::Packet::DATA, Type::Packet::CONTEXT_NONE, Type::Transport::BROADCAST, Type::Packet::HEADER_1, {Bytes::NONE}, false);
+		packed.pack();
+		Bytes raw = packed.raw();
+		Bench::run("packet.unpack", param("payload", size), 2000, [&](uint32_t) {
+			Packet packet(Destination(Type::NONE), raw);
+			packet.unpack();
+		});
+	}
+
+	add_nodes(1);
+	Bytes announce_raw = nodes[0].announce_raw;
+	Bench::run("packet.unpack.announce", param("payload", announce_raw.size()), 2000, [&](uint32_t) {
+		Packet packet(Destination(Type::NONE), announce_raw);
+		packet.unpack();
+	});
+}
+
+// ─── Identity ────────────────────────────────────────────────────────────────
+static void bench_identity() {
+	// More distinct announces than the verified-announce cache holds
+	const size_t pool = 256;
+	if (nodes.size() < pool) add_nodes(pool - nodes.size());
+	std::vector<Packet> announces;
+	for (size_t i = 0; i < pool; i++) {
+		Packet packet(Destination(Type::NONE), nodes[i].announce_raw);
+		packet.unpack();
+		announces.push_back(packet);
+	}
+	Bench::run("identity.validate_announce", "\"cached\": false", pool, [&](uint32_t i) {
+		Identity::validate_announce(announces[i % pool]);
+	});
+	Bench::run("identity.validate_announce", "\"cached\": true", 2000, [&](uint32_t) {
+		Identity::validate_announce(announces[0]);
+	});
+}
+
+// ─── Curve25519 ──────────────────────────────────────────────────────────────
+static void check(bool ok, const char* what) {
+	if (!ok) {
+		fprintf(stderr, "curve25519: %s mismatch\n", what);
+		exit(1);
+	}
+}
+
+static Bytes from_hex(const char* hex) {
+	Bytes bytes;
+	bytes.assignHex(hex);
+	return bytes;
+}
+
+// Fast25519 against the RFC 8032 and RFC 7748 test vectors and against the Crypto library
+static void check_curve25519() {
+	const Bytes ed_private = from_hex("9d61b19deffd5a60ba844af492ec2cc44449c5697b326919703bac031cae7f60");
+	const Bytes ed_public = from_hex("d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a");
+	const Bytes ed_signature = from_hex("e5564300c360ac729086e2cc806e828a84877f1eb8e5d974d873e065224901555fb8821590a33bacc61e39701cf9b46bd25bf5f0595bbe24655141438e7a100b");
+	const Bytes x_alice = from_hex("77076d0a7318a57d3c16c17251b26645df4c2f87ebc0992ab177fba51db92c2a");
+	const Bytes x_alice_public = from_hex("8520f0098930a754748b7ddcb43ef75a0dbf3a0d26381af4eba4a98eaa9b4e6a");
+	const Bytes x_bob_public = from_hex("de9edb7d7b7dc1b4d35b61c2ece435373f8343c85b78674dadfc7e146f882b4f");
+	const Bytes x_shared = from_hex("4a5d9d5ba4ce2de1728e3bf480350f25e07e21c947d19e3376f09b3c1e161742");
+
+	uint8_t key[32];
+	uint8_t signature[64];
+	Cryptography::Fast25519::ed25519_public_key(key, ed_private.data());
+	check(memcmp(key, ed_public.data(), 32) == 0, "RFC 8032 public key");
+	Cryptography::Fast25519::ed25519_sign(signature, ed_private.data(), ed_public.data(), nullptr, 0);
+	check(memcmp(signature, ed_signature.data(), 64) == 0, "RFC 8032 signature");
+	check(Cryptography::Fast25519::ed25519_verify(ed_signature.data(), ed_public.data(), nullptr, 0), "RFC 8032 verify");
+	Cryptography::Fast25519::x25519_public_key(key, x_alice.data());
+	check(memcmp(key, x_alice_public.data(), 32) == 0, "RFC 7748 public key");
+	check(Cryptography::Fast25519::x25519(key, x_alice.data(), x_bob_public.data()), "RFC 7748 shared key");
+	check(memcmp(key, x_shared.data(), 32) == 0, "RFC 7748 shared key");
+
+	for (uint32_t i = 0; i < 64; i++) {
+		Bytes private_key = Cryptography::random(32);
+		Bytes peer = Cryptography::random(32);
+		peer.writable(32)[31] &= 0x7f;
+		Bytes message = Cryptography::random(i * 7);
+		uint8_t expected[64];
+		uint8_t public_key[32];
+		::Ed25519::derivePublicKey(public_key, private_key.data());
+		Cryptography::Fast25519::ed25519_public_key(key, private_key.data());
+		check(memcmp(key, public_key, 32) == 0, "Ed25519 public key");
+		::Ed25519::sign(expected, private_key.data(), public_key, message.data(), message.size());
+		Cryptography::Fast25519::ed25519_sign(signature, private_key.data(), public_key, message.data(), message.size());
+		check(memcmp(signature, expected, 64) == 0, "Ed25519 signature");
+		check(Cryptography::Fast25519::ed25519_verify(signature, public_key, message.data(), message.size()), "Ed25519 verify");
+		signature[i % 64] ^= 0x04;
+		check(Cryptography::Fast25519::ed25519_verify(signature, public_key, message.data(), message.size()) ==
+			::Ed25519::verify(signature, public_key, message.data(), message.size()), "Ed25519 verify of a bad signature");
+		Curve25519::eval(expected, private_key.data(), 0);
+		Cryptography::Fast25519::x25519_public_key(key, private_key.data());
+		check(memcmp(key, expected, 32) == 0, "X25519 public key");
+		Curve25519::eval(expected, private_key.data(), peer.data());
+		Cryptography::Fast25519::x25519(key, private_key.data(), peer.data());
+		check(memcmp(key, expected, 32) == 0, "X25519 shared key");
+	}
+}
+
+static void bench_curve25519() {
+	check_curve25519();
+
+	Bytes private_key = Cryptography::random(32);
+	Bytes peer = Cryptography::random(32);
+	Bytes message = Cryptography::random(160);
+	uint8_t public_key[32];
+	uint8_t signature[64];
+	uint8_t out[64];
+	::Ed25519::derivePublicKey(public_key, private_key.data());
+	::Ed25519::sign(signature, private_key.data(), public_key, message.data(), message.size());
+
+	Bench::run("curve25519.ed25519_sign", "\"backend\": \"crypto\"", 200, [&](uint32_t) {
+		::Ed25519::sign(out, private_key.data(), public_key, message.data(), message.size());
+	});
+	Bench::run("curve25519.ed25519_sign", "\"backend\": \"fast\"", 200, [&](uint32_t) {
+		Cryptography::Fast25519::ed25519_sign(out, private_key.data(), public_key, message.data(), message.size());
+	});
+	Bench::run("curve25519.ed25519_verify", "\"backend\": \"crypto\"", 200, [&](uint32_t) {
+		::Ed25519::verify(signature, public_key, message.data(), message.size());
+	});
+	Bench::run("curve25519.ed25519_verify", "\"backend\": \"fast\"", 200, [&](uint32_t) {
+		Cryptography::Fast25519::ed25519_verify(signature, public_key, message.data(), message.size());
+	});
+	Bench::run("curve25519.x25519_public_key", "\"backend\": \"crypto\"", 200, [&](uint32_t) {
+		Curve25519::eval(out, private_key.data(), 0);
+	});
+	Bench::run("curve25519.x25519_public_key", "\"backend\": \"fast\"", 200, [&](uint32_t) {
+		Cryptography::Fast25519::x25519_public_key(out, private_key.data());
+	});
+	Bench::run("curve25519.x25519", "\"backend\": \"crypto\"", 200, [&](uint32_t) {
+		Curve25519::eval(out, private_key.data(), peer.data());
+	});
+	Bench::run("curve25519.x25519", "\"backend\": \"fast\"", 200, [&](uint32_t) {
+		Cryptography::Fast25519::x25519(out, private_key.data(), peer.data());
+	});
+}
+
+// ─── Compression ─────────────────────────────────────────────────────────────
+// Page-like text, words of a small vocabulary with markup, and random bytes
+static Bytes sample_text(size_t size) {
+	static const char* words[] = {"the ", "node ", "page ", "link ", "message ", "announce ", "`!", "`F0af", "`=", ">>", "\n", "reticulum ", "lora ", "and ", "of "};
+	std::string text;
+	while (text.size() < size) {
+		text += words[rand() % (sizeof(words) / sizeof(words[0]))];
+	}
+	return Bytes((const uint8_t*)text.data(), size);
+}
+
+static Bytes lz_compress(const Bytes& data, size_t chunk) {
+	Utilities::LzCompressor compressor;
+	Bytes packed;
+	for (size_t offset = 0; offset < data.size(); offset += chunk) {
+		compressor.update(data.mid(offset, chunk), packed);
+	}
+	compressor.finish(packed);
+	return packed;
+}
+
+static void bench_compression() {
+	for (bool text : {true, false}) {
+		Bytes data = text ? sample_text(8192) : Cryptography::random(8192);
+		Bytes packed = lz_compress(data, Type::Resource::SPOOL_CHUNK_SIZE);
+		Utilities::LzDecompressor decompressor;
+		Bytes unpacked;
+		if (!decompressor.update(packed, unpacked, data.size()) || !decompressor.finished() || unpacked != data) {
+			fprintf(stderr, "compression: round trip mismatch\n");
+			exit(1);
+		}
+		std::string params = std::string("\"data\": \"") + (text ? "text" : "random") + "\", " + param("size", data.size()) + ", " + param("packed", packed.size());
+		Bench::run("compression.compress", params, 50, [&](uint32_t) {
+			lz_compress(data, Type::Resource::SPOOL_CHUNK_SIZE);
+		});
+		Bench::run("compression.decompress", params, 200, [&](uint32_t) {
+			Utilities::LzDecompressor decompressor;
+			Bytes unpacked;
+			decompressor.update(packed, unpacked, data.size());
+		});
+	}
+}
+
+// ─── Transport ───────────────────────────────────────────────────────────────
+static void bench_transport() {
+	Bytes payload_link_request = Cryptography::random(Type::Link::ECPUBSIZE);
+
+	for (size_t paths : std::initializer_list<size_t>{16, 64, 256}) {
+		fill_path_table(paths);
+		size_t table = Transport::get_destination_table().size();
+		std::vector<Bytes> known;
+		for (const auto& [hash, entry] : Transport::get_destination_table()) known.push_back(hash);
+
+		// Announces for new destinations, validated on the loop() that follows
+		const uint32_t announce_iterations = 32;
+		add_nodes(announce_iterations * (Bench::REPEATS + 1));
+		Bench::run("transport.inbound.announce", param("paths", table), announce_iterations, [&](uint32_t) {
+			Transport::inbound(nodes[next_node++].announce_raw, bench_interface);
+			Transport::loop();
+		});
+
+		// Data for known destinations, forwarded as their next hop
+		const uint32_t data_iterations = 1000;
+		std::vector<Bytes> data_frames;
+		for (uint32_t i = 0; i < data_iterations * (Bench::REPEATS + 1); i++) {
+			data_frames.push_back(make_transport_frame(Type::Packet::DATA, known[i % known.size()], numbered_payload(next_serial++, 128)));
+		}
+		uint32_t data_next = 0;
+		Bench::run("transport.inbound.data", param("paths", table), data_iterations, [&](uint32_t) {
+			Transport::inbound(data_frames[data_next++], bench_interface);
+		});
+
+		// Link requests set up link table entries, then link data follows them
+		const uint32_t link_iterations = 200;
+		std::vector<Bytes> link_frames;
+		for (uint32_t i = 0; i < link_iterations * (Bench::REPEATS + 1); i++) {
+			link_frames.push_back(make_transport_frame(Type::Packet::LINKREQUEST, known[i % known.size()], numbered_payload(next_serial++, payload_link_request.size())));
+		}
+		std::vector<Bytes> link_ids;
+		for (const Bytes& frame : link_frames) {
+			Packet packet(Destination(Type::NONE), frame);
+			packet.unpack();
+			link_ids.push_back(Link::link_id_from_lr_packet(packet));
+		}
+		uint32_t link_next = 0;
+		Bench::run("transport.inbound.link_request", param("paths", table), link_iterations, [&](uint32_t) {
+			Transport::inbound(link_frames[link_next++], bench_interface);
+		});
+		uint32_t link_data_next = 0;
+		Bench::run("transport.inbound.link_data", param("paths", table), link_iterations, [&](uint32_t) {
+			uint32_t n = link_data_next++;
+			Transport::inbound(make_link_frame(link_ids[n % link_ids.size()], numbered_payload(next_serial++, 128)), bench_interface);
+		});
+	}
+}
+
+// ─── Link cipher ─────────────────────────────────────────────────────────────
+// Link::encrypt()/decrypt() are a Token over the link's 64-byte derived key
+static void bench_link() {
+	Cryptography::Token token(Cryptography::random(64));
+	for (size_t size : std::initializer_list<size_t>{64, 256, Type::Link::MDU}) {
+		Bytes plaintext = Cryptography::random(size);
+		Bench::run("link.encrypt", param("payload", size), 2000, [&](uint32_t) {
+			token.encrypt(plaintext);
+		});
+		Bytes ciphertext = token.encrypt(plaintext);
+		Bench::run("link.decrypt", param("payload", size), 2000, [&](uint32_t) {
+			token.decrypt(ciphertext);
+		});
+	}
+}
+
+// ─── Persistence ─────────────────────────────────────────────────────────────
+static void bench_persistence() {
+	size_t paths = Transport::get_destination_table().size();
+	char path_table_path[Type::Reticulum::FILEPATH_MAXSIZE];
+	snprintf(path_table_path, sizeof(path_table_path), "%s/path_table", Reticulum::_storagepath);
+
+	// Without a file the save writes every record instead of appending deltas
+	Bench::run("persist.path_table.save", param("paths", paths), 1, [&](uint32_t) {
+		Transport::write_path_table();
+	}, [&]() {
+		if (Utilities::OS::file_exists(path_table_path)) Utilities::OS::remove_file(path_table_path);
+	});
+	Bench::run("persist.path_table.load", param("paths", paths), 1, [&](uint32_t) {
+		Transport::read_path_table();
+	});
+	// Path responses read the announce back from RAM, or from the spill file once pushed out
+	std::vector<Bytes> announce_hashes;
+	for (const auto& [destination_hash, destination_entry] : Transport::get_destination_table()) {
+		announce_hashes.push_back(destination_entry._announce_packet);
+	}
+	Bench::run("persist.packet_cache.get", param("paths", paths), announce_hashes.size(), [&](uint32_t i) {
+		Transport::get_cached_packet(announce_hashes[i]);
+	});
+	Bench::run("persist.packet_hashlist.save", param("hashes", Transport::hashlist_maxsize()), 1, [&](uint32_t) {
+		Transport::write_packet_hashlist();
+	});
+	Bench::run("persist.known_destinations.load", param("paths", paths), 1, [&](uint32_t) {
+		Identity::load_known_destinations();
+	});
+}
+
+int main() {
+	loglevel(LOG_ERROR);
+
+	host_filesystem = new HostFileSystem();
+	Utilities::OS::register_filesystem(host_filesystem);
+
+	bench_interface = new BenchInterface();
+	bench_interface.mode(Type::Interface::MODE_FULL);
+	Transport::register_interface(bench_interface);
+	Transport::path_table_maxsize(1024);
+	Transport::path_table_maxpersist(1024);
+	Identity::known_destinations_maxsize(2048);
+
+	Reticulum reticulum;
+	reticulum.transport_enabled(true);
+	reticulum.start();
+
+	bench_bytes();
+	bench_packet();
+	bench_identity();
+	bench_curve25519();
+	bench_compression();
+	bench_transport();
+	bench_link();
+	bench_persistence();
+
+	Bench::write_json(stdout, MICRORETICULUM_VERSION);
+	return 0;
+}
+
+#endif // RNS_BENCHMARK
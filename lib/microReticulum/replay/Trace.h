@@ -0,0 +1,163 @@
+#pragma once
+
+#include <Bytes.h>
+
+#include <string>
+#include <vector>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// CBA Reader for the packet traces the firmware writes to /tracefile.txt.
+//
+// The firmware's on_receive_packet() and on_transmit_packet() append one line per
+// packet, its time of day from getTimeString() followed by the direction and the
+// raw frame in hex:
+//
+//   00:12:31.337 recv: 0800a1b2...
+//   2-03:00:01.002 send: 5100...
+//
+// The day prefix appears once the device has been up for a day. Host logs put a
+// date in front of the time instead ("2026-10-14 09:30:00.250"), and lines copied
+// out of a verbose serial log carry the same shape after their own prefix, so the
+// reader looks for the direction marker anywhere in the line and takes the time
+// just before it. Lines that do not parse, like the decoded dumps written to
+// /tracedetails.txt, are counted and skipped.
+//
+// Captures from the firmware's PacketCapture.h (/capture.pcap, or a TCP stream
+// saved to a file) are read as well, recognised by the PCAP magic. Their records
+// carry an 8 byte pseudo-header in front of the frame, bit 0 of its flags byte
+// set for transmitted frames.
+namespace Replay {
+
+	struct TraceRecord {
+		double time;		// seconds since the first record of the trace
+		bool received;		// recv line, sent lines are what the original node transmitted
+		RNS::Bytes raw;
+	};
+
+	struct Trace {
+		std::vector<TraceRecord> records;
+		size_t received = 0;
+		size_t sent = 0;
+		size_t skipped = 0;
+
+		inline double duration() const { return records.empty() ? 0 : records.back().time; }
+	};
+
+	// Seconds since midnight, plus whole days, from the time just before end
+	inline bool parse_time(const char* line, const char* end, double& seconds) {
+		// walk back over "[D-]HH:MM:SS.mmm", a date in front is separated by a space
+		const char* start = end;
+		while (start > line && (isdigit((unsigned char)start[-1]) || start[-1] == ':' || start[-1] == '.' || start[-1] == '-')) --start;
+		std::string text(start, end - start);
+		unsigned days = 0, hours = 0, minutes = 0, secs = 0, millis = 0;
+		size_t dash = text.find('-');
+		if (dash != std::string::npos) {
+			days = atoi(text.c_str());
+			text.erase(0, dash + 1);
+		}
+		if (sscanf(text.c_str(), "%u:%u:%u.%u", &hours, &minutes, &secs, &millis) != 4) return false;
+		seconds = days * 86400.0 + hours * 3600.0 + minutes * 60.0 + secs + millis / 1000.0;
+		return true;
+	}
+
+	inline bool parse_hex(const char* hex, RNS::Bytes& raw) {
+		size_t length = 0;
+		while (isxdigit((unsigned char)hex[length])) ++length;
+		// the rest of the line may only be whitespace
+		for (const char* rest = hex + length; *rest; ++rest) {
+			if (!isspace((unsigned char)*rest)) return false;
+		}
+		if (length < 4 || length % 2 != 0) return false;
+		raw.assignHex((const uint8_t*)hex, length);
+		return true;
+	}
+
+	inline bool parse_line(const char* line, TraceRecord& record, double& absolute) {
+		const char* marker = strstr(line, " recv: ");
+		record.received = (marker != nullptr);
+		if (!marker) marker = strstr(line, " send: ");
+		if (!marker) return false;
+		if (!parse_time(line, marker, absolute)) return false;
+		return parse_hex(marker + 7, record.raw);
+	}
+
+	static const uint32_t PCAP_MAGIC = 0xa1b2c3d4;
+	static const uint32_t PCAP_LINKTYPE_USER0 = 147;
+	static const uint8_t PCAP_PSEUDO_HEADER_LEN = 8;
+	static const uint8_t PCAP_FLAG_TX = 0x01;
+
+	// Little-endian captures, as the device writes them
+	inline bool read_pcap(FILE* file, Trace& trace) {
+		uint32_t header[6];
+		if (fread(header, sizeof(header), 1, file) != 1 || header[0] != PCAP_MAGIC) return false;
+		size_t skip = (header[5] == PCAP_LINKTYPE_USER0) ? PCAP_PSEUDO_HEADER_LEN : 0;
+		double first = -1;
+		uint32_t record[4];
+		std::vector<uint8_t> data;
+		while (fread(record, sizeof(record), 1, file) == 1) {
+			data.resize(record[2]);
+			if (record[2] > 0 && fread(data.data(), record[2], 1, file) != 1) break;
+			// a frame cut at the snap length cannot be replayed
+			if (record[2] < skip + 2 || record[2] != record[3]) {
+				++trace.skipped;
+				continue;
+			}
+			double absolute = record[0] + record[1] / 1000000.0;
+			if (first < 0) first = absolute;
+			TraceRecord entry;
+			entry.time = absolute - first;
+			if (!trace.records.empty() && entry.time < trace.records.back().time) entry.time = trace.records.back().time;
+			entry.received = !(skip > 0 && (data[1] & PCAP_FLAG_TX));
+			entry.raw.assign(data.data() + skip, record[2] - skip);
+			(entry.received ? trace.received : trace.sent) += 1;
+			trace.records.push_back(entry);
+		}
+		return true;
+	}
+
+	// Reads every record of a trace file, times relative to its first record.
+	// Traces that run past midnight without a day prefix are followed across it.
+	inline bool read_trace(const char* path, Trace& trace) {
+		FILE* file = fopen(path, "rb");
+		if (!file) return false;
+		uint32_t magic = 0;
+		if (fread(&magic, sizeof(magic), 1, file) == 1 && magic == PCAP_MAGIC) {
+			rewind(file);
+			bool ok = read_pcap(file, trace);
+			fclose(file);
+			return ok;
+		}
+		rewind(file);
+		char line[4096];
+		double first = -1;
+		double previous = 0;
+		double wrap = 0;
+		while (fgets(line, sizeof(line), file)) {
+			TraceRecord record;
+			double absolute;
+			if (!parse_line(line, record, absolute)) {
+				if (line[0] != '\n' && line[0] != '\r') ++trace.skipped;
+				continue;
+			}
+			absolute += wrap;
+			if (first >= 0 && absolute + 43200 < previous) {
+				wrap += 86400;
+				absolute += 86400;
+			}
+			if (first < 0) first = absolute;
+			previous = absolute;
+			// keep the trace ordered even if the clock stepped back a little
+			record.time = absolute - first;
+			if (!trace.records.empty() && record.time < trace.records.back().time) record.time = trace.records.back().time;
+			(record.received ? trace.received : trace.sent) += 1;
+			trace.records.push_back(record);
+		}
+		fclose(file);
+		return true;
+	}
+
+}
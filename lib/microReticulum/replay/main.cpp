@@ -0,0 +1,315 @@
+// CBA Packet trace replay for the microReticulum stack.
+//
+// Build and run on Linux from lib/microReticulum:
+//
+//   pio run -e native_replay && .pio/build/native_replay/program tracefile.txt > replay.json
+//
+// Feeds every received frame of a firmware trace or capture (see Trace.h) into
+// Transport::inbound() on a single interface, either at the pace it was captured
+// or, with --fast, back to back. Transport's own timers run on the wall clock, so
+// a fast replay packs the whole trace into a few periodic job passes; use the
+// captured pace when table culling and announce retransmission should behave as
+// they did on the device.
+//
+// The time of a packet is its inbound() call plus the loop() pass that follows
+// it, since announces are only validated from the queue there. Per packet times
+// are reported as percentiles overall and per packet type, and heap use and table
+// sizes are sampled every --interval seconds of trace time. Progress goes to
+// stderr, the JSON document to stdout.
+//
+//   --fast                replay back to back instead of at the captured pace
+//   --speed X             pace multiplier when not --fast (1)
+//   --interval S          trace seconds between samples (10)
+//   --mode MODE           interface mode: full, gateway, boundary, access_point (full)
+//   --identity FILE       transport identity private key (64 bytes), e.g. the
+//                         node's storage/transport_identity, so transport traffic
+//                         addressed to it is forwarded as it was
+//   --path-table N        Transport path_table_maxsize (library default)
+//   --hashlist N          Transport hashlist_maxsize (library default)
+//   --known N             Identity known_destinations_maxsize (library default)
+
+#ifdef RNS_REPLAY
+
+#include "Trace.h"
+#include "HostFileSystem.h"
+
+#include <Reticulum.h>
+#include <Transport.h>
+#include <Interface.h>
+#include <Identity.h>
+#include <Bytes.h>
+#include <Log.h>
+#include <Utilities/OS.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef MICRORETICULUM_VERSION
+#define MICRORETICULUM_VERSION "0.2.4"
+#endif
+
+using namespace RNS;
+using namespace Replay;
+using clock_type = std::chrono::steady_clock;
+
+struct ReplayConfig {
+	std::vector<const char*> traces;
+	bool fast = false;
+	double speed = 1;
+	double interval = 10;
+	Type::Interface::modes mode = Type::Interface::MODE_FULL;
+	const char* identity = nullptr;
+	uint16_t path_table_maxsize = 0;		// 0 keeps the library default
+	uint16_t hashlist_maxsize = 0;
+	uint16_t known_destinations_maxsize = 0;
+};
+
+// ─── Replay interface ────────────────────────────────────────────────────────
+// Drops what Transport sends back out, the interface counters keep the totals
+class ReplayInterface : public InterfaceImpl {
+public:
+	ReplayInterface() : InterfaceImpl("ReplayInterface") {
+		_IN = true;
+		_OUT = true;
+		_HW_MTU = 508;
+		_bitrate = 1000000;
+	}
+protected:
+	virtual void send_outgoing(const Bytes& data) {
+		InterfaceImpl::handle_outgoing(data);
+	}
+};
+
+static Interface replay_interface({Type::NONE});
+static FileSystem host_filesystem({Type::NONE});
+
+static uint32_t heap_in_use() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+	return (uint32_t)mallinfo2().uordblks;
+#else
+	return (uint32_t)mallinfo().uordblks;
+#endif
+}
+
+// ─── Statistics ──────────────────────────────────────────────────────────────
+struct Timings {
+	std::vector<double> ns;
+
+	inline void add(double value) { ns.push_back(value); }
+
+	// Nearest rank, ns is sorted by write_timings()
+	inline double percentile(double p) const {
+		if (ns.empty()) return 0;
+		size_t rank = (size_t)(p / 100.0 * ns.size());
+		return ns[(rank < ns.size()) ? rank : ns.size() - 1];
+	}
+};
+
+struct Sample {
+	double time;
+	uint32_t packets;
+	uint32_t heap_bytes;
+	uint32_t heap_peak_bytes;
+	uint32_t path_table;
+	uint32_t link_table;
+	uint32_t announce_rate_table;
+	uint32_t known_destinations;
+	uint32_t sent_packets;
+};
+
+static const char* const packet_type_names[] = {"data", "announce", "link_request", "proof"};
+
+static Timings all_timings;
+static Timings type_timings[4];
+static std::vector<Sample> samples;
+static uint32_t heap_peak = 0;
+static uint32_t replayed = 0;
+
+static void sample(double time) {
+	uint32_t heap = heap_in_use();
+	if (heap > heap_peak) heap_peak = heap;
+	samples.push_back({time, replayed, heap, heap_peak,
+	                   (uint32_t)Transport::get_destination_table().size(),
+	                   (uint32_t)Transport::get_link_table().size(),
+	                   (uint32_t)Transport::get_announce_rate_table().size(),
+	                   (uint32_t)Identity::_known_destinations.size(),
+	                   replay_interface.txp()});
+}
+
+// ─── Replay ──────────────────────────────────────────────────────────────────
+static void replay(Reticulum& reticulum, const Trace& trace, const ReplayConfig& config) {
+	clock_type::time_point start = clock_type::now();
+	double next_sample = 0;
+	size_t progress = trace.records.size() / 10;
+	for (size_t i = 0; i < trace.records.size(); i++) {
+		const TraceRecord& record = trace.records[i];
+		if (!record.received) continue;
+
+		while (record.time >= next_sample) {
+			sample(next_sample);
+			next_sample += config.interval;
+		}
+		if (!config.fast) {
+			// keep the stack's loop running until the packet is due
+			clock_type::time_point due = start + std::chrono::duration_cast<clock_type::duration>(std::chrono::duration<double>(record.time / config.speed));
+			while (clock_type::now() < due) {
+				reticulum.loop();
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}
+
+		clock_type::time_point before = clock_type::now();
+		Transport::inbound(record.raw, replay_interface);
+		reticulum.loop();
+		double ns = std::chrono::duration<double, std::nano>(clock_type::now() - before).count();
+		all_timings.add(ns);
+		type_timings[record.raw.data()[0] & 0x03].add(ns);
+		++replayed;
+
+		uint32_t heap = heap_in_use();
+		if (heap > heap_peak) heap_peak = heap;
+		if (progress > 0 && i % progress == 0) fprintf(stderr, "%3u%% %u packets, %u paths\n", (unsigned)(i * 100 / trace.records.size()), replayed, (unsigned)Transport::get_destination_table().size());
+	}
+	// drain the validation queue before the last sample
+	for (uint8_t i = 0; i < Type::Transport::ANNOUNCE_VALIDATION_MAXSIZE; i++) reticulum.loop();
+	sample(trace.duration());
+}
+
+// ─── Output ──────────────────────────────────────────────────────────────────
+static void write_timings(FILE* out, const char* name, Timings& timings, bool last) {
+	std::sort(timings.ns.begin(), timings.ns.end());
+	double total = 0;
+	for (double ns : timings.ns) total += ns;
+	fprintf(out, "    \"%s\": {\"packets\": %u, \"mean_ns\": %.0f, \"p50_ns\": %.0f, \"p90_ns\": %.0f, \"p99_ns\": %.0f, \"p999_ns\": %.0f, \"max_ns\": %.0f}%s\n",
+	        name, (unsigned)timings.ns.size(), timings.ns.empty() ? 0.0 : total / timings.ns.size(),
+	        timings.percentile(50), timings.percentile(90), timings.percentile(99), timings.percentile(99.9),
+	        timings.ns.empty() ? 0.0 : timings.ns.back(), last ? "" : ",");
+}
+
+static void write_json(FILE* out, const ReplayConfig& config, const Trace& trace, double elapsed) {
+	fprintf(out, "{\n  \"suite\": \"microReticulum-replay\",\n  \"version\": \"%s\",\n", MICRORETICULUM_VERSION);
+	fprintf(out, "  \"config\": {\"fast\": %s, \"speed\": %.2f, \"interval_s\": %.1f, \"mode\": %u, \"identity\": %s},\n",
+	        config.fast ? "true" : "false", config.speed, config.interval, config.mode, config.identity ? "true" : "false");
+	fprintf(out, "  \"trace\": {\"records\": %u, \"received\": %u, \"sent\": %u, \"skipped\": %u, \"duration_s\": %.3f},\n",
+	        (unsigned)trace.records.size(), (unsigned)trace.received, (unsigned)trace.sent, (unsigned)trace.skipped, trace.duration());
+	fprintf(out, "  \"replay\": {\"packets\": %u, \"elapsed_s\": %.3f, \"sent_packets\": %u, \"sent_bytes\": %u, \"heap_peak_bytes\": %u},\n",
+	        replayed, elapsed, replay_interface.txp(), (unsigned)replay_interface.txb(), heap_peak);
+	fprintf(out, "  \"timings\": {\n");
+	write_timings(out, "all", all_timings, false);
+	for (uint8_t type = 0; type < 4; type++) write_timings(out, packet_type_names[type], type_timings[type], type == 3);
+	fprintf(out, "  },\n  \"samples\": [\n");
+	for (size_t i = 0; i < samples.size(); i++) {
+		const Sample& s = samples[i];
+		fprintf(out, "    {\"t\": %.1f, \"packets\": %u, \"heap_bytes\": %u, \"heap_peak_bytes\": %u, \"path_table\": %u, \"link_table\": %u, \"announce_rate_table\": %u, \"known_destinations\": %u, \"sent_packets\": %u}%s\n",
+		        s.time, s.packets, s.heap_bytes, s.heap_peak_bytes, s.path_table, s.link_table, s.announce_rate_table,
+		        s.known_destinations, s.sent_packets, (i + 1 < samples.size()) ? "," : "");
+	}
+	fprintf(out, "  ]\n}\n");
+}
+
+// ─── Arguments ───────────────────────────────────────────────────────────────
+static bool parse(int argc, char** argv, ReplayConfig& config) {
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--fast") { config.fast = true; continue; }
+		if (arg.compare(0, 2, "--") != 0) { config.traces.push_back(argv[i]); continue; }
+		if (i + 1 >= argc) { fprintf(stderr, "missing value for %s\n", arg.c_str()); return false; }
+		const char* value = argv[++i];
+		if (arg == "--speed") config.speed = atof(value);
+		else if (arg == "--interval") config.interval = atof(value);
+		else if (arg == "--mode") {
+			if (strcmp(value, "full") == 0) config.mode = Type::Interface::MODE_FULL;
+			else if (strcmp(value, "gateway") == 0) config.mode = Type::Interface::MODE_GATEWAY;
+			else if (strcmp(value, "boundary") == 0) config.mode = Type::Interface::MODE_BOUNDARY;
+			else if (strcmp(value, "access_point") == 0) config.mode = Type::Interface::MODE_ACCESS_POINT;
+			else { fprintf(stderr, "unknown mode %s\n", value); return false; }
+		}
+		else if (arg == "--identity") config.identity = value;
+		else if (arg == "--path-table") config.path_table_maxsize = atoi(value);
+		else if (arg == "--hashlist") config.hashlist_maxsize = atoi(value);
+		else if (arg == "--known") config.known_destinations_maxsize = atoi(value);
+		else { fprintf(stderr, "unknown option %s\n", arg.c_str()); return false; }
+	}
+	if (config.traces.empty()) { fprintf(stderr, "usage: program [options] TRACE...\n"); return false; }
+	if (config.speed <= 0 || config.interval <= 0) { fprintf(stderr, "speed and interval must be positive\n"); return false; }
+	return true;
+}
+
+// The private key as the firmware stores it, read from the host's disk
+static bool read_identity(const char* path, Bytes& key) {
+	FILE* file = fopen(path, "rb");
+	if (!file) return false;
+	uint8_t buffer[Type::Identity::KEYSIZE / 8];
+	size_t read = fread(buffer, 1, sizeof(buffer), file);
+	fclose(file);
+	if (read != sizeof(buffer)) return false;
+	key.assign(buffer, sizeof(buffer));
+	return true;
+}
+
+int main(int argc, char** argv) {
+	ReplayConfig config;
+	if (!parse(argc, argv, config)) return 2;
+	loglevel(LOG_ERROR);
+
+	// Traces from several files are replayed one after another
+	Trace trace;
+	for (const char* path : config.traces) {
+		Trace part;
+		if (!read_trace(path, part)) { fprintf(stderr, "cannot read %s\n", path); return 1; }
+		double offset = trace.records.empty() ? 0 : trace.duration() + 1;
+		for (TraceRecord& record : part.records) {
+			record.time += offset;
+			trace.records.push_back(record);
+		}
+		trace.received += part.received;
+		trace.sent += part.sent;
+		trace.skipped += part.skipped;
+	}
+	fprintf(stderr, "trace: %u received, %u sent, %u lines skipped, %.0f s\n",
+	        (unsigned)trace.received, (unsigned)trace.sent, (unsigned)trace.skipped, trace.duration());
+	if (trace.received == 0) { fprintf(stderr, "no received packets in trace\n"); return 1; }
+
+	host_filesystem = new HostFileSystem();
+	Utilities::OS::register_filesystem(host_filesystem);
+
+	replay_interface = new ReplayInterface();
+	replay_interface.mode(config.mode);
+	Transport::register_interface(replay_interface);
+	if (config.path_table_maxsize) {
+		Transport::path_table_maxsize(config.path_table_maxsize);
+		Transport::path_table_maxpersist(config.path_table_maxsize);
+	}
+	if (config.hashlist_maxsize) Transport::hashlist_maxsize(config.hashlist_maxsize);
+	if (config.known_destinations_maxsize) Identity::known_destinations_maxsize(config.known_destinations_maxsize);
+
+	Reticulum reticulum;
+	if (config.identity) {
+		// start() loads the transport identity from storage when one is there
+		Bytes key;
+		if (!read_identity(config.identity, key)) { fprintf(stderr, "cannot read identity %s\n", config.identity); return 1; }
+		char path[Type::Reticulum::FILEPATH_MAXSIZE];
+		snprintf(path, sizeof(path), "%s/transport_identity", Reticulum::_storagepath);
+		Utilities::OS::write_file(path, key);
+	}
+	reticulum.transport_enabled(true);
+	reticulum.start();
+	fprintf(stderr, "transport identity %s\n", Transport::identity().hash().toHex().c_str());
+
+	heap_peak = heap_in_use();
+	clock_type::time_point start = clock_type::now();
+	replay(reticulum, trace, config);
+	double elapsed = std::chrono::duration<double>(clock_type::now() - start).count();
+
+	write_json(stdout, config, trace, elapsed);
+	return 0;
+}
+
+#endif // RNS_REPLAY
@@ -0,0 +1,259 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+#include <math.h>
+#include <stdint.h>
+
+// CBA Virtual LoRa channel shared by all simulated nodes.
+//
+// Airtime follows the firmware's update_airtime_model() and updateBitrate() for an
+// SX1262, including its preamble target and the split of frames over SINGLE_MTU
+// into two, and the one byte RNode header on every frame. Nodes are placed at
+// random in a square; two nodes hear each other within range, and a frame reaches
+// a neighbour unless that neighbour was itself transmitting, or another neighbour
+// of it was, at any time the frame was on air. There is no capture effect.
+//
+// Each node has a TX queue drained with the firmware's style of CSMA: the channel
+// has to be sensed idle for DIFS, then for a random number of slots out of the
+// contention window, and sensing only sees a transmission once its preamble has
+// been on air for a few symbols, so nodes that pick the same slot still collide.
+namespace Sim {
+
+	struct RadioParams {
+		uint8_t sf = 7;
+		uint32_t bw = 125000;
+		uint8_t cr = 5;
+
+		// Firmware constants, Config.h
+		static constexpr uint16_t SINGLE_MTU = 255;
+		static constexpr uint8_t HEADER_L = 1;
+		static constexpr uint8_t PHY_HEADER_LORA_SYMBOLS = 20;
+		static constexpr uint8_t PHY_CRC_LORA_BITS = 16;
+		static constexpr uint8_t LORA_PREAMBLE_SYMBOLS_MIN = 18;
+		static constexpr float LORA_PREAMBLE_TARGET_MS = 24;
+		static constexpr uint8_t CSMA_SLOT_SYMBOLS = 12;
+		static constexpr uint8_t CSMA_SLOT_MIN_MS = 24;
+		static constexpr uint8_t CSMA_SLOT_MAX_MS = 100;
+		static constexpr uint8_t CSMA_CW_WINDOW = 15;
+		static constexpr uint8_t CSMA_DETECT_SYMBOLS = 4;
+
+		inline double symbol_time_ms() const { return pow(2, sf) / ((double)bw / 1000.0); }
+		inline uint32_t bitrate() const { return (uint32_t)(sf * ((4.0 / cr) / (pow(2, sf) / ((double)bw / 1000.0))) * 1000.0); }
+		inline uint32_t slot_us() const {
+			double slot_ms = symbol_time_ms() * CSMA_SLOT_SYMBOLS;
+			if (slot_ms > CSMA_SLOT_MAX_MS) slot_ms = CSMA_SLOT_MAX_MS;
+			if (slot_ms < CSMA_SLOT_MIN_MS) slot_ms = CSMA_SLOT_MIN_MS;
+			return (uint32_t)(slot_ms * 1000);
+		}
+		inline uint32_t difs_us() const { return 2 * slot_us(); }
+		inline uint32_t detect_us() const { return (uint32_t)(CSMA_DETECT_SYMBOLS * symbol_time_ms() * 1000); }
+
+		inline double preamble_symbols() const {
+			double target = LORA_PREAMBLE_TARGET_MS / symbol_time_ms();
+			return (target < LORA_PREAMBLE_SYMBOLS_MIN) ? LORA_PREAMBLE_SYMBOLS_MIN : ceil(target);
+		}
+
+		// One modem frame of written bytes, header included
+		inline uint32_t frame_airtime_us(uint16_t written) const {
+			int ldr_opt = (symbol_time_ms() > 16.0) ? 1 : 0;
+			double symbols = 0;
+			if (sf < 7) {
+				symbols += (8 * written + PHY_CRC_LORA_BITS - 4 * sf + PHY_HEADER_LORA_SYMBOLS);
+				symbols /= 4 * sf;
+				symbols *= cr;
+				symbols += preamble_symbols() + 2.25 + 8;
+			}
+			else {
+				symbols += (8 * written + PHY_CRC_LORA_BITS - 4 * sf + 8 + PHY_HEADER_LORA_SYMBOLS);
+				symbols /= 4 * (sf - 2 * ldr_opt);
+				symbols *= cr;
+				symbols += preamble_symbols() + 0.25 + 8;
+			}
+			return (uint32_t)(symbols * symbol_time_ms() * 1000.0);
+		}
+
+		// A packet as Transport hands it to the interface
+		inline uint32_t airtime_us(size_t length) const {
+			size_t written = length + HEADER_L;
+			if (written <= SINGLE_MTU) return frame_airtime_us(written);
+			return frame_airtime_us(SINGLE_MTU) + frame_airtime_us(written - SINGLE_MTU + HEADER_L);
+		}
+	};
+
+	class Channel {
+
+	public:
+		using Deliver = std::function<void(uint16_t node, const std::string& frame)>;
+
+		struct Stats {
+			uint64_t frames = 0;			// frames put on air
+			uint64_t airtime_us = 0;
+			uint64_t receptions = 0;		// frame deliveries to neighbours
+			uint64_t collisions = 0;		// frame/neighbour pairs lost to overlap
+			uint64_t half_duplex = 0;		// frame/neighbour pairs lost because the neighbour was transmitting
+			uint64_t queue_drops = 0;
+			uint64_t backoffs = 0;
+		};
+
+	private:
+		struct Transmission {
+			uint16_t sender;
+			uint64_t start;
+			uint64_t end;
+			std::string frame;
+			bool done;
+		};
+
+		enum State : uint8_t { IDLE, BACKOFF, TRANSMITTING };
+
+		struct Node {
+			double x, y;
+			std::vector<uint16_t> neighbours;
+			std::vector<bool> hears;		// hears[n] when n is a neighbour
+			std::deque<std::string> queue;
+			State state = IDLE;
+			uint64_t backoff_until = 0;
+		};
+
+	public:
+		Channel(const RadioParams& radio, size_t nodes, double side_m, double range_m, size_t queue_max, uint32_t seed) :
+			_radio(radio), _range(range_m), _queue_max(queue_max), _random(seed)
+		{
+			std::uniform_real_distribution<double> position(0, side_m);
+			_nodes.resize(nodes);
+			for (Node& node : _nodes) {
+				node.x = position(_random);
+				node.y = position(_random);
+				node.hears.assign(nodes, false);
+			}
+			for (uint16_t a = 0; a < nodes; a++) {
+				for (uint16_t b = 0; b < nodes; b++) {
+					if (a == b) continue;
+					double dx = _nodes[a].x - _nodes[b].x, dy = _nodes[a].y - _nodes[b].y;
+					if (sqrt(dx * dx + dy * dy) <= range_m) {
+						_nodes[a].neighbours.push_back(b);
+						_nodes[a].hears[b] = true;
+					}
+				}
+			}
+		}
+
+		inline const RadioParams& radio() const { return _radio; }
+		inline const Stats& stats() const { return _stats; }
+		inline size_t neighbours(uint16_t node) const { return _nodes[node].neighbours.size(); }
+
+		double mean_neighbours() const {
+			size_t total = 0;
+			for (const Node& node : _nodes) total += node.neighbours.size();
+			return _nodes.empty() ? 0 : (double)total / _nodes.size();
+		}
+
+		// Nodes that can reach node 0 over any number of hops, as a share of all nodes
+		double connectivity() const {
+			std::vector<bool> seen(_nodes.size(), false);
+			std::vector<uint16_t> open = {0};
+			seen[0] = true;
+			size_t reached = 1;
+			while (!open.empty()) {
+				uint16_t node = open.back();
+				open.pop_back();
+				for (uint16_t n : _nodes[node].neighbours) {
+					if (!seen[n]) { seen[n] = true; ++reached; open.push_back(n); }
+				}
+			}
+			return (double)reached / _nodes.size();
+		}
+
+		void queue(uint16_t node, const std::string& frame) {
+			if (_nodes[node].queue.size() >= _queue_max) {
+				++_stats.queue_drops;
+				return;
+			}
+			_nodes[node].queue.push_back(frame);
+		}
+
+		// Advances the channel to now, delivering every frame that finished on air
+		void step(uint64_t now, const Deliver& deliver) {
+			for (Transmission& tx : _air) {
+				if (!tx.done && now >= tx.end) finish(tx, deliver);
+			}
+			// forget transmissions nothing still on air could overlap with
+			while (!_air.empty() && _air.front().done && _air.front().end + _longest < now) _air.pop_front();
+
+			for (uint16_t n = 0; n < _nodes.size(); n++) {
+				Node& node = _nodes[n];
+				if (node.state == TRANSMITTING) continue;
+				if (node.queue.empty()) { node.state = IDLE; continue; }
+				if (busy(n, now)) {
+					// start over once the channel is free again
+					if (node.state == BACKOFF) ++_stats.backoffs;
+					node.state = IDLE;
+					continue;
+				}
+				if (node.state == IDLE) {
+					std::uniform_int_distribution<uint32_t> window(0, RadioParams::CSMA_CW_WINDOW);
+					node.backoff_until = now + _radio.difs_us() + (uint64_t)window(_random) * _radio.slot_us();
+					node.state = BACKOFF;
+				}
+				if (node.state == BACKOFF && now >= node.backoff_until) {
+					transmit(n, now);
+				}
+			}
+		}
+
+	private:
+		// What node senses on the channel at time now
+		bool busy(uint16_t node, uint64_t now) const {
+			for (const Transmission& tx : _air) {
+				if (tx.done || !_nodes[node].hears[tx.sender]) continue;
+				if (now >= tx.start + _radio.detect_us()) return true;
+			}
+			return false;
+		}
+
+		void transmit(uint16_t n, uint64_t now) {
+			Node& node = _nodes[n];
+			std::string frame = node.queue.front();
+			node.queue.pop_front();
+			uint32_t airtime = _radio.airtime_us(frame.size());
+			if (airtime > _longest) _longest = airtime;
+			_air.push_back({n, now, now + airtime, frame, false});
+			node.state = TRANSMITTING;
+			++_stats.frames;
+			_stats.airtime_us += airtime;
+		}
+
+		void finish(Transmission& tx, const Deliver& deliver) {
+			tx.done = true;
+			_nodes[tx.sender].state = IDLE;
+			for (uint16_t receiver : _nodes[tx.sender].neighbours) {
+				bool lost = false;
+				for (const Transmission& other : _air) {
+					if (&other == &tx || other.start >= tx.end || other.end <= tx.start) continue;
+					if (other.sender == receiver) { ++_stats.half_duplex; lost = true; break; }
+					if (_nodes[receiver].hears[other.sender]) { ++_stats.collisions; lost = true; break; }
+				}
+				if (!lost) {
+					++_stats.receptions;
+					deliver(receiver, tx.frame);
+				}
+			}
+		}
+
+	private:
+		RadioParams _radio;
+		double _range;
+		size_t _queue_max;
+		std::mt19937 _random;
+		std::vector<Node> _nodes;
+		std::deque<Transmission> _air;
+		uint32_t _longest = 0;
+		Stats _stats;
+
+	};
+
+}
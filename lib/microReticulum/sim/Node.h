@@ -0,0 +1,247 @@
+#pragma once
+
+#include "Wire.h"
+#include "HostFileSystem.h"
+
+#include <Reticulum.h>
+#include <Transport.h>
+#include <Interface.h>
+#include <Identity.h>
+#include <Destination.h>
+#include <Packet.h>
+#include <Bytes.h>
+#include <Log.h>
+#include <Cryptography/Random.h>
+#include <Utilities/OS.h>
+
+#include <RNG.h>
+
+#include <random>
+#include <vector>
+#include <malloc.h>
+#include <poll.h>
+#include <sys/resource.h>
+
+// CBA One simulated node, run in its own process after fork().
+//
+// The node is a complete Reticulum instance with transport enabled, a LoRa
+// interface on the shared channel and, for backbone nodes, a TCP backbone
+// interface. It announces a single destination, and once the hub has started
+// traffic sends data packets at random intervals to random other nodes whose
+// identity it has learned from their announces.
+namespace Sim {
+
+	struct NodeConfig {
+		uint16_t index = 0;
+		uint16_t nodes = 0;
+		bool backbone = false;
+		uint32_t lora_bitrate = 0;
+		float announce_cap = RNS::Type::Reticulum::ANNOUNCE_CAP / 100.0;
+		uint16_t path_table_maxsize = 0;		// 0 keeps the library default
+		uint16_t hashlist_maxsize = 0;
+		uint16_t known_destinations_maxsize = 0;
+		double announce_interval = 600;
+		double data_interval = 10;
+		uint16_t data_size = 64;
+		uint32_t seed = 0;
+	};
+
+	class SimInterface : public RNS::InterfaceImpl {
+	public:
+		SimInterface(const char* name, int fd, uint8_t type, uint32_t bitrate, uint16_t hw_mtu, float announce_cap) :
+			RNS::InterfaceImpl(name), _fd(fd), _type(type)
+		{
+			_IN = true;
+			_OUT = true;
+			_HW_MTU = hw_mtu;
+			_bitrate = bitrate;
+			_announce_cap = announce_cap;
+			_online = true;
+		}
+	protected:
+		virtual void send_outgoing(const RNS::Bytes& data) {
+			send_message(_fd, _type, data.data(), data.size());
+			InterfaceImpl::handle_outgoing(data);
+		}
+	private:
+		int _fd;
+		uint8_t _type;
+	};
+
+	class NodeProcess {
+
+	public:
+		NodeProcess(const NodeConfig& config, int fd) : _config(config), _fd(fd), _random(config.seed * 65599 + config.index) {}
+
+		int run();
+
+	private:
+		static void packet_received(const RNS::Bytes& data, const RNS::Packet& packet) { ++_delivered; }
+
+		static uint32_t heap_in_use() {
+		#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+			return (uint32_t)mallinfo2().uordblks;
+		#else
+			return (uint32_t)mallinfo().uordblks;
+		#endif
+		}
+
+		// Uniform in [0, max)
+		double random_time(double max) { return std::uniform_real_distribution<double>(0, max)(_random); }
+
+		void send_data();
+		void report();
+
+	private:
+		NodeConfig _config;
+		int _fd;
+		std::mt19937 _random;
+		std::vector<RNS::Bytes> _peers;
+		bool _traffic = false;
+		uint32_t _sent = 0;
+		uint32_t _unroutable = 0;
+		uint32_t _heap_peak = 0;
+		static uint32_t _delivered;
+
+	};
+
+	uint32_t NodeProcess::_delivered = 0;
+
+	// Node main loop, returns the process exit code
+	inline int NodeProcess::run() {
+		using namespace RNS;
+		loglevel(LOG_NONE);
+
+		static FileSystem host_filesystem({Type::NONE});
+		host_filesystem = new HostFileSystem();
+		Utilities::OS::register_filesystem(host_filesystem);
+
+		Reticulum reticulum;
+		// every node is forked from the same RNG state
+		uint32_t stir[3] = {_config.seed, _config.index, (uint32_t)getpid()};
+		RNG.stir((const uint8_t*)stir, sizeof(stir));
+
+		Interface lora({Type::NONE});
+		lora = new SimInterface("SimLoRa", _fd, MSG_LORA, _config.lora_bitrate, 508, _config.announce_cap);
+		lora.mode(Type::Interface::MODE_FULL);
+		Transport::register_interface(lora);
+
+		Interface backbone({Type::NONE});
+		if (_config.backbone) {
+			backbone = new SimInterface("SimBackbone", _fd, MSG_BACKBONE, 10000000, 1064, _config.announce_cap);
+			backbone.mode(Type::Interface::MODE_FULL);
+			backbone.is_backbone(true);
+			Transport::register_interface(backbone);
+		}
+
+		if (_config.path_table_maxsize) {
+			Transport::path_table_maxsize(_config.path_table_maxsize);
+			Transport::path_table_maxpersist(_config.path_table_maxsize);
+		}
+		if (_config.hashlist_maxsize) Transport::hashlist_maxsize(_config.hashlist_maxsize);
+		if (_config.known_destinations_maxsize) Identity::known_destinations_maxsize(_config.known_destinations_maxsize);
+
+		reticulum.transport_enabled(true);
+		reticulum.start();
+
+		Identity identity;
+		Destination destination(identity, Type::Destination::IN, Type::Destination::SINGLE, "sim", "node");
+		destination.set_packet_callback(packet_received);
+		send_message(_fd, MSG_HASH, destination.hash().data(), destination.hash().size());
+
+		// spread the first announces over the first interval so nodes do not start in step
+		double now = Utilities::OS::time();
+		double next_announce = now + random_time(_config.announce_interval < 10 ? _config.announce_interval : 10);
+		double next_data = 0;
+
+		while (true) {
+			pollfd pfd = {_fd, POLLIN, 0};
+			::poll(&pfd, 1, 2);
+
+			uint8_t type;
+			std::string data;
+			while (receive_message(_fd, type, data) && type != 0) {
+				Bytes frame((const uint8_t*)data.data(), data.size());
+				switch (type) {
+				case MSG_LORA:
+					lora.handle_incoming(frame);
+					break;
+				case MSG_BACKBONE:
+					if (backbone) backbone.handle_incoming(frame);
+					break;
+				case MSG_PEERS:
+					_peers.clear();
+					for (size_t i = 0; i + 16 <= frame.size(); i += 16) {
+						Bytes peer = frame.mid(i, 16);
+						if (peer != destination.hash()) _peers.push_back(peer);
+					}
+					break;
+				case MSG_TRAFFIC:
+					_traffic = true;
+					next_data = Utilities::OS::time() + random_time(_config.data_interval);
+					break;
+				case MSG_QUIET:
+					_traffic = false;
+					break;
+				case MSG_STOP:
+					report();
+					return 0;
+				}
+			}
+			if (type == 0 && pfd.revents & (POLLHUP | POLLERR)) return 1;
+
+			reticulum.loop();
+
+			now = Utilities::OS::time();
+			if (now >= next_announce) {
+				destination.announce();
+				next_announce = now + _config.announce_interval;
+			}
+			if (_traffic && now >= next_data && !_peers.empty()) {
+				send_data();
+				// Poisson traffic, the mean gap is the data interval
+				next_data = now + std::exponential_distribution<double>(1.0 / _config.data_interval)(_random);
+			}
+			uint32_t heap = heap_in_use();
+			if (heap > _heap_peak) _heap_peak = heap;
+		}
+	}
+
+	inline void NodeProcess::send_data() {
+		using namespace RNS;
+		const Bytes& peer = _peers[std::uniform_int_distribution<size_t>(0, _peers.size() - 1)(_random)];
+		Identity identity = Identity::recall(peer);
+		if (!identity) {
+			++_unroutable;
+			return;
+		}
+		Destination destination(identity, Type::Destination::OUT, Type::Destination::SINGLE, "sim", "node");
+		Packet packet(destination, Cryptography::random(_config.data_size));
+		packet.send();
+		++_sent;
+	}
+
+	inline void NodeProcess::report() {
+		using namespace RNS;
+		NodeStats stats = {};
+		stats.node = _config.index;
+		stats.heap_bytes = heap_in_use();
+		stats.heap_peak_bytes = (_heap_peak > stats.heap_bytes) ? _heap_peak : stats.heap_bytes;
+		rusage usage;
+		getrusage(RUSAGE_SELF, &usage);
+		stats.cpu_us = (uint64_t)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000 + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+		for (auto& [hash, interface] : Transport::get_interfaces()) {
+			bool is_backbone = interface.is_backbone();
+			(is_backbone ? stats.backbone_rx : stats.lora_rx) += interface.rxp();
+			(is_backbone ? stats.backbone_tx : stats.lora_tx) += interface.txp();
+			stats.announces_dropped += interface.announces_dropped();
+		}
+		stats.data_sent = _sent;
+		stats.data_unroutable = _unroutable;
+		stats.data_delivered = _delivered;
+		stats.path_table = Transport::get_destination_table().size();
+		stats.known_destinations = Identity::_known_destinations.size();
+		send_message(_fd, MSG_STATS, (const uint8_t*)&stats, sizeof(stats));
+	}
+
+}
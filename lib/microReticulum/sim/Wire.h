@@ -0,0 +1,78 @@
+#pragma once
+
+#include <string>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// CBA Messages between the simulator hub and its node processes.
+//
+// Every node is a forked process with its own copy of the (static) Transport, and
+// talks to the hub over one SOCK_SEQPACKET socketpair, so each message arrives
+// whole: a type byte followed by its payload.
+namespace Sim {
+
+	enum MessageType : uint8_t {
+		MSG_LORA     = 'L',	// frame to put on air (node → hub) or received from it (hub → node)
+		MSG_BACKBONE = 'B',	// frame on the TCP backbone, either direction
+		MSG_HASH     = 'H',	// node → hub: its destination hash, once at startup
+		MSG_PEERS    = 'P',	// hub → node: every node's destination hash, concatenated
+		MSG_TRAFFIC  = 'T',	// hub → node: start sending data packets
+		MSG_QUIET    = 'D',	// hub → node: stop sending, let traffic drain
+		MSG_STOP     = 'Q',	// hub → node: report and exit
+		MSG_STATS    = 'S'	// node → hub: NodeStats
+	};
+
+	// Everything a node reports when it is stopped
+	struct NodeStats {
+		uint32_t node;
+		uint32_t heap_bytes;		// allocated from the heap at the end of the run
+		uint32_t heap_peak_bytes;	// highest allocation seen when sampled
+		uint64_t cpu_us;			// user + system time of the process
+		uint32_t lora_rx;
+		uint32_t lora_tx;
+		uint32_t backbone_rx;
+		uint32_t backbone_tx;
+		uint32_t data_sent;			// data packets sent to a destination with a known identity
+		uint32_t data_unroutable;	// data packets not sent, destination identity unknown
+		uint32_t data_delivered;	// data packets received for our destination
+		uint32_t path_table;
+		uint32_t known_destinations;
+		uint32_t announces_dropped;
+	};
+
+	static const size_t MESSAGE_MAXSIZE = 16384;
+
+	inline bool send_message(int fd, uint8_t type, const uint8_t* data, size_t size) {
+		uint8_t buffer[MESSAGE_MAXSIZE];
+		if (size + 1 > sizeof(buffer)) return false;
+		buffer[0] = type;
+		if (size > 0) memcpy(buffer + 1, data, size);
+		while (true) {
+			ssize_t written = ::send(fd, buffer, size + 1, MSG_NOSIGNAL);
+			if (written >= 0) return (size_t)written == size + 1;
+			if (errno != EINTR) return false;
+		}
+	}
+
+	inline bool send_message(int fd, uint8_t type, const std::string& data = std::string()) {
+		return send_message(fd, type, (const uint8_t*)data.data(), data.size());
+	}
+
+	// Returns false on a closed or failed socket, type 0 when nothing was waiting
+	inline bool receive_message(int fd, uint8_t& type, std::string& data, bool wait = false) {
+		uint8_t buffer[MESSAGE_MAXSIZE];
+		ssize_t read = ::recv(fd, buffer, sizeof(buffer), wait ? 0 : MSG_DONTWAIT);
+		if (read < 0) {
+			type = 0;
+			return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+		}
+		if (read == 0) return false;
+		type = buffer[0];
+		data.assign((const char*)buffer + 1, read - 1);
+		return true;
+	}
+
+}
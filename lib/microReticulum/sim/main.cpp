@@ -0,0 +1,313 @@
+// CBA Multi-node network simulator for the microReticulum stack.
+//
+// Build and run on Linux from lib/microReticulum:
+//
+//   pio run -e native_sim && .pio/build/native_sim/program --nodes 5,10,20,40 > sim.json
+//
+// Every node is a forked process running the real stack, so Transport's static
+// state stays per node, and the hub (this process) connects them through the
+// virtual LoRa channel in Channel.h and an optional TCP backbone shared by the
+// first --backbone nodes. The simulation runs in real time: the stack's timers
+// are wall clock timers, and frames take their modelled airtime to arrive.
+//
+// One run per node count in --nodes. A run announces for --warmup seconds, sends
+// data packets until --drain seconds before the end, and then collects what every
+// node reports. Progress goes to stderr, the JSON document to stdout.
+//
+//   --nodes LIST          node counts to run, comma separated (5,10,20,40)
+//   --duration S          length of each run (180)
+//   --warmup S            announce-only start of each run (60)
+//   --drain S             quiet end of each run (15)
+//   --density N           mean LoRa neighbours, sets the area per run (6)
+//   --range M             LoRa range in metres (2000)
+//   --backbone N          nodes on the TCP backbone (0)
+//   --backbone-latency MS one way backbone delay (5)
+//   --sf --bw --cr        LoRa modulation (7, 125000, 5)
+//   --queue N             TX queue per node in frames (32)
+//   --path-table N        Transport path_table_maxsize (library default)
+//   --hashlist N          Transport hashlist_maxsize (library default)
+//   --known N             Identity known_destinations_maxsize (library default)
+//   --announce-cap PCT    announce cap in percent of bitrate (ANNOUNCE_CAP)
+//   --announce-interval S interval between announces of each node (600)
+//   --data-interval S     mean interval between data packets of each node (10)
+//   --data-size N         data payload size (64)
+//   --seed N              placement and traffic seed (1)
+
+#ifdef RNS_SIMULATOR
+
+#include "Channel.h"
+#include "Node.h"
+#include "Wire.h"
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifndef MICRORETICULUM_VERSION
+#define MICRORETICULUM_VERSION "0.2.4"
+#endif
+
+using namespace Sim;
+
+struct SimConfig {
+	std::vector<uint16_t> node_counts = {5, 10, 20, 40};
+	double duration = 180;
+	double warmup = 60;
+	double drain = 15;
+	double density = 6;
+	double range = 2000;
+	uint16_t backbone = 0;
+	uint32_t backbone_latency_ms = 5;
+	size_t queue = 32;
+	RadioParams radio;
+	NodeConfig node;
+};
+
+struct RunResult {
+	uint16_t nodes;
+	double side_m;
+	double mean_neighbours;
+	double connectivity;
+	Channel::Stats channel;
+	std::vector<NodeStats> stats;
+};
+
+static uint64_t now_us() {
+	using namespace std::chrono;
+	return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// ─── Run ─────────────────────────────────────────────────────────────────────
+static bool run(const SimConfig& config, uint16_t nodes, RunResult& result) {
+	// area grows with the node count so the density stays the same
+	double side = config.range * sqrt(M_PI * nodes / config.density);
+	Channel channel(config.radio, nodes, side, config.range, config.queue, config.node.seed + nodes);
+	result.nodes = nodes;
+	result.side_m = side;
+	result.mean_neighbours = channel.mean_neighbours();
+	result.connectivity = channel.connectivity();
+	fprintf(stderr, "run: %u nodes, %.0f m square, %.1f neighbours, %.0f%% connected\n",
+	        nodes, side, result.mean_neighbours, result.connectivity * 100);
+
+	std::vector<int> fds;
+	std::vector<pid_t> pids;
+	for (uint16_t n = 0; n < nodes; n++) {
+		int pair[2];
+		if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, pair) != 0) { perror("socketpair"); return false; }
+		fflush(stdout);
+		fflush(stderr);
+		pid_t pid = fork();
+		if (pid < 0) { perror("fork"); return false; }
+		if (pid == 0) {
+			for (int fd : fds) close(fd);
+			close(pair[0]);
+			NodeConfig node = config.node;
+			node.index = n;
+			node.nodes = nodes;
+			node.backbone = n < config.backbone;
+			node.lora_bitrate = config.radio.bitrate();
+			NodeProcess process(node, pair[1]);
+			_exit(process.run());
+		}
+		close(pair[1]);
+		fds.push_back(pair[0]);
+		pids.push_back(pid);
+	}
+
+	// every node reports its destination hash once the stack is up
+	std::string peers(nodes * 16, '\0');
+	for (uint16_t n = 0; n < nodes; n++) {
+		uint8_t type = 0;
+		std::string data;
+		while (type != MSG_HASH) {
+			if (!receive_message(fds[n], type, data, true)) { fprintf(stderr, "node %u failed to start\n", n); return false; }
+		}
+		peers.replace(n * 16, 16, data.substr(0, 16));
+	}
+	for (int fd : fds) send_message(fd, MSG_PEERS, peers);
+
+	std::multimap<uint64_t, std::pair<uint16_t, std::string>> backbone_pending;
+	std::vector<pollfd> pfds(nodes);
+	for (uint16_t n = 0; n < nodes; n++) pfds[n] = {fds[n], POLLIN, 0};
+
+	uint64_t start = now_us();
+	uint64_t traffic_at = start + (uint64_t)(config.warmup * 1e6);
+	uint64_t quiet_at = start + (uint64_t)((config.duration - config.drain) * 1e6);
+	uint64_t stop_at = start + (uint64_t)(config.duration * 1e6);
+	bool traffic = false, quiet = false;
+	uint64_t next_progress = start + 10000000;
+
+	auto deliver = [&](uint16_t node, const std::string& frame) { send_message(fds[node], MSG_LORA, frame); };
+
+	while (true) {
+		::poll(pfds.data(), pfds.size(), 1);
+		uint64_t now = now_us();
+		for (uint16_t n = 0; n < nodes; n++) {
+			uint8_t type;
+			std::string data;
+			while (receive_message(fds[n], type, data) && type != 0) {
+				if (type == MSG_LORA) {
+					channel.queue(n, data);
+				}
+				else if (type == MSG_BACKBONE) {
+					uint64_t at = now + config.backbone_latency_ms * 1000;
+					for (uint16_t peer = 0; peer < config.backbone && peer < nodes; peer++) {
+						if (peer != n) backbone_pending.insert({at, {peer, data}});
+					}
+				}
+			}
+		}
+		while (!backbone_pending.empty() && backbone_pending.begin()->first <= now) {
+			auto& [peer, frame] = backbone_pending.begin()->second;
+			send_message(fds[peer], MSG_BACKBONE, frame);
+			backbone_pending.erase(backbone_pending.begin());
+		}
+		channel.step(now, deliver);
+
+		if (!traffic && now >= traffic_at) {
+			for (int fd : fds) send_message(fd, MSG_TRAFFIC);
+			traffic = true;
+		}
+		if (!quiet && now >= quiet_at) {
+			for (int fd : fds) send_message(fd, MSG_QUIET);
+			quiet = true;
+		}
+		if (now >= next_progress) {
+			fprintf(stderr, "  %3.0f s: %llu frames, %llu collisions\n", (now - start) / 1e6,
+			        (unsigned long long)channel.stats().frames, (unsigned long long)channel.stats().collisions);
+			next_progress += 10000000;
+		}
+		if (now >= stop_at) break;
+	}
+
+	for (int fd : fds) send_message(fd, MSG_STOP);
+	result.channel = channel.stats();
+	for (uint16_t n = 0; n < nodes; n++) {
+		uint8_t type = 0;
+		std::string data;
+		while (type != MSG_STATS) {
+			if (!receive_message(fds[n], type, data, true)) break;
+		}
+		if (type == MSG_STATS && data.size() == sizeof(NodeStats)) {
+			NodeStats stats;
+			memcpy(&stats, data.data(), sizeof(stats));
+			result.stats.push_back(stats);
+		}
+		close(fds[n]);
+	}
+	for (pid_t pid : pids) waitpid(pid, nullptr, 0);
+	return result.stats.size() == nodes;
+}
+
+// ─── Report ──────────────────────────────────────────────────────────────────
+static void write_json(FILE* out, const SimConfig& config, const std::vector<RunResult>& results) {
+	const RadioParams& radio = config.radio;
+	fprintf(out, "{\n  \"suite\": \"microReticulum-sim\",\n  \"version\": \"%s\",\n", MICRORETICULUM_VERSION);
+	fprintf(out, "  \"radio\": {\"sf\": %u, \"bw\": %u, \"cr\": %u, \"bitrate\": %u, \"slot_ms\": %.1f, \"airtime_255_ms\": %.1f},\n",
+	        radio.sf, radio.bw, radio.cr, radio.bitrate(), radio.slot_us() / 1000.0, radio.airtime_us(254) / 1000.0);
+	fprintf(out, "  \"duration_s\": %.0f, \"warmup_s\": %.0f, \"drain_s\": %.0f, \"backbone\": %u,\n",
+	        config.duration, config.warmup, config.drain, config.backbone);
+	fprintf(out, "  \"runs\": [\n");
+	for (size_t r = 0; r < results.size(); r++) {
+		const RunResult& result = results[r];
+		uint64_t heap = 0, heap_max = 0, heap_peak = 0, cpu = 0, packets = 0, paths = 0, paths_max = 0, known = 0;
+		uint64_t sent = 0, unroutable = 0, delivered = 0, announces_dropped = 0;
+		for (const NodeStats& stats : result.stats) {
+			heap += stats.heap_bytes;
+			if (stats.heap_bytes > heap_max) heap_max = stats.heap_bytes;
+			if (stats.heap_peak_bytes > heap_peak) heap_peak = stats.heap_peak_bytes;
+			cpu += stats.cpu_us;
+			packets += stats.lora_rx + stats.lora_tx + stats.backbone_rx + stats.backbone_tx;
+			paths += stats.path_table;
+			if (stats.path_table > paths_max) paths_max = stats.path_table;
+			known += stats.known_destinations;
+			sent += stats.data_sent;
+			unroutable += stats.data_unroutable;
+			delivered += stats.data_delivered;
+			announces_dropped += stats.announces_dropped;
+		}
+		size_t count = result.stats.empty() ? 1 : result.stats.size();
+		const Channel::Stats& channel = result.channel;
+		fprintf(out, "    {\"nodes\": %u, \"side_m\": %.0f, \"mean_neighbours\": %.2f, \"connectivity\": %.3f,\n",
+		        result.nodes, result.side_m, result.mean_neighbours, result.connectivity);
+		fprintf(out, "     \"frames\": %llu, \"node_airtime\": %.4f, \"receptions\": %llu, \"collisions\": %llu, \"half_duplex\": %llu, \"queue_drops\": %llu, \"backoffs\": %llu,\n",
+		        (unsigned long long)channel.frames, channel.airtime_us / (config.duration * 1e6 * result.nodes),
+		        (unsigned long long)channel.receptions, (unsigned long long)channel.collisions, (unsigned long long)channel.half_duplex,
+		        (unsigned long long)channel.queue_drops, (unsigned long long)channel.backoffs);
+		fprintf(out, "     \"data_sent\": %llu, \"data_unroutable\": %llu, \"data_delivered\": %llu, \"delivery_ratio\": %.3f,\n",
+		        (unsigned long long)sent, (unsigned long long)unroutable, (unsigned long long)delivered,
+		        (sent + unroutable) ? (double)delivered / (sent + unroutable) : 0.0);
+		fprintf(out, "     \"heap_mean\": %llu, \"heap_max\": %llu, \"heap_peak\": %llu, \"cpu_us_per_packet\": %.1f,\n",
+		        (unsigned long long)(heap / count), (unsigned long long)heap_max, (unsigned long long)heap_peak,
+		        packets ? (double)cpu / packets : 0.0);
+		fprintf(out, "     \"path_table_mean\": %.1f, \"path_table_max\": %llu, \"known_destinations_mean\": %.1f, \"announces_dropped\": %llu}%s\n",
+		        (double)paths / count, (unsigned long long)paths_max, (double)known / count, (unsigned long long)announces_dropped,
+		        (r + 1 < results.size()) ? "," : "");
+	}
+	fprintf(out, "  ]\n}\n");
+}
+
+// ─── Arguments ───────────────────────────────────────────────────────────────
+static bool parse(int argc, char** argv, SimConfig& config) {
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (i + 1 >= argc) { fprintf(stderr, "missing value for %s\n", arg.c_str()); return false; }
+		const char* value = argv[++i];
+		if (arg == "--nodes") {
+			config.node_counts.clear();
+			for (char* token = strtok((char*)value, ","); token; token = strtok(nullptr, ",")) config.node_counts.push_back(atoi(token));
+		}
+		else if (arg == "--duration") config.duration = atof(value);
+		else if (arg == "--warmup") config.warmup = atof(value);
+		else if (arg == "--drain") config.drain = atof(value);
+		else if (arg == "--density") config.density = atof(value);
+		else if (arg == "--range") config.range = atof(value);
+		else if (arg == "--backbone") config.backbone = atoi(value);
+		else if (arg == "--backbone-latency") config.backbone_latency_ms = atoi(value);
+		else if (arg == "--sf") config.radio.sf = atoi(value);
+		else if (arg == "--bw") config.radio.bw = atoi(value);
+		else if (arg == "--cr") config.radio.cr = atoi(value);
+		else if (arg == "--queue") config.queue = atoi(value);
+		else if (arg == "--path-table") config.node.path_table_maxsize = atoi(value);
+		else if (arg == "--hashlist") config.node.hashlist_maxsize = atoi(value);
+		else if (arg == "--known") config.node.known_destinations_maxsize = atoi(value);
+		else if (arg == "--announce-cap") config.node.announce_cap = atof(value) / 100.0;
+		else if (arg == "--announce-interval") config.node.announce_interval = atof(value);
+		else if (arg == "--data-interval") config.node.data_interval = atof(value);
+		else if (arg == "--data-size") config.node.data_size = atoi(value);
+		else if (arg == "--seed") config.node.seed = atoi(value);
+		else { fprintf(stderr, "unknown option %s\n", arg.c_str()); return false; }
+	}
+	if (config.warmup + config.drain >= config.duration) { fprintf(stderr, "warmup and drain leave no traffic time\n"); return false; }
+	return true;
+}
+
+int main(int argc, char** argv) {
+	SimConfig config;
+	config.node.seed = 1;
+	if (!parse(argc, argv, config)) return 2;
+	signal(SIGPIPE, SIG_IGN);
+
+	std::vector<RunResult> results;
+	for (uint16_t nodes : config.node_counts) {
+		if (nodes < 2) continue;
+		RunResult result;
+		if (!run(config, nodes, result)) {
+			fprintf(stderr, "run with %u nodes failed\n", nodes);
+			return 1;
+		}
+		results.push_back(result);
+	}
+	write_json(stdout, config, results);
+	return 0;
+}
+
+#endif // RNS_SIMULATOR
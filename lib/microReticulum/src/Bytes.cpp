@@ -20,18 +20,42 @@ void Bytes::newData(size_t capacity /*= 0*/) {
 //MEM("newData: Reserved data capacity");
 	}
 //MEM("newData: Assigning data to shared data pointer...");
-	_data = SharedData(data);
+	if (_heap) {
+		_data = SharedData(data);
+	}
+	else {
+		// an inline payload is dropped
+		new (&_data) SharedData(data);
+		_heap = true;
+		_inline_size = 0;
+	}
 //MEM("newData: Assigned data to shared data pointer");
 	_exclusive = true;
 }
 
 // Ensures that instance has exclusive shared data
+// - If instance holds an inline payload then move it (if requested) into new shared data with reserved capacity
 // - If instance has no shared data then create new shared data
 // - If instance does not have exclusive on shared data that is not empty then make a copy of shared data (if requests) and reserve capacity (if requested)
 // - If instance does not have exclusive on shared data that is empty then create new shared data
 // - If instance already has exclusive on shared data then do nothing except reserve capacity (if requested)
 void Bytes::exclusiveData(bool copy /*= true*/, size_t capacity /*= 0*/) {
-	if (!_data) {
+	if (!_heap) {
+		Data* data = new Data();
+		if (data == nullptr) {
+			ERROR("Bytes failed to allocate data buffer");
+			throw std::runtime_error("Failed to allocate data buffer");
+		}
+		size_t size = copy ? _inline_size : 0;
+		data->reserve((capacity > size) ? capacity : size);
+		data->insert(data->end(), _inline, _inline + size);
+		// the inline bytes share storage with the shared data pointer
+		_inline_size = 0;
+		new (&_data) SharedData(data);
+		_heap = true;
+		_exclusive = true;
+	}
+	else if (!_data) {
 		newData(capacity);
 	}
 	else if (!_exclusive) {
@@ -81,39 +105,45 @@ void Bytes::exclusiveData(bool copy /*= true*/, size_t capacity /*= 0*/) {
 	}
 }
 
-int Bytes::compare(const Bytes& bytes) const {
-	if (_data == bytes._data) {
-		return 0;
-	}
-	else if (!_data) {
-		return -1;
-	}
-	else if (!bytes._data) {
-		return 1;
-	}
-	else if (*_data < *(bytes._data)) {
-		return -1;
+// Moves the payload into inline storage of size bytes (no more than INLINE_MAXSIZE), keeping
+// the leading bytes and zeroing any new ones
+void Bytes::inlineData(size_t size) {
+	if (_heap) {
+		uint8_t buffer[INLINE_MAXSIZE];
+		size_t keep = (size < this->size()) ? size : this->size();
+		if (keep > 0) {
+			memcpy(buffer, data(), keep);
+		}
+		release();
+		memcpy(_inline, buffer, keep);
+		_inline_size = (uint8_t)keep;
 	}
-	else if (*_data > *(bytes._data)) {
-		return 1;
+	if (size > _inline_size) {
+		memset(_inline + _inline_size, 0, size - _inline_size);
 	}
-	else {
+	_inline_size = (uint8_t)size;
+}
+
+int Bytes::compare(const Bytes& bytes) const {
+	if (_heap && bytes._heap && _data == bytes._data) {
 		return 0;
 	}
+	return compare(bytes.data(), bytes.size());
 }
 
 int Bytes::compare(const uint8_t* buf, size_t size) const {
-	if (!_data && size == 0) {
+	size_t length = this->size();
+	if (length == 0 && size == 0) {
 		return 0;
 	}
-	else if (!_data) {
+	else if (length == 0) {
 		return -1;
 	}
-	int cmp = memcmp(_data->data(), buf, (_data->size() < size) ? _data->size() : size);
-	if (cmp == 0 && _data->size() < size) {
+	int cmp = (size > 0) ? memcmp(data(), buf, (length < size) ? length : size) : 0;
+	if (cmp == 0 && length < size) {
 		return -1;
 	}
-	else if (cmp == 0 && _data->size() > size) {
+	else if (cmp == 0 && length > size) {
 		return 1;
 	}
 	return cmp;
@@ -122,16 +152,20 @@ int Bytes::compare(const uint8_t* buf, size_t size) const {
 void Bytes::assignHex(const uint8_t* hex, size_t hex_size) {
 	// if assignment is empty then clear data and don't bother creating new
 	if (hex == nullptr || hex_size <= 0) {
-		_data = nullptr;
-		_exclusive = true;
+		release();
 		return;
 	}
-	exclusiveData(false, hex_size / 2);
 	// need to clear data since we're appending below
-	_data->clear();
-	for (size_t i = 0; i < hex_size; i += 2) {
+	if (fitsInline(hex_size / 2)) {
+		inlineData(0);
+	}
+	else {
+		exclusiveData(false, hex_size / 2);
+		_data->clear();
+	}
+	for (size_t i = 0; i + 1 < hex_size; i += 2) {
 		uint8_t byte = (hex[i] % 32 + 9) % 25 * 16 + (hex[i+1] % 32 + 9) % 25;
-		_data->push_back(byte);
+		append(byte);
 	}
 }
 
@@ -140,10 +174,12 @@ void Bytes::appendHex(const uint8_t* hex, size_t hex_size) {
 	if (hex == nullptr || hex_size <= 0) {
 		return;
 	}
-	exclusiveData(true, size() + (hex_size / 2));
-	for (size_t i = 0; i < hex_size; i += 2) {
+	if (_heap || size() + (hex_size / 2) > INLINE_MAXSIZE) {
+		exclusiveData(true, size() + (hex_size / 2));
+	}
+	for (size_t i = 0; i + 1 < hex_size; i += 2) {
 		uint8_t byte = (hex[i] % 32 + 9) % 25 * 16 + (hex[i+1] % 32 + 9) % 25;
-		_data->push_back(byte);
+		append(byte);
 	}
 }
 
@@ -164,11 +200,14 @@ std::string RNS::hexFromByte(uint8_t byte, bool upper /*= true*/) {
 }
 
 std::string Bytes::toHex(bool upper /*= false*/) const {
-	if (!_data) {
+	if (empty()) {
 		return "";
 	}
 	std::string hex;
-	for (uint8_t byte : *_data) {
+	hex.reserve(size() * 2);
+	const uint8_t* bytes = data();
+	for (size_t i = 0; i < size(); i++) {
+		uint8_t byte = bytes[i];
 		if (upper) {
 			hex += hex_upper_chars[ (byte&  0xF0) >> 4];
 			hex += hex_upper_chars[ (byte&  0x0F) >> 0];
@@ -183,7 +222,7 @@ std::string Bytes::toHex(bool upper /*= false*/) const {
 
 // mid
 Bytes Bytes::mid(size_t beginpos, size_t len) const {
-	if (!_data || beginpos >= size()) {
+	if (empty() || beginpos >= size()) {
 		return NONE;
 	}
 	if ((beginpos + len) >= size()) {
@@ -194,7 +233,7 @@ Bytes Bytes::mid(size_t beginpos, size_t len) const {
 
 // to end
 Bytes Bytes::mid(size_t beginpos) const {
-	if (!_data || beginpos >= size()) {
+	if (empty() || beginpos >= size()) {
 		return NONE;
 	}
 	 return {data() + beginpos, size() - beginpos};
@@ -12,6 +12,11 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <new>
+
+#if defined(RNS_USE_POOLS)
+#include "Utilities/Pool.h"
+#endif
 
 // Finds the start of the first occurrence of the substring needle of length needlelen in the  memory  area  haystack  of length haystacklen.
 inline void* memmem(const void* haystack, size_t haystack_len, const void* needle, size_t needle_len) {
@@ -37,65 +42,85 @@ namespace RNS {
 
 	#define COW
 
+	class BytesView;
+
+	// CBA Payloads of up to INLINE_MAXSIZE bytes (hashes, random blobs, flags, signalling bytes)
+	// are stored inside the object itself and copied by value. Larger payloads live in shared
+	// data that is copied on write. An exclusively owned shared buffer stays in use when it
+	// shrinks, so reused buffers keep their reserved capacity.
 	class Bytes {
 
+	public:
+		// What Bytes converts to and from
+		using Vector = std::vector<uint8_t>;
+
 	private:
 		//typedef std::vector<uint8_t> Data;
-		using Data = std::vector<uint8_t>;
+#if defined(RNS_USE_POOLS)
+		// CBA Shared storage comes from the packet buffer pools
+		using Data = std::vector<uint8_t, Utilities::BufferAllocator<uint8_t>>;
+#else
+		using Data = Vector;
+#endif
 		//typedef std::shared_ptr<Data> SharedData;
 		using SharedData = std::shared_ptr<Data>;
 
 	public:
+		static const size_t INLINE_MAXSIZE = 32;
+
 		enum NoneConstructor {
 			NONE
 		};
 
 	public:
 		Bytes() {
-			MEMF("Bytes object created from default, this: %lu, data: %lu", this, _data.get());
+			MEMF("Bytes object created from default, this: %lu, data: %lu", this, data());
 		}
 		Bytes(const NoneConstructor none) {
-			MEMF("Bytes object created from NONE, this: %lu, data: %lu", this, _data.get());
+			MEMF("Bytes object created from NONE, this: %lu, data: %lu", this, data());
 		}
 		Bytes(const Bytes& bytes) {
 //MEM("Bytes is using shared data");
 			assign(bytes);
-			MEMF("Bytes object copy created from bytes \"%s\", this: %lu, data: %lu", toString().c_str(), this, _data.get());
+			MEMF("Bytes object copy created from bytes \"%s\", this: %lu, data: %lu", toString().c_str(), this, data());
 		}
 		// Construct from std::vector<uint8_t>
-		Bytes(const Data& data) {
+		Bytes(const Vector& data) {
 MEM("Creating from data-copy...");
 			assign(data);
-			MEMF("Bytes object created from data-copy \"%s\", this: %lu, data: %lu", toString().c_str(), this, _data.get());
+			MEMF("Bytes object created from data-copy \"%s\", this: %lu, data: %lu", toString().c_str(), this, this->data());
 		}
 		// Construct from rvalue std::vector<uint8_t> (move)
-		Bytes(Data&& rdata) {
+		Bytes(Vector&& rdata) {
 MEM("Creating from data-move...");
 			assign(std::move(rdata));
-			MEMF("Bytes object created from data-move \"%s\", this: %lu, data: %lu", toString().c_str(), this, _data.get());
+			MEMF("Bytes object created from data-move \"%s\", this: %lu, data: %lu", toString().c_str(), this, data());
 		}
 		Bytes(const uint8_t* chunk, size_t size) {
 			assign(chunk, size);
-			MEMF("Bytes object created from chunk \"%s\", this: %lu, data: %lu", toString().c_str(), this, _data.get());
+			MEMF("Bytes object created from chunk \"%s\", this: %lu, data: %lu", toString().c_str(), this, data());
 		}
 		Bytes(const void* chunk, size_t size) {
 			assign(chunk, size);
-			MEMF("Bytes object created from chunk \"%s\", this: %lu, data: %lu", toString().c_str(), this, _data.get());
+			MEMF("Bytes object created from chunk \"%s\", this: %lu, data: %lu", toString().c_str(), this, data());
 		}
 		Bytes(const char* string) {
 			assign(string);
-			MEMF("Bytes object created from string \"%s\", this: %lu, data: %lu", toString().c_str(), this, _data.get());
+			MEMF("Bytes object created from string \"%s\", this: %lu, data: %lu", toString().c_str(), this, data());
 		}
 		Bytes(const std::string& string) {
 			assign(string);
-			MEMF("Bytes object created from std::string \"%s\", this: %lu, data: %lu", toString().c_str(), this, _data.get());
+			MEMF("Bytes object created from std::string \"%s\", this: %lu, data: %lu", toString().c_str(), this, data());
 		}
 		Bytes(size_t capacity) {
-			newData(capacity);
-			MEMF("Bytes object created with capacity %u, this: %lu, data: %lu", capacity, this, _data.get());
+			if (capacity > INLINE_MAXSIZE) {
+				newData(capacity);
+			}
+			MEMF("Bytes object created with capacity %u, this: %lu, data: %lu", capacity, this, data());
 		}
 		virtual ~Bytes() {
-			MEMF("Bytes object destroyed \"%s\", this: %lu, data: %lu", toString().c_str(), this, _data.get());
+			MEMF("Bytes object destroyed \"%s\", this: %lu, data: %lu", toString().c_str(), this, data());
+			release();
 		}
 
 		inline const Bytes& operator = (const Bytes& bytes) {
@@ -110,17 +135,17 @@ MEM("Creating from data-move...");
 		// CBA TODO Resolve ambiguity in JsonVariantConst assignments before enabling the following
 /*
 		// Assignment from std::vector<uint8_t>
-		inline const Bytes& operator = (const Data& data) {
+		inline const Bytes& operator = (const Vector& data) {
 			assign(data);
 			return *this;
 		}
 		// Move assignment from std::vector<uint8_t>
-		inline const Bytes& operator = (Data&& rdata) {
+		inline const Bytes& operator = (Vector&& rdata) {
 			assign(std::move(rdata));
 			return *this;
 		}
 */
-		inline const Bytes& operator += (const Data& data) {
+		inline const Bytes& operator += (const Vector& data) {
 			append(data);
 			return *this;
 		}
@@ -144,26 +169,24 @@ MEM("Creating from data-move...");
 		}
 
 		inline uint8_t& operator[](size_t index) {
-			if (!_data || index >= _data->size()) {
+			if (index >= size()) {
 				throw std::out_of_range("Index out of bounds");
 			}
-			return (*_data)[index];
+			return _heap ? (*_data)[index] : _inline[index];
 		}
 
 		inline const uint8_t& operator[](size_t index) const {
-			if (!_data || index >= _data->size()) {
+			if (index >= size()) {
 				throw std::out_of_range("Index out of bounds");
 			}
-			return (*_data)[index];
+			return _heap ? (*_data)[index] : _inline[index];
 		}
 
 		inline operator bool() const {
-			return (_data && !_data->empty());
+			return !empty();
 		}
-		inline operator const Data() const {
-			if (!_data)
-				return Data();
-			return *_data.get();
+		inline operator const Vector() const {
+			return collection();
 		}
 		// CBA NOTE: Following cast operators can cause issues with ambiguity from other libraries
 /*
@@ -180,6 +203,7 @@ MEM("Creating from data-move...");
 */
 
 	private:
+		// only valid while _heap
 		inline SharedData shareData() const {
 //MEM("Bytes is sharing its own data");
 			_exclusive = false;
@@ -187,56 +211,82 @@ MEM("Creating from data-move...");
 		}
 		void newData(size_t capacity = 0);
 		void exclusiveData(bool copy = true, size_t capacity = 0);
+		void inlineData(size_t size);
+		inline void release() {
+			if (_heap) {
+				_data.~SharedData();
+				_heap = false;
+			}
+			_inline_size = 0;
+			_exclusive = true;
+		}
+		// whether a payload of size bytes goes inline, an exclusive buffer is kept for reuse
+		inline bool fitsInline(size_t size) const {
+			return (size <= INLINE_MAXSIZE && !(_heap && _exclusive));
+		}
 
 	public:
 		inline void clear() {
-			_data = nullptr;
-			_exclusive = true;
+			release();
 		}
 
 		inline void assign(const Bytes& bytes) {
+			if (&bytes == this) {
+				return;
+			}
 #ifdef COW
-			_data = bytes.shareData();
-			_exclusive = false;
-#else
-			// if assignment is empty then clear data and don't bother creating new
-			if (bytes.size() <= 0) {
-				_data = nullptr;
-				_exclusive = true;
+			if (bytes._heap) {
+				if (_heap) {
+					_data = bytes.shareData();
+				}
+				else {
+					new (&_data) SharedData(bytes.shareData());
+					_heap = true;
+				}
+				_exclusive = false;
 				return;
 			}
-			exclusiveData(false, bytes._data->size());
-			//_data->insert(_data->begin(), bytes._data->begin(), bytes._data->end());
-			//_data->assign(bytes._data->begin(), bytes._data->end());
-			*_data = bytes._data;
+			release();
+			memcpy(_inline, bytes._inline, bytes._inline_size);
+			_inline_size = bytes._inline_size;
+#else
+			assign(bytes.data(), bytes.size());
 #endif
 		}
-		inline void assign(const Data& data) {
-			// if assignment is empty then clear data and don't bother creating new
-			if (data.size() <= 0) {
-				_data = nullptr;
-				_exclusive = true;
-				return;
-			}
-			exclusiveData(false, data.size());
-			//_data->assign(data.begin(), data.end());
-			*_data = data;
+		inline void assign(const Vector& data) {
+			assign(data.data(), data.size());
 		}
-		inline void assign(Data&& rdata) {
-			// if assignment is empty then clear data and don't bother creating new
-			if (rdata.size() <= 0) {
-				_data = nullptr;
-				_exclusive = true;
+		inline void assign(Vector&& rdata) {
+			if (fitsInline(rdata.size())) {
+				assign(rdata.data(), rdata.size());
 				return;
 			}
 			exclusiveData(false);
+#if defined(RNS_USE_POOLS)
+			// pooled storage can't adopt the vector's buffer
+			_data->assign(rdata.begin(), rdata.end());
+#else
 			*_data = std::move(rdata);
+#endif
 		}
 		inline void assign(const uint8_t* chunk, size_t chunk_size) {
 			// if assignment is empty then clear data and don't bother creating new
 			if (chunk == nullptr || chunk_size <= 0) {
-				_data = nullptr;
-				_exclusive = true;
+				release();
+				return;
+			}
+			if (fitsInline(chunk_size)) {
+				if (_heap) {
+					// chunk may point into the shared data about to be released
+					uint8_t buffer[INLINE_MAXSIZE];
+					memcpy(buffer, chunk, chunk_size);
+					release();
+					memcpy(_inline, buffer, chunk_size);
+				}
+				else {
+					memmove(_inline, chunk, chunk_size);
+				}
+				_inline_size = (uint8_t)chunk_size;
 				return;
 			}
 			exclusiveData(false, chunk_size);
@@ -249,14 +299,10 @@ MEM("Creating from data-move...");
 		inline void assign(const char* string) {
 			// if assignment is empty then clear data and don't bother creating new
 			if (string == nullptr || string[0] == 0) {
-				_data = nullptr;
-				_exclusive = true;
+				release();
 				return;
 			}
-			size_t string_size = strlen(string);
-			exclusiveData(false, string_size);
-			//_data->insert(_data->begin(), (uint8_t* )string, (uint8_t* )string + string_size);
-			_data->assign((uint8_t* )string, (uint8_t* )string + string_size);
+			assign((const uint8_t*)string, strlen(string));
 		}
 		//inline void assign(const std::string& string) { assign(string.c_str()); }
 		inline void assign(const std::string& string) { assign((uint8_t*)string.c_str(), string.length()); }
@@ -268,22 +314,35 @@ MEM("Creating from data-move...");
 			if (bytes.size() <= 0) {
 				return;
 			}
-			exclusiveData(true, size() + bytes.size());
-			_data->insert(_data->end(), bytes._data->begin(), bytes._data->end());
-		}
-		inline void append(const Data& data) {
-			// if append is empty then do nothing
-			if (data.size() <= 0) {
+			if (&bytes == this) {
+				// the copy keeps the source alive while this one grows
+				Bytes copy(bytes);
+				append(copy.data(), copy.size());
 				return;
 			}
-			exclusiveData(true, size() + data.size());
-			_data->insert(_data->end(), data.begin(), data.end());
+			append(bytes.data(), bytes.size());
+		}
+		inline void append(const Vector& data) {
+			append(data.data(), data.size());
 		}
 		inline void append(const uint8_t* chunk, size_t chunk_size) {
 			// if append is empty then do nothing
 			if (chunk == nullptr || chunk_size <= 0) {
 				return;
 			}
+			if (!_heap) {
+				if (_inline_size + chunk_size <= INLINE_MAXSIZE) {
+					memmove(_inline + _inline_size, chunk, chunk_size);
+					_inline_size += (uint8_t)chunk_size;
+					return;
+				}
+				if (chunk >= _inline && chunk < _inline + INLINE_MAXSIZE) {
+					// moving to shared data overwrites the inline bytes chunk points into
+					Bytes copy(chunk, chunk_size);
+					append(copy);
+					return;
+				}
+			}
 			exclusiveData(true, size() + chunk_size);
 			_data->insert(_data->end(), chunk, chunk + chunk_size);
 		}
@@ -295,36 +354,40 @@ MEM("Creating from data-move...");
 			if (string == nullptr || string[0] == 0) {
 				return;
 			}
-			size_t string_size = strlen(string);
-			exclusiveData(true, size() + string_size);
-			_data->insert(_data->end(), (uint8_t* )string, (uint8_t* )string + string_size);
+			append((const uint8_t*)string, strlen(string));
 		}
 		inline void append(uint8_t byte) {
+			if (!_heap && _inline_size < INLINE_MAXSIZE) {
+				_inline[_inline_size++] = byte;
+				return;
+			}
 			exclusiveData(true, size() + 1);
 			_data->push_back(byte);
 		}
+		inline void append(const BytesView& view);
 		//inline void append(const std::string& string) { append(string.c_str()); }
 		inline void append(const std::string& string) { append((uint8_t*)string.c_str(), string.length()); }
 		void appendHex(const uint8_t* hex, size_t hex_size);
 		inline void appendHex(const char* hex) { appendHex((uint8_t*)hex, strlen(hex)); }
 
+		// Exclusive buffer of size bytes (or the current size if 0), existing bytes are kept
+		// and new ones zeroed. The pointer is valid until the next change to this object.
 		inline uint8_t* writable(size_t size) {
-			if (size > 0) {
-				// create exclusive data with reserved capacity
-				exclusiveData(false, size);
-				// actually expand data to requested size
-				resize(size);
-				return _data->data();
+			if (size == 0) {
+				if (empty()) {
+					return nullptr;
+				}
+				size = this->size();
 			}
-			else if (_data) {
-				size_t current_size = _data->size();
-				// create exclusive data with reserved capacity
-				exclusiveData(false, current_size);
-				// actually expand data to current size
-				resize(current_size);
-				return _data->data();
+			if (fitsInline(size)) {
+				inlineData(size);
+				return _inline;
 			}
-			return nullptr;
+			// create exclusive data with reserved capacity
+			exclusiveData(true, size);
+			// actually expand data to requested size
+			_data->resize(size);
+			return _data->data();
 		}
 
 		inline void resize(size_t newsize) {
@@ -332,6 +395,10 @@ MEM("Creating from data-move...");
 			if (newsize == size()) {
 				return;
 			}
+			if (fitsInline(newsize)) {
+				inlineData(newsize);
+				return;
+			}
 			// CBA TODO Determine whether or not to reserve capacity here since when size is shrunk the call to
 			// exclusive data may copy all data firt which will effectively grow the data again before being
 			// shrunk below (inefficient).
@@ -343,29 +410,34 @@ MEM("Creating from data-move...");
 		int compare(const Bytes& bytes) const;
 		int compare(const uint8_t* buf, size_t size) const;
 		inline int compare(const char* str) const { return compare((const uint8_t*)str, strlen(str)); }
-		inline size_t size() const { if (!_data) return 0; return _data->size(); }
-		inline bool empty() const { if (!_data) return true; return _data->empty(); }
-		inline size_t capacity() const { if (!_data) return 0; return _data->capacity(); }
-		inline void reserve(size_t capacity) const { if (!_data) return; _data->reserve(capacity); }
-		inline const uint8_t* data() const { if (!_data) return nullptr; return _data->data(); }
-		inline const Data collection() const { if (!_data) return Data(); return *_data.get(); }
-
-		inline std::string toString() const { if (!_data) return ""; return {(const char*)data(), size()}; }
+		inline size_t size() const { if (!_heap) return _inline_size; if (!_data) return 0; return _data->size(); }
+		inline bool empty() const { return size() == 0; }
+		inline size_t capacity() const { if (!_heap) return INLINE_MAXSIZE; if (!_data) return 0; return _data->capacity(); }
+		inline void reserve(size_t capacity) const { if (!_heap || !_data) return; _data->reserve(capacity); }
+		inline const uint8_t* data() const { if (!_heap) return (_inline_size > 0) ? _inline : nullptr; if (!_data) return nullptr; return _data->data(); }
+		inline const Vector collection() const { if (empty()) return Vector(); return Vector(data(), data() + size()); }
+
+		inline std::string toString() const { if (empty()) return ""; return {(const char*)data(), size()}; }
 		std::string toHex(bool upper = false) const;
 		Bytes mid(size_t beginpos, size_t len) const;
 		Bytes mid(size_t beginpos) const;
-		inline Bytes left(size_t len) const { if (!_data) return NONE; if (len > size()) len = size(); return {data(), len}; }
-		inline Bytes right(size_t len) const { if (!_data) return NONE; if (len > size()) len = size(); return {data() + (size() - len), len}; }
+		// Non-copying equivalents of mid(), left() and right()
+		inline BytesView view(size_t beginpos, size_t len) const;
+		inline BytesView view(size_t beginpos) const;
+		inline BytesView view_left(size_t len) const;
+		inline BytesView view_right(size_t len) const;
+		inline Bytes left(size_t len) const { if (empty()) return NONE; if (len > size()) len = size(); return {data(), len}; }
+		inline Bytes right(size_t len) const { if (empty()) return NONE; if (len > size()) len = size(); return {data() + (size() - len), len}; }
 		inline int find(int pos, const char* str) {
-			if (!_data || _data->data() == nullptr || (size_t)pos >= _data->size()) {
+			if (empty() || (size_t)pos >= size()) {
 				return -1;
 			}
 			//const char* ptr = strnstr((const char*)(_data->data() + pos), str, (_data->size() - pos));
-			void* ptr = memmem((const void*)(_data->data() + pos), (_data->size() - pos), (const void*)str, strlen(str));
+			void* ptr = memmem((const void*)(data() + pos), (size() - pos), (const void*)str, strlen(str));
 			if (ptr == nullptr) {
 				return -1;
 			}
-			return (int)((uint8_t*)ptr - _data->data());
+			return (int)((const uint8_t*)ptr - data());
 		}
 		inline int find(const char* str) { return find(0, str); }
 
@@ -392,11 +464,91 @@ MEM("Creating from data-move...");
 		//   second to last element
 
 	private:
-		SharedData _data;
+		union {
+			SharedData _data;						// while _heap
+			uint8_t _inline[INLINE_MAXSIZE];		// otherwise
+		};
+		uint8_t _inline_size = 0;
+		bool _heap = false;
 		mutable bool _exclusive = true;
 
 	};
 
+	// CBA Non-owning slice of a Bytes buffer.
+	//
+	// A view shares the parent's data (just like a Bytes copy, so it costs a reference count,
+	// or a copy of an inline payload, and no allocation) and addresses a window of it by
+	// offset and length. Since the parent is marked shared, any later write through the
+	// parent lands in a fresh copy and the window seen by the view never changes. Use bytes() to materialize an owning copy only
+	// where one is actually retained.
+	class BytesView {
+
+	public:
+		BytesView() {}
+		BytesView(const Bytes& parent, size_t offset, size_t length) : _parent(parent) {
+			if (offset > parent.size()) {
+				offset = parent.size();
+			}
+			if (length > (parent.size() - offset)) {
+				length = parent.size() - offset;
+			}
+			_offset = offset;
+			_length = length;
+		}
+
+		inline bool operator == (const BytesView& view) const {
+			return compare(view.data(), view.size()) == 0;
+		}
+		inline bool operator != (const BytesView& view) const {
+			return compare(view.data(), view.size()) != 0;
+		}
+		inline bool operator == (const Bytes& bytes) const {
+			return compare(bytes.data(), bytes.size()) == 0;
+		}
+		inline bool operator != (const Bytes& bytes) const {
+			return compare(bytes.data(), bytes.size()) != 0;
+		}
+		inline const uint8_t& operator[](size_t index) const {
+			return data()[index];
+		}
+		inline operator bool() const {
+			return _length > 0;
+		}
+
+	public:
+		inline int compare(const uint8_t* buf, size_t size) const {
+			int cmp = (_length > 0 && size > 0) ? memcmp(data(), buf, (_length < size) ? _length : size) : 0;
+			if (cmp == 0 && _length < size) {
+				return -1;
+			}
+			else if (cmp == 0 && _length > size) {
+				return 1;
+			}
+			return cmp;
+		}
+		inline size_t size() const { return _length; }
+		inline bool empty() const { return _length == 0; }
+		inline const uint8_t* data() const { if (_length == 0) return nullptr; return _parent.data() + _offset; }
+		inline Bytes bytes() const { return {data(), _length}; }
+		inline std::string toHex(bool upper = false) const { return bytes().toHex(upper); }
+		inline BytesView view(size_t beginpos, size_t len) const { if (beginpos > _length) beginpos = _length; if (len > (_length - beginpos)) len = _length - beginpos; return {_parent, _offset + beginpos, len}; }
+		inline BytesView view(size_t beginpos) const { if (beginpos > _length) beginpos = _length; return {_parent, _offset + beginpos, _length - beginpos}; }
+
+	private:
+		Bytes _parent;
+		size_t _offset = 0;
+		size_t _length = 0;
+
+	};
+
+	inline void Bytes::append(const BytesView& view) {
+		append(view.data(), view.size());
+	}
+	inline BytesView Bytes::view(size_t beginpos, size_t len) const { return {*this, beginpos, len}; }
+	inline BytesView Bytes::view(size_t beginpos) const { return {*this, beginpos, size()}; }
+	inline BytesView Bytes::view_left(size_t len) const { return {*this, 0, len}; }
+	inline BytesView Bytes::view_right(size_t len) const { if (len > size()) len = size(); return {*this, size() - len, len}; }
+
 	// following array function doesn't work without size since it's passed as a pointer to the array so sizeof() is of the pointer
 	//inline Bytes bytesFromArray(const uint8_t arr[]) { return Bytes(arr, sizeof(arr)); }
 	//inline Bytes bytesFromChunk(const uint8_t* ptr, size_t len) { return Bytes(ptr, len); }
@@ -418,6 +570,11 @@ inline RNS::Bytes& operator << (RNS::Bytes& lhbytes, const RNS::Bytes& rhbytes)
 	return lhbytes;
 }
 
+inline RNS::Bytes& operator << (RNS::Bytes& lhbytes, const RNS::BytesView& rhview) {
+	lhbytes.append(rhview);
+	return lhbytes;
+}
+
 inline RNS::Bytes& operator << (RNS::Bytes& lhbytes, uint8_t rhbyte) {
 //MEM("Appending right-hand byte to left-hand Bytes");
 	lhbytes.append(rhbyte);
@@ -1,12 +1,349 @@
 #include "Channel.h"
+#include "ChannelData.h"
 
 #include "Reticulum.h"
 #include "Transport.h"
 #include "Packet.h"
 #include "Log.h"
+#include "Utilities/OS.h"
 
 #include <algorithm>
+#include <cmath>
 
 using namespace RNS;
 using namespace RNS::Type::Channel;
 using namespace RNS::Utilities;
+
+/*static*/ std::set<Channel> Channel::_channels;
+
+Channel::Channel(const Link& link) : _object(new ChannelData(link)) {
+	assert(_object);
+	ChannelData& d = *_object;
+	d._rtt = d._link.rtt();
+	if (d._rtt > RTT_SLOW) {
+		d._window = 1;
+		d._window_max = 1;
+		d._window_min = 1;
+		d._window_flexibility = 1;
+	}
+	_channels.insert(*this);
+	MEM("Channel object created");
+}
+
+void Channel::register_message_type(uint16_t msgtype, Callbacks::factory factory, bool is_system_type /*= false*/) {
+	assert(_object);
+	if (factory == nullptr) {
+		throw std::invalid_argument("Channel message type has no factory");
+	}
+	if (msgtype >= SMT_RESERVED && !is_system_type) {
+		throw std::invalid_argument("Channel message type is in the range reserved for system messages");
+	}
+	_object->_message_factories[msgtype] = factory;
+}
+
+void Channel::add_message_handler(Callbacks::message callback) {
+	assert(_object);
+	std::vector<Callbacks::message>& callbacks = _object->_message_callbacks;
+	if (std::find(callbacks.begin(), callbacks.end(), callback) == callbacks.end()) {
+		callbacks.push_back(callback);
+	}
+}
+
+void Channel::remove_message_handler(Callbacks::message callback) {
+	assert(_object);
+	std::vector<Callbacks::message>& callbacks = _object->_message_callbacks;
+	callbacks.erase(std::remove(callbacks.begin(), callbacks.end(), callback), callbacks.end());
+}
+
+bool Channel::is_ready_to_send() const {
+	if (!_object || !_object->_link || _object->_link.status() != Type::Link::ACTIVE) {
+		return false;
+	}
+	size_t pending = 0;
+	for (auto& envelope : _object->_tx_ring) {
+		const PacketReceipt& receipt = envelope._packet.receipt();
+		if (!receipt || receipt.status() != Type::PacketReceipt::DELIVERED) {
+			++pending;
+		}
+	}
+	return pending < _object->_window;
+}
+
+uint16_t Channel::mdu() const {
+	if (!_object || !_object->_link) {
+		return 0;
+	}
+	uint16_t link_mdu = _object->_link.get_mdu();
+	return (link_mdu > ENVELOPE_HEADER_SIZE) ? (link_mdu - ENVELOPE_HEADER_SIZE) : 0;
+}
+
+bool Channel::send(const MessageBase& message) {
+	assert(_object);
+	ChannelData& d = *_object;
+	if (!is_ready_to_send()) {
+		DEBUG("Channel::send: link not ready or window full");
+		return false;
+	}
+	const Bytes data = message.pack();
+	if (data.size() > mdu()) {
+		ERRORF("Channel::send: message of %u bytes exceeds the channel MDU of %u bytes", data.size(), mdu());
+		return false;
+	}
+
+	uint16_t msgtype = message.msgtype();
+	uint16_t sequence = d._next_sequence;
+	uint16_t length = (uint16_t)data.size();
+	const uint8_t header[ENVELOPE_HEADER_SIZE] = {
+		(uint8_t)(msgtype >> 8), (uint8_t)msgtype,
+		(uint8_t)(sequence >> 8), (uint8_t)sequence,
+		(uint8_t)(length >> 8), (uint8_t)length
+	};
+	Bytes raw(header, sizeof(header));
+	raw.append(data);
+	d._next_sequence = (uint16_t)((d._next_sequence + 1) % SEQ_MODULUS);
+
+	d._tx_ring.emplace_back(sequence, Packet(d._link, raw, Type::Packet::DATA, Type::Packet::CHANNEL));
+	ChannelData::Envelope& envelope = d._tx_ring.back();
+	try {
+		envelope.transmit();
+	}
+	catch (std::exception& e) {
+		// left in the ring, the watchdog retries it once its timeout is up
+		ERRORF("Channel::send: failed to send envelope, the contained exception was: %s", e.what());
+	}
+	envelope._timeout_at = envelope._sent_at + packet_timeout_time(envelope._tries);
+	update_packet_timeouts();
+	return true;
+}
+
+/*static*/ void Channel::watchdog_jobs() {
+	if (_channels.empty()) {
+		return;
+	}
+	// Copy since a channel exhausting its tries shuts down and removes itself from the set
+	std::set<Channel> channels(_channels);
+	for (auto& channel : channels) {
+		const_cast<Channel&>(channel).watchdog_job();
+	}
+}
+
+void Channel::watchdog_job() {
+	assert(_object);
+	ChannelData& d = *_object;
+	if (!d._link || d._link.status() == Type::Link::CLOSED) {
+		_shutdown();
+		return;
+	}
+	if (d._tx_ring.empty()) {
+		return;
+	}
+	// CBA Every proof that arrived since the last pass is handled here as one batch, the
+	// window moves per delivered envelope but the remaining timeouts are refreshed once
+	bool changed = false;
+	double now = OS::time();
+	for (auto iter = d._tx_ring.begin(); iter != d._tx_ring.end(); ) {
+		ChannelData::Envelope& envelope = *iter;
+		PacketReceipt receipt(envelope._packet.receipt());
+		if (receipt && receipt.status() == Type::PacketReceipt::DELIVERED) {
+			// A proof for a retransmitted envelope can't be matched to one try, so it is no RTT sample
+			double sample = (envelope._tries == 1) ? receipt.get_rtt() : 0.0;
+			iter = d._tx_ring.erase(iter);
+			delivered(sample);
+			changed = true;
+			continue;
+		}
+		if (now > envelope._timeout_at) {
+			if (envelope._tries >= d._max_tries) {
+				timed_out();
+				return;
+			}
+			try {
+				envelope.transmit();
+			}
+			catch (std::exception& e) {
+				ERRORF("Channel::watchdog_job: failed to resend envelope, the contained exception was: %s", e.what());
+			}
+			envelope._timeout_at = envelope._sent_at + packet_timeout_time(envelope._tries);
+			if (d._window > d._window_min) {
+				--d._window;
+				if (d._window_max > (d._window_min + d._window_flexibility)) {
+					--d._window_max;
+				}
+			}
+			changed = true;
+		}
+		++iter;
+	}
+	if (changed) {
+		update_packet_timeouts();
+	}
+}
+
+double Channel::packet_timeout_time(uint8_t tries) const {
+	assert(_object);
+	return std::pow(1.5, tries - 1) * std::max(_object->_rtt * 2.5, 0.025) * (_object->_tx_ring.size() + 1.5);
+}
+
+void Channel::update_packet_timeouts() {
+	assert(_object);
+	for (auto& envelope : _object->_tx_ring) {
+		double timeout_at = envelope._sent_at + packet_timeout_time(envelope._tries);
+		if (timeout_at > envelope._timeout_at) {
+			envelope._timeout_at = timeout_at;
+		}
+		// Keep the receipt alive at least as long so a late proof still gets matched
+		PacketReceipt receipt(envelope._packet.receipt());
+		if (receipt && receipt.status() == Type::PacketReceipt::SENT && receipt.timeout_at() < envelope._timeout_at) {
+			receipt.set_timeout((int16_t)std::ceil(envelope._timeout_at - envelope._sent_at) + 1);
+		}
+	}
+}
+
+void Channel::delivered(double rtt) {
+	assert(_object);
+	ChannelData& d = *_object;
+	if (rtt > 0.0) {
+		d._rtt = (d._rtt > 0.0) ? ((d._rtt * 7.0 + rtt) / 8.0) : rtt;
+	}
+	if (d._window < d._window_max) {
+		++d._window;
+		if ((d._window - d._window_min) > (d._window_flexibility - 1)) {
+			++d._window_min;
+		}
+	}
+	if (d._rtt == 0.0) {
+		return;
+	}
+	if (d._rtt > RTT_FAST) {
+		d._fast_rate_rounds = 0;
+		if (d._rtt > RTT_MEDIUM) {
+			d._medium_rate_rounds = 0;
+		}
+		else if (d._medium_rate_rounds < FAST_RATE_THRESHOLD) {
+			++d._medium_rate_rounds;
+			if (d._window_max < WINDOW_MAX_MEDIUM && d._medium_rate_rounds == FAST_RATE_THRESHOLD) {
+				d._window_max = WINDOW_MAX_MEDIUM;
+				d._window_min = WINDOW_MIN_LIMIT_MEDIUM;
+				TRACEF("Channel: window raised to %u for medium RTT link", d._window_max);
+			}
+		}
+	}
+	else if (d._fast_rate_rounds < FAST_RATE_THRESHOLD) {
+		++d._fast_rate_rounds;
+		if (d._window_max < WINDOW_MAX_FAST && d._fast_rate_rounds == FAST_RATE_THRESHOLD) {
+			d._window_max = WINDOW_MAX_FAST;
+			d._window_min = WINDOW_MIN_LIMIT_FAST;
+			TRACEF("Channel: window raised to %u for fast RTT link", d._window_max);
+		}
+	}
+}
+
+void Channel::timed_out() {
+	assert(_object);
+	Link link(_object->_link);
+	ERRORF("Channel: retry count exceeded on %s, tearing down link", link.toString().c_str());
+	_shutdown();
+	if (link) {
+		link.teardown();
+	}
+}
+
+void Channel::_receive(const Bytes& raw) {
+	assert(_object);
+	ChannelData& d = *_object;
+	if (raw.size() < ENVELOPE_HEADER_SIZE) {
+		DEBUG("Channel::_receive: envelope too short, dropped");
+		return;
+	}
+	uint16_t sequence = (uint16_t)((raw.data()[2] << 8) | raw.data()[3]);
+	// CBA Distance ahead of the next expected sequence, modulo the sequence space. Anything
+	// at or beyond the maximum window is a repeat of an envelope already delivered, its packet
+	// has been proven again by the link so the sender stops retransmitting it.
+	uint16_t ahead = (uint16_t)(sequence - d._next_rx_sequence);
+	if (ahead >= WINDOW_MAX) {
+		TRACEF("Channel::_receive: dropped envelope with sequence %u outside the window", sequence);
+		return;
+	}
+	if (ahead > 0) {
+		if (!d._rx_ring.emplace(sequence, raw).second) {
+			TRACEF("Channel::_receive: dropped duplicate envelope with sequence %u", sequence);
+		}
+		return;
+	}
+	d._next_rx_sequence = (uint16_t)((d._next_rx_sequence + 1) % SEQ_MODULUS);
+	deliver(raw);
+	// Hand over the envelopes that were waiting on this one
+	for (auto iter = d._rx_ring.find(d._next_rx_sequence); iter != d._rx_ring.end(); iter = d._rx_ring.find(d._next_rx_sequence)) {
+		const Bytes next((*iter).second);
+		d._rx_ring.erase(iter);
+		d._next_rx_sequence = (uint16_t)((d._next_rx_sequence + 1) % SEQ_MODULUS);
+		deliver(next);
+	}
+}
+
+void Channel::deliver(const Bytes& raw) {
+	assert(_object);
+	ChannelData& d = *_object;
+	uint16_t msgtype = (uint16_t)((raw.data()[0] << 8) | raw.data()[1]);
+	uint16_t length = (uint16_t)((raw.data()[4] << 8) | raw.data()[5]);
+	if (length > (raw.size() - ENVELOPE_HEADER_SIZE)) {
+		ERRORF("Channel: envelope with message type 0x%04x is truncated", msgtype);
+		return;
+	}
+	auto iter = d._message_factories.find(msgtype);
+	if (iter == d._message_factories.end()) {
+		ERRORF("Channel: received unregistered message type 0x%04x", msgtype);
+		return;
+	}
+	try {
+		MessageBase::Ptr message = (*iter).second();
+		message->unpack(raw.view(ENVELOPE_HEADER_SIZE, length));
+		// Copy, handlers may add or remove handlers
+		std::vector<Callbacks::message> callbacks(d._message_callbacks);
+		for (auto callback : callbacks) {
+			if (callback(*message)) {
+				break;
+			}
+		}
+	}
+	catch (std::exception& e) {
+		ERRORF("Channel: error while handling message type 0x%04x, the contained exception was: %s", msgtype, e.what());
+	}
+}
+
+void Channel::_shutdown() {
+	if (!_object) {
+		return;
+	}
+	ChannelData& d = *_object;
+	d._message_callbacks.clear();
+	d._tx_ring.clear();
+	d._rx_ring.clear();
+	d._link = {Type::NONE};
+	_channels.erase(*this);
+}
+
+uint8_t Channel::window() const {
+	assert(_object);
+	return _object->_window;
+}
+
+uint8_t Channel::window_max() const {
+	assert(_object);
+	return _object->_window_max;
+}
+
+uint8_t Channel::window_min() const {
+	assert(_object);
+	return _object->_window_min;
+}
+
+size_t Channel::outstanding() const {
+	assert(_object);
+	return _object->_tx_ring.size();
+}
+
+double Channel::rtt() const {
+	assert(_object);
+	return _object->_rtt;
+}
@@ -1,56 +1,125 @@
 #pragma once
 
-#include "Destination.h"
+#include "Bytes.h"
+#include "Log.h"
 #include "Type.h"
 
+#include <set>
 #include <memory>
 #include <cassert>
 
 namespace RNS {
 
+	class ChannelData;
+	class Link;
+
+	/*
+	Base class for messages sent over a ``Channel``. Every message class needs a
+	``MSGTYPE`` that is unique on the channel and below ``SMT_RESERVED``, a default
+	constructor, and must be registered on the receiving channel with
+	``Channel::register_message_type<T>()``.
+	*/
+	class MessageBase {
+
+	public:
+		using Ptr = std::shared_ptr<MessageBase>;
+
+	public:
+		virtual ~MessageBase() {}
+
+	public:
+		virtual uint16_t msgtype() const = 0;
+		virtual const Bytes pack() const = 0;
+		// CBA raw is a view into the decrypted packet, no copy is made before unpacking.
+		// Copy out (BytesView::bytes()) only what has to outlive the call.
+		virtual void unpack(const BytesView& raw) = 0;
+
+	};
+
+	/*
+	Reliable, ordered delivery of messages over a ``Link``.
+
+	Messages are wrapped in envelopes carrying a 16-bit sequence number and sent as
+	CHANNEL packets. Up to ``window`` envelopes are in flight at once, each is
+	retransmitted until its packet proof arrives. The window grows as messages are
+	delivered and shrinks on timeouts, its bounds follow the RTT measured from the
+	delivery proofs. Received envelopes are buffered until they can be handed to the
+	message handlers in sequence order.
+	*/
 	class Channel {
 
+	public:
+		class Callbacks {
+		public:
+			// CBA std::function apparently not implemented in NRF52 framework
+			// Return true if the message was handled, later handlers are skipped
+			using message = bool(*)(const MessageBase& message);
+			using factory = MessageBase::Ptr(*)();
+		};
+
 	public:
 		Channel(Type::NoneConstructor none) {
 			MEM("Channel NONE object created");
 		}
-		Channel(const Channel& resource) : _object(resource._object) {
+		Channel(const Channel& channel) : _object(channel._object) {
 			MEM("Channel object copy created");
 		}
+		Channel(const Link& link);
 		virtual ~Channel(){
 			MEM("Channel object destroyed");
 		}
 
-		Channel& operator = (const Channel& resource) {
-			_object = resource._object;
+		Channel& operator = (const Channel& channel) {
+			_object = channel._object;
 			return *this;
 		}
 		operator bool() const {
 			return _object.get() != nullptr;
 		}
-		bool operator < (const Channel& resource) const {
-			return _object.get() < resource._object.get();
-			//return _object->_hash < resource._object->_hash;
+		bool operator < (const Channel& channel) const {
+			return _object.get() < channel._object.get();
 		}
 
 	public:
-		void _shutdown() {}
+		template<class T>
+		inline void register_message_type() {
+			register_message_type(T::MSGTYPE, []() -> MessageBase::Ptr { return MessageBase::Ptr(new T()); }, false);
+		}
+		void register_message_type(uint16_t msgtype, Callbacks::factory factory, bool is_system_type = false);
+		void add_message_handler(Callbacks::message callback);
+		void remove_message_handler(Callbacks::message callback);
+		bool is_ready_to_send() const;
+		// Returns false if the window is full or the message doesn't fit in an envelope
+		bool send(const MessageBase& message);
+		// Largest message payload that fits in one envelope
+		uint16_t mdu() const;
 
-	private:
-		class Object {
-		public:
-			Object() { MEM("Channel::Data object created, this: " + std::to_string((uintptr_t)this)); }
-			virtual ~Object() { MEM("Channel::Data object destroyed, this: " + std::to_string((uintptr_t)this)); }
-		private:
+		// CBA Runs the transmit bookkeeping of every open channel, called from Transport::loop()
+		static void watchdog_jobs();
 
-		friend class Channel;
-		};
-		std::shared_ptr<Object> _object;
+		void _receive(const Bytes& raw);
+		void _shutdown();
 
-	};
+		// getters
+		uint8_t window() const;
+		uint8_t window_max() const;
+		uint8_t window_min() const;
+		size_t outstanding() const;
+		double rtt() const;
 
+	private:
+		void watchdog_job();
+		double packet_timeout_time(uint8_t tries) const;
+		void update_packet_timeouts();
+		void delivered(double rtt);
+		void timed_out();
+		void deliver(const Bytes& raw);
+
+	private:
+		static std::set<Channel> _channels;
 
-	class ChannelAdvertisement {
+	protected:
+		std::shared_ptr<ChannelData> _object;
 
 	};
 
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Channel.h"
+
+#include "Link.h"
+#include "Packet.h"
+#include "Bytes.h"
+#include "Type.h"
+#include "Utilities/OS.h"
+
+#include <list>
+#include <map>
+#include <vector>
+
+namespace RNS {
+
+	class ChannelData {
+	public:
+		// Sent message awaiting its delivery proof
+		class Envelope {
+		public:
+			Envelope(uint16_t sequence, const Packet& packet) : _sequence(sequence), _packet(packet) {}
+			// Sends the packet or, once sent, resends it with fresh ciphertext and a new receipt
+			inline void transmit() {
+				// counted up front so a failing send still uses up a try
+				++_tries;
+				_sent_at = Utilities::OS::time();
+				if (_packet.sent()) {
+					_packet.resend();
+				}
+				else {
+					_packet.send();
+				}
+			}
+			uint16_t _sequence = 0;
+			Packet _packet = {Type::NONE};
+			uint8_t _tries = 0;
+			double _sent_at = 0.0;
+			double _timeout_at = 0.0;
+		};
+	public:
+		ChannelData(const Link& link) : _link(link) {}
+		virtual ~ChannelData() {}
+	private:
+		// CBA Released by _shutdown() so the link isn't kept alive by its own channel
+		Link _link;
+		// Envelopes in sequence order
+		std::list<Envelope> _tx_ring;
+		// Envelopes received ahead of _next_rx_sequence, keyed by sequence
+		std::map<uint16_t, Bytes> _rx_ring;
+		std::map<uint16_t, Channel::Callbacks::factory> _message_factories;
+		std::vector<Channel::Callbacks::message> _message_callbacks;
+		uint16_t _next_sequence = 0;
+		uint16_t _next_rx_sequence = 0;
+		uint8_t _max_tries = Type::Channel::MAX_TRIES;
+		uint8_t _window = Type::Channel::WINDOW;
+		uint8_t _window_max = Type::Channel::WINDOW_MAX_SLOW;
+		uint8_t _window_min = Type::Channel::WINDOW_MIN;
+		uint8_t _window_flexibility = Type::Channel::WINDOW_FLEXIBILITY;
+		uint8_t _fast_rate_rounds = 0;
+		uint8_t _medium_rate_rounds = 0;
+		// Smoothed RTT from delivery proofs, starts out as the link RTT
+		double _rtt = 0.0;
+
+	friend class Channel;
+	};
+
+}
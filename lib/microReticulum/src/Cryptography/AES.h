@@ -1,48 +1,91 @@
 #pragma once
 
+#include "Backend.h"
 #include "CBC.h"
 
 #include "../Bytes.h"
 
 #include <AES.h>
 
+#ifdef RNS_CRYPTO_BACKEND_HW
+#include <mbedtls/aes.h>
+#include <stdexcept>
+#include <string.h>
+#endif
+
 namespace RNS { namespace Cryptography {
 
+	// CBA Single CBC entry point for both key sizes so the backend is selected in one place.
+	// Output may alias input for the in-place variants.
+	template <typename T>
+	inline void aes_cbc(bool encrypt, const Bytes& key, const uint8_t* iv, size_t iv_size, uint8_t* output, const uint8_t* input, size_t len) {
+#ifdef RNS_CRYPTO_BACKEND_HW
+		// mbedTLS drives the AES peripheral on ESP32 and advances the iv it is given
+		uint8_t iv_copy[16] = {0};
+		memcpy(iv_copy, iv, (iv_size < sizeof(iv_copy)) ? iv_size : sizeof(iv_copy));
+		mbedtls_aes_context aes;
+		mbedtls_aes_init(&aes);
+		int ret;
+		if (encrypt) {
+			ret = mbedtls_aes_setkey_enc(&aes, key.data(), key.size() * 8);
+		}
+		else {
+			ret = mbedtls_aes_setkey_dec(&aes, key.data(), key.size() * 8);
+		}
+		if (ret == 0) {
+			ret = mbedtls_aes_crypt_cbc(&aes, encrypt ? MBEDTLS_AES_ENCRYPT : MBEDTLS_AES_DECRYPT, len, iv_copy, input, output);
+		}
+		mbedtls_aes_free(&aes);
+		if (ret != 0) {
+			throw std::runtime_error("AES-CBC operation failed with mbedTLS error " + std::to_string(ret));
+		}
+#else
+#ifdef RNS_CRYPTO_BACKEND_CC310
+		// the CryptoCell only has AES-128, AES-256 stays in software
+		if (key.size() == 16 && CryptoCell::aes128_cbc(encrypt, key.data(), iv, iv_size, output, input, len)) {
+			return;
+		}
+#endif
+		CBC<T> cbc;
+		cbc.setKey(key.data(), key.size());
+		cbc.setIV(iv, iv_size);
+		if (encrypt) {
+			cbc.encrypt(output, input, len);
+		}
+		else {
+			cbc.decrypt(output, input, len);
+		}
+#endif
+	}
+
+	template <typename T>
+	inline void aes_cbc(bool encrypt, const Bytes& key, const Bytes& iv, uint8_t* output, const uint8_t* input, size_t len) {
+		aes_cbc<T>(encrypt, key, iv.data(), iv.size(), output, input, len);
+	}
+
 	class AES_128_CBC {
 
 	public:
 		static inline const Bytes encrypt(const Bytes& plaintext, const Bytes& key, const Bytes& iv) {
-			CBC<AES128> cbc;
-			cbc.setKey(key.data(), key.size());
-			cbc.setIV(iv.data(), iv.size());
 			Bytes ciphertext;
-			cbc.encrypt(ciphertext.writable(plaintext.size()), plaintext.data(), plaintext.size());
+			aes_cbc<AES128>(true, key, iv, ciphertext.writable(plaintext.size()), plaintext.data(), plaintext.size());
 			return ciphertext;
 		}
 
 		static inline const Bytes decrypt(const Bytes& ciphertext, const Bytes& key, const Bytes& iv) {
-			CBC<AES128> cbc;
-			cbc.setKey(key.data(), key.size());
-			cbc.setIV(iv.data(), iv.size());
 			Bytes plaintext;
-			cbc.decrypt(plaintext.writable(ciphertext.size()), ciphertext.data(), ciphertext.size());
+			aes_cbc<AES128>(false, key, iv, plaintext.writable(ciphertext.size()), ciphertext.data(), ciphertext.size());
 			return plaintext;
 		}
 
 		// EXPERIMENTAL - overwrites passed buffer
 		static inline void inplace_encrypt(Bytes& plaintext, const Bytes& key, const Bytes& iv) {
-			CBC<AES128> cbc;
-			cbc.setKey(key.data(), key.size());
-			cbc.setIV(iv.data(), iv.size());
-			cbc.encrypt((uint8_t*)plaintext.data(), plaintext.data(), plaintext.size());
+			aes_cbc<AES128>(true, key, iv, (uint8_t*)plaintext.data(), plaintext.data(), plaintext.size());
 		}
 
 		// EXPERIMENTAL - overwrites passed buffer
 		static inline void inplace_decrypt(Bytes& ciphertext, const Bytes& key, const Bytes& iv) {
-			CBC<AES128> cbc;
-			cbc.setKey(key.data(), key.size());
-			cbc.setIV(iv.data(), iv.size());
-			cbc.decrypt((uint8_t*)ciphertext.data(), ciphertext.data(), ciphertext.size());
+			aes_cbc<AES128>(false, key, iv, (uint8_t*)ciphertext.data(), ciphertext.data(), ciphertext.size());
 		}
 
 	};
@@ -51,37 +94,25 @@ namespace RNS { namespace Cryptography {
 
 	public:
 		static inline const Bytes encrypt(const Bytes& plaintext, const Bytes& key, const Bytes& iv) {
-			CBC<AES256> cbc;
-			cbc.setKey(key.data(), key.size());
-			cbc.setIV(iv.data(), iv.size());
 			Bytes ciphertext;
-			cbc.encrypt(ciphertext.writable(plaintext.size()), plaintext.data(), plaintext.size());
+			aes_cbc<AES256>(true, key, iv, ciphertext.writable(plaintext.size()), plaintext.data(), plaintext.size());
 			return ciphertext;
 		}
 
 		static inline const Bytes decrypt(const Bytes& ciphertext, const Bytes& key, const Bytes& iv) {
-			CBC<AES256> cbc;
-			cbc.setKey(key.data(), key.size());
-			cbc.setIV(iv.data(), iv.size());
 			Bytes plaintext;
-			cbc.decrypt(plaintext.writable(ciphertext.size()), ciphertext.data(), ciphertext.size());
+			aes_cbc<AES256>(false, key, iv, plaintext.writable(ciphertext.size()), ciphertext.data(), ciphertext.size());
 			return plaintext;
 		}
 
 		// EXPERIMENTAL - overwrites passed buffer
 		static inline void inplace_encrypt(Bytes& plaintext, const Bytes& key, const Bytes& iv) {
-			CBC<AES256> cbc;
-			cbc.setKey(key.data(), key.size());
-			cbc.setIV(iv.data(), iv.size());
-			cbc.encrypt((uint8_t*)plaintext.data(), plaintext.data(), plaintext.size());
+			aes_cbc<AES256>(true, key, iv, (uint8_t*)plaintext.data(), plaintext.data(), plaintext.size());
 		}
 
 		// EXPERIMENTAL - overwrites passed buffer
 		static inline void inplace_decrypt(Bytes& ciphertext, const Bytes& key, const Bytes& iv) {
-			CBC<AES256> cbc;
-			cbc.setKey(key.data(), key.size());
-			cbc.setIV(iv.data(), iv.size());
-			cbc.decrypt((uint8_t*)ciphertext.data(), ciphertext.data(), ciphertext.size());
+			aes_cbc<AES256>(false, key, iv, (uint8_t*)ciphertext.data(), ciphertext.data(), ciphertext.size());
 		}
 
 	};
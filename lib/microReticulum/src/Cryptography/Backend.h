@@ -0,0 +1,47 @@
+#pragma once
+
+// CBA Compile-time crypto backend selection.
+//
+// Define RNS_CRYPTO_HW to route SHA-256/SHA-512 (and thereby HMAC and HKDF) and AES-CBC
+// through mbedTLS, which on ESP32 targets drives the on-chip SHA and AES peripherals.
+// On the nRF52840 the same flag selects the CryptoCell-310 (CryptoCell.h) for SHA-256,
+// AES-128-CBC, Ed25519 and X25519. On platforms without either engine the flag is ignored
+// and the software Crypto library is used as before.
+#if defined(RNS_CRYPTO_HW) && defined(ESP32)
+#define RNS_CRYPTO_BACKEND_HW 1
+#elif defined(RNS_CRYPTO_HW) && defined(NRF52840_XXAA)
+#define RNS_CRYPTO_BACKEND_CC310 1
+#endif
+
+// Define RNS_CRYPTO_FAST25519 to run Ed25519 and X25519 on Fast25519 (precomputed base point
+// tables, sliding window verification) rather than the Crypto library's generic field
+// arithmetic. Neither target has a curve engine, so this applies to all of them.
+#if defined(RNS_CRYPTO_FAST25519)
+#define RNS_CRYPTO_BACKEND_FAST25519 1
+#endif
+
+#ifdef RNS_CRYPTO_BACKEND_HW
+#include "HardwareSHA.h"
+#elif defined(RNS_CRYPTO_BACKEND_CC310)
+#include "CryptoCell.h"
+#include <SHA512.h>
+#else
+#include <SHA256.h>
+#include <SHA512.h>
+#endif
+
+namespace RNS { namespace Cryptography {
+
+#ifdef RNS_CRYPTO_BACKEND_HW
+	using SHA256Engine = HardwareSHA256;
+	using SHA512Engine = HardwareSHA512;
+#elif defined(RNS_CRYPTO_BACKEND_CC310)
+	// no SHA-512 on the cell
+	using SHA256Engine = CryptoCellSHA256;
+	using SHA512Engine = ::SHA512;
+#else
+	using SHA256Engine = ::SHA256;
+	using SHA512Engine = ::SHA512;
+#endif
+
+} }
@@ -0,0 +1,278 @@
+#include "Backend.h"
+
+#ifdef RNS_CRYPTO_BACKEND_CC310
+
+#include <Crypto.h>
+#include <nrf.h>
+
+#include "nrf_cc310/include/ssi_aes.h"
+#include "nrf_cc310/include/crys_ec_edw_api.h"
+#include "nrf_cc310/include/crys_ec_mont_api.h"
+
+#include <stdexcept>
+#include <string.h>
+
+using namespace RNS::Cryptography;
+
+namespace {
+
+	// nRF52840 data RAM, the only memory the cell's DMA can read
+	const uintptr_t RAM_START = 0x20000000;
+	const uintptr_t RAM_END   = 0x20040000;
+	// longest single AES operation handed to the cell
+	const size_t AES_MAXSIZE  = 0xfff0;
+
+	bool library_ready = false;
+	uint8_t session_depth = 0;
+
+	CRYS_ECEDW_TempBuff_t edw_temp;
+	CRYS_ECMONT_TempBuff_t mont_temp;
+
+}
+
+// ─── Session ─────────────────────────────────────────────────────────────────
+CryptoCellSession::CryptoCellSession() {
+	if (!library_ready) {
+		// enables the cell and initialises the runtime library once
+		nRFCrypto.begin();
+		library_ready = true;
+	}
+	if (session_depth++ == 0) {
+		NRF_CRYPTOCELL->ENABLE = 1;
+	}
+}
+
+CryptoCellSession::~CryptoCellSession() {
+	if (--session_depth == 0) {
+		NRF_CRYPTOCELL->ENABLE = 0;
+	}
+}
+
+/*static*/ bool CryptoCell::in_ram(const void* data, size_t len) {
+	uintptr_t start = (uintptr_t)data;
+	return start >= RAM_START && start <= RAM_END && len <= RAM_END - start;
+}
+
+// ─── SHA-256 ─────────────────────────────────────────────────────────────────
+CryptoCellSHA256::CryptoCellSHA256() {
+	reset();
+}
+
+CryptoCellSHA256::~CryptoCellSHA256() {
+}
+
+void CryptoCellSHA256::reset() {
+	CryptoCellSession session;
+	_hash.begin(CRYS_HASH_SHA256_mode);
+}
+
+void CryptoCellSHA256::update(const void* data, size_t len) {
+	if (len == 0) {
+		return;
+	}
+	CryptoCellSession session;
+	if (CryptoCell::in_ram(data, len)) {
+		_hash.update((uint8_t*)data, len);
+		return;
+	}
+	// staged through RAM for the DMA
+	uint8_t chunk[64];
+	const uint8_t* input = (const uint8_t*)data;
+	while (len > 0) {
+		size_t size = (len < sizeof(chunk)) ? len : sizeof(chunk);
+		memcpy(chunk, input, size);
+		_hash.update(chunk, size);
+		input += size;
+		len -= size;
+	}
+	clean(chunk);
+}
+
+void CryptoCellSHA256::finalize(void* hash, size_t len) {
+	// sized for the runtime's result buffer, the digest is the first 32 bytes
+	uint8_t temp[64];
+	{
+		CryptoCellSession session;
+		_hash.end(temp);
+	}
+	memcpy(hash, temp, (len < 32) ? len : 32);
+	clean(temp);
+}
+
+void CryptoCellSHA256::clear() {
+	reset();
+}
+
+void CryptoCellSHA256::resetHMAC(const void* key, size_t keyLen) {
+	uint8_t block[64];
+	formatHMACKey(block, key, keyLen, 0x36);
+	reset();
+	update(block, sizeof(block));
+	clean(block);
+}
+
+void CryptoCellSHA256::finalizeHMAC(const void* key, size_t keyLen, void* hash, size_t hashLen) {
+	uint8_t temp[32];
+	uint8_t block[64];
+	finalize(temp, sizeof(temp));
+	formatHMACKey(block, key, keyLen, 0x5C);
+	reset();
+	update(block, sizeof(block));
+	update(temp, sizeof(temp));
+	finalize(hash, hashLen);
+	clean(block);
+	clean(temp);
+}
+
+// ─── AES-128-CBC ─────────────────────────────────────────────────────────────
+/*static*/ bool CryptoCell::aes128_cbc(bool encrypt, const uint8_t* key, const uint8_t* iv, size_t iv_size, uint8_t* output, const uint8_t* input, size_t len) {
+	if (len == 0 || (len % 16) != 0 || len > AES_MAXSIZE || !in_ram(input, len) || !in_ram(output, len)) {
+		return false;
+	}
+	uint8_t key_copy[16];
+	memcpy(key_copy, key, sizeof(key_copy));
+	SaSiAesIv_t iv_copy = {0};
+	memcpy(iv_copy, iv, (iv_size < sizeof(iv_copy)) ? iv_size : sizeof(iv_copy));
+	SaSiAesUserKeyData_t key_data;
+	key_data.pKey = key_copy;
+	key_data.keySize = sizeof(key_copy);
+
+	SaSiAesUserContext_t context;
+	size_t output_size = len;
+	SaSiError_t ret;
+	{
+		CryptoCellSession session;
+		// the cell streams block by block, so output may alias input
+		ret = SaSi_AesInit(&context, encrypt ? SASI_AES_ENCRYPT : SASI_AES_DECRYPT, SASI_AES_MODE_CBC, SASI_AES_PADDING_NONE);
+		if (ret == SASI_OK) {
+			ret = SaSi_AesSetKey(&context, SASI_AES_USER_KEY, &key_data, sizeof(key_data));
+		}
+		if (ret == SASI_OK) {
+			ret = SaSi_AesSetIv(&context, iv_copy);
+		}
+		if (ret == SASI_OK) {
+			ret = SaSi_AesFinish(&context, len, (uint8_t*)input, len, output, &output_size);
+		}
+		SaSi_AesFree(&context);
+	}
+	clean(key_copy);
+	if (ret != SASI_OK) {
+		throw std::runtime_error("AES-CBC operation failed with CryptoCell error " + std::to_string(ret));
+	}
+	return true;
+}
+
+// ─── Ed25519 ─────────────────────────────────────────────────────────────────
+/*static*/ bool CryptoCell::ed25519_public_key(uint8_t public_key[32], const uint8_t private_key[32]) {
+	uint8_t seed[32];
+	uint8_t secret[64];
+	uint8_t pub[32];
+	size_t secret_size = sizeof(secret);
+	size_t pub_size = sizeof(pub);
+	memcpy(seed, private_key, sizeof(seed));
+	CRYSError_t ret;
+	{
+		CryptoCellSession session;
+		ret = CRYS_ECEDW_SeedKeyPair(seed, sizeof(seed), secret, &secret_size, pub, &pub_size, &edw_temp);
+	}
+	clean(seed);
+	clean(secret);
+	if (ret != CRYS_OK) {
+		throw std::runtime_error("Ed25519 key derivation failed with CryptoCell error " + std::to_string(ret));
+	}
+	memcpy(public_key, pub, sizeof(pub));
+	return true;
+}
+
+/*static*/ bool CryptoCell::ed25519_sign(uint8_t signature[64], const uint8_t private_key[32], const uint8_t public_key[32], const void* message, size_t len) {
+	uint8_t empty = 0;
+	if (len == 0) {
+		message = &empty;
+	}
+	if (!in_ram(message, len)) {
+		return false;
+	}
+	// the runtime takes the secret key as seed || public key
+	uint8_t secret[64];
+	uint8_t sig[64];
+	size_t sig_size = sizeof(sig);
+	memcpy(secret, private_key, 32);
+	memcpy(secret + 32, public_key, 32);
+	CRYSError_t ret;
+	{
+		CryptoCellSession session;
+		ret = CRYS_ECEDW_Sign(sig, &sig_size, (const uint8_t*)message, len, secret, sizeof(secret), &edw_temp);
+	}
+	clean(secret);
+	if (ret != CRYS_OK) {
+		throw std::runtime_error("Ed25519 signing failed with CryptoCell error " + std::to_string(ret));
+	}
+	memcpy(signature, sig, sizeof(sig));
+	return true;
+}
+
+/*static*/ bool CryptoCell::ed25519_verify(const uint8_t signature[64], const uint8_t public_key[32], const void* message, size_t len, bool& valid) {
+	uint8_t empty = 0;
+	if (len == 0) {
+		message = &empty;
+	}
+	if (!in_ram(message, len)) {
+		return false;
+	}
+	uint8_t sig[64];
+	uint8_t pub[32];
+	memcpy(sig, signature, sizeof(sig));
+	memcpy(pub, public_key, sizeof(pub));
+	CRYSError_t ret;
+	{
+		CryptoCellSession session;
+		ret = CRYS_ECEDW_Verify(sig, sizeof(sig), pub, sizeof(pub), (uint8_t*)message, len, &edw_temp);
+	}
+	valid = (ret == CRYS_OK);
+	return true;
+}
+
+// ─── X25519 ──────────────────────────────────────────────────────────────────
+/*static*/ bool CryptoCell::x25519_public_key(uint8_t public_key[32], const uint8_t private_key[32]) {
+	uint8_t scalar[32];
+	uint8_t pub[32];
+	size_t pub_size = sizeof(pub);
+	memcpy(scalar, private_key, sizeof(scalar));
+	CRYSError_t ret;
+	{
+		CryptoCellSession session;
+		ret = CRYS_ECMONT_ScalarmultBase(pub, &pub_size, scalar, sizeof(scalar), &mont_temp);
+	}
+	clean(scalar);
+	if (ret != CRYS_OK) {
+		throw std::runtime_error("X25519 key derivation failed with CryptoCell error " + std::to_string(ret));
+	}
+	memcpy(public_key, pub, sizeof(pub));
+	return true;
+}
+
+/*static*/ bool CryptoCell::x25519(uint8_t shared_key[32], const uint8_t private_key[32], const uint8_t peer_key[32]) {
+	uint8_t scalar[32];
+	uint8_t peer[32];
+	uint8_t shared[32];
+	size_t shared_size = sizeof(shared);
+	memcpy(scalar, private_key, sizeof(scalar));
+	memcpy(peer, peer_key, sizeof(peer));
+	// RFC 7748 ignores the top bit of u
+	peer[31] &= 0x7f;
+	CRYSError_t ret;
+	{
+		CryptoCellSession session;
+		ret = CRYS_ECMONT_Scalarmult(shared, &shared_size, scalar, sizeof(scalar), peer, sizeof(peer), &mont_temp);
+	}
+	clean(scalar);
+	if (ret != CRYS_OK) {
+		// reported to the caller as an invalid peer key
+		memset(shared, 0, sizeof(shared));
+	}
+	memcpy(shared_key, shared, sizeof(shared));
+	clean(shared);
+	return true;
+}
+
+#endif
@@ -0,0 +1,79 @@
+#pragma once
+
+// included through Backend.h, which decides whether the CryptoCell backend is in use
+#ifdef RNS_CRYPTO_BACKEND_CC310
+
+#include <Hash.h>
+#include <Adafruit_nRFCrypto.h>
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace RNS { namespace Cryptography {
+
+	// CBA Backend for the CryptoCell-310 of the nRF52840, through the nrf_cc310 runtime that
+	// ships with Adafruit_nRFCrypto.
+	//
+	// The cell accelerates SHA-256 (and thereby HMAC and HKDF), AES-128 and the Ed25519 and
+	// X25519 curve operations. It has no SHA-512 and no AES-256, those stay in software. The
+	// cell is powered only for the duration of each operation, as Nordic's nrf_crypto does,
+	// and reads its input by DMA, so buffers outside RAM (constants in flash) are either
+	// copied first or left to the software path.
+	//
+	// Everything runs on the one task that drives Reticulum; the scratch buffers the curve
+	// operations need are static.
+
+	// Keeps the cell enabled while in scope, nests
+	class CryptoCellSession {
+
+	public:
+		CryptoCellSession();
+		~CryptoCellSession();
+
+	};
+
+	class CryptoCellSHA256 : public Hash {
+
+	public:
+		CryptoCellSHA256();
+		virtual ~CryptoCellSHA256();
+
+		size_t hashSize() const { return 32; }
+		size_t blockSize() const { return 64; }
+
+		void reset();
+		void update(const void* data, size_t len);
+		void finalize(void* hash, size_t len);
+
+		void clear();
+
+		void resetHMAC(const void* key, size_t keyLen);
+		void finalizeHMAC(const void* key, size_t keyLen, void* hash, size_t hashLen);
+
+	private:
+		nRFCrypto_Hash _hash;
+
+	};
+
+	// Each returns false when the operation was not run on the cell (buffer outside RAM,
+	// cell error), the caller then falls back to software
+	class CryptoCell {
+
+	public:
+		static bool aes128_cbc(bool encrypt, const uint8_t* key, const uint8_t* iv, size_t iv_size, uint8_t* output, const uint8_t* input, size_t len);
+
+		static bool ed25519_public_key(uint8_t public_key[32], const uint8_t private_key[32]);
+		static bool ed25519_sign(uint8_t signature[64], const uint8_t private_key[32], const uint8_t public_key[32], const void* message, size_t len);
+		// valid is the verification result when true is returned
+		static bool ed25519_verify(const uint8_t signature[64], const uint8_t public_key[32], const void* message, size_t len, bool& valid);
+
+		static bool x25519_public_key(uint8_t public_key[32], const uint8_t private_key[32]);
+		static bool x25519(uint8_t shared_key[32], const uint8_t private_key[32], const uint8_t peer_key[32]);
+
+		static bool in_ram(const void* data, size_t len);
+
+	};
+
+} }
+
+#endif
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Bytes.h"
+#include "Backend.h"
+#include "Fast25519.h"
 
 #include <Ed25519.h>
 
@@ -14,6 +16,41 @@ Note that the library currently in use for Ed25519 does not support generating k
 
 namespace RNS { namespace Cryptography {
 
+	// CBA Raw entry points, on the backend selected in Backend.h
+	inline void ed25519_derive_public_key(uint8_t* public_key, const uint8_t* private_key) {
+#ifdef RNS_CRYPTO_BACKEND_CC310
+		if (CryptoCell::ed25519_public_key(public_key, private_key)) return;
+#endif
+#ifdef RNS_CRYPTO_BACKEND_FAST25519
+		Fast25519::ed25519_public_key(public_key, private_key);
+#else
+		::Ed25519::derivePublicKey(public_key, private_key);
+#endif
+	}
+
+	inline void ed25519_sign(uint8_t* signature, const uint8_t* private_key, const uint8_t* public_key, const void* message, size_t len) {
+#ifdef RNS_CRYPTO_BACKEND_CC310
+		if (CryptoCell::ed25519_sign(signature, private_key, public_key, message, len)) return;
+#endif
+#ifdef RNS_CRYPTO_BACKEND_FAST25519
+		Fast25519::ed25519_sign(signature, private_key, public_key, message, len);
+#else
+		::Ed25519::sign(signature, private_key, public_key, message, len);
+#endif
+	}
+
+	inline bool ed25519_verify(const uint8_t* signature, const uint8_t* public_key, const void* message, size_t len) {
+#ifdef RNS_CRYPTO_BACKEND_CC310
+		bool valid;
+		if (CryptoCell::ed25519_verify(signature, public_key, message, len, valid)) return valid;
+#endif
+#ifdef RNS_CRYPTO_BACKEND_FAST25519
+		return Fast25519::ed25519_verify(signature, public_key, message, len);
+#else
+		return ::Ed25519::verify(signature, public_key, message, len);
+#endif
+	}
+
 	class Ed25519PublicKey {
 
 	public:
@@ -36,7 +73,7 @@ namespace RNS { namespace Cryptography {
 		}
 
 		inline bool verify(const Bytes& signature, const Bytes& message) {
-			return Ed25519::verify(signature.data(), _publicKey.data(), message.data(), message.size());
+			return ed25519_verify(signature.data(), _publicKey.data(), message.data(), message.size());
 		}
 
 	private:
@@ -60,7 +97,7 @@ namespace RNS { namespace Cryptography {
 				Ed25519::generatePrivateKey(_privateKey.writable(32));
 			}
 			// derive public key from private key
-			Ed25519::derivePublicKey(_publicKey.writable(32), _privateKey.data());
+			ed25519_derive_public_key(_publicKey.writable(32), _privateKey.data());
 		}
 		~Ed25519PrivateKey() {}
 
@@ -89,7 +126,7 @@ namespace RNS { namespace Cryptography {
 		inline const Bytes sign(const Bytes& message) {
 			//z return _sk.sign(message);
 			Bytes signature;
-			Ed25519::sign(signature.writable(64), _privateKey.data(), _publicKey.data(), message.data(), message.size());
+			ed25519_sign(signature.writable(64), _privateKey.data(), _publicKey.data(), message.data(), message.size());
 			return signature;
 		}
 
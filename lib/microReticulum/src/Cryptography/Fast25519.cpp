@@ -0,0 +1,830 @@
+#include "Fast25519.h"
+#include "Fast25519Tables.h"
+#include "Backend.h"
+
+#include <Crypto.h>
+
+#include <string.h>
+
+using namespace RNS::Cryptography;
+
+namespace {
+
+	// ─── Field arithmetic mod 2^255 - 19 ────────────────────────────────────────
+	// h = h0 + 2^26 h1 + 2^51 h2 + 2^77 h3 + ... + 2^230 h9, the limbs are signed and
+	// unreduced between operations; see ref10 for the bounds each operation expects.
+	typedef int32_t fe[10];
+
+	inline int64_t mul(int32_t a, int32_t b) {
+		// a single widening multiply on 32 bit targets
+		return (int64_t)a * (int64_t)b;
+	}
+
+	inline int64_t carry_out(int64_t& h, int bits) {
+		int64_t c = (h + ((int64_t)1 << (bits - 1))) >> bits;
+		h -= c * ((int64_t)1 << bits);
+		return c;
+	}
+
+	void fe_carry(fe out, int64_t* h) {
+		h[1] += carry_out(h[0], 26);
+		h[5] += carry_out(h[4], 26);
+		h[2] += carry_out(h[1], 25);
+		h[6] += carry_out(h[5], 25);
+		h[3] += carry_out(h[2], 26);
+		h[7] += carry_out(h[6], 26);
+		h[4] += carry_out(h[3], 25);
+		h[8] += carry_out(h[7], 25);
+		h[5] += carry_out(h[4], 26);
+		h[9] += carry_out(h[8], 26);
+		h[0] += carry_out(h[9], 25) * 19;
+		h[1] += carry_out(h[0], 26);
+		for (int i = 0; i < 10; i++) {
+			out[i] = (int32_t)h[i];
+		}
+	}
+
+	inline void fe_0(fe h) {
+		memset(h, 0, sizeof(fe));
+	}
+
+	inline void fe_1(fe h) {
+		fe_0(h);
+		h[0] = 1;
+	}
+
+	inline void fe_copy(fe h, const fe f) {
+		memcpy(h, f, sizeof(fe));
+	}
+
+	inline void fe_add(fe h, const fe f, const fe g) {
+		for (int i = 0; i < 10; i++) {
+			h[i] = f[i] + g[i];
+		}
+	}
+
+	inline void fe_sub(fe h, const fe f, const fe g) {
+		for (int i = 0; i < 10; i++) {
+			h[i] = f[i] - g[i];
+		}
+	}
+
+	inline void fe_neg(fe h, const fe f) {
+		for (int i = 0; i < 10; i++) {
+			h[i] = -f[i];
+		}
+	}
+
+	// h = g if b == 1, unchanged if b == 0, in constant time
+	inline void fe_cmov(fe h, const fe g, uint32_t b) {
+		int32_t mask = -(int32_t)b;
+		for (int i = 0; i < 10; i++) {
+			h[i] ^= mask & (h[i] ^ g[i]);
+		}
+	}
+
+	inline void fe_cswap(fe f, fe g, uint32_t b) {
+		int32_t mask = -(int32_t)b;
+		for (int i = 0; i < 10; i++) {
+			int32_t x = mask & (f[i] ^ g[i]);
+			f[i] ^= x;
+			g[i] ^= x;
+		}
+	}
+
+	void fe_mul(fe h, const fe f, const fe g) {
+		int32_t f0 = f[0], f1 = f[1], f2 = f[2], f3 = f[3], f4 = f[4];
+		int32_t f5 = f[5], f6 = f[6], f7 = f[7], f8 = f[8], f9 = f[9];
+		int32_t g0 = g[0], g1 = g[1], g2 = g[2], g3 = g[3], g4 = g[4];
+		int32_t g5 = g[5], g6 = g[6], g7 = g[7], g8 = g[8], g9 = g[9];
+		int32_t g1_19 = 19 * g1, g2_19 = 19 * g2, g3_19 = 19 * g3, g4_19 = 19 * g4, g5_19 = 19 * g5;
+		int32_t g6_19 = 19 * g6, g7_19 = 19 * g7, g8_19 = 19 * g8, g9_19 = 19 * g9;
+		int32_t f1_2 = 2 * f1, f3_2 = 2 * f3, f5_2 = 2 * f5, f7_2 = 2 * f7, f9_2 = 2 * f9;
+		int64_t t[10];
+		t[0] = mul(f0, g0) + mul(f1_2, g9_19) + mul(f2, g8_19) + mul(f3_2, g7_19) + mul(f4, g6_19) + mul(f5_2, g5_19) + mul(f6, g4_19) + mul(f7_2, g3_19) + mul(f8, g2_19) + mul(f9_2, g1_19);
+		t[1] = mul(f0, g1) + mul(f1, g0) + mul(f2, g9_19) + mul(f3, g8_19) + mul(f4, g7_19) + mul(f5, g6_19) + mul(f6, g5_19) + mul(f7, g4_19) + mul(f8, g3_19) + mul(f9, g2_19);
+		t[2] = mul(f0, g2) + mul(f1_2, g1) + mul(f2, g0) + mul(f3_2, g9_19) + mul(f4, g8_19) + mul(f5_2, g7_19) + mul(f6, g6_19) + mul(f7_2, g5_19) + mul(f8, g4_19) + mul(f9_2, g3_19);
+		t[3] = mul(f0, g3) + mul(f1, g2) + mul(f2, g1) + mul(f3, g0) + mul(f4, g9_19) + mul(f5, g8_19) + mul(f6, g7_19) + mul(f7, g6_19) + mul(f8, g5_19) + mul(f9, g4_19);
+		t[4] = mul(f0, g4) + mul(f1_2, g3) + mul(f2, g2) + mul(f3_2, g1) + mul(f4, g0) + mul(f5_2, g9_19) + mul(f6, g8_19) + mul(f7_2, g7_19) + mul(f8, g6_19) + mul(f9_2, g5_19);
+		t[5] = mul(f0, g5) + mul(f1, g4) + mul(f2, g3) + mul(f3, g2) + mul(f4, g1) + mul(f5, g0) + mul(f6, g9_19) + mul(f7, g8_19) + mul(f8, g7_19) + mul(f9, g6_19);
+		t[6] = mul(f0, g6) + mul(f1_2, g5) + mul(f2, g4) + mul(f3_2, g3) + mul(f4, g2) + mul(f5_2, g1) + mul(f6, g0) + mul(f7_2, g9_19) + mul(f8, g8_19) + mul(f9_2, g7_19);
+		t[7] = mul(f0, g7) + mul(f1, g6) + mul(f2, g5) + mul(f3, g4) + mul(f4, g3) + mul(f5, g2) + mul(f6, g1) + mul(f7, g0) + mul(f8, g9_19) + mul(f9, g8_19);
+		t[8] = mul(f0, g8) + mul(f1_2, g7) + mul(f2, g6) + mul(f3_2, g5) + mul(f4, g4) + mul(f5_2, g3) + mul(f6, g2) + mul(f7_2, g1) + mul(f8, g0) + mul(f9_2, g9_19);
+		t[9] = mul(f0, g9) + mul(f1, g8) + mul(f2, g7) + mul(f3, g6) + mul(f4, g5) + mul(f5, g4) + mul(f6, g3) + mul(f7, g2) + mul(f8, g1) + mul(f9, g0);
+		fe_carry(h, t);
+	}
+
+	// t = f^2, unreduced; the symmetric products are only computed once
+	void fe_sq_terms(int64_t* t, const fe f) {
+		int32_t f0 = f[0], f1 = f[1], f2 = f[2], f3 = f[3], f4 = f[4];
+		int32_t f5 = f[5], f6 = f[6], f7 = f[7], f8 = f[8], f9 = f[9];
+		int32_t f0_2 = 2 * f0, f1_2 = 2 * f1, f2_2 = 2 * f2, f3_2 = 2 * f3, f4_2 = 2 * f4;
+		int32_t f5_2 = 2 * f5, f6_2 = 2 * f6, f7_2 = 2 * f7, f8_2 = 2 * f8, f9_2 = 2 * f9;
+		int32_t f5_19 = 19 * f5, f6_19 = 19 * f6, f7_19 = 19 * f7, f8_19 = 19 * f8, f9_19 = 19 * f9;
+		int32_t f7_38 = 38 * f7, f9_38 = 38 * f9;
+		t[0] = mul(f0, f0) + mul(f1_2, f9_38) + mul(f2_2, f8_19) + mul(f3_2, f7_38) + mul(f4_2, f6_19) + mul(f5_2, f5_19);
+		t[1] = mul(f0_2, f1) + mul(f2_2, f9_19) + mul(f3_2, f8_19) + mul(f4_2, f7_19) + mul(f5_2, f6_19);
+		t[2] = mul(f0_2, f2) + mul(f1_2, f1) + mul(f3_2, f9_38) + mul(f4_2, f8_19) + mul(f5_2, f7_38) + mul(f6, f6_19);
+		t[3] = mul(f0_2, f3) + mul(f1_2, f2) + mul(f4_2, f9_19) + mul(f5_2, f8_19) + mul(f6_2, f7_19);
+		t[4] = mul(f0_2, f4) + mul(f1_2, f3_2) + mul(f2, f2) + mul(f5_2, f9_38) + mul(f6_2, f8_19) + mul(f7_2, f7_19);
+		t[5] = mul(f0_2, f5) + mul(f1_2, f4) + mul(f2_2, f3) + mul(f6_2, f9_19) + mul(f7_2, f8_19);
+		t[6] = mul(f0_2, f6) + mul(f1_2, f5_2) + mul(f2_2, f4) + mul(f3_2, f3) + mul(f7_2, f9_38) + mul(f8, f8_19);
+		t[7] = mul(f0_2, f7) + mul(f1_2, f6) + mul(f2_2, f5) + mul(f3_2, f4) + mul(f8_2, f9_19);
+		t[8] = mul(f0_2, f8) + mul(f1_2, f7_2) + mul(f2_2, f6) + mul(f3_2, f5_2) + mul(f4, f4) + mul(f9_2, f9_19);
+		t[9] = mul(f0_2, f9) + mul(f1_2, f8) + mul(f2_2, f7) + mul(f3_2, f6) + mul(f4_2, f5);
+	}
+
+	void fe_sq(fe h, const fe f) {
+		int64_t t[10];
+		fe_sq_terms(t, f);
+		fe_carry(h, t);
+	}
+
+	// h = 2 f^2
+	void fe_sq2(fe h, const fe f) {
+		int64_t t[10];
+		fe_sq_terms(t, f);
+		for (int i = 0; i < 10; i++) {
+			t[i] += t[i];
+		}
+		fe_carry(h, t);
+	}
+
+	// h = f^(2^n)
+	void fe_sqn(fe h, const fe f, int n) {
+		fe_sq(h, f);
+		for (int i = 1; i < n; i++) {
+			fe_sq(h, h);
+		}
+	}
+
+	void fe_mul121666(fe h, const fe f) {
+		int64_t t[10];
+		for (int i = 0; i < 10; i++) {
+			t[i] = mul(f[i], 121666);
+		}
+		fe_carry(h, t);
+	}
+
+	// out = z^(2^255 - 21) = 1/z
+	void fe_invert(fe out, const fe z) {
+		fe t0, t1, t2, t3;
+		fe_sq(t0, z);
+		fe_sqn(t1, t0, 2);
+		fe_mul(t1, z, t1);
+		fe_mul(t0, t0, t1);
+		fe_sq(t2, t0);
+		fe_mul(t1, t1, t2);			// 2^5 - 1
+		fe_sqn(t2, t1, 5);
+		fe_mul(t1, t2, t1);			// 2^10 - 1
+		fe_sqn(t2, t1, 10);
+		fe_mul(t2, t2, t1);			// 2^20 - 1
+		fe_sqn(t3, t2, 20);
+		fe_mul(t2, t3, t2);			// 2^40 - 1
+		fe_sqn(t2, t2, 10);
+		fe_mul(t1, t2, t1);			// 2^50 - 1
+		fe_sqn(t2, t1, 50);
+		fe_mul(t2, t2, t1);			// 2^100 - 1
+		fe_sqn(t3, t2, 100);
+		fe_mul(t2, t3, t2);			// 2^200 - 1
+		fe_sqn(t2, t2, 50);
+		fe_mul(t1, t2, t1);			// 2^250 - 1
+		fe_sqn(t1, t1, 5);
+		fe_mul(out, t1, t0);
+	}
+
+	// out = z^(2^252 - 3), for square roots
+	void fe_pow22523(fe out, const fe z) {
+		fe t0, t1, t2;
+		fe_sq(t0, z);
+		fe_sqn(t1, t0, 2);
+		fe_mul(t1, z, t1);
+		fe_mul(t0, t0, t1);
+		fe_sq(t0, t0);
+		fe_mul(t0, t1, t0);			// 2^5 - 1
+		fe_sqn(t1, t0, 5);
+		fe_mul(t0, t1, t0);			// 2^10 - 1
+		fe_sqn(t1, t0, 10);
+		fe_mul(t1, t1, t0);			// 2^20 - 1
+		fe_sqn(t2, t1, 20);
+		fe_mul(t1, t2, t1);			// 2^40 - 1
+		fe_sqn(t1, t1, 10);
+		fe_mul(t0, t1, t0);			// 2^50 - 1
+		fe_sqn(t1, t0, 50);
+		fe_mul(t1, t1, t0);			// 2^100 - 1
+		fe_sqn(t2, t1, 100);
+		fe_mul(t1, t2, t1);			// 2^200 - 1
+		fe_sqn(t1, t1, 50);
+		fe_mul(t0, t1, t0);			// 2^250 - 1
+		fe_sqn(t0, t0, 2);
+		fe_mul(out, t0, z);
+	}
+
+	// Little-endian 255 bit value, the top bit of s[31] is ignored
+	void fe_frombytes(fe h, const uint8_t* s) {
+		uint64_t acc = 0;
+		int bits = 0;
+		for (int i = 0; i < 10; i++) {
+			int width = (i & 1) ? 25 : 26;
+			while (bits < width) {
+				acc |= (uint64_t)(*s++) << bits;
+				bits += 8;
+			}
+			h[i] = (int32_t)(acc & (((uint64_t)1 << width) - 1));
+			acc >>= width;
+			bits -= width;
+		}
+	}
+
+	// Canonical (fully reduced) little-endian encoding
+	void fe_tobytes(uint8_t* s, const fe f) {
+		int32_t h[10];
+		fe_copy(h, f);
+		// q = floor(h / p), 0 or 1
+		int32_t q = (19 * h[9] + ((int32_t)1 << 24)) >> 25;
+		for (int i = 0; i < 10; i++) {
+			q = (h[i] + q) >> ((i & 1) ? 25 : 26);
+		}
+		h[0] += 19 * q;
+		for (int i = 0; i < 9; i++) {
+			int width = (i & 1) ? 25 : 26;
+			int32_t c = h[i] >> width;
+			h[i + 1] += c;
+			h[i] -= c * ((int32_t)1 << width);
+		}
+		h[9] -= (h[9] >> 25) * ((int32_t)1 << 25);
+		uint64_t acc = 0;
+		int bits = 0;
+		for (int i = 0; i < 10; i++) {
+			acc |= (uint64_t)(uint32_t)h[i] << bits;
+			bits += (i & 1) ? 25 : 26;
+			while (bits >= 8) {
+				*s++ = (uint8_t)acc;
+				acc >>= 8;
+				bits -= 8;
+			}
+		}
+		*s = (uint8_t)acc;
+	}
+
+	inline bool fe_isnegative(const fe f) {
+		uint8_t s[32];
+		fe_tobytes(s, f);
+		return s[0] & 1;
+	}
+
+	inline bool fe_isnonzero(const fe f) {
+		uint8_t s[32];
+		fe_tobytes(s, f);
+		uint8_t r = 0;
+		for (int i = 0; i < 32; i++) {
+			r |= s[i];
+		}
+		return r != 0;
+	}
+
+	// ─── Points on -x^2 + y^2 = 1 + d x^2 y^2 ───────────────────────────────────
+	struct ge_p2 { fe X, Y, Z; };				// projective, x = X/Z, y = Y/Z
+	struct ge_p3 { fe X, Y, Z, T; };			// extended, XY = ZT
+	struct ge_p1p1 { fe X, Y, Z, T; };			// completed, x = X/Z, y = Y/T
+	struct ge_precomp { fe yplusx, yminusx, xy2d; };	// affine, for mixed additions
+	struct ge_cached { fe YplusX, YminusX, Z, T2d; };
+
+	inline void ge_p2_0(ge_p2& h) {
+		fe_0(h.X);
+		fe_1(h.Y);
+		fe_1(h.Z);
+	}
+
+	inline void ge_p3_0(ge_p3& h) {
+		fe_0(h.X);
+		fe_1(h.Y);
+		fe_1(h.Z);
+		fe_0(h.T);
+	}
+
+	inline void ge_precomp_0(ge_precomp& h) {
+		fe_1(h.yplusx);
+		fe_1(h.yminusx);
+		fe_0(h.xy2d);
+	}
+
+	inline void ge_precomp_load(ge_precomp& h, const int32_t (*table)[10]) {
+		fe_copy(h.yplusx, table[0]);
+		fe_copy(h.yminusx, table[1]);
+		fe_copy(h.xy2d, table[2]);
+	}
+
+	inline void ge_p1p1_to_p2(ge_p2& r, const ge_p1p1& p) {
+		fe_mul(r.X, p.X, p.T);
+		fe_mul(r.Y, p.Y, p.Z);
+		fe_mul(r.Z, p.Z, p.T);
+	}
+
+	inline void ge_p1p1_to_p3(ge_p3& r, const ge_p1p1& p) {
+		fe_mul(r.X, p.X, p.T);
+		fe_mul(r.Y, p.Y, p.Z);
+		fe_mul(r.Z, p.Z, p.T);
+		fe_mul(r.T, p.X, p.Y);
+	}
+
+	inline void ge_p3_to_p2(ge_p2& r, const ge_p3& p) {
+		fe_copy(r.X, p.X);
+		fe_copy(r.Y, p.Y);
+		fe_copy(r.Z, p.Z);
+	}
+
+	inline void ge_p3_to_cached(ge_cached& r, const ge_p3& p) {
+		fe_add(r.YplusX, p.Y, p.X);
+		fe_sub(r.YminusX, p.Y, p.X);
+		fe_copy(r.Z, p.Z);
+		fe_mul(r.T2d, p.T, Fast25519Tables::d2);
+	}
+
+	void ge_p2_dbl(ge_p1p1& r, const ge_p2& p) {
+		fe t0;
+		fe_sq(r.X, p.X);
+		fe_sq(r.Z, p.Y);
+		fe_sq2(r.T, p.Z);
+		fe_add(r.Y, p.X, p.Y);
+		fe_sq(t0, r.Y);
+		fe_add(r.Y, r.Z, r.X);
+		fe_sub(r.Z, r.Z, r.X);
+		fe_sub(r.X, t0, r.Y);
+		fe_sub(r.T, r.T, r.Z);
+	}
+
+	inline void ge_p3_dbl(ge_p1p1& r, const ge_p3& p) {
+		ge_p2 q;
+		ge_p3_to_p2(q, p);
+		ge_p2_dbl(r, q);
+	}
+
+	// r = p + q, or p - q with subtract
+	void ge_add(ge_p1p1& r, const ge_p3& p, const ge_cached& q, bool subtract = false) {
+		fe t0;
+		fe_add(r.X, p.Y, p.X);
+		fe_sub(r.Y, p.Y, p.X);
+		fe_mul(r.Z, r.X, subtract ? q.YminusX : q.YplusX);
+		fe_mul(r.Y, r.Y, subtract ? q.YplusX : q.YminusX);
+		fe_mul(r.T, q.T2d, p.T);
+		fe_mul(r.X, p.Z, q.Z);
+		fe_add(t0, r.X, r.X);
+		fe_sub(r.X, r.Z, r.Y);
+		fe_add(r.Y, r.Z, r.Y);
+		if (subtract) {
+			fe_sub(r.Z, t0, r.T);
+			fe_add(r.T, t0, r.T);
+		}
+		else {
+			fe_add(r.Z, t0, r.T);
+			fe_sub(r.T, t0, r.T);
+		}
+	}
+
+	// r = p + q, or p - q with subtract, q affine
+	void ge_madd(ge_p1p1& r, const ge_p3& p, const ge_precomp& q, bool subtract = false) {
+		fe t0;
+		fe_add(r.X, p.Y, p.X);
+		fe_sub(r.Y, p.Y, p.X);
+		fe_mul(r.Z, r.X, subtract ? q.yminusx : q.yplusx);
+		fe_mul(r.Y, r.Y, subtract ? q.yplusx : q.yminusx);
+		fe_mul(r.T, q.xy2d, p.T);
+		fe_add(t0, p.Z, p.Z);
+		fe_sub(r.X, r.Z, r.Y);
+		fe_add(r.Y, r.Z, r.Y);
+		if (subtract) {
+			fe_sub(r.Z, t0, r.T);
+			fe_add(r.T, t0, r.T);
+		}
+		else {
+			fe_add(r.Z, t0, r.T);
+			fe_sub(r.T, t0, r.T);
+		}
+	}
+
+	void ge_p2_tobytes(uint8_t* s, const fe X, const fe Y, const fe Z) {
+		fe recip, x, y;
+		fe_invert(recip, Z);
+		fe_mul(x, X, recip);
+		fe_mul(y, Y, recip);
+		fe_tobytes(s, y);
+		s[31] ^= (uint8_t)(fe_isnegative(x) << 7);
+	}
+
+	// h = -A for the encoding s of A, false if s is not a point
+	bool ge_frombytes_negate_vartime(ge_p3& h, const uint8_t* s) {
+		fe u, v, v3, vxx, check;
+		fe_frombytes(h.Y, s);
+		fe_1(h.Z);
+		fe_sq(u, h.Y);
+		fe_mul(v, u, Fast25519Tables::d);
+		fe_sub(u, u, h.Z);			// u = y^2 - 1
+		fe_add(v, v, h.Z);			// v = d y^2 + 1
+
+		fe_sq(v3, v);
+		fe_mul(v3, v3, v);			// v^3
+		fe_sq(h.X, v3);
+		fe_mul(h.X, h.X, v);
+		fe_mul(h.X, h.X, u);		// u v^7
+		fe_pow22523(h.X, h.X);
+		fe_mul(h.X, h.X, v3);
+		fe_mul(h.X, h.X, u);		// x = u v^3 (u v^7)^((p-5)/8)
+
+		fe_sq(vxx, h.X);
+		fe_mul(vxx, vxx, v);
+		fe_sub(check, vxx, u);		// v x^2 - u
+		if (fe_isnonzero(check)) {
+			fe_add(check, vxx, u);	// v x^2 + u
+			if (fe_isnonzero(check)) {
+				return false;
+			}
+			fe_mul(h.X, h.X, Fast25519Tables::sqrtm1);
+		}
+		if (fe_isnegative(h.X) == (bool)(s[31] >> 7)) {
+			fe_neg(h.X, h.X);
+		}
+		fe_mul(h.T, h.X, h.Y);
+		return true;
+	}
+
+	// ─── Fixed base ─────────────────────────────────────────────────────────────
+	inline uint32_t equal(int8_t b, int8_t c) {
+		uint32_t x = (uint8_t)b ^ (uint8_t)c;
+		return (x - 1) >> 31;
+	}
+
+	inline uint32_t negative(int8_t b) {
+		return (uint32_t)((uint64_t)(int64_t)b >> 63);
+	}
+
+	// t = b * 256^pos * B for -8 <= b <= 8, without secret dependent branches or indexing
+	void select(ge_precomp& t, int pos, int8_t b) {
+		ge_precomp entry, minus_t;
+		uint32_t bnegative = negative(b);
+		int8_t babs = (int8_t)(b - ((-(int32_t)bnegative & b) * 2));
+		ge_precomp_0(t);
+		for (int j = 0; j < 8; j++) {
+			ge_precomp_load(entry, Fast25519Tables::base[pos][j]);
+			uint32_t hit = equal(babs, (int8_t)(j + 1));
+			fe_cmov(t.yplusx, entry.yplusx, hit);
+			fe_cmov(t.yminusx, entry.yminusx, hit);
+			fe_cmov(t.xy2d, entry.xy2d, hit);
+		}
+		fe_copy(minus_t.yplusx, t.yminusx);
+		fe_copy(minus_t.yminusx, t.yplusx);
+		fe_neg(minus_t.xy2d, t.xy2d);
+		fe_cmov(t.yplusx, minus_t.yplusx, bnegative);
+		fe_cmov(t.yminusx, minus_t.yminusx, bnegative);
+		fe_cmov(t.xy2d, minus_t.xy2d, bnegative);
+	}
+
+	// h = a * B, a[31] <= 127
+	void ge_scalarmult_base(ge_p3& h, const uint8_t* a) {
+		// signed radix 16 digits, -8 <= e[i] < 8
+		int8_t e[64];
+		for (int i = 0; i < 32; i++) {
+			e[2 * i + 0] = (a[i] >> 0) & 15;
+			e[2 * i + 1] = (a[i] >> 4) & 15;
+		}
+		int8_t carry = 0;
+		for (int i = 0; i < 63; i++) {
+			e[i] += carry;
+			carry = (int8_t)((e[i] + 8) >> 4);
+			e[i] -= (int8_t)(carry * 16);
+		}
+		e[63] += carry;
+
+		ge_p1p1 r;
+		ge_p2 s;
+		ge_precomp t;
+		ge_p3_0(h);
+		for (int i = 1; i < 64; i += 2) {
+			select(t, i / 2, e[i]);
+			ge_madd(r, h, t);
+			ge_p1p1_to_p3(h, r);
+		}
+
+		ge_p3_dbl(r, h);
+		ge_p1p1_to_p2(s, r);
+		ge_p2_dbl(r, s);
+		ge_p1p1_to_p2(s, r);
+		ge_p2_dbl(r, s);
+		ge_p1p1_to_p2(s, r);
+		ge_p2_dbl(r, s);
+		ge_p1p1_to_p3(h, r);
+
+		for (int i = 0; i < 64; i += 2) {
+			select(t, i / 2, e[i]);
+			ge_madd(r, h, t);
+			ge_p1p1_to_p3(h, r);
+		}
+		clean(e);
+	}
+
+	// ─── Double scalar ──────────────────────────────────────────────────────────
+	// Signed sliding window digits of a, odd and at most 15 in magnitude
+	void slide(int8_t* r, const uint8_t* a) {
+		for (int i = 0; i < 256; i++) {
+			r[i] = 1 & (a[i >> 3] >> (i & 7));
+		}
+		for (int i = 0; i < 256; i++) {
+			if (!r[i]) continue;
+			for (int b = 1; b <= 6 && i + b < 256; b++) {
+				if (!r[i + b]) continue;
+				if (r[i] + (r[i + b] << b) <= 15) {
+					r[i] += r[i + b] << b;
+					r[i + b] = 0;
+				}
+				else if (r[i] - (r[i + b] << b) >= -15) {
+					r[i] -= r[i + b] << b;
+					for (int k = i + b; k < 256; k++) {
+						if (!r[k]) {
+							r[k] = 1;
+							break;
+						}
+						r[k] = 0;
+					}
+				}
+				else {
+					break;
+				}
+			}
+		}
+	}
+
+	// r = a * A + b * B, in variable time (public inputs only)
+	void ge_double_scalarmult_vartime(ge_p2& r, const uint8_t* a, const ge_p3& A, const uint8_t* b) {
+		int8_t aslide[256];
+		int8_t bslide[256];
+		slide(aslide, a);
+		slide(bslide, b);
+
+		// Ai[i] = (2i+1) A
+		ge_cached Ai[8];
+		ge_p1p1 t;
+		ge_p3 u;
+		ge_p3 A2;
+		ge_p3_to_cached(Ai[0], A);
+		ge_p3_dbl(t, A);
+		ge_p1p1_to_p3(A2, t);
+		for (int i = 1; i < 8; i++) {
+			ge_add(t, A2, Ai[i - 1]);
+			ge_p1p1_to_p3(u, t);
+			ge_p3_to_cached(Ai[i], u);
+		}
+
+		ge_p2_0(r);
+		int i = 255;
+		while (i >= 0 && !aslide[i] && !bslide[i]) {
+			i--;
+		}
+		ge_precomp bi;
+		for (; i >= 0; i--) {
+			ge_p2_dbl(t, r);
+			if (aslide[i] > 0) {
+				ge_p1p1_to_p3(u, t);
+				ge_add(t, u, Ai[aslide[i] / 2]);
+			}
+			else if (aslide[i] < 0) {
+				ge_p1p1_to_p3(u, t);
+				ge_add(t, u, Ai[(-aslide[i]) / 2], true);
+			}
+			if (bslide[i] > 0) {
+				ge_p1p1_to_p3(u, t);
+				ge_precomp_load(bi, Fast25519Tables::bi[bslide[i] / 2]);
+				ge_madd(t, u, bi);
+			}
+			else if (bslide[i] < 0) {
+				ge_p1p1_to_p3(u, t);
+				ge_precomp_load(bi, Fast25519Tables::bi[(-bslide[i]) / 2]);
+				ge_madd(t, u, bi, true);
+			}
+			ge_p1p1_to_p2(r, t);
+		}
+	}
+
+	// ─── Scalars mod L = 2^252 + 27742317777372353535851937790883648493 ─────────
+	const int64_t L[32] = {
+		0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x10
+	};
+
+	// r = x mod L for x of 64 signed 8 bit digits (as in TweetNaCl)
+	void sc_modL(uint8_t* r, int64_t* x) {
+		int64_t carry;
+		for (int i = 63; i >= 32; i--) {
+			carry = 0;
+			int j;
+			for (j = i - 32; j < i - 12; j++) {
+				x[j] += carry - 16 * x[i] * L[j - (i - 32)];
+				carry = (x[j] + 128) >> 8;
+				x[j] -= carry * 256;
+			}
+			x[j] += carry;
+			x[i] = 0;
+		}
+		carry = 0;
+		for (int j = 0; j < 32; j++) {
+			x[j] += carry - (x[31] >> 4) * L[j];
+			carry = x[j] >> 8;
+			x[j] &= 255;
+		}
+		for (int j = 0; j < 32; j++) {
+			x[j] -= carry * L[j];
+		}
+		for (int i = 0; i < 32; i++) {
+			x[i + 1] += x[i] >> 8;
+			r[i] = (uint8_t)(x[i] & 255);
+		}
+	}
+
+	// r = s mod L for a 64 byte s
+	void sc_reduce(uint8_t* r, const uint8_t* s) {
+		int64_t x[64];
+		for (int i = 0; i < 64; i++) {
+			x[i] = s[i];
+		}
+		sc_modL(r, x);
+		clean(x);
+	}
+
+	// s = (a * b + c) mod L
+	void sc_muladd(uint8_t* s, const uint8_t* a, const uint8_t* b, const uint8_t* c) {
+		int64_t x[64];
+		for (int i = 0; i < 64; i++) {
+			x[i] = (i < 32) ? c[i] : 0;
+		}
+		for (int i = 0; i < 32; i++) {
+			for (int j = 0; j < 32; j++) {
+				x[i + j] += (int64_t)a[i] * b[j];
+			}
+		}
+		sc_modL(s, x);
+		clean(x);
+	}
+
+	// s < L
+	bool sc_is_canonical(const uint8_t* s) {
+		for (int i = 31; i >= 0; i--) {
+			if (s[i] < L[i]) return true;
+			if (s[i] > L[i]) return false;
+		}
+		return false;
+	}
+
+	inline void clamp(uint8_t* e) {
+		e[0] &= 248;
+		e[31] &= 127;
+		e[31] |= 64;
+	}
+
+}
+
+// ─── Ed25519 ─────────────────────────────────────────────────────────────────
+/*static*/ void Fast25519::ed25519_public_key(uint8_t public_key[32], const uint8_t private_key[32]) {
+	uint8_t az[64];
+	SHA512Engine hash;
+	hash.reset();
+	hash.update(private_key, 32);
+	hash.finalize(az, sizeof(az));
+	clamp(az);
+	ge_p3 A;
+	ge_scalarmult_base(A, az);
+	ge_p2_tobytes(public_key, A.X, A.Y, A.Z);
+	clean(az);
+}
+
+/*static*/ void Fast25519::ed25519_sign(uint8_t signature[64], const uint8_t private_key[32], const uint8_t public_key[32], const void* message, size_t len) {
+	uint8_t az[64];
+	uint8_t nonce[64];
+	uint8_t hram[64];
+	uint8_t r[32];
+	uint8_t h[32];
+	SHA512Engine hash;
+	hash.reset();
+	hash.update(private_key, 32);
+	hash.finalize(az, sizeof(az));
+	clamp(az);
+
+	// r = SHA512(prefix || M) mod L, R = rB
+	hash.reset();
+	hash.update(az + 32, 32);
+	hash.update(message, len);
+	hash.finalize(nonce, sizeof(nonce));
+	sc_reduce(r, nonce);
+	ge_p3 R;
+	ge_scalarmult_base(R, r);
+	ge_p2_tobytes(signature, R.X, R.Y, R.Z);
+
+	// S = (r + SHA512(R || A || M) a) mod L
+	hash.reset();
+	hash.update(signature, 32);
+	hash.update(public_key, 32);
+	hash.update(message, len);
+	hash.finalize(hram, sizeof(hram));
+	sc_reduce(h, hram);
+	sc_muladd(signature + 32, h, az, r);
+
+	clean(az);
+	clean(nonce);
+	clean(r);
+}
+
+/*static*/ bool Fast25519::ed25519_verify(const uint8_t signature[64], const uint8_t public_key[32], const void* message, size_t len) {
+	if (!sc_is_canonical(signature + 32)) {
+		return false;
+	}
+	ge_p3 A;
+	if (!ge_frombytes_negate_vartime(A, public_key)) {
+		return false;
+	}
+
+	uint8_t hram[64];
+	uint8_t h[32];
+	SHA512Engine hash;
+	hash.reset();
+	hash.update(signature, 32);
+	hash.update(public_key, 32);
+	hash.update(message, len);
+	hash.finalize(hram, sizeof(hram));
+	sc_reduce(h, hram);
+
+	// R' = SB - hA must encode to R
+	ge_p2 R;
+	uint8_t check[32];
+	ge_double_scalarmult_vartime(R, h, A, signature + 32);
+	ge_p2_tobytes(check, R.X, R.Y, R.Z);
+	return memcmp(check, signature, 32) == 0;
+}
+
+// ─── X25519 ──────────────────────────────────────────────────────────────────
+/*static*/ void Fast25519::x25519_public_key(uint8_t public_key[32], const uint8_t private_key[32]) {
+	uint8_t e[32];
+	memcpy(e, private_key, sizeof(e));
+	clamp(e);
+	ge_p3 A;
+	ge_scalarmult_base(A, e);
+	// birational map to the Montgomery curve, u = (1 + y) / (1 - y)
+	fe zplusy, zminusy, u;
+	fe_add(zplusy, A.Z, A.Y);
+	fe_sub(zminusy, A.Z, A.Y);
+	fe_invert(zminusy, zminusy);
+	fe_mul(u, zplusy, zminusy);
+	fe_tobytes(public_key, u);
+	clean(e);
+}
+
+/*static*/ bool Fast25519::x25519(uint8_t shared_key[32], const uint8_t private_key[32], const uint8_t peer_key[32]) {
+	uint8_t e[32];
+	memcpy(e, private_key, sizeof(e));
+	clamp(e);
+
+	fe x1, x2, z2, x3, z3, tmp0, tmp1;
+	fe_frombytes(x1, peer_key);
+	fe_1(x2);
+	fe_0(z2);
+	fe_copy(x3, x1);
+	fe_1(z3);
+
+	// Montgomery ladder, RFC 7748 section 5
+	uint32_t swap = 0;
+	for (int pos = 254; pos >= 0; pos--) {
+		uint32_t b = (e[pos / 8] >> (pos & 7)) & 1;
+		swap ^= b;
+		fe_cswap(x2, x3, swap);
+		fe_cswap(z2, z3, swap);
+		swap = b;
+		fe_sub(tmp0, x3, z3);		// D
+		fe_sub(tmp1, x2, z2);		// B
+		fe_add(x2, x2, z2);			// A
+		fe_add(z2, x3, z3);			// C
+		fe_mul(z3, tmp0, x2);		// DA
+		fe_mul(z2, z2, tmp1);		// CB
+		fe_sq(tmp0, tmp1);			// BB
+		fe_sq(tmp1, x2);			// AA
+		fe_add(x3, z3, z2);			// DA + CB
+		fe_sub(z2, z3, z2);			// DA - CB
+		fe_mul(x2, tmp1, tmp0);		// x2 = AA BB
+		fe_sub(tmp1, tmp1, tmp0);	// E = AA - BB
+		fe_sq(z2, z2);
+		fe_mul121666(z3, tmp1);
+		fe_sq(x3, x3);				// x3 = (DA + CB)^2
+		fe_add(tmp0, tmp0, z3);		// BB + 121666 E = AA + 121665 E
+		fe_mul(z3, x1, z2);			// z3 = x1 (DA - CB)^2
+		fe_mul(z2, tmp1, tmp0);		// z2 = E (AA + 121665 E)
+	}
+	fe_cswap(x2, x3, swap);
+	fe_cswap(z2, z3, swap);
+
+	fe_invert(z2, z2);
+	fe_mul(x2, x2, z2);
+	fe_tobytes(shared_key, x2);
+	clean(e);
+
+	uint8_t zero = 0;
+	for (int i = 0; i < 32; i++) {
+		zero |= shared_key[i];
+	}
+	return zero != 0;
+}
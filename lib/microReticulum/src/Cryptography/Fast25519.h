@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace RNS { namespace Cryptography {
+
+	// CBA Ed25519 and X25519 on a radix 2^25.5 field (ten 32 bit limbs), the representation
+	// of the ref10 implementation.
+	//
+	// Every field multiply is a hundred 32x32->64 products, which map onto a single
+	// widening multiply on both targets (MULL/MULSH on the ESP32 LX6/LX7, SMULL/SMLAL on
+	// the nRF52840 Cortex-M4) instead of the generic multi-precision loops of the Crypto
+	// library.
+	//
+	// Fixed-base scalar multiplication (key generation, signing) walks a precomputed table
+	// of 256 multiples of the base point in flash, 64 additions and 4 doublings, with
+	// constant-time table lookups. Verification computes [s]B - [h]A in one pass of
+	// doublings using signed sliding windows over both scalars. X25519 keys derived from
+	// a private key go through the fixed-base table as well, the shared secret is a
+	// constant-time Montgomery ladder.
+	//
+	// The functions take the same arguments as the Crypto library's Ed25519 and
+	// Curve25519 classes and produce identical results, Backend.h decides which of the two
+	// is used. The tables are generated by tools/fast25519_tables.py.
+	class Fast25519 {
+
+	public:
+		// public_key = [clamp(SHA512(private_key)[0:32])]B
+		static void ed25519_public_key(uint8_t public_key[32], const uint8_t private_key[32]);
+		static void ed25519_sign(uint8_t signature[64], const uint8_t private_key[32], const uint8_t public_key[32], const void* message, size_t len);
+		static bool ed25519_verify(const uint8_t signature[64], const uint8_t public_key[32], const void* message, size_t len);
+
+		// public_key = X25519(private_key, 9)
+		static void x25519_public_key(uint8_t public_key[32], const uint8_t private_key[32]);
+		// false if the result is all zeros (peer_key is of small order)
+		static bool x25519(uint8_t shared_key[32], const uint8_t private_key[32], const uint8_t peer_key[32]);
+
+	};
+
+} }
@@ -1,7 +1,7 @@
 #include "HKDF.h"
+#include "Backend.h"
 
 #include <HKDF.h>
-#include <SHA256.h>
 
 using namespace RNS;
 
@@ -15,7 +15,7 @@ const Bytes RNS::Cryptography::hkdf(size_t length, const Bytes& derive_from, con
 		throw std::invalid_argument("Cannot derive key from empty input material");
 	}
 
-	HKDF<SHA256> hkdf;
+	HKDF<SHA256Engine> hkdf;
 	if (salt) {
 		hkdf.setKey(derive_from.data(), derive_from.size(), salt.data(), salt.size());
 	}
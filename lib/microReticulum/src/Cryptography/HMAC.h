@@ -1,10 +1,9 @@
 #pragma once
 
+#include "Backend.h"
 #include "../Bytes.h"
 
 #include <Hash.h>
-#include <SHA256.h>
-#include <SHA512.h>
 #include <stdexcept>
 #include <memory>
 #include <cassert>
@@ -37,10 +36,10 @@ namespace RNS { namespace Cryptography {
 
 			switch (digest) {
 			case DIGEST_SHA256:
-				_hash = std::unique_ptr<Hash>(new SHA256());
+				_hash = std::unique_ptr<Hash>(new SHA256Engine());
 				break;
 			case DIGEST_SHA512:
-				_hash = std::unique_ptr<Hash>(new SHA512());
+				_hash = std::unique_ptr<Hash>(new SHA512Engine());
 				break;
 			default:
 				throw std::invalid_argument("Unknown ior unsuppored digest");
@@ -61,6 +60,10 @@ namespace RNS { namespace Cryptography {
 			assert(_hash);
 			_hash->update(msg.data(), msg.size());
 		}
+		void update(const uint8_t* data, size_t size) {
+			assert(_hash);
+			_hash->update(data, size);
+		}
 
 		/*
 		Return the hash value of this hashing object.
@@ -74,6 +77,12 @@ namespace RNS { namespace Cryptography {
 			_hash->finalizeHMAC(_key.data(), _key.size(), result.writable(_hash->hashSize()), _hash->hashSize());
 			return result;
 		}
+		// CBA Writes the size() byte hmac value to result, without allocating
+		void digest(uint8_t* result) {
+			assert(_hash);
+			_hash->finalizeHMAC(_key.data(), _key.size(), result, _hash->hashSize());
+		}
+		inline size_t size() const { assert(_hash); return _hash->hashSize(); }
 
 		/*
 		Create a new hashing object and return it.
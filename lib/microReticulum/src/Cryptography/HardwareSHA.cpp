@@ -0,0 +1,131 @@
+#include "Backend.h"
+
+#ifdef RNS_CRYPTO_BACKEND_HW
+
+#include <Crypto.h>
+#include <mbedtls/version.h>
+
+#include <string.h>
+
+using namespace RNS::Cryptography;
+
+// mbedTLS 3.x dropped the _ret suffixes that 2.x used for the int-returning variants
+#if MBEDTLS_VERSION_NUMBER < 0x03000000
+#define rns_sha256_starts mbedtls_sha256_starts_ret
+#define rns_sha256_update mbedtls_sha256_update_ret
+#define rns_sha256_finish mbedtls_sha256_finish_ret
+#define rns_sha512_starts mbedtls_sha512_starts_ret
+#define rns_sha512_update mbedtls_sha512_update_ret
+#define rns_sha512_finish mbedtls_sha512_finish_ret
+#else
+#define rns_sha256_starts mbedtls_sha256_starts
+#define rns_sha256_update mbedtls_sha256_update
+#define rns_sha256_finish mbedtls_sha256_finish
+#define rns_sha512_starts mbedtls_sha512_starts
+#define rns_sha512_update mbedtls_sha512_update
+#define rns_sha512_finish mbedtls_sha512_finish
+#endif
+
+HardwareSHA256::HardwareSHA256() {
+	mbedtls_sha256_init(&_context);
+	rns_sha256_starts(&_context, 0);
+}
+
+HardwareSHA256::~HardwareSHA256() {
+	mbedtls_sha256_free(&_context);
+}
+
+void HardwareSHA256::reset() {
+	mbedtls_sha256_free(&_context);
+	mbedtls_sha256_init(&_context);
+	rns_sha256_starts(&_context, 0);
+}
+
+void HardwareSHA256::update(const void* data, size_t len) {
+	rns_sha256_update(&_context, (const uint8_t*)data, len);
+}
+
+void HardwareSHA256::finalize(void* hash, size_t len) {
+	uint8_t temp[32];
+	rns_sha256_finish(&_context, temp);
+	memcpy(hash, temp, (len < sizeof(temp)) ? len : sizeof(temp));
+	clean(temp);
+}
+
+void HardwareSHA256::clear() {
+	reset();
+}
+
+void HardwareSHA256::resetHMAC(const void* key, size_t keyLen) {
+	uint8_t block[64];
+	formatHMACKey(block, key, keyLen, 0x36);
+	reset();
+	update(block, sizeof(block));
+	clean(block);
+}
+
+void HardwareSHA256::finalizeHMAC(const void* key, size_t keyLen, void* hash, size_t hashLen) {
+	uint8_t temp[32];
+	uint8_t block[64];
+	finalize(temp, sizeof(temp));
+	formatHMACKey(block, key, keyLen, 0x5C);
+	reset();
+	update(block, sizeof(block));
+	update(temp, sizeof(temp));
+	finalize(hash, hashLen);
+	clean(block);
+	clean(temp);
+}
+
+HardwareSHA512::HardwareSHA512() {
+	mbedtls_sha512_init(&_context);
+	rns_sha512_starts(&_context, 0);
+}
+
+HardwareSHA512::~HardwareSHA512() {
+	mbedtls_sha512_free(&_context);
+}
+
+void HardwareSHA512::reset() {
+	mbedtls_sha512_free(&_context);
+	mbedtls_sha512_init(&_context);
+	rns_sha512_starts(&_context, 0);
+}
+
+void HardwareSHA512::update(const void* data, size_t len) {
+	rns_sha512_update(&_context, (const uint8_t*)data, len);
+}
+
+void HardwareSHA512::finalize(void* hash, size_t len) {
+	uint8_t temp[64];
+	rns_sha512_finish(&_context, temp);
+	memcpy(hash, temp, (len < sizeof(temp)) ? len : sizeof(temp));
+	clean(temp);
+}
+
+void HardwareSHA512::clear() {
+	reset();
+}
+
+void HardwareSHA512::resetHMAC(const void* key, size_t keyLen) {
+	uint8_t block[128];
+	formatHMACKey(block, key, keyLen, 0x36);
+	reset();
+	update(block, sizeof(block));
+	clean(block);
+}
+
+void HardwareSHA512::finalizeHMAC(const void* key, size_t keyLen, void* hash, size_t hashLen) {
+	uint8_t temp[64];
+	uint8_t block[128];
+	finalize(temp, sizeof(temp));
+	formatHMACKey(block, key, keyLen, 0x5C);
+	reset();
+	update(block, sizeof(block));
+	update(temp, sizeof(temp));
+	finalize(hash, hashLen);
+	clean(block);
+	clean(temp);
+}
+
+#endif
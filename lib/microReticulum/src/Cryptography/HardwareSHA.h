@@ -0,0 +1,68 @@
+#pragma once
+
+// included through Backend.h, which decides whether the hardware backend is in use
+#if defined(RNS_CRYPTO_HW) && defined(ESP32)
+
+#include <Hash.h>
+
+#include <mbedtls/sha256.h>
+#include <mbedtls/sha512.h>
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace RNS { namespace Cryptography {
+
+	// CBA Drop-in replacements for the Crypto library's SHA256/SHA512 classes backed by
+	// mbedTLS (and therefore by the hardware SHA engine on ESP32). They implement the same
+	// Hash interface so they can be used with HMAC and the HKDF template unchanged.
+
+	class HardwareSHA256 : public Hash {
+
+	public:
+		HardwareSHA256();
+		virtual ~HardwareSHA256();
+
+		size_t hashSize() const { return 32; }
+		size_t blockSize() const { return 64; }
+
+		void reset();
+		void update(const void* data, size_t len);
+		void finalize(void* hash, size_t len);
+
+		void clear();
+
+		void resetHMAC(const void* key, size_t keyLen);
+		void finalizeHMAC(const void* key, size_t keyLen, void* hash, size_t hashLen);
+
+	private:
+		mbedtls_sha256_context _context;
+
+	};
+
+	class HardwareSHA512 : public Hash {
+
+	public:
+		HardwareSHA512();
+		virtual ~HardwareSHA512();
+
+		size_t hashSize() const { return 64; }
+		size_t blockSize() const { return 128; }
+
+		void reset();
+		void update(const void* data, size_t len);
+		void finalize(void* hash, size_t len);
+
+		void clear();
+
+		void resetHMAC(const void* key, size_t keyLen);
+		void finalizeHMAC(const void* key, size_t keyLen, void* hash, size_t hashLen);
+
+	private:
+		mbedtls_sha512_context _context;
+
+	};
+
+} }
+
+#endif
@@ -1,22 +1,20 @@
 #include "Hashes.h"
 
+#include "Backend.h"
 #include "../Bytes.h"
 
-#include <SHA256.h>
-#include <SHA512.h>
-
 using namespace RNS;
 
 /*
 The SHA primitives are abstracted here to allow platform-
-aware hardware acceleration in the future. Currently only
-uses Python's internal SHA-256 implementation. All SHA-256
-calls in RNS end up here.
+aware hardware acceleration. Uses the software Crypto
+library unless RNS_CRYPTO_HW selects the hardware backend
+(see Backend.h). All SHA-256 calls in RNS end up here.
 */
 
 const Bytes RNS::Cryptography::sha256(const Bytes& data) {
 	//TRACE("Cryptography::sha256: data: " + data.toHex() );
-	SHA256 digest;
+	SHA256Engine digest;
 	digest.reset();
 	digest.update(data.data(), data.size());
 	Bytes hash;
@@ -25,8 +23,26 @@ const Bytes RNS::Cryptography::sha256(const Bytes& data) {
 	return hash;
 }
 
+const Bytes RNS::Cryptography::sha256(const uint8_t* head, size_t head_size, const uint8_t* tail, size_t tail_size) {
+	Bytes hash;
+	sha256(head, head_size, tail, tail_size, hash.writable(32));
+	return hash;
+}
+
+void RNS::Cryptography::sha256(const uint8_t* head, size_t head_size, const uint8_t* tail, size_t tail_size, uint8_t* hash) {
+	SHA256Engine digest;
+	digest.reset();
+	if (head_size > 0) {
+		digest.update(head, head_size);
+	}
+	if (tail_size > 0) {
+		digest.update(tail, tail_size);
+	}
+	digest.finalize(hash, 32);
+}
+
 const Bytes RNS::Cryptography::sha512(const Bytes& data) {
-	SHA512 digest;
+	SHA512Engine digest;
 	digest.reset();
 	digest.update(data.data(), data.size());
 	Bytes hash;
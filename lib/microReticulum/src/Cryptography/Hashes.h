@@ -7,6 +7,10 @@
 namespace RNS { namespace Cryptography {
 
 	const Bytes sha256(const Bytes& data);
+	// digest of the concatenation of two chunks without assembling them first
+	const Bytes sha256(const uint8_t* head, size_t head_size, const uint8_t* tail, size_t tail_size);
+	// as above, into a 32 byte buffer
+	void sha256(const uint8_t* head, size_t head_size, const uint8_t* tail, size_t tail_size, uint8_t* hash);
 	const Bytes sha512(const Bytes& data);
 
 } }
@@ -0,0 +1,81 @@
+#include "Ifac.h"
+
+#include "HKDF.h"
+#include "Ed25519.h"
+#include "../Log.h"
+
+#include <string.h>
+
+using namespace RNS;
+using namespace RNS::Cryptography;
+
+void Ifac::setup(const Bytes& ifac_key, const Bytes& signing_private_key, const Bytes& signing_public_key) {
+	if (signing_private_key.size() != KEYSIZE || signing_public_key.size() != KEYSIZE || !ifac_key) {
+		ERROR("Ifac::setup: invalid signing keys");
+		_enabled = false;
+		return;
+	}
+	memcpy(_signing_private_key, signing_private_key.data(), KEYSIZE);
+	memcpy(_signing_public_key, signing_public_key.data(), KEYSIZE);
+	_ifac_key = ifac_key;
+	_enabled = true;
+}
+
+inline void Ifac::sign(uint8_t* signature, const uint8_t* data, size_t size) const {
+	ed25519_sign(signature, _signing_private_key, _signing_public_key, data, size);
+}
+
+bool Ifac::apply(const Bytes& raw, Bytes& masked) {
+	if (!_enabled || raw.size() < 2) {
+		return false;
+	}
+	const uint8_t* frame = raw.data();
+
+	// IFAC is the last _size bytes of the signature of the raw frame
+	uint8_t signature[SIGLENGTH];
+	sign(signature, frame, raw.size());
+	const uint8_t* ifac = signature + SIGLENGTH - _size;
+
+	Bytes mask = hkdf(raw.size() + _size, Bytes(ifac, _size), _ifac_key);
+	const uint8_t* m = mask.data();
+
+	// header, IFAC, payload; everything but the IFAC is masked and the IFAC flag stays set
+	uint8_t* out = masked.writable(raw.size() + _size);
+	out[0] = ((frame[0] | 0x80) ^ m[0]) | 0x80;
+	out[1] = frame[1] ^ m[1];
+	memcpy(out + 2, ifac, _size);
+	for (size_t i = 2; i < raw.size(); i++) {
+		out[i + _size] = frame[i] ^ m[i + _size];
+	}
+	++_applied;
+	return true;
+}
+
+bool Ifac::remove(const Bytes& masked, Bytes& raw) {
+	if (!_enabled || masked.size() <= (size_t)(2 + _size)) {
+		return false;
+	}
+	const uint8_t* frame = masked.data();
+	const uint8_t* ifac = frame + 2;
+
+	Bytes mask = hkdf(masked.size(), Bytes(ifac, _size), _ifac_key);
+	const uint8_t* m = mask.data();
+
+	// Unmask header and payload, dropping the IFAC and its flag
+	size_t size = masked.size() - _size;
+	uint8_t* out = raw.writable(size);
+	out[0] = (frame[0] ^ m[0]) & 0x7F;
+	out[1] = frame[1] ^ m[1];
+	for (size_t i = 2 + _size; i < masked.size(); i++) {
+		out[i - _size] = frame[i] ^ m[i];
+	}
+
+	uint8_t signature[SIGLENGTH];
+	sign(signature, out, size);
+	if (memcmp(signature + SIGLENGTH - _size, ifac, _size) != 0) {
+		++_failed;
+		return false;
+	}
+	++_removed;
+	return true;
+}
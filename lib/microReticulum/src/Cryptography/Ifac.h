@@ -0,0 +1,60 @@
+#pragma once
+
+#include "../Bytes.h"
+
+#include <stdint.h>
+
+namespace RNS { namespace Cryptography {
+
+	/*
+	Interface access codes for one IFAC enabled interface.
+
+	The IFAC of a frame is the tail of the Ed25519 signature of the frame made with
+	the interface identity, and the frame (except the IFAC itself) is masked with an
+	HKDF stream keyed on the IFAC. Signatures are deterministic, so inbound frames are
+	authenticated by signing the unmasked frame again and comparing the tails.
+
+	The signing keys are kept here as plain arrays and passed straight to the Ed25519
+	backend, and frames are masked and unmasked in a single output buffer, so a frame
+	costs one signature, one HKDF and one allocation for the result.
+	*/
+	class Ifac {
+
+	public:
+		static const uint8_t KEYSIZE = 32;
+		static const uint8_t SIGLENGTH = 64;
+
+	public:
+		Ifac() {}
+
+	public:
+		void setup(const Bytes& ifac_key, const Bytes& signing_private_key, const Bytes& signing_public_key);
+		inline void size(uint8_t size) { _size = size; }
+		inline uint8_t size() const { return _size; }
+		inline operator bool() const { return _enabled; }
+
+		// Sign and mask outbound frame raw into masked
+		bool apply(const Bytes& raw, Bytes& masked);
+		// Unmask and authenticate inbound frame masked into raw (without the IFAC), false if it fails authentication
+		bool remove(const Bytes& masked, Bytes& raw);
+
+		inline uint32_t applied() const { return _applied; }
+		inline uint32_t removed() const { return _removed; }
+		inline uint32_t failed() const { return _failed; }
+
+	private:
+		inline void sign(uint8_t* signature, const uint8_t* data, size_t size) const;
+
+	private:
+		uint8_t _signing_private_key[KEYSIZE] = {0};
+		uint8_t _signing_public_key[KEYSIZE] = {0};
+		Bytes _ifac_key;
+		uint8_t _size = 8;
+		bool _enabled = false;
+		uint32_t _applied = 0;
+		uint32_t _removed = 0;
+		uint32_t _failed = 0;
+
+	};
+
+} }
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "X25519.h"
+#include "Ed25519.h"
+
+#include <vector>
+#include <stdint.h>
+
+namespace RNS { namespace Cryptography {
+
+	/*
+	Ephemeral private keys generated ahead of time.
+
+	Link setup (and Identity::encrypt) needs a fresh keypair per use, and generating it
+	(a scalar multiplication for the public key) sits on the critical path of the
+	handshake. take() hands out a pooled key when there is one and only generates on
+	the spot when the pool has run dry, and refill() tops the pool up one key at a time
+	while the loop has nothing better to do. Each pooled key is handed out exactly once.
+	*/
+	template <typename K>
+	class KeyPool {
+
+	public:
+		static const uint8_t POOL_SIZE = 4;
+
+	public:
+		static typename K::Ptr take() {
+			if (_keys.empty()) {
+				++_misses;
+				return K::generate();
+			}
+			++_hits;
+			typename K::Ptr key = _keys.back();
+			_keys.pop_back();
+			return key;
+		}
+
+		// Generate one key if the pool is short, returns true if a key was generated
+		static bool refill() {
+			if (_keys.size() >= POOL_SIZE) {
+				return false;
+			}
+			_keys.push_back(K::generate());
+			return true;
+		}
+
+		static inline size_t size() { return _keys.size(); }
+		static inline uint32_t hits() { return _hits; }
+		static inline uint32_t misses() { return _misses; }
+
+	private:
+		static std::vector<typename K::Ptr> _keys;
+		static uint32_t _hits;
+		static uint32_t _misses;
+
+	};
+
+	template <typename K> std::vector<typename K::Ptr> KeyPool<K>::_keys;
+	template <typename K> uint32_t KeyPool<K>::_hits = 0;
+	template <typename K> uint32_t KeyPool<K>::_misses = 0;
+
+	using X25519KeyPool = KeyPool<X25519PrivateKey>;
+	using Ed25519KeyPool = KeyPool<Ed25519PrivateKey>;
+
+} }
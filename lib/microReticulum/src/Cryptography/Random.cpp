@@ -0,0 +1,123 @@
+#include "Random.h"
+
+#include "../Utilities/OS.h"
+
+#if defined(ESP32)
+#include <esp_random.h>
+#elif defined(NRF52840_XXAA)
+#include <nrf_rng.h>
+#include <nrf_sdm.h>
+#include <nrf_soc.h>
+#endif
+
+#include <string.h>
+
+using namespace RNS;
+using namespace RNS::Cryptography;
+using namespace RNS::Utilities;
+
+uint8_t RandomPool::_pool[RandomPool::POOL_SIZE];
+uint8_t RandomPool::_available = 0;
+uint32_t RandomPool::_drawn = 0;
+uint64_t RandomPool::_reseeded_at = 0;
+bool RandomPool::_seeded = false;
+uint32_t RandomPool::_hits = 0;
+uint32_t RandomPool::_misses = 0;
+uint32_t RandomPool::_reseeds = 0;
+
+namespace {
+
+	// Fills data from the hardware generator, returns the number of bytes it had
+	size_t hardware_random(uint8_t* data, size_t len) {
+#if defined(ESP32)
+		esp_fill_random(data, len);
+		return len;
+#elif defined(NRF52840_XXAA)
+		uint8_t softdevice = 0;
+		sd_softdevice_is_enabled(&softdevice);
+		if (softdevice) {
+			// the SoftDevice owns the peripheral and collects its output into a pool
+			uint8_t ready = 0;
+			sd_rand_application_bytes_available_get(&ready);
+			if (len > ready) {
+				len = ready;
+			}
+			if (len == 0 || sd_rand_application_vector_get(data, len) != NRF_SUCCESS) {
+				return 0;
+			}
+			return len;
+		}
+		nrf_rng_error_correction_enable(NRF_RNG);
+		nrf_rng_shorts_disable(NRF_RNG, NRF_RNG_SHORT_VALRDY_STOP_MASK);
+		nrf_rng_task_trigger(NRF_RNG, NRF_RNG_TASK_START);
+		for (size_t i = 0; i < len; i++) {
+			while (!nrf_rng_event_check(NRF_RNG, NRF_RNG_EVENT_VALRDY));
+			data[i] = nrf_rng_random_value_get(NRF_RNG);
+			nrf_rng_event_clear(NRF_RNG, NRF_RNG_EVENT_VALRDY);
+		}
+		nrf_rng_task_trigger(NRF_RNG, NRF_RNG_TASK_STOP);
+		return len;
+#else
+		(void)data;
+		(void)len;
+		return 0;
+#endif
+	}
+
+}
+
+/*static*/ void RandomPool::fill(uint8_t* data, size_t len) {
+	if (reseed_due()) {
+		reseed();
+	}
+	_drawn += len;
+	if (len >= DIRECT_SIZE) {
+		RNG.rand(data, len);
+		return;
+	}
+	if (len > _available) {
+		++_misses;
+		RNG.rand(_pool, POOL_SIZE);
+		_available = POOL_SIZE;
+	}
+	else {
+		++_hits;
+	}
+	// handed out from the end so the bytes left are always at the start
+	uint8_t* start = _pool + _available - len;
+	memcpy(data, start, len);
+	memset(start, 0, len);
+	_available -= len;
+}
+
+/*static*/ bool RandomPool::refill() {
+	if (reseed_due()) {
+		reseed();
+		return true;
+	}
+	if (_available >= POOL_SIZE / 2) {
+		return false;
+	}
+	RNG.rand(_pool, POOL_SIZE);
+	_available = POOL_SIZE;
+	return true;
+}
+
+/*static*/ void RandomPool::reseed() {
+	uint8_t seed[SEED_SIZE];
+	size_t len = hardware_random(seed, sizeof(seed));
+	if (len > 0) {
+		RNG.stir(seed, len, len * 8);
+		memset(seed, 0, sizeof(seed));
+	}
+	memset(_pool, 0, sizeof(_pool));
+	_available = 0;
+	_drawn = 0;
+	_reseeded_at = OS::ltime();
+	_seeded = true;
+	++_reseeds;
+}
+
+/*static*/ bool RandomPool::reseed_due() {
+	return !_seeded || _drawn >= RESEED_BYTES || OS::ltime() - _reseeded_at >= RESEED_INTERVAL;
+}
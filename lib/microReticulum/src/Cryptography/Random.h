@@ -4,35 +4,88 @@
 
 #include <RNG.h>
 #include <stdint.h>
+#include <stddef.h>
 
 namespace RNS { namespace Cryptography {
 
-    // return vector specified length of random bytes
+	/*
+	CBA Small random draws served out of a pool of generator output.
+
+	RNG.rand() runs the ChaCha20 generator for each request and rekeys it afterwards, so
+	a 16 byte IV or a 1 byte header costs two block operations. The pool holds one block
+	of output that refill() tops up in idle time, and draws shorter than DIRECT_SIZE are
+	copied out of it, the bytes wiped as they are handed out so each is used only once.
+	Key sized draws and larger go straight to RNG.rand(), so key material never waits in
+	the pool.
+
+	Reseed policy: the generator is only as good as what it was seeded with, and nothing
+	else feeds it entropy on these targets. reseed() stirs SEED_SIZE bytes from the
+	hardware generator (esp_fill_random() on ESP32, the RNG peripheral or the SoftDevice's
+	pool on nRF52) into it, credited as full entropy, before the first draw, after every
+	RESEED_BYTES handed out and at least every RESEED_INTERVAL ms. Hardware bytes are
+	mixed in, never used directly, so a weak hardware source (ESP32 with the radios off)
+	cannot make the output worse than the generator state alone. The pool is discarded
+	on reseed, nothing generated under the old state is handed out after it.
+
+	Like RNG itself the pool is not locked. Only the task running the RNS loop may use it;
+	the firmware's own getRandom() on the other core reads the hardware RNG instead.
+	*/
+	class RandomPool {
+
+	public:
+		static const uint8_t POOL_SIZE = 64;
+		static const uint8_t DIRECT_SIZE = 32;
+		static const uint8_t SEED_SIZE = 32;
+		static const uint32_t RESEED_BYTES = 4096;
+		static const uint32_t RESEED_INTERVAL = 60000;
+
+	public:
+		static void fill(uint8_t* data, size_t len);
+		// Reseeds if due and tops the pool up, returns true if there was work to do
+		static bool refill();
+		static void reseed();
+
+		static inline uint32_t hits() { return _hits; }
+		static inline uint32_t misses() { return _misses; }
+		static inline uint32_t reseeds() { return _reseeds; }
+
+	private:
+		static bool reseed_due();
+
+	private:
+		static uint8_t _pool[POOL_SIZE];
+		static uint8_t _available;		// unused bytes at the start of _pool
+		static uint32_t _drawn;			// bytes handed out since the last reseed
+		static uint64_t _reseeded_at;
+		static bool _seeded;
+		static uint32_t _hits;
+		static uint32_t _misses;
+		static uint32_t _reseeds;
+
+	};
+
+	// return vector specified length of random bytes
 	inline const Bytes random(size_t length) {
-        Bytes rand;
-        RNG.rand(rand.writable(length), length);
-        return rand;
-    }
-
-    // return 32 bit random unigned int
-    inline uint32_t randomnum() {
-        Bytes rand;
-        RNG.rand(rand.writable(4), 4);
-        uint32_t randnum = uint32_t((unsigned char)(rand.data()[0]) << 24 |
-                                    (unsigned char)(rand.data()[0]) << 16 |
-                                    (unsigned char)(rand.data()[0]) << 8 |
-                                    (unsigned char)(rand.data()[0]));
-        return randnum;
-    }
-
-    // return 32 bit random unsigned int between 0 and specified value
-    inline uint32_t randomnum(uint32_t max) {
-        return randomnum() % max;
-    }
-
-    // return random float value from 0 to 1
-    inline float random() {
-        return (float)(randomnum() / (float)0xffffffff);
-    }
+		Bytes rand;
+		RandomPool::fill(rand.writable(length), length);
+		return rand;
+	}
+
+	// return 32 bit random unigned int
+	inline uint32_t randomnum() {
+		uint8_t rand[4];
+		RandomPool::fill(rand, sizeof(rand));
+		return (uint32_t)rand[0] << 24 | (uint32_t)rand[1] << 16 | (uint32_t)rand[2] << 8 | (uint32_t)rand[3];
+	}
+
+	// return 32 bit random unsigned int between 0 and specified value
+	inline uint32_t randomnum(uint32_t max) {
+		return randomnum() % max;
+	}
+
+	// return random float value from 0 to 1
+	inline float random() {
+		return (float)(randomnum() / (float)0xffffffff);
+	}
 
 } }
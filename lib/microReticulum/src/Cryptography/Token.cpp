@@ -3,9 +3,11 @@
 #include "HMAC.h"
 #include "PKCS7.h"
 #include "AES.h"
+#include "Random.h"
 #include "../Log.h"
 
 #include <stdexcept>
+#include <string.h>
 #include <time.h>
 
 using namespace RNS;
@@ -49,106 +51,98 @@ Token::~Token() {
 }
 
 bool Token::verify_hmac(const Bytes& token) {
+	return verify_hmac(token.data(), token.size());
+}
+
+bool Token::verify_hmac(const uint8_t* token, size_t size) {
 
-	if (token.size() <= 32) {
-		throw std::invalid_argument("Cannot verify HMAC on token of only " + std::to_string(token.size()) + " bytes");
+	if (size <= HMAC_SIZE) {
+		throw std::invalid_argument("Cannot verify HMAC on token of only " + std::to_string(size) + " bytes");
 	}
 
 	//received_hmac = token[-32:]
-	Bytes received_hmac = token.right(32);
-	DEBUG("Token::verify_hmac: received_hmac: " + received_hmac.toHex());
+	const uint8_t* received_hmac = token + size - HMAC_SIZE;
 	//expected_hmac = HMAC.new(self._signing_key, token[:-32]).digest()
-	Bytes expected_hmac = HMAC::generate(_signing_key, token.left(token.size()-32))->digest();
-	DEBUG("Token::verify_hmac: expected_hmac: " + expected_hmac.toHex());
-
-	return (received_hmac == expected_hmac);
+	HMAC hmac(_signing_key);
+	hmac.update(token, size - HMAC_SIZE);
+	uint8_t expected_hmac[HMAC_SIZE];
+	hmac.digest(expected_hmac);
+
+	// CBA Compared in constant time
+	uint8_t diff = 0;
+	for (size_t i = 0; i < HMAC_SIZE; i++) {
+		diff |= received_hmac[i] ^ expected_hmac[i];
+	}
+	return (diff == 0);
 }
 
 const Bytes Token::encrypt(const Bytes& data) {
 
 	DEBUG("Token::encrypt: plaintext length: " + std::to_string(data.size()));
-	Bytes iv = random(16);
-	//double current_time = OS::time();
-	TRACE("Token::encrypt: iv:         " + iv.toHex());
-
 	TRACE("Token::encrypt: plaintext:  " + data.toHex());
-	Bytes ciphertext;
-	if (_mode == MODE_AES_128_CBC) {
-		ciphertext = AES_128_CBC::encrypt(
-			PKCS7::pad(data),
-			_encryption_key,
-			iv
-		);
-	}
-	else if (_mode == MODE_AES_256_CBC) {
-		ciphertext = AES_256_CBC::encrypt(
-			PKCS7::pad(data),
-			_encryption_key,
-			iv
-		);
-	}
-	else {
-		throw new std::invalid_argument("Invalid token mode "+std::to_string(_mode));
-	}
-	DEBUG("Token::encrypt: padded ciphertext length: " + std::to_string(ciphertext.size()));
-	TRACE("Token::encrypt: ciphertext: " + ciphertext.toHex());
+	Bytes token;
+	size_t size = token_size(data.size());
+	encrypt(data.data(), data.size(), token.writable(size));
+	TRACE("Token::encrypt: token:      " + token.toHex());
+	DEBUG("Token::encrypt: token length: " + std::to_string(token.size()));
+	return token;
+}
+
+size_t Token::encrypt(const uint8_t* data, size_t size, uint8_t* output) {
+
+	// CBA Layout is iv | padded ciphertext | HMAC, the plaintext is padded and encrypted where the
+	// ciphertext goes
+	uint8_t* iv = output;
+	RandomPool::fill(iv, IV_SIZE);
 
-	Bytes signed_parts = iv + ciphertext;
+	uint8_t* ciphertext = output + IV_SIZE;
+	size_t padlen = PKCS7::BLOCKSIZE - (size % PKCS7::BLOCKSIZE);
+	if (size > 0) {
+		memcpy(ciphertext, data, size);
+	}
+	// same padding as PKCS7::inplace_pad()
+	memset(ciphertext + size, 0, padlen);
+	ciphertext[size + padlen - 1] = (uint8_t)padlen;
+	size_t ciphertext_size = size + padlen;
+	cbc(true, iv, ciphertext, ciphertext, ciphertext_size);
 
 	//return signed_parts + HMAC::generate(_signing_key, signed_parts)->digest();
-	Bytes sig(HMAC::generate(_signing_key, signed_parts)->digest());
-	TRACE("Token::encrypt: sig:        " + sig.toHex());
-	Bytes token(signed_parts + sig);
-	DEBUG("Token::encrypt: token length: " + std::to_string(token.size()));
-	return token;
+	HMAC hmac(_signing_key);
+	hmac.update(output, IV_SIZE + ciphertext_size);
+	hmac.digest(ciphertext + ciphertext_size);
+	return IV_SIZE + ciphertext_size + HMAC_SIZE;
 }
 
+/*static*/ size_t Token::ciphertext_size(size_t size) {
+	if (size < IV_SIZE + HMAC_SIZE) {
+		throw std::invalid_argument("Cannot decrypt token of only " + std::to_string(size) + " bytes");
+	}
+	return size - IV_SIZE - HMAC_SIZE;
+}
 
 const Bytes Token::decrypt(const Bytes& token) {
+	return decrypt(token.data(), token.size());
+}
 
-	DEBUG("Token::decrypt: token length: " + std::to_string(token.size()));
-	if (token.size() < 48) {
-		throw std::invalid_argument("Cannot decrypt token of only " + std::to_string(token.size()) + " bytes");
-	}
+const Bytes Token::decrypt(const uint8_t* token, size_t size) {
 
-	if (!verify_hmac(token)) {
+	DEBUG("Token::decrypt: token length: " + std::to_string(size));
+	size_t len = ciphertext_size(size);
+
+	if (!verify_hmac(token, size)) {
 		throw std::invalid_argument("Token token HMAC was invalid");
 	}
 
 	//iv = token[:16]
-	Bytes iv = token.left(16);
-	TRACE("Token::decrypt: iv:         " + iv.toHex());
-
 	//ciphertext = token[16:-32]
-	Bytes ciphertext = token.mid(16, token.size()-48);
-	TRACE("Token::decrypt: ciphertext: " + ciphertext.toHex());
-
 	try {
-		Bytes plaintext;
-		if (_mode == MODE_AES_128_CBC) {
-			plaintext = PKCS7::unpad(
-				AES_128_CBC::decrypt(
-					ciphertext,
-					_encryption_key,
-					iv
-				)
-			);
-		}
-		else if (_mode == MODE_AES_256_CBC) {
-			plaintext = PKCS7::unpad(
-				AES_256_CBC::decrypt(
-					ciphertext,
-					_encryption_key,
-					iv
-				)
-			);
-		}
-		else {
-			throw new std::invalid_argument("Invalid token mode "+std::to_string(_mode));
+		if (len == 0 || (len % PKCS7::BLOCKSIZE) != 0) {
+			throw std::runtime_error("Ciphertext is not a whole number of blocks");
 		}
-		DEBUG("Token::encrypt: unpadded plaintext length: " + std::to_string(plaintext.size()));
+		Bytes plaintext;
+		cbc(false, token, plaintext.writable(len), token + IV_SIZE, len);
+		PKCS7::inplace_unpad(plaintext);
 		TRACE("Token::decrypt: plaintext:  " + plaintext.toHex());
-
 		DEBUG("Token::decrypt: plaintext length: " + std::to_string(plaintext.size()));
 		return plaintext;
 	}
@@ -156,4 +150,101 @@ const Bytes Token::decrypt(const Bytes& token) {
 		WARNING("Could not decrypt Token token");
 		throw std::runtime_error("Could not decrypt Token token");
 	}
-}
\ No newline at end of file
+}
+
+void Token::cbc(bool encrypt, const Bytes& iv, uint8_t* output, const uint8_t* input, size_t len) const {
+	cbc(encrypt, iv.data(), output, input, len);
+}
+
+void Token::cbc(bool encrypt, const uint8_t* iv, uint8_t* output, const uint8_t* input, size_t len) const {
+	if (_mode == MODE_AES_128_CBC) {
+		aes_cbc<AES128>(encrypt, _encryption_key, iv, IV_SIZE, output, input, len);
+	}
+	else if (_mode == MODE_AES_256_CBC) {
+		aes_cbc<AES256>(encrypt, _encryption_key, iv, IV_SIZE, output, input, len);
+	}
+	else {
+		throw std::invalid_argument("Invalid token mode "+std::to_string(_mode));
+	}
+}
+
+Token::Encryptor::Encryptor(const Token& token) : _token(token), _hmac(token._signing_key) {
+}
+
+const Bytes Token::Encryptor::begin() {
+	_iv = random(16);
+	_pending.clear();
+	_hmac.update(_iv);
+	return _iv;
+}
+
+const Bytes Token::Encryptor::update(const Bytes& plaintext) {
+	_pending.append(plaintext);
+	size_t len = _pending.size() - (_pending.size() % PKCS7::BLOCKSIZE);
+	if (len == 0) {
+		return {Bytes::NONE};
+	}
+	Bytes ciphertext;
+	_token.cbc(true, _iv, ciphertext.writable(len), _pending.data(), len);
+	// CBC chains on the last ciphertext block, which becomes the iv of the next call
+	_iv = ciphertext.right(PKCS7::BLOCKSIZE);
+	_pending = _pending.mid(len);
+	_hmac.update(ciphertext);
+	return ciphertext;
+}
+
+const Bytes Token::Encryptor::finish() {
+	PKCS7::inplace_pad(_pending);
+	Bytes ciphertext;
+	_token.cbc(true, _iv, ciphertext.writable(_pending.size()), _pending.data(), _pending.size());
+	_pending.clear();
+	_hmac.update(ciphertext);
+	ciphertext.append(_hmac.digest());
+	return ciphertext;
+}
+
+Token::Decryptor::Decryptor(const Token& token) : _token(token), _hmac(token._signing_key) {
+}
+
+const Bytes Token::Decryptor::update(const Bytes& token) {
+	_pending.append(token);
+	if (!_iv) {
+		if (_pending.size() < PKCS7::BLOCKSIZE) {
+			return {Bytes::NONE};
+		}
+		_iv = _pending.left(PKCS7::BLOCKSIZE);
+		_pending = _pending.mid(PKCS7::BLOCKSIZE);
+		_hmac.update(_iv);
+	}
+	// Hold back the HMAC and the final (padded) block
+	if (_pending.size() <= 32 + PKCS7::BLOCKSIZE) {
+		return {Bytes::NONE};
+	}
+	size_t len = _pending.size() - 32 - PKCS7::BLOCKSIZE;
+	len -= (len % PKCS7::BLOCKSIZE);
+	if (len == 0) {
+		return {Bytes::NONE};
+	}
+	Bytes plaintext;
+	_token.cbc(false, _iv, plaintext.writable(len), _pending.data(), len);
+	_hmac.update(_pending.left(len));
+	_iv = _pending.mid(len - PKCS7::BLOCKSIZE, PKCS7::BLOCKSIZE);
+	_pending = _pending.mid(len);
+	return plaintext;
+}
+
+const Bytes Token::Decryptor::finish() {
+	if (!_iv || _pending.size() < 32 + PKCS7::BLOCKSIZE || ((_pending.size() - 32) % PKCS7::BLOCKSIZE) != 0) {
+		throw std::invalid_argument("Cannot decrypt truncated token");
+	}
+	size_t len = _pending.size() - 32;
+	_hmac.update(_pending.left(len));
+	if (_hmac.digest() != _pending.right(32)) {
+		throw std::invalid_argument("Token token HMAC was invalid");
+	}
+	Bytes plaintext;
+	_token.cbc(false, _iv, plaintext.writable(len), _pending.data(), len);
+	_pending.clear();
+	PKCS7::inplace_unpad(plaintext);
+	return plaintext;
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Random.h"
+#include "HMAC.h"
+#include "PKCS7.h"
 #include "../Bytes.h"
 #include "../Type.h"
 
@@ -33,10 +35,71 @@ namespace RNS { namespace Cryptography {
 		Token(const Bytes& key, RNS::Type::Cryptography::Token::token_mode mode = RNS::Type::Cryptography::Token::MODE_AES);
 		~Token();
 
+	public:
+		static const size_t IV_SIZE = 16;
+		static const size_t HMAC_SIZE = 32;
+		// Size of the token for size bytes of plaintext, iv + padded ciphertext + HMAC
+		static inline size_t token_size(size_t size) { return IV_SIZE + (size / PKCS7::BLOCKSIZE + 1) * PKCS7::BLOCKSIZE + HMAC_SIZE; }
+
 	public:
 		bool verify_hmac(const Bytes& token);
+		bool verify_hmac(const uint8_t* token, size_t size);
 		const Bytes encrypt(const Bytes& data);
 		const Bytes decrypt(const Bytes& token);
+		const Bytes decrypt(const uint8_t* token, size_t size);
+
+		// CBA Buffer variants, the token is built and taken apart where it lies.
+		// Encrypts into output, which must hold token_size(size) bytes and must not overlap data,
+		// returns the token size.
+		size_t encrypt(const uint8_t* data, size_t size, uint8_t* output);
+
+	public:
+		/*
+		Incremental token encryption for payloads too large to hold twice in memory.
+		The concatenated output of begin(), every update() and finish() is identical
+		to what encrypt() returns for the concatenated input.
+		*/
+		class Encryptor {
+		public:
+			Encryptor(const Token& token);
+			// Returns the iv that starts the token
+			const Bytes begin();
+			// Returns the ciphertext for every whole block buffered so far
+			const Bytes update(const Bytes& plaintext);
+			// Returns the padded final block(s) followed by the HMAC
+			const Bytes finish();
+		private:
+			const Token& _token;
+			HMAC _hmac;
+			Bytes _iv;
+			Bytes _pending;
+		};
+
+		/*
+		Incremental counterpart of decrypt(). Plaintext is released as soon as the
+		ciphertext covering it has arrived, but the HMAC can only be checked once the
+		whole token has been fed, so callers must not act on released plaintext before
+		finish() returned successfully.
+		*/
+		class Decryptor {
+		public:
+			Decryptor(const Token& token);
+			// Feed token bytes, returns plaintext that can be released (the last block and the HMAC are held back)
+			const Bytes update(const Bytes& token);
+			// Verifies the HMAC and returns the remaining unpadded plaintext, throws if the token is invalid
+			const Bytes finish();
+		private:
+			const Token& _token;
+			HMAC _hmac;
+			Bytes _iv;
+			Bytes _pending;
+		};
+
+	private:
+		void cbc(bool encrypt, const Bytes& iv, uint8_t* output, const uint8_t* input, size_t len) const;
+		void cbc(bool encrypt, const uint8_t* iv, uint8_t* output, const uint8_t* input, size_t len) const;
+		// Ciphertext length of a token of size bytes, throws if the token can't be valid
+		static size_t ciphertext_size(size_t size);
 
 	private:
 		RNS::Type::Cryptography::Token::token_mode _mode = RNS::Type::Cryptography::Token::MODE_AES_256_CBC;
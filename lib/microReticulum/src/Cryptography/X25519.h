@@ -2,8 +2,12 @@
 
 #include "Bytes.h"
 #include "Log.h"
+#include "Backend.h"
+#include "Fast25519.h"
+#include "Random.h"
 
 #include <Curve25519.h>
+#include <RNG.h>
 
 #include <memory>
 #include <stdexcept>
@@ -11,6 +15,36 @@
 
 namespace RNS { namespace Cryptography {
 
+	// CBA Raw entry points, on the backend selected in Backend.h
+	inline void x25519_derive_public_key(uint8_t* public_key, const uint8_t* private_key) {
+#ifdef RNS_CRYPTO_BACKEND_CC310
+		if (CryptoCell::x25519_public_key(public_key, private_key)) return;
+#endif
+#ifdef RNS_CRYPTO_BACKEND_FAST25519
+		Fast25519::x25519_public_key(public_key, private_key);
+#else
+		Curve25519::eval(public_key, private_key, 0);
+#endif
+	}
+
+	// false if the peer key is invalid
+	inline bool x25519_exchange(uint8_t* shared_key, const uint8_t* private_key, const uint8_t* peer_key) {
+#ifdef RNS_CRYPTO_BACKEND_CC310
+		if (CryptoCell::x25519(shared_key, private_key, peer_key)) {
+			uint8_t nonzero = 0;
+			for (int i = 0; i < 32; i++) {
+				nonzero |= shared_key[i];
+			}
+			return nonzero != 0;
+		}
+#endif
+#ifdef RNS_CRYPTO_BACKEND_FAST25519
+		return Fast25519::x25519(shared_key, private_key, peer_key);
+#else
+		return Curve25519::eval(shared_key, private_key, peer_key);
+#endif
+	}
+
 	class X25519PublicKey {
 
 	public:
@@ -79,13 +113,22 @@ namespace RNS { namespace Cryptography {
 				// second param "f" is secret
 				//eval(uint8_t result[32], const uint8_t s[32], const uint8_t x[32])
 				// derive public key from private key
-				Curve25519::eval(_publicKey.writable(32), _privateKey.data(), 0);
+				x25519_derive_public_key(_publicKey.writable(32), _privateKey.data());
 			}
 			else {
 				// create random private key and derive public key
 				// second param "f" is secret
 				//dh1(uint8_t k[32], uint8_t f[32])
+#if defined(RNS_CRYPTO_BACKEND_FAST25519) || defined(RNS_CRYPTO_BACKEND_CC310)
+				// clamped as dh1() does
+				uint8_t* f = _privateKey.writable(32);
+				RandomPool::fill(f, 32);
+				f[0] &= 0xF8;
+				f[31] = (f[31] & 0x7F) | 0x40;
+				x25519_derive_public_key(_publicKey.writable(32), f);
+#else
 				Curve25519::dh1(_publicKey.writable(32), _privateKey.writable(32));
+#endif
 			}
 		}
 		~X25519PrivateKey() {}
@@ -174,7 +217,7 @@ namespace RNS { namespace Cryptography {
 			DEBUG("X25519PublicKey::exchange: peer public key:  " + peer_public_key.toHex());
 			DEBUG("X25519PublicKey::exchange: pre private key:  " + _privateKey.toHex());
 			Bytes sharedKey;
-			if (!Curve25519::eval(sharedKey.writable(32), _privateKey.data(), peer_public_key.data())) {
+			if (peer_public_key.size() != 32 || !x25519_exchange(sharedKey.writable(32), _privateKey.data(), peer_public_key.data())) {
 				throw std::runtime_error("Peer key is invalid");
 			}
 			DEBUG("X25519PublicKey::exchange: shared key:       " + sharedKey.toHex());
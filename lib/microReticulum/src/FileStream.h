@@ -30,6 +30,8 @@ namespace RNS {
 		virtual const char* name() = 0;
 		virtual size_t size() = 0;
 		virtual void close() = 0;
+		// Optional, implementations that can't reposition report failure
+		virtual bool seek(size_t position) { return false; }
 
 		// Print overrides
 		virtual size_t write(uint8_t byte) = 0;
@@ -113,6 +115,7 @@ namespace RNS {
 		inline const char* name() { assert(_impl); return _impl->name(); }
 		inline size_t size() { assert(_impl); return _impl->size(); }
 		inline void close() { assert(_impl); _impl->close(); }
+		inline bool seek(size_t position) { assert(_impl); return _impl->seek(position); }
 
 		// Print overrides
 		inline size_t write(uint8_t byte) { assert(_impl); _crc = Utilities::Crc::crc32(_crc, byte); return _impl->write(byte); }
@@ -34,6 +34,8 @@ namespace RNS {
 		virtual std::list<std::string> list_directory(const char* directory_path) = 0;
 		virtual size_t storage_size() = 0;
 		virtual size_t storage_available() = 0;
+		// Writes buffered by the implementation reach storage before this returns
+		virtual void sync() {}
 
 	friend class FileSystem;
 	};
@@ -106,6 +108,7 @@ namespace RNS {
 		inline std::list<std::string> list_directory(const char* directory_path) { assert(_impl); return _impl->list_directory(directory_path); }
 		inline size_t storage_size() { assert(_impl); return _impl->storage_size(); }
 		inline size_t storage_available() { assert(_impl); return _impl->storage_available(); }
+		inline void sync() { assert(_impl); _impl->sync(); }
 
 	private:
 		std::list<std::string> _empty;
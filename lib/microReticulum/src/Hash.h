@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Bytes.h"
+#include "Type.h"
+
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+namespace RNS {
+
+	// CBA Fixed-size hash value with inline storage, for use as table key.
+	//
+	// A Bytes key costs a shared heap buffer and every comparison in a std::map or
+	// std::set dereferences both sides before calling memcmp. FixedHash holds the N
+	// hash bytes in 64-bit words inside the object, so it is trivially copyable,
+	// compares in N/8 word compares and hashes by its first word (hashes are uniformly
+	// distributed already).
+	//
+	// It converts implicitly from and to Bytes so that call sites passing Bytes keep
+	// working; a Bytes of another size is truncated or zero padded. Ordering is by
+	// native-endian words, consistent but not the lexicographic order of the bytes.
+	template <size_t N>
+	class FixedHash {
+
+		static_assert(N > 0 && (N % sizeof(uint64_t)) == 0, "FixedHash size must be a multiple of 8 bytes");
+
+	public:
+		static const size_t SIZE = N;
+		static const size_t WORDS = N / sizeof(uint64_t);
+
+	public:
+		FixedHash() { memset(_words, 0, sizeof(_words)); }
+		FixedHash(const Bytes& bytes) { assign(bytes.data(), bytes.size()); }
+		explicit FixedHash(const uint8_t* data) { memcpy(_words, data, N); }
+		FixedHash(const uint8_t* data, size_t size) { assign(data, size); }
+
+		inline void assign(const uint8_t* data, size_t size) {
+			if (data == nullptr || size > N) {
+				size = (data == nullptr) ? 0 : N;
+			}
+			if (size < N) {
+				memset(_words, 0, sizeof(_words));
+			}
+			if (size > 0) {
+				memcpy(_words, data, size);
+			}
+		}
+
+		inline bool operator==(const FixedHash& other) const {
+			for (size_t i = 0; i < WORDS; i++) {
+				if (_words[i] != other._words[i]) return false;
+			}
+			return true;
+		}
+		inline bool operator!=(const FixedHash& other) const { return !(*this == other); }
+		inline bool operator<(const FixedHash& other) const {
+			for (size_t i = 0; i < WORDS; i++) {
+				if (_words[i] != other._words[i]) return _words[i] < other._words[i];
+			}
+			return false;
+		}
+
+		inline operator Bytes() const { return {data(), N}; }
+		inline Bytes bytes() const { return {data(), N}; }
+		inline const uint8_t* data() const { return (const uint8_t*)_words; }
+		inline size_t size() const { return N; }
+		inline size_t hash() const { return (size_t)_words[0]; }
+		inline std::string toHex(bool upper = false) const { return bytes().toHex(upper); }
+
+	private:
+		uint64_t _words[WORDS];
+
+	};
+
+	// Destination hashes, link ids, truncated packet hashes
+	using TruncatedHash = FixedHash<Type::Reticulum::TRUNCATED_HASHLENGTH/8>;
+	// Full packet hashes, identity hashes, tunnel ids
+	using FullHash = FixedHash<Type::Reticulum::HASHLENGTH/8>;
+
+	static_assert(std::is_trivially_copyable<TruncatedHash>::value, "TruncatedHash must be trivially copyable");
+	static_assert(std::is_trivially_copyable<FullHash>::value, "FullHash must be trivially copyable");
+
+}
+
+namespace std {
+	template <size_t N>
+	struct hash<RNS::FixedHash<N>> {
+		inline size_t operator()(const RNS::FixedHash<N>& value) const { return value.hash(); }
+	};
+}
@@ -5,8 +5,10 @@
 #include "Packet.h"
 #include "Log.h"
 #include "Utilities/OS.h"
+#include "Utilities/KnownDestinationStore.h"
 #include "Cryptography/Ed25519.h"
 #include "Cryptography/X25519.h"
+#include "Cryptography/KeyPool.h"
 #include "Cryptography/HKDF.h"
 #include "Cryptography/Token.h"
 #include "Cryptography/Random.h"
@@ -19,12 +21,21 @@ using namespace RNS::Type::Identity;
 using namespace RNS::Cryptography;
 using namespace RNS::Utilities;
 
-/*static*/ std::map<Bytes, Identity::IdentityEntry> Identity::_known_destinations;
+/*static*/ Identity::KnownDestinations Identity::_known_destinations;
 /*static*/ bool Identity::_saving_known_destinations = false;
+/*static*/ std::set<TruncatedHash> Identity::_known_destinations_changed;
+/*static*/ std::set<TruncatedHash> Identity::_known_destinations_removed;
+// CBA Append-only known destinations file
+static Utilities::KnownDestinationStore _known_destinations_store;
 // CBA
 // CBA ACCUMULATES
 /*static*/ //uint16_t Identity::_known_destinations_maxsize = 100;
 /*static*/ uint16_t Identity::_known_destinations_maxsize = 100;
+/*static*/ Utilities::HashTable<bool> Identity::_verified_announces(VERIFIED_ANNOUNCES_MAXSIZE);
+/*static*/ Utilities::HashTable<Bytes> Identity::_announce_keys(ANNOUNCE_KEYS_MAXSIZE);
+/*static*/ Utilities::HashTable<Identity> Identity::_recalled_identities(RECALLED_IDENTITIES_MAXSIZE);
+/*static*/ uint32_t Identity::_announces_verified = 0;
+/*static*/ uint32_t Identity::_announces_cached = 0;
 
 Identity::Identity(bool create_keys /*= true*/) : _object(new Object()) {
 	if (create_keys) {
@@ -195,8 +206,13 @@ Can be used to load previously created and saved identities into Reticulum.
 	}
 	else {
 		//p _known_destinations[destination_hash] = {OS::time(), packet_hash, public_key, app_data};
+		RNS_ALLOC_SCOPE(TAG_KNOWN_DESTINATIONS);
 		// CBA ACCUMULATES
-		_known_destinations.insert({destination_hash, {OS::time(), packet_hash, public_key, app_data}});
+		// Replace any existing entry so that the stored app data and timestamp are the latest heard
+		_known_destinations.insert_or_assign(destination_hash, IdentityEntry(OS::time(), packet_hash, public_key, app_data));
+		_recalled_identities.erase(destination_hash);
+		_known_destinations_changed.insert(destination_hash);
+		_known_destinations_removed.erase(destination_hash);
 	}
 }
 
@@ -211,10 +227,16 @@ Recall identity for a destination hash.
 	auto iter = _known_destinations.find(destination_hash);
 	if (iter != _known_destinations.end()) {
 		TRACE("Identity::recall: Found identity entry for destination " + destination_hash.toHex());
+		// CBA Reuse the identity built by an earlier recall rather than loading the public keys again
+		auto recalled_iter = _recalled_identities.find(destination_hash);
+		if (recalled_iter != _recalled_identities.end()) {
+			return (*recalled_iter).second.clone();
+		}
 		const IdentityEntry& identity_data = (*iter).second;
 		Identity identity(false);
 		identity.load_public_key(identity_data._public_key);
 		identity.app_data(identity_data._app_data);
+		_recalled_identities.insert_or_assign(destination_hash, identity.clone());
 		return identity;
 	}
 	else {
@@ -253,116 +275,92 @@ Recall last heard app_data for a destination hash.
 }
 
 /*static*/ bool Identity::save_known_destinations() {
-	// TODO: Improve the storage method so we don't have to
-	// deserialize and serialize the entire table on every
-	// save, but the only changes. It might be possible to
-	// simply overwrite on exit now that every local client
-	// disconnect triggers a data persist.
+	// CBA Only destinations remembered or culled since the last save are appended to the
+	// known destinations file (see Utilities/KnownDestinationStore.h), so a save costs a
+	// few small writes instead of rewriting the whole table. A save that is still running
+	// is not waited for, the changes stay pending until the next one.
+	if (_saving_known_destinations) {
+		DEBUG("Skipping save of known destinations, previous save operation is still running");
+		return false;
+	}
 
 	bool success = false;
+#if defined(RNS_USE_FS)
 	try {
-		if (_saving_known_destinations) {
-			double wait_interval = 0.2;
-			double wait_timeout = 5;
-			double wait_start = OS::time();
-			while (_saving_known_destinations) {
-				OS::sleep(wait_interval);
-				if (OS::time() > (wait_start + wait_timeout)) {
-					ERROR("Could not save known destinations to storage, waiting for previous save operation timed out.");
-					return false;
-				}
-			}
-		}
-
 		_saving_known_destinations = true;
 		double save_start = OS::time();
 
-		std::map<Bytes, IdentityEntry> storage_known_destinations;
-// TODO
-/*
-		if os.path.isfile(RNS.Reticulum.storagepath+"/known_destinations"):
-			try:
-				file = open(RNS.Reticulum.storagepath+"/known_destinations","rb")
-				storage_known_destinations = umsgpack.load(file)
-				file.close()
-			except:
-				pass
-*/
+		char known_destinations_path[Type::Reticulum::FILEPATH_MAXSIZE];
+		snprintf(known_destinations_path, Type::Reticulum::FILEPATH_MAXSIZE, "%s/known_destinations", Reticulum::_storagepath);
+		if (_known_destinations_store.save(known_destinations_path, _known_destinations, _known_destinations_changed, _known_destinations_removed)) {
+			_known_destinations_changed.clear();
+			_known_destinations_removed.clear();
 
-		for (auto& [destination_hash, identity_entry] : storage_known_destinations) {
-			if (_known_destinations.find(destination_hash) == _known_destinations.end()) {
-				//_known_destinations[destination_hash] = storage_known_destinations[destination_hash];
-				//_known_destinations[destination_hash] = identity_entry;
-				// CBA ACCUMULATES
-				_known_destinations.insert({destination_hash, identity_entry});
+			std::string time_str;
+			double save_time = OS::time() - save_start;
+			if (save_time < 1) {
+				time_str = std::to_string((int)(save_time*1000)) + " ms";
 			}
-		}
-
-// TODO
-/*
-		DEBUG("Saving " + std::to_string(_known_destinations.size()) + " known destinations to storage...");
-		file = open(RNS.Reticulum.storagepath+"/known_destinations","wb")
-		umsgpack.dump(Identity.known_destinations, file)
-		file.close()
-*/
-
-		std::string time_str;
-		double save_time = OS::time() - save_start;
-		if (save_time < 1) {
-			time_str = std::to_string((int)(save_time*1000)) + " ms";
+			else {
+				time_str = std::to_string(OS::round(save_time, 1)) + " s";
+			}
+			DEBUG("Saved known destinations to storage in " + time_str + " (" + std::to_string(_known_destinations_store.records()) + " records)");
+			success = true;
 		}
 		else {
-			time_str = std::to_string(OS::round(save_time, 1)) + " s";
+			ERROR("Could not save known destinations to storage");
 		}
-
-		DEBUG("Saved known destinations to storage in " + time_str);
-
-		success = true;
 	}
 	catch (std::exception& e) {
 		ERRORF("Error while saving known destinations to disk, the contained exception was: %s", e.what());
 	}
-
 	_saving_known_destinations = false;
+#endif
 
 	return success;
 }
 
 /*static*/ void Identity::load_known_destinations() {
-// TODO
-/*
-	if os.path.isfile(RNS.Reticulum.storagepath+"/known_destinations"):
-		try:
-			file = open(RNS.Reticulum.storagepath+"/known_destinations","rb")
-			loaded_known_destinations = umsgpack.load(file)
-			file.close()
-
-			Identity.known_destinations = {}
-			for known_destination in loaded_known_destinations:
-				if len(known_destination) == RNS.Reticulum.TRUNCATED_HASHLENGTH//8:
-					Identity.known_destinations[known_destination] = loaded_known_destinations[known_destination]
-
-			RNS.log("Loaded "+str(len(Identity.known_destinations))+" known destination from storage", RNS.LOG_VERBOSE)
-		except:
-			RNS.log("Error loading known destinations from disk, file will be recreated on exit", RNS.LOG_ERROR)
-	else:
-		RNS.log("Destinations file does not exist, no known destinations loaded", RNS.LOG_VERBOSE)
-*/
-
+#if defined(RNS_USE_FS)
+	try {
+		char known_destinations_path[Type::Reticulum::FILEPATH_MAXSIZE];
+		snprintf(known_destinations_path, Type::Reticulum::FILEPATH_MAXSIZE, "%s/known_destinations", Reticulum::_storagepath);
+		if (OS::file_exists(known_destinations_path)) {
+			_known_destinations.clear();
+			_recalled_identities.clear();
+			RNS_ALLOC_SCOPE(TAG_KNOWN_DESTINATIONS);
+			size_t loaded = _known_destinations_store.load(known_destinations_path, _known_destinations);
+			_known_destinations_changed.clear();
+			_known_destinations_removed.clear();
+			VERBOSE("Loaded " + std::to_string(loaded) + " known destinations from storage");
+			cull_known_destinations();
+		}
+		else {
+			VERBOSE("Destinations file does not exist, no known destinations loaded");
+		}
+	}
+	catch (std::exception& e) {
+		ERRORF("Error loading known destinations from disk, file will be recreated on exit. The contained exception was: %s", e.what());
+	}
+#endif
 }
 
 /*static*/ void Identity::cull_known_destinations() {
+	cull_known_destinations(_known_destinations_maxsize);
+}
+
+/*static*/ size_t Identity::cull_known_destinations(uint16_t maxsize) {
 	TRACE("Transport::cull_path_table()");
-	if (_known_destinations.size() > _known_destinations_maxsize) {
+	uint16_t count = 0;
+	if (_known_destinations.size() > maxsize) {
 		// prune by age
-		uint16_t count = 0;
-		std::vector<std::pair<Bytes, IdentityEntry>> sorted_pairs;
+		std::vector<std::pair<TruncatedHash, IdentityEntry>> sorted_pairs;
 		// Copy key/value pairs from map into vector
-		std::for_each(_known_destinations.begin(), _known_destinations.end(), [&](const std::pair<const Bytes, IdentityEntry>& ref) {
+		std::for_each(_known_destinations.begin(), _known_destinations.end(), [&](const std::pair<const TruncatedHash, IdentityEntry>& ref) {
 			sorted_pairs.push_back(ref);
 		});
 		// Sort vector using specified comparator
-		std::sort(sorted_pairs.begin(), sorted_pairs.end(), [](const std::pair<Bytes, IdentityEntry> &left, const std::pair<Bytes, IdentityEntry> &right) {
+		std::sort(sorted_pairs.begin(), sorted_pairs.end(), [](const std::pair<TruncatedHash, IdentityEntry> &left, const std::pair<TruncatedHash, IdentityEntry> &right) {
 			return left.second._timestamp < right.second._timestamp;
 		});
 		// Iterate vector of sorted values
@@ -372,13 +370,23 @@ Recall last heard app_data for a destination hash.
 			if (_known_destinations.erase(destination_hash) < 1) {
 				WARNING("Failed to remove destination " + destination_hash.toHex() + " from known destinations");
 			}
+			_recalled_identities.erase(destination_hash);
+			_known_destinations_changed.erase(destination_hash);
+			_known_destinations_removed.insert(destination_hash);
 			++count;
-			if (_known_destinations.size() <= _known_destinations_maxsize) {
+			if (_known_destinations.size() <= maxsize) {
 				break;
 			}
 		}
 		DEBUG("Removed " + std::to_string(count) + " path(s) from known destinations");
 	}
+	return count;
+}
+
+/*static*/ size_t Identity::clear_recalled_identities() {
+	size_t count = _recalled_identities.size();
+	_recalled_identities.clear();
+	return count;
 }
 
 /*static*/ bool Identity::validate_announce(const Packet& packet) {
@@ -409,16 +417,45 @@ Recall last heard app_data for a destination hash.
 				app_data.clear();
 			}
 
-			Identity announced_identity(false);
-			announced_identity.load_public_key(public_key);
-
-			if (announced_identity.pub() && announced_identity.validate(signature, signed_data)) {
-				Bytes hash_material = name_hash << announced_identity.hash();
-				Bytes expected_hash = full_hash(hash_material).left(Type::Reticulum::TRUNCATED_HASHLENGTH/8);
-				//TRACE("Identity::validate_announce: destination_hash: " + packet.destination_hash().toHex());
-				//TRACE("Identity::validate_announce: expected_hash:    " + expected_hash.toHex());
+			// CBA The announce hash covers the destination hash and all of the signed data, so a
+			// duplicate of an announce that was already checked has the same outcome. Only the
+			// signature and destination hash checks are cached, the known key check below is not.
+			bool signature_valid = false;
+			bool destination_valid = false;
+			auto verified_iter = _verified_announces.find(packet.get_hash());
+			if (verified_iter != _verified_announces.end()) {
+				++_announces_cached;
+				signature_valid = (*verified_iter).second;
+				destination_valid = signature_valid;
+			}
+			else {
+				++_announces_verified;
+				auto key_iter = _announce_keys.find(destination_hash);
+				if (key_iter != _announce_keys.end() && (*key_iter).second == public_key) {
+					// Destination hash was already checked against this key, only the signature is new
+					signature_valid = (signature.size() == SIGLENGTH/8 && Cryptography::ed25519_verify(signature.data(), public_key.data() + KEYSIZE/8/2, signed_data.data(), signed_data.size()));
+					destination_valid = signature_valid;
+				}
+				else {
+					Identity announced_identity(false);
+					announced_identity.load_public_key(public_key);
+					if (announced_identity.pub() && announced_identity.validate(signature, signed_data)) {
+						signature_valid = true;
+						Bytes hash_material = name_hash << announced_identity.hash();
+						Bytes expected_hash = full_hash(hash_material).left(Type::Reticulum::TRUNCATED_HASHLENGTH/8);
+						//TRACE("Identity::validate_announce: destination_hash: " + packet.destination_hash().toHex());
+						//TRACE("Identity::validate_announce: expected_hash:    " + expected_hash.toHex());
+						destination_valid = (packet.destination_hash() == expected_hash);
+						if (destination_valid) {
+							_announce_keys.insert_or_assign(destination_hash, public_key);
+						}
+					}
+				}
+				_verified_announces.insert_or_assign(packet.get_hash(), destination_valid);
+			}
 
-				if (packet.destination_hash() == expected_hash) {
+			if (signature_valid) {
+				if (destination_valid) {
 					// Check if we already have a public key for this destination
 					// and make sure the public key is not different.
 					auto iter = _known_destinations.find(packet.destination_hash());
@@ -503,7 +540,7 @@ const Bytes Identity::encrypt(const Bytes& plaintext) const {
 	if (!_object->_pub) {
 		throw std::runtime_error("Encryption failed because identity does not hold a public key");
 	}
-	Cryptography::X25519PrivateKey::Ptr ephemeral_key = Cryptography::X25519PrivateKey::generate();
+	Cryptography::X25519PrivateKey::Ptr ephemeral_key = Cryptography::X25519KeyPool::take();
 	Bytes ephemeral_pub_bytes = ephemeral_key->public_key()->public_bytes();
 	TRACE("Identity::encrypt: ephemeral public key: " + ephemeral_pub_bytes.toHex());
 
@@ -523,10 +560,15 @@ const Bytes Identity::encrypt(const Bytes& plaintext) const {
 	Cryptography::Token token(derived_key);
 	TRACE("Identity::encrypt: Token encrypting data of length " + std::to_string(plaintext.size()));
 	TRACE("Identity::encrypt: plaintext:  " + plaintext.toHex());
-	Bytes ciphertext = token.encrypt(plaintext);
+	// CBA Token written straight behind the ephemeral key, one allocation for the whole result
+	Bytes ciphertext;
+	size_t pub_size = ephemeral_pub_bytes.size();
+	uint8_t* output = ciphertext.writable(pub_size + Cryptography::Token::token_size(plaintext.size()));
+	memcpy(output, ephemeral_pub_bytes.data(), pub_size);
+	token.encrypt(plaintext.data(), plaintext.size(), output + pub_size);
 	TRACE("Identity::encrypt: ciphertext: " + ciphertext.toHex());
 
-	return ephemeral_pub_bytes + ciphertext;
+	return ciphertext;
 }
 
 
@@ -570,10 +612,10 @@ const Bytes Identity::decrypt(const Bytes& ciphertext_token) const {
 
 		Cryptography::Token token(derived_key);
 		//ciphertext = ciphertext_token[Identity.KEYSIZE//8//2:]
-		Bytes ciphertext(ciphertext_token.mid(Type::Identity::KEYSIZE/8/2));
-		TRACE("Identity::decrypt: Token decrypting data of length " + std::to_string(ciphertext.size()));
-		TRACE("Identity::decrypt: ciphertext: " + ciphertext.toHex());
-		plaintext = token.decrypt(ciphertext);
+		const uint8_t* ciphertext = ciphertext_token.data() + Type::Identity::KEYSIZE/8/2;
+		size_t ciphertext_size = ciphertext_token.size() - Type::Identity::KEYSIZE/8/2;
+		TRACE("Identity::decrypt: Token decrypting data of length " + std::to_string(ciphertext_size));
+		plaintext = token.decrypt(ciphertext, ciphertext_size);
 		TRACE("Identity::decrypt: plaintext:  " + plaintext.toHex());
 		//TRACE("Identity::decrypt: Token decrypted data of length " + std::to_string(plaintext.size()));
 	}
@@ -2,13 +2,17 @@
 
 #include "Log.h"
 #include "Bytes.h"
+#include "Hash.h"
 #include "Type.h"
 #include "Cryptography/Hashes.h"
 #include "Cryptography/Ed25519.h"
 #include "Cryptography/X25519.h"
 #include "Cryptography/Token.h"
+#include "Utilities/PlacedAllocator.h"
+#include "Utilities/HashTable.h"
 
 #include <map>
+#include <set>
 #include <string>
 #include <memory>
 #include <cassert>
@@ -20,7 +24,7 @@ namespace RNS {
 
 	class Identity {
 
-	private:
+	public:
 		class IdentityEntry {
 		public:
 			IdentityEntry(double timestamp, const Bytes& packet_hash, const Bytes& public_key, const Bytes& app_data) :
@@ -36,12 +40,30 @@ namespace RNS {
 			Bytes _public_key;
 			Bytes _app_data;
 		};
+		using KnownDestinations = Utilities::PlacedMap<TruncatedHash, IdentityEntry, Utilities::OS::PLACE_COLD>;
 
 	public:
-		static std::map<Bytes, IdentityEntry> _known_destinations;
+		// CBA Only read on recall, so kept in PSRAM where present and allowed to grow larger
+		static KnownDestinations _known_destinations;
 		static bool _saving_known_destinations;
+		// CBA Destinations remembered or culled since the last save, only these are appended to storage
+		static std::set<TruncatedHash> _known_destinations_changed;
+		static std::set<TruncatedHash> _known_destinations_removed;
 		// CBA
 		static uint16_t _known_destinations_maxsize;
+		inline static uint16_t known_destinations_maxsize() { return _known_destinations_maxsize; }
+		inline static void known_destinations_maxsize(uint16_t known_destinations_maxsize) { _known_destinations_maxsize = known_destinations_maxsize; }
+		// CBA Announce hash -> signature and destination hash valid, so duplicates of an announce are verified once
+		static Utilities::HashTable<bool> _verified_announces;
+		// CBA Destination hash -> public key of announces that verified, re-announces from a known binding skip the destination hash check
+		static Utilities::HashTable<Bytes> _announce_keys;
+		// CBA Destination hash -> Identity built by recall(), dropped whenever the known destination changes.
+		// Callers are handed a clone so one of them changing it leaves the cached copy untouched.
+		static Utilities::HashTable<Identity> _recalled_identities;
+		static uint32_t _announces_verified;
+		static uint32_t _announces_cached;
+		inline static uint32_t announces_verified() { return _announces_verified; }
+		inline static uint32_t announces_cached() { return _announces_cached; }
 
 	public:
 		Identity(bool create_keys = true);
@@ -115,6 +137,9 @@ namespace RNS {
 		static void load_known_destinations();
 		// CBA
 		static void cull_known_destinations();
+		// CBA Memory pressure shedding, each returns the number of entries dropped
+		static size_t cull_known_destinations(uint16_t maxsize);
+		static size_t clear_recalled_identities();
 
 		/*
 		Get a SHA-256 hash of passed data.
@@ -195,6 +220,15 @@ namespace RNS {
 		};
 		std::shared_ptr<Object> _object;
 
+		// CBA Separate Identity holding the same state, the immutable key objects are shared
+		inline Identity clone() const {
+			Identity identity(Type::NONE);
+			if (_object) {
+				identity._object = std::make_shared<Object>(*_object);
+			}
+			return identity;
+		}
+
 	};
 
 }
\ No newline at end of file
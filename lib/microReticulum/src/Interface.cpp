@@ -5,9 +5,13 @@
 #include "Reticulum.h"
 #include "Cryptography/Hashes.h"
 #include "Cryptography/HKDF.h"
+#include "Utilities/OS.h"
+
+#include <algorithm>
 
 using namespace RNS;
 using namespace RNS::Type::Interface;
+using namespace RNS::Utilities;
 
 /*static*/ uint8_t Interface::DISCOVER_PATHS_FOR = MODE_ACCESS_POINT | MODE_GATEWAY;
 
@@ -49,24 +53,27 @@ void Interface::setup_ifac(const char* ifac_netname, const char* ifac_netkey) {
 	Identity ifac_id(false);  // don't auto-generate keys
 	ifac_id.load_private_key(_impl->_ifac_key);
 	_impl->_ifac_id = ifac_id;
+	_impl->_ifac.setup(_impl->_ifac_key, ifac_id.signingPrivateKey(), ifac_id.signingPublicKey());
 
 	// Set _ifac_identity to non-empty to flag IFAC as enabled
 	// (Transport checks this with operator bool)
 	_impl->_ifac_identity = ifac_id.get_public_key();
 
-	TRACE("Interface::setup_ifac: IFAC configured, ifac_size=" + std::to_string(_impl->_ifac_size));
+	TRACE("Interface::setup_ifac: IFAC configured, ifac_size=" + std::to_string(_impl->_ifac.size()));
 }
 
 void InterfaceImpl::handle_outgoing(const Bytes& data) {
 	//TRACE("InterfaceImpl.handle_outgoing: data: " + data.toHex());
 	TRACE("InterfaceImpl.handle_outgoing");
 	_txb += data.size();
+	++_txp;
 }
 
 void InterfaceImpl::handle_incoming(const Bytes& data) {
 	//TRACE("InterfaceImpl.handle_incoming: data: " + data.toHex());
 	TRACE("InterfaceImpl.handle_incoming");
 	_rxb += data.size();
+	++_rxp;
 	// Create temporary Interface encapsulating our own shared impl
 	std::shared_ptr<InterfaceImpl> self = shared_from_this();
 	Interface interface(self);
@@ -74,6 +81,32 @@ void InterfaceImpl::handle_incoming(const Bytes& data) {
 	Transport::inbound(data, interface);
 }
 
+void InterfaceImpl::throughput_sample(size_t bytes, double seconds) {
+	if (bytes == 0 || seconds <= 0.0) {
+		return;
+	}
+	uint32_t sample = (uint32_t)std::min((double)bytes * 8.0 / seconds, (double)UINT32_MAX);
+	_measured_bitrate = (_measured_bitrate == 0) ? sample : (uint32_t)(((uint64_t)_measured_bitrate * 3 + sample) / 4);
+}
+
+void InterfaceImpl::rtt_sample(double seconds) {
+	if (seconds <= 0.0) {
+		return;
+	}
+	uint32_t sample = (uint32_t)std::min(seconds * 1000000.0, (double)UINT32_MAX);
+	uint32_t rtt = _rtt_us.load(std::memory_order_relaxed);
+	_rtt_us.store((rtt == 0) ? sample : (uint32_t)(((uint64_t)rtt * 3 + sample) / 4), std::memory_order_relaxed);
+}
+
+double Interface::transfer_time(size_t size) const {
+	assert(_impl);
+	uint32_t bitrate = effective_bitrate();
+	if (bitrate == 0) {
+		return 0.0;
+	}
+	return rtt() + ((double)size * 8.0 / (double)bitrate);
+}
+
 void Interface::handle_incoming(const Bytes& data) {
 	//TRACE("Interface.handle_incoming: data: " + data.toHex());
 	TRACE("Interface.handle_incoming");
@@ -131,6 +164,114 @@ void Interface::process_announce_queue() {
 			RNS.log("Error while processing announce queue on "+str(self)+". The contained exception was: "+str(e), RNS.LOG_ERROR)
 			RNS.log("The announce queue for this interface has been cleared.", RNS.LOG_ERROR)
 */
+	assert(_impl);
+	// CBA Nothing to do while the interface has refused a frame and not yet signalled writable()
+	if (_impl->_announce_queue.size() == 0 || _impl->_send_blocked) {
+		return;
+	}
+	try {
+		double now = OS::time();
+		while (_impl->_announce_queue.size() > 0 && announce_refill()) {
+			// Fewest hops first, oldest first among equal hops, dropping stale announces on the way
+			auto selected = _impl->_announce_queue.end();
+			for (auto iter = _impl->_announce_queue.begin(); iter != _impl->_announce_queue.end(); ) {
+				const AnnounceEntry& entry = (*iter).second;
+				if (now > (entry._time + Type::Reticulum::QUEUED_ANNOUNCE_LIFE)) {
+					iter = _impl->_announce_queue.erase(iter);
+					++_impl->_announces_dropped;
+					continue;
+				}
+				if (selected == _impl->_announce_queue.end() || entry._hops < (*selected).second._hops || (entry._hops == (*selected).second._hops && entry._time < (*selected).second._time)) {
+					selected = iter;
+				}
+				++iter;
+			}
+			if (selected == _impl->_announce_queue.end()) {
+				break;
+			}
+			Bytes raw((*selected).second._raw);
+			// Stays queued until the interface has room for it, unless the interface refuses it
+			// without backpressure, then it will never fit and is dropped
+			if (!_impl->can_send(raw)) {
+				if (_impl->backpressured()) {
+					_impl->_send_blocked = true;
+					break;
+				}
+				_impl->_announce_queue.erase(selected);
+				++_impl->_announces_dropped;
+				continue;
+			}
+			_impl->_announce_queue.erase(selected);
+			announce_spend(raw.size());
+			TRACE("Sending queued announce (" + std::to_string(_impl->_announce_queue.size()) + " remaining) on " + toString());
+			Transport::transmit(*this, raw);
+		}
+	}
+	catch (std::exception& e) {
+		_impl->_announce_queue.clear();
+		ERROR("Error while processing announce queue on " + toString() + ". The contained exception was: " + e.what());
+		ERROR("The announce queue for this interface has been cleared.");
+	}
+}
+
+void Interface::queue_announce(const Bytes& destination, double time, uint8_t hops, uint64_t emitted, const Bytes& raw) {
+	assert(_impl);
+	auto iter = _impl->_announce_queue.find(destination);
+	if (iter != _impl->_announce_queue.end()) {
+		AnnounceEntry& entry = (*iter).second;
+		if (emitted > entry._emitted) {
+			entry._time = time;
+			entry._hops = hops;
+			entry._emitted = emitted;
+			entry._raw = raw;
+			++_impl->_announces_replaced;
+		}
+		return;
+	}
+	if (_impl->_announce_queue.size() >= Type::Interface::ANNOUNCE_QUEUE_MAXSIZE) {
+		// Full, make room by dropping the most distant announce if this one is closer
+		auto worst = _impl->_announce_queue.begin();
+		for (auto it = _impl->_announce_queue.begin(); it != _impl->_announce_queue.end(); ++it) {
+			if ((*it).second._hops > (*worst).second._hops || ((*it).second._hops == (*worst).second._hops && (*it).second._time < (*worst).second._time)) {
+				worst = it;
+			}
+		}
+		++_impl->_announces_dropped;
+		if ((*worst).second._hops <= hops) {
+			return;
+		}
+		_impl->_announce_queue.erase(worst);
+	}
+	// CBA ACCUMULATES
+	_impl->_announce_queue.insert({destination, AnnounceEntry(destination, time, hops, emitted, raw)});
+}
+
+bool Interface::announce_spend(size_t size) {
+	assert(_impl);
+	if (!announce_refill()) {
+		return false;
+	}
+	if (_impl->_bitrate > 0 && _impl->_announce_cap > 0) {
+		double rate = _impl->_bitrate * _impl->_announce_cap;
+		_impl->_announce_tokens -= size * 8;
+		_impl->_announce_allowed_at = _impl->_announce_tokens_at + ((_impl->_announce_tokens < 0) ? (-_impl->_announce_tokens / rate) : 0);
+	}
+	return true;
+}
+
+// Top up the token bucket for the time elapsed, true if announces may be sent now
+bool Interface::announce_refill() {
+	if (_impl->_bitrate == 0 || _impl->_announce_cap <= 0) {
+		// no cap
+		return true;
+	}
+	double now = OS::time();
+	double rate = _impl->_bitrate * _impl->_announce_cap;
+	if (_impl->_announce_tokens_at > 0 && now > _impl->_announce_tokens_at) {
+		_impl->_announce_tokens = std::min(_impl->_announce_tokens + (now - _impl->_announce_tokens_at) * rate, (double)Type::Interface::ANNOUNCE_BURST * 8);
+	}
+	_impl->_announce_tokens_at = now;
+	return _impl->_announce_tokens >= 0;
 }
 
 /*
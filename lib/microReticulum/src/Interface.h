@@ -4,11 +4,14 @@
 #include "Log.h"
 #include "Bytes.h"
 #include "Type.h"
+#include "Utilities/HashTable.h"
+#include "Cryptography/Ifac.h"
 
 #include <ArduinoJson.h>
 
 #include <list>
 #include <memory>
+#include <atomic>
 #include <cassert>
 #include <stdint.h>
 
@@ -49,14 +52,35 @@ namespace RNS {
 
 		// CBA Virtual override method for custom interface to send outgoing data
 		virtual void send_outgoing(const Bytes& data) = 0;
+		// CBA Backpressure. False if send_outgoing() would have to drop data, a whole frame is
+		// either queued or refused before anything is committed. An interface that overrides
+		// this must call writable() once it has room again, until then its queued announces
+		// are held. May be called from the transport task while the interface drains its
+		// queue, so the answer is advisory and send_outgoing() still refuses what doesn't fit.
+		virtual bool can_send(const Bytes& data) const { return true; }
+		// Frames waiting in the interface's own transmit queue
+		virtual uint16_t queue_depth() const { return 0; }
+		// True while the interface refuses frames for a reason writable() will end even with
+		// an empty queue (the LoRa interface during a radio reconfiguration)
+		virtual bool tx_held() const { return false; }
+		// A refusal now is backpressure to wait out rather than a frame that can never go
+		inline bool backpressured() const { return queue_depth() > 0 || tx_held(); }
+		inline void writable() { _send_blocked = false; }
 		
 		// CBA Internal method to handle housekeeping for data going out on interface
 		void handle_outgoing(const Bytes& data);
 		// CBA Internal method to handle data coming in on interface and pass on to transport
 		virtual void handle_incoming(const Bytes& data);
+		// CBA Feed the link estimates from what the interface observes, smoothed 1/4 like the link RTT
+		void throughput_sample(size_t bytes, double seconds);
+		void rtt_sample(double seconds);
 
+		// CBA Memoized, the hash only depends on the interface name
 		virtual const Bytes get_hash() const {
-			return Identity::full_hash({toString()});
+			if (!_hash) {
+				_hash = Identity::full_hash({toString()});
+			}
+			return _hash;
 		}
 
 		virtual inline std::string toString() const { return "Interface[" + _name + "]"; }
@@ -70,23 +94,47 @@ namespace RNS {
 		std::string _name;
 		size_t _rxb = 0;
 		size_t _txb = 0;
+		uint32_t _rxp = 0;
+		uint32_t _txp = 0;
 		bool _online = false;
 		Bytes _ifac_identity;
 		Bytes _ifac_key;
 		Identity _ifac_id = {Type::NONE};
-		uint8_t _ifac_size = 8;  // DEFAULT_IFAC_SIZE for LoRa-type interfaces
+		Cryptography::Ifac _ifac;	// signing keys and IFAC size (DEFAULT_IFAC_SIZE 8 for LoRa-type interfaces)
 		Type::Interface::modes _mode = Type::Interface::MODE_NONE;
 		uint32_t _bitrate = 0;
+		// CBA Measured by the interface, 0 until it has a sample. The RTT is the first-hop round
+		// trip, or the queueing delay plus airtime where the interface only sees its own side.
+		uint32_t _measured_bitrate = 0;
+		// CBA Microseconds, written by one task and read by others (status, metrics, links), so a
+		// whole 32 bit value rather than a double that could be read half written
+		std::atomic<uint32_t> _rtt_us{0};
 		uint16_t _HW_MTU = 0;
 		bool _AUTOCONFIGURE_MTU = false;
 		bool _FIXED_MTU = false;
 		double _announce_allowed_at = 0;
-		float _announce_cap = 0.0;
-		std::list<AnnounceEntry> _announce_queue;
+		float _announce_cap = 0.0;		// fraction of _bitrate that announces may use
+		// CBA Per-destination announce rate limit, RNS's announce_rate_target, _grace and _penalty,
+		// off while the target is 0
+		uint32_t _announce_rate_target = 0;		// seconds
+		uint8_t _announce_rate_grace = 0;
+		uint32_t _announce_rate_penalty = 0;	// seconds
+		// CBA Announce token bucket in bits, refilled at _bitrate * _announce_cap, may go
+		// negative by one announce and nothing is sent until it has refilled past zero
+		double _announce_tokens = Type::Interface::ANNOUNCE_BURST * 8;
+		double _announce_tokens_at = 0;
+		Utilities::HashTable<AnnounceEntry> _announce_queue;	// keyed on destination hash
+		uint32_t _announces_replaced = 0;
+		uint32_t _announces_dropped = 0;
+		// CBA Frames refused by can_send(), and set while announces wait for writable()
+		uint32_t _refused = 0;
+		volatile bool _send_blocked = false;
 		bool _is_connected_to_shared_instance = false;
 		bool _is_local_shared_instance = false;
 		bool _is_backbone = false;
-		//Bytes _hash;
+		bool _filter_announces = false;	// backbone announces pass Transport::announce_filter() before rebroadcast here
+		mutable Bytes _hash;
+		uint8_t _id = 0;	// registry index assigned by Transport::register_interface(), 0 if not registered
 		HInterface _parent_interface;
 		//Transport& _owner;
 
@@ -159,13 +207,33 @@ namespace RNS {
 		inline void stop() { assert(_impl); return _impl->stop(); }
 		inline void loop() { assert(_impl); return _impl->loop(); }
 		inline const Bytes get_hash() const { assert(_impl); return _impl->get_hash(); }
+		inline uint8_t id() const { if (!_impl) return 0; return _impl->_id; }
+		// Send queued announces as the announce cap allows, fewest hops first
 		void process_announce_queue();
+		// Queue an announce, replacing an older emission queued for the same destination
+		void queue_announce(const Bytes& destination, double time, uint8_t hops, uint64_t emitted, const Bytes& raw);
+		// Take size bytes of announce bandwidth, false if the announce cap is currently used up
+		bool announce_spend(size_t size);
 
-		// CBA ACCUMULATES
-		inline void add_announce(AnnounceEntry& entry) { assert(_impl); _impl->_announce_queue.push_back(entry); }
+		inline bool can_send(const Bytes& data) const { assert(_impl); return _impl->can_send(data); }
+		inline uint16_t queue_depth() const { assert(_impl); return _impl->queue_depth(); }
 
 	protected:
-		inline void send_outgoing(const Bytes& data) { assert(_impl); _impl->send_outgoing(data); }
+		// Accepted or refused whole, a refused frame is counted and nothing of it is queued.
+		// Only a refusal under backpressure is latched until writable(); otherwise the frame
+		// itself can't go (oversize, undersize) and is dropped.
+		inline bool send_outgoing(const Bytes& data) {
+			assert(_impl);
+			if (!_impl->can_send(data)) {
+				++_impl->_refused;
+				if (_impl->backpressured()) {
+					_impl->_send_blocked = true;
+				}
+				return false;
+			}
+			_impl->send_outgoing(data);
+			return true;
+		}
 	public:
 		//inline void handle_incoming(const Bytes& data) { assert(_impl); _impl->handle_incoming(data); }
 		// Public method to handle data coming in on interface and pass on to impl
@@ -192,22 +260,43 @@ namespace RNS {
 		inline const Bytes& ifac_identity() const { assert(_impl); return _impl->_ifac_identity; }
 		inline const Bytes& ifac_key() const { assert(_impl); return _impl->_ifac_key; }
 		inline const Identity& ifac_id() const { assert(_impl); return _impl->_ifac_id; }
-		inline uint8_t ifac_size() const { assert(_impl); return _impl->_ifac_size; }
-		inline void ifac_size(uint8_t size) { assert(_impl); _impl->_ifac_size = size; }
+		inline uint8_t ifac_size() const { assert(_impl); return _impl->_ifac.size(); }
+		inline void ifac_size(uint8_t size) { assert(_impl); _impl->_ifac.size(size); }
+		inline Cryptography::Ifac& ifac() const { assert(_impl); return _impl->_ifac; }
 		void setup_ifac(const char* ifac_netname, const char* ifac_netkey);
 		inline Type::Interface::modes mode() const { assert(_impl); return _impl->_mode; }
 		inline void mode(Type::Interface::modes mode) { assert(_impl); _impl->_mode = mode; }
 		inline uint32_t bitrate() const { assert(_impl); return _impl->_bitrate; }
+		inline uint32_t measured_bitrate() const { assert(_impl); return _impl->_measured_bitrate; }
+		inline double rtt() const { assert(_impl); return _impl->_rtt_us.load(std::memory_order_relaxed) / 1000000.0; }
+		// Achieved throughput once measured, the configured bitrate until then
+		inline uint32_t effective_bitrate() const { assert(_impl); return (_impl->_measured_bitrate > 0) ? _impl->_measured_bitrate : _impl->_bitrate; }
+		// Estimated seconds to get size bytes across the first hop, 0 if the bitrate is unknown
+		double transfer_time(size_t size) const;
 		inline uint16_t HW_MTU() const { assert(_impl); return _impl->_HW_MTU; }
 		inline bool AUTOCONFIGURE_MTU() const { assert(_impl); return _impl->_AUTOCONFIGURE_MTU; }
 		inline bool FIXED_MTU() const { assert(_impl); return _impl->_FIXED_MTU; }
 		inline double announce_allowed_at() const { assert(_impl); return _impl->_announce_allowed_at; }
 		inline float announce_cap() const { assert(_impl); return _impl->_announce_cap; }
-		inline std::list<AnnounceEntry>& announce_queue() const { assert(_impl); return _impl->_announce_queue; }
+		inline uint32_t announce_rate_target() const { assert(_impl); return _impl->_announce_rate_target; }
+		inline uint8_t announce_rate_grace() const { assert(_impl); return _impl->_announce_rate_grace; }
+		inline uint32_t announce_rate_penalty() const { assert(_impl); return _impl->_announce_rate_penalty; }
+		inline void announce_rate(uint32_t target, uint8_t grace, uint32_t penalty) { assert(_impl); _impl->_announce_rate_target = target; _impl->_announce_rate_grace = grace; _impl->_announce_rate_penalty = penalty; }
+		inline Utilities::HashTable<AnnounceEntry>& announce_queue() const { assert(_impl); return _impl->_announce_queue; }
+		inline uint32_t announces_replaced() const { assert(_impl); return _impl->_announces_replaced; }
+		inline uint32_t announces_dropped() const { assert(_impl); return _impl->_announces_dropped; }
+		inline uint32_t refused() const { assert(_impl); return _impl->_refused; }
+		// CBA Traffic counters, updated by handle_incoming()/handle_outgoing()
+		inline size_t rxb() const { assert(_impl); return _impl->_rxb; }
+		inline size_t txb() const { assert(_impl); return _impl->_txb; }
+		inline uint32_t rxp() const { assert(_impl); return _impl->_rxp; }
+		inline uint32_t txp() const { assert(_impl); return _impl->_txp; }
 		inline bool is_connected_to_shared_instance() const { assert(_impl); return _impl->_is_connected_to_shared_instance; }
 		inline bool is_local_shared_instance() const { assert(_impl); return _impl->_is_local_shared_instance; }
 		inline bool is_backbone() const { assert(_impl); return _impl->_is_backbone; }
 		inline void is_backbone(bool val) { assert(_impl); _impl->_is_backbone = val; }
+		inline bool filter_announces() const { assert(_impl); return _impl->_filter_announces; }
+		inline void filter_announces(bool val) { assert(_impl); _impl->_filter_announces = val; }
 		inline HInterface parent_interface() const { assert(_impl); return _impl->_parent_interface; }
 
 		virtual inline std::string toString() const { if (!_impl) return ""; return _impl->toString(); }
@@ -220,6 +309,11 @@ namespace RNS {
 		}
 #endif
 
+	private:
+		bool announce_refill();
+		// Set by Transport on (de)registration
+		inline void id(uint8_t id) const { assert(_impl); _impl->_id = id; }
+
 	protected:
 		std::shared_ptr<InterfaceImpl> _impl;
 
@@ -8,6 +8,7 @@
 #include "Log.h"
 #include "Cryptography/Ed25519.h"
 #include "Cryptography/X25519.h"
+#include "Cryptography/KeyPool.h"
 #include "Cryptography/HKDF.h"
 #include "Cryptography/Token.h"
 #include "Cryptography/Random.h"
@@ -44,7 +45,7 @@ Link::Link(const Destination& destination /*= {Type::NONE}*/, Callbacks::establi
 
 	if (!destination) {
 		_object->_initiator = false;
-		_object->_prv     = Cryptography::X25519PrivateKey::generate();
+		_object->_prv     = Cryptography::X25519KeyPool::take();
 		// CBA BUG: not checking for owner
 		if (_object->_owner) {
 			_object->_sig_prv = _object->_owner.identity().sig_prv();
@@ -54,8 +55,8 @@ Link::Link(const Destination& destination /*= {Type::NONE}*/, Callbacks::establi
 		_object->_initiator = true;
 		_object->_expected_hops = Transport::hops_to(_object->_destination.hash());
 		_object->_establishment_timeout = Reticulum::get_instance().get_first_hop_timeout(destination.hash());
-		_object->_prv     = Cryptography::X25519PrivateKey::generate();
-		_object->_sig_prv = Cryptography::Ed25519PrivateKey::generate();
+		_object->_prv     = Cryptography::X25519KeyPool::take();
+		_object->_sig_prv = Cryptography::Ed25519KeyPool::take();
 	}
 
 	_object->_pub           = _object->_prv->public_key();
@@ -100,7 +101,7 @@ Link::Link(const Destination& destination /*= {Type::NONE}*/, Callbacks::establi
 		_object->_establishment_cost += _object->_packet.raw().size();
 		set_link_id(_object->_packet);
 		Transport::register_link(*this);
-		_object->_request_time = OS::time();
+		_object->_request_time = OS::ltime();
 		start_watchdog();
 		_object->_packet.send();
 		had_outbound();
@@ -176,6 +177,7 @@ Link::Link(const Destination& destination /*= {Type::NONE}*/, Callbacks::establi
 }
 
 /*static*/ Link Link::validate_request( const Destination& owner, const Bytes& data, const Packet& packet) {
+	RNS_ALLOC_SCOPE(TAG_LINK);
 	if (data.size() == ECPUBSIZE || data.size() == ECPUBSIZE + LINK_MTU_SIZE) {
 		try {
 			Link link({Type::NONE}, nullptr, nullptr, owner, data.left(ECPUBSIZE/2), data.mid(ECPUBSIZE/2, ECPUBSIZE/2));
@@ -185,7 +187,11 @@ Link::Link(const Destination& destination /*= {Type::NONE}*/, Callbacks::establi
 				DEBUG("Link request includes MTU signalling"); // TODO: Remove debug
 				try {
 					uint16_t mtu = mtu_from_lr_packet(packet);
-					link.mtu((mtu != 0) ? mtu : Type::Reticulum::MTU);
+					// CBA Clamped to what the interface the request came in on can carry, as RNS
+					// does for local destinations
+					const Interface& interface = packet.receiving_interface();
+					uint16_t interface_mtu = (interface && (interface.AUTOCONFIGURE_MTU() || interface.FIXED_MTU()) && interface.HW_MTU() > 0) ? interface.HW_MTU() : Type::Reticulum::MTU;
+					link.mtu((mtu != 0) ? std::min(mtu, interface_mtu) : Type::Reticulum::MTU);
 				}
 				catch (std::exception& e) {
 					ERRORF("An error ocurred while validating link request %s", link.link_id().toHex().c_str());
@@ -208,9 +214,9 @@ Link::Link(const Destination& destination /*= {Type::NONE}*/, Callbacks::establi
 			link.handshake();
 			link.attached_interface(packet.receiving_interface());
 			link.prove();
-			link.request_time(OS::time());
+			link.request_time(OS::ltime());
 			Transport::register_link(link);
-			link.last_inbound(OS::time());
+			link.last_inbound(OS::ltime());
 			link.start_watchdog();
 			
 			DEBUGF("Incoming link request %s accepted", link.toString().c_str());
@@ -276,10 +282,13 @@ void Link::handshake() {
 void Link::prove() {
 	assert(_object);
 	DEBUGF("Link %s requesting proof", link_id().toHex().c_str());
-	Bytes signed_data =_object->_link_id + _object->_pub_bytes + _object->_sig_pub_bytes;
+	// CBA The confirmed MTU is signed along with the keys, without it the initiator falls
+	// back to the Reticulum MTU
+	const Bytes signalling_bytes(Link::signalling_bytes(_object->_mtu, _object->_mode));
+	Bytes signed_data =_object->_link_id + _object->_pub_bytes + _object->_sig_pub_bytes + signalling_bytes;
 	const Bytes signature(_object->_owner.identity().sign(signed_data));
 
-	Bytes proof_data = signature + _object->_pub_bytes;
+	Bytes proof_data = signature + _object->_pub_bytes + signalling_bytes;
 	// CBA LINK
 	// CBA TODO: Determine which approach is better, passing liunk to packet or passing _link_destination
 	Packet proof(*this, proof_data, Type::Packet::PROOF, Type::Packet::LRPROOF);
@@ -337,7 +346,7 @@ void Link::validate_proof(const Packet& packet) {
 				handshake();
 
 				_object->_establishment_cost += packet.raw().size();
-				Bytes signed_data = _object->_link_id + _object->_peer_pub_bytes + _object->_peer_sig_pub_bytes;
+				Bytes signed_data = _object->_link_id + _object->_peer_pub_bytes + _object->_peer_sig_pub_bytes + signalling_bytes;
 				const Bytes signature(packet_data.left(Type::Identity::SIGLENGTH/8));
 				
 				TRACEF("Link %s validating identity", link_id().toHex().c_str());
@@ -345,15 +354,20 @@ void Link::validate_proof(const Packet& packet) {
 					if (_object->_status != Type::Link::HANDSHAKE) {
 						throw std::runtime_error("Invalid link state for proof validation: " + _object->_status);
 					}
-					_object->_rtt = OS::time() - _object->_request_time;
+					_object->_rtt = (OS::ltime() - _object->_request_time) / 1000.0;
 					_object->_attached_interface = packet.receiving_interface();
+					// CBA Count the queueing delay the first hop has measured (LoRa queue wait and
+					// airtime) in, the handshake alone may have found the queue empty. The peer is
+					// sent this RTT and derives its keepalive and stale time from it, as this end does.
+					_object->_rtt = std::max(_object->_rtt, _object->_attached_interface.rtt());
 					_object->__remote_identity = _object->_destination.identity();
 					if (confirmed_mtu) _object->_mtu = confirmed_mtu;
 					else _object->_mtu = RNS::Type::Reticulum::MTU;
 					update_mdu();
 					_object->_status = Type::Link::ACTIVE;
-					_object->_activated_at = OS::time();
+					_object->_activated_at = OS::ltime();
 					_object->_last_proof = _object->_activated_at;
+					update_keepalive();
 					Transport::activate_link(*this);
 					VERBOSEF("Link %s established with %s, RTT is %f s", toString().c_str(), _object->_destination.toString().c_str(), OS::round(_object->_rtt, 3));
 					
@@ -453,7 +467,7 @@ const RNS::RequestReceipt Link::request(const Bytes& path, const Bytes& data /*=
 		timeout = _object->_rtt * _object->_traffic_timeout_factor + Type::Resource::RESPONSE_MAX_GRACE_TIME * 1.125;
 	}
 
-	if (packed_request.size() <= MDU) {
+	if (packed_request.size() <= _object->_mdu) {
 		Packet request_packet(*this, packed_request, Type::Packet::DATA, Type::Packet::REQUEST);
 		PacketReceipt packet_receipt = request_packet.send();
 
@@ -503,7 +517,7 @@ void Link::update_mdu() {
 void Link::rtt_packet(const Packet& packet) {
 	assert(_object);
 	try {
-		double measured_rtt = OS::time() - _object->_request_time;
+		double measured_rtt = (OS::ltime() - _object->_request_time) / 1000.0;
 		const Bytes plaintext(decrypt(packet.data()));
 		if (plaintext) {
 			//p rtt = umsgpack.unpackb(plaintext)
@@ -511,9 +525,10 @@ void Link::rtt_packet(const Packet& packet) {
 			unpacker.feed(plaintext.data(), plaintext.size());
 			double rtt = 0.0;
 			unpacker.deserialize(rtt);
-			_object->_rtt = std::max(measured_rtt, rtt);
+			_object->_rtt = std::max(std::max(measured_rtt, rtt), _object->_attached_interface.rtt());
 			_object->_status = Type::Link::ACTIVE;
-			_object->_activated_at = OS::time();
+			_object->_activated_at = OS::ltime();
+			update_keepalive();
 
 			//p if _object->_rtt != None and _object->_establishment_cost != None and _object->_rtt > 0 and _object->_establishment_cost > 0:
 			if (_object->_rtt != 0.0 && _object->_establishment_cost != 0.0 && _object->_rtt > 0 and _object->_establishment_cost > 0) {
@@ -604,7 +619,7 @@ const Bytes Link::get_context() {
 double Link::get_age() {
 	assert(_object);
 	if (_object->_activated_at) {
-		return OS::time() - _object->_activated_at;
+		return (OS::ltime() - _object->_activated_at) / 1000.0;
 	}
 	return 0.0;
 }
@@ -615,9 +630,9 @@ double Link::get_age() {
 double Link::no_inbound_for() {
 	assert(_object);
 	//p activated_at = _object->_activated_at if _object->_activated_at != None else 0
-	double activated_at = _object->_activated_at;
-	double last_inbound = std::max(_object->_last_inbound, activated_at);
-	return (OS::time() - last_inbound);
+	uint64_t activated_at = _object->_activated_at;
+	uint64_t last_inbound = std::max(_object->_last_inbound, activated_at);
+	return (OS::ltime() - last_inbound) / 1000.0;
 }
 
 /*
@@ -625,7 +640,7 @@ double Link::no_inbound_for() {
 */
 double Link::no_outbound_for() {
 	assert(_object);
-	return OS::time() - _object->_last_outbound;
+	return (OS::ltime() - _object->_last_outbound) / 1000.0;
 }
 
 /*
@@ -633,7 +648,7 @@ double Link::no_outbound_for() {
 */
 double Link::no_data_for() {
 	assert(_object);
-	return OS::time() - _object->_last_data;
+	return (OS::ltime() - _object->_last_data) / 1000.0;
 }
 
 /*
@@ -654,7 +669,7 @@ const Identity& Link::get_remote_identity() {
 
 void Link::had_outbound(bool is_keepalive /*= false*/) {
 	assert(_object);
-	_object->_last_outbound = OS::time();
+	_object->_last_outbound = OS::ltime();
 	if (!is_keepalive) {
 		_object->_last_data = _object->_last_outbound;
 	}
@@ -702,10 +717,13 @@ void Link::teardown_packet(const Packet& packet) {
 
 void Link::link_closed() {
 	assert(_object);
-	for (auto& resource : _object->_incoming_resources) {
+	// CBA Copies, cancelling removes the resource from the link
+	std::set<Resource> incoming_resources(_object->_incoming_resources);
+	for (auto& resource : incoming_resources) {
 		const_cast<Resource&>(resource).cancel();
 	}
-	for (auto& resource : _object->_outgoing_resources) {
+	std::set<Resource> outgoing_resources(_object->_outgoing_resources);
+	for (auto& resource : outgoing_resources) {
 		const_cast<Resource&>(resource).cancel();
 	}
 	if (_object->_channel) {
@@ -736,13 +754,89 @@ void Link::link_closed() {
 	}
 }
 
-// CBA TODO Implement watchdog
+// CBA The watchdog has no thread of its own, Transport runs watchdog_job() for every link
 void Link::start_watchdog() {
 	//z thread = threading.Thread(target=_object->___watchdog_job)
 	//z thread.daemon = True
 	//z thread.start()
 }
 
+// CBA __watchdog_job() below without the sleeps: each pass checks the link's deadlines once and
+// returns. Keepalives are sent by the initiator after a keepalive interval without inbound traffic
+// as in RNS, but held back while it has been sending data, which already shows the peer the link
+// is alive. A held keepalive still goes once half the gap to the stale time is used up, so the
+// peer's answer can arrive before this end gives up on the link.
+void Link::watchdog_job() {
+	assert(_object);
+	if (_object->_status == Type::Link::CLOSED || _object->_watchdog_lock) {
+		return;
+	}
+	uint64_t now = OS::ltime();
+	switch (_object->_status) {
+	case Type::Link::PENDING:
+	case Type::Link::HANDSHAKE:
+		if (now >= _object->_request_time + (uint64_t)(_object->_establishment_timeout * 1000)) {
+			if (_object->_status == Type::Link::PENDING) {
+				VERBOSEF("Link %s establishment timed out", toString().c_str());
+			}
+			else if (_object->_initiator) {
+				DEBUGF("Timeout waiting for link request proof on %s", toString().c_str());
+			}
+			else {
+				DEBUGF("Timeout waiting for RTT packet from link initiator on %s", toString().c_str());
+			}
+			_object->_status = Type::Link::CLOSED;
+			_object->_teardown_reason = TIMEOUT;
+			link_closed();
+		}
+		break;
+	case Type::Link::ACTIVE:
+	{
+		uint64_t last_inbound = std::max(std::max(_object->_last_inbound, _object->_last_proof), _object->_activated_at);
+		uint64_t keepalive = (uint64_t)_object->_keepalive * 1000;
+		uint64_t stale_time = (uint64_t)_object->_stale_time * 1000;
+		if (now >= last_inbound + keepalive) {
+			if (_object->_initiator && now >= _object->_last_keepalive + keepalive) {
+				// inbound data would have moved last_inbound, so recent data went out
+				bool sending = (now < _object->_last_data + keepalive);
+				if (sending && now < last_inbound + (keepalive + stale_time) / 2) {
+					++_object->_keepalives_deferred;
+				}
+				else {
+					send_keepalive();
+				}
+			}
+			if (now >= last_inbound + stale_time) {
+				_object->_status = STALE;
+				_object->_stale_at = now;
+			}
+		}
+		break;
+	}
+	case STALE:
+		if (now >= _object->_stale_at + (uint64_t)((_object->_rtt * KEEPALIVE_TIMEOUT_FACTOR + STALE_GRACE) * 1000)) {
+			DEBUGF("Link %s timed out", toString().c_str());
+			_object->_status = Type::Link::CLOSED;
+			_object->_teardown_reason = TIMEOUT;
+			link_closed();
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+// CBA As RNS
+void Link::update_keepalive() {
+	assert(_object);
+	//p self.keepalive = max(min(self.rtt*(Link.KEEPALIVE_MAX/Link.KEEPALIVE_MAX_RTT), Link.KEEPALIVE_MAX), Link.KEEPALIVE_MIN)
+	double keepalive = std::max(std::min(_object->_rtt * (KEEPALIVE_MAX / KEEPALIVE_MAX_RTT), (double)KEEPALIVE_MAX), (double)KEEPALIVE_MIN);
+	_object->_keepalive = (uint16_t)keepalive;
+	//p self.stale_time = self.keepalive * Link.STALE_FACTOR
+	_object->_stale_time = _object->_keepalive * STALE_FACTOR;
+	DEBUGF("Link %s keepalive is %u s, stale time %u s", toString().c_str(), _object->_keepalive, _object->_stale_time);
+}
+
 /*p TODO
 
 void Link::__watchdog_job() {
@@ -823,6 +917,8 @@ void Link::send_keepalive() {
 	RNS::Packet keepalive_packet(*this, Bytes("\xFF"), Type::Packet::DATA, Type::Packet::KEEPALIVE);
 	keepalive_packet.send();
 	had_outbound(true);
+	_object->_last_keepalive = _object->_last_outbound;
+	++_object->_keepalives_sent;
 }
 
 void Link::handle_request(const Bytes& request_id, const ResourceRequest& resource_request) {
@@ -866,13 +962,14 @@ void Link::handle_request(const Bytes& request_id, const ResourceRequest& resour
 					packer.to_array(request_id, response);
 					Bytes packed_response(packer.data(), packer.size());
 
-					if (packed_response.size() <= MDU) {
+					if (packed_response.size() <= _object->_mdu) {
 						//p RNS.Packet(self, packed_response, Type::Packet::DATA, context = Type::Packet::RESPONSE).send()
 						RNS::Packet response_packet(*this, packed_response, Type::Packet::DATA, Type::Packet::RESPONSE);
 						response_packet.send();
 					}
 					else {
-						// CBA TODO Determine why unused Resource is created here
+						// CBA Resource advertises itself on construction
+						RNS_ALLOC_SCOPE(TAG_RESOURCE);
 						Resource response_resource = RNS::Resource(packed_response, *this, request_id, true);
 					}
 				}
@@ -976,32 +1073,44 @@ void Link::response_resource_concluded(const Resource& resource) {
 }
 
 
-/*z
-"""
+/*
 Get the ``Channel`` for this link.
 
 :return: ``Channel`` object
-"""
-void Link::get_channel() {
-	assert(_object);
-	if _object->_channel is None:
-		_object->_channel = Channel(LinkChannelOutlet(self))
-	return _object->_channel
 */
+Channel& Link::get_channel() {
+	assert(_object);
+	if (!_object->_channel) {
+		_object->_channel = Channel(*this);
+	}
+	return _object->_channel;
+}
 
 /*
 void Link::receive(const Packet& packet) {
 }
 */
+// CBA Holds the watchdog lock for a scope, released however the scope is left, exceptions included
+class WatchdogLockGuard {
+public:
+	WatchdogLockGuard(bool& lock) : _lock(lock) { _lock = true; }
+	~WatchdogLockGuard() { _lock = false; }
+private:
+	bool& _lock;
+};
+
 void Link::receive(const Packet& packet) {
 	assert(_object);
-	_object->_watchdog_lock = true;
+	RNS_ALLOC_SCOPE(TAG_LINK);
+	// Keeps the data alive for the guard should the link give up its _object meanwhile
+	std::shared_ptr<LinkData> object(_object);
+	WatchdogLockGuard watchdog_lock(object->_watchdog_lock);
 	if (_object->_status != Type::Link::CLOSED && !(_object->_initiator && packet.context() == Type::Packet::KEEPALIVE && packet.data() == "\xFF")) {
 		if (packet.receiving_interface() != _object->_attached_interface) {
 			ERROR("Link-associated packet received on unexpected interface! Someone might be trying to manipulate your communication!");
 		}
 		else {
-			_object->_last_inbound = OS::time();
+			_object->_last_inbound = OS::ltime();
 			if (packet.context() != Type::Packet::KEEPALIVE) {
 				_object->_last_data = _object->_last_inbound;
 			}
@@ -1138,98 +1247,119 @@ void Link::receive(const Packet& packet) {
 					teardown_packet(packet);
 					break;
 				}
-/*z
 				case Type::Packet::RESOURCE_ADV:
 				{
 					//p packet.plaintext = decrypt(packet.data)
 					const Bytes plaintext = decrypt(packet.data());
 					if (plaintext) {
 						const_cast<Packet&>(packet).plaintext(plaintext);
-						if (ResourceAdvertisement::is_request(packet)) {
-							Resource::accept(packet, callback=_object->_request_resource_concluded);
-						}
-						else if (ResourceAdvertisement::is_response(packet)) {
-							Bytes request_id = ResourceAdvertisement::read_request_id(packet)
-							for (auto& pending_request : _object->_pending_requests) {
-								if (pending_request.request_id == request_id) {
-									const Bytes response_resource = Resource::accept(packet, callback=_object->_response_resource_concluded, progress_callback=pending_request.response_resource_progress, request_id = request_id);
-									if (response_resource) {
-										//p if pending_request.response_size == None:
-										if (pending_request.response_size == 0) {
-											pending_request.response_size = ResourceAdvertisement::read_size(packet);
-										}
-										//p if pending_request.response_transfer_size == None:
-										if (pending_request.response_transfer_size == 0) {
-											pending_request.response_transfer_size = 0;
-										}
-										pending_request.response_transfer_size += ResourceAdvertisement::read_transfer_size(packet);
-										//p if pending_request.started_at == None:
-										if (pending_request.started_at == 0.0) {
-											pending_request.started_at = OS::time();
+						try {
+							if (ResourceAdvertisement::is_request(packet)) {
+								// CBA Request and response resources are routed back through resource_concluded()
+								Resource::accept(packet);
+							}
+							else if (ResourceAdvertisement::is_response(packet)) {
+								Bytes request_id = ResourceAdvertisement::read_request_id(packet);
+								for (RNS::RequestReceipt pending_request : _object->_pending_requests) {
+									if (pending_request.request_id() == request_id) {
+										Resource response_resource = Resource::accept(packet, nullptr, nullptr, request_id);
+										if (response_resource) {
+											pending_request.response_size(ResourceAdvertisement::read_size(packet));
+											pending_request.response_transfer_size(pending_request.response_transfer_size() + ResourceAdvertisement::read_transfer_size(packet));
+											pending_request.response_resource_progress(response_resource);
 										}
-										pending_request.response_resource_progress(response_resource);
+										break;
 									}
 								}
 							}
-						}
-						else if (_object->_resource_strategy == ACCEPT_NONE) {
-							//p pass
-						}
-						else if (_object->_resource_strategy == ACCEPT_APP) {
-							if (_object->_callbacks.resource) {
-								try {
-									resource_advertisement = RNS.ResourceAdvertisement.unpack(packet.plaintext());
-									resource_advertisement.link = *this;
-									if (_object->_callbacks.resource(resource_advertisement)) {
-										Resource::accept(packet, _object->_callbacks.resource_concluded);
+							else if (_object->_resource_strategy == ACCEPT_NONE) {
+								//p pass
+							}
+							else if (_object->_resource_strategy == ACCEPT_APP) {
+								if (_object->_callbacks._resource) {
+									ResourceAdvertisement resource_advertisement = ResourceAdvertisement::unpack(plaintext);
+									if (_object->_callbacks._resource(resource_advertisement)) {
+										Resource::accept(packet, _object->_callbacks._resource_concluded);
 									}
 								}
-								catch (std::exception& e) {
-									ERRORF("Error while executing resource accept callback from %s. The contained exception was: %s", toString().c_str(), e.what());
-								}
-						elif _object->_resource_strategy == ACCEPT_ALL:
-							RNS.Resource.accept(packet, _object->_callbacks.resource_concluded)
+							}
+							else if (_object->_resource_strategy == ACCEPT_ALL) {
+								Resource::accept(packet, _object->_callbacks._resource_concluded);
+							}
+						}
+						catch (std::exception& e) {
+							ERRORF("Error while handling resource advertisement from %s. The contained exception was: %s", toString().c_str(), e.what());
+						}
+					}
 					break;
 				}
 				case Type::Packet::RESOURCE_REQ:
 				{
 					const Bytes plaintext = decrypt(packet.data());
-					if (plaintext) {
-						if ord(plaintext[:1]) == RNS.Resource.HASHMAP_IS_EXHAUSTED:
-							resource_hash = plaintext[1+RNS.Resource.MAPHASH_LEN:Type::Identity::HASHLENGTH//8+1+RNS.Resource.MAPHASH_LEN]
-						else:
-							resource_hash = plaintext[1:Type::Identity::HASHLENGTH//8+1]
-
-						for resource in _object->_outgoing_resources:
-							if resource.hash == resource_hash:
+					if (plaintext && plaintext.size() > 0) {
+						Bytes resource_hash;
+						if (plaintext.data()[0] == Type::Resource::HASHMAP_IS_EXHAUSTED) {
+							resource_hash = plaintext.mid(1+Type::Resource::MAPHASH_LEN, Type::Identity::HASHLENGTH/8);
+						}
+						else {
+							resource_hash = plaintext.mid(1, Type::Identity::HASHLENGTH/8);
+						}
+						std::set<Resource> outgoing_resources(_object->_outgoing_resources);
+						for (auto& resource : outgoing_resources) {
+							if (resource.hash() == resource_hash) {
 								// We need to check that this request has not been
 								// received before in order to avoid sequencing errors.
-								if not packet.packet_hash in resource.req_hashlist:
-									resource.req_hashlist.append(packet.packet_hash)
-									resource.request(plaintext)
+								if (resource.req_hashlist().count(packet.packet_hash()) == 0) {
+									resource.req_hashlist().insert(packet.packet_hash());
+									const_cast<Resource&>(resource).request(plaintext);
+								}
+							}
+						}
+					}
 					break;
 				}
 				case Type::Packet::RESOURCE_HMU:
 				{
 					const Bytes plaintext = decrypt(packet.data());
 					if (plaintext) {
-						resource_hash = plaintext[:Type::Identity::HASHLENGTH//8]
-						for resource in _object->_incoming_resources:
-							if resource_hash == resource.hash:
-								resource.hashmap_update_packet(plaintext)
+						Bytes resource_hash = plaintext.left(Type::Identity::HASHLENGTH/8);
+						std::set<Resource> incoming_resources(_object->_incoming_resources);
+						for (auto& resource : incoming_resources) {
+							if (resource_hash == resource.hash()) {
+								const_cast<Resource&>(resource).hashmap_update_packet(plaintext);
+							}
+						}
+					}
 					break;
 				}
 				case Type::Packet::RESOURCE_ICL:
 				{
 					const Bytes plaintext = decrypt(packet.data());
 					if (plaintext) {
-						resource_hash = plaintext[:Type::Identity::HASHLENGTH//8]
-						for resource in _object->_incoming_resources:
-							if resource_hash == resource.hash:
-								resource.cancel()
+						Bytes resource_hash = plaintext.left(Type::Identity::HASHLENGTH/8);
+						std::set<Resource> incoming_resources(_object->_incoming_resources);
+						for (auto& resource : incoming_resources) {
+							if (resource_hash == resource.hash()) {
+								const_cast<Resource&>(resource).cancel();
+							}
+						}
+					}
+					break;
+				}
+				case Type::Packet::RESOURCE_RCL:
+				{
+					const Bytes plaintext = decrypt(packet.data());
+					if (plaintext) {
+						Bytes resource_hash = plaintext.left(Type::Identity::HASHLENGTH/8);
+						std::set<Resource> outgoing_resources(_object->_outgoing_resources);
+						for (auto& resource : outgoing_resources) {
+							if (resource_hash == resource.hash()) {
+								const_cast<Resource&>(resource).rejected();
+							}
+						}
+					}
 					break;
 				}
-*/
 				case Type::Packet::KEEPALIVE:
 				{
 					if (!_object->_initiator && packet.data() == "\xFF") {
@@ -1246,44 +1376,41 @@ void Link::receive(const Packet& packet) {
 				// of hash -> sequence map
 				case Type::Packet::RESOURCE:
 				{
-					for (auto& resource : _object->_incoming_resources) {
-						//z resource.receive_part(packet);
+					std::set<Resource> incoming_resources(_object->_incoming_resources);
+					for (auto& resource : incoming_resources) {
+						const_cast<Resource&>(resource).receive_part(packet);
 					}
 					break;
 				}
-/*z
 				case Type::Packet::CHANNEL:
 				{
-					//z if (!_object->_channel) {
-					if (true) {
-						DEBUG(f"Channel data received without open channel")
+					if (!_object->_channel) {
+						DEBUG("Channel data received without open channel");
 					}
 					else {
-						//z packet.prove();
-						//z plaintext = decrypt(packet.data());
-						//z if (plaintext) {
-						//z 	_object->_channel._receive(plaintext);
-						//z }
+						const_cast<Packet&>(packet).prove();
+						const Bytes plaintext = decrypt(packet.data());
+						if (plaintext) {
+							_object->_channel._receive(plaintext);
+						}
 					}
 					break;
 				}
-*/
 				}
 			}
 			else if (packet.packet_type() == Type::Packet::PROOF) {
 				if (packet.context() == Type::Packet::RESOURCE_PRF) {
 					Bytes resource_hash = packet.data().left(Type::Identity::HASHLENGTH/8);
-					for (const auto& resource : _object->_outgoing_resources) {
+					std::set<Resource> outgoing_resources(_object->_outgoing_resources);
+					for (auto& resource : outgoing_resources) {
 						if (resource_hash == resource.hash()) {
-							//z resource.validate_proof(packet.data());
+							const_cast<Resource&>(resource).validate_proof(packet.data());
 						}
 					}
 				}
 			}
 		}
 	}
-
-	_object->_watchdog_lock = false;
 }
 
 const Bytes Link::encrypt(const Bytes& plaintext) {
@@ -1322,6 +1449,14 @@ const Bytes Link::decrypt(const Bytes& ciphertext) {
 	}
 }
 
+const Cryptography::Token::Ptr& Link::token() {
+	assert(_object);
+	if (!_object->_token) {
+		_object->_token.reset(new Token(_object->_derived_key));
+	}
+	return _object->_token;
+}
+
 const Bytes Link::sign(const Bytes& message) {
 	assert(_object);
 	return _object->_sig_prv->sign(message);
@@ -1374,6 +1509,31 @@ void Link::set_resource_concluded_callback(Callbacks::resource_concluded callbac
 }
 
 
+void Link::resource_started(const Resource& resource) {
+	assert(_object);
+	if (_object->_callbacks._resource_started != nullptr) {
+		try {
+			_object->_callbacks._resource_started(resource);
+		}
+		catch (std::exception& e) {
+			ERRORF("Error while executing resource started callback from %s. The contained exception was: %s", toString().c_str(), e.what());
+		}
+	}
+}
+
+// CBA Resource callbacks can't be bound to a request receipt, so response progress is routed here
+void Link::resource_progress(const Resource& resource) {
+	assert(_object);
+	if (resource.initiator() || !resource.is_response()) {
+		return;
+	}
+	for (RNS::RequestReceipt pending_request : _object->_pending_requests) {
+		if (pending_request.request_id() == resource.request_id()) {
+			pending_request.response_resource_progress(resource);
+		}
+	}
+}
+
 void Link::resource_concluded(const Resource& resource) {
 	assert(_object);
 	if (_object->_incoming_resources.count(resource) > 0) {
@@ -1382,6 +1542,23 @@ void Link::resource_concluded(const Resource& resource) {
 	if (_object->_outgoing_resources.count(resource) > 0) {
 		_object->_outgoing_resources.erase(resource);
 	}
+	// CBA Likewise requests and responses sent as resources conclude here rather than through bound callbacks
+	if (resource.initiator()) {
+		if (resource.is_request()) {
+			std::set<RequestReceipt> pending_requests(_object->_pending_requests);
+			for (RNS::RequestReceipt pending_request : pending_requests) {
+				if (pending_request.request_id() == resource.request_id()) {
+					pending_request.request_resource_concluded(resource);
+				}
+			}
+		}
+	}
+	else if (resource.is_request()) {
+		request_resource_concluded(resource);
+	}
+	else if (resource.is_response()) {
+		response_resource_concluded(resource);
+	}
 }
 
 /*
@@ -1442,7 +1619,7 @@ void Link::cancel_incoming_resource(const Resource& resource) {
 
 bool Link::ready_for_new_resource() {
 	assert(_object);
-	return (_object->_outgoing_resources.size() > 0);
+	return (_object->_outgoing_resources.size() == 0);
 }
 
 std::string Link::toString() const {
@@ -1487,6 +1664,11 @@ uint16_t Link::mtu() const {
 	return _object->_mtu;
 }
 
+bool Link::peer_compression() const {
+	assert(_object);
+	return _object->_peer_compression;
+}
+
 Type::Link::status Link::status() const {
 	assert(_object);
 	return _object->_status;
@@ -1507,16 +1689,36 @@ uint8_t Link::traffic_timeout_factor() const {
 	return _object->_traffic_timeout_factor;
 }
 
-double Link::request_time() const {
+uint64_t Link::request_time() const {
 	assert(_object);
 	return _object->_request_time;
 }
 
-double Link::last_inbound() const {
+uint64_t Link::last_inbound() const {
 	assert(_object);
 	return _object->_last_inbound;
 }
 
+uint16_t Link::keepalive() const {
+	assert(_object);
+	return _object->_keepalive;
+}
+
+uint16_t Link::stale_time() const {
+	assert(_object);
+	return _object->_stale_time;
+}
+
+uint32_t Link::keepalives_sent() const {
+	assert(_object);
+	return _object->_keepalives_sent;
+}
+
+uint32_t Link::keepalives_deferred() const {
+	assert(_object);
+	return _object->_keepalives_deferred;
+}
+
 std::set<RNS::RequestReceipt>& Link::pending_requests() const {
 	assert(_object);
 	return _object->_pending_requests;
@@ -1554,17 +1756,17 @@ void Link::establishment_cost(uint16_t cost) {
 	_object->_establishment_cost = cost;
 }
 
-void Link::request_time(double time) {
+void Link::request_time(uint64_t time) {
 	assert(_object);
 	_object->_request_time = time;
 }
 
-void Link::last_inbound(double time) {
+void Link::last_inbound(uint64_t time) {
 	assert(_object);
 	_object->_last_inbound = time;
 }
 
-void Link::last_outbound(double time) {
+void Link::last_outbound(uint64_t time) {
 	assert(_object);
 	_object->_last_outbound = time;
 }
@@ -1589,6 +1791,11 @@ void Link::mtu(uint16_t mtu) {
 	_object->_mtu = mtu;
 }
 
+void Link::peer_compression(bool peer_compression) {
+	assert(_object);
+	_object->_peer_compression = peer_compression;
+}
+
 void Link::mode(RNS::Type::Link::link_mode mode) {
 	assert(_object);
 	_object->_mode = mode;
@@ -8,6 +8,10 @@
 
 namespace RNS {
 
+	namespace Cryptography {
+		class Token;
+	}
+
 	class ResourceRequest;
 	class ResourceResponse;
 	class RequestReceipt;
@@ -16,6 +20,7 @@ namespace RNS {
 	class LinkData;
 	class RequestReceiptData;
 	class Resource;
+	class Channel;
 	class Packet;
 	class Destination;
 	class ResourceAdvertisement;
@@ -116,7 +121,7 @@ namespace RNS {
 			using closed = void(*)(Link& link);
 			using packet = void(*)(const Bytes& plaintext, const Packet& packet);
 			using remote_identified = void(*)(const Link& link, const Identity& remote_identity);
-			using resource = void(*)(const ResourceAdvertisement& resource_advertisement);
+			using resource = bool(*)(const ResourceAdvertisement& resource_advertisement);
 			using resource_started = void(*)(const Resource& resource);
 			using resource_concluded = void(*)(const Resource& resource);
 		public:
@@ -199,15 +204,20 @@ namespace RNS {
 		void link_closed();
 		void start_watchdog();
 		void __watchdog_job();
+		// CBA One pass of the watchdog, run for every link by Transport's link jobs
+		void watchdog_job();
+		void update_keepalive();
 		void send_keepalive();
 		void handle_request(const Bytes& request_id, const ResourceRequest& unpacked_request);
 		void handle_response(const Bytes& request_id, const Bytes& response_data, size_t response_size, size_t response_transfer_size);
 		void request_resource_concluded(const Resource& resource);
 		void response_resource_concluded(const Resource& resource);
-		//z const Channel& get_channel();
+		Channel& get_channel();
 		void receive(const Packet& packet);
 		const Bytes encrypt(const Bytes& plaintext);
 		const Bytes decrypt(const Bytes& ciphertext);
+		// CBA Link token, exposed for streaming resource encryption
+		const std::shared_ptr<Cryptography::Token>& token();
 		const Bytes sign(const Bytes& message);
 		bool validate(const Bytes& signature, const Bytes& message);
 		void set_link_established_callback(Callbacks::established callback);
@@ -217,6 +227,8 @@ namespace RNS {
 		void set_resource_callback(Callbacks::resource callback);
 		void set_resource_started_callback(Callbacks::resource_started callback);
 		void set_resource_concluded_callback(Callbacks::resource_concluded callback);
+		void resource_started(const Resource& resource);
+		void resource_progress(const Resource& resource);
 		void resource_concluded(const Resource& resource);
 		void set_resource_strategy(Type::Link::resource_strategy strategy);
 		void register_outgoing_resource(const Resource& resource);
@@ -238,12 +250,19 @@ namespace RNS {
 		const Bytes& link_id() const;
 		const Bytes& hash() const;
 		uint16_t mtu() const;
+		// CBA Whether the peer has advertised that it takes LZ compressed resources
+		bool peer_compression() const;
 		Type::Link::status status() const;
 		double establishment_timeout() const;
 		uint16_t establishment_cost() const;
 		uint8_t traffic_timeout_factor() const;
-		double request_time() const;
-		double last_inbound() const;
+		uint64_t request_time() const;
+		uint64_t last_inbound() const;
+		// CBA Keepalive interval and stale time in seconds, as adapted to the RTT
+		uint16_t keepalive() const;
+		uint16_t stale_time() const;
+		uint32_t keepalives_sent() const;
+		uint32_t keepalives_deferred() const;
 		std::set<RequestReceipt>& pending_requests() const;
 		Type::Link::teardown_reason teardown_reason() const;
 		bool initiator() const;
@@ -253,13 +272,14 @@ namespace RNS {
 		void attached_interface(const Interface& interface);
 		void establishment_timeout(double timeout);
 		void establishment_cost(uint16_t cost);
-		void request_time(double time);
-		void last_inbound(double time);
-		void last_outbound(double time);
+		void request_time(uint64_t time);
+		void last_inbound(uint64_t time);
+		void last_outbound(uint64_t time);
 		void increment_tx();
 		void increment_txbytes(uint16_t bytes);
 		void status(Type::Link::status status);
 		void mtu(uint16_t mtu);
+		void peer_compression(bool peer_compression);
 		void mode(RNS::Type::Link::link_mode mode);
 
 	protected:
@@ -41,11 +41,12 @@ namespace RNS {
 		uint16_t _establishment_cost = 0;
 		Link::Callbacks _callbacks;
 		Type::Link::resource_strategy _resource_strategy = Type::Link::ACCEPT_NONE;
-		double _last_inbound = 0.0;
-		double _last_outbound = 0.0;
-        double _last_keepalive = 0.0;
-		double _last_proof = 0.0;
-		double _last_data = 0.0;
+		// CBA Activity times are ms of OS::ltime(), they are set for every packet on the link
+		uint64_t _last_inbound = 0;
+		uint64_t _last_outbound = 0;
+		uint64_t _last_keepalive = 0;
+		uint64_t _last_proof = 0;
+		uint64_t _last_data = 0;
 		uint16_t _tx = 0;
 		uint16_t _rx = 0;
 		uint16_t _txbytes = 0;
@@ -55,14 +56,20 @@ namespace RNS {
 		float _q = 0.0;
 		uint8_t _traffic_timeout_factor = Type::Link::TRAFFIC_TIMEOUT_FACTOR;
 		uint16_t _keepalive_timeout_factor = Type::Link::KEEPALIVE_TIMEOUT_FACTOR;
+		// CBA Adapted to the RTT by update_keepalive() once the link is active
 		uint16_t _keepalive = Type::Link::KEEPALIVE;
 		uint16_t _stale_time = Type::Link::STALE_TIME;
+		uint64_t _stale_at = 0;
+		uint32_t _keepalives_sent = 0;
+		uint32_t _keepalives_deferred = 0;
 		bool _watchdog_lock = false;
-		double _activated_at = 0.0;
+		uint64_t _activated_at = 0;
 		// CBA LINK
 		//Type::Destination::types _type = Type::Destination::LINK;
 		Destination _owner = {Type::NONE};
 		bool _initiator = false;
+		// CBA Set once a resource advertisement from the peer has shown it takes LZ compressed resources
+		bool _peer_compression = false;
 		uint8_t _expected_hops = 0;
 		Interface _attached_interface = {Type::NONE};
 		Identity __remote_identity = {Type::NONE};
@@ -70,7 +77,7 @@ namespace RNS {
 		double _establishment_timeout = 0.0;
 		Bytes _request_data;
 		Packet _packet = {Type::NONE};
-		double _request_time = 0.0;
+		uint64_t _request_time = 0;
 		float _establishment_rate = 0.0;
         float _expected_rate = 0.0;
 		Type::Link::teardown_reason _teardown_reason = Type::Link::TEARDOWN_NONE;
@@ -101,7 +101,7 @@ void RNS::doLog(LogLevel level, const char* msg) {
 #endif
 }
 
-void HEAD(const char* msg, LogLevel level) {
+void RNS::head(const char* msg, LogLevel level) {
 	if (level > _level) {
 		return;
 	}
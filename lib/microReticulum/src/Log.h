@@ -8,30 +8,39 @@
 
 #include <string>
 
-#define LOG(msg, level) (RNS::log(msg, level))
-#define LOGF(level, msg, ...) (RNS::logf(level, msg, __VA_ARGS__))
-#define HEAD(msg, level) (RNS::head(msg, level))
-#define HEADF(level, msg, ...) (RNS::headf(level, msg, __VA_ARGS__))
-#define CRITICAL(msg) (RNS::critical(msg))
-#define CRITICALF(msg, ...) (RNS::criticalf(msg, __VA_ARGS__))
-#define ERROR(msg) (RNS::error(msg))
-#define ERRORF(msg, ...) (RNS::errorf(msg, __VA_ARGS__))
-#define WARNING(msg) (RNS::warning(msg))
-#define WARNINGF(msg, ...) (RNS::warningf(msg, __VA_ARGS__))
-#define NOTICE(msg) (RNS::notice(msg))
-#define NOTICEF(msg, ...) (RNS::noticef(msg, __VA_ARGS__))
-#define INFO(msg) (RNS::info(msg))
-#define INFOF(msg, ...) (RNS::infof(msg, __VA_ARGS__))
-#define VERBOSE(msg) (RNS::verbose(msg))
-#define VERBOSEF(msg, ...) (RNS::verbosef(msg, __VA_ARGS__))
+// CBA Messages less severe than RNS_LOG_MIN_LEVEL are compiled out. The others
+// are only formatted, and their arguments only evaluated, when the runtime level
+// lets them through, so a disabled log line costs one comparison. NDEBUG still
+// strips DEBUG, TRACE and MEM as before.
+#ifndef RNS_LOG_MIN_LEVEL
+	#define RNS_LOG_MIN_LEVEL 9		// RNS::LOG_MEM, keep every level
+#endif
+#define RNS_LOG_ENABLED(level) ((int)(level) <= RNS_LOG_MIN_LEVEL && RNS::loglevel() >= (level))
+
+#define LOG(msg, level) do { if (RNS_LOG_ENABLED(level)) RNS::log(msg, level); } while(0)
+#define LOGF(level, msg, ...) do { if (RNS_LOG_ENABLED(level)) RNS::logf(level, msg, __VA_ARGS__); } while(0)
+#define HEAD(msg, level) do { if (RNS_LOG_ENABLED(level)) RNS::head(msg, level); } while(0)
+#define HEADF(level, msg, ...) do { if (RNS_LOG_ENABLED(level)) RNS::headf(level, msg, __VA_ARGS__); } while(0)
+#define CRITICAL(msg) do { if (RNS_LOG_ENABLED(RNS::LOG_CRITICAL)) RNS::critical(msg); } while(0)
+#define CRITICALF(msg, ...) do { if (RNS_LOG_ENABLED(RNS::LOG_CRITICAL)) RNS::criticalf(msg, __VA_ARGS__); } while(0)
+#define ERROR(msg) do { if (RNS_LOG_ENABLED(RNS::LOG_ERROR)) RNS::error(msg); } while(0)
+#define ERRORF(msg, ...) do { if (RNS_LOG_ENABLED(RNS::LOG_ERROR)) RNS::errorf(msg, __VA_ARGS__); } while(0)
+#define WARNING(msg) do { if (RNS_LOG_ENABLED(RNS::LOG_WARNING)) RNS::warning(msg); } while(0)
+#define WARNINGF(msg, ...) do { if (RNS_LOG_ENABLED(RNS::LOG_WARNING)) RNS::warningf(msg, __VA_ARGS__); } while(0)
+#define NOTICE(msg) do { if (RNS_LOG_ENABLED(RNS::LOG_NOTICE)) RNS::notice(msg); } while(0)
+#define NOTICEF(msg, ...) do { if (RNS_LOG_ENABLED(RNS::LOG_NOTICE)) RNS::noticef(msg, __VA_ARGS__); } while(0)
+#define INFO(msg) do { if (RNS_LOG_ENABLED(RNS::LOG_INFO)) RNS::info(msg); } while(0)
+#define INFOF(msg, ...) do { if (RNS_LOG_ENABLED(RNS::LOG_INFO)) RNS::infof(msg, __VA_ARGS__); } while(0)
+#define VERBOSE(msg) do { if (RNS_LOG_ENABLED(RNS::LOG_VERBOSE)) RNS::verbose(msg); } while(0)
+#define VERBOSEF(msg, ...) do { if (RNS_LOG_ENABLED(RNS::LOG_VERBOSE)) RNS::verbosef(msg, __VA_ARGS__); } while(0)
 #ifndef NDEBUG
-	#define DEBUG(msg) do { if (RNS::loglevel() >= RNS::LOG_DEBUG) RNS::debug(msg); } while(0)
-	#define DEBUGF(msg, ...) do { if (RNS::loglevel() >= RNS::LOG_DEBUG) RNS::debugf(msg, __VA_ARGS__); } while(0)
-	#define TRACE(msg) do { if (RNS::loglevel() >= RNS::LOG_TRACE) RNS::trace(msg); } while(0)
-	#define TRACEF(msg, ...) do { if (RNS::loglevel() >= RNS::LOG_TRACE) RNS::tracef(msg, __VA_ARGS__); } while(0)
+	#define DEBUG(msg) do { if (RNS_LOG_ENABLED(RNS::LOG_DEBUG)) RNS::debug(msg); } while(0)
+	#define DEBUGF(msg, ...) do { if (RNS_LOG_ENABLED(RNS::LOG_DEBUG)) RNS::debugf(msg, __VA_ARGS__); } while(0)
+	#define TRACE(msg) do { if (RNS_LOG_ENABLED(RNS::LOG_TRACE)) RNS::trace(msg); } while(0)
+	#define TRACEF(msg, ...) do { if (RNS_LOG_ENABLED(RNS::LOG_TRACE)) RNS::tracef(msg, __VA_ARGS__); } while(0)
 	#if defined(RNS_MEM_LOG)
-		#define MEM(msg) (RNS::mem(msg))
-		#define MEMF(msg, ...) (RNS::memf(msg, __VA_ARGS__))
+		#define MEM(msg) do { if (RNS_LOG_ENABLED(RNS::LOG_MEM)) RNS::mem(msg); } while(0)
+		#define MEMF(msg, ...) do { if (RNS_LOG_ENABLED(RNS::LOG_MEM)) RNS::memf(msg, __VA_ARGS__); } while(0)
 	#else
 		#define MEM(ignore) ((void)0)
 		#define MEMF(...) ((void)0)
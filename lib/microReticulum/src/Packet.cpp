@@ -274,23 +274,33 @@ void Packet::pack() {
 	}
 	_object->_destination_hash = _object->_destination.hash();
 
-	_object->_header.clear();
 	_object->_encrypted = false;
 
-	_object->_header << _object->_flags;
-	_object->_header << _object->_hops;
+	// CBA The header is collected on the stack and written together with the ciphertext into
+	// a single raw buffer, instead of building a header Bytes and concatenating
+	uint8_t header[Type::Reticulum::HEADER_MAXSIZE];
+	size_t header_size = 0;
+	auto put_header = [&](const Bytes& field) {
+		if (header_size + field.size() > sizeof(header) - 1) {
+			throw std::length_error("Packet header exceeds " + std::to_string(sizeof(header)) + " bytes");
+		}
+		memcpy(header + header_size, field.data(), field.size());
+		header_size += field.size();
+	};
+	header[header_size++] = _object->_flags;
+	header[header_size++] = _object->_hops;
 
 	// CBA LINK
 	if (_object->_context == LRPROOF) {
 		if (!_object->_destination_link) throw std::invalid_argument("Packet is not associated with a Link");
 		TRACE("Packet::pack: destination link id: " + _object->_destination_link.link_id().toHex() );
-		_object->_header << _object->_destination_link.link_id();
+		put_header(_object->_destination_link.link_id());
 		_object->_ciphertext = _object->_data;
 	}
 	else {
 		if (_object->_header_type == HEADER_1) {
 			TRACE("Packet::pack: destination hash: " + _object->_destination.hash().toHex() );
-			_object->_header << _object->_destination.hash();
+			put_header(_object->_destination.hash());
 
 			if (_object->_packet_type == ANNOUNCE) {
 				// Announce packets are not encrypted
@@ -350,8 +360,8 @@ TRACEF("***** Destination Data: %s", _object->_ciphertext.toHex().c_str());
 			}
 			TRACE("Packet::pack: transport id: " + _object->_transport_id.toHex() );
 			TRACE("Packet::pack: destination hash: " + _object->_destination.hash().toHex() );
-			_object->_header << _object->_transport_id;
-			_object->_header << _object->_destination.hash();
+			put_header(_object->_transport_id);
+			put_header(_object->_destination.hash());
 
 			if (_object->_packet_type == ANNOUNCE) {
 				// Announce packets are not encrypted
@@ -363,18 +373,25 @@ TRACEF("***** Destination Data: %s", _object->_ciphertext.toHex().c_str());
 		}
 	}
 
-	_object->_header << (uint8_t)_object->_context;
-	_object->_raw = _object->_header + _object->_ciphertext;
+	header[header_size++] = (uint8_t)_object->_context;
 
-	if (_object->_raw.size() > _object->_MTU) {
-		throw std::length_error("Packet size of " + std::to_string(_object->_raw.size()) + " exceeds MTU of " + std::to_string(_object->_MTU) +" bytes");
+	size_t raw_size = header_size + _object->_ciphertext.size();
+	if (raw_size > _object->_MTU) {
+		throw std::length_error("Packet size of " + std::to_string(raw_size) + " exceeds MTU of " + std::to_string(_object->_MTU) +" bytes");
+	}
+	// the previous raw may still be shared (cache, transmit queues), it's replaced rather than copied
+	_object->_raw.clear();
+	uint8_t* raw = _object->_raw.writable(raw_size);
+	memcpy(raw, header, header_size);
+	if (_object->_ciphertext.size() > 0) {
+		memcpy(raw + header_size, _object->_ciphertext.data(), _object->_ciphertext.size());
 	}
 
 	_object->_packed = true;
 	update_hash();
 }
 
-bool Packet::unpack() {
+bool Packet::unpack(const uint8_t* packet_hash /*= nullptr*/) {
 	assert(_object);
 	TRACE("Packet::unpack: unpacking packet...");
 	try {
@@ -417,7 +434,13 @@ bool Packet::unpack() {
 		}
 
 		_object->_packed = false;
-		update_hash();
+		if (packet_hash) {
+			_object->_packet_hash.assign(packet_hash, Type::Reticulum::HASHLENGTH/8);
+			_object->_truncated_packet_hash.clear();
+		}
+		else {
+			update_hash();
+		}
 	}
 	catch (std::exception& e) {
 		ERROR(std::string("Received malformed packet, dropping it. The contained exception was: ") + e.what());
@@ -446,7 +469,7 @@ PacketReceipt Packet::send() {
             throw std::runtime_error("Attempt to transmit over a closed link");
 		}
 		else {
-			_object->_destination_link.last_outbound(OS::time());
+			_object->_destination_link.last_outbound(OS::ltime());
 			_object->_destination_link.increment_tx();
 			_object->_destination_link.increment_txbytes(_object->_data.size());
 		}
@@ -544,36 +567,61 @@ bool Packet::validate_proof(const Bytes& proof) {
 
 void Packet::update_hash() {
 	assert(_object);
-	_object->_packet_hash = get_hash();
+	// CBA Hash is memoized here (at the end of pack() and unpack()) and served by get_hash()
+	// and getTruncatedHash() until the packet is packed or unpacked again
+	_object->_packet_hash = compute_hash();
+	_object->_truncated_packet_hash.clear();
 }
 
 const Bytes Packet::get_hash() const {
 	assert(_object);
-	Bytes hashable_part = get_hashable_part();
-	// CBA MCU SHORTER HASH
-	return Identity::full_hash(hashable_part);
-	//return Identity::truncated_hash(hashable_part);
+	if (_object->_packet_hash) {
+		return _object->_packet_hash;
+	}
+	// not yet packed or unpacked so header fields may not be final, don't memoize
+	return compute_hash();
 }
 
 const Bytes Packet::getTruncatedHash() const {
 	assert(_object);
-	Bytes hashable_part = get_hashable_part();
-	return Identity::truncated_hash(hashable_part);
+	if (!_object->_packet_hash) {
+		return get_hash().left(Type::Identity::TRUNCATED_HASHLENGTH/8);
+	}
+	if (!_object->_truncated_packet_hash) {
+		_object->_truncated_packet_hash = _object->_packet_hash.left(Type::Identity::TRUNCATED_HASHLENGTH/8);
+	}
+	return _object->_truncated_packet_hash;
+}
+
+const Bytes Packet::compute_hash() const {
+	assert(_object);
+	// CBA Hash the masked flags byte and the raw tail directly rather than assembling the
+	// hashable part first, which saves a buffer allocation and copy for every packet
+	//Bytes hashable_part = get_hashable_part();
+	uint8_t flags = (uint8_t)(_object->_raw.data()[0] & 0b00001111);
+	BytesView tail = get_hashable_tail();
+	// CBA MCU SHORTER HASH
+	return Cryptography::sha256(&flags, 1, tail.data(), tail.size());
+	//return Identity::truncated_hash(hashable_part);
 }
 
 const Bytes Packet::get_hashable_part() const {
 	assert(_object);
-	Bytes hashable_part;
+	BytesView tail = get_hashable_tail();
+	Bytes hashable_part(tail.size() + 1);
 	hashable_part << (uint8_t)(_object->_raw.data()[0] & 0b00001111);
+	hashable_part << tail;
+	return hashable_part;
+}
+
+const BytesView Packet::get_hashable_tail() const {
+	assert(_object);
 	if (_object->_header_type == HEADER_2) {
 		//p hashable_part += self.raw[(RNS.Identity.TRUNCATED_HASHLENGTH//8)+2:]
-		hashable_part << _object->_raw.mid((Type::Identity::TRUNCATED_HASHLENGTH/8)+2);
-	}
-	else {
-		//p hashable_part += self.raw[2:];
-		hashable_part << _object->_raw.mid(2);
+		return _object->_raw.view((Type::Identity::TRUNCATED_HASHLENGTH/8)+2);
 	}
-	return hashable_part;
+	//p hashable_part += self.raw[2:];
+	return _object->_raw.view(2);
 }
 
 
@@ -792,6 +840,30 @@ std::string Packet::dumpString() const {
 #endif
 
 
+#if defined(RNS_USE_POOLS)
+/*static*/ Utilities::Pool Packet::Object::_pool("Packet objects", sizeof(Packet::Object), Type::Pool::PACKET_OBJECTS);
+
+/*static*/ void* Packet::Object::operator new(size_t size) {
+	void* p = _pool.allocate();
+	if (p == nullptr) {
+		// pool exhausted (counted), fall back to the heap
+		p = ::operator new(size);
+	}
+	return p;
+}
+
+/*static*/ void Packet::Object::operator delete(void* p) {
+	if (!_pool.release(p)) {
+		::operator delete(p);
+	}
+}
+
+/*static*/ void Packet::dump_pool_stats() {
+	Object::_pool.dump_stats();
+}
+#endif
+
+
 PacketReceipt::PacketReceipt(const Packet& packet) : _object(new Object()) {
 
 	if (!packet.destination()) {
@@ -7,6 +7,7 @@
 #include "Log.h"
 #include "Type.h"
 #include "Utilities/OS.h"
+#include "Utilities/Pool.h"
 
 #include <memory>
 #include <cassert>
@@ -63,6 +64,9 @@ namespace RNS {
 		inline bool operator < (const PacketReceipt& packet_receipt) const {
 			return _object.get() < packet_receipt._object.get();
 		}
+		inline bool operator == (const PacketReceipt& packet_receipt) const {
+			return _object.get() == packet_receipt._object.get();
+		}
 
 	public:
 		bool validate_proof_packet(const Packet& proof_packet);
@@ -74,6 +78,7 @@ namespace RNS {
 		bool validate_proof(const Bytes& proof, const Packet& proof_packet);
 		inline double get_rtt() { assert(_object); return _object->_concluded_at - _object->_sent_at; }
 		inline bool is_timed_out() { assert(_object); return ((_object->_sent_at + _object->_timeout) < Utilities::OS::time()); }
+		inline double timeout_at() const { assert(_object); return _object->_sent_at + _object->_timeout; }
 		void check_timeout();
 
 		// :param timeout: The timeout in seconds.
@@ -209,7 +214,8 @@ namespace RNS {
 		uint8_t get_packed_flags();
 		void unpack_flags(uint8_t flags);
 		void pack();
-		bool unpack();
+		// packet_hash, if given, is the hash already computed from the raw frame
+		bool unpack(const uint8_t* packet_hash = nullptr);
 		PacketReceipt send();
 		bool resend();
 		void prove(const Destination& destination = {Type::NONE});
@@ -220,8 +226,13 @@ namespace RNS {
 		const Bytes get_hash() const;
 		const Bytes getTruncatedHash() const;
 		const Bytes get_hashable_part() const;
+		// hashed region of raw that follows the flags byte, without copying it
+		const BytesView get_hashable_tail() const;
 
 		inline std::string toString() const { if (!_object) return ""; return "{Packet:" + _object->_packet_hash.toHex() + "}"; }
+#if defined(RNS_USE_POOLS)
+		static void dump_pool_stats();
+#endif
 
 		// getters
 		inline const Destination& destination() const { assert(_object); return _object->_destination; }
@@ -269,6 +280,9 @@ namespace RNS {
 		std::string dumpString() const;
 #endif
 
+	private:
+		const Bytes compute_hash() const;
+
 	private:
 		class Object {
 		public:
@@ -277,7 +291,15 @@ namespace RNS {
 			//Object(const Destination& destination, const Link& destination_link) : _destination(destination), _destination_link(destination_link) { MEM("Packet::Data object created, this: " + std::to_string((uintptr_t)this)); }
 			//Object(const Link& link) : _destination(link.destination()), _destination_link(link) { MEM("Packet::Data object created, this: " + std::to_string((uintptr_t)this)); }
 			virtual ~Object() { MEM("Packet::Data object destroyed, this: " + std::to_string((uintptr_t)this)); }
+#if defined(RNS_USE_POOLS)
+			// Packet objects are created and destroyed for every packet in flight, so they come from a slab pool
+			static void* operator new(size_t size);
+			static void operator delete(void* p);
+#endif
 		private:
+#if defined(RNS_USE_POOLS)
+			static Utilities::Pool _pool;
+#endif
 			Destination _destination = {Type::NONE};
 
 			// CBA LINK
@@ -316,6 +338,7 @@ namespace RNS {
 			float _q = 0.0;
 
 			Bytes _packet_hash;
+			Bytes _truncated_packet_hash;	// lazily derived from _packet_hash
 			Bytes _ratchet_id;
 			Bytes _destination_hash;
 			Bytes _transport_id;
@@ -325,7 +348,6 @@ namespace RNS {
 
 			Bytes _plaintext;	// used exclusively to relay decrypted resource advertisement form Link to Resource
 
-			Bytes _header;
 			Bytes _ciphertext;
 
 		friend class Packet;
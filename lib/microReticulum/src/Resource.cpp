@@ -3,68 +3,1235 @@
 #include "ResourceData.h"
 #include "Reticulum.h"
 #include "Transport.h"
+#include "Identity.h"
 #include "Packet.h"
 #include "Log.h"
+#include "Cryptography/Random.h"
+#include "Utilities/Compression.h"
+#include "Utilities/OS.h"
 
 #include <algorithm>
+#include <math.h>
+#include <string.h>
 
 using namespace RNS;
 using namespace RNS::Type::Resource;
 using namespace RNS::Utilities;
 
-//Resource::Resource(const Link& link /*= {Type::NONE}*/) :
-//	_object(new ResourceData(link))
-//{
-//	assert(_object);
-//	MEM("Resource object created");
-//}
+/*static*/ std::set<Resource> Resource::_resources;
 
-Resource::Resource(const Bytes& data, const Link& link, const Bytes& request_id, bool is_response, double timeout) :
+static const uint8_t FLAG_ENCRYPTED    = 0x01;
+static const uint8_t FLAG_COMPRESSED   = 0x02;
+static const uint8_t FLAG_SPLIT        = 0x04;
+static const uint8_t FLAG_IS_REQUEST   = 0x08;
+static const uint8_t FLAG_IS_RESPONSE  = 0x10;
+static const uint8_t FLAG_HAS_METADATA = 0x20;
+// CBA Bits RNS leaves unused. The first is set in every advertisement sent from here and
+// tells the peer this side takes resources compressed with Utilities::LzCompressor, the
+// second marks such a resource. A resource is only compressed once the peer on the link
+// has shown the first, RNS and older versions never see the second.
+static const uint8_t FLAG_LZ_CAPABLE   = 0x40;
+static const uint8_t FLAG_LZ           = 0x80;
+
+static const uint16_t HASHMAP_MAX_LEN = Type::Resource::ResourceAdvertisement::HASHMAP_MAX_LEN;
+static const uint16_t COLLISION_GUARD_SIZE = Type::Resource::ResourceAdvertisement::COLLISION_GUARD_SIZE;
+
+// CBA Minimal msgpack encoding for the advertisement map and the hashmap update array,
+// written out by hand since only a handful of fixed shapes are ever exchanged
+static void pack_uint(Bytes& packed, uint64_t value) {
+	if (value < 0x80) {
+		packed.append((uint8_t)value);
+	}
+	else if (value <= 0xFF) {
+		packed.append((uint8_t)0xcc);
+		packed.append((uint8_t)value);
+	}
+	else if (value <= 0xFFFF) {
+		packed.append((uint8_t)0xcd);
+		packed.append((uint8_t)(value >> 8));
+		packed.append((uint8_t)value);
+	}
+	else if (value <= 0xFFFFFFFF) {
+		packed.append((uint8_t)0xce);
+		for (int shift = 24; shift >= 0; shift -= 8) {
+			packed.append((uint8_t)(value >> shift));
+		}
+	}
+	else {
+		packed.append((uint8_t)0xcf);
+		for (int shift = 56; shift >= 0; shift -= 8) {
+			packed.append((uint8_t)(value >> shift));
+		}
+	}
+}
+
+static void pack_bin(Bytes& packed, const Bytes& value) {
+	size_t len = value.size();
+	if (len <= 0xFF) {
+		packed.append((uint8_t)0xc4);
+		packed.append((uint8_t)len);
+	}
+	else if (len <= 0xFFFF) {
+		packed.append((uint8_t)0xc5);
+		packed.append((uint8_t)(len >> 8));
+		packed.append((uint8_t)len);
+	}
+	else {
+		packed.append((uint8_t)0xc6);
+		for (int shift = 24; shift >= 0; shift -= 8) {
+			packed.append((uint8_t)(len >> shift));
+		}
+	}
+	packed.append(value);
+}
+
+static void pack_key(Bytes& packed, char key) {
+	packed.append((uint8_t)0xa1);
+	packed.append((uint8_t)key);
+}
+
+class MsgPackReader {
+public:
+	MsgPackReader(const Bytes& packed, size_t offset = 0) : _packed(packed), _pos(offset) {}
+
+	uint8_t next() {
+		if (_pos >= _packed.size()) {
+			throw std::invalid_argument("Truncated msgpack data");
+		}
+		return _packed.data()[_pos++];
+	}
+	uint64_t read_be(uint8_t len) {
+		uint64_t value = 0;
+		for (uint8_t i = 0; i < len; i++) {
+			value = (value << 8) | next();
+		}
+		return value;
+	}
+	bool read_nil() {
+		if (_pos < _packed.size() && _packed.data()[_pos] == 0xc0) {
+			++_pos;
+			return true;
+		}
+		return false;
+	}
+	uint64_t read_uint() {
+		uint8_t type = next();
+		if (type < 0x80) return type;
+		switch (type) {
+		case 0xcc: return read_be(1);
+		case 0xcd: return read_be(2);
+		case 0xce: return read_be(4);
+		case 0xcf: return read_be(8);
+		}
+		throw std::invalid_argument("Expected msgpack unsigned integer");
+	}
+	const Bytes read_bin() {
+		uint8_t type = next();
+		size_t len;
+		switch (type) {
+		case 0xc4: len = read_be(1); break;
+		case 0xc5: len = read_be(2); break;
+		case 0xc6: len = read_be(4); break;
+		default: throw std::invalid_argument("Expected msgpack bin");
+		}
+		if (len > _packed.size() - _pos) {
+			throw std::invalid_argument("Truncated msgpack bin");
+		}
+		Bytes value(_packed.data() + _pos, len);
+		_pos += len;
+		return value;
+	}
+	const std::string read_str() {
+		uint8_t type = next();
+		size_t len;
+		if ((type & 0xe0) == 0xa0) len = type & 0x1f;
+		else if (type == 0xd9) len = read_be(1);
+		else throw std::invalid_argument("Expected msgpack str");
+		if (len > _packed.size() - _pos) {
+			throw std::invalid_argument("Truncated msgpack str");
+		}
+		std::string value((const char*)_packed.data() + _pos, len);
+		_pos += len;
+		return value;
+	}
+	size_t read_container(uint8_t fix, uint8_t fix_mask, uint8_t type16) {
+		uint8_t type = next();
+		if ((type & fix_mask) == fix) return type & ~fix_mask;
+		if (type == type16) return read_be(2);
+		if (type == type16 + 1) return read_be(4);
+		throw std::invalid_argument("Expected msgpack container");
+	}
+	inline size_t read_map() { return read_container(0x80, 0xf0, 0xde); }
+	inline size_t read_array() { return read_container(0x90, 0xf0, 0xdc); }
+
+private:
+	const Bytes& _packed;
+	size_t _pos;
+};
+
+
+Resource::Resource(const Link& link) :
 	_object(new ResourceData(link))
 {
 	assert(_object);
 	MEM("Resource object created");
 }
 
+Resource::Resource(const Bytes& data, const Link& link, const Bytes& request_id, bool is_response, double timeout /*= 0.0*/) :
+	Resource(data, link, true, true, nullptr, nullptr, timeout, 1, {Type::NONE}, request_id, is_response)
+{
+}
+
 Resource::Resource(const Bytes& data, const Link& link, bool advertise /*= true*/, bool auto_compress /*= true*/, Callbacks::concluded callback /*= nullptr*/, Callbacks::progress progress_callback /*= nullptr*/, double timeout /*= 0.0*/, int segment_index /*= 1*/, const Bytes& original_hash /*= {Type::NONE}*/, const Bytes& request_id /*= {Type::NONE}*/, bool is_response /*= false*/) :
 	_object(new ResourceData(link))
 {
 	assert(_object);
 	MEM("Resource object created");
+	// CBA bz2 is not available here, auto_compress uses the streaming LZ compressor when the peer takes it
+	_object->_request_id = request_id;
+	_object->_is_response = is_response;
+	_object->_segment_index = segment_index;
+	_object->_original_hash = original_hash;
+	_object->_callbacks._concluded = callback;
+	_object->_callbacks._progress = progress_callback;
+	_object->_timeout = timeout;
+	if (!prepare({}, data, auto_compress)) {
+		_object->_status = FAILED;
+		return;
+	}
+	if (advertise) {
+		this->advertise();
+	}
+}
+
+Resource::Resource(const char* file_path, const Link& link, bool advertise /*= true*/, bool auto_compress /*= true*/, Callbacks::concluded callback /*= nullptr*/, Callbacks::progress progress_callback /*= nullptr*/, double timeout /*= 0.0*/) :
+	_object(new ResourceData(link))
+{
+	assert(_object);
+	MEM("Resource object created");
+	_object->_callbacks._concluded = callback;
+	_object->_callbacks._progress = progress_callback;
+	_object->_timeout = timeout;
+	if (!prepare(file_path, {Bytes::NONE}, auto_compress)) {
+		_object->_status = FAILED;
+		return;
+	}
+	if (advertise) {
+		this->advertise();
+	}
+}
+
+/*
+Hash, encrypt and map the outgoing data.
+
+The token (iv, ciphertext, HMAC) is produced incrementally and cut into parts as it
+goes, so with a file source and spooling only one chunk and one part are in RAM at a
+time. A map hash collision within the collision guard means another random hash has
+to be drawn and everything redone, as in RNS.
+
+With auto_compress, the data is compressed chunk by chunk on its way into the
+encryptor. A dry run first tells whether that pays, if not the data is sent as is.
+*/
+bool Resource::prepare(const std::string& source_path, const Bytes& source, bool auto_compress) {
+	assert(_object);
+	ResourceData& d = *_object;
+	d._initiator = true;
+	d._encrypted = true;
+	d._timeout_factor = d._link.traffic_timeout_factor();
+	if (d._timeout == 0.0) {
+		d._timeout = d._link.rtt() * d._link.traffic_timeout_factor();
+	}
+	d._sdu = d._link.mtu() - Type::Reticulum::HEADER_MAXSIZE - Type::Reticulum::IFAC_MIN_SIZE;
+
+	size_t data_size = source.size();
+	if (!source_path.empty()) {
+		FileStream stream = OS::open_file(source_path.c_str(), FileStream::MODE_READ);
+		if (!stream) {
+			ERRORF("Could not open %s for sending as resource", source_path.c_str());
+			return false;
+		}
+		data_size = stream.size();
+		stream.close();
+	}
+	if (data_size > MAX_EFFICIENT_SIZE) {
+		// CBA Multi-segment resources are not supported
+		ERRORF("Cannot send %u bytes as a single resource segment", data_size);
+		return false;
+	}
+	d._total_size = data_size;
+
+	// Feed the source to fn in chunks
+	auto each_chunk = [&](auto fn) -> bool {
+		if (source_path.empty()) {
+			for (size_t offset = 0; offset < source.size(); offset += SPOOL_CHUNK_SIZE) {
+				fn(source.mid(offset, SPOOL_CHUNK_SIZE));
+			}
+			return true;
+		}
+		FileStream stream = OS::open_file(source_path.c_str(), FileStream::MODE_READ);
+		if (!stream) {
+			return false;
+		}
+		size_t remaining = data_size;
+		Bytes chunk;
+		while (remaining > 0) {
+			size_t len = std::min<size_t>(remaining, SPOOL_CHUNK_SIZE);
+			if (stream.readBytes(chunk.writable(len), len) != len) {
+				return false;
+			}
+			fn(chunk);
+			remaining -= len;
+		}
+		stream.close();
+		return true;
+	};
+
+	size_t payload_size = data_size;
+	if (auto_compress && d._link.peer_compression() && data_size > 0 && data_size <= AUTO_COMPRESS_MAX_SIZE) {
+		std::unique_ptr<Utilities::LzCompressor> compressor(new Utilities::LzCompressor());
+		size_t compressed_size = 0;
+		Bytes packed;
+		auto measure = [&](const Bytes& chunk) {
+			compressor->update(chunk, packed);
+			compressed_size += packed.size();
+			packed.clear();
+		};
+		if (!each_chunk(measure)) {
+			ERROR("Failed reading resource source");
+			return false;
+		}
+		compressor->finish(packed);
+		compressed_size += packed.size();
+		if (compressed_size < data_size) {
+			d._compressed = true;
+			payload_size = compressed_size;
+		}
+	}
+
+	// Token of the random prefix and the payload: iv, padded ciphertext and HMAC
+	d._size = 16 + (((RANDOM_HASH_SIZE + payload_size) / 16) + 1) * 16 + 32;
+	d._total_parts = (uint32_t)ceil((double)d._size / (double)d._sdu);
+	d._sent.assign(d._total_parts, false);
+
+	d._flags = FLAG_ENCRYPTED | FLAG_LZ_CAPABLE;
+	if (d._compressed) {
+		d._flags |= FLAG_LZ;
+	}
+	if (d._request_id) {
+		d._flags |= (d._is_response ? FLAG_IS_RESPONSE : FLAG_IS_REQUEST);
+	}
+
+	bool spool = (d._size > SPOOL_THRESHOLD && OS::get_filesystem());
+	if (spool) {
+		char spool_path[Type::Reticulum::FILEPATH_MAXSIZE];
+		snprintf(spool_path, Type::Reticulum::FILEPATH_MAXSIZE, "%s/resource_%s", Reticulum::_cachepath, Cryptography::random(8).toHex().c_str());
+		d._spool_path = spool_path;
+	}
+	d._token = d._link.token();
+
+	for (uint8_t attempt = 0; attempt < HASHMAP_ATTEMPTS; attempt++) {
+		d._random_hash = Identity::get_random_hash().left(RANDOM_HASH_SIZE);
+
+		Cryptography::SHA256Engine digest;
+		digest.reset();
+		if (!each_chunk([&](const Bytes& chunk) { digest.update(chunk.data(), chunk.size()); })) {
+			ERROR("Failed reading resource source");
+			return false;
+		}
+		digest.update(d._random_hash.data(), d._random_hash.size());
+		digest.finalize(d._hash.writable(32), 32);
+		if (!d._original_hash) {
+			d._original_hash = d._hash;
+		}
+
+		d._data.clear();
+		d._hashmap.clear();
+		if (spool && !spool_open(FileStream::MODE_WRITE)) {
+			ERROR("Could not open resource spool file, keeping resource in RAM");
+			spool = false;
+			d._spool_path.clear();
+		}
+
+		bool hashmap_ok = true;
+		bool write_ok = true;
+		auto map_part = [&](const Bytes& part_data) {
+			const Bytes map_hash(get_map_hash(part_data));
+			// Map hashes only need to be unique within the window the receiver searches
+			size_t count = d._hashmap.size() / MAPHASH_LEN;
+			size_t guard = std::min<size_t>(count, COLLISION_GUARD_SIZE);
+			for (size_t i = count - guard; i < count; i++) {
+				if (memcmp(d._hashmap.data() + i * MAPHASH_LEN, map_hash.data(), MAPHASH_LEN) == 0) {
+					hashmap_ok = false;
+				}
+			}
+			d._hashmap.append(map_hash);
+			if (spool) {
+				write_ok = (d._spool.write(part_data.data(), part_data.size()) == part_data.size());
+			}
+			else {
+				d._data.append(part_data);
+			}
+		};
+		Bytes part;
+		auto emit = [&](const Bytes& ciphertext) {
+			part.append(ciphertext);
+			while (hashmap_ok && write_ok && part.size() >= d._sdu) {
+				map_part(part.left(d._sdu));
+				part = part.mid(d._sdu);
+			}
+		};
+
+		Cryptography::SHA256Engine proof;
+		proof.reset();
+		Cryptography::Token::Encryptor encryptor(*d._token);
+		std::unique_ptr<Utilities::LzCompressor> compressor(d._compressed ? new Utilities::LzCompressor() : nullptr);
+		Bytes packed;
+		emit(encryptor.begin());
+		emit(encryptor.update(Identity::get_random_hash().left(RANDOM_HASH_SIZE)));
+		if (!each_chunk([&](const Bytes& chunk) {
+			proof.update(chunk.data(), chunk.size());
+			if (compressor) {
+				compressor->update(chunk, packed);
+				emit(encryptor.update(packed));
+				packed.clear();
+			}
+			else {
+				emit(encryptor.update(chunk));
+			}
+		})) {
+			ERROR("Failed reading resource source");
+			spool_close();
+			release_spool(d);
+			return false;
+		}
+		if (compressor) {
+			compressor->finish(packed);
+			emit(encryptor.update(packed));
+		}
+		emit(encryptor.finish());
+		// The last part is whatever is left over
+		if (hashmap_ok && write_ok && part.size() > 0) {
+			map_part(part);
+		}
+		proof.update(d._hash.data(), d._hash.size());
+		proof.finalize(d._expected_proof.writable(32), 32);
+		spool_close();
+
+		if (!write_ok) {
+			ERROR("Failed writing resource spool file");
+			release_spool(d);
+			return false;
+		}
+		if (hashmap_ok) {
+			TRACEF("Resource %s prepared, %u bytes in %u parts", d._hash.toHex().c_str(), d._size, d._total_parts);
+			return true;
+		}
+		DEBUG("Map hash collision detected, retrying resource preparation with a new random hash");
+		d._original_hash = {Bytes::NONE};
+	}
+	ERROR("Could not find a collision free hashmap for resource");
+	release_spool(d);
+	return false;
+}
+
+bool Resource::spool_open(FileStream::MODE mode) {
+	assert(_object);
+	_object->_spool = OS::open_file(_object->_spool_path.c_str(), mode);
+	_object->_spool_position = 0;
+	return (bool)_object->_spool;
+}
+
+void Resource::spool_close() {
+	assert(_object);
+	if (_object->_spool) {
+		_object->_spool.close();
+		_object->_spool = {Type::NONE};
+	}
+}
+
+/*static*/ void Resource::release_spool(ResourceData& data) {
+	if (data._spool) {
+		data._spool.close();
+		data._spool = {Type::NONE};
+	}
+	if (!data._spool_path.empty()) {
+		try {
+			OS::remove_file(data._spool_path.c_str());
+		}
+		catch (std::exception& e) {
+		}
+		data._spool_path.clear();
+	}
+}
+
+const Bytes Resource::read_part(uint32_t index) {
+	assert(_object);
+	ResourceData& d = *_object;
+	size_t offset = (size_t)index * d._sdu;
+	size_t len = std::min<size_t>(d._sdu, d._size - offset);
+	if (d._spool_path.empty()) {
+		return d._data.mid(offset, len);
+	}
+	if (!d._spool || offset != d._spool_position) {
+		if (!d._spool || !d._spool.seek(offset)) {
+			// No seek support, reopen and skip up to the part
+			spool_close();
+			if (!spool_open(FileStream::MODE_READ)) {
+				return {Bytes::NONE};
+			}
+			Bytes skip;
+			while (d._spool_position < offset) {
+				size_t skip_len = std::min<size_t>(offset - d._spool_position, SPOOL_CHUNK_SIZE);
+				if (d._spool.readBytes(skip.writable(skip_len), skip_len) != skip_len) {
+					return {Bytes::NONE};
+				}
+				d._spool_position += skip_len;
+			}
+		}
+		d._spool_position = offset;
+	}
+	Bytes part_data;
+	if (d._spool.readBytes(part_data.writable(len), len) != len) {
+		return {Bytes::NONE};
+	}
+	d._spool_position += len;
+	return part_data;
+}
+
+void Resource::send_part(uint32_t index) {
+	assert(_object);
+	const Bytes part_data(read_part(index));
+	if (!part_data) {
+		ERRORF("Could not read part %u of resource %s", index, toString().c_str());
+		cancel();
+		return;
+	}
+	Packet part(_object->_link, part_data, Type::Packet::DATA, Type::Packet::RESOURCE);
+	part.send();
+	_object->_last_activity = OS::time();
+	_object->_last_part_sent = _object->_last_activity;
+	if (!_object->_sent[index]) {
+		_object->_sent[index] = true;
+		++_object->_sent_parts;
+	}
+}
+
+/*static*/ Resource Resource::accept(const Packet& advertisement_packet, Callbacks::concluded callback /*= nullptr*/, Callbacks::progress progress_callback /*= nullptr*/, const Bytes& request_id /*= {Bytes::NONE}*/) {
+	try {
+		RNS::ResourceAdvertisement adv(RNS::ResourceAdvertisement::unpack(const_cast<Packet&>(advertisement_packet).plaintext()));
+		Link link(advertisement_packet.link());
+		if (adv._f & FLAG_LZ_CAPABLE) {
+			link.peer_compression(true);
+		}
+		if (adv._c || adv._s || adv._x || adv._l > 1) {
+			// CBA Compression, segmentation and metadata are not supported, tell the sender
+			WARNINGF("Rejecting resource %s, compressed, segmented or metadata resources are not supported", adv._h.toHex().c_str());
+			Packet reject_packet(link, adv._h, Type::Packet::DATA, Type::Packet::RESOURCE_RCL);
+			reject_packet.send();
+			return {Type::NONE};
+		}
+		// CBA The part count and map size follow from the transfer size, so a peer can't make
+		// us allocate for parts that don't exist, and the first map segment can't be empty
+		uint16_t sdu = link.mtu() - Type::Reticulum::HEADER_MAXSIZE - Type::Reticulum::IFAC_MIN_SIZE;
+		if (adv._h.size() != Type::Identity::HASHLENGTH/8 || adv._r.size() != RANDOM_HASH_SIZE ||
+			adv._t == 0 || adv._t > MAX_INCOMING_SIZE || adv._d > MAX_EFFICIENT_SIZE ||
+			adv._n != (adv._t + sdu - 1) / sdu || adv._m.size() < MAPHASH_LEN) {
+			throw std::invalid_argument("Inconsistent resource advertisement");
+		}
+
+		Resource resource(link);
+		ResourceData& d = *resource._object;
+		d._status = TRANSFERRING;
+		d._flags = adv._f;
+		d._size = adv._t;
+		d._total_size = adv._d;
+		d._total_parts = adv._n;
+		d._sdu = sdu;
+		d._hash = adv._h;
+		d._random_hash = adv._r;
+		d._original_hash = adv._o;
+		d._segment_index = adv._i;
+		d._total_segments = adv._l;
+		d._encrypted = adv._e;
+		d._is_response = adv._p;
+		d._request_id = request_id;
+		d._initiator = false;
+		d._callbacks._concluded = callback;
+		d._callbacks._progress = progress_callback;
+		d._received.assign(d._total_parts, false);
+		d._hashmap.writable(d._total_parts * MAPHASH_LEN);
+		d._hashmap_height = 0;
+		d._last_activity = OS::time();
+		d._started_transferring = d._last_activity;
+
+		if (link.has_incoming_resource(resource)) {
+			DEBUGF("Ignoring resource advertisement for %s, resource already transferring", d._hash.toHex().c_str());
+			return {Type::NONE};
+		}
+
+		// Requests and responses are handed to Link as Bytes, so only plain resources spool.
+		// Compressed data is spooled by the size it expands to.
+		if (std::max(d._size, d._total_size) > SPOOL_THRESHOLD && !adv._u && !adv._p && OS::get_filesystem()) {
+			char spool_path[Type::Reticulum::FILEPATH_MAXSIZE];
+			snprintf(spool_path, Type::Reticulum::FILEPATH_MAXSIZE, "%s/resource_%s", Reticulum::_cachepath, d._hash.left(8).toHex().c_str());
+			d._spool_path = spool_path;
+			if (!resource.spool_open(FileStream::MODE_WRITE)) {
+				ERROR("Could not open resource spool file, receiving into RAM");
+				d._spool_path.clear();
+			}
+		}
+		if (d._encrypted) {
+			d._token = link.token();
+			d._decryptor.reset(new Cryptography::Token::Decryptor(*d._token));
+		}
+		if (adv._f & FLAG_LZ) {
+			d._decompressor.reset(new Utilities::LzDecompressor());
+		}
+		d._data_hash.reset(new Cryptography::SHA256Engine());
+		d._data_hash->reset();
+		d._proof_hash.reset(new Cryptography::SHA256Engine());
+		d._proof_hash->reset();
+
+		link.register_incoming_resource(resource);
+		DEBUGF("Accepting resource advertisement for %s. Transfer size is %u in %u parts.", d._hash.toHex().c_str(), d._size, d._total_parts);
+		link.resource_started(resource);
+		_resources.insert(resource);
+		resource.hashmap_update(0, adv._m);
+		return resource;
+	}
+	catch (std::exception& e) {
+		ERRORF("Could not decode resource advertisement, dropping resource. The contained exception was: %s", e.what());
+		return {Type::NONE};
+	}
 }
 
+void Resource::hashmap_update_packet(const Bytes& plaintext) {
+	assert(_object);
+	if (_object->_status == FAILED) {
+		return;
+	}
+	_object->_last_activity = OS::time();
+	_object->_retries_left = _object->_max_retries;
+	try {
+		MsgPackReader reader(plaintext, Type::Identity::HASHLENGTH/8);
+		if (reader.read_array() != 2) {
+			throw std::invalid_argument("Expected segment and hashmap");
+		}
+		uint32_t segment = (uint32_t)reader.read_uint();
+		const Bytes hashmap(reader.read_bin());
+		hashmap_update(segment, hashmap);
+	}
+	catch (std::exception& e) {
+		ERRORF("Could not decode hashmap update for %s. The contained exception was: %s", toString().c_str(), e.what());
+	}
+}
+
+void Resource::hashmap_update(uint32_t segment, const Bytes& hashmap) {
+	assert(_object);
+	ResourceData& d = *_object;
+	if (d._status == FAILED) {
+		return;
+	}
+	size_t hashes = hashmap.size() / MAPHASH_LEN;
+	uint8_t* map = d._hashmap.writable(0);
+	for (size_t i = 0; i < hashes; i++) {
+		size_t index = i + (size_t)segment * HASHMAP_MAX_LEN;
+		if (index >= d._total_parts) {
+			break;
+		}
+		// Segments fill the map in order, so anything below the height is already known
+		if (index == d._hashmap_height) {
+			memcpy(map + index * MAPHASH_LEN, hashmap.data() + i * MAPHASH_LEN, MAPHASH_LEN);
+			++d._hashmap_height;
+		}
+	}
+	d._waiting_for_hmu = false;
+	request_next();
+}
+
+const Bytes Resource::get_map_hash(const Bytes& data) const {
+	assert(_object);
+	return Cryptography::sha256(data.data(), data.size(), _object->_random_hash.data(), _object->_random_hash.size()).left(MAPHASH_LEN);
+}
+
+void Resource::advertise() {
+	assert(_object);
+	ResourceData& d = *_object;
+	if (d._status >= COMPLETE) {
+		return;
+	}
+	// Only one outgoing resource is advertised per link at a time, the rest wait in QUEUED
+	if (!d._link.ready_for_new_resource()) {
+		d._status = QUEUED;
+		_resources.insert(*this);
+		return;
+	}
+	try {
+		RNS::ResourceAdvertisement advertisement(*this);
+		d._advertisement_packet = Packet(d._link, advertisement.pack(), Type::Packet::DATA, Type::Packet::RESOURCE_ADV);
+		d._advertisement_packet.send();
+		d._last_activity = OS::time();
+		d._started_transferring = d._last_activity;
+		d._adv_sent = d._last_activity;
+		d._rtt = 0.0;
+		d._status = ADVERTISED;
+		d._retries_left = d._max_adv_retries;
+		d._link.register_outgoing_resource(*this);
+		_resources.insert(*this);
+		DEBUGF("Sent resource advertisement for %s", toString().c_str());
+	}
+	catch (std::exception& e) {
+		ERRORF("Could not advertise resource, the contained exception was: %s", e.what());
+		cancel();
+	}
+}
+
+/*static*/ void Resource::watchdog_jobs() {
+	if (_resources.empty()) {
+		return;
+	}
+	// Copy since watchdogs conclude resources and remove them from the set
+	std::set<Resource> resources(_resources);
+	for (auto& resource : resources) {
+		const_cast<Resource&>(resource).watchdog_job();
+	}
+}
+
+void Resource::watchdog_job() {
+	assert(_object);
+	ResourceData& d = *_object;
+	if (d._status >= ASSEMBLING) {
+		_resources.erase(*this);
+		return;
+	}
+	if (d._link.status() == Type::Link::CLOSED) {
+		cancel();
+		return;
+	}
+	double now = OS::time();
+	switch (d._status) {
+	case QUEUED:
+		if (d._link.ready_for_new_resource()) {
+			advertise();
+		}
+		break;
+	case ADVERTISED:
+		if (now > d._adv_sent + d._timeout + PROCESSING_GRACE) {
+			if (d._retries_left <= 0) {
+				DEBUG("Resource transfer timeout after sending advertisement");
+				cancel();
+			}
+			else {
+				DEBUG("No part requests received, retrying resource advertisement...");
+				--d._retries_left;
+				d._advertisement_packet.resend();
+				d._last_activity = now;
+				d._adv_sent = now;
+			}
+		}
+		break;
+	case TRANSFERRING:
+		if (!d._initiator) {
+			uint8_t retries_used = d._max_retries - d._retries_left;
+			double extra_wait = retries_used * PER_RETRY_DELAY;
+			// Until the first part arrives only the link RTT is known
+			double rtt = (d._rtt != 0.0) ? d._rtt : d._link.rtt();
+			double deadline = d._last_activity + (rtt * (d._part_timeout_factor + d._outstanding_parts)) + RETRY_GRACE_TIME + extra_wait;
+			if (now > deadline) {
+				if (d._retries_left > 0) {
+					// Timed out waiting for parts, shrink the window and ask again
+					if (d._window > d._window_min) {
+						--d._window;
+						if (d._window_max > d._window_min) {
+							--d._window_max;
+							if ((d._window_max - d._window) > (d._window_flexibility - 1)) {
+								--d._window_max;
+							}
+						}
+					}
+					DEBUGF("Timed out waiting for %u parts, requesting retry", d._outstanding_parts);
+					--d._retries_left;
+					d._waiting_for_hmu = false;
+					request_next();
+				}
+				else {
+					cancel();
+				}
+			}
+		}
+		else {
+			double max_extra_wait = 0.0;
+			for (uint8_t retry = 0; retry < MAX_RETRIES; retry++) {
+				max_extra_wait += (retry + 1) * PER_RETRY_DELAY;
+			}
+			double max_wait = d._rtt * d._timeout_factor * d._max_retries + d._sender_grace_time + max_extra_wait;
+			if (now > d._last_activity + max_wait) {
+				DEBUG("Resource timed out waiting for part requests");
+				cancel();
+			}
+		}
+		break;
+	case AWAITING_PROOF:
+		d._timeout_factor = PROOF_TIMEOUT_FACTOR;
+		if (now > d._last_part_sent + (d._rtt * d._timeout_factor + d._sender_grace_time)) {
+			if (d._retries_left <= 0) {
+				DEBUG("Resource timed out waiting for proof");
+				cancel();
+			}
+			else {
+				DEBUG("All parts sent, but no resource proof received, querying network cache...");
+				--d._retries_left;
+				Bytes expected_data(d._hash);
+				expected_data.append(d._expected_proof);
+				Packet expected_proof_packet(d._link, expected_data, Type::Packet::PROOF, Type::Packet::RESOURCE_PRF);
+				expected_proof_packet.pack();
+				Transport::cache_request(expected_proof_packet.packet_hash(), d._link);
+				d._last_part_sent = now;
+			}
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/*
+Decrypt, hash and store the contiguous run of parts. Parts that arrive ahead of a gap
+wait in the reorder buffer, which holds at most one window.
+*/
+void Resource::flush_parts() {
+	assert(_object);
+	ResourceData& d = *_object;
+	while (true) {
+		auto iter = d._reorder.find((uint32_t)(d._consecutive_completed_height + 1));
+		if (iter == d._reorder.end()) {
+			break;
+		}
+		Bytes plaintext;
+		if (d._encrypted) {
+			plaintext = d._decryptor->update((*iter).second);
+		}
+		else {
+			plaintext = (*iter).second;
+		}
+		d._reorder.erase(iter);
+		++d._consecutive_completed_height;
+		if (!sink(plaintext)) {
+			ERRORF("Could not store received parts of %s", toString().c_str());
+			cancel();
+			return;
+		}
+	}
+}
+
+bool Resource::sink(const Bytes& plaintext) {
+	assert(_object);
+	ResourceData& d = *_object;
+	if (plaintext.size() == 0) {
+		return true;
+	}
+	// Strip the random prefix the sender put in front of the data
+	size_t offset = 0;
+	if (d._prefix_skipped < RANDOM_HASH_SIZE) {
+		offset = std::min<size_t>(RANDOM_HASH_SIZE - d._prefix_skipped, plaintext.size());
+		d._prefix_skipped += offset;
+	}
+	size_t len = plaintext.size() - offset;
+	if (len == 0) {
+		return true;
+	}
+	const uint8_t* data = plaintext.data() + offset;
+	Bytes expanded;
+	if (d._decompressor) {
+		if (!d._decompressor->update(data, len, expanded, d._total_size)) {
+			ERRORF("Received data of %s does not decompress", toString().c_str());
+			return false;
+		}
+		data = expanded.data();
+		len = expanded.size();
+		if (len == 0) {
+			return true;
+		}
+	}
+	d._data_hash->update(data, len);
+	d._proof_hash->update(data, len);
+	if (d._spool) {
+		return (d._spool.write(data, len) == len);
+	}
+	d._data.append(data, len);
+	return true;
+}
+
+void Resource::assemble() {
+	assert(_object);
+	ResourceData& d = *_object;
+	if (d._status == FAILED) {
+		return;
+	}
+	d._status = ASSEMBLING;
+	try {
+		bool stored = true;
+		if (d._encrypted) {
+			stored = sink(d._decryptor->finish());
+		}
+		if (d._decompressor && !d._decompressor->finished()) {
+			stored = false;
+		}
+		spool_close();
+		Bytes calculated_hash;
+		d._data_hash->update(d._random_hash.data(), d._random_hash.size());
+		d._data_hash->finalize(calculated_hash.writable(32), 32);
+		if (stored && calculated_hash == d._hash) {
+			d._proof_hash->update(d._hash.data(), d._hash.size());
+			d._proof_hash->finalize(d._expected_proof.writable(32), 32);
+			d._status = COMPLETE;
+			prove();
+		}
+		else {
+			d._status = CORRUPT;
+		}
+	}
+	catch (std::exception& e) {
+		ERRORF("Error while assembling received resource. The contained exception was: %s", e.what());
+		d._status = CORRUPT;
+	}
+	conclude();
+}
+
+void Resource::prove() {
+	assert(_object);
+	if (_object->_status == FAILED) {
+		return;
+	}
+	try {
+		Bytes proof_data(_object->_hash);
+		proof_data.append(_object->_expected_proof);
+		Packet proof_packet(_object->_link, proof_data, Type::Packet::PROOF, Type::Packet::RESOURCE_PRF);
+		proof_packet.send();
+	}
+	catch (std::exception& e) {
+		ERRORF("Could not send proof packet, cancelling resource. The contained exception was: %s", e.what());
+		cancel();
+	}
+}
 
 void Resource::validate_proof(const Bytes& proof_data) {
+	assert(_object);
+	if (_object->_status == FAILED) {
+		return;
+	}
+	if (proof_data.size() == (Type::Identity::HASHLENGTH/8)*2 && proof_data.mid(Type::Identity::HASHLENGTH/8) == _object->_expected_proof) {
+		_object->_status = COMPLETE;
+		conclude();
+	}
 }
 
-void Resource::cancel() {
+void Resource::receive_part(const Packet& packet) {
+	assert(_object);
+	ResourceData& d = *_object;
+	if (d._initiator || d._status == FAILED || d._status >= ASSEMBLING) {
+		return;
+	}
+	d._last_activity = OS::time();
+	d._retries_left = d._max_retries;
+
+	if (d._req_resp == 0.0) {
+		d._req_resp = d._last_activity;
+		double rtt = d._req_resp - d._req_sent;
+		d._part_timeout_factor = PART_TIMEOUT_FACTOR_AFTER_RTT;
+		if (d._rtt == 0.0) {
+			d._rtt = d._link.rtt();
+		}
+		else if (rtt < d._rtt) {
+			d._rtt = std::max(d._rtt - d._rtt*0.05, rtt);
+		}
+		else if (rtt > d._rtt) {
+			d._rtt = std::min(d._rtt + d._rtt*0.05, rtt);
+		}
+		if (rtt > 0) {
+			double req_resp_rtt_rate = (packet.raw().size() + d._req_sent_bytes) / rtt;
+			if (req_resp_rtt_rate > RATE_FAST && d._fast_rate_rounds < FAST_RATE_THRESHOLD) {
+				++d._fast_rate_rounds;
+				if (d._fast_rate_rounds == FAST_RATE_THRESHOLD) {
+					d._window_max = WINDOW_MAX_FAST;
+				}
+			}
+		}
+	}
+
+	d._status = TRANSFERRING;
+	const Bytes& part_data = packet.data();
+	const Bytes part_hash(get_map_hash(part_data));
+	// Only the window that was requested is searched
+	uint32_t start = (uint32_t)(d._consecutive_completed_height + 1);
+	uint32_t end = std::min<uint32_t>(start + d._window, d._hashmap_height);
+	bool received = false;
+	for (uint32_t i = start; i < end; i++) {
+		if (memcmp(d._hashmap.data() + i * MAPHASH_LEN, part_hash.data(), MAPHASH_LEN) == 0 && !d._received[i]) {
+			d._received[i] = true;
+			d._reorder[i] = part_data;
+			d._rtt_rxd_bytes += part_data.size();
+			++d._received_count;
+			if (d._outstanding_parts > 0) {
+				--d._outstanding_parts;
+			}
+			received = true;
+		}
+	}
+	if (!received) {
+		return;
+	}
+	flush_parts();
+	if (d._status == FAILED) {
+		return;
+	}
+	if (d._callbacks._progress != nullptr) {
+		try {
+			d._callbacks._progress(*this);
+		}
+		catch (std::exception& e) {
+			ERRORF("Error while executing progress callback from %s. The contained exception was: %s", toString().c_str(), e.what());
+		}
+	}
+	d._link.resource_progress(*this);
+
+	if (d._received_count == d._total_parts) {
+		assemble();
+	}
+	else if (d._outstanding_parts == 0) {
+		// Window complete, grow it
+		if (d._window < d._window_max) {
+			++d._window;
+			if ((d._window - d._window_min) > (d._window_flexibility - 1)) {
+				++d._window_min;
+			}
+		}
+		if (d._req_sent != 0.0) {
+			double rtt = OS::time() - d._req_sent;
+			size_t req_transferred = d._rtt_rxd_bytes - d._rtt_rxd_bytes_at_part_req;
+			if (rtt != 0) {
+				double req_data_rtt_rate = req_transferred / rtt;
+				d._rtt_rxd_bytes_at_part_req = d._rtt_rxd_bytes;
+				if (req_data_rtt_rate > RATE_FAST && d._fast_rate_rounds < FAST_RATE_THRESHOLD) {
+					++d._fast_rate_rounds;
+					if (d._fast_rate_rounds == FAST_RATE_THRESHOLD) {
+						d._window_max = WINDOW_MAX_FAST;
+					}
+				}
+			}
+		}
+		request_next();
+	}
+}
+
+void Resource::request_next() {
+	assert(_object);
+	ResourceData& d = *_object;
+	if (d._status == FAILED || d._waiting_for_hmu) {
+		return;
+	}
+	d._outstanding_parts = 0;
+	uint8_t hashmap_exhausted = HASHMAP_IS_NOT_EXHAUSTED;
+	Bytes requested_hashes;
+	uint32_t start = (uint32_t)(d._consecutive_completed_height + 1);
+	uint32_t end = std::min<uint32_t>(start + d._window, d._total_parts);
+	for (uint32_t pn = start; pn < end; pn++) {
+		if (!d._received[pn]) {
+			if (pn < d._hashmap_height) {
+				requested_hashes.append(d._hashmap.data() + pn * MAPHASH_LEN, MAPHASH_LEN);
+				++d._outstanding_parts;
+			}
+			else {
+				hashmap_exhausted = HASHMAP_IS_EXHAUSTED;
+				break;
+			}
+		}
+	}
+
+	Bytes request_data;
+	request_data.append(hashmap_exhausted);
+	if (hashmap_exhausted == HASHMAP_IS_EXHAUSTED) {
+		request_data.append(d._hashmap.data() + (d._hashmap_height - 1) * MAPHASH_LEN, MAPHASH_LEN);
+		d._waiting_for_hmu = true;
+	}
+	request_data.append(d._hash);
+	request_data.append(requested_hashes);
+
+	try {
+		Packet request_packet(d._link, request_data, Type::Packet::DATA, Type::Packet::RESOURCE_REQ);
+		request_packet.send();
+		d._last_activity = OS::time();
+		d._req_sent = d._last_activity;
+		d._req_sent_bytes = request_packet.raw().size();
+		d._req_resp = 0.0;
+	}
+	catch (std::exception& e) {
+		ERRORF("Could not send resource request packet, cancelling resource. The contained exception was: %s", e.what());
+		cancel();
+	}
+}
+
+void Resource::request(const Bytes& request_data) {
+	assert(_object);
+	ResourceData& d = *_object;
+	if (d._status == FAILED || request_data.size() < 1) {
+		return;
+	}
+	double now = OS::time();
+	if (d._rtt == 0.0) {
+		d._rtt = now - d._adv_sent;
+	}
+	d._status = TRANSFERRING;
+	d._retries_left = d._max_retries;
+
+	bool wants_more_hashmap = (request_data.data()[0] == HASHMAP_IS_EXHAUSTED);
+	size_t pad = wants_more_hashmap ? 1 + MAPHASH_LEN : 1;
+	if (request_data.size() < pad + Type::Identity::HASHLENGTH/8) {
+		return;
+	}
+	const uint8_t* requested_hashes = request_data.data() + pad + Type::Identity::HASHLENGTH/8;
+	size_t requested_count = (request_data.size() - pad - Type::Identity::HASHLENGTH/8) / MAPHASH_LEN;
+
+	uint32_t search_start = d._receiver_min_consecutive_height;
+	uint32_t search_end = std::min<uint32_t>(search_start + COLLISION_GUARD_SIZE, d._total_parts);
+	for (uint32_t index = search_start; index < search_end && d._status != FAILED; index++) {
+		for (size_t i = 0; i < requested_count; i++) {
+			if (memcmp(d._hashmap.data() + index * MAPHASH_LEN, requested_hashes + i * MAPHASH_LEN, MAPHASH_LEN) == 0) {
+				send_part(index);
+				break;
+			}
+		}
+	}
+	if (d._status == FAILED) {
+		return;
+	}
+
+	if (wants_more_hashmap) {
+		const uint8_t* last_map_hash = request_data.data() + 1;
+		uint32_t part_index = d._receiver_min_consecutive_height;
+		for (uint32_t index = search_start; index < search_end; index++) {
+			++part_index;
+			if (memcmp(d._hashmap.data() + index * MAPHASH_LEN, last_map_hash, MAPHASH_LEN) == 0) {
+				break;
+			}
+		}
+		d._receiver_min_consecutive_height = (uint32_t)std::max<int32_t>((int32_t)part_index - 1 - WINDOW_MAX, 0);
+		if (part_index % HASHMAP_MAX_LEN != 0) {
+			ERROR("Resource sequencing error, cancelling transfer!");
+			cancel();
+			return;
+		}
+		uint32_t segment = part_index / HASHMAP_MAX_LEN;
+		uint32_t hashmap_start = segment * HASHMAP_MAX_LEN;
+		uint32_t hashmap_end = std::min<uint32_t>((segment + 1) * HASHMAP_MAX_LEN, d._total_parts);
+
+		Bytes hmu(d._hash);
+		hmu.append((uint8_t)0x92);
+		pack_uint(hmu, segment);
+		pack_bin(hmu, d._hashmap.mid(hashmap_start * MAPHASH_LEN, (hashmap_end - hashmap_start) * MAPHASH_LEN));
+		Packet hmu_packet(d._link, hmu, Type::Packet::DATA, Type::Packet::RESOURCE_HMU);
+		hmu_packet.send();
+		d._last_activity = OS::time();
+	}
+
+	if (d._sent_parts == d._total_parts) {
+		d._status = AWAITING_PROOF;
+		d._retries_left = 3;
+	}
+
+	if (d._callbacks._progress != nullptr) {
+		try {
+			d._callbacks._progress(*this);
+		}
+		catch (std::exception& e) {
+			ERRORF("Error while executing progress callback from %s. The contained exception was: %s", toString().c_str(), e.what());
+		}
+	}
 }
 
 /*
-:returns: The current progress of the resource transfer as a *float* between 0.0 and 1.0.
+Cancels transferring the resource.
 */
-float Resource::get_progress() const {
+void Resource::cancel() {
+	assert(_object);
+	if (_object->_status >= COMPLETE) {
+		return;
+	}
+	_object->_status = FAILED;
+	if (_object->_initiator && _object->_link.status() == Type::Link::ACTIVE) {
+		try {
+			Packet cancel_packet(_object->_link, _object->_hash, Type::Packet::DATA, Type::Packet::RESOURCE_ICL);
+			cancel_packet.send();
+		}
+		catch (std::exception& e) {
+			ERRORF("Could not send resource cancel packet. The contained exception was: %s", e.what());
+		}
+	}
+	conclude();
+}
+
 /*
+The receiver declined the resource.
+*/
+void Resource::rejected() {
 	assert(_object);
-	if (_object->_initiator) {
-		_object->_processed_parts = (_object->_segment_index-1)*math.ceil(Type::Resource::MAX_EFFICIENT_SIZE/Type::Resource::SDU);
-		_object->_processed_parts += _object->sent_parts;
-		_object->_progress_total_parts = float(_object->grand_total_parts);
+	if (_object->_status >= COMPLETE) {
+		return;
+	}
+	DEBUGF("Resource %s was rejected by the receiver", toString().c_str());
+	_object->_status = FAILED;
+	conclude();
+}
+
+void Resource::conclude() {
+	assert(_object);
+	// Keep a reference, removing the last owners below would free the resource mid-call
+	Resource resource(*this);
+	ResourceData& d = *_object;
+	_resources.erase(resource);
+	d._decryptor.reset();
+	d._data_hash.reset();
+	d._proof_hash.reset();
+	d._reorder.clear();
+	if (d._initiator || d._status != COMPLETE) {
+		release_spool(d);
 	}
 	else {
-		_object->_processed_parts = (_object->_segment_index-1)*math.ceil(Type::Resource::MAX_EFFICIENT_SIZE/Type::Resource::SDU);
-		_object->_processed_parts += _object->_received_count;
-		if (_object->split) {
-			_object->progress_total_parts = float(math.ceil(_object->total_size/Type::Resource::SDU));
+		spool_close();
+	}
+	d._link.resource_concluded(resource);
+	if (d._callbacks._concluded != nullptr) {
+		try {
+			d._callbacks._concluded(resource);
 		}
-		else {
-			_object->progress_total_parts = float(_object->total_parts);
+		catch (std::exception& e) {
+			ERRORF("Error while executing resource concluded callback from %s. The contained exception was: %s", toString().c_str(), e.what());
 		}
 	}
+	// A spooled resource is only valid for the duration of the concluded callback
+	release_spool(d);
+}
 
-	return (float)_object->processed_parts / (float)_object->progress_total_parts;
+/*
+:returns: The current progress of the resource transfer as a *float* between 0.0 and 1.0.
 */
-	return 0.0;
+float Resource::get_progress() const {
+	assert(_object);
+	if (_object->_total_parts == 0) {
+		return 0.0;
+	}
+	if (_object->_status == COMPLETE) {
+		return 1.0;
+	}
+	if (_object->_initiator) {
+		return (float)_object->_sent_parts / (float)_object->_total_parts;
+	}
+	return (float)_object->_received_count / (float)_object->_total_parts;
+}
+
+uint32_t Resource::get_parts() const {
+	assert(_object);
+	return _object->_total_parts;
 }
 
 void Resource::set_concluded_callback(Callbacks::concluded callback) {
@@ -82,9 +1249,8 @@ std::string Resource::toString() const {
 	if (!_object) {
 		return "";
 	}
-    //return "<"+RNS.hexrep(self.hash,delimit=False)+"/"+RNS.hexrep(self.link.link_id,delimit=False)+">"
-	//return "{Resource:" + _object->_hash.toHex() + "}";
-	return "{Resource: unknown}";
+	//return "<"+RNS.hexrep(self.hash,delimit=False)+"/"+RNS.hexrep(self.link.link_id,delimit=False)+">"
+	return "{Resource:" + _object->_hash.toHex() + "/" + _object->_link.link_id().toHex() + "}";
 }
 
 // getters
@@ -93,16 +1259,36 @@ const Bytes& Resource::hash() const {
 	return _object->_hash;
 }
 
+const Bytes& Resource::random_hash() const {
+	assert(_object);
+	return _object->_random_hash;
+}
+
+const Bytes& Resource::original_hash() const {
+	assert(_object);
+	return _object->_original_hash;
+}
+
 const Bytes& Resource::request_id() const {
 	assert(_object);
 	return _object->_request_id;
 }
 
+const Bytes& Resource::hashmap() const {
+	assert(_object);
+	return _object->_hashmap;
+}
+
 const Bytes& Resource::data() const {
 	assert(_object);
 	return _object->_data;
 }
 
+const std::string& Resource::storage_path() const {
+	assert(_object);
+	return _object->_spool_path;
+}
+
 const Type::Resource::status Resource::status() const {
 	assert(_object);
 	return _object->_status;
@@ -118,5 +1304,143 @@ const size_t Resource::total_size() const {
 	return _object->_total_size;
 }
 
+const Link& Resource::link() const {
+	assert(_object);
+	return _object->_link;
+}
+
+uint8_t Resource::flags() const {
+	assert(_object);
+	return _object->_flags;
+}
+
+bool Resource::initiator() const {
+	assert(_object);
+	return _object->_initiator;
+}
+
+bool Resource::is_compressed() const {
+	assert(_object);
+	return (_object->_flags & FLAG_LZ) != 0;
+}
+
+bool Resource::encrypted() const {
+	assert(_object);
+	return _object->_encrypted;
+}
+
+bool Resource::is_request() const {
+	assert(_object);
+	return (_object->_flags & FLAG_IS_REQUEST) != 0;
+}
+
+bool Resource::is_response() const {
+	assert(_object);
+	return (_object->_flags & FLAG_IS_RESPONSE) != 0;
+}
+
+std::set<Bytes>& Resource::req_hashlist() const {
+	assert(_object);
+	return _object->_req_hashlist;
+}
+
 // setters
 
+
+RNS::ResourceAdvertisement::ResourceAdvertisement(const Resource& resource) {
+	_t = resource.size();
+	_d = resource.total_size();
+	_n = resource.get_parts();
+	_h = resource.hash();
+	_r = resource.random_hash();
+	_o = resource.original_hash();
+	_m = resource.hashmap();
+	_i = 1;
+	_l = 1;
+	_q = resource.request_id();
+	_f = resource.flags();
+	_e = (_f & FLAG_ENCRYPTED) != 0;
+	_u = (_f & FLAG_IS_REQUEST) != 0;
+	_p = (_f & FLAG_IS_RESPONSE) != 0;
+}
+
+const Bytes RNS::ResourceAdvertisement::pack(uint32_t segment /*= 0*/) const {
+	uint32_t hashmap_start = segment * HASHMAP_MAX_LEN;
+	uint32_t hashmap_end = std::min<uint32_t>((segment + 1) * HASHMAP_MAX_LEN, _n);
+
+	Bytes packed;
+	packed.append((uint8_t)(0x80 | 11));
+	pack_key(packed, 't'); pack_uint(packed, _t);
+	pack_key(packed, 'd'); pack_uint(packed, _d);
+	pack_key(packed, 'n'); pack_uint(packed, _n);
+	pack_key(packed, 'h'); pack_bin(packed, _h);
+	pack_key(packed, 'r'); pack_bin(packed, _r);
+	pack_key(packed, 'o'); pack_bin(packed, _o);
+	pack_key(packed, 'i'); pack_uint(packed, _i);
+	pack_key(packed, 'l'); pack_uint(packed, _l);
+	pack_key(packed, 'q');
+	if (_q) {
+		pack_bin(packed, _q);
+	}
+	else {
+		packed.append((uint8_t)0xc0);
+	}
+	pack_key(packed, 'f'); pack_uint(packed, _f);
+	pack_key(packed, 'm'); pack_bin(packed, _m.mid(hashmap_start * MAPHASH_LEN, (hashmap_end - hashmap_start) * MAPHASH_LEN));
+	return packed;
+}
+
+/*static*/ RNS::ResourceAdvertisement RNS::ResourceAdvertisement::unpack(const Bytes& plaintext) {
+	ResourceAdvertisement adv;
+	MsgPackReader reader(plaintext);
+	size_t entries = reader.read_map();
+	for (size_t entry = 0; entry < entries; entry++) {
+		const std::string key(reader.read_str());
+		if (key.size() != 1) {
+			throw std::invalid_argument("Unexpected resource advertisement key");
+		}
+		switch (key[0]) {
+		case 't': adv._t = reader.read_uint(); break;
+		case 'd': adv._d = reader.read_uint(); break;
+		case 'n': adv._n = reader.read_uint(); break;
+		case 'h': adv._h = reader.read_bin(); break;
+		case 'r': adv._r = reader.read_bin(); break;
+		case 'o': adv._o = reader.read_bin(); break;
+		case 'i': adv._i = reader.read_uint(); break;
+		case 'l': adv._l = reader.read_uint(); break;
+		case 'q': if (!reader.read_nil()) adv._q = reader.read_bin(); break;
+		case 'f': adv._f = reader.read_uint(); break;
+		case 'm': adv._m = reader.read_bin(); break;
+		default: throw std::invalid_argument("Unexpected resource advertisement key");
+		}
+	}
+	adv._e = (adv._f & FLAG_ENCRYPTED) != 0;
+	adv._c = (adv._f & FLAG_COMPRESSED) != 0;
+	adv._s = (adv._f & FLAG_SPLIT) != 0;
+	adv._u = (adv._f & FLAG_IS_REQUEST) != 0;
+	adv._p = (adv._f & FLAG_IS_RESPONSE) != 0;
+	adv._x = (adv._f & FLAG_HAS_METADATA) != 0;
+	return adv;
+}
+
+/*static*/ bool RNS::ResourceAdvertisement::is_request(const Packet& advertisement_packet) {
+	const ResourceAdvertisement adv(unpack(const_cast<Packet&>(advertisement_packet).plaintext()));
+	return (adv._q && adv._u);
+}
+
+/*static*/ bool RNS::ResourceAdvertisement::is_response(const Packet& advertisement_packet) {
+	const ResourceAdvertisement adv(unpack(const_cast<Packet&>(advertisement_packet).plaintext()));
+	return (adv._q && adv._p);
+}
+
+/*static*/ const Bytes RNS::ResourceAdvertisement::read_request_id(const Packet& advertisement_packet) {
+	return unpack(const_cast<Packet&>(advertisement_packet).plaintext())._q;
+}
+
+/*static*/ size_t RNS::ResourceAdvertisement::read_transfer_size(const Packet& advertisement_packet) {
+	return unpack(const_cast<Packet&>(advertisement_packet).plaintext())._t;
+}
+
+/*static*/ size_t RNS::ResourceAdvertisement::read_size(const Packet& advertisement_packet) {
+	return unpack(const_cast<Packet&>(advertisement_packet).plaintext())._d;
+}
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "Destination.h"
+#include "FileStream.h"
 #include "Type.h"
 
+#include <set>
+#include <string>
 #include <memory>
 #include <cassert>
 
@@ -37,8 +40,10 @@ namespace RNS {
 			MEM("Resource object copy created");
 		}
 		//Resource(const Link& link = {Type::NONE});
-		Resource(const Bytes& data, const Link& link, const Bytes& request_id, bool is_response, double timeout);
+		Resource(const Bytes& data, const Link& link, const Bytes& request_id, bool is_response, double timeout = 0.0);
 		Resource(const Bytes& data, const Link& link, bool advertise = true, bool auto_compress = true, Callbacks::concluded callback = nullptr, Callbacks::progress progress_callback = nullptr, double timeout = 0.0, int segment_index = 1, const Bytes& original_hash = {Type::NONE}, const Bytes& request_id = {Type::NONE}, bool is_response = false);
+		// CBA Send the contents of a file, read in chunks so it never has to fit in RAM
+		Resource(const char* file_path, const Link& link, bool advertise = true, bool auto_compress = true, Callbacks::concluded callback = nullptr, Callbacks::progress progress_callback = nullptr, double timeout = 0.0);
 		virtual ~Resource(){
 			MEM("Resource object destroyed");
 		}
@@ -55,33 +60,37 @@ namespace RNS {
 			//return _object->_hash < resource._object->_hash;
 		}
 
+	private:
+		// Incoming resource, populated by accept()
+		Resource(const Link& link);
+
 	public:
-	    //p static def accept(advertisement_packet, callback=None, progress_callback = None, request_id = None):
+		static Resource accept(const Packet& advertisement_packet, Callbacks::concluded callback = nullptr, Callbacks::progress progress_callback = nullptr, const Bytes& request_id = {Bytes::NONE});
+		// CBA Runs the watchdog of every active resource, called from Transport::loop()
+		static void watchdog_jobs();
 
 	public:
-//p def hashmap_update_packet(self, plaintext):
-//p def hashmap_update(self, segment, hashmap):
-//p def get_map_hash(self, data):
-//p def advertise(self):
-//p def __advertise_job(self):
-//p def watchdog_job(self):
-//p def __watchdog_job(self):
-//p def assemble(self):
-//p def prove(self):
+		void hashmap_update_packet(const Bytes& plaintext);
+		void hashmap_update(uint32_t segment, const Bytes& hashmap);
+		const Bytes get_map_hash(const Bytes& data) const;
+		void advertise();
+		void watchdog_job();
+		void assemble();
+		void prove();
 		void validate_proof(const Bytes& proof_data);
-//p def receive_part(self, packet):
-//p def request_next(self):
-//p def request(self, request_data):
+		void receive_part(const Packet& packet);
+		void request_next();
+		void request(const Bytes& request_data);
 		void cancel();
-//p def set_callback(self, callback):
-//p def progress_callback(self, callback):
+		void rejected();
 		float get_progress() const;
-//p def get_transfer_size(self):
-//p def get_data_size(self):
-//p def get_parts(self):
-//p def get_segments(self):
-//p def get_hash(self):
-//p def is_compressed(self):
+		inline size_t get_transfer_size() const { return size(); }
+		inline size_t get_data_size() const { return total_size(); }
+		uint32_t get_parts() const;
+		inline int get_segments() const { return 1; }
+		inline const Bytes& get_hash() const { return hash(); }
+		// CBA Whether the data is sent LZ compressed (bz2 is not supported)
+		bool is_compressed() const;
 		void set_concluded_callback(Callbacks::concluded callback);
 		void set_progress_callback(Callbacks::progress callback);
 
@@ -89,22 +98,88 @@ namespace RNS {
 
 		// getters
 		const Bytes& hash() const;
+		const Bytes& random_hash() const;
+		const Bytes& original_hash() const;
 		const Bytes& request_id() const;
+		const Bytes& hashmap() const;
+		// Data of a completed incoming resource, empty when it was spooled to storage_path()
 		const Bytes& data() const;
+		const std::string& storage_path() const;
 		const Type::Resource::status status() const;
 		const size_t size() const;
 		const size_t total_size() const;
+		const Link& link() const;
+		uint8_t flags() const;
+		bool initiator() const;
+		bool encrypted() const;
+		bool is_request() const;
+		bool is_response() const;
+		std::set<Bytes>& req_hashlist() const;
 
 		// setters
 
+	private:
+		bool prepare(const std::string& source_path, const Bytes& source, bool auto_compress);
+		bool spool_open(FileStream::MODE mode);
+		void spool_close();
+		const Bytes read_part(uint32_t index);
+		void send_part(uint32_t index);
+		bool sink(const Bytes& plaintext);
+		void flush_parts();
+		void conclude();
+		static void release_spool(ResourceData& data);
+
+	private:
+		// CBA Active resources whose watchdog is driven by watchdog_jobs()
+		static std::set<Resource> _resources;
+
 	protected:
 		std::shared_ptr<ResourceData> _object;
 
 	};
 
 
+	/*
+	Resource advertisement, a msgpack map sent with context RESOURCE_ADV describing the
+	resource and carrying the first segment of its hashmap.
+	*/
 	class ResourceAdvertisement {
 
+	public:
+		ResourceAdvertisement() {}
+		ResourceAdvertisement(const Resource& resource);
+
+	public:
+		const Bytes pack(uint32_t segment = 0) const;
+		// Throws std::invalid_argument on a malformed advertisement
+		static ResourceAdvertisement unpack(const Bytes& plaintext);
+
+		static bool is_request(const Packet& advertisement_packet);
+		static bool is_response(const Packet& advertisement_packet);
+		static const Bytes read_request_id(const Packet& advertisement_packet);
+		static size_t read_transfer_size(const Packet& advertisement_packet);
+		static size_t read_size(const Packet& advertisement_packet);
+
+	public:
+		size_t _t = 0;			// transfer size
+		size_t _d = 0;			// data size
+		uint32_t _n = 0;		// number of parts
+		Bytes _h;				// resource hash
+		Bytes _r;				// resource random hash
+		Bytes _o;				// original hash (first segment)
+		uint32_t _i = 1;		// segment index
+		uint32_t _l = 1;		// total segments
+		Bytes _q;				// request id
+		uint8_t _f = 0;			// flags
+		Bytes _m;				// hashmap
+
+		bool _e = false;		// encrypted
+		bool _c = false;		// compressed
+		bool _s = false;		// split
+		bool _u = false;		// is request
+		bool _p = false;		// is response
+		bool _x = false;		// has metadata
+
 	};
 
 }
@@ -5,9 +5,17 @@
 #include "Interface.h"
 #include "Packet.h"
 #include "Destination.h"
+#include "FileStream.h"
 #include "Bytes.h"
 #include "Type.h"
-#include "Cryptography/Fernet.h"
+#include "Cryptography/Token.h"
+#include "Cryptography/Backend.h"
+#include "Utilities/Compression.h"
+
+#include <map>
+#include <set>
+#include <vector>
+#include <memory>
 
 namespace RNS {
 
@@ -18,13 +26,83 @@ namespace RNS {
 	private:
 		Link _link;
 		Bytes _hash;
+		Bytes _random_hash;
+		Bytes _original_hash;
 		Bytes _request_id;
 		Bytes _data;
 		Type::Resource::status _status = Type::Resource::NONE;
-		size_t _size = 0;
-		size_t _total_size = 0;
+		size_t _size = 0;				// transfer size (the encrypted token)
+		size_t _total_size = 0;			// size of the data itself
+		uint32_t _total_parts = 0;
+		uint16_t _sdu = Type::Resource::SDU;
+		uint8_t _flags = 0;
+		bool _initiator = false;
+		bool _encrypted = true;
+		bool _is_response = false;
+		bool _compressed = false;
+		int _segment_index = 1;
+		int _total_segments = 1;
 		Resource::Callbacks _callbacks;
 
+		// Map hashes of every part, MAPHASH_LEN bytes each
+		Bytes _hashmap;
+		uint32_t _hashmap_height = 0;
+
+		// CBA Spooled resources keep their token (sender) or plaintext (receiver) in a cache
+		// file instead of _data, so only a window of parts is ever in RAM
+		std::string _spool_path;
+		FileStream _spool = {Type::NONE};
+		size_t _spool_position = 0;
+
+		// Timing and retries
+		double _timeout = 0.0;
+		uint8_t _timeout_factor = 0;
+		double _last_activity = 0.0;
+		double _started_transferring = 0.0;
+		double _adv_sent = 0.0;
+		double _last_part_sent = 0.0;
+		double _req_sent = 0.0;
+		double _req_resp = 0.0;
+		size_t _req_sent_bytes = 0;
+		double _rtt = 0.0;
+		uint8_t _part_timeout_factor = Type::Resource::PART_TIMEOUT_FACTOR;
+		uint8_t _max_retries = Type::Resource::MAX_RETRIES;
+		uint8_t _max_adv_retries = Type::Resource::MAX_ADV_RETRIES;
+		uint8_t _retries_left = Type::Resource::MAX_RETRIES;
+		double _sender_grace_time = Type::Resource::SENDER_GRACE_TIME;
+
+		// Sender
+		Packet _advertisement_packet = {Type::NONE};
+		std::vector<bool> _sent;
+		Bytes _expected_proof;
+		uint32_t _sent_parts = 0;
+		uint32_t _receiver_min_consecutive_height = 0;
+		std::set<Bytes> _req_hashlist;
+
+		// Receiver
+		uint32_t _received_count = 0;
+		uint32_t _outstanding_parts = 0;
+		int32_t _consecutive_completed_height = -1;
+		// Which parts have arrived, and the parts that arrived ahead of the contiguous run
+		std::vector<bool> _received;
+		std::map<uint32_t, Bytes> _reorder;
+		uint8_t _window = Type::Resource::WINDOW;
+		uint8_t _window_max = Type::Resource::WINDOW_MAX_SLOW;
+		uint8_t _window_min = Type::Resource::WINDOW_MIN;
+		uint8_t _window_flexibility = Type::Resource::WINDOW_FLEXIBILITY;
+		uint8_t _fast_rate_rounds = 0;
+		size_t _rtt_rxd_bytes = 0;
+		size_t _rtt_rxd_bytes_at_part_req = 0;
+		bool _waiting_for_hmu = false;
+		// Streaming decryption and hashing of the contiguous parts as they arrive
+		Cryptography::Token::Ptr _token;
+		std::unique_ptr<Cryptography::Token::Decryptor> _decryptor;
+		std::unique_ptr<Cryptography::SHA256Engine> _data_hash;
+		std::unique_ptr<Cryptography::SHA256Engine> _proof_hash;
+		size_t _prefix_skipped = 0;
+		// Set for LZ compressed resources, expands the plaintext before it is hashed and stored
+		std::unique_ptr<Utilities::LzDecompressor> _decompressor;
+
 	friend class Resource;
 	};
 
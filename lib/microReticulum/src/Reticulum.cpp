@@ -137,9 +137,9 @@ Reticulum::Reticulum() : _object(new Object()) {
 #endif
 
 	// Initialize time-based variables *after* time offset update
-	_object->_last_data_persist = OS::time();
-	_object->_last_cache_clean = 0.0;
-	_object->_jobs_last_run = OS::time();
+	_object->_last_data_persist = OS::seconds();
+	_object->_last_cache_clean = 0;
+	_object->_jobs_last_run = OS::seconds();
 
 /*p TODO
 	if not os.path.isdir(Reticulum.storagepath):
@@ -199,6 +199,8 @@ void Reticulum::start() {
 	INFO("Total memory: " + std::to_string(OS::heap_size()));
 	INFO("Total flash: " + std::to_string(OS::storage_size()));
 
+	Identity::load_known_destinations();
+
 	INFO("Starting Transport...");
 	Transport::start(*this);
 }
@@ -207,16 +209,23 @@ void Reticulum::loop() {
 	assert(_object);
 	if (!_object->_is_connected_to_shared_instance) {
 
-		// Perform Reticulum housekeeping
-		if (OS::time() > (_object->_jobs_last_run + JOB_INTERVAL)) {
-			jobs();
-			_object->_jobs_last_run = OS::time();
-		}
-
 		// Perform interface processing
 		for (auto& [hash, interface] : Transport::get_interfaces()) {
 			interface.loop();
 		}
+	}
+	transport_loop();
+}
+
+void Reticulum::transport_loop() {
+	assert(_object);
+	if (!_object->_is_connected_to_shared_instance) {
+
+		// Perform Reticulum housekeeping
+		if (OS::seconds() > (_object->_jobs_last_run + JOB_INTERVAL)) {
+			jobs();
+			_object->_jobs_last_run = OS::seconds();
+		}
 
 		// Perform Filesystem processing
 		FileSystem& filesystem = OS::get_filesystem();
@@ -234,7 +243,7 @@ void Reticulum::loop() {
 
 void Reticulum::jobs() {
 
-	double now = OS::time();
+	uint32_t now = OS::seconds();
 
 #if 1
 	// CBA Detect low-memory condition and reset
@@ -255,7 +264,7 @@ void Reticulum::jobs() {
 
 	if (now > _object->_last_cache_clean + CLEAN_INTERVAL) {
 		clean_caches();
-		_object->_last_cache_clean = OS::time();
+		_object->_last_cache_clean = OS::seconds();
 	}
 
 	if (now > _object->_last_data_persist + PERSIST_INTERVAL) {
@@ -275,7 +284,7 @@ void Reticulum::_add_interface(self,interface, mode = None, configured_bitrate=N
 */
 
 void Reticulum::should_persist_data() {
-	if (OS::time() > _object->_last_data_persist + GRACIOUS_PERSIST_INTERVAL) {
+	if (OS::seconds() > _object->_last_data_persist + GRACIOUS_PERSIST_INTERVAL) {
 		persist_data();
 	}
 }
@@ -302,7 +311,7 @@ void Reticulum::persist_data() {
 #endif
 #endif
 
-	_object->_last_data_persist = OS::time();
+	_object->_last_data_persist = OS::seconds();
 }
 
 void Reticulum::clean_caches() {
@@ -395,7 +404,7 @@ void Reticulum::get_interface_stats() const {
 }
 */
 
-const std::map<Bytes, Transport::DestinationEntry>& Reticulum::get_path_table() const {
+const Utilities::HashTable<Transport::DestinationEntry>& Reticulum::get_path_table() const {
 /*
 	path_table = []
 	for dst_hash in Transport::destination_table:
@@ -414,7 +423,7 @@ const std::map<Bytes, Transport::DestinationEntry>& Reticulum::get_path_table()
 	return Transport::get_destination_table();
 }
 
-const std::map<Bytes, Transport::RateEntry>& Reticulum::get_rate_table() const {
+const Utilities::HashTable<Transport::RateEntry>& Reticulum::get_rate_table() const {
 /*
 	rate_table = []
 	for dst_hash in Transport::announce_rate_table:
@@ -82,6 +82,8 @@ namespace RNS {
 	public:
 		void start();
 		void loop();
+		// CBA loop() without the interface loops, for a task that does not own the interfaces
+		void transport_loop();
 		void jobs();
 		void should_persist_data();
 		void persist_data();
@@ -90,8 +92,8 @@ namespace RNS {
 		//void __create_default_config();
 		//void rpc_loop();
 		//void get_interface_stats() const;
-		const std::map<Bytes, Transport::DestinationEntry>& get_path_table() const;
-		const std::map<Bytes, Transport::RateEntry>& get_rate_table() const;
+		const Utilities::HashTable<Transport::DestinationEntry>& get_path_table() const;
+		const Utilities::HashTable<Transport::RateEntry>& get_rate_table() const;
 		bool drop_path(const Bytes& destination);
 		uint16_t drop_all_via(const Bytes& transport_hash);
 		void drop_announce_queues();
@@ -176,11 +178,12 @@ namespace RNS {
 			bool _is_connected_to_shared_instance = false;
 			bool _is_standalone_instance = false;
 			//p _jobs_thread = None
-			double _last_data_persist = Utilities::OS::time();
-			double _last_cache_clean = 0.0;
+			// CBA Housekeeping times are OS::seconds()
+			uint32_t _last_data_persist = Utilities::OS::seconds();
+			uint32_t _last_cache_clean = 0;
 
 			// CBA
-			double _jobs_last_run = Utilities::OS::time();
+			uint32_t _jobs_last_run = Utilities::OS::seconds();
 
 		friend class Reticulum;
 		};
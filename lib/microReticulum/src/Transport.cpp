@@ -1,5 +1,7 @@
 #include "Transport.h"
 #include "Link.h"
+#include "Resource.h"
+#include "Channel.h"
 
 #include "Reticulum.h"
 #include "Destination.h"
@@ -7,12 +9,18 @@
 #include "Packet.h"
 #include "Interface.h"
 #include "Log.h"
+#include "Cryptography/Hashes.h"
 #include "Cryptography/Random.h"
 #include "Cryptography/HKDF.h"
+#include "Cryptography/KeyPool.h"
 #include "Utilities/OS.h"
 #include "Utilities/Persistence.h"
+#include "Utilities/PathStore.h"
+#include "Utilities/PacketCache.h"
+#include "Utilities/Whitelist.h"
 
 #include <algorithm>
+#include <limits>
 #include <unistd.h>
 #include <time.h>
 
@@ -20,141 +28,160 @@ using namespace RNS;
 using namespace RNS::Type::Transport;
 using namespace RNS::Utilities;
 
-#if defined(INTERFACES_SET)
-///*static*/ std::set<std::reference_wrapper<const Interface>, std::less<const Interface>> Transport::_interfaces;
-/*static*/ std::set<std::reference_wrapper<Interface>, std::less<Interface>> Transport::_interfaces;
-#elif defined(INTERFACES_LIST)
-/*static*/ std::list<std::reference_wrapper<Interface>> Transport::_interfaces;
-#elif defined(INTERFACES_MAP)
-/*static*/ std::map<Bytes, Interface&> Transport::_interfaces;
-#endif
-#if defined(DESTINATIONS_SET)
-/*static*/ std::set<Destination> Transport::_destinations;
-#elif defined(DESTINATIONS_MAP)
-/*static*/ std::map<Bytes, Destination> Transport::_destinations;
-#endif
-/*static*/ std::set<Link> Transport::_pending_links;
-/*static*/ std::set<Link> Transport::_active_links;
-/*static*/ std::set<Bytes> Transport::_packet_hashlist;
-/*static*/ std::list<PacketReceipt> Transport::_receipts;
-
-/*static*/ std::map<Bytes, Transport::AnnounceEntry> Transport::_announce_table;
-/*static*/ std::map<Bytes, Transport::DestinationEntry> Transport::_destination_table;
-/*static*/ std::map<Bytes, Transport::ReverseEntry> Transport::_reverse_table;
-/*static*/ std::map<Bytes, Transport::LinkEntry> Transport::_link_table;
-/*static*/ std::map<Bytes, Transport::AnnounceEntry> Transport::_held_announces;
-/*static*/ std::set<HAnnounceHandler> Transport::_announce_handlers;
-/*static*/ std::map<Bytes, Transport::TunnelEntry> Transport::_tunnels;
-/*static*/ std::map<Bytes, Transport::RateEntry> Transport::_announce_rate_table;
-/*static*/ std::map<Bytes, double> Transport::_path_requests;
-
-/*static*/ std::map<Bytes, Transport::PathRequestEntry> Transport::_discovery_path_requests;
-/*static*/ std::set<Bytes> Transport::_discovery_pr_tags;
-
-/*static*/ std::set<Destination> Transport::_control_destinations;
-/*static*/ std::set<Bytes> Transport::_control_hashes;
-
-///*static*/ std::set<Interface> Transport::_local_client_interfaces;
-/*static*/ std::set<std::reference_wrapper<const Interface>, std::less<const Interface>> Transport::_local_client_interfaces;
-
-/*static*/ std::map<Bytes, const Interface&> Transport::_pending_local_path_requests;
-
-// CBA
-/*static*/ std::map<Bytes, Transport::PacketEntry> Transport::_packet_table;
-
-/*static*/ uint16_t Transport::_LOCAL_CLIENT_CACHE_MAXSIZE = 512;
-
-/*static*/ double Transport::_start_time				= 0.0;
-/*static*/ bool Transport::_jobs_locked					= false;
-/*static*/ bool Transport::_jobs_running				= false;
-/*static*/ float Transport::_job_interval				= 0.250;
-/*static*/ double Transport::_jobs_last_run				= 0.0;
-/*static*/ double Transport::_links_last_checked		= 0.0;
-/*static*/ float Transport::_links_check_interval		= 1.0;
-/*static*/ double Transport::_receipts_last_checked		= 0.0;
-/*static*/ float Transport::_receipts_check_interval	= 1.0;
-/*static*/ double Transport::_announces_last_checked	= 0.0;
-/*static*/ float Transport::_announces_check_interval	= 1.0;
-/*static*/ double Transport::_tables_last_culled		= 0.0;
-// CBA MCU
-/*static*/ //float Transport::_tables_cull_interval		= 5.0;
-/*static*/ float Transport::_tables_cull_interval		= 60.0;
-/*static*/ bool Transport::_saving_path_table			= false;
-// CBA ACCUMULATES
-// CBA MCU
-/*static*/ //uint16_t Transport::_hashlist_maxsize		= 1000000;
-/*static*/ //uint16_t Transport::_hashlist_maxsize		= 100;
-/*static*/ uint16_t Transport::_hashlist_maxsize		= 100;
-// CBA ACCUMULATES
-// CBA MCU
-/*static*/ //uint16_t Transport::_max_pr_tags			= 32000;
-/*static*/ uint16_t Transport::_max_pr_tags				= 32;
-
-// CBA
-// CBA ACCUMULATES
-/*static*/ uint16_t Transport::_path_table_maxsize		= 100;
-// CBA ACCUMULATES
-/*static*/ uint16_t Transport::_path_table_maxpersist	= 100;
-/*static*/ double Transport::_last_saved				= 0.0;
-/*static*/ float Transport::_save_interval				= 3600.0;
-/*static*/ uint32_t Transport::_destination_table_crc	= 0;
-
-/*static*/ Reticulum Transport::_owner({Type::NONE});
-
-// BOUNDARY MODE Whitelist 1: addresses of local devices (from LoRa and LocalTCP interfaces)
-static std::set<Bytes> _boundary_local_addresses;
-// BOUNDARY MODE Whitelist 2: addresses mentioned in packets from local devices
-static std::set<Bytes> _boundary_mentioned_addresses;
-static const uint16_t _boundary_maxsize = 200;
+/*static*/ Transport::Instance Transport::_default_instance;
+/*static*/ Transport::Instance* Transport::_instance = &Transport::_default_instance;
+
+// CBA The owner stays a NONE handle until start()
+Transport::Instance::Instance() :
+	_owner(new Reticulum({Type::NONE})),
+	_path_store(new Utilities::PathStore()),
+	_packet_cache(new Utilities::PacketCache(PACKET_CACHE_MAXSIZE, PACKET_CACHE_SPILL_MAXSIZE))
+{
+	// CBA Path table capacity tracks maxsize with one slot of headroom, see path_table_maxsize()
+	_destination_table.capacity(_path_table_maxsize + 1);
+	_packet_hashlist.capacity(_hashlist_maxsize);
+	MEM("Transport::Instance object created");
+}
+
+Transport::Instance::~Instance() {
+	MEM("Transport::Instance object destroyed");
+}
+
+/*static*/ Transport::Instance& Transport::use(Instance& instance) {
+	Instance& previous = *_instance;
+	_instance = &instance;
+	return previous;
+}
 
 // BOUNDARY MODE: Check if an interface is the backbone
 static bool is_backbone_interface(const Interface& iface) {
 	return iface.is_backbone();
 }
-/*static*/ Identity Transport::_identity({Type::NONE});
 
-// CBA
-/*static*/ Transport::Callbacks Transport::_callbacks;
+// CBA Largest link MTU an interface can carry: its hardware MTU if it takes MTU
+// configuration (TCP, UDP, ...), the Reticulum MTU otherwise (LoRa)
+static uint16_t interface_link_mtu(const Interface& iface) {
+	if (iface && (iface.AUTOCONFIGURE_MTU() || iface.FIXED_MTU()) && iface.HW_MTU() > 0) {
+		return iface.HW_MTU();
+	}
+	return Type::Reticulum::MTU;
+}
 
-// CBA Stats
-/*static*/ uint32_t Transport::_packets_sent = 0;
-/*static*/ uint32_t Transport::_packets_received = 0;
-/*static*/ uint32_t Transport::_destinations_added = 0;
-/*static*/ size_t Transport::_last_memory = 0;
-/*static*/ size_t Transport::_last_flash = 0;
+// CBA Clamps the MTU signalled in a forwarded LINKREQUEST (the last LINK_MTU_SIZE bytes of
+// new_raw) to what both the previous and the next hop can carry, so a link whose hops are
+// all TCP keeps the full TCP MTU and one crossing LoRa falls back to the Reticulum MTU.
+// Without this, endpoints negotiate a segment size that exceeds a hop's buffer capacity,
+// causing silent truncation and resource transfer stalls. As in RNS, the signalling is
+// stripped if the next hop can't be configured at all.
+static void clamp_link_mtu(const Packet& packet, const Interface& outbound_interface, Bytes& new_raw) {
+	uint16_t path_mtu = Link::mtu_from_lr_packet(packet);
+	if (path_mtu == 0) {
+		return;
+	}
+	if (outbound_interface.HW_MTU() == 0 || (!outbound_interface.AUTOCONFIGURE_MTU() && !outbound_interface.FIXED_MTU())) {
+		DEBUG("MTU CLAMP: Outbound interface doesn't support MTU config, stripping link MTU signalling");
+		new_raw = new_raw.left(new_raw.size() - Type::Link::LINK_MTU_SIZE);
+		return;
+	}
+	uint16_t ph_mtu = interface_link_mtu(packet.receiving_interface());
+	uint16_t nh_mtu = outbound_interface.HW_MTU();
+	uint16_t clamped = std::min(path_mtu, std::min(ph_mtu, nh_mtu));
+	if (clamped < path_mtu) {
+		Bytes clamped_mtu_bytes = Link::signalling_bytes(clamped, Link::mode_from_lr_packet(packet));
+		new_raw = new_raw.left(new_raw.size() - Type::Link::LINK_MTU_SIZE) + clamped_mtu_bytes;
+		DEBUGF("MTU CLAMP: path=%u ph=%u nh=%u -> clamped=%u", path_mtu, ph_mtu, nh_mtu, clamped);
+	}
+}
+
+// CBA Resumable sweep over a std container for the time-sliced jobs. Visits at most
+// job._budget entries starting at index job._cursor (std iterators can't be kept across
+// ticks) and erases those for which visit() returns true. Returns true once the end of
+// the container has been reached.
+template <typename C, typename F>
+static bool sweep(C& container, Transport::Job& job, F visit) {
+	auto iter = container.begin();
+	std::advance(iter, (job._cursor < container.size()) ? job._cursor : container.size());
+	uint16_t processed = 0;
+	while (iter != container.end()) {
+		if (job._budget > 0 && processed++ >= job._budget) {
+			return false;
+		}
+		if (visit(*iter)) {
+			iter = container.erase(iter);
+		}
+		else {
+			++iter;
+			++job._cursor;
+		}
+	}
+	return true;
+}
+
+// CBA Resumable sweep over a HashTable, using the slot position as cursor. Keys for which
+// stale() returns true are collected rather than erased so the caller can release them
+// through the usual remove_*() helpers (erase never moves entries, so the cursor stays valid).
+template <typename T, typename F>
+static bool sweep_table(Utilities::HashTable<T>& table, Transport::Job& job, std::vector<Bytes>& stale_keys, F stale) {
+	uint16_t processed = 0;
+	for (auto iter = table.from(job._cursor); iter != table.end(); ++iter) {
+		if (job._budget > 0 && processed++ >= job._budget) {
+			job._cursor = table.position(iter);
+			return false;
+		}
+		if (stale((*iter).first, (*iter).second)) {
+			stale_keys.push_back((*iter).first);
+		}
+	}
+	return true;
+}
 
 /*static*/ void Transport::start(const Reticulum& reticulum_instance) {
 	INFO("Transport starting...");
-	_jobs_running = true;
-	_owner = reticulum_instance;
+	_instance->_jobs_running = true;
+	*_instance->_owner = reticulum_instance;
 
 	// Initialize time-based variables *after* time offset update
-	_jobs_last_run = OS::time();
-	_links_last_checked = OS::time();
-	_receipts_last_checked = OS::time();
-	_announces_last_checked = OS::time();
-	_tables_last_culled = OS::time();
-	_last_saved = OS::time();
+	_instance->_jobs_last_run = OS::ticks();
+	for (auto& job : _instance->_jobs) {
+		job._last_run = OS::ticks();
+	}
+	_instance->_last_saved = OS::seconds();
 
 	// ensure required directories exist
 	if (!OS::directory_exists(Reticulum::_cachepath)) {
 		VERBOSE("No cache directory, creating...");
 		OS::create_directory(Reticulum::_cachepath);
 	}
+#if defined(RNS_USE_FS) && defined(RNS_PERSIST_PATHS)
+	{
+		// CBA Announce packets that left RAM live in one spill file, indexed before the path table loads
+		char packet_cache_path[Type::Reticulum::FILEPATH_MAXSIZE];
+		snprintf(packet_cache_path, Type::Reticulum::FILEPATH_MAXSIZE, "%s/packet_cache", Reticulum::_cachepath);
+		size_t indexed = _instance->_packet_cache->open(packet_cache_path);
+		DEBUGF("Transport::start: %u cached packets indexed", indexed);
+		// Per-packet cache files (named by hex packet hash) have been superseded
+		for (auto& file : OS::list_directory(Reticulum::_cachepath)) {
+			if (file.length() == (Type::Reticulum::HASHLENGTH/8)*2) {
+				snprintf(packet_cache_path, Type::Reticulum::FILEPATH_MAXSIZE, "%s/%s", Reticulum::_cachepath, file.c_str());
+				OS::remove_file(packet_cache_path);
+			}
+		}
+	}
+#endif
 
-	if (!_identity) {
+	if (!_instance->_identity) {
 		char transport_identity_path[Type::Reticulum::FILEPATH_MAXSIZE];
 		snprintf(transport_identity_path, Type::Reticulum::FILEPATH_MAXSIZE, "%s/transport_identity", Reticulum::_storagepath);
 		DEBUG("Checking for transport identity...");
 		try {
 			if (OS::file_exists(transport_identity_path)) {
-				_identity = Identity::from_file(transport_identity_path);
+				_instance->_identity = Identity::from_file(transport_identity_path);
 			}
 
-			if (!_identity) {
+			if (!_instance->_identity) {
 				VERBOSE("No valid Transport Identity in storage, creating...");
-				_identity = Identity();
-				_identity.to_file(transport_identity_path);
+				_instance->_identity = Identity();
+				_instance->_identity.to_file(transport_identity_path);
 			}
 			else {
 				VERBOSE("Loaded Transport Identity from storage");
@@ -165,30 +192,36 @@ static bool is_backbone_interface(const Interface& iface) {
 		}
 	}
 
-// TODO
-/*
-	packet_hashlist_path = Reticulum::storagepath + "/packet_hashlist";
-	if (!owner.is_connected_to_shared_instance()) {
-		if (os.path.isfile(packet_hashlist_path)) {
-			try {
-				//p file = open(packet_hashlist_path, "rb")
-				//p Transport.packet_hashlist = umsgpack.unpackb(file.read())
-				//p file.close()
-			}
-			catch (std::exception& e) {
-				ERRORF("Could not load packet hashlist from storage, the contained exception was: %s", e.what());
+#if defined(RNS_USE_FS) && defined(RNS_PERSIST_PATHS)
+	if (!_instance->_owner->is_connected_to_shared_instance()) {
+		char packet_hashlist_path[Type::Reticulum::FILEPATH_MAXSIZE];
+		snprintf(packet_hashlist_path, Type::Reticulum::FILEPATH_MAXSIZE, "%s/packet_hashlist", Reticulum::_storagepath);
+		try {
+			if (OS::file_exists(packet_hashlist_path)) {
+				Bytes data;
+				if (OS::read_file(packet_hashlist_path, data) > 0) {
+					size_t count = _instance->_packet_hashlist.deserialize(data);
+					VERBOSEF("Loaded %u packet hashes from storage", count);
+				}
 			}
 		}
+		catch (std::exception& e) {
+			ERRORF("Could not load packet hashlist from storage, the contained exception was: %s", e.what());
+		}
 	}
-*/
+#endif
+	_instance->_hashlist_last_saved = OS::seconds();
 
 	// Create transport-specific destination for path request
 	Destination path_request_destination({Type::NONE}, Type::Destination::IN, Type::Destination::PLAIN, APP_NAME, "path.request");
 	path_request_destination.set_packet_callback(path_request_handler);
 	// CBA ACCUMULATES
-	_control_destinations.insert(path_request_destination);
+	_instance->_control_destinations.insert(path_request_destination);
 	// CBA ACCUMULATES
-	_control_hashes.insert(path_request_destination.hash());
+	_instance->_control_hashes.insert(path_request_destination.hash());
+#ifdef BOUNDARY_MODE
+	_instance->_boundary_whitelist.insert(path_request_destination.hash(), Utilities::Whitelist::CLASS_PINNED);
+#endif
 	DEBUG("Created transport-specific path request destination " + path_request_destination.hash().toHex());
 
 	// Create transport-specific destination for tunnel synthesize
@@ -197,12 +230,15 @@ static bool is_backbone_interface(const Interface& iface) {
 	// CBA BUG?
     //p Transport.control_destinations.append(Transport.tunnel_synthesize_handler)
 	// CBA ACCUMULATES
-	_control_destinations.insert(tunnel_synthesize_destination);
+	_instance->_control_destinations.insert(tunnel_synthesize_destination);
 	// CBA ACCUMULATES
-	_control_hashes.insert(tunnel_synthesize_destination.hash());
+	_instance->_control_hashes.insert(tunnel_synthesize_destination.hash());
+#ifdef BOUNDARY_MODE
+	_instance->_boundary_whitelist.insert(tunnel_synthesize_destination.hash(), Utilities::Whitelist::CLASS_PINNED);
+#endif
 	DEBUG("Created transport-specific tunnel synthesize destination " + tunnel_synthesize_destination.hash().toHex());
 
-	_jobs_running = false;
+	_instance->_jobs_running = false;
 
 	// CBA Threading
 	//p thread = threading.Thread(target=Transport.jobloop, daemon=True)
@@ -221,7 +257,7 @@ static bool is_backbone_interface(const Interface& iface) {
 
 		// Create transport-specific destination for probe requests
 		if (Reticulum::probe_destination_enabled()) {
-			Destination probe_destination(_identity, Type::Destination::IN, Type::Destination::SINGLE, APP_NAME, "probe");
+			Destination probe_destination(_instance->_identity, Type::Destination::IN, Type::Destination::SINGLE, APP_NAME, "probe");
 			probe_destination.accepts_links(false);
 			probe_destination.set_proof_strategy(Type::Destination::PROVE_ALL);
 			DEBUG("Created probe responder destination " + probe_destination.hash().toHex());
@@ -229,8 +265,8 @@ static bool is_backbone_interface(const Interface& iface) {
 			NOTICE("Transport Instance will respond to probe requests on " + probe_destination.toString());
 		}
 
-		VERBOSE("Transport instance " + _identity.toString() + " started");
-		_start_time = OS::time();
+		VERBOSE("Transport instance " + _instance->_identity.toString() + " started");
+		_instance->_start_time = OS::seconds();
 	}
 
 // TODO
@@ -249,484 +285,704 @@ static bool is_backbone_interface(const Interface& iface) {
 }
 
 /*static*/ void Transport::loop() {
-	if (OS::time() > (_jobs_last_run + _job_interval)) {
+	if (OS::elapsed(_instance->_jobs_last_run) > _instance->_job_interval) {
 		jobs();
-		_jobs_last_run = OS::time();
+		_instance->_jobs_last_run = OS::ticks();
 	}
-}
-
-/*static*/ void Transport::jobs() {
-	//TRACE("Transport::jobs()");
-
-	// Heap telemetry: snapshot at jobs entry
-	size_t _jobs_heap_entry = OS::heap_available();
 
-	std::vector<Packet> outgoing;
-	std::set<Bytes> path_requests;
-	int count;
-	_jobs_running = true;
-
-	try {
-		if (!_jobs_locked) {
-
-			// Process active and pending link lists
-			if (OS::time() > (_links_last_checked + _links_check_interval)) {
-				std::set<Link> pending_links(_pending_links);
-				for (auto& link : pending_links) {
-					if (link.status() == Type::Link::CLOSED) {
-						// If we are not a Transport Instance, finding a pending link
-						// that was never activated will trigger an expiry of the path
-						// to the destination, and an attempt to rediscover the path.
-						if (!Reticulum::transport_enabled()) {
-							expire_path(link.destination().hash());
-
-							// If we are connected to a shared instance, it will take
-							// care of sending out a new path request. If not, we will
-							// send one directly.
-							if (!_owner.is_connected_to_shared_instance()) {
-								double last_path_request = 0;
-								auto iter = _path_requests.find(link.destination().hash());
-								if (iter != _path_requests.end()) {
-									last_path_request = (*iter).second;
-								}
-
-								if ((OS::time() - last_path_request) > Type::Transport::PATH_REQUEST_MI) {
-									DEBUG("Trying to rediscover path for " + link.destination().hash().toHex() + " since an attempted link was never established");
-									//if (path_requests.find(link.destination().hash()) == path_requests.end()) {
-									if (path_requests.count(link.destination().hash()) == 0) {
-										// CBA ACCUMULATES
-										path_requests.insert(link.destination().hash());
-									}
-								}
-							}
-						}
+	// CBA Validate a few staged announces per pass so other traffic keeps flowing during announce storms
+	process_announce_validation();
 
-						_pending_links.erase(link);
-					}
-				}
-				std::set<Link> active_links(_active_links);
-				for (auto& link : active_links) {
-					if (link.status() == Type::Link::CLOSED) {
-						_active_links.erase(link);
-					}
-				}
+	// CBA Resource and Channel retries and timeouts, these ran in their own threads in RNS
+	Resource::watchdog_jobs();
+	Channel::watchdog_jobs();
 
-				_links_last_checked = OS::time();
-			}
+	// CBA Top up the ephemeral key pools, at most one key per pass and only while there are no announces waiting
+	if (_instance->_announce_validation_queue.empty()) {
+		if (!Cryptography::X25519KeyPool::refill()) {
+			Cryptography::Ed25519KeyPool::refill();
+		}
+		// and the random byte pool, reseeding from the hardware generator when due
+		Cryptography::RandomPool::refill();
+	}
 
-			// Process receipts list for timed-out packets
-			if (OS::time() > (_receipts_last_checked + _receipts_check_interval)) {
-				while (_receipts.size() > Type::Transport::MAX_RECEIPTS) {
-					//p culled_receipt = Transport.receipts.pop(0)
-					PacketReceipt culled_receipt = _receipts.front();
-					_receipts.pop_front();
-					culled_receipt.set_timeout(-1);
-					culled_receipt.check_timeout();
-				}
+	// CBA Release queued announces as each interface's announce cap allows
+#if defined(INTERFACES_SET)
+	for (const Interface& interface : _instance->_interfaces) {
+		const_cast<Interface&>(interface).process_announce_queue();
+#elif defined(INTERFACES_LIST)
+	for (Interface& interface : _instance->_interfaces) {
+		interface.process_announce_queue();
+#elif defined(INTERFACES_MAP)
+	for (auto& [hash, interface] : _instance->_interfaces) {
+		interface.process_announce_queue();
+#endif
+	}
+}
 
-				std::list<PacketReceipt> cull_receipts;
-				for (auto& receipt : _receipts) {
-					receipt.check_timeout();
-					if (receipt.status() != Type::PacketReceipt::SENT) {
-						//p if receipt in Transport.receipts:
-						//p 	Transport.receipts.remove(receipt)
-						cull_receipts.push_back(receipt);
-					}
-				}
-				// CBA since modifying of collection while iterating is forbidden
-				for (auto& receipt : _receipts) {
-					cull_receipts.remove(receipt);
-				}
+/*static*/ void Transport::jobs() {
+	//TRACE("Transport::jobs()");
 
-				_receipts_last_checked = OS::time();
-			}
+	// Heap telemetry: snapshot at jobs entry, only taken when it can be logged
+	size_t _jobs_heap_entry = RNS_LOG_ENABLED(LOG_VERBOSE) ? OS::heap_available() : 0;
 
-			// Process announces needing retransmission
-			if (OS::time() > (_announces_last_checked + _announces_check_interval)) {
-				DEBUG("DIAG: ANNOUNCE-TBL size=" + std::to_string(_announce_table.size()));
-				//p for destination_hash in Transport.announce_table:
-				for (auto& [destination_hash, announce_entry] : _announce_table) {
-				//for (auto& pair : _announce_table) {
-				//	const auto& destination_hash = pair.first;
-				//	auto& announce_entry = pair.second;
-//TRACE("[0] announce entry data size: " + std::to_string(announce_entry._packet.data().size()));
-					//p announce_entry = Transport.announce_table[destination_hash]
-					DEBUG("DIAG: ANNOUNCE-ENTRY dest=" + destination_hash.toHex().substr(0,8) + " retries=" + std::to_string(announce_entry._retries) + " block=" + std::to_string(announce_entry._block_rebroadcasts) + " timeout_in=" + std::to_string(announce_entry._retransmit_timeout - OS::time()));
-					if (announce_entry._retries > 0 && announce_entry._retries >= Type::Transport::LOCAL_REBROADCASTS_MAX) {
-						TRACE("Completed announce processing for " + destination_hash.toHex() + ", local rebroadcast limit reached");
-						// CBA OK to modify collection here since we're immediately exiting iteration
-						_announce_table.erase(destination_hash);
-						break;
-					}
-					else if (announce_entry._retries > Type::Transport::PATHFINDER_R) {
-						DEBUG("DIAG: ANNOUNCE-CULL dest=" + destination_hash.toHex().substr(0,8) + " retries=" + std::to_string(announce_entry._retries) + " reason=retry_limit");
-						TRACE("Completed announce processing for " + destination_hash.toHex() + ", retry limit reached");
-						// CBA OK to modify collection here since we're immediately exiting iteration
-						_announce_table.erase(destination_hash);
-						break;
-					}
-					else {
-						if (OS::time() > announce_entry._retransmit_timeout) {
-							TRACE("Performing announce processing for " + destination_hash.toHex() + "...");
-							announce_entry._retransmit_timeout = OS::time() + Type::Transport::PATHFINDER_G + Type::Transport::PATHFINDER_RW;
-							announce_entry._retries += 1;
-							//p packet = announce_entry[5]
-							//p block_rebroadcasts = announce_entry[7]
-							//p attached_interface = announce_entry[8]
-							Type::Packet::context_types announce_context = Type::Packet::CONTEXT_NONE;
-							if (announce_entry._block_rebroadcasts) {
-								announce_context = Type::Packet::PATH_RESPONSE;
-							}
-							//p announce_data = packet.data
-							Identity announce_identity(Identity::recall(announce_entry._packet.destination_hash()));
-							//Destination announce_destination(announce_identity, Type::Destination::OUT, Type::Destination::SINGLE, "unknown", "unknown");
-							//announce_destination.hash(announce_entry._packet.destination_hash());
-							Destination announce_destination(announce_identity, Type::Destination::OUT, Type::Destination::SINGLE, announce_entry._packet.destination_hash());
-							//P announce_destination.hexhash = announce_destination.hash.hex()
-
-//if (announce_entry._attached_interface) {
-//TRACE("[1] interface is valid");
-//TRACE("[1] interface: " + announce_entry._attached_interface.debugString());
-//TRACE("[1] interface: " + announce_entry._attached_interface.toString());
-//}
-							Packet new_packet(
-								announce_destination,
-								//{Type::NONE},
-								announce_entry._attached_interface,
-								//{Type::NONE},
-								announce_entry._packet.data(),
-								Type::Packet::ANNOUNCE,
-								announce_context,
-								Type::Transport::TRANSPORT,
-								Type::Packet::HEADER_2,
-								Transport::_identity.hash(),
-								true,
-								announce_entry._packet.context_flag()
-							);
+	_instance->_jobs_outgoing.clear();
+	_instance->_jobs_path_requests.clear();
+	_instance->_jobs_running = true;
+	if (_instance->_callbacks._jobs_profile) _instance->_callbacks._jobs_profile(-1);
 
-							new_packet.hops(announce_entry._hops);
-							if (announce_entry._block_rebroadcasts) {
-								DEBUG("Rebroadcasting announce as path response for " + announce_destination.hash().toHex() + " with hop count " + std::to_string(new_packet.hops()));
-								DEBUG("DIAG: SENDING PATH-RESP announce for " + announce_destination.hash().toHex().substr(0,8) + " hops=" + std::to_string(new_packet.hops()) + " attached=" + (announce_entry._attached_interface ? announce_entry._attached_interface.toString() : "NONE"));
-							}
-							else {
-								DEBUG("Rebroadcasting announce for " + announce_destination.hash().toHex() + " with hop count " + std::to_string(new_packet.hops()));
-							}
-							
-							outgoing.push_back(new_packet);
-
-							// This handles an edge case where a peer sends a past
-							// request for a destination just after an announce for
-							// said destination has arrived, but before it has been
-							// rebroadcast locally. In such a case the actual announce
-							// is temporarily held, and then reinserted when the path
-							// request has been served to the peer.
-							//p if destination_hash in Transport.held_announces:
-							auto iter =_held_announces.find(destination_hash);
-							if (iter != _held_announces.end()) {
-								//p held_entry = Transport.held_announces.pop(destination_hash)
-								auto held_entry = (*iter).second;
-								_held_announces.erase(iter);
-								//p Transport.announce_table[destination_hash] = held_entry
-								//_announce_table[destination_hash] = held_entry;
-								//_announce_table.insert_or_assign({destination_hash, held_entry});
-								_announce_table.erase(destination_hash);
-								// CBA ACCUMULATES
-								_announce_table.insert({destination_hash, held_entry});
-								DEBUG("Reinserting held announce into table");
-								// CBA Must break after erase to avoid iterator invalidation
-								// (same pattern as the other two erases above in this loop)
-								break;
-							}
-						}
-					}
+	try {
+		if (!_instance->_jobs_locked) {
+
+			// CBA Each job processes a bounded slice of its table per tick and resumes where it
+			// left off on the next tick. Jobs are run round-robin, and once the tick's time
+			// budget is spent the remaining jobs wait for the next tick, starting with the
+			// first one skipped so that no job can be starved by a large table.
+			uint64_t tick_start = OS::ltime();
+			for (uint8_t n = 0; n < JOB_COUNT; n++) {
+				uint8_t job = (_instance->_jobs_next + n) % JOB_COUNT;
+				if (n > 0 && (OS::ltime() - tick_start) >= _instance->_jobs_time_budget) {
+					_instance->_jobs_next = job;
+					break;
 				}
-
-				_announces_last_checked = OS::time();
+				run_job((job_types)job);
+				if (_instance->_callbacks._jobs_profile) _instance->_callbacks._jobs_profile(job);
 			}
 
 			// Cull held announces that are older than 60 seconds or if map exceeds cap
 			{
-				const double held_timeout = 60.0;
+				const uint32_t held_timeout = 60;
 				const uint16_t held_maxsize = 32;
-				auto iter = _held_announces.begin();
-				while (iter != _held_announces.end()) {
-					if (OS::time() > ((*iter).second._timestamp + held_timeout)) {
+				uint32_t now = OS::seconds();
+				auto iter = _instance->_held_announces.begin();
+				while (iter != _instance->_held_announces.end()) {
+					if (now > ((*iter).second._timestamp + held_timeout)) {
 						DEBUG("Culling expired held announce for " + (*iter).first.toHex());
-						iter = _held_announces.erase(iter);
+						iter = _instance->_held_announces.erase(iter);
 					} else {
 						++iter;
 					}
 				}
-				while (_held_announces.size() > held_maxsize) {
+				while (_instance->_held_announces.size() > held_maxsize) {
 					DEBUG("Culling oldest held announce (cap " + std::to_string(held_maxsize) + ")");
-					_held_announces.erase(_held_announces.begin());
+					_instance->_held_announces.erase(_instance->_held_announces.begin());
 				}
 			}
 
-			// Cull the packet hashlist if it has reached its max size
-			if (_packet_hashlist.size() > _hashlist_maxsize) {
-				std::set<Bytes>::iterator iter = _packet_hashlist.begin();
-				std::advance(iter, _packet_hashlist.size() - _hashlist_maxsize);
-				_packet_hashlist.erase(_packet_hashlist.begin(), iter);
-			}
+			// CBA Packet hashlist is a fixed-size ring that culls itself on insert
 
 #ifdef BOUNDARY_MODE
-			// Cull the boundary mentioned addresses if it has reached its max size
-			if (_boundary_mentioned_addresses.size() > _boundary_maxsize) {
-				std::set<Bytes>::iterator iter = _boundary_mentioned_addresses.begin();
-				std::advance(iter, _boundary_mentioned_addresses.size() - _boundary_maxsize);
-				_boundary_mentioned_addresses.erase(_boundary_mentioned_addresses.begin(), iter);
-			}
-
-			// Cull the boundary local addresses if it has reached its max size
-			if (_boundary_local_addresses.size() > _boundary_maxsize) {
-				std::set<Bytes>::iterator iter = _boundary_local_addresses.begin();
-				std::advance(iter, _boundary_local_addresses.size() - _boundary_maxsize);
-				_boundary_local_addresses.erase(_boundary_local_addresses.begin(), iter);
-			}
+			// Age out a slice of the boundary whitelist; when full, inserts evict by CLOCK
+			_instance->_boundary_whitelist.cull(Type::Transport::BOUNDARY_WHITELIST_CULL);
 #endif
 
 			// Cull the path request tags list if it has reached its max size
-			if (_discovery_pr_tags.size() > _max_pr_tags) {
-				std::set<Bytes>::iterator iter = _discovery_pr_tags.begin();
-				std::advance(iter, _discovery_pr_tags.size() - _max_pr_tags);
-				_discovery_pr_tags.erase(_discovery_pr_tags.begin(), iter);
+			if (_instance->_discovery_pr_tags.size() > _instance->_max_pr_tags) {
+				std::set<Bytes>::iterator iter = _instance->_discovery_pr_tags.begin();
+				std::advance(iter, _instance->_discovery_pr_tags.size() - _instance->_max_pr_tags);
+				_instance->_discovery_pr_tags.erase(_instance->_discovery_pr_tags.begin(), iter);
 			}
 
-			if (OS::time() > (_tables_last_culled + _tables_cull_interval)) {
+			// CBA Periodically persist data
+			//if (OS::seconds() > (_instance->_last_saved + _instance->_save_interval)) {
+			//	persist_data();
+			//	_instance->_last_saved = OS::seconds();
+			//}
+		}
+		else {
+			// Transport jobs were locked, do nothing
+			//p pass
+		}
+	}
+	catch (std::exception& e) {
+		ERROR("An exception occurred while running Transport jobs.");
+		ERRORF("The contained exception was: %s", e.what());
+	}
 
-				// CBA Disabled following since we're calling immediately after adding to path table now
-				// Cull the path table if it has reached its max size
-				//cull_path_table();
+	_instance->_jobs_running = false;
 
-				// Cull the reverse table according to timeout
-				std::vector<Bytes> stale_reverse_entries;
-				for (const auto& [packet_hash, reverse_entry] : _reverse_table) {
-					if (OS::time() > (reverse_entry._timestamp + REVERSE_TIMEOUT)) {
-						stale_reverse_entries.push_back(packet_hash);
-					}
+	// Heap telemetry: snapshot at jobs exit
+	if (RNS_LOG_ENABLED(LOG_VERBOSE)) {
+		size_t _jobs_heap_exit = OS::heap_available();
+		int _jobs_delta = (int)_jobs_heap_exit - (int)_jobs_heap_entry;
+		if (_jobs_delta < -64 || _jobs_delta > 64) {
+			VERBOSEF("[HEAP-TEL] jobs: %d bytes (heap=%u)", _jobs_delta, (uint32_t)_jobs_heap_exit);
+		}
+	}
+
+	// CBA send announce retransmission packets, a retry of an already sent (and packed)
+	// rebroadcast goes straight to outbound() as send() only takes a packet once
+	for (auto& packet : _instance->_jobs_outgoing) {
+		DEBUG("DIAG: OUTGOING announce dest=" + packet.destination_hash().toHex().substr(0,8) + " type=" + std::to_string(packet.packet_type()) + " ctx=" + std::to_string(packet.context()) + " attached=" + (packet.attached_interface() ? packet.attached_interface().toString() : "NONE"));
+		if (packet.sent()) {
+			outbound(packet);
+		}
+		else {
+			packet.send();
+		}
+	}
+	// CBA release packets now rather than holding them until the next tick
+	_instance->_jobs_outgoing.clear();
+
+	// CBA send link-related path requests
+	for (auto& destination_hash : _instance->_jobs_path_requests) {
+		request_path(destination_hash);
+	}
+	_instance->_jobs_path_requests.clear();
+	if (_instance->_callbacks._jobs_profile) _instance->_callbacks._jobs_profile(JOB_COUNT);
+}
+
+/*static*/ void Transport::run_job(job_types job) {
+	switch (job) {
+	case JOB_PENDING_LINKS:
+		run_links_job(job, _instance->_pending_links, true);
+		break;
+	case JOB_ACTIVE_LINKS:
+		run_links_job(job, _instance->_active_links, false);
+		break;
+	case JOB_RECEIPTS:
+		run_receipts_job();
+		break;
+	case JOB_ANNOUNCES:
+		run_announces_job();
+		break;
+	case JOB_REVERSE_CULL:
+	case JOB_LINK_CULL:
+	case JOB_PATH_CULL:
+		run_table_cull_job(job);
+		break;
+	case JOB_DISCOVERY_CULL:
+	case JOB_PATH_REQUEST_CULL:
+	case JOB_LOCAL_REQUEST_CULL:
+		run_request_cull_job(job);
+		break;
+	case JOB_TUNNEL_CULL:
+		run_tunnel_cull_job();
+		break;
+	case JOB_PATH_WARM:
+		run_path_warm_job();
+		break;
+	default:
+		break;
+	}
+}
+
+/*static*/ void Transport::queue_path_request(const Bytes& destination_hash) {
+	if (std::find(_instance->_jobs_path_requests.begin(), _instance->_jobs_path_requests.end(), destination_hash) == _instance->_jobs_path_requests.end()) {
+		_instance->_jobs_path_requests.push_back(destination_hash);
+	}
+}
+
+// Process active and pending link lists
+/*static*/ void Transport::run_links_job(job_types job, Utilities::HashTable<Link>& links, bool pending) {
+	if (!_instance->_jobs[job].due(OS::ticks())) {
+		return;
+	}
+	_instance->_jobs[job]._active = true;
+	// CBA Closed links are collected during the sweep and erased after it, so nothing
+	// iterates over a copy of the table. The watchdogs of the others run after the sweep
+	// too, a link closed by its watchdog calls back into the application, which may open
+	// another; it is erased on the next pass.
+	_instance->_stale_entries.clear();
+	_instance->_watchdog_links.clear();
+	bool done = sweep_table(links, _instance->_jobs[job], _instance->_stale_entries, [pending](const Bytes& link_id, const Link& link) {
+		if (link.status() != Type::Link::CLOSED) {
+			_instance->_watchdog_links.push_back(link);
+			return false;
+		}
+		// If we are not a Transport Instance, finding a pending link
+		// that was never activated will trigger an expiry of the path
+		// to the destination, and an attempt to rediscover the path.
+		if (pending && !Reticulum::transport_enabled()) {
+			expire_path(link.destination().hash());
+
+			// If we are connected to a shared instance, it will take
+			// care of sending out a new path request. If not, we will
+			// send one directly.
+			if (!_instance->_owner->is_connected_to_shared_instance()) {
+				uint32_t last_path_request = 0;
+				auto iter = _instance->_path_requests.find(link.destination().hash());
+				if (iter != _instance->_path_requests.end()) {
+					last_path_request = (*iter).second;
 				}
 
-				// Cull the link table according to timeout
-				std::vector<Bytes> stale_links;
-				for (const auto& [link_id, link_entry] : _link_table) {
-					if (link_entry._validated) {
-						if (OS::time() > (link_entry._timestamp + LINK_TIMEOUT)) {
-							stale_links.push_back(link_id);
-						}
-					}
-					else {
-						if (OS::time() > link_entry._proof_timeout) {
-							stale_links.push_back(link_id);
+				if ((OS::seconds() - last_path_request) > Type::Transport::PATH_REQUEST_MI) {
+					DEBUG("Trying to rediscover path for " + link.destination().hash().toHex() + " since an attempted link was never established");
+					queue_path_request(link.destination().hash());
+				}
+			}
+		}
+		return true;
+	});
+	for (auto& link_id : _instance->_stale_entries) {
+		links.erase(link_id);
+	}
+	_instance->_stale_entries.clear();
+	for (auto& link : _instance->_watchdog_links) {
+		link.watchdog_job();
+	}
+	_instance->_watchdog_links.clear();
+	if (done) {
+		_instance->_jobs[job].finish(OS::ticks());
+	}
+}
 
-							double last_path_request = 0.0;
-							const auto& iter = _path_requests.find(link_entry._destination_hash);
-							if (iter != _path_requests.end()) {
-								last_path_request = (*iter).second;
-							}
+// Process receipts list for timed-out packets
+/*static*/ void Transport::run_receipts_job() {
+	Job& job = _instance->_jobs[JOB_RECEIPTS];
+	if (!job.due(OS::ticks())) {
+		return;
+	}
+	if (!job._active) {
+		job._active = true;
+		while (_instance->_receipts.size() > Type::Transport::MAX_RECEIPTS) {
+			//p culled_receipt = Transport.receipts.pop(0)
+			// CBA Receipts are only touched on insert, so the least recently used is the oldest
+			auto oldest = _instance->_receipts.lru();
+			PacketReceipt culled_receipt = (*oldest).second;
+			_instance->_receipts.erase(oldest);
+			culled_receipt.set_timeout(-1);
+			culled_receipt.check_timeout();
+		}
+	}
+	// CBA Only receipts whose timeout has come up are checked
+	_instance->_receipt_timers.advance(OS::seconds(), [](const PacketReceipt& timer_receipt, uint32_t deadline) {
+		PacketReceipt receipt(timer_receipt);
+		if (receipt.status() == Type::PacketReceipt::SENT) {
+			receipt.check_timeout();
+			if (receipt.status() == Type::PacketReceipt::SENT) {
+				// timeout was extended after the receipt was scheduled
+				schedule_receipt(receipt);
+				return;
+			}
+		}
+		//p if receipt.status != RNS.PacketReceipt.SENT:
+		//p 	if receipt in Transport.receipts:
+		//p 		Transport.receipts.remove(receipt)
+		remove_receipt(receipt);
+	});
+	job.finish(OS::ticks());
+}
 
-							uint8_t lr_taken_hops = link_entry._hops;
+// Process announces needing retransmission
+/*static*/ void Transport::run_announces_job() {
+	Job& job = _instance->_jobs[JOB_ANNOUNCES];
+	if (!job.due(OS::ticks())) {
+		return;
+	}
+	// CBA Only entries whose retransmit timer has come up are visited. Every insert schedules
+	// a timer for its entry, so a timer whose deadline no longer matches its entry (retransmitted
+	// or replaced since) is stale and dropped, and one for an entry that is gone is ignored.
+	_instance->_announce_timers.advance(OS::ticks(), [](const Bytes& destination_hash, uint32_t deadline) {
+		auto iter = _instance->_announce_table.find(destination_hash);
+		if (iter == _instance->_announce_table.end()) {
+			return;
+		}
+		//p announce_entry = Transport.announce_table[destination_hash]
+		AnnounceEntry& announce_entry = (*iter).second;
+		if (announce_deadline(announce_entry) != deadline) {
+			return;
+		}
+		DEBUG("DIAG: ANNOUNCE-ENTRY dest=" + destination_hash.toHex().substr(0,8) + " retries=" + std::to_string(announce_entry._retries) + " block=" + std::to_string(announce_entry._block_rebroadcasts) + " timeout_in=" + std::to_string((int32_t)(announce_entry._retransmit_timeout - OS::ticks())));
+		if (announce_entry._retries > 0 && announce_entry._retries >= Type::Transport::LOCAL_REBROADCASTS_MAX) {
+			TRACE("Completed announce processing for " + destination_hash.toHex() + ", local rebroadcast limit reached");
+			_instance->_announce_table.erase(iter);
+			return;
+		}
+		else if (announce_entry._retries > Type::Transport::PATHFINDER_R) {
+			DEBUG("DIAG: ANNOUNCE-CULL dest=" + destination_hash.toHex().substr(0,8) + " retries=" + std::to_string(announce_entry._retries) + " reason=retry_limit");
+			TRACE("Completed announce processing for " + destination_hash.toHex() + ", retry limit reached");
+			_instance->_announce_table.erase(iter);
+			return;
+		}
 
-							bool path_request_throttle = (OS::time() - last_path_request) < PATH_REQUEST_MI;
-							bool path_request_conditions = false;
-							
-							// If the path has been invalidated between the time of
-							// making the link request and now, try to rediscover it
-							if (!has_path(link_entry._destination_hash)) {
-								DEBUG("Trying to rediscover path for " + link_entry._destination_hash.toHex() + " since an attempted link was never established, and path is now missing");
-								path_request_conditions = true;
-							}
+		TRACE("Performing announce processing for " + destination_hash.toHex() + "...");
+		announce_entry._retransmit_timeout = OS::ticks() + (uint32_t)((Type::Transport::PATHFINDER_G + Type::Transport::PATHFINDER_RW) * 1000);
+		announce_entry._retries += 1;
+		_instance->_announce_timers.schedule(destination_hash, announce_deadline(announce_entry));
+
+		// CBA The rebroadcast packet is built and packed on the first retransmission and kept
+		// with the entry, later retries send the same frame again
+		if (!announce_entry._rebroadcast) {
+			//p packet = announce_entry[5]
+			//p block_rebroadcasts = announce_entry[7]
+			//p attached_interface = announce_entry[8]
+			Type::Packet::context_types announce_context = Type::Packet::CONTEXT_NONE;
+			if (announce_entry._block_rebroadcasts) {
+				announce_context = Type::Packet::PATH_RESPONSE;
+			}
+			//p announce_data = packet.data
+			Identity announce_identity(Identity::recall(announce_entry._packet.destination_hash()));
+			Destination announce_destination(announce_identity, Type::Destination::OUT, Type::Destination::SINGLE, announce_entry._packet.destination_hash());
+			//P announce_destination.hexhash = announce_destination.hash.hex()
+
+			announce_entry._rebroadcast = Packet(
+				announce_destination,
+				announce_entry._attached_interface,
+				announce_entry._packet.data(),
+				Type::Packet::ANNOUNCE,
+				announce_context,
+				Type::Transport::TRANSPORT,
+				Type::Packet::HEADER_2,
+				_instance->_identity.hash(),
+				true,
+				announce_entry._packet.context_flag()
+			);
+			announce_entry._rebroadcast.hops(announce_entry._hops);
+			announce_entry._rebroadcast.pack();
+		}
+		if (announce_entry._block_rebroadcasts) {
+			DEBUG("Rebroadcasting announce as path response for " + destination_hash.toHex() + " with hop count " + std::to_string(announce_entry._hops));
+			DEBUG("DIAG: SENDING PATH-RESP announce for " + destination_hash.toHex().substr(0,8) + " hops=" + std::to_string(announce_entry._hops) + " attached=" + (announce_entry._attached_interface ? announce_entry._attached_interface.toString() : "NONE"));
+		}
+		else {
+			DEBUG("Rebroadcasting announce for " + destination_hash.toHex() + " with hop count " + std::to_string(announce_entry._hops));
+		}
 
-							// If this link request was originated from a local client
-							// attempt to rediscover a path to the destination, if this
-							// has not already happened recently.
-							else if (!path_request_throttle && lr_taken_hops == 0) {
-								DEBUG("Trying to rediscover path for " + link_entry._destination_hash.toHex() + " since an attempted local client link was never established");
-								path_request_conditions = true;
-							}
+		_instance->_jobs_outgoing.push_back(announce_entry._rebroadcast);
+		if (announce_entry._block_rebroadcasts && announce_entry._attached_interface) {
+			path_response_sent(destination_hash, announce_entry._attached_interface);
+		}
 
-							// If the link destination was previously only 1 hop
-							// away, this likely means that it was local to one
-							// of our interfaces, and that it roamed somewhere else.
-							// In that case, try to discover a new path.
-							else if (!path_request_throttle && hops_to(link_entry._destination_hash) == 1) {
-								DEBUG("Trying to rediscover path for " + link_entry._destination_hash.toHex() + " since an attempted link was never established, and destination was previously local to an interface on this instance");
-								path_request_conditions = true;
-							}
+		// This handles an edge case where a peer sends a past
+		// request for a destination just after an announce for
+		// said destination has arrived, but before it has been
+		// rebroadcast locally. In such a case the actual announce
+		// is temporarily held, and then reinserted when the path
+		// request has been served to the peer.
+		//p if destination_hash in Transport.held_announces:
+		auto held_iter = _instance->_held_announces.find(destination_hash);
+		if (held_iter != _instance->_held_announces.end()) {
+			//p held_entry = Transport.held_announces.pop(destination_hash)
+			AnnounceEntry held_entry = (*held_iter).second;
+			_instance->_held_announces.erase(held_iter);
+			//p Transport.announce_table[destination_hash] = held_entry
+			DEBUG("Reinserting held announce into table");
+			insert_announce(Bytes(destination_hash), held_entry);
+		}
+	});
+	job.finish(OS::ticks());
+}
 
-							// If the link destination was previously only 1 hop
-							// away, this likely means that it was local to one
-							// of our interfaces, and that it roamed somewhere else.
-							// In that case, try to discover a new path.
-							else if ( !path_request_throttle and lr_taken_hops == 1) {
-								DEBUG("Trying to rediscover path for " + link_entry._destination_hash.toHex() + " since an attempted link was never established, and link initiator is local to an interface on this instance");
-								path_request_conditions = true;
-							}
+// Cull the reverse, link and path tables according to timeout
+/*static*/ void Transport::run_table_cull_job(job_types job) {
+	if (!_instance->_jobs[job].due(OS::ticks())) {
+		return;
+	}
+	_instance->_jobs[job]._active = true;
+
+	// CBA Disabled following since we're calling immediately after adding to path table now
+	// Cull the path table if it has reached its max size
+	//cull_path_table();
+
+	_instance->_stale_entries.clear();
+	bool done = false;
+	if (job == JOB_REVERSE_CULL) {
+		// Cull the reverse table according to timeout, only entries whose timer is due are checked
+		uint32_t now = OS::seconds();
+		_instance->_reverse_timers.advance(now, [now](const Bytes& packet_hash, uint32_t deadline) {
+			// CBA const lookup so that the check doesn't refresh the entry's LRU stamp
+			const auto& reverse_table = _instance->_reverse_table;
+			auto iter = reverse_table.find(packet_hash);
+			if (iter == reverse_table.end()) {
+				return;
+			}
+			uint32_t expiry = reverse_deadline((*iter).second);
+			if (now >= expiry) {
+				_instance->_stale_entries.push_back(packet_hash);
+			}
+			else if (expiry != deadline) {
+				// entry was replaced after this timer was scheduled
+				_instance->_reverse_timers.schedule(packet_hash, expiry);
+			}
+		});
+		remove_reverse_entries(_instance->_stale_entries);
+		done = true;
+	}
+	else if (job == JOB_LINK_CULL) {
+		// Cull the link table according to timeout
+		uint32_t now = OS::seconds();
+		done = sweep_table(_instance->_link_table, _instance->_jobs[job], _instance->_stale_entries, [now](const Bytes& link_id, const LinkEntry& link_entry) {
+			if (link_entry._validated) {
+				return (now > (link_entry._timestamp + (uint32_t)LINK_TIMEOUT));
+			}
+			if (now <= link_entry._proof_timeout) {
+				return false;
+			}
 
-							if (path_request_conditions) {
-								if (path_requests.count(link_entry._destination_hash) == 0) {
-									// CBA ACCUMULATES
-									path_requests.insert(link_entry._destination_hash);
-								}
+			uint32_t last_path_request = 0;
+			const auto& iter = _instance->_path_requests.find(link_entry._destination_hash);
+			if (iter != _instance->_path_requests.end()) {
+				last_path_request = (*iter).second;
+			}
 
-								if (!Reticulum::transport_enabled()) {
-									// Drop current path if we are not a transport instance, to
-									// allow using higher-hop count paths or reused announces
-									// from newly adjacent transport instances.
-									expire_path(link_entry._destination_hash);
-								}
-							}
-						}
-					}
-				}
+			uint8_t lr_taken_hops = link_entry._hops;
 
-				// Cull the path table
-				std::vector<Bytes> stale_paths;
-				for (const auto& [destination_hash, destination_entry] : _destination_table) {
-					const Interface& attached_interface = destination_entry.receiving_interface();
-					double destination_expiry;
-					if (attached_interface && attached_interface.mode() == Type::Interface::MODE_ACCESS_POINT) {
-						destination_expiry = destination_entry._timestamp + AP_PATH_TIME;
-					}
-					else if (attached_interface && attached_interface.mode() == Type::Interface::MODE_ROAMING) {
-						destination_expiry = destination_entry._timestamp + ROAMING_PATH_TIME;
-					}
-					else {
-						destination_expiry = destination_entry._timestamp + DESTINATION_TIMEOUT;
-					}
+			bool path_request_throttle = (now - last_path_request) < PATH_REQUEST_MI;
+			bool path_request_conditions = false;
 
-					if (OS::time() > destination_expiry) {
-						stale_paths.push_back(destination_hash);
-						DEBUG("Path to " + destination_hash.toHex() + " timed out and was removed");
-					}
-					else if (_interfaces.count(attached_interface.get_hash()) == 0) {
-						stale_paths.push_back(destination_hash);
-						DEBUG("Path to " + destination_hash.toHex() + " was removed since the attached interface no longer exists");
-					}
-				}
+			// If the path has been invalidated between the time of
+			// making the link request and now, try to rediscover it
+			if (!has_path(link_entry._destination_hash)) {
+				DEBUG("Trying to rediscover path for " + link_entry._destination_hash.toHex() + " since an attempted link was never established, and path is now missing");
+				path_request_conditions = true;
+			}
 
-				// Cull the pending discovery path requests table
-				std::vector<Bytes> stale_discovery_path_requests;
-				for (const auto& [destination_hash, path_entry] : _discovery_path_requests) {
-					if (OS::time() > path_entry._timeout) {
-						stale_discovery_path_requests.push_back(destination_hash);
-						DEBUG("Waiting path request for " + destination_hash.toString() + " timed out and was removed");
-					}
-				}
+			// If this link request was originated from a local client
+			// attempt to rediscover a path to the destination, if this
+			// has not already happened recently.
+			else if (!path_request_throttle && lr_taken_hops == 0) {
+				DEBUG("Trying to rediscover path for " + link_entry._destination_hash.toHex() + " since an attempted local client link was never established");
+				path_request_conditions = true;
+			}
 
-				// Cull the path requests table (entries older than destination timeout)
-				{
-					std::vector<Bytes> stale_path_requests;
-					for (const auto& [destination_hash, timestamp] : _path_requests) {
-						if (OS::time() > (timestamp + DESTINATION_TIMEOUT)) {
-							stale_path_requests.push_back(destination_hash);
-						}
-					}
-					for (const Bytes& destination_hash : stale_path_requests) {
-						_path_requests.erase(destination_hash);
-					}
-				}
+			// If the link destination was previously only 1 hop
+			// away, this likely means that it was local to one
+			// of our interfaces, and that it roamed somewhere else.
+			// In that case, try to discover a new path.
+			else if (!path_request_throttle && hops_to(link_entry._destination_hash) == 1) {
+				DEBUG("Trying to rediscover path for " + link_entry._destination_hash.toHex() + " since an attempted link was never established, and destination was previously local to an interface on this instance");
+				path_request_conditions = true;
+			}
 
-				// Cull pending local path requests for interfaces that no longer exist
-				{
-					std::vector<Bytes> stale_plpr;
-					for (const auto& [destination_hash, iface] : _pending_local_path_requests) {
-						if (_interfaces.count(iface.get_hash()) == 0) {
-							stale_plpr.push_back(destination_hash);
-						}
-					}
-					for (const Bytes& destination_hash : stale_plpr) {
-						_pending_local_path_requests.erase(destination_hash);
-					}
-				}
+			// If the link destination was previously only 1 hop
+			// away, this likely means that it was local to one
+			// of our interfaces, and that it roamed somewhere else.
+			// In that case, try to discover a new path.
+			else if ( !path_request_throttle and lr_taken_hops == 1) {
+				DEBUG("Trying to rediscover path for " + link_entry._destination_hash.toHex() + " since an attempted link was never established, and link initiator is local to an interface on this instance");
+				path_request_conditions = true;
+			}
 
-				// Cull the tunnel table
-				count = 0;
-				std::vector<Bytes> stale_tunnels;
-				for (const auto& [tunnel_id, tunnel_entry] : _tunnels) {
-					if (OS::time() > tunnel_entry._expires) {
-						stale_tunnels.push_back(tunnel_id);
-						TRACE("Tunnel " + tunnel_id.toHex() + " timed out and was removed");
-					}
-					else {
-						std::vector<Bytes> stale_tunnel_paths;
-						for (const auto& [destination_hash, destination_entry] : tunnel_entry._serialised_paths) {
-							if (OS::time() > (destination_entry._timestamp + DESTINATION_TIMEOUT)) {
-								stale_tunnel_paths.push_back(destination_hash);
-								TRACE("Tunnel path to " + destination_hash.toHex() + " timed out and was removed");
-							}
-						}
+			if (path_request_conditions) {
+				queue_path_request(link_entry._destination_hash);
 
-						//for (const auto& destination_hash : stale_tunnel_paths) {
-						for (const Bytes& destination_hash : stale_tunnel_paths) {
-							const_cast<TunnelEntry&>(tunnel_entry)._serialised_paths.erase(destination_hash);
-							++count;
-						}
-					}
+				if (!Reticulum::transport_enabled()) {
+					// Drop current path if we are not a transport instance, to
+					// allow using higher-hop count paths or reused announces
+					// from newly adjacent transport instances.
+					expire_path(link_entry._destination_hash);
 				}
-				if (count > 0) {
-					TRACE("Removed " + std::to_string(count) + " tunnel paths");
-				}
-				
-				remove_reverse_entries(stale_reverse_entries);
-				remove_links(stale_links);
-				remove_paths(stale_paths);
-				remove_discovery_path_requests(stale_discovery_path_requests);
-				remove_tunnels(stale_tunnels);
+			}
+			return true;
+		});
+		remove_links(_instance->_stale_entries);
+	}
+	else if (job == JOB_PATH_CULL) {
+		// Cull the path table, only paths whose timer is due are checked
+		uint32_t now = OS::seconds();
+		_instance->_path_timers.advance(now, [now](const Bytes& destination_hash, uint32_t deadline) {
+			// CBA const lookup so that the check doesn't refresh the entry's LRU stamp
+			const auto& destination_table = _instance->_destination_table;
+			auto iter = destination_table.find(destination_hash);
+			if (iter == destination_table.end()) {
+				return;
+			}
+			DestinationEntry& destination_entry = const_cast<DestinationEntry&>((*iter).second);
+			if (destination_entry._cull_at != deadline) {
+				// superseded by an earlier timer
+				return;
+			}
+			destination_entry._cull_at = 0;
+			if (!destination_entry.receiving_interface()) {
+				// ids resolve only while the interface is registered
+				DEBUG("Path to " + destination_hash.toHex() + " was removed since the attached interface no longer exists");
+				_instance->_stale_entries.push_back(destination_hash);
+			}
+			else if (now >= path_deadline(destination_entry)) {
+				DEBUG("Path to " + destination_hash.toHex() + " timed out and was removed");
+				_instance->_stale_entries.push_back(destination_hash);
+			}
+			else {
+				// used since it was scheduled
+				schedule_path(destination_hash, destination_entry);
+			}
+		});
+		remove_paths(_instance->_stale_entries);
+		done = true;
+	}
+	_instance->_stale_entries.clear();
 
-//#ifndef NDEBUG
-				dump_stats();
-//#endif
+	if (done) {
+		_instance->_jobs[job].finish(OS::ticks());
+	}
+}
 
-				_tables_last_culled = OS::time();
+// Cull the path request tables
+/*static*/ void Transport::run_request_cull_job(job_types job) {
+	if (!_instance->_jobs[job].due(OS::ticks())) {
+		return;
+	}
+	_instance->_jobs[job]._active = true;
+	bool done = false;
+	uint32_t now = OS::seconds();
+	if (job == JOB_DISCOVERY_CULL) {
+		// Cull the pending discovery path requests table
+		done = sweep(_instance->_discovery_path_requests, _instance->_jobs[job], [now](const auto& entry) {
+			if (now > entry.second._timeout) {
+				DEBUG("Waiting path request for " + entry.first.toHex() + " timed out and was removed");
+				return true;
 			}
+			return false;
+		});
+	}
+	else if (job == JOB_PATH_REQUEST_CULL) {
+		// Cull the path requests table (entries older than destination timeout)
+		done = sweep(_instance->_path_requests, _instance->_jobs[job], [now](const auto& entry) {
+			return (now > (entry.second + DESTINATION_TIMEOUT));
+		});
+	}
+	else if (job == JOB_LOCAL_REQUEST_CULL) {
+		// Cull pending local path requests for interfaces that no longer exist
+		done = sweep(_instance->_pending_local_path_requests, _instance->_jobs[job], [](const auto& entry) {
+			return (_instance->_interfaces.count(entry.second.get_hash()) == 0);
+		});
+	}
+	if (done) {
+		_instance->_jobs[job].finish(OS::ticks());
+	}
+}
 
-			// CBA Periodically persist data
-			//if (OS::time() > (_last_saved + _save_interval)) {
-			//	persist_data();
-			//	_last_saved = OS::time();
-			//}
+// Cull the tunnel table
+/*static*/ void Transport::run_tunnel_cull_job() {
+	Job& job = _instance->_jobs[JOB_TUNNEL_CULL];
+	if (!job.due(OS::ticks())) {
+		return;
+	}
+	job._active = true;
+	uint16_t count = 0;
+	uint32_t now = OS::seconds();
+	bool done = sweep(_instance->_tunnels, job, [&count, now](auto& entry) {
+		if (now > entry.second._expires) {
+			TRACE("Tunnel " + entry.first.toHex() + " timed out and was removed");
+			return true;
 		}
-		else {
-			// Transport jobs were locked, do nothing
-			//p pass
+		auto iter = entry.second._serialised_paths.begin();
+		while (iter != entry.second._serialised_paths.end()) {
+			if (now > ((*iter).second._timestamp + DESTINATION_TIMEOUT)) {
+				TRACE("Tunnel path to " + (*iter).first.toHex() + " timed out and was removed");
+				iter = entry.second._serialised_paths.erase(iter);
+				++count;
+			}
+			else {
+				++iter;
+			}
 		}
+		return false;
+	});
+	if (count > 0) {
+		TRACE("Removed " + std::to_string(count) + " tunnel paths");
 	}
-	catch (std::exception& e) {
-		ERROR("An exception occurred while running Transport jobs.");
-		ERRORF("The contained exception was: %s", e.what());
+	if (done) {
+		job.finish(OS::ticks());
+//#ifndef NDEBUG
+		dump_stats();
+//#endif
 	}
+}
 
-	_jobs_running = false;
-
-	// Heap telemetry: snapshot at jobs exit
-	{
-		size_t _jobs_heap_exit = OS::heap_available();
-		int _jobs_delta = (int)_jobs_heap_exit - (int)_jobs_heap_entry;
-		if (_jobs_delta < -64 || _jobs_delta > 64) {
-			VERBOSEF("[HEAP-TEL] jobs: %d bytes (heap=%u)", _jobs_delta, (uint32_t)_jobs_heap_exit);
-		}
+// CBA Request counts are halved once for every PATH_WARM_DECAY seconds since they were last decayed
+static void decay_heat(Transport::HeatEntry& heat_entry, uint32_t now) {
+	uint32_t periods = (now - heat_entry._decayed_at) / Type::Transport::PATH_WARM_DECAY;
+	if (periods == 0) {
+		return;
 	}
+	heat_entry._requests = (periods < 16) ? (heat_entry._requests >> periods) : 0;
+	heat_entry._decayed_at += periods * Type::Transport::PATH_WARM_DECAY;
+}
 
-	// CBA send announce retransmission packets
-	for (auto& packet : outgoing) {
-		DEBUG("DIAG: OUTGOING announce dest=" + packet.destination_hash().toHex().substr(0,8) + " type=" + std::to_string(packet.packet_type()) + " ctx=" + std::to_string(packet.context()) + " attached=" + (packet.attached_interface() ? packet.attached_interface().toString() : "NONE"));
-		packet.send();
+/*static*/ void Transport::record_path_request(const Bytes& destination_hash) {
+	uint32_t now = OS::seconds();
+	auto iter = _instance->_path_heat_table.find(destination_hash);
+	if (iter == _instance->_path_heat_table.end()) {
+		// CBA ACCUMULATES, bounded by PATH_HEAT_MAXSIZE
+		iter = _instance->_path_heat_table.insert({destination_hash, HeatEntry(now)}).first;
+	}
+	HeatEntry& heat_entry = (*iter).second;
+	decay_heat(heat_entry, now);
+	if (heat_entry._requests < UINT16_MAX) {
+		++heat_entry._requests;
 	}
+}
 
-	// CBA send link-related path requests
-	for (auto& destination_hash : path_requests) {
-		request_path(destination_hash);
+// CBA Path warming for destinations that clients on the LoRa side keep asking for, so their
+// path requests are answered at once from the path table instead of waiting on a backbone
+// round trip. For each hot destination (PATH_WARM_THRESHOLD requests, decayed):
+//   - without a path, the path is requested on the backbone interfaces, at most once every
+//     PATH_WARM_INTERVAL seconds, so a path lost to expiry, eviction or a failed link is back
+//     before the next client asks
+//   - with one, its announce frame is read back into RAM if the packet cache had spilled it,
+//     so the path response doesn't wait on flash
+// A known path isn't re-requested ahead of its expiry: the answer would be the same announce,
+// which is refused as a replay, and paths that clients use are kept alive by use anyway.
+/*static*/ void Transport::run_path_warm_job() {
+	Job& job = _instance->_jobs[JOB_PATH_WARM];
+	if (!job.due(OS::ticks())) {
+		return;
+	}
+	if (!Reticulum::transport_enabled() || _instance->_path_heat_table.empty()) {
+		job.finish(OS::ticks());
+		return;
+	}
+	job._active = true;
+	uint32_t now = OS::seconds();
+	_instance->_stale_entries.clear();
+	bool done = sweep_table(_instance->_path_heat_table, job, _instance->_stale_entries, [now](const Bytes& destination_hash, HeatEntry& heat_entry) {
+		decay_heat(heat_entry, now);
+		if (heat_entry._requests == 0) {
+			return true;
+		}
+		if (heat_entry._requests < Type::Transport::PATH_WARM_THRESHOLD) {
+			return false;
+		}
+		// CBA const lookup so that warming doesn't refresh the path's LRU stamp
+		const auto& destination_table = _instance->_destination_table;
+		auto iter = destination_table.find(destination_hash);
+		if (iter != destination_table.end()) {
+			const Bytes& packet_hash = (*iter).second._announce_packet;
+			if (!_instance->_packet_cache->resident(packet_hash)) {
+				Bytes raw;
+				if (_instance->_packet_cache->get(packet_hash, raw)) {
+					++_instance->_path_announces_promoted;
+				}
+			}
+			return false;
+		}
+		if (heat_entry._warmed_at != 0 && (now - heat_entry._warmed_at) < Type::Transport::PATH_WARM_INTERVAL) {
+			return false;
+		}
+		heat_entry._warmed_at = now;
+		DEBUG("Warming path to " + destination_hash.toHex() + " after " + std::to_string(heat_entry._requests) + " path requests");
+		Bytes request_tag = Identity::get_random_hash();
+#if defined(INTERFACES_SET)
+		for (const Interface& interface : _instance->_interfaces) {
+#elif defined(INTERFACES_LIST)
+		for (Interface& interface : _instance->_interfaces) {
+#elif defined(INTERFACES_MAP)
+		for (auto& [hash, interface] : _instance->_interfaces) {
+#endif
+			if (is_backbone_interface(interface) && interface.online()) {
+				request_path(destination_hash, interface, request_tag);
+			}
+		}
+		++_instance->_paths_warmed;
+		return false;
+	});
+	for (auto& destination_hash : _instance->_stale_entries) {
+		_instance->_path_heat_table.erase(destination_hash);
+	}
+	_instance->_stale_entries.clear();
+	if (done) {
+		job.finish(OS::ticks());
 	}
 }
 
-/*static*/ void Transport::transmit(Interface& interface, const Bytes& raw) {
+/*static*/ bool Transport::transmit(Interface& interface, const Bytes& raw) {
 	TRACE("Transport::transmit()");
 	// CBA
-	if (_callbacks._transmit_packet) {
+	if (_instance->_callbacks._transmit_packet) {
 		try {
-			_callbacks._transmit_packet(raw, interface);
+			_instance->_callbacks._transmit_packet(raw, interface);
 		}
 		catch (std::exception& e) {
 			DEBUG("Error while executing transmit packet callback. The contained exception was: " + std::string(e.what()));
@@ -735,61 +991,34 @@ static bool is_backbone_interface(const Interface& iface) {
 	try {
 		//if hasattr(interface, "ifac_identity") and interface.ifac_identity != None:
 		if (interface.ifac_identity()) {
-			// Calculate packet access code by signing the raw packet
-			// and taking the last ifac_size bytes of the signature
-			Bytes signature = interface.ifac_id().sign(raw);
-			Bytes ifac = signature.right(interface.ifac_size());
-
-			// Generate mask via HKDF
-			Bytes mask = Cryptography::hkdf(
-				raw.size() + interface.ifac_size(),
-				ifac,
-				interface.ifac_key()
-			);
-
-			// Set IFAC flag in header byte 0
-			uint8_t new_header0 = raw[0] | 0x80;
-			uint8_t new_header1 = raw[1];
-
-			// Assemble new payload: new_header + ifac + raw[2:]
-			Bytes new_raw;
-			new_raw.append(new_header0);
-			new_raw.append(new_header1);
-			new_raw.append(ifac);
-			new_raw.append(raw.mid(2));
-
-			// Mask payload
+			// Sign with the interface identity and mask the frame
 			Bytes masked_raw;
-			for (size_t i = 0; i < new_raw.size(); i++) {
-				if (i == 0) {
-					// Mask first header byte, keep IFAC flag set
-					masked_raw.append((uint8_t)((new_raw[i] ^ mask[i]) | 0x80));
-				}
-				else if (i == 1 || i > (size_t)(interface.ifac_size() + 1)) {
-					// Mask second header byte and payload
-					masked_raw.append((uint8_t)(new_raw[i] ^ mask[i]));
-				}
-				else {
-					// Don't mask the IFAC itself
-					masked_raw.append(new_raw[i]);
-				}
+			if (!interface.ifac().apply(raw, masked_raw)) {
+				ERROR("Transport::transmit: IFAC could not be applied on " + interface.toString());
+				return false;
+			}
+			if (!interface.send_outgoing(masked_raw)) {
+				TRACE("Transport::transmit: " + interface.toString() + " has no room, frame refused");
+				return false;
 			}
-
-			// Send it
-			interface.send_outgoing(masked_raw);
 		}
 		else {
-			interface.send_outgoing(raw);
+			if (!interface.send_outgoing(raw)) {
+				TRACE("Transport::transmit: " + interface.toString() + " has no room, frame refused");
+				return false;
+			}
 		}
 	}
 	catch (std::exception& e) {
 		ERROR("Error while transmitting on " + interface.toString() + ". The contained exception was: " + e.what());
+		return false;
 	}
+	return true;
 }
 
 /*static*/ bool Transport::outbound(Packet& packet) {
 	TRACE("Transport::outbound()");
-	++_packets_sent;
+	++_instance->_packets_sent;
 
 	if (!packet.destination()) {
 		//throw std::invalid_argument("Can not send packet with no destination.");
@@ -799,22 +1028,22 @@ static bool is_backbone_interface(const Interface& iface) {
 
 	TRACE("Transport::outbound: destination=" + packet.destination_hash().toHex() + " hops=" + std::to_string(packet.hops()));
 
-	while (_jobs_running) {
+	while (_instance->_jobs_running) {
 		TRACE("Transport::outbound: sleeping...");
 		OS::sleep(0.0005);
 	}
 
-	_jobs_locked = true;
+	_instance->_jobs_locked = true;
 
 	bool sent = false;
-	double outbound_time = OS::time();
+	uint32_t outbound_time = OS::seconds();
 
 	// Check if we have a known path for the destination in the path table
     //if packet.packet_type != RNS.Packet.ANNOUNCE and packet.destination.type != RNS.Destination.PLAIN and packet.destination.type != RNS.Destination.GROUP and packet.destination_hash in Transport.destination_table:
-	if (packet.packet_type() != Type::Packet::ANNOUNCE && packet.destination().type() != Type::Destination::PLAIN && packet.destination().type() != Type::Destination::GROUP && _destination_table.find(packet.destination_hash()) != _destination_table.end()) {
+	if (packet.packet_type() != Type::Packet::ANNOUNCE && packet.destination().type() != Type::Destination::PLAIN && packet.destination().type() != Type::Destination::GROUP && _instance->_destination_table.find(packet.destination_hash()) != _instance->_destination_table.end()) {
 		TRACE("Transport::outbound: Path to destination is known");
         //outbound_interface = Transport.destination_table[packet.destination_hash][5]
-		DestinationEntry& destination_entry = (*_destination_table.find(packet.destination_hash())).second;
+		DestinationEntry& destination_entry = (*_instance->_destination_table.find(packet.destination_hash())).second;
 		Interface outbound_interface = destination_entry.receiving_interface();
 
 		// If there's more than one hop to the destination, and we know
@@ -835,15 +1064,14 @@ static bool is_backbone_interface(const Interface& iface) {
 				//new_raw = struct.pack("!B", new_flags)
 				new_raw << new_flags;
 				//new_raw += packet.raw[1:2]
-				new_raw << packet.raw().mid(1,1);
+				new_raw << packet.raw().view(1,1);
 				//new_raw += Transport.destination_table[packet.destination_hash][1]
 				new_raw << destination_entry._received_from;
 				//new_raw += packet.raw[2:]
-				new_raw << packet.raw().mid(2);
-				transmit(outbound_interface, new_raw);
-				//_destination_table[packet.destination_hash][0] = time.time()
-				destination_entry._timestamp = OS::time();
-				sent = true;
+				new_raw << packet.raw().view(2);
+				sent = transmit(outbound_interface, new_raw);
+				//_instance->_destination_table[packet.destination_hash][0] = time.time()
+				touch_path(packet.destination_hash(), destination_entry);
 			}
 		}
 
@@ -855,7 +1083,7 @@ static bool is_backbone_interface(const Interface& iface) {
 		// are "behind" a shared instance, we need to get that instance
 		// to transport it onto the network.
         //elif Transport.destination_table[packet.destination_hash][2] == 1 and Transport.owner.is_connected_to_shared_instance:
-		else if (destination_entry._hops == 1 && _owner.is_connected_to_shared_instance()) {
+		else if (destination_entry._hops == 1 && _instance->_owner->is_connected_to_shared_instance()) {
 			TRACE("Transport::outbound: Sending packet for directly connected interface to shared instance...");
 			if (packet.header_type() == Type::Packet::HEADER_1) {
 				// Insert packet into transport
@@ -867,15 +1095,14 @@ static bool is_backbone_interface(const Interface& iface) {
 				//new_raw = struct.pack("!B", new_flags)
 				new_raw << new_flags;
 				//new_raw += packet.raw[1:2]
-				new_raw << packet.raw().mid(1, 1);
+				new_raw << packet.raw().view(1, 1);
 				//new_raw += Transport.destination_table[packet.destination_hash][1]
 				new_raw << destination_entry._received_from;
 				//new_raw += packet.raw[2:]
-				new_raw << packet.raw().mid(2);
-				transmit(outbound_interface, new_raw);
+				new_raw << packet.raw().view(2);
+				sent = transmit(outbound_interface, new_raw);
 				//Transport.destination_table[packet.destination_hash][0] = time.time()
-				destination_entry._timestamp = OS::time();
-				sent = true;
+				touch_path(packet.destination_hash(), destination_entry);
 			}
 		}
 
@@ -884,8 +1111,7 @@ static bool is_backbone_interface(const Interface& iface) {
 		// simply transmit the packet directly on that one.
 		else {
 			TRACE("Transport::outbound: Sending packet over directly connected interface...");
-			transmit(outbound_interface, packet.raw());
-			sent = true;
+			sent = transmit(outbound_interface, packet.raw());
 		}
 	}
 	// If we don't have a known path for the destination, we'll
@@ -895,27 +1121,71 @@ static bool is_backbone_interface(const Interface& iface) {
 	else {
 		TRACE("Transport::outbound: Path to destination is unknown");
 		bool stored_hash = false;
+
+		// CBA Everything that only depends on the packet is settled once here, the loop below
+		// only makes the per-interface decisions (mode, announce cap, attached interface) and
+		// transmit() applies the interface's IFAC. Lookups that only some interface modes need
+		// are made on first use and reused for the remaining interfaces.
+		const bool announce = (packet.packet_type() == Type::Packet::ANNOUNCE);
+		const Bytes& raw = packet.raw();
+		bool link_closed = false;
+		if (packet.destination().type() == Type::Destination::LINK) {
+			if (!packet.destination_link()) throw std::invalid_argument("Packet is not associated with a Link");
+			link_closed = (packet.destination_link().status() == Type::Link::CLOSED);
+			// CBA Bug? Destination has no member attached_interface
+			//z if (interface != packet.destination().attached_interface()) {
+			//z 	should_transmit = false;
+			//z }
+		}
+		int8_t announce_filter_passed = -1;
+		auto passes_announce_filter = [&]() {
+			if (announce_filter_passed < 0) {
+				announce_filter_passed = filter_announce(packet) ? 1 : 0;
+			}
+			return (announce_filter_passed > 0);
+		};
+		int8_t local_destination = -1;
+		auto is_local_destination = [&]() {
+			if (local_destination < 0) {
+				//local_destination = next((d for d in Transport.destinations if d.hash == packet.destination_hash), None)
+#if defined(DESTINATIONS_SET)
+				local_destination = 0;
+				for (auto& destination : _instance->_destinations) {
+					if (destination.hash() == packet.destination_hash()) {
+						local_destination = 1;
+						break;
+					}
+				}
+#elif defined(DESTINATIONS_MAP)
+				local_destination = (_instance->_destinations.find(packet.destination_hash()) != _instance->_destinations.end()) ? 1 : 0;
+#endif
+			}
+			return (local_destination > 0);
+		};
+		bool from_interface_known = false;
+		Interface from_interface({Type::NONE});
+		auto next_hop = [&]() -> const Interface& {
+			if (!from_interface_known) {
+				from_interface = next_hop_interface(packet.destination_hash());
+				from_interface_known = true;
+			}
+			return from_interface;
+		};
+
 #if defined(INTERFACES_SET)
-		for (const Interface& interface : _interfaces) {
+		for (const Interface& interface : _instance->_interfaces) {
 #elif defined(INTERFACES_LIST)
-		for (Interface& interface : _interfaces) {
+		for (Interface& interface : _instance->_interfaces) {
 #elif defined(INTERFACES_MAP)
-		for (auto& [hash, interface] : _interfaces) {
+		for (auto& [hash, interface] : _instance->_interfaces) {
 #endif
 			TRACE("Transport::outbound: Checking interface " + interface.toString());
 			if (interface.OUT()) {
 				bool should_transmit = true;
 
-				if (packet.destination().type() == Type::Destination::LINK) {
-					if (!packet.destination_link()) throw std::invalid_argument("Packet is not associated with a Link");
-					if (packet.destination_link().status() == Type::Link::CLOSED) {
-						TRACE("Transport::outbound: Pscket destination is link-closed, not transmitting");
-						should_transmit = false;
-					}
-					// CBA Bug? Destination has no member attached_interface
-					//z if (interface != packet.destination().attached_interface()) {
-					//z 	should_transmit = false;
-					//z }
+				if (link_closed) {
+					TRACE("Transport::outbound: Pscket destination is link-closed, not transmitting");
+					should_transmit = false;
 				}
 				
 				if (packet.attached_interface() && interface != packet.attached_interface()) {
@@ -923,7 +1193,12 @@ static bool is_backbone_interface(const Interface& iface) {
 					should_transmit = false;
 				}
 
-				if (packet.packet_type() == Type::Packet::ANNOUNCE) {
+				if (should_transmit && announce && interface.filter_announces() && !passes_announce_filter()) {
+					TRACE("Blocking announce for " + packet.destination_hash().toHex() + " on " + interface.toString() + " due to announce filter");
+					should_transmit = false;
+				}
+
+				if (announce) {
 					if (!packet.attached_interface()) {
 						TRACE("Transport::outbound: Packet has no attached interface");
 						if (interface.mode() == Type::Interface::MODE_ACCESS_POINT) {
@@ -931,31 +1206,12 @@ static bool is_backbone_interface(const Interface& iface) {
 							should_transmit = false;
 						}
 						else if (interface.mode() == Type::Interface::MODE_ROAMING) {
-							//local_destination = next((d for d in Transport.destinations if d.hash == packet.destination_hash), None)
-							//Destination local_destination({Type::NONE});
-#if defined(DESTINATIONS_SET)
-							bool found_local = false;
-							for (auto& destination : _destinations) {
-								if (destination.hash() == packet.destination_hash()) {
-									//local_destination = destination;
-									found_local = true;
-									break;
-								}
-							}
                             //if local_destination != None:
-							//if (local_destination) {
-							if (found_local) {
-#elif defined(DESTINATIONS_MAP)
-							auto iter = _destinations.find(packet.destination_hash());
-							//if (iter != _destinations.end()) {
-							//	local_destination = (*iter).second;
-							//}
-							if (iter != _destinations.end()) {
-#endif
+							if (is_local_destination()) {
 								TRACE("Allowing announce broadcast on roaming-mode interface from instance-local destination");
 							}
 							else {
-								const Interface& from_interface = next_hop_interface(packet.destination_hash());
+								const Interface& from_interface = next_hop();
 								//if from_interface == None or not hasattr(from_interface, "mode"):
 								if (!from_interface || from_interface.mode() == Type::Interface::MODE_NONE) {
 									should_transmit = false;
@@ -979,32 +1235,12 @@ static bool is_backbone_interface(const Interface& iface) {
 							}
 						}
 						else if (interface.mode() == Type::Interface::MODE_BOUNDARY) {
-							//local_destination = next((d for d in Transport.destinations if d.hash == packet.destination_hash), None)
-							// next and filter pattern?
-							// next(iterable, default)
-							// list comprehension: [x for x in xyz if x in a]
-							// CBA TODO confirm that above pattern just selects the first matching destination
-#if defined(DESTINATIONS_SET)
-							//Destination local_destination({Type::Destination::NONE});
-							bool found_local = false;
-							for (auto& destination : _destinations) {
-								if (destination.hash() == packet.destination_hash()) {
-									//local_destination = destination;
-									found_local = true;
-									break;
-								}
-							}
                             //if local_destination != None:
-							//if (local_destination) {
-							if (found_local) {
-#elif defined(DESTINATIONS_MAP)
-							auto iter = _destinations.find(packet.destination_hash());
-							if (iter != _destinations.end()) {
-#endif
+							if (is_local_destination()) {
 								TRACE("Allowing announce broadcast on boundary-mode interface from instance-local destination");
 							}
 							else {
-								const Interface& from_interface = next_hop_interface(packet.destination_hash());
+								const Interface& from_interface = next_hop();
 								if (!from_interface || from_interface.mode() == Type::Interface::MODE_NONE) {
 									should_transmit = false;
 									if (!from_interface) {
@@ -1040,81 +1276,27 @@ static bool is_backbone_interface(const Interface& iface) {
 										interface.announce_queue = []
 */
 
+								// CBA Announces already waiting go first, and once the interface's announce
+								// bandwidth (token bucket) is used up further announces wait in its queue,
+								// replacing any older emission queued for the same destination.
 								bool queued_announces = (interface.announce_queue().size() > 0);
-								if (!queued_announces && outbound_time > interface.announce_allowed_at()) {
-									uint16_t wait_time = 0;
-									if (interface.bitrate() > 0 && interface.announce_cap() > 0) {
-										uint16_t tx_time = (packet.raw().size() * 8) / interface.bitrate();
-										wait_time = (tx_time / interface.announce_cap());
-									}
 #if defined(INTERFACES_SET)
-									const_cast<Interface&>(interface).announce_allowed_at(outbound_time + wait_time);
+								Interface& capped_interface = const_cast<Interface&>(interface);
 #else
-									interface.announce_allowed_at(outbound_time + wait_time);
+								Interface& capped_interface = interface;
 #endif
-								}
-								else {
+								// CBA and so do announces for an interface that has no room for them now
+								if (queued_announces || !capped_interface.can_send(raw) || !capped_interface.announce_spend(raw.size())) {
 									should_transmit = false;
-									if (interface.announce_queue().size() < Type::Reticulum::MAX_QUEUED_ANNOUNCES) {
-										bool should_queue = true;
-										for (auto& entry : interface.announce_queue()) {
-											if (entry._destination == packet.destination_hash()) {
-												uint64_t emission_timestamp = announce_emitted(packet);
-												should_queue = false;
-												if (emission_timestamp > entry._emitted) {
-													entry._time = outbound_time;
-													entry._hops = packet.hops();
-													entry._emitted = emission_timestamp;
-													entry._raw = packet.raw();
-												}
-												break;
-											}
-										}
-										if (should_queue) {
-											RNS::AnnounceEntry entry(
-												packet.destination_hash(),
-												outbound_time,
-												packet.hops(),
-												announce_emitted(packet),
-												packet.raw()
-											);
-
-											queued_announces = (interface.announce_queue().size() > 0);
-#if defined(INTERFACES_SET)
-											const_cast<Interface&>(interface).add_announce(entry);
-#else
-											// CBA ACCUMULATES
-											interface.add_announce(entry);
-#endif
-
-											if (!queued_announces) {
-												double wait_time = std::max(interface.announce_allowed_at() - OS::time(), (double)0);
-
-												// CBA TODO THREAD?
-												//z timer = threading.Timer(wait_time, interface.process_announce_queue)
-												//z timer.start()
-
-												if (wait_time < 1000) {
-													TRACE("Added announce to queue (height " + std::to_string(interface.announce_queue().size()) + ") on " + interface.toString() + " for processing in " + std::to_string((int)wait_time) + " ms");
-												}
-												else {
-													TRACE("Added announce to queue (height " + std::to_string(interface.announce_queue().size()) + ") on " + interface.toString() + " for processing in " + std::to_string(OS::round(wait_time/1000,1)) + " s");
-												}
-											}
-											else {
-												double wait_time = std::max(interface.announce_allowed_at() - OS::time(), (double)0);
-												if (wait_time < 1000) {
-													TRACE("Added announce to queue (height " + std::to_string(interface.announce_queue().size()) + ") on " + interface.toString() + " for processing in " + std::to_string((int)wait_time) + " ms");
-												}
-												else {
-													TRACE("Added announce to queue (height " + std::to_string(interface.announce_queue().size()) + ") on " + interface.toString() + " for processing in " + std::to_string(OS::round(wait_time/1000,1)) + " s");
-												}
-											}
-										}
-									}
-									else {
-										//p pass
-									}
+									capped_interface.queue_announce(
+										packet.destination_hash(),
+										outbound_time,
+										packet.hops(),
+										announce_emitted(packet),
+										raw
+									);
+									double wait_time = std::max(interface.announce_allowed_at() - OS::time(), (double)0);
+									TRACE("Added announce to queue (height " + std::to_string(interface.announce_queue().size()) + ") on " + interface.toString() + " for processing in " + std::to_string(OS::round(wait_time,1)) + " s");
 								}
 							}
 							else {
@@ -1126,12 +1308,12 @@ static bool is_backbone_interface(const Interface& iface) {
 						
 				if (should_transmit) {
 					TRACE("Transport::outbound: Packet transmission allowed");
-					if (packet.packet_type() == Type::Packet::ANNOUNCE) {
+					if (announce) {
 						DEBUG("DIAG: TX-OUT announce dest=" + packet.destination_hash().toHex().substr(0,8) + " on " + interface.toString());
 					}
 					if (!stored_hash) {
 						// CBA ACCUMULATES
-						_packet_hashlist.insert(packet.packet_hash());
+						_instance->_packet_hashlist.insert(packet.packet_hash());
 						stored_hash = true;
 					}
 
@@ -1143,15 +1325,16 @@ static bool is_backbone_interface(const Interface& iface) {
 					// thread.start()
 
 #if defined(INTERFACES_SET)
-					transmit(const_cast<Interface&>(interface), packet.raw());
+					if (transmit(const_cast<Interface&>(interface), raw)) {
 #else
-					transmit(interface, packet.raw());
+					if (transmit(interface, raw)) {
 #endif
-					sent = true;
+						sent = true;
+					}
 				}
 				else {
 					TRACE("Transport::outbound: Packet transmission refused");
-					if (packet.packet_type() == Type::Packet::ANNOUNCE) {
+					if (announce) {
 						DEBUG("DIAG: TX-REFUSED announce dest=" + packet.destination_hash().toHex().substr(0,8) + " refused on " + interface.toString());
 					}
 				}
@@ -1177,13 +1360,15 @@ static bool is_backbone_interface(const Interface& iface) {
 			PacketReceipt receipt(packet);
 			packet.receipt(receipt);
 			// CBA ACCUMULATES
-			_receipts.push_back(receipt);
+			// CBA A resent packet's new receipt replaces the old one, which still times out
+			_instance->_receipts.insert_or_assign(receipt.truncated_hash(), receipt);
+			schedule_receipt(receipt);
 		}
 		
 		cache_packet(packet);
 	}
 
-	_jobs_locked = false;
+	_instance->_jobs_locked = false;
 	return sent;
 }
 
@@ -1242,7 +1427,7 @@ static bool is_backbone_interface(const Interface& iface) {
 		}
 	}
 
-	if (_packet_hashlist.find(packet.packet_hash()) == _packet_hashlist.end()) {
+	if (!_instance->_packet_hashlist.contains(packet.packet_hash())) {
 		TRACE("Transport::packet_filter: packet not previously seen");
 		return true;
 	}
@@ -1264,16 +1449,362 @@ static bool is_backbone_interface(const Interface& iface) {
 	return false;
 }
 
+// CBA Drops, from the raw frame and before a Packet is built from it, what packet_filter() and
+// the BOUNDARY firewall in process_inbound() would drop after a full unpack: frames shorter
+// than their header, PLAIN and GROUP packets out of scope, duplicates and backbone traffic
+// for destinations nobody here has mentioned. Header fields are read at their fixed offsets
+// and looked up with the hashes still inside the frame. Where the duplicate check applies
+// the packet hash is computed into packet_hash and hashed set, so that it is not computed
+// again downstream. Returns false if the frame should be dropped, counting the reason.
+/*static*/ bool Transport::prefilter(const Bytes& raw, const Interface& interface, uint8_t* packet_hash, bool& hashed) {
+	static const size_t DST_LEN = Type::Reticulum::DESTINATION_LENGTH;
+	hashed = false;
+	if (raw.size() < Type::Reticulum::HEADER_MINSIZE) {
+		++_instance->_prefilter_rejects[PREFILTER_MALFORMED];
+		return false;
+	}
+	const uint8_t* frame = raw.data();
+	uint8_t flags = frame[0];
+	uint8_t header_type = (flags & 0b01000000) >> 6;
+	uint8_t destination_type = (flags & 0b00001100) >> 2;
+	uint8_t packet_type = flags & 0b00000011;
+	uint8_t hashable_flags = flags & 0b00001111;
+	if (header_type == Type::Packet::HEADER_2 && raw.size() < Type::Reticulum::HEADER_MAXSIZE) {
+		++_instance->_prefilter_rejects[PREFILTER_MALFORMED];
+		return false;
+	}
+	size_t destination_offset = (header_type == Type::Packet::HEADER_2) ? DST_LEN + 2 : 2;
+	const uint8_t* destination_hash = frame + destination_offset;
+	uint8_t context = frame[destination_offset + DST_LEN];
+
+#ifdef BOUNDARY_MODE
+	// Same rules as the firewall in process_inbound()
+	if (is_backbone_interface(interface)) {
+		bool allowed = _instance->_boundary_whitelist.allowed(destination_hash, DST_LEN)
+			|| _instance->_reverse_table.find(destination_hash, DST_LEN) != _instance->_reverse_table.end()
+			|| _instance->_link_table.find(destination_hash, DST_LEN) != _instance->_link_table.end()
+			|| (header_type == Type::Packet::HEADER_2 && memcmp(frame + 2, _instance->_identity.hash().data(), DST_LEN) == 0);
+		if (!allowed) {
+			++_instance->_prefilter_rejects[PREFILTER_BLOCKED];
+			return false;
+		}
+	}
+#endif
+
+	// Same rules, in the same order, as packet_filter()
+	if (context == Type::Packet::KEEPALIVE || context == Type::Packet::RESOURCE_REQ || context == Type::Packet::RESOURCE_PRF || context == Type::Packet::RESOURCE || context == Type::Packet::CACHE_REQUEST || context == Type::Packet::CHANNEL) {
+		return true;
+	}
+	if (destination_type == Type::Destination::PLAIN || destination_type == Type::Destination::GROUP) {
+		// hops as process_inbound() will have counted them
+		uint8_t hops = frame[1] + 1;
+		if (_instance->_local_client_interfaces.size() > 0) {
+			if (is_local_client_interface(interface)) {
+				hops--;
+			}
+		}
+		else if (interface_to_shared_instance(interface)) {
+			hops--;
+		}
+		if (packet_type == Type::Packet::ANNOUNCE || hops > 1) {
+			++_instance->_prefilter_rejects[PREFILTER_SCOPE];
+			return false;
+		}
+		return true;
+	}
+	if (packet_type == Type::Packet::ANNOUNCE && destination_type == Type::Destination::SINGLE) {
+		return true;
+	}
+	Cryptography::sha256(&hashable_flags, 1, frame + destination_offset, raw.size() - destination_offset, packet_hash);
+	hashed = true;
+	if (_instance->_packet_hashlist.contains(packet_hash)) {
+		++_instance->_prefilter_rejects[PREFILTER_DUPLICATE];
+		return false;
+	}
+	return true;
+}
+
+// CBA Forwarding fast path working on the raw frame, for the two cases that make up most of a
+// transport node's traffic and need no more than a table lookup:
+//
+//   - link DATA and PROOF packets (HEADER_1) for links in the link table
+//   - SINGLE destination DATA packets (HEADER_2) for which we are the designated next hop
+//
+// Header fields are read at their fixed offsets, the next hop is looked up with the
+// destination hash still inside the frame, and the forwarded frame is a single copy with
+// the hop count (and transport headers) rewritten. The packet hash is computed for the
+// duplicate filter without assembling the hashable part. Anything else, including packets
+// with a local client or shared instance on either side, returns false and takes the full
+// inbound() path. Returns true if the packet was forwarded or dropped as a duplicate.
+/*static*/ bool Transport::forward_fast(const Bytes& raw, const Interface& interface, const uint8_t* known_hash) {
+	static const size_t DST_LEN = Type::Reticulum::DESTINATION_LENGTH;
+	if (!Reticulum::transport_enabled() || _instance->_callbacks._filter_packet || !interface) {
+		return false;
+	}
+	if (raw.size() < Type::Reticulum::HEADER_MINSIZE) {
+		return false;
+	}
+	const uint8_t* frame = raw.data();
+	uint8_t flags = frame[0];
+	uint8_t header_type = (flags & 0b01000000) >> 6;
+	uint8_t destination_type = (flags & 0b00001100) >> 2;
+	uint8_t packet_type = flags & 0b00000011;
+	uint8_t hops = frame[1] + 1;
+	uint8_t hashable_flags = flags & 0b00001111;
+	if (packet_type != Type::Packet::DATA && packet_type != Type::Packet::PROOF) {
+		return false;
+	}
+	if (_instance->_local_client_interfaces.find(interface) != _instance->_local_client_interfaces.end() || is_local_client_interface(interface) || interface_to_shared_instance(interface)) {
+		return false;
+	}
+
+	if (header_type == Type::Packet::HEADER_1 && destination_type == Type::Destination::LINK) {
+		uint8_t context = frame[DST_LEN + 2];
+		if (context == Type::Packet::LRPROOF || context == Type::Packet::CACHE_REQUEST) {
+			return false;
+		}
+		auto link_iter = _instance->_link_table.find(frame + 2, DST_LEN);
+		if (link_iter == _instance->_link_table.end()) {
+			return false;
+		}
+		LinkEntry& link_entry = (*link_iter).second;
+		if (_instance->_local_client_interfaces.find(link_entry._receiving_interface) != _instance->_local_client_interfaces.end() || _instance->_local_client_interfaces.find(link_entry._outbound_interface) != _instance->_local_client_interfaces.end()) {
+			return false;
+		}
+
+		// Same duplicate rules as packet_filter()
+		Bytes packet_hash = known_hash ? Bytes(known_hash, Type::Reticulum::HASHLENGTH/8) : Cryptography::sha256(&hashable_flags, 1, frame + 2, raw.size() - 2);
+		bool filtered = !(context == Type::Packet::KEEPALIVE || context == Type::Packet::RESOURCE_REQ || context == Type::Packet::RESOURCE_PRF || context == Type::Packet::RESOURCE || context == Type::Packet::CHANNEL);
+		if (filtered && _instance->_packet_hashlist.contains(packet_hash)) {
+			TRACE("Transport::forward_fast: dropped duplicate link packet");
+			return true;
+		}
+
+		// Same direction and hop count checks as link transport in inbound()
+		Interface outbound_interface({Type::NONE});
+		if (link_entry._outbound_interface == link_entry._receiving_interface) {
+			if (hops == link_entry._remaining_hops || hops == link_entry._hops) {
+				outbound_interface = link_entry._outbound_interface;
+			}
+		}
+		else if (interface == link_entry._outbound_interface) {
+			if (hops == link_entry._remaining_hops) {
+				outbound_interface = link_entry._receiving_interface;
+			}
+		}
+		else if (interface == link_entry._receiving_interface) {
+			if (hops == link_entry._hops) {
+				outbound_interface = link_entry._outbound_interface;
+			}
+		}
+		if (!outbound_interface) {
+			// let the full path handle and log the mismatch
+			return false;
+		}
+
+		_instance->_packet_hashlist.insert(packet_hash);
+		Bytes new_raw(raw.size());
+		new_raw << flags;
+		new_raw << hops;
+		new_raw.append(frame + 2, raw.size() - 2);
+		TRACE("Transport::forward_fast: forwarding link packet to " + outbound_interface.toString());
+		transmit(outbound_interface, new_raw);
+		link_entry._timestamp = OS::seconds();
+		++_instance->_packets_fast_forwarded;
+		return true;
+	}
+
+	if (header_type == Type::Packet::HEADER_2 && destination_type == Type::Destination::SINGLE && packet_type == Type::Packet::DATA) {
+		if (raw.size() < Type::Reticulum::HEADER_MAXSIZE) {
+			return false;
+		}
+		if (memcmp(frame + 2, _instance->_identity.hash().data(), DST_LEN) != 0) {
+			return false;
+		}
+		uint8_t context = frame[2*DST_LEN + 2];
+		if (context == Type::Packet::CACHE_REQUEST) {
+			return false;
+		}
+		const uint8_t* destination_hash = frame + DST_LEN + 2;
+		if (_instance->_link_table.find(destination_hash, DST_LEN) != _instance->_link_table.end() || _instance->_control_hashes.count(TruncatedHash(destination_hash)) > 0) {
+			return false;
+		}
+		auto destination_iter = _instance->_destination_table.find(destination_hash, DST_LEN);
+		if (destination_iter == _instance->_destination_table.end()) {
+			return false;
+		}
+		DestinationEntry& destination_entry = (*destination_iter).second;
+		uint8_t remaining_hops = destination_entry._hops;
+		if (remaining_hops == 0 || destination_entry._received_from.size() != DST_LEN) {
+			return false;
+		}
+		Interface outbound_interface = destination_entry.receiving_interface();
+		if (!outbound_interface || _instance->_local_client_interfaces.find(outbound_interface) != _instance->_local_client_interfaces.end()) {
+			return false;
+		}
+#ifdef BOUNDARY_MODE
+		// never route backbone back to backbone, leave that case to the full path
+		if (is_backbone_interface(interface) && is_backbone_interface(outbound_interface)) {
+			return false;
+		}
+#endif
+
+		Bytes packet_hash = known_hash ? Bytes(known_hash, Type::Reticulum::HASHLENGTH/8) : Cryptography::sha256(&hashable_flags, 1, frame + DST_LEN + 2, raw.size() - (DST_LEN + 2));
+		if (_instance->_packet_hashlist.contains(packet_hash)) {
+			TRACE("Transport::forward_fast: dropped duplicate transport packet");
+			return true;
+		}
+		_instance->_packet_hashlist.insert(packet_hash);
+		Bytes truncated_hash = packet_hash.left(Type::Identity::TRUNCATED_HASHLENGTH/8);
+
+#ifdef BOUNDARY_MODE
+		// Transitive whitelist, as in inbound()
+		_instance->_boundary_whitelist.insert(destination_hash, DST_LEN, Utilities::Whitelist::CLASS_MENTIONED);
+		_instance->_boundary_whitelist.insert(frame + 2, DST_LEN, Utilities::Whitelist::CLASS_MENTIONED);
+		_instance->_boundary_whitelist.insert(truncated_hash, Utilities::Whitelist::CLASS_MENTIONED);
+#endif
+
+		Bytes new_raw(raw.size());
+		if (remaining_hops > 1) {
+			// Rewrite hops and transport id
+			new_raw << flags;
+			new_raw << hops;
+			new_raw << destination_entry._received_from;
+		}
+		else {
+			// Last hop, strip the transport headers
+			new_raw << (uint8_t)((Type::Packet::HEADER_1) << 6 | (Type::Transport::BROADCAST) << 4 | hashable_flags);
+			new_raw << hops;
+		}
+		new_raw.append(frame + DST_LEN + 2, raw.size() - (DST_LEN + 2));
+
+		{
+			RNS_ALLOC_SCOPE(TAG_PATH_TABLE);
+			ReverseEntry reverse_entry(
+				interface,
+				outbound_interface,
+				OS::seconds()
+			);
+			// CBA ACCUMULATES
+			_instance->_reverse_table.insert({truncated_hash, reverse_entry});
+			_instance->_reverse_timers.schedule(truncated_hash, reverse_deadline(reverse_entry));
+		}
+		TRACE("Transport::forward_fast: forwarding transport packet to " + outbound_interface.toString());
+#if defined(INTERFACES_SET)
+		transmit(const_cast<Interface&>(outbound_interface), new_raw);
+#else
+		transmit(outbound_interface, new_raw);
+#endif
+		touch_path((*destination_iter).first, destination_entry);
+		++_instance->_packets_fast_forwarded;
+		return true;
+	}
+
+	return false;
+}
+
+/*static*/ bool Transport::queue_announce_validation(const Bytes& raw, const Interface& interface) {
+	// Only announces from registered interfaces are staged, anything else is handled inline
+	if ((raw[0] & 0x03) != Type::Packet::ANNOUNCE || !interface || interface.id() == 0) {
+		return false;
+	}
+	++_instance->_announces_queued;
+	if (_instance->_announce_validation_queue.size() < Type::Transport::ANNOUNCE_VALIDATION_MAXSIZE) {
+		_instance->_announce_validation_queue.emplace_back(raw, interface.id());
+		return true;
+	}
+
+	// Queue is full, shed whichever announce is least useful: ones from rate limited
+	// destinations first, then the furthest away. On a tie the new announce is dropped.
+	uint32_t now = OS::seconds();
+	uint16_t shed_score = announce_shed_score(raw, now);
+	size_t shed_index = _instance->_announce_validation_queue.size();
+	for (size_t index = 0; index < _instance->_announce_validation_queue.size(); index++) {
+		uint16_t score = announce_shed_score(_instance->_announce_validation_queue[index]._raw, now);
+		if (score > shed_score) {
+			shed_score = score;
+			shed_index = index;
+		}
+	}
+	++_instance->_announces_shed;
+	if (shed_index < _instance->_announce_validation_queue.size()) {
+		_instance->_announce_validation_queue.erase(_instance->_announce_validation_queue.begin() + shed_index);
+		_instance->_announce_validation_queue.emplace_back(raw, interface.id());
+	}
+	TRACE("Transport::inbound: announce validation queue full, shed an announce");
+	return true;
+}
+
+// Drops queued announces, least useful first as when the queue overflows
+/*static*/ size_t Transport::shed_announce_queue(size_t keep) {
+	auto& queue = _instance->_announce_validation_queue;
+	uint32_t now = OS::seconds();
+	size_t count = 0;
+	while (queue.size() > keep) {
+		size_t shed_index = 0;
+		uint16_t shed_score = 0;
+		for (size_t index = 0; index < queue.size(); index++) {
+			uint16_t score = announce_shed_score(queue[index]._raw, now);
+			if (score >= shed_score) {
+				shed_score = score;
+				shed_index = index;
+			}
+		}
+		queue.erase(queue.begin() + shed_index);
+		++_instance->_announces_shed;
+		++count;
+	}
+	return count;
+}
+
+/*static*/ size_t Transport::shed_held_announces() {
+	size_t count = _instance->_held_announces.size();
+	_instance->_held_announces.clear();
+	return count;
+}
+
+// Frames already in the spill file leave RAM, the rest are written there first
+/*static*/ size_t Transport::shed_packet_cache() {
+	return _instance->_packet_cache->shed();
+}
+
+/*static*/ uint16_t Transport::announce_shed_score(const Bytes& raw, uint32_t now) {
+	const uint8_t hash_length = Type::Reticulum::DESTINATION_LENGTH;
+	size_t offset = ((raw[0] & 0b01000000) ? 2 + hash_length : 2);
+	uint16_t score = raw[1];
+	if (raw.size() >= offset + hash_length) {
+		// const lookup so that shedding doesn't refresh the entry's LRU stamp
+		const auto& rate_table = _instance->_announce_rate_table;
+		auto iter = rate_table.find(raw.data() + offset, hash_length);
+		if (iter != rate_table.end() && now < (*iter).second._blocked_until) {
+			score += 0x100;
+		}
+	}
+	return score;
+}
+
+/*static*/ void Transport::process_announce_validation() {
+	for (uint8_t n = 0; n < Type::Transport::ANNOUNCE_VALIDATIONS_PER_LOOP && !_instance->_announce_validation_queue.empty(); n++) {
+		QueuedAnnounce queued = _instance->_announce_validation_queue.front();
+		_instance->_announce_validation_queue.erase(_instance->_announce_validation_queue.begin());
+		// Interface may have been deregistered while the announce was waiting
+		Interface interface = find_interface_from_id(queued._interface_id);
+		if (interface) {
+			process_inbound(queued._raw, interface);
+		}
+	}
+}
+
 /*static*/ void Transport::inbound(const Bytes& raw_in, const Interface& interface /*= {Type::NONE}*/) {
 	TRACEF("Transport::inbound: received %d bytes", raw_in.size());
-	++_packets_received;
+	++_instance->_packets_received;
+	// in-flight packet allocations, the path/announce/link table scopes below take precedence
+	RNS_ALLOC_SCOPE(TAG_PACKETS);
 
-	// Heap telemetry: snapshot at entry
-	size_t _heap_at_entry = OS::heap_available();
 	// CBA
-	if (_callbacks._receive_packet) {
+	if (_instance->_callbacks._receive_packet) {
 		try {
-			_callbacks._receive_packet(raw_in, interface);
+			_instance->_callbacks._receive_packet(raw_in, interface);
 		}
 		catch (std::exception& e) {
 			DEBUG("Error while executing receive packet callback. The contained exception was: " + std::string(e.what()));
@@ -1290,61 +1821,27 @@ static bool is_backbone_interface(const Interface& iface) {
 			// Check that IFAC flag is set
 			if ((raw[0] & 0x80) == 0x80) {
 				if (raw.size() > (size_t)(2 + interface.ifac_size())) {
-					// Extract IFAC
-					Bytes ifac = raw.mid(2, interface.ifac_size());
-
-					// Generate mask
-					Bytes mask = Cryptography::hkdf(
-						raw.size(),
-						ifac,
-						interface.ifac_key()
-					);
-
-					// Unmask payload
-					Bytes unmasked_raw;
-					for (size_t i = 0; i < raw.size(); i++) {
-						if (i <= 1 || i > (size_t)(interface.ifac_size() + 1)) {
-							// Unmask header bytes and payload
-							unmasked_raw.append((uint8_t)(raw[i] ^ mask[i]));
-						}
-						else {
-							// Don't unmask IFAC itself
-							unmasked_raw.append(raw[i]);
-						}
-					}
-					raw = unmasked_raw;
-
-					// Unset IFAC flag
-					uint8_t new_header0 = raw[0] & 0x7F;
-					uint8_t new_header1 = raw[1];
-
-					// Re-assemble packet without IFAC bytes
+					// Unmask, strip the IFAC and check it against our own signature
 					Bytes new_raw;
-					new_raw.append(new_header0);
-					new_raw.append(new_header1);
-					new_raw.append(raw.mid(2 + interface.ifac_size()));
-
-					// Calculate expected IFAC
-					Bytes expected_signature = interface.ifac_id().sign(new_raw);
-					Bytes expected_ifac = expected_signature.right(interface.ifac_size());
-
-					// Check it
-					if (ifac == expected_ifac) {
+					if (interface.ifac().remove(raw, new_raw)) {
 						raw = new_raw;
 					}
 					else {
 						TRACE("Transport::inbound: IFAC authentication failed, dropping packet");
+						++_instance->_prefilter_rejects[PREFILTER_IFAC];
 						return;
 					}
 				}
 				else {
 					TRACE("Transport::inbound: packet too short for IFAC, dropping");
+					++_instance->_prefilter_rejects[PREFILTER_IFAC];
 					return;
 				}
 			}
 			else {
 				// If the IFAC flag is not set, but should be, drop the packet
 				TRACE("Transport::inbound: IFAC required but flag not set, dropping packet");
+				++_instance->_prefilter_rejects[PREFILTER_IFAC];
 				return;
 			}
 		}
@@ -1354,28 +1851,54 @@ static bool is_backbone_interface(const Interface& iface) {
 			if ((raw[0] & 0x80) == 0x80) {
 				// If the flag is set, drop the packet
 				TRACE("Transport::inbound: IFAC flag set but interface has no IFAC, dropping packet");
+				++_instance->_prefilter_rejects[PREFILTER_IFAC];
 				return;
 			}
 		}
 	}
 	else {
+		++_instance->_prefilter_rejects[PREFILTER_MALFORMED];
+		return;
+	}
+
+	// CBA Frames the filter and firewall would drop go before anything is built from them
+	uint8_t packet_hash[Type::Reticulum::HASHLENGTH/8];
+	bool hashed = false;
+	if (!prefilter(raw, interface, packet_hash, hashed)) {
 		return;
 	}
 
-	while (_jobs_running) {
+	// CBA Announces are staged and validated later from loop()
+	if (queue_announce_validation(raw, interface)) {
+		return;
+	}
+
+	process_inbound(raw, interface, hashed ? packet_hash : nullptr);
+}
+
+/*static*/ void Transport::process_inbound(const Bytes& raw, const Interface& interface, const uint8_t* known_hash /*= nullptr*/) {
+	// Heap telemetry: snapshot at entry, only taken when it can be logged
+	size_t _heap_at_entry = RNS_LOG_ENABLED(LOG_VERBOSE) ? OS::heap_available() : 0;
+
+	while (_instance->_jobs_running) {
 		TRACE("Transport::inbound: sleeping...");
 		OS::sleep(0.0005);
 	}
 
-	if (!_identity) {
+	if (!_instance->_identity) {
 		WARNING("Transport::inbound: No identity!");
 		return;
 	}
 
-	_jobs_locked = true;
+	_instance->_jobs_locked = true;
+
+	if (forward_fast(raw, interface, known_hash)) {
+		_instance->_jobs_locked = false;
+		return;
+	}
 
 	Packet packet(RNS::Destination(RNS::Type::NONE), raw);
-	if (!packet.unpack()) {
+	if (!packet.unpack(known_hash)) {
 		WARNING("Transport::inbound: Packet unpack failed!");
 		return;
 	}
@@ -1411,7 +1934,7 @@ static bool is_backbone_interface(const Interface& iface) {
 	}
 */
 
-	if (_local_client_interfaces.size() > 0) {
+	if (_instance->_local_client_interfaces.size() > 0) {
 		if (is_local_client_interface(interface)) {
 			packet.hops(packet.hops() - 1);
 		}
@@ -1423,9 +1946,9 @@ static bool is_backbone_interface(const Interface& iface) {
 	//if (packet_filter(packet)) {
 	// CBA
 	bool accept = true;
-	if (_callbacks._filter_packet) {
+	if (_instance->_callbacks._filter_packet) {
 		try {
-			accept = _callbacks._filter_packet(packet);
+			accept = _instance->_callbacks._filter_packet(packet);
 		}
 		catch (std::exception& e) {
 			DEBUG("Error while executing filter packet callback. The contained exception was: " + std::string(e.what()));
@@ -1458,35 +1981,24 @@ static bool is_backbone_interface(const Interface& iface) {
 			if (is_backbone) {
 				// === BACKBONE PACKET: gate against all whitelists ===
 				bool allowed = false;
-				// Whitelist 1: destination is a local device
-				if (_boundary_local_addresses.find(packet.destination_hash()) != _boundary_local_addresses.end()) {
-					allowed = true;
-				}
-				// Whitelist 2: destination was mentioned by a local device
-				else if (_boundary_mentioned_addresses.find(packet.destination_hash()) != _boundary_mentioned_addresses.end()) {
+				// Whitelist: a local device, mentioned by a local device, or one of our own
+				// control and registered destinations
+				if (_instance->_boundary_whitelist.allowed(packet.destination_hash())) {
 					allowed = true;
 				}
 				// Return traffic: proofs routed via reverse_table
-				else if (_reverse_table.find(packet.destination_hash()) != _reverse_table.end()) {
+				else if (_instance->_reverse_table.find(packet.destination_hash()) != _instance->_reverse_table.end()) {
 					allowed = true;
 				}
 				// Return traffic: link proofs and link data via link_table
-				else if (_link_table.find(packet.destination_hash()) != _link_table.end()) {
-					allowed = true;
-				}
-				// Our own control destinations (path requests, tunnel synthesize)
-				else if (_control_hashes.find(packet.destination_hash()) != _control_hashes.end()) {
-					allowed = true;
-				}
-				// Our own registered destinations
-				else if (_destinations.find(packet.destination_hash()) != _destinations.end()) {
+				else if (_instance->_link_table.find(packet.destination_hash()) != _instance->_link_table.end()) {
 					allowed = true;
 				}
 				// HEADER_2 packet addressed to us as transport node — the
 				// sending node routed this to us so we must accept it even
 				// if we haven't seen this specific destination before
 				else if (packet.header_type() == Type::Packet::HEADER_2
-				         && packet.transport_id() == _identity.hash()) {
+				         && packet.transport_id() == _instance->_identity.hash()) {
 					allowed = true;
 				}
 				if (!allowed) {
@@ -1497,14 +2009,14 @@ static bool is_backbone_interface(const Interface& iface) {
 				// Extract ALL identifiers from this allowed backbone packet
 				// so that future related traffic (proofs, link data, return
 				// packets) will also pass through the filter.
-				_boundary_mentioned_addresses.insert(packet.destination_hash());
+				_instance->_boundary_whitelist.insert(packet.destination_hash(), Utilities::Whitelist::CLASS_MENTIONED);
 				if (packet.header_type() == Type::Packet::HEADER_2 && packet.transport_id()) {
-					_boundary_mentioned_addresses.insert(packet.transport_id());
+					_instance->_boundary_whitelist.insert(packet.transport_id(), Utilities::Whitelist::CLASS_MENTIONED);
 				}
 				if (packet.packet_type() == Type::Packet::LINKREQUEST) {
-					_boundary_mentioned_addresses.insert(Link::link_id_from_lr_packet(packet));
+					_instance->_boundary_whitelist.insert(Link::link_id_from_lr_packet(packet), Utilities::Whitelist::CLASS_MENTIONED);
 				}
-				_boundary_mentioned_addresses.insert(packet.getTruncatedHash());
+				_instance->_boundary_whitelist.insert(packet.getTruncatedHash(), Utilities::Whitelist::CLASS_MENTIONED);
 			}
 			else {
 				// === LOCAL DEVICE PACKET ===
@@ -1513,24 +2025,24 @@ static bool is_backbone_interface(const Interface& iface) {
 				// Every identifier that touches a local interface gets
 				// whitelisted on the backbone — link hashes, announces,
 				// requests, proofs, EVERYTHING.
-				_boundary_mentioned_addresses.insert(packet.destination_hash());
+				_instance->_boundary_whitelist.insert(packet.destination_hash(), Utilities::Whitelist::CLASS_MENTIONED);
 				if (packet.header_type() == Type::Packet::HEADER_2 && packet.transport_id()) {
-					_boundary_mentioned_addresses.insert(packet.transport_id());
+					_instance->_boundary_whitelist.insert(packet.transport_id(), Utilities::Whitelist::CLASS_MENTIONED);
 				}
 				if (packet.packet_type() == Type::Packet::LINKREQUEST) {
-					_boundary_mentioned_addresses.insert(Link::link_id_from_lr_packet(packet));
+					_instance->_boundary_whitelist.insert(Link::link_id_from_lr_packet(packet), Utilities::Whitelist::CLASS_MENTIONED);
 				}
-				_boundary_mentioned_addresses.insert(packet.getTruncatedHash());
+				_instance->_boundary_whitelist.insert(packet.getTruncatedHash(), Utilities::Whitelist::CLASS_MENTIONED);
 			}
 		}
 #endif
 
 		// Heap telemetry: snapshot after boundary filter
-		{
+		if (RNS_LOG_ENABLED(LOG_VERBOSE)) {
 			size_t _heap_after_boundary = OS::heap_available();
 			int _boundary_delta = (int)_heap_after_boundary - (int)_heap_at_entry;
 			if (_boundary_delta < -64) {
-				VERBOSEF("[HEAP-TEL] boundary: %d bytes (bma=%u phl=%u)", _boundary_delta, _boundary_mentioned_addresses.size(), _packet_hashlist.size());
+				VERBOSEF("[HEAP-TEL] boundary: %d bytes (bwl=%u phl=%u)", _boundary_delta, _instance->_boundary_whitelist.size(), _instance->_packet_hashlist.size());
 			}
 		}
 
@@ -1545,7 +2057,7 @@ static bool is_backbone_interface(const Interface& iface) {
 		// or terminates with this instance, but before it would
 		// normally reach us. If the packet is appended to the
 		// filter list at this point, link transport will break.
-		if (_link_table.find(packet.destination_hash()) != _link_table.end()) {
+		if (_instance->_link_table.find(packet.destination_hash()) != _instance->_link_table.end()) {
 			remember_packet_hash = false;
 		}
 
@@ -1558,7 +2070,7 @@ static bool is_backbone_interface(const Interface& iface) {
 
 		if (remember_packet_hash) {
 			// CBA ACCUMULATES
-			_packet_hashlist.insert(packet.packet_hash());
+			_instance->_packet_hashlist.insert(packet.packet_hash());
 		}
 		cache_packet(packet);
 
@@ -1573,7 +2085,7 @@ static bool is_backbone_interface(const Interface& iface) {
 		// Check special conditions for local clients connected
 		// through a shared Reticulum instance
 		//p from_local_client         = (packet.receiving_interface in Transport.local_client_interfaces)
-		bool from_local_client         = (_local_client_interfaces.find(packet.receiving_interface()) != _local_client_interfaces.end());
+		bool from_local_client         = (_instance->_local_client_interfaces.find(packet.receiving_interface()) != _instance->_local_client_interfaces.end());
 		//p for_local_client          = (packet.packet_type != RNS.Packet.ANNOUNCE) and (packet.destination_hash in Transport.destination_table and Transport.destination_table[packet.destination_hash][2] == 0)
 		//p for_local_client_link     = (packet.packet_type != RNS.Packet.ANNOUNCE) and (packet.destination_hash in Transport.link_table and Transport.link_table[packet.destination_hash][4] in Transport.local_client_interfaces)
 		//p for_local_client_link    |= (packet.packet_type != RNS.Packet.ANNOUNCE) and (packet.destination_hash in Transport.link_table and Transport.link_table[packet.destination_hash][2] in Transport.local_client_interfaces)
@@ -1582,22 +2094,22 @@ static bool is_backbone_interface(const Interface& iface) {
 		bool for_local_client = false;
 		bool for_local_client_link = false;
 		if (packet.packet_type() != Type::Packet::ANNOUNCE) {
-			auto destination_iter = _destination_table.find(packet.destination_hash());
-			if (destination_iter != _destination_table.end()) {
+			auto destination_iter = _instance->_destination_table.find(packet.destination_hash());
+			if (destination_iter != _instance->_destination_table.end()) {
 				DestinationEntry destination_entry = (*destination_iter).second;
 			 	if (destination_entry._hops == 0) {
 					// Destined for a local destination
 					for_local_client = true;
 				}
 			}
-			auto link_iter = _link_table.find(packet.destination_hash());
-			if (link_iter != _link_table.end()) {
+			auto link_iter = _instance->_link_table.find(packet.destination_hash());
+			if (link_iter != _instance->_link_table.end()) {
 				LinkEntry link_entry = (*link_iter).second;
-			 	if (_local_client_interfaces.find(link_entry._receiving_interface) != _local_client_interfaces.end()) {
+			 	if (_instance->_local_client_interfaces.find(link_entry._receiving_interface) != _instance->_local_client_interfaces.end()) {
 					// Destined for a local link
 					for_local_client_link = true;
 				}
-			 	if (_local_client_interfaces.find(link_entry._outbound_interface) != _local_client_interfaces.end()) {
+			 	if (_instance->_local_client_interfaces.find(link_entry._outbound_interface) != _instance->_local_client_interfaces.end()) {
 					// Destined for a local link
 					for_local_client_link = true;
 				}
@@ -1607,10 +2119,10 @@ static bool is_backbone_interface(const Interface& iface) {
 		// Determine if packet is proof for local destination???
 		//p proof_for_local_client    = (packet.destination_hash in Transport.reverse_table) and (Transport.reverse_table[packet.destination_hash][0] in Transport.local_client_interfaces)
 		bool proof_for_local_client = false;
-		auto reverse_iter = _reverse_table.find(packet.destination_hash());
-		if (reverse_iter != _reverse_table.end()) {
+		auto reverse_iter = _instance->_reverse_table.find(packet.destination_hash());
+		if (reverse_iter != _instance->_reverse_table.end()) {
 			ReverseEntry reverse_entry = (*reverse_iter).second;
-			if (_local_client_interfaces.find(reverse_entry._receiving_interface) != _local_client_interfaces.end()) {
+			if (_instance->_local_client_interfaces.find(reverse_entry._receiving_interface) != _instance->_local_client_interfaces.end()) {
 				// Proof for local destination???
 				proof_for_local_client = true;
 			}
@@ -1621,17 +2133,17 @@ static bool is_backbone_interface(const Interface& iface) {
 		// never injected into transport.
 
 		// If packet is not destined for a local transport-specific destination
-		if (_control_hashes.find(packet.destination_hash()) == _control_hashes.end()) {
+		if (_instance->_control_hashes.find(packet.destination_hash()) == _instance->_control_hashes.end()) {
 			// If packet is destination type PLAIN and transport type BROADCAST
 			if (packet.destination_type() == Type::Destination::PLAIN && packet.transport_type() == Type::Transport::BROADCAST) {
 				// Send to all interfaces except the one the packet was recieved on
 				if (from_local_client) {
 #if defined(INTERFACES_SET)
-					for (const Interface& interface : _interfaces) {
+					for (const Interface& interface : _instance->_interfaces) {
 #elif defined(INTERFACES_LIST)
-					for (Interface& interface : _interfaces) {
+					for (Interface& interface : _instance->_interfaces) {
 #elif defined(INTERFACES_MAP)
-					for (auto& [hash, interface] : _interfaces) {
+					for (auto& [hash, interface] : _instance->_interfaces) {
 #endif
 						if (interface != packet.receiving_interface()) {
 							TRACE("Transport::inbound: Broadcasting packet on " + interface.toString());
@@ -1646,7 +2158,7 @@ static bool is_backbone_interface(const Interface& iface) {
 				// If the packet was not from a local client, send
 				// it directly to all local clients
 				else {
-					for (const Interface& interface : _local_client_interfaces) {
+					for (const Interface& interface : _instance->_local_client_interfaces) {
 						TRACE("Transport::inbound: Broadcasting packet on " + interface.toString());
 						transmit(const_cast<Interface&>(interface), packet.raw());
 					}
@@ -1673,7 +2185,7 @@ static bool is_backbone_interface(const Interface& iface) {
 			// implementation can handle the packet.
 			if (!packet.transport_id() && for_local_client) {
 				TRACE("Transport::inbound: Regenerating transport id");
-				packet.transport_id(_identity.hash());
+				packet.transport_id(_instance->_identity.hash());
 			}
 
 			// If this is a cache request, and we can fullfill
@@ -1691,10 +2203,10 @@ static bool is_backbone_interface(const Interface& iface) {
 			// accordingly if we are.
 			if (packet.transport_id() && packet.packet_type() != Type::Packet::ANNOUNCE) {
 				TRACE("Transport::inbound: Packet is in transport...");
-				if (packet.transport_id() == _identity.hash()) {
+				if (packet.transport_id() == _instance->_identity.hash()) {
 					TRACE("Transport::inbound: We are designated next-hop");
-					auto destination_iter = _destination_table.find(packet.destination_hash());
-					if (destination_iter != _destination_table.end()) {
+					auto destination_iter = _instance->_destination_table.find(packet.destination_hash());
+					if (destination_iter != _instance->_destination_table.end()) {
 						TRACE("Transport::inbound: Found next-hop path to destination");
 						DestinationEntry& destination_entry = (*destination_iter).second;
 						Bytes next_hop = destination_entry._received_from;
@@ -1706,13 +2218,13 @@ static bool is_backbone_interface(const Interface& iface) {
 						if (remaining_hops > 1) {
 							// Just increase hop count and transmit
 							//new_raw  = packet.raw[0:1]
-							new_raw << packet.raw().left(1);
+							new_raw << packet.raw().view_left(1);
 							//new_raw += struct.pack("!B", packet.hops)
 							new_raw << packet.hops();
 							//new_raw += next_hop
 							new_raw << next_hop;
 							//new_raw += packet.raw[(RNS.Identity.TRUNCATED_HASHLENGTH//8)+2:]
-							new_raw << packet.raw().mid((Type::Identity::TRUNCATED_HASHLENGTH/8)+2);
+							new_raw << packet.raw().view((Type::Identity::TRUNCATED_HASHLENGTH/8)+2);
 						}
 						else if (remaining_hops == 1) {
 							// Strip transport headers and transmit
@@ -1723,16 +2235,16 @@ static bool is_backbone_interface(const Interface& iface) {
 							//new_raw += struct.pack("!B", packet.hops)
 							new_raw << packet.hops();
 							//new_raw += packet.raw[(RNS.Identity.TRUNCATED_HASHLENGTH//8)+2:]
-							new_raw << packet.raw().mid((Type::Identity::TRUNCATED_HASHLENGTH/8)+2);
+							new_raw << packet.raw().view((Type::Identity::TRUNCATED_HASHLENGTH/8)+2);
 						}
 						else if (remaining_hops == 0) {
 							// Just increase hop count and transmit
 							//new_raw  = packet.raw[0:1]
-							new_raw << packet.raw().left(1);
+							new_raw << packet.raw().view_left(1);
 							//new_raw += struct.pack("!B", packet.hops)
 							new_raw << packet.hops();
 							//new_raw += packet.raw[2:]
-							new_raw << packet.raw().mid(2);
+							new_raw << packet.raw().view(2);
 						}
 
 						Interface outbound_interface = destination_entry.receiving_interface();
@@ -1749,36 +2261,12 @@ static bool is_backbone_interface(const Interface& iface) {
 						{
 						if (packet.packet_type() == Type::Packet::LINKREQUEST) {
 							TRACE("Transport::inbound: Packet is next-hop LINKREQUEST");
-							double now = OS::time();
-							double proof_timeout = now + Type::Link::ESTABLISHMENT_TIMEOUT_PER_HOP * std::max((uint8_t)1, remaining_hops);
-
-							// === MTU Clamping (v1.0.12) ===
-							// When forwarding a LINKREQUEST through this transport node,
-							// clamp the link MTU signalling to min(prev-hop, next-hop)
-							// interface HW_MTU.  Without this, endpoints negotiate a
-							// segment size that exceeds this node's buffer capacity,
-							// causing silent truncation and resource transfer stalls.
-							uint16_t path_mtu = Link::mtu_from_lr_packet(packet);
-							if (path_mtu > 0) {
-								uint16_t ph_mtu = packet.receiving_interface().HW_MTU();
-								uint16_t nh_mtu = outbound_interface.HW_MTU();
-								if (nh_mtu == 0) {
-									DEBUG("MTU CLAMP: No next-hop HW MTU, stripping link MTU signalling");
-									new_raw = new_raw.left(new_raw.size() - Type::Link::LINK_MTU_SIZE);
-								} else if (!outbound_interface.AUTOCONFIGURE_MTU() && !outbound_interface.FIXED_MTU()) {
-									DEBUG("MTU CLAMP: Outbound interface doesn't support MTU config, stripping link MTU signalling");
-									new_raw = new_raw.left(new_raw.size() - Type::Link::LINK_MTU_SIZE);
-								} else {
-									if (nh_mtu < path_mtu || (ph_mtu > 0 && ph_mtu < path_mtu)) {
-										uint16_t clamped = std::min(nh_mtu, (ph_mtu > 0) ? ph_mtu : nh_mtu);
-										RNS::Type::Link::link_mode mode = Link::mode_from_lr_packet(packet);
-										Bytes clamped_mtu_bytes = Link::signalling_bytes(clamped, mode);
-										new_raw = new_raw.left(new_raw.size() - Type::Link::LINK_MTU_SIZE) + clamped_mtu_bytes;
-										DEBUGF("MTU CLAMP: path=%u ph=%u nh=%u -> clamped=%u", path_mtu, ph_mtu, nh_mtu, clamped);
-									}
-								}
-							}
+							uint32_t now = OS::seconds();
+							uint32_t proof_timeout = now + Type::Link::ESTABLISHMENT_TIMEOUT_PER_HOP * std::max((uint8_t)1, remaining_hops);
+
+							clamp_link_mtu(packet, outbound_interface, new_raw);
 
+							RNS_ALLOC_SCOPE(TAG_LINK_TABLE);
 							LinkEntry link_entry(
 								now,
 								next_hop,
@@ -1791,17 +2279,18 @@ static bool is_backbone_interface(const Interface& iface) {
 								proof_timeout
 							);
 							// CBA ACCUMULATES
-							_link_table.insert({Link::link_id_from_lr_packet(packet), link_entry});
+							_instance->_link_table.insert({Link::link_id_from_lr_packet(packet), link_entry});
 						}
 						else {
 							TRACE("Transport::inbound: Packet is next-hop other type");
 							ReverseEntry reverse_entry(
 								packet.receiving_interface(),
 								outbound_interface,
-								OS::time()
+								OS::seconds()
 							);
 							// CBA ACCUMULATES
-							_reverse_table.insert({packet.getTruncatedHash(), reverse_entry});
+							_instance->_reverse_table.insert({packet.getTruncatedHash(), reverse_entry});
+							_instance->_reverse_timers.schedule(packet.getTruncatedHash(), reverse_deadline(reverse_entry));
 						}
 						TRACE("Transport::outbound: Sending packet to next hop...");
 #if defined(INTERFACES_SET)
@@ -1809,7 +2298,7 @@ static bool is_backbone_interface(const Interface& iface) {
 #else
 						transmit(outbound_interface, new_raw);
 #endif
-						destination_entry._timestamp = OS::time();
+						touch_path(packet.destination_hash(), destination_entry);
 						} // boundary mode else
 					}
 					else {
@@ -1819,7 +2308,7 @@ static bool is_backbone_interface(const Interface& iface) {
 						// this isn't a link_id (link data is handled by link transport).
 						{
 							bool from_backbone = is_backbone_interface(packet.receiving_interface());
-							if (!from_backbone && _link_table.find(packet.destination_hash()) == _link_table.end()) {
+							if (!from_backbone && _instance->_link_table.find(packet.destination_hash()) == _instance->_link_table.end()) {
 								DEBUG("BOUNDARY: No path to " + packet.destination_hash().toHex() + " for local device packet. Requesting path.");
 								request_path(packet.destination_hash());
 							}
@@ -1848,17 +2337,17 @@ static bool is_backbone_interface(const Interface& iface) {
 				// (e.g. path request handler) — those must be processed locally.
 				bool is_local_destination = false;
 #if defined(DESTINATIONS_MAP)
-				is_local_destination = (_destinations.find(packet.destination_hash()) != _destinations.end());
+				is_local_destination = (_instance->_destinations.find(packet.destination_hash()) != _instance->_destinations.end());
 #elif defined(DESTINATIONS_SET)
-				for (auto& dest : _destinations) {
+				for (auto& dest : _instance->_destinations) {
 					if (dest.hash() == packet.destination_hash()) { is_local_destination = true; break; }
 				}
 #endif
 				if (!is_local_destination && packet.packet_type() != Type::Packet::ANNOUNCE && packet.packet_type() != Type::Packet::PROOF) {
 					bool is_from_backbone = is_backbone_interface(packet.receiving_interface());
 					if (!is_from_backbone) {
-						auto destination_iter = _destination_table.find(packet.destination_hash());
-						if (destination_iter != _destination_table.end()) {
+						auto destination_iter = _instance->_destination_table.find(packet.destination_hash());
+						if (destination_iter != _instance->_destination_table.end()) {
 							DestinationEntry& dest_entry = (*destination_iter).second;
 							Bytes next_hop = dest_entry._received_from;
 							uint8_t remaining_hops = dest_entry._hops;
@@ -1877,7 +2366,7 @@ static bool is_backbone_interface(const Interface& iface) {
 								new_raw << new_flags;
 								new_raw << packet.hops();
 								new_raw << next_hop;          // insert transport_id
-								new_raw << packet.raw().mid(2); // destination_hash + payload
+								new_raw << packet.raw().view(2); // destination_hash + payload
 							}
 							else {
 								// Single hop (remaining_hops <= 1): destination is
@@ -1889,57 +2378,43 @@ static bool is_backbone_interface(const Interface& iface) {
 									| (packet.flags() & 0b00001111);
 								new_raw << new_flags;
 								new_raw << packet.hops();
-								new_raw << packet.raw().mid(2); // destination_hash + payload
+								new_raw << packet.raw().view(2); // destination_hash + payload
 							}
 
 							// Create link_table or reverse_table entry for return path
 							if (packet.packet_type() == Type::Packet::LINKREQUEST) {
-								double now = OS::time();
-								double proof_timeout = now + Type::Link::ESTABLISHMENT_TIMEOUT_PER_HOP
+								uint32_t now = OS::seconds();
+								uint32_t proof_timeout = now + Type::Link::ESTABLISHMENT_TIMEOUT_PER_HOP
 									* std::max((uint8_t)1, remaining_hops);
 
-								// === MTU Clamping (v1.0.12) ===
-								uint16_t path_mtu = Link::mtu_from_lr_packet(packet);
-								if (path_mtu > 0) {
-									uint16_t ph_mtu = packet.receiving_interface().HW_MTU();
-									uint16_t nh_mtu = outbound_interface.HW_MTU();
-									if (nh_mtu == 0) {
-										new_raw = new_raw.left(new_raw.size() - Type::Link::LINK_MTU_SIZE);
-									} else if (!outbound_interface.AUTOCONFIGURE_MTU() && !outbound_interface.FIXED_MTU()) {
-										new_raw = new_raw.left(new_raw.size() - Type::Link::LINK_MTU_SIZE);
-									} else if (nh_mtu < path_mtu || (ph_mtu > 0 && ph_mtu < path_mtu)) {
-										uint16_t clamped = std::min(nh_mtu, (ph_mtu > 0) ? ph_mtu : nh_mtu);
-										RNS::Type::Link::link_mode mode = Link::mode_from_lr_packet(packet);
-										Bytes clamped_mtu_bytes = Link::signalling_bytes(clamped, mode);
-										new_raw = new_raw.left(new_raw.size() - Type::Link::LINK_MTU_SIZE) + clamped_mtu_bytes;
-										DEBUGF("MTU CLAMP: local->backbone path=%u ph=%u nh=%u -> %u", path_mtu, ph_mtu, nh_mtu, clamped);
-									}
-								}
+								clamp_link_mtu(packet, outbound_interface, new_raw);
 
+								RNS_ALLOC_SCOPE(TAG_LINK_TABLE);
 								LinkEntry link_entry(
 									now, next_hop, outbound_interface, remaining_hops,
 									packet.receiving_interface(), packet.hops(),
 									packet.destination_hash(), false, proof_timeout
 								);
 								// Each LINKREQUEST gets its own entry (unique link_id)
-								_link_table.insert({Link::link_id_from_lr_packet(packet), link_entry});
+								_instance->_link_table.insert({Link::link_id_from_lr_packet(packet), link_entry});
 							}
 							else {
 								ReverseEntry reverse_entry(
-									packet.receiving_interface(), outbound_interface, OS::time()
+									packet.receiving_interface(), outbound_interface, OS::seconds()
 								);
-								_reverse_table.insert({packet.getTruncatedHash(), reverse_entry});
+								_instance->_reverse_table.insert({packet.getTruncatedHash(), reverse_entry});
+								_instance->_reverse_timers.schedule(packet.getTruncatedHash(), reverse_deadline(reverse_entry));
 							}
 
 							DEBUG("BOUNDARY: Forwarding local packet (" + std::to_string(remaining_hops) + " hops, " + std::to_string(new_raw.size()) + " bytes) to " + outbound_interface.toString() + " for " + packet.destination_hash().toHex());
 							transmit(outbound_interface, new_raw);
-							dest_entry._timestamp = OS::time();
+							touch_path(packet.destination_hash(), dest_entry);
 						}
 						else {
 							// Only request path if the destination is not a link_id
 							// (link data packets are handled by link transport below,
 							// not by standard transport path lookup).
-							if (_link_table.find(packet.destination_hash()) == _link_table.end()) {
+							if (_instance->_link_table.find(packet.destination_hash()) == _instance->_link_table.end()) {
 								DEBUG("BOUNDARY: No path to " + packet.destination_hash().toHex() + " for local packet. Requesting path.");
 								request_path(packet.destination_hash());
 							}
@@ -1948,9 +2423,9 @@ static bool is_backbone_interface(const Interface& iface) {
 					else {
 						// BOUNDARY MODE REVERSE: Packet came from backbone,
 						// check if destination is a local LoRa device and forward it.
-						if (_boundary_local_addresses.find(packet.destination_hash()) != _boundary_local_addresses.end()) {
-							auto destination_iter = _destination_table.find(packet.destination_hash());
-							if (destination_iter != _destination_table.end()) {
+						if (_instance->_boundary_whitelist.allowed(packet.destination_hash(), Utilities::Whitelist::CLASS_LOCAL)) {
+							auto destination_iter = _instance->_destination_table.find(packet.destination_hash());
+							if (destination_iter != _instance->_destination_table.end()) {
 								DestinationEntry& dest_entry = (*destination_iter).second;
 								Bytes next_hop = dest_entry._received_from;
 								uint8_t remaining_hops = dest_entry._hops;
@@ -1967,57 +2442,43 @@ static bool is_backbone_interface(const Interface& iface) {
 									new_raw << new_flags;
 									new_raw << packet.hops();
 									new_raw << next_hop;            // transport_id
-									new_raw << packet.raw().mid(2); // destination_hash + payload
+									new_raw << packet.raw().view(2); // destination_hash + payload
 								}
 								else {
 									// Direct or single-hop: send as HEADER_1
-									new_raw << packet.raw().left(1);
+									new_raw << packet.raw().view_left(1);
 									new_raw << packet.hops();
-									new_raw << packet.raw().mid(2);
+									new_raw << packet.raw().view(2);
 								}
 
 								// Create link_table or reverse_table entry for return traffic
 								if (packet.packet_type() == Type::Packet::LINKREQUEST) {
-									double now = OS::time();
-									double proof_timeout = now + Type::Link::ESTABLISHMENT_TIMEOUT_PER_HOP
+									uint32_t now = OS::seconds();
+									uint32_t proof_timeout = now + Type::Link::ESTABLISHMENT_TIMEOUT_PER_HOP
 										* std::max((uint8_t)1, remaining_hops);
 
-									// === MTU Clamping (v1.0.12) ===
-									uint16_t path_mtu = Link::mtu_from_lr_packet(packet);
-									if (path_mtu > 0) {
-										uint16_t ph_mtu = packet.receiving_interface().HW_MTU();
-										uint16_t nh_mtu = outbound_interface.HW_MTU();
-										if (nh_mtu == 0) {
-											new_raw = new_raw.left(new_raw.size() - Type::Link::LINK_MTU_SIZE);
-										} else if (!outbound_interface.AUTOCONFIGURE_MTU() && !outbound_interface.FIXED_MTU()) {
-											new_raw = new_raw.left(new_raw.size() - Type::Link::LINK_MTU_SIZE);
-										} else if (nh_mtu < path_mtu || (ph_mtu > 0 && ph_mtu < path_mtu)) {
-											uint16_t clamped = std::min(nh_mtu, (ph_mtu > 0) ? ph_mtu : nh_mtu);
-											RNS::Type::Link::link_mode mode = Link::mode_from_lr_packet(packet);
-											Bytes clamped_mtu_bytes = Link::signalling_bytes(clamped, mode);
-											new_raw = new_raw.left(new_raw.size() - Type::Link::LINK_MTU_SIZE) + clamped_mtu_bytes;
-											DEBUGF("MTU CLAMP: backbone->local path=%u ph=%u nh=%u -> %u", path_mtu, ph_mtu, nh_mtu, clamped);
-										}
-									}
+									clamp_link_mtu(packet, outbound_interface, new_raw);
 
+									RNS_ALLOC_SCOPE(TAG_LINK_TABLE);
 									LinkEntry link_entry(
 										now, next_hop, outbound_interface, remaining_hops,
 										packet.receiving_interface(), packet.hops(),
 										packet.destination_hash(), false, proof_timeout
 									);
-									_link_table.insert({Link::link_id_from_lr_packet(packet), link_entry});
+									_instance->_link_table.insert({Link::link_id_from_lr_packet(packet), link_entry});
 									DEBUG("BOUNDARY: Created link_table entry for backbone LINKREQUEST, link_id=" + Link::link_id_from_lr_packet(packet).toHex());
 								}
 								else {
 									ReverseEntry reverse_entry(
-										packet.receiving_interface(), outbound_interface, OS::time()
+										packet.receiving_interface(), outbound_interface, OS::seconds()
 									);
-									_reverse_table.insert({packet.getTruncatedHash(), reverse_entry});
+									_instance->_reverse_table.insert({packet.getTruncatedHash(), reverse_entry});
+									_instance->_reverse_timers.schedule(packet.getTruncatedHash(), reverse_deadline(reverse_entry));
 								}
 
 								DEBUG("BOUNDARY: Forwarding backbone packet (" + std::to_string(remaining_hops) + " hops) to local device for " + packet.destination_hash().toHex() + " via " + outbound_interface.toString());
 								transmit(outbound_interface, new_raw);
-								dest_entry._timestamp = OS::time();
+								touch_path(packet.destination_hash(), dest_entry);
 							}
 						}
 					}
@@ -2029,8 +2490,8 @@ static bool is_backbone_interface(const Interface& iface) {
 			// to entries in the link tables
 			if (packet.packet_type() != Type::Packet::ANNOUNCE && packet.packet_type() != Type::Packet::LINKREQUEST && packet.context() != Type::Packet::LRPROOF) {
 				TRACE("Transport::inbound: Checking if packet is meant for link transport...");
-				auto link_iter = _link_table.find(packet.destination_hash());
-				if (link_iter != _link_table.end()) {
+				auto link_iter = _instance->_link_table.find(packet.destination_hash());
+				if (link_iter != _instance->_link_table.end()) {
 					DEBUG("LINK-XPORT: pkt for " + packet.destination_hash().toHex().substr(0,8) + " type=" + std::to_string(packet.packet_type()) + " ctx=" + std::to_string(packet.context()) + " hops=" + std::to_string(packet.hops()) + " from=" + packet.receiving_interface().toString() + " hdr=" + std::to_string(packet.header_type()) + " sz=" + std::to_string(packet.raw().size()));
 					LinkEntry& link_entry = (*link_iter).second;
 					DEBUG("LINK-XPORT: entry hops=" + std::to_string(link_entry._hops) + " rem=" + std::to_string(link_entry._remaining_hops) + " recv=" + link_entry._receiving_interface.toString() + " out=" + link_entry._outbound_interface.toString() + " val=" + std::to_string(link_entry._validated));
@@ -2078,18 +2539,18 @@ static bool is_backbone_interface(const Interface& iface) {
 						// Add this packet to the filter hashlist now that
 						// we have determined it's actually our turn to
 						// process it (matching Python Transport line 1544).
-						_packet_hashlist.insert(packet.packet_hash());
+						_instance->_packet_hashlist.insert(packet.packet_hash());
 						// CBA RESERVE
 						//Bytes new_raw;
 						Bytes new_raw(512);
 						//new_raw = packet.raw[0:1]
-						new_raw << packet.raw().left(1);
+						new_raw << packet.raw().view_left(1);
 						//new_raw += struct.pack("!B", packet.hops)
 						new_raw << packet.hops();
 						//new_raw += packet.raw[2:]
-						new_raw << packet.raw().mid(2);
+						new_raw << packet.raw().view(2);
 						transmit(outbound_interface, new_raw);
-						link_entry._timestamp = OS::time();
+						link_entry._timestamp = OS::seconds();
 					}
 					else {
 						DEBUG("LINK-XPORT: DROPPED (no outbound interface resolved)");
@@ -2113,7 +2574,7 @@ static bool is_backbone_interface(const Interface& iface) {
 #if defined(DESTINATIONS_SET)
 			//Destination local_destination({Type::NONE});
 			bool found_local = false;
-			for (auto& destination : _destinations) {
+			for (auto& destination : _instance->_destinations) {
 				if (destination.hash() == packet.destination_hash()) {
 					//local_destination = destination;
 					found_local = true;
@@ -2124,8 +2585,8 @@ static bool is_backbone_interface(const Interface& iface) {
 			//if (!local_destination && Identity::validate_announce(packet)) {
 			if (!found_local && Identity::validate_announce(packet)) {
 #elif defined(DESTINATIONS_MAP)
-			auto iter = _destinations.find(packet.destination_hash());
-			if (iter == _destinations.end() && Identity::validate_announce(packet)) {
+			auto iter = _instance->_destinations.find(packet.destination_hash());
+			if (iter == _instance->_destinations.end() && Identity::validate_announce(packet)) {
 #endif
 				TRACE("Transport::inbound: Packet is announce for non-local destination, processing...");
 				if (packet.transport_id()) {
@@ -2134,24 +2595,24 @@ static bool is_backbone_interface(const Interface& iface) {
 					// Check if this is a next retransmission from
 					// another node. If it is, we're removing the
 					// announce in question from our pending table
-					if (Reticulum::transport_enabled() && _announce_table.count(packet.destination_hash()) > 0) {
-						//AnnounceEntry& announce_entry = _announce_table[packet.destination_hash()];
-						AnnounceEntry& announce_entry = (*_announce_table.find(packet.destination_hash())).second;
+					if (Reticulum::transport_enabled() && _instance->_announce_table.count(packet.destination_hash()) > 0) {
+						//AnnounceEntry& announce_entry = _instance->_announce_table[packet.destination_hash()];
+						AnnounceEntry& announce_entry = (*_instance->_announce_table.find(packet.destination_hash())).second;
 						
 						if ((packet.hops() - 1) == announce_entry._hops) {
 							DEBUG("Heard a local rebroadcast of announce for " + packet.destination_hash().toHex());
 							announce_entry._local_rebroadcasts += 1;
 							if (announce_entry._local_rebroadcasts >= LOCAL_REBROADCASTS_MAX) {
 								DEBUG("Max local rebroadcasts of announce for " + packet.destination_hash().toHex() + " reached, dropping announce from our table");
-								_announce_table.erase(packet.destination_hash());
+								_instance->_announce_table.erase(packet.destination_hash());
 							}
 						}
 
 						if ((packet.hops() - 1) == (announce_entry._hops + 1) && announce_entry._retries > 0) {
-							double now = OS::time();
+							uint32_t now = OS::seconds();
 							if (now < announce_entry._timestamp) {
 								DEBUG("Rebroadcasted announce for " + packet.destination_hash().toHex() + " has been passed on to another node, no further tries needed");
-								_announce_table.erase(packet.destination_hash());
+								_instance->_announce_table.erase(packet.destination_hash());
 							}
 						}
 					}
@@ -2170,7 +2631,7 @@ static bool is_backbone_interface(const Interface& iface) {
 				//if (not any(packet.destination_hash == d.hash for d in Transport.destinations) and packet.hops < Transport.PATHFINDER_M+1):
 #if defined(DESTINATIONS_SET)
 				bool found_local = false;
-				for (auto& destination : _destinations) {
+				for (auto& destination : _instance->_destinations) {
 					if (destination.hash() == packet.destination_hash()) {
 						found_local = true;
 						break;
@@ -2178,18 +2639,17 @@ static bool is_backbone_interface(const Interface& iface) {
 				}
 				if (!found_local && packet.hops() < (PATHFINDER_M+1)) {
 #elif defined(DESTINATIONS_MAP)
-				auto iter = _destinations.find(packet.destination_hash());
-				if (iter == _destinations.end() && packet.hops() < (PATHFINDER_M+1)) {
+				auto iter = _instance->_destinations.find(packet.destination_hash());
+				if (iter == _instance->_destinations.end() && packet.hops() < (PATHFINDER_M+1)) {
 #endif
 					uint64_t announce_emitted = Transport::announce_emitted(packet);
 
 					//p random_blob = packet.data[RNS.Identity.KEYSIZE//8+RNS.Identity.NAME_HASH_LENGTH//8:RNS.Identity.KEYSIZE//8+RNS.Identity.NAME_HASH_LENGTH//8+10]
 					Bytes random_blob = packet.data().mid(Type::Identity::KEYSIZE/8 + Type::Identity::NAME_HASH_LENGTH/8, Type::Identity::RANDOM_HASH_LENGTH/8);
 					//p random_blobs = []
-					std::set<Bytes> empty_random_blobs;
-					std::set<Bytes>& random_blobs = empty_random_blobs;
-					auto iter = _destination_table.find(packet.destination_hash());
-					if (iter != _destination_table.end()) {
+					RandomBlobs random_blobs;
+					auto iter = _instance->_destination_table.find(packet.destination_hash());
+					if (iter != _instance->_destination_table.end()) {
 						DestinationEntry destination_entry = (*iter).second;
 						//p random_blobs = Transport.destination_table[packet.destination_hash][4]
 						random_blobs = destination_entry._random_blobs;
@@ -2204,35 +2664,36 @@ static bool is_backbone_interface(const Interface& iface) {
 							// TODO: Check whether this approach works
 							// under all circumstances
 							//p if not random_blob in random_blobs:
-							if (random_blobs.find(random_blob) == random_blobs.end()) {
+							if (!random_blobs.contains(random_blob)) {
 								should_add = true;
 							}
 							else {
 								should_add = false;
 							}
+							// CBA At equal hops a much slower interface doesn't take over a path that is
+							// still online, the blob isn't recorded so the copy via the faster one is
+							// still accepted when it arrives
+							if (should_add && packet.hops() == destination_entry._hops && prefer_current_path(destination_entry, packet.receiving_interface())) {
+								DEBUG("Keeping destination table entry for " + packet.destination_hash().toHex() + ", equal-hop announce arrived over a slower interface");
+								should_add = false;
+							}
 						}
 						else {
 							// If an announce arrives with a larger hop
 							// count than we already have in the table,
 							// ignore it, unless the path is expired, or
 							// the emission timestamp is more recent.
-							double now = OS::time();
-							double path_expires = destination_entry._expires;
+							uint32_t now = OS::seconds();
+							uint32_t path_expires = destination_entry._expires;
 							
-							uint64_t path_announce_emitted = 0;
-							for (const Bytes& path_random_blob : random_blobs) {
-								//p path_announce_emitted = max(path_announce_emitted, int.from_bytes(path_random_blob[5:10], "big"))
-								path_announce_emitted = std::max(path_announce_emitted, OS::from_bytes_big_endian(path_random_blob.data() + 5, 5));
-								if (path_announce_emitted >= announce_emitted) {
-									break;
-								}
-							}
+							//p path_announce_emitted = max(path_announce_emitted, int.from_bytes(path_random_blob[5:10], "big"))
+							uint64_t path_announce_emitted = random_blobs.latest_emitted();
 
 							if (now >= path_expires) {
 								// We also check that the announce is
 								// different from ones we've already heard,
 								// to avoid loops in the network
-								if (random_blobs.find(random_blob) == random_blobs.end()) {
+								if (!random_blobs.contains(random_blob)) {
 									// TODO: Check that this ^ approach actually
 									// works under all circumstances
 									DEBUG("Replacing destination table entry for " + packet.destination_hash().toHex() + " with new announce due to expired path");
@@ -2244,7 +2705,7 @@ static bool is_backbone_interface(const Interface& iface) {
 							}
 							else {
 								if (announce_emitted > path_announce_emitted) {
-									if (random_blobs.find(random_blob) == random_blobs.end()) {
+									if (!random_blobs.contains(random_blob)) {
 										DEBUG("Replacing destination table entry for " + packet.destination_hash().toHex() + " with new announce, since it was more recently emitted");
 										should_add = true;
 									}
@@ -2276,45 +2737,46 @@ static bool is_backbone_interface(const Interface& iface) {
 					// until the next re-announce cycle changes the path.
 
 					if (should_add) {
-						double now = OS::time();
+						uint32_t now = OS::seconds();
 
 						bool rate_blocked = false;
 
-// TODO
-/*p
-						if packet.context != RNS.Packet.PATH_RESPONSE and packet.receiving_interface.announce_rate_target != None:
-							if not packet.destination_hash in Transport.announce_rate_table:
-								rate_entry = { "last": now, "rate_violations": 0, "blocked_until": 0, "timestamps": [now]}
-								Transport.announce_rate_table[packet.destination_hash] = rate_entry
-
-							else:
-								rate_entry = Transport.announce_rate_table[packet.destination_hash]
-								rate_entry["timestamps"].append(now)
-
-								while len(rate_entry["timestamps"]) > Transport.MAX_RATE_TIMESTAMPS:
-									rate_entry["timestamps"].pop(0)
-
-								current_rate = now - rate_entry["last"]
-
-								if now > rate_entry["blocked_until"]:
-
-									if current_rate < packet.receiving_interface.announce_rate_target:
-										rate_entry["rate_violations"] += 1
-
-									else:
-										rate_entry["rate_violations"] = std::max(0, rate_entry["rate_violations"]-1)
-
-									if rate_entry["rate_violations"] > packet.receiving_interface.announce_rate_grace:
-										rate_target = packet.receiving_interface.announce_rate_target
-										rate_penalty = packet.receiving_interface.announce_rate_penalty
-										rate_entry["blocked_until"] = rate_entry["last"] + rate_target + rate_penalty
-										rate_blocked = True
-									else:
-										rate_entry["last"] = now
-
-								else:
-									rate_blocked = True
-*/
+						//p if packet.context != RNS.Packet.PATH_RESPONSE and packet.receiving_interface.announce_rate_target != None:
+						const Interface& rate_interface = packet.receiving_interface();
+						if (packet.context() != Type::Packet::PATH_RESPONSE && rate_interface && rate_interface.announce_rate_target() > 0) {
+							auto rate_iter = _instance->_announce_rate_table.find(packet.destination_hash());
+							if (rate_iter == _instance->_announce_rate_table.end()) {
+								_instance->_announce_rate_table.insert({packet.destination_hash(), RateEntry(now)});
+							}
+							else {
+								RateEntry& rate_entry = (*rate_iter).second;
+								//p if now > rate_entry["blocked_until"]:
+								if (now > rate_entry._blocked_until) {
+									//p current_rate = now - rate_entry["last"]
+									if (now - rate_entry._last < rate_interface.announce_rate_target()) {
+										if (rate_entry._rate_violations < 0xFF) {
+											++rate_entry._rate_violations;
+										}
+									}
+									else if (rate_entry._rate_violations > 0) {
+										--rate_entry._rate_violations;
+									}
+									if (rate_entry._rate_violations > rate_interface.announce_rate_grace()) {
+										rate_entry._blocked_until = rate_entry._last + rate_interface.announce_rate_target() + rate_interface.announce_rate_penalty();
+										rate_blocked = true;
+									}
+									else {
+										rate_entry._last = now;
+									}
+								}
+								else {
+									rate_blocked = true;
+								}
+							}
+							if (rate_blocked) {
+								++_instance->_announces_rate_blocked;
+							}
+						}
 
 						uint8_t retries = 0;
 						uint8_t announce_hops = packet.hops();
@@ -2322,9 +2784,12 @@ static bool is_backbone_interface(const Interface& iface) {
 						bool block_rebroadcasts = false;
 						Interface attached_interface = {Type::NONE};
 						
-						double retransmit_timeout = now + (Cryptography::random() * PATHFINDER_RW);
+						//p retransmit_timeout = now + (RNS.rand() * Transport.PATHFINDER_RW)
+						// CBA Announce retransmit times are in ms of OS::ticks()
+						uint32_t now_ticks = OS::ticks();
+						uint32_t retransmit_timeout = now_ticks + Cryptography::randomnum((uint32_t)(PATHFINDER_RW * 1000) + 1);
 
-						double expires;
+						uint32_t expires;
 						if (packet.receiving_interface().mode() == Type::Interface::MODE_ACCESS_POINT) {
 							expires = now + AP_PATH_TIME;
 						}
@@ -2335,27 +2800,9 @@ static bool is_backbone_interface(const Interface& iface) {
 							expires = now + PATHFINDER_E;
 						}
 
-						random_blobs.insert(random_blob);
-
-						// Trim random_blobs to prevent unbounded memory growth
+						// Ring keeps the last MAX_RANDOM_BLOBS
 						// (matching Python: random_blobs = random_blobs[-MAX_RANDOM_BLOBS:])
-						if (random_blobs.size() > MAX_RANDOM_BLOBS) {
-							// Keep only the MAX_RANDOM_BLOBS blobs with the highest
-							// timestamps (bytes 5-9 big-endian). Extract, sort by
-							// timestamp desc, keep top N, rebuild set.
-							std::vector<Bytes> blob_vec(random_blobs.begin(), random_blobs.end());
-							std::sort(blob_vec.begin(), blob_vec.end(), [](const Bytes& a, const Bytes& b) {
-								// Sort descending by timestamp (bytes 5-9)
-								uint64_t ts_a = OS::from_bytes_big_endian(a.data() + 5, 5);
-								uint64_t ts_b = OS::from_bytes_big_endian(b.data() + 5, 5);
-								return ts_a > ts_b;
-							});
-							random_blobs.clear();
-							for (size_t i = 0; i < MAX_RANDOM_BLOBS && i < blob_vec.size(); i++) {
-								random_blobs.insert(blob_vec[i]);
-							}
-							TRACEF("Trimmed random_blobs to %d entries for %s", random_blobs.size(), packet.destination_hash().toHex().c_str());
-						}
+						random_blobs.insert(random_blob);
 
 						if ((Reticulum::transport_enabled() || Transport::from_local_client(packet)) && packet.context() != Type::Packet::PATH_RESPONSE) {
 							// Insert announce into announce table for retransmission
@@ -2367,9 +2814,10 @@ static bool is_backbone_interface(const Interface& iface) {
 								if (Transport::from_local_client(packet)) {
 									// If the announce is from a local client,
 									// it is announced immediately, but only one time.
-									retransmit_timeout = now;
+									retransmit_timeout = now_ticks;
 									retries = PATHFINDER_R;
 								}
+								RNS_ALLOC_SCOPE(TAG_ANNOUNCE_TABLE);
 								AnnounceEntry announce_entry(
 									now,
 									retransmit_timeout,
@@ -2381,10 +2829,7 @@ static bool is_backbone_interface(const Interface& iface) {
 									block_rebroadcasts,
 									attached_interface
 								);
-								// BUG FIX: erase before insert since std::map::insert() is
-								// a no-op when key exists (Python dict assignment overwrites)
-								_announce_table.erase(packet.destination_hash());
-								_announce_table.insert({packet.destination_hash(), announce_entry});
+								insert_announce(packet.destination_hash(), announce_entry);
 							}
 						}
 						// TODO: Check from_local_client once and store result
@@ -2393,14 +2838,15 @@ static bool is_backbone_interface(const Interface& iface) {
 							// check if any external interfaces have pending
 							// path requests.
 							//p if packet.destination_hash in Transport.pending_local_path_requests:
-							auto iter = _pending_local_path_requests.find(packet.destination_hash());
-							if (iter != _pending_local_path_requests.end()) {
+							auto iter = _instance->_pending_local_path_requests.find(packet.destination_hash());
+							if (iter != _instance->_pending_local_path_requests.end()) {
 								//p desiring_interface = Transport.pending_local_path_requests.pop(packet.destination_hash)
 								//const Interface& desiring_interface = (*iter).second;
-								_pending_local_path_requests.erase(iter);  // CBA FIX: pop() equivalent
-								retransmit_timeout = now;
+								_instance->_pending_local_path_requests.erase(iter);  // CBA FIX: pop() equivalent
+								retransmit_timeout = now_ticks;
 								retries = PATHFINDER_R;
 
+								RNS_ALLOC_SCOPE(TAG_ANNOUNCE_TABLE);
 								AnnounceEntry announce_entry(
 									now,
 									retransmit_timeout,
@@ -2412,16 +2858,13 @@ static bool is_backbone_interface(const Interface& iface) {
 									block_rebroadcasts,
 									attached_interface
 								);
-								// BUG FIX: erase before insert since std::map::insert() is
-								// a no-op when key exists (Python dict assignment overwrites)
-								_announce_table.erase(packet.destination_hash());
-								_announce_table.insert({packet.destination_hash(), announce_entry});
+								insert_announce(packet.destination_hash(), announce_entry);
 							}
 						}
 
 						// If we have any local clients connected, we re-
 						// transmit the announce to them immediately
-						if (_local_client_interfaces.size() > 0) {
+						if (_instance->_local_client_interfaces.size() > 0) {
 							Identity announce_identity(Identity::recall(packet.destination_hash()));
 							//Destination announce_destination(announce_identity, Type::Destination::OUT, Type::Destination::SINGLE, "unknown", "unknown");
 							//announce_destination.hash(packet.destination_hash());
@@ -2432,7 +2875,7 @@ static bool is_backbone_interface(const Interface& iface) {
 
 							// TODO: Shouldn't the context be PATH_RESPONSE in the first case here?
 							if (Transport::from_local_client(packet) && packet.context() == Type::Packet::PATH_RESPONSE) {
-								for (const Interface& local_interface : _local_client_interfaces) {
+								for (const Interface& local_interface : _instance->_local_client_interfaces) {
 									if (packet.receiving_interface() != local_interface) {
 										Packet new_announce(
 											announce_destination,
@@ -2442,7 +2885,7 @@ static bool is_backbone_interface(const Interface& iface) {
 											announce_context,
 											Type::Transport::TRANSPORT,
 											Type::Packet::HEADER_2,
-											_identity.hash(),
+											_instance->_identity.hash(),
 											true,
 											packet.context_flag()
 										);
@@ -2453,7 +2896,7 @@ static bool is_backbone_interface(const Interface& iface) {
 								}
 							}
 							else {
-								for (const Interface& local_interface : _local_client_interfaces) {
+								for (const Interface& local_interface : _instance->_local_client_interfaces) {
 									if (packet.receiving_interface() != local_interface) {
 										Packet new_announce(
 											announce_destination,
@@ -2463,7 +2906,7 @@ static bool is_backbone_interface(const Interface& iface) {
 											announce_context,
 											Type::Transport::TRANSPORT,
 											Type::Packet::HEADER_2,
-											_identity.hash(),
+											_instance->_identity.hash(),
 											true,
 											packet.context_flag()
 										);
@@ -2473,40 +2916,49 @@ static bool is_backbone_interface(const Interface& iface) {
 									}
 								}
 							}
-						}
-
-						// If we have any waiting discovery path requests
-						// for this destination, we retransmit to that
-						// interface immediately
-						auto iter = _discovery_path_requests.find(packet.destination_hash());
-						if (iter != _discovery_path_requests.end()) {
-							PathRequestEntry& pr_entry = (*iter).second;
-							attached_interface = pr_entry._requesting_interface;
-
-							DEBUG("Got matching announce, answering waiting discovery path request for " + packet.destination_hash().toHex() + " on " + attached_interface.toString());
-							Identity announce_identity(Identity::recall(packet.destination_hash()));
-							//Destination announce_destination(announce_identity, Type::Destination::OUT, Type::Destination::SINGLE, "unknown", "unknown");
-							//announce_destination.hash(packet.destination_hash());
-							Destination announce_destination(announce_identity, Type::Destination::OUT, Type::Destination::SINGLE, packet.destination_hash());
-							//announce_destination.hexhash(announce_destination.hash().toHex());
-							Type::Packet::context_types announce_context = Type::Packet::CONTEXT_NONE;
-							Bytes announce_data = packet.data();
+						}
 
-							Packet new_announce(
-								announce_destination,
-								attached_interface,
-								announce_data,
-								Type::Packet::ANNOUNCE,
-								Type::Packet::PATH_RESPONSE,
-								Type::Transport::TRANSPORT,
-								Type::Packet::HEADER_2,
-								_identity.hash(),
-								true,
-								packet.context_flag()
-							);
+						// If we have any waiting discovery path requests
+						// for this destination, we retransmit to that
+						// interface immediately
+						auto iter = _instance->_discovery_path_requests.find(packet.destination_hash());
+						if (iter != _instance->_discovery_path_requests.end()) {
+							// CBA The request is answered once on each interface that asked for the path,
+							// however many requests were coalesced into it, and then forgotten
+							std::vector<Interface> requesting_interfaces((*iter).second._coalesced_interfaces);
+							requesting_interfaces.insert(requesting_interfaces.begin(), (*iter).second._requesting_interface);
+							_instance->_discovery_path_requests.erase(iter);
+							for (const Interface& requesting_interface : requesting_interfaces) {
+								attached_interface = requesting_interface;
+
+								DEBUG("Got matching announce, answering waiting discovery path request for " + packet.destination_hash().toHex() + " on " + attached_interface.toString());
+								Identity announce_identity(Identity::recall(packet.destination_hash()));
+								//Destination announce_destination(announce_identity, Type::Destination::OUT, Type::Destination::SINGLE, "unknown", "unknown");
+								//announce_destination.hash(packet.destination_hash());
+								Destination announce_destination(announce_identity, Type::Destination::OUT, Type::Destination::SINGLE, packet.destination_hash());
+								//announce_destination.hexhash(announce_destination.hash().toHex());
+								Type::Packet::context_types announce_context = Type::Packet::CONTEXT_NONE;
+								Bytes announce_data = packet.data();
+
+								Packet new_announce(
+									announce_destination,
+									attached_interface,
+									announce_data,
+									Type::Packet::ANNOUNCE,
+									Type::Packet::PATH_RESPONSE,
+									Type::Transport::TRANSPORT,
+									Type::Packet::HEADER_2,
+									_instance->_identity.hash(),
+									true,
+									packet.context_flag()
+								);
 
-							new_announce.hops(packet.hops());
-							new_announce.send();
+								new_announce.hops(packet.hops());
+								new_announce.send();
+								if (attached_interface) {
+									path_response_sent(packet.destination_hash(), attached_interface);
+								}
+							}
 						}
 
 						// CBA Culling before adding to esnure table does not exceed maxsize
@@ -2517,27 +2969,40 @@ static bool is_backbone_interface(const Interface& iface) {
 						//TRACE("Adding packet " + packet.get_hash().toHex() + " to packet table");
 						//PacketEntry packet_entry(packet);
 						// CBA ACCUMULATES
-						//_packet_table.insert({packet.get_hash(), packet_entry});
+						//_instance->_packet_table.insert({packet.get_hash(), packet_entry});
 						TRACE("Adding destination " + packet.destination_hash().toHex() + " to path table");
-						DestinationEntry destination_table_entry(
-							now,
-							received_from,
-							announce_hops,
-							expires,
-							random_blobs,
-							//packet.receiving_interface(),
-							//const_cast<Interface&>(packet.receiving_interface()),
-							packet.receiving_interface().get_hash(),
-							//packet
-							packet.get_hash()
-						);
-						// CBA ACCUMULATES
-						// Erase existing entry so insert overwrites (matching Python dict[key]=value)
-						bool path_existed = (_destination_table.erase(packet.destination_hash()) > 0);
-						if (_destination_table.insert({packet.destination_hash(), destination_table_entry}).second) {
-							if (!path_existed) {
-								++_destinations_added;
-								cull_path_table();
+						{
+							RNS_ALLOC_SCOPE(TAG_PATH_TABLE);
+							DestinationEntry destination_table_entry(
+								now,
+								received_from,
+								announce_hops,
+								expires,
+								random_blobs,
+								//packet.receiving_interface(),
+								//const_cast<Interface&>(packet.receiving_interface()),
+								packet.receiving_interface().id(),
+								//packet
+								packet.get_hash()
+							);
+							// CBA ACCUMULATES
+							// Erase existing entry so insert overwrites (matching Python dict[key]=value)
+							bool path_existed = false;
+							DestinationEntry* existing_entry = find_path_entry(packet.destination_hash());
+							if (existing_entry) {
+								// CBA the path's timer still stands, it re-arms from the new timestamp when it fires
+								destination_table_entry._cull_at = existing_entry->_cull_at;
+								unlink_path(packet.destination_hash(), *existing_entry);
+								path_existed = (_instance->_destination_table.erase(packet.destination_hash()) > 0);
+							}
+							schedule_path(packet.destination_hash(), destination_table_entry);
+							auto inserted = _instance->_destination_table.insert({packet.destination_hash(), destination_table_entry});
+							if (inserted.second) {
+								link_path(packet.destination_hash(), (*inserted.first).second);
+								if (!path_existed) {
+									++_instance->_destinations_added;
+									cull_path_table();
+								}
 							}
 						}
 
@@ -2549,7 +3014,7 @@ static bool is_backbone_interface(const Interface& iface) {
 						{
 							bool is_backbone = is_backbone_interface(packet.receiving_interface());
 							if (!is_backbone) {
-								_boundary_local_addresses.insert(packet.destination_hash());
+								_instance->_boundary_whitelist.insert(packet.destination_hash(), Utilities::Whitelist::CLASS_LOCAL);
 								DEBUG("BOUNDARY: Registered local address " + packet.destination_hash().toHex() + " from local interface");
 							}
 						}
@@ -2565,7 +3030,7 @@ static bool is_backbone_interface(const Interface& iface) {
 							tunnel_entry = Transport.tunnels[packet.receiving_interface.tunnel_id];
 							paths = tunnel_entry[2];
 							paths[packet.destination_hash] = destination_table_entry;
-							expires = OS::time() + Transport::DESTINATION_TIMEOUT;
+							expires = OS::seconds() + Transport::DESTINATION_TIMEOUT;
 							tunnel_entry[3] = expires;
 							DEBUG("Path to " + packet.destination_hash().toHex() + " associated with tunnel " + packet.receiving_interface().tunnel_id().toHex());
 						}
@@ -2575,7 +3040,7 @@ static bool is_backbone_interface(const Interface& iface) {
 						// wanting to know when an announce arrives
 						if (packet.context() != Type::Packet::PATH_RESPONSE) {
 							TRACE("Transport::inbound: Not path response, sending to announce handler...");
-							for (auto& handler : _announce_handlers) {
+							for (auto& handler : _instance->_announce_handlers) {
 								TRACE("Transport::inbound: Checking filter of announce handler...");
 								try {
 									// Check that the announced destination matches
@@ -2622,26 +3087,33 @@ static bool is_backbone_interface(const Interface& iface) {
 		// Handling for link requests to local destinations
 		else if (packet.packet_type() == Type::Packet::LINKREQUEST) {
 			TRACE("Transport::inbound: Packet is LINKREQUEST");
-			if (!packet.transport_id() || packet.transport_id() == _identity.hash()) {
+			if (!packet.transport_id() || packet.transport_id() == _instance->_identity.hash()) {
 				TRACE("Transport::inbound: Checking if LINKREQUEST is for local destination");
 #if defined(DESTINATIONS_SET)
-				for (auto& destination : _destinations) {
+				for (auto& destination : _instance->_destinations) {
 					if (destination.hash() == packet.destination_hash() && destination.type() == packet.destination_type()) {
 #elif defined(DESTINATIONS_MAP)
-				auto iter = _destinations.find(packet.destination_hash());
-				if (iter != _destinations.end()) {
+				auto iter = _instance->_destinations.find(packet.destination_hash());
+				if (iter != _instance->_destinations.end()) {
 					auto& destination = (*iter).second;
 					if (destination.type() == packet.destination_type()) {
 #endif
 						TRACE("Transport::inbound: Found local destination for LINKREQUEST");
-						packet.destination(destination);
-						// CBA iterator over std::set is always const so need to make temporarily mutable
-						//destination.receive(packet);
+						if (!_instance->_accept_link_requests) {
+							// CBA Shedding memory, a new link would only add to it
+							++_instance->_link_requests_rejected;
+							DEBUG("Transport::inbound: Not accepting link requests, dropped LINKREQUEST for " + packet.destination_hash().toHex());
+						}
+						else {
+							packet.destination(destination);
+							// CBA iterator over std::set is always const so need to make temporarily mutable
+							//destination.receive(packet);
 #if defined(DESTINATIONS_SET)
-						const_cast<Destination&>(destination).receive(packet);
+							const_cast<Destination&>(destination).receive(packet);
 #else
-						destination.receive(packet);
+							destination.receive(packet);
 #endif
+						}
 					}
 				}
 			}
@@ -2653,23 +3125,23 @@ static bool is_backbone_interface(const Interface& iface) {
 			if (packet.destination_type() == Type::Destination::LINK) {
 				// Data is destined for a link
 				TRACE("Transport::inbound: Packet is DATA for a LINK");
-				std::set<Link> active_links(_active_links);
-				for (auto& link : active_links) {
-					if (link.link_id() == packet.destination_hash()) {
-						TRACE("Transport::inbound: Packet is DATA for an active LINK");
-						packet.link(link);
-						const_cast<Link&>(link).receive(packet);
-					}
+				auto link_iter = _instance->_active_links.find(packet.destination_hash());
+				if (link_iter != _instance->_active_links.end()) {
+					TRACE("Transport::inbound: Packet is DATA for an active LINK");
+					// CBA Hold a handle, receive() can register new links and rehash the table
+					Link link = (*link_iter).second;
+					packet.link(link);
+					link.receive(packet);
 				}
 			}
 			else {
 				// Data is basic (not destined for a link)
 #if defined(DESTINATIONS_SET)
-				for (auto& destination : _destinations) {
+				for (auto& destination : _instance->_destinations) {
 					if (destination.hash() == packet.destination_hash() && destination.type() == packet.destination_type()) {
 #elif defined(DESTINATIONS_MAP)
-				auto iter = _destinations.find(packet.destination_hash());
-				if (iter != _destinations.end()) {
+				auto iter = _instance->_destinations.find(packet.destination_hash());
+				if (iter != _instance->_destinations.end()) {
 					// Data is for a local destination
 					DEBUG("Packet destination " + packet.destination_hash().toHex() + " found, destination is local");
 					auto& destination = (*iter).second;
@@ -2716,9 +3188,9 @@ static bool is_backbone_interface(const Interface& iface) {
 				TRACE("Transport::inbound: Packet is LINK PROOF");
 				// This is a link request proof, check if it
 				// needs to be transported
-				if ((Reticulum::transport_enabled() || for_local_client_link || from_local_client) && _link_table.find(packet.destination_hash()) != _link_table.end()) {
+				if ((Reticulum::transport_enabled() || for_local_client_link || from_local_client) && _instance->_link_table.find(packet.destination_hash()) != _instance->_link_table.end()) {
 					DEBUG("LRPROOF-XPORT: handling proof for link " + packet.destination_hash().toHex().substr(0,8));
-					LinkEntry& link_entry = (*_link_table.find(packet.destination_hash())).second;
+					LinkEntry& link_entry = (*_instance->_link_table.find(packet.destination_hash())).second;
 					DEBUG("LRPROOF-XPORT: recv_iface=" + packet.receiving_interface().toString() + " entry_out=" + link_entry._outbound_interface.toString() + " entry_recv=" + link_entry._receiving_interface.toString());
 
 					bool interface_match = (packet.receiving_interface() == link_entry._outbound_interface);
@@ -2751,11 +3223,11 @@ static bool is_backbone_interface(const Interface& iface) {
 									// CBA RESERVE
 									//Bytes new_raw = packet.raw().left(1);
 									Bytes new_raw(512);
-									new_raw << packet.raw().left(1);
+									new_raw << packet.raw().view_left(1);
 									//p new_raw += struct.pack("!B", packet.hops)
 									new_raw << packet.hops();
 									//p new_raw += packet.raw[2:]
-									new_raw << packet.raw().mid(2);
+									new_raw << packet.raw().view(2);
 									DEBUG("LRPROOF-XPORT: new_raw size=" + std::to_string(new_raw.size()) + " hops=" + std::to_string(packet.hops()) + " flags=0x" + new_raw.left(1).toHex() + " dest=" + new_raw.mid(2, 10).toHex().substr(0,16));
 									link_entry._validated = true;
 									transmit(link_entry._receiving_interface, new_raw);
@@ -2782,36 +3254,30 @@ static bool is_backbone_interface(const Interface& iface) {
 				else {
 					// Not in link_table or transport not enabled — check
 					// if we can deliver it to a local pending link
-					DEBUG("LRPROOF-XPORT: not in link_table or transport not enabled, checking local pending links (transport=" + std::to_string(Reticulum::transport_enabled()) + " for_lcl=" + std::to_string(for_local_client_link) + " from_lcl=" + std::to_string(from_local_client) + " in_lt=" + std::to_string(_link_table.find(packet.destination_hash()) != _link_table.end()) + ")");
-					// CBA Must make a copy of _pending_links before traversing since it gets modified
-					//for (auto link : _pending_links) {
-					std::set<Link> pending_links(_pending_links);
-					for (auto& link : pending_links) {
-						TRACEF("Checking for link request handling by pending link %s", link.link_id().toHex().c_str());
-						if (link.link_id() == packet.destination_hash()) {
-							TRACE("Requesting pending link to validate proof");
-							const_cast<Link&>(link).validate_proof(packet);
-						}
+					DEBUG("LRPROOF-XPORT: not in link_table or transport not enabled, checking local pending links (transport=" + std::to_string(Reticulum::transport_enabled()) + " for_lcl=" + std::to_string(for_local_client_link) + " from_lcl=" + std::to_string(from_local_client) + " in_lt=" + std::to_string(_instance->_link_table.find(packet.destination_hash()) != _instance->_link_table.end()) + ")");
+					// CBA validate_proof() activates the link, moving it out of _pending_links
+					auto link_iter = _instance->_pending_links.find(packet.destination_hash());
+					if (link_iter != _instance->_pending_links.end()) {
+						TRACE("Requesting pending link to validate proof");
+						Link link = (*link_iter).second;
+						link.validate_proof(packet);
 					}
 				}
 			}
 			else if (packet.context() == Type::Packet::RESOURCE_PRF) {
 				TRACE("Transport::inbound: Packet is RESOURCE PROOF");
-				std::set<Link> active_links(_active_links);
-				for (auto& link : active_links) {
-					if (link.link_id() == packet.destination_hash()) {
-						const_cast<Link&>(link).receive(packet);
-					}
+				auto link_iter = _instance->_active_links.find(packet.destination_hash());
+				if (link_iter != _instance->_active_links.end()) {
+					Link link = (*link_iter).second;
+					link.receive(packet);
 				}
 			}
 			else {
 				TRACE("Transport::inbound: Packet is regular PROOF");
 				if (packet.destination_type() == Type::Destination::LINK) {
-					std::set<Link> active_links(_active_links);
-					for (auto& link : active_links) {
-						if (link.link_id() == packet.destination_hash()) {
-							packet.link(link);
-						}
+					auto link_iter = _instance->_active_links.find(packet.destination_hash());
+					if (link_iter != _instance->_active_links.end()) {
+						packet.link((*link_iter).second);
 					}
 				}
 
@@ -2821,19 +3287,19 @@ static bool is_backbone_interface(const Interface& iface) {
 				}
 
 				// Check if this proof needs to be transported
-				if ((Reticulum::transport_enabled() || from_local_client || proof_for_local_client) && _reverse_table.find(packet.destination_hash()) != _reverse_table.end()) {
-					ReverseEntry reverse_entry = (*_reverse_table.find(packet.destination_hash())).second;
+				if ((Reticulum::transport_enabled() || from_local_client || proof_for_local_client) && _instance->_reverse_table.find(packet.destination_hash()) != _instance->_reverse_table.end()) {
+					ReverseEntry reverse_entry = (*_instance->_reverse_table.find(packet.destination_hash())).second;
 					if (packet.receiving_interface() == reverse_entry._outbound_interface) {
 						TRACE("Proof received on correct interface, transporting it via " + reverse_entry._receiving_interface.toString());
 						//p new_raw = packet.raw[0:1]
 						// CBA RESERVE
 						//Bytes new_raw = packet.raw().left(1);
 						Bytes new_raw(512);
-						new_raw << packet.raw().left(1);
+						new_raw << packet.raw().view_left(1);
 						//p new_raw += struct.pack("!B", packet.hops)
 						new_raw << packet.hops();
 						//p new_raw += packet.raw[2:]
-						new_raw << packet.raw().mid(2);
+						new_raw << packet.raw().view(2);
 						transmit(reverse_entry._receiving_interface, new_raw);
 					}
 					else {
@@ -2844,62 +3310,49 @@ static bool is_backbone_interface(const Interface& iface) {
 					TRACE("Proof is not candidate for transporting");
 				}
 
-				std::list<PacketReceipt> cull_receipts;
-				for (auto& receipt : _receipts) {
-					bool receipt_validated = false;
-					if (proof_hash) {
-						// Only test validation if hash matches
-						if (receipt.hash() == proof_hash) {
-							receipt_validated = receipt.validate_proof_packet(packet);
-						}
-					}
-					else {
-						// TODO: This looks like it should actually
-						// be rewritten when implicit proofs are added.
-
-						// In case of an implicit proof, we have
-						// to check every single outstanding receipt
-						receipt_validated = receipt.validate_proof_packet(packet);
-					}
-
-					// CBA TODO requires modifying of collection while iterating which is forbidden
-					if (receipt_validated) {
+				// CBA Receipts are keyed on the truncated packet hash. An explicit proof carries
+				// the full hash, an implicit one is addressed to the proof destination, whose
+				// hash is the truncated packet hash, so neither needs a scan of all receipts.
+				Bytes receipt_key = proof_hash ? proof_hash.left(Type::Reticulum::TRUNCATED_HASHLENGTH/8) : packet.destination_hash();
+				const auto& receipts = _instance->_receipts;
+				auto receipt_iter = receipts.find(receipt_key);
+				if (receipt_iter != receipts.end()) {
+					// hold a handle, delivery callbacks may send packets and add receipts
+					PacketReceipt receipt = (*receipt_iter).second;
+					// Only test validation if hash matches
+					if ((!proof_hash || receipt.hash() == proof_hash) && receipt.validate_proof_packet(packet)) {
 						//p if receipt in Transport.receipts:
 						//p 	Transport.receipts.remove(receipt)
-						cull_receipts.push_back(receipt);
+						remove_receipt(receipt);
 					}
 				}
-				// CBA since modifying of collection while iterating is forbidden
-				for (auto& receipt : _receipts) {
-					cull_receipts.remove(receipt);
-				}
 			}
 		}
 	}
 
 	// Heap telemetry: snapshot at exit
-	{
+	if (RNS_LOG_ENABLED(LOG_VERBOSE)) {
 		size_t _heap_at_exit = OS::heap_available();
 		int _inbound_delta = (int)_heap_at_exit - (int)_heap_at_entry;
 		// Log every 100th packet or when delta exceeds threshold
 		static uint32_t _tel_pkt_count = 0;
 		++_tel_pkt_count;
 		if (_inbound_delta < -64 || (_tel_pkt_count % 100 == 0)) {
-			VERBOSEF("[HEAP-TEL] inbound: %d bytes (heap=%u pin=%u bma=%u phl=%u lt=%u revr=%u)",
-				_inbound_delta, (uint32_t)_heap_at_exit, _packets_received,
-				_boundary_mentioned_addresses.size(), _packet_hashlist.size(),
-				_link_table.size(), _reverse_table.size());
+			VERBOSEF("[HEAP-TEL] inbound: %d bytes (heap=%u pin=%u bwl=%u phl=%u lt=%u revr=%u)",
+				_inbound_delta, (uint32_t)_heap_at_exit, _instance->_packets_received,
+				_instance->_boundary_whitelist.size(), _instance->_packet_hashlist.size(),
+				_instance->_link_table.size(), _instance->_reverse_table.size());
 		}
 	}
 
-	_jobs_locked = false;
+	_instance->_jobs_locked = false;
 }
 
 /*static*/ void Transport::synthesize_tunnel(const Interface& interface) {
 // TODO
 /*p
 	Bytes interface_hash = interface.get_hash();
-	Bytes public_key     = _identity.get_public_key();
+	Bytes public_key     = _instance->_identity.get_public_key();
 	Bytes random_hash    = Identity::get_random_hash();
 	
 	tunnel_id_data = public_key+interface_hash
@@ -3002,46 +3455,75 @@ static bool is_backbone_interface(const Interface& iface) {
 }
 
 /*static*/ void Transport::register_interface(Interface& interface) {
-	TRACE("Transport: Registering interface " + interface.get_hash().toHex() + " " + interface.toString());
+	// CBA Hash is computed here once and memoized in the interface
+	const Bytes interface_hash = interface.get_hash();
+	TRACE("Transport: Registering interface " + interface_hash.toHex() + " " + interface.toString());
+	if (interface.id() == 0) {
+		for (uint8_t i = 0; i < Type::Transport::INTERFACES_MAXSIZE; i++) {
+			if (_instance->_interfaces_by_id[i] == nullptr) {
+				_instance->_interfaces_by_id[i] = &interface;
+				interface.id(i + 1);
+				_instance->_interface_ids.insert_or_assign(interface_hash, interface.id());
+				break;
+			}
+		}
+		if (interface.id() == 0) {
+			ERROR("Transport: No free interface id for " + interface.toString() + ", paths via it will not be kept");
+		}
+	}
 #if defined(INTERFACES_SET)
-	_interfaces.insert(interface);
+	_instance->_interfaces.insert(interface);
 #elif defined(INTERFACES_LIST)
-	_interfaces.push_back(interface);
+	_instance->_interfaces.push_back(interface);
 #elif defined(INTERFACES_MAP)
-	_interfaces.insert({interface.get_hash(), interface});
+	_instance->_interfaces.insert({interface.get_hash(), interface});
 #endif
 	// CBA TODO set or add transport as listener on interface to receive incoming packets?
 }
 
 /*static*/ void Transport::deregister_interface(const Interface& interface) {
 	TRACE("Transport: Deregistering interface " + interface.toString());
+	uint8_t interface_id = interface.id();
+	if (interface_id > 0 && interface_id <= Type::Transport::INTERFACES_MAXSIZE) {
+		// Paths via the interface are culled on the next path cull tick
+		uint32_t now = OS::seconds();
+		for (auto& [destination_hash, destination_entry] : _instance->_destination_table) {
+			if (destination_entry._receiving_interface == interface_id) {
+				destination_entry._cull_at = now;
+				_instance->_path_timers.schedule(destination_hash, now);
+			}
+		}
+		_instance->_interfaces_by_id[interface_id - 1] = nullptr;
+		_instance->_interface_ids.erase(interface.get_hash());
+		interface.id(0);
+	}
 #if defined(INTERFACES_SET)
-	//for (auto iter = _interfaces.begin(); iter != _interfaces.end(); ++iter) {
+	//for (auto iter = _instance->_interfaces.begin(); iter != _instance->_interfaces.end(); ++iter) {
 	//	if ((*iter).get() == interface) {
-	//		_interfaces.erase(iter);
+	//		_instance->_interfaces.erase(iter);
 	//		TRACE("Transport::deregister_interface: Found and removed interface " + (*iter).get().toString());
 	//		break;
 	//	}
 	//}
-	//auto iter = _interfaces.find(interface);
-	auto iter = _interfaces.find(const_cast<Interface&>(interface));
-	if (iter != _interfaces.end()) {
-		_interfaces.erase(iter);
+	//auto iter = _instance->_interfaces.find(interface);
+	auto iter = _instance->_interfaces.find(const_cast<Interface&>(interface));
+	if (iter != _instance->_interfaces.end()) {
+		_instance->_interfaces.erase(iter);
 		TRACE("Transport::deregister_interface: Found and removed interface " + (*iter).get().toString());
 	}
 #elif defined(INTERFACES_LIST)
-	for (auto iter = _interfaces.begin(); iter != _interfaces.end(); ++iter) {
+	for (auto iter = _instance->_interfaces.begin(); iter != _instance->_interfaces.end(); ++iter) {
 		if ((*iter).get() == interface) {
-			_interfaces.erase(iter);
+			_instance->_interfaces.erase(iter);
 			TRACE("Transport::deregister_interface: Found and removed interface " + (*iter).get().toString());
 			break;
 		}
 	}
 #elif defined(INTERFACES_MAP)
-	auto iter = _interfaces.find(interface.get_hash());
-	if (iter != _interfaces.end()) {
+	auto iter = _instance->_interfaces.find(interface.get_hash());
+	if (iter != _instance->_interfaces.end()) {
 		TRACE("Transport::deregister_interface: Found and removed interface " + (*iter).second.toString());
-		_interfaces.erase(iter);
+		_instance->_interfaces.erase(iter);
 	}
 #endif
 }
@@ -3052,7 +3534,7 @@ static bool is_backbone_interface(const Interface& iface) {
 	destination.mtu(Type::Reticulum::MTU);
 	if (destination.direction() == Type::Destination::IN) {
 #if defined(DESTINATIONS_SET)
-		for (auto& registered_destination : _destinations) {
+		for (auto& registered_destination : _instance->_destinations) {
 			if (destination.hash() == registered_destination.hash()) {
 				//p raise KeyError("Attempt to register an already registered destination.")
 				throw std::runtime_error("Attempt to register an already registered destination.");
@@ -3060,19 +3542,23 @@ static bool is_backbone_interface(const Interface& iface) {
 		}
 
 		// CBA ACCUMULATES
-		_destinations.insert(destination);
+		_instance->_destinations.insert(destination);
 #elif defined(DESTINATIONS_MAP)
-		auto iter = _destinations.find(destination.hash());
-		if (iter != _destinations.end()) {
+		auto iter = _instance->_destinations.find(destination.hash());
+		if (iter != _instance->_destinations.end()) {
 			//p raise KeyError("Attempt to register an already registered destination.")
 			throw std::runtime_error("Attempt to register an already registered destination.");
 		}
 
 		// CBA ACCUMULATES
-		_destinations.insert({destination.hash(), destination});
+		_instance->_destinations.insert({destination.hash(), destination});
+#endif
+#ifdef BOUNDARY_MODE
+		// Traffic for our own destinations always passes the boundary firewall
+		_instance->_boundary_whitelist.insert(destination.hash(), Utilities::Whitelist::CLASS_PINNED);
 #endif
 
-		if (_owner && _owner.is_connected_to_shared_instance()) {
+		if (*_instance->_owner && _instance->_owner->is_connected_to_shared_instance()) {
 			if (destination.type() == Type::Destination::SINGLE) {
 				TRACE("Transport:register_destination: Announcing destination " + destination.toString());
 				destination.announce({}, true);
@@ -3085,9 +3571,9 @@ static bool is_backbone_interface(const Interface& iface) {
 
 /*
 #if defined(DESTINATIONS_SET)
-	for (const Destination& destination : _destinations) {
+	for (const Destination& destination : _instance->_destinations) {
 #elif defined(DESTINATIONS_MAP)
-	for (auto& [hash, destination] : _destinations) {
+	for (auto& [hash, destination] : _instance->_destinations) {
 #endif
 		TRACE("Transport::register_destination: Listed destination " + destination.toString());
 	}
@@ -3098,40 +3584,43 @@ static bool is_backbone_interface(const Interface& iface) {
 /*static*/ void Transport::deregister_destination(const Destination& destination) {
 	TRACE("Transport: Deregistering destination " + destination.toString());
 #if defined(DESTINATIONS_SET)
-	if (_destinations.find(destination) != _destinations.end()) {
-		_destinations.erase(destination);
+	if (_instance->_destinations.find(destination) != _instance->_destinations.end()) {
+		_instance->_destinations.erase(destination);
 		TRACE("Transport::deregister_destination: Found and removed destination " + destination.toString());
 	}
 #elif defined(DESTINATIONS_MAP)
-	auto iter = _destinations.find(destination.hash());
-	if (iter != _destinations.end()) {
-		_destinations.erase(iter);
+	auto iter = _instance->_destinations.find(destination.hash());
+	if (iter != _instance->_destinations.end()) {
+		_instance->_destinations.erase(iter);
 		TRACE("Transport::deregister_destination: Found and removed destination " + (*iter).second.toString());
 	}
 #endif
+#ifdef BOUNDARY_MODE
+	_instance->_boundary_whitelist.remove(destination.hash(), Utilities::Whitelist::CLASS_PINNED);
+#endif
 }
 
 /*static*/ void Transport::register_link(Link& link) {
 	TRACE("Transport: Registering link " + link.toString());
 	if (link.initiator()) {
 		// CBA ACCUMULATES
-		_pending_links.insert(link);
+		_instance->_pending_links.insert({link.link_id(), link});
 	}
 	else {
 		// CBA ACCUMULATES
-		_active_links.insert(link);
+		_instance->_active_links.insert({link.link_id(), link});
 	}
 }
 
 /*static*/ void Transport::activate_link(Link& link) {
 	TRACE("Transport: Activating link " + link.toString());
-	if (_pending_links.find(link) != _pending_links.end()) {
+	if (_instance->_pending_links.contains(link.link_id())) {
 		if (link.status() != Type::Link::ACTIVE) {
 			throw std::runtime_error("Invalid link state for link activation: " + std::to_string(link.status()));
 		}
-		_pending_links.erase(link);
+		_instance->_pending_links.erase(link.link_id());
 		// CBA ACCUMULATES
-		_active_links.insert(link);
+		_instance->_active_links.insert({link.link_id(), link});
 		link.status(Type::Link::ACTIVE);
 	}
 	else {
@@ -3146,7 +3635,7 @@ Registers an announce handler.
 */
 /*static*/ void Transport::register_announce_handler(HAnnounceHandler handler) {
 	TRACE("Transport: Registering announce handler " + handler->aspect_filter());
-	_announce_handlers.insert(handler);
+	_instance->_announce_handlers.insert(handler);
 }
 
 /*
@@ -3156,30 +3645,35 @@ Deregisters an announce handler.
 */
 /*static*/ void Transport::deregister_announce_handler(HAnnounceHandler handler) {
 	TRACE("Transport: Deregistering announce handler " + handler->aspect_filter());
-	if (_announce_handlers.find(handler) != _announce_handlers.end()) {
-		_announce_handlers.erase(handler);
+	if (_instance->_announce_handlers.find(handler) != _instance->_announce_handlers.end()) {
+		_instance->_announce_handlers.erase(handler);
 		TRACE("Transport::deregister_announce_handler: Found and removed handler" + handler->aspect_filter());
 	}
 }
 
 /*static*/ Interface Transport::find_interface_from_hash(const Bytes& interface_hash) {
+	// CBA Registered interfaces are found through the id index
+	uint8_t interface_id = interface_id_from_hash(interface_hash);
+	if (interface_id > 0) {
+		return find_interface_from_id(interface_id);
+	}
 #if defined(INTERFACES_SET)
-	for (const Interface& interface : _interfaces) {
+	for (const Interface& interface : _instance->_interfaces) {
 		if (interface.get_hash() == interface_hash) {
 			TRACE("Transport::find_interface_from_hash: Found interface " + interface.toString());
 			return interface;
 		}
 	}
 #elif defined(INTERFACES_LIST)
-	for (Interface& interface : _interfaces) {
+	for (Interface& interface : _instance->_interfaces) {
 		if (interface.get_hash() == interface_hash) {
 			TRACE("Transport::find_interface_from_hash: Found interface " + interface.toString());
 			return interface;
 		}
 	}
 #elif defined(INTERFACES_MAP)
-	auto iter = _interfaces.find(interface_hash);
-	if (iter != _interfaces.end()) {
+	auto iter = _instance->_interfaces.find(interface_hash);
+	if (iter != _instance->_interfaces.end()) {
 		TRACE("Transport::find_interface_from_hash: Found interface " + (*iter).second.toString());
 		return (*iter).second;
 	}
@@ -3188,6 +3682,169 @@ Deregisters an announce handler.
 	return {Type::NONE};
 }
 
+/*static*/ uint32_t Transport::path_deadline(const DestinationEntry& destination_entry) {
+	const Interface attached_interface = destination_entry.receiving_interface();
+	uint32_t path_time = DESTINATION_TIMEOUT;
+	if (attached_interface && attached_interface.mode() == Type::Interface::MODE_ACCESS_POINT) {
+		path_time = AP_PATH_TIME;
+	}
+	else if (attached_interface && attached_interface.mode() == Type::Interface::MODE_ROAMING) {
+		path_time = ROAMING_PATH_TIME;
+	}
+	// first whole second at which the path has expired
+	return destination_entry._timestamp + path_time + 1;
+}
+
+// CBA Timers can't be cancelled, so a path keeps one timer: a new one is only scheduled when
+// the path has none or its deadline moved earlier (expired, or now on a shorter-lived
+// interface). A later deadline is picked up when the standing timer fires.
+/*static*/ void Transport::schedule_path(const Bytes& destination_hash, DestinationEntry& destination_entry) {
+	uint32_t deadline = path_deadline(destination_entry);
+	if (destination_entry._cull_at != 0 && destination_entry._cull_at <= deadline) {
+		return;
+	}
+	destination_entry._cull_at = deadline;
+	_instance->_path_timers.schedule(destination_hash, deadline);
+}
+
+// CBA Compares the time an MTU sized packet takes over each first hop, by the interfaces'
+// measured throughput and RTT (configured bitrate until measured). Only interfaces that keep
+// their online state can hold on to a path, so a dead link never blocks the replacement.
+/*static*/ bool Transport::prefer_current_path(const DestinationEntry& destination_entry, const Interface& candidate) {
+	const Interface current = destination_entry.receiving_interface();
+	if (!current || !candidate || current == candidate || !current.online()) {
+		return false;
+	}
+	double current_time = current.transfer_time(Type::Reticulum::MTU);
+	double candidate_time = candidate.transfer_time(Type::Reticulum::MTU);
+	if (current_time <= 0.0 || candidate_time <= 0.0) {
+		return false;
+	}
+	return (candidate_time > current_time * PATH_COST_MARGIN);
+}
+
+// CBA Paths form a doubly-linked list through their keys, newest first. Timestamps only ever
+// move to now (or to 0 when expired, which moves the path to the oldest end), so the list is
+// in timestamp order: cull_path_table() pops from the oldest end and write_path_table() walks
+// from the newest end, neither scans nor sorts the table. Neighbours are looked up const so
+// relinking doesn't refresh their LRU stamps.
+/*static*/ Transport::DestinationEntry* Transport::find_path_entry(const Bytes& destination_hash) {
+	const auto& destination_table = _instance->_destination_table;
+	auto iter = destination_table.find(destination_hash);
+	return (iter != destination_table.end()) ? const_cast<DestinationEntry*>(&(*iter).second) : nullptr;
+}
+
+/*static*/ void Transport::link_path(const Bytes& destination_hash, DestinationEntry& destination_entry, bool newest /*= true*/) {
+	++_instance->_path_table_epoch;
+	Bytes& end = newest ? _instance->_newest_path : _instance->_oldest_path;
+	DestinationEntry* neighbour = end ? find_path_entry(end) : nullptr;
+	if (neighbour == nullptr) {
+		// empty list
+		destination_entry._newer.clear();
+		destination_entry._older.clear();
+		_instance->_newest_path = destination_hash;
+		_instance->_oldest_path = destination_hash;
+		return;
+	}
+	if (newest) {
+		destination_entry._newer.clear();
+		destination_entry._older = end;
+		neighbour->_newer = destination_hash;
+	}
+	else {
+		destination_entry._older.clear();
+		destination_entry._newer = end;
+		neighbour->_older = destination_hash;
+	}
+	end = destination_hash;
+}
+
+/*static*/ void Transport::unlink_path(const Bytes& destination_hash, DestinationEntry& destination_entry) {
+	if (!destination_entry._newer && !destination_entry._older && _instance->_newest_path != destination_hash) {
+		// not in the list
+		return;
+	}
+	++_instance->_path_table_epoch;
+	if (destination_entry._newer) {
+		DestinationEntry* newer = find_path_entry(destination_entry._newer);
+		if (newer) newer->_older = destination_entry._older;
+	}
+	else {
+		_instance->_newest_path = destination_entry._older;
+	}
+	if (destination_entry._older) {
+		DestinationEntry* older = find_path_entry(destination_entry._older);
+		if (older) older->_newer = destination_entry._newer;
+	}
+	else {
+		_instance->_oldest_path = destination_entry._newer;
+	}
+	destination_entry._newer.clear();
+	destination_entry._older.clear();
+}
+
+/*static*/ void Transport::touch_path(const Bytes& destination_hash, DestinationEntry& destination_entry) {
+	destination_entry._timestamp = OS::seconds();
+	// forwarding to the same destination again finds it at the front already
+	if (_instance->_newest_path == destination_hash) {
+		++_instance->_path_table_epoch;
+		return;
+	}
+	unlink_path(destination_hash, destination_entry);
+	link_path(destination_hash, destination_entry);
+}
+
+/*static*/ uint32_t Transport::announce_deadline(const AnnounceEntry& announce_entry) {
+	return announce_entry._retransmit_timeout + 1;
+}
+
+// CBA Replaces any entry for destination_hash (Python dict assignment overwrites, where
+// insert() on an existing key would be a no-op) and schedules the entry's retransmit timer
+/*static*/ void Transport::insert_announce(const Bytes& destination_hash, const AnnounceEntry& announce_entry) {
+	_instance->_announce_table.erase(destination_hash);
+	_instance->_announce_table.insert({destination_hash, announce_entry});
+	_instance->_announce_timers.schedule(destination_hash, announce_deadline(announce_entry));
+}
+
+/*static*/ uint32_t Transport::reverse_deadline(const ReverseEntry& reverse_entry) {
+	return reverse_entry._timestamp + REVERSE_TIMEOUT + 1;
+}
+
+/*static*/ void Transport::schedule_receipt(const PacketReceipt& receipt) {
+	_instance->_receipt_timers.schedule(receipt, (uint32_t)receipt.timeout_at() + 1);
+}
+
+// Only removes the table entry if it still holds this receipt and not a newer one for the same packet
+/*static*/ void Transport::remove_receipt(const PacketReceipt& receipt) {
+	auto iter = _instance->_receipts.find(receipt.truncated_hash());
+	if (iter != _instance->_receipts.end() && (*iter).second == receipt) {
+		_instance->_receipts.erase(iter);
+	}
+}
+
+/*static*/ Interface Transport::find_interface_from_id(uint8_t interface_id) {
+	if (interface_id > 0 && interface_id <= Type::Transport::INTERFACES_MAXSIZE && _instance->_interfaces_by_id[interface_id - 1] != nullptr) {
+		return *_instance->_interfaces_by_id[interface_id - 1];
+	}
+	return {Type::NONE};
+}
+
+/*static*/ uint8_t Transport::interface_id_from_hash(const Bytes& interface_hash) {
+	auto iter = _instance->_interface_ids.find(interface_hash);
+	if (iter == _instance->_interface_ids.end()) {
+		return 0;
+	}
+	return (*iter).second;
+}
+
+/*static*/ Bytes Transport::interface_hash_from_id(uint8_t interface_id) {
+	Interface interface = find_interface_from_id(interface_id);
+	if (!interface) {
+		return {};
+	}
+	return interface.get_hash();
+}
+
 /*static*/ bool Transport::should_cache_packet(const Packet& packet) {
 	// TODO: Rework the caching system. It's currently
 	// not very useful to even cache Resource proofs,
@@ -3198,33 +3855,22 @@ Deregisters an announce handler.
 	return false;
 }
 
-// When caching packets to storage, they are written
-// exactly as they arrived over their interface. This
-// means that they have not had their hop count
-// increased yet! Take note of this when reading from
-// the packet cache.
+// When caching packets, they are kept exactly as they
+// arrived over their interface. This means that they
+// have not had their hop count increased yet! Take note
+// of this when reading from the packet cache.
 /*static*/ bool Transport::cache_packet(const Packet& packet, bool force_cache /*= false*/) {
 	TRACE("Checking to see if packet " + packet.get_hash().toHex() + " should be cached");
-#if defined(RNS_USE_FS) && defined(RNS_PERSIST_PATHS)
 	if (should_cache_packet(packet) || force_cache) {
-		TRACE("Saving packet " + packet.get_hash().toHex() + " to storage");
-		try {
-			char packet_cache_path[Type::Reticulum::FILEPATH_MAXSIZE];
-			snprintf(packet_cache_path, Type::Reticulum::FILEPATH_MAXSIZE, "%s/%s", Reticulum::_cachepath, packet.get_hash().toHex().c_str());
-			return (Persistence::serialize(packet, packet_cache_path) > 0);
-		}
-		catch (std::exception& e) {
-			ERROR("Error writing packet to cache. The contained exception was: " + std::string(e.what()));
-		}
+		TRACE("Caching packet " + packet.get_hash().toHex());
+		_instance->_packet_cache->insert(packet.get_hash(), packet.raw());
+		return true;
 	}
-#endif
 	return false;
 }
 
 /*static*/ Packet Transport::get_cached_packet(const Bytes& packet_hash) {
-	TRACE("Loading packet " + packet_hash.toHex() + " from cache storage");
-#if defined(RNS_USE_FS) && defined(RNS_PERSIST_PATHS)
-	try {
+	TRACE("Loading packet " + packet_hash.toHex() + " from cache");
 /*p
 		packet_hash = RNS.hexrep(packet_hash, delimit=False)
 		path = RNS.Reticulum.cachepath+"/"+packet_hash
@@ -3245,44 +3891,20 @@ Deregisters an announce handler.
 		else:
 			return None
 */
-		char packet_cache_path[Type::Reticulum::FILEPATH_MAXSIZE];
-		snprintf(packet_cache_path, Type::Reticulum::FILEPATH_MAXSIZE, "%s/%s", Reticulum::_cachepath, packet_hash.toHex().c_str());
-		Packet packet({Type::NONE});
-		if (Persistence::deserialize(packet, packet_cache_path) > 0) {
-			packet.unpack();
-		}
-		return packet;
-	}
-	catch (std::exception& e) {
-		ERROR("Exception occurred while getting cached packet.");
-		ERRORF("The contained exception was: %s", e.what());
+	// CBA Frames are served from RAM, or from the spill file once pushed out of RAM
+	Bytes raw;
+	if (!_instance->_packet_cache->get(packet_hash, raw)) {
+		return {Type::NONE};
 	}
-#endif
-	return {Type::NONE};
+	Packet packet(Destination(Type::NONE), raw);
+	packet.cached(true);
+	packet.unpack();
+	return packet;
 }
 
 /*static*/ bool Transport::clear_cached_packet(const Bytes& packet_hash) {
-	TRACE("Clearing packet " + packet_hash.toHex() + " from cache storage");
-#if defined(RNS_USE_FS) && defined(RNS_PERSIST_PATHS)
-	try {
-		char packet_cache_path[Type::Reticulum::FILEPATH_MAXSIZE];
-		snprintf(packet_cache_path, Type::Reticulum::FILEPATH_MAXSIZE, "%s/%s", Reticulum::_cachepath, packet_hash.toHex().c_str());
-		double start_time = OS::time();
-		bool success = RNS::Utilities::OS::remove_file(packet_cache_path);
-		double diff_time = OS::time() - start_time;
-		if (diff_time < 1.0) {
-			DEBUG("Remove cached packet in " + std::to_string((int)(diff_time*1000)) + " ms");
-		}
-		else {
-			DEBUG("Remove cached packet in " + std::to_string(diff_time) + " s");
-		}
-	}
-	catch (std::exception& e) {
-		ERROR("Exception occurred while clearing cached packet.");
-		ERRORF("The contained exception was: %s", e.what());
-	}
-#endif
-	return false;
+	TRACE("Clearing packet " + packet_hash.toHex() + " from cache");
+	return _instance->_packet_cache->erase(packet_hash);
 }
 
 /*static*/ bool Transport::cache_request_packet(const Packet& packet) {
@@ -3321,11 +3943,28 @@ Deregisters an announce handler.
 	}
 }
 
+// CBA Same as above for packets on a link, such as resource proofs
+/*static*/ void Transport::cache_request(const Bytes& packet_hash, const Link& link) {
+	const Packet& cached_packet = get_cached_packet(packet_hash);
+	if (cached_packet) {
+		inbound(cached_packet.raw(), cached_packet.receiving_interface());
+	}
+	else {
+		Packet request(link, packet_hash, Type::Packet::DATA, Type::Packet::CACHE_REQUEST);
+		request.send();
+	}
+}
+
 /*static*/ bool Transport::remove_path(const Bytes& destination_hash) {
-	if (_destination_table.erase(destination_hash) > 0) {
-		// CBA also remove cached announce packet if exists
+	auto iter = _instance->_destination_table.find(destination_hash);
+	if (iter == _instance->_destination_table.end()) {
+		return false;
 	}
-	return false;
+	unlink_path(destination_hash, (*iter).second);
+	// CBA also remove cached announce packet
+	_instance->_packet_cache->erase((*iter).second._announce_packet);
+	_instance->_destination_table.erase(iter);
+	return true;
 }
 
 /*
@@ -3333,7 +3972,7 @@ Deregisters an announce handler.
 :returns: *True* if a path to the destination is known, otherwise *False*.
 */
 /*static*/ bool Transport::has_path(const Bytes& destination_hash) {
-	if (_destination_table.find(destination_hash) != _destination_table.end()) {
+	if (_instance->_destination_table.find(destination_hash) != _instance->_destination_table.end()) {
 		return true;
 	}
 	else {
@@ -3346,8 +3985,8 @@ Deregisters an announce handler.
 :returns: The number of hops to the specified destination, or ``RNS.Transport.PATHFINDER_M`` if the number of hops is unknown.
 */
 /*static*/ uint8_t Transport::hops_to(const Bytes& destination_hash) {
-	auto iter = _destination_table.find(destination_hash);
-	if (iter != _destination_table.end()) {
+	auto iter = _instance->_destination_table.find(destination_hash);
+	if (iter != _instance->_destination_table.end()) {
 		DestinationEntry destination_entry = (*iter).second;
 		return destination_entry._hops;
 	}
@@ -3361,8 +4000,8 @@ Deregisters an announce handler.
 :returns: The destination hash as *bytes* for the next hop to the specified destination, or *None* if the next hop is unknown.
 */
 /*static*/ Bytes Transport::next_hop(const Bytes& destination_hash) {
-	auto iter = _destination_table.find(destination_hash);
-	if (iter != _destination_table.end()) {
+	auto iter = _instance->_destination_table.find(destination_hash);
+	if (iter != _instance->_destination_table.end()) {
 		DestinationEntry destination_entry = (*iter).second;
 		return destination_entry._received_from;
 	}
@@ -3376,20 +4015,21 @@ Deregisters an announce handler.
 :returns: The interface for the next hop to the specified destination, or *None* if the interface is unknown.
 */
 /*static*/ Interface Transport::next_hop_interface(const Bytes& destination_hash) {
-	auto iter = _destination_table.find(destination_hash);
-	if (iter != _destination_table.end()) {
-		DestinationEntry destination_entry = (*iter).second;
-		return destination_entry.receiving_interface();
+	// CBA The entry is only looked at, a copy would duplicate its random blobs and hashes
+	const DestinationEntry* destination_entry = find_path_entry(destination_hash);
+	if (destination_entry != nullptr) {
+		return destination_entry->receiving_interface();
 	}
 	else {
 		return {Type::NONE};
 	}
 }
 
+// CBA Measured throughput of the next hop once its interface has sampled one
 /*static*/ uint32_t Transport::next_hop_interface_bitrate(const Bytes& destination_hash) {
 	const Interface& interface = next_hop_interface(destination_hash);
 	if (interface) {
-		return interface.bitrate();
+		return interface.effective_bitrate();
 	}
 	else {
 		return 0;
@@ -3427,19 +4067,31 @@ Deregisters an announce handler.
 	}
 }
 
+/*static*/ double Transport::next_hop_rtt(const Bytes& destination_hash) {
+	const Interface& interface = next_hop_interface(destination_hash);
+	if (interface) {
+		return interface.rtt();
+	}
+	else {
+		return 0.0;
+	}
+}
+
 /*static*/ double Transport::first_hop_timeout(const Bytes& destination_hash) {
 	double latency = next_hop_per_byte_latency(destination_hash);
+	// CBA 0 until the next hop interface has measured its round trip
+	double rtt = next_hop_rtt(destination_hash);
 	if (latency > 0.0) {
-		return RNS::Type::Reticulum::MTU * latency + RNS::Type::Reticulum::DEFAULT_PER_HOP_TIMEOUT;
+		return RNS::Type::Reticulum::MTU * latency + rtt + RNS::Type::Reticulum::DEFAULT_PER_HOP_TIMEOUT;
 	}
 	else {
-		return RNS::Type::Reticulum::DEFAULT_PER_HOP_TIMEOUT;
+		return rtt + RNS::Type::Reticulum::DEFAULT_PER_HOP_TIMEOUT;
 	}
 }
 
 /*static*/ double Transport::extra_link_proof_timeout(const Interface& interface) {
-	if (interface) {
-		return ((1.0/(double)interface.bitrate())*8.0)*RNS::Type::Reticulum::MTU;
+	if (interface && interface.effective_bitrate() > 0) {
+		return ((1.0/(double)interface.effective_bitrate())*8.0)*RNS::Type::Reticulum::MTU;
 	}
 	else {
 		return 0.0;
@@ -3447,11 +4099,14 @@ Deregisters an announce handler.
 }
 
 /*static*/ bool Transport::expire_path(const Bytes& destination_hash) {
-	auto iter = _destination_table.find(destination_hash);
-	if (iter != _destination_table.end()) {
-		DestinationEntry destination_entry = (*iter).second;
+	auto iter = _instance->_destination_table.find(destination_hash);
+	if (iter != _instance->_destination_table.end()) {
+		DestinationEntry& destination_entry = (*iter).second;
 		destination_entry._timestamp = 0;
-		_tables_last_culled = 0;
+		unlink_path(destination_hash, destination_entry);
+		link_path(destination_hash, destination_entry, false);
+		schedule_path(destination_hash, destination_entry);
+		_instance->_jobs[JOB_PATH_CULL].trigger();
 		return true;
 	}
 	else {
@@ -3515,7 +4170,7 @@ will announce it.
 
 	Bytes path_request_data;
 	if (Reticulum::transport_enabled()) {
-		path_request_data = destination_hash + _identity.hash() + request_tag;
+		path_request_data = destination_hash + _instance->_identity.hash() + request_tag;
 	}
 	else {
 		path_request_data = destination_hash + request_tag;
@@ -3543,31 +4198,67 @@ will announce it.
 			return;
 		}
 		else {
-			double now = OS::time();
-			if (now < on_interface.announce_allowed_at()) {
+			//p tx_time   = ((len(path_request_data)+RNS.Reticulum.HEADER_MINSIZE)*8) / on_interface.bitrate
+			// CBA Recursive path requests draw on the same announce bandwidth as announces
+			if (!const_cast<Interface&>(on_interface).announce_spend(path_request_data.size() + Type::Reticulum::HEADER_MINSIZE)) {
 				TRACE("Blocking recursive path request on " + on_interface.toString() + " due to active announce cap");
 				return;
 			}
-			else {
-				//p tx_time   = ((len(path_request_data)+RNS.Reticulum.HEADER_MINSIZE)*8) / on_interface.bitrate
-				uint32_t wait_time = 0;
-				if ( on_interface.bitrate() > 0 && on_interface.announce_cap() > 0) {
-					uint32_t tx_time = ((path_request_data.size() + Type::Reticulum::HEADER_MINSIZE)*8) / on_interface.bitrate();
-					wait_time = (tx_time / on_interface.announce_cap());
-				}
-				const_cast<Interface&>(on_interface).announce_allowed_at(now + wait_time);
-			}
 		}
 	}
 
 	packet.send();
-	_path_requests[destination_hash] = OS::time();
+	_instance->_path_requests[destination_hash] = OS::seconds();
 }
 
 /*static*/ void Transport::request_path(const Bytes& destination_hash) {
+	_instance->_announce_filter.requested(destination_hash);
 	return request_path(destination_hash, {Type::NONE});
 }
 
+// CBA True if a path response for destination_hash is waiting in the announce table for
+// interface, or was sent on it less than PATH_REQUEST_COALESCE seconds ago
+/*static*/ bool Transport::path_response_pending(const Bytes& destination_hash, const Interface& interface) {
+	auto announce_iter = _instance->_announce_table.find(destination_hash);
+	if (announce_iter != _instance->_announce_table.end()) {
+		const AnnounceEntry& announce_entry = (*announce_iter).second;
+		if (announce_entry._block_rebroadcasts && announce_entry._retries <= Type::Transport::PATHFINDER_R && announce_entry._attached_interface == interface) {
+			return true;
+		}
+	}
+	auto response_iter = _instance->_path_responses.find(destination_hash);
+	if (response_iter != _instance->_path_responses.end()) {
+		const PathResponseEntry& response_entry = (*response_iter).second;
+		if (OS::seconds() - response_entry._timestamp < Type::Transport::PATH_REQUEST_COALESCE && response_entry._interface_hash == interface.get_hash()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*static*/ void Transport::path_response_sent(const Bytes& destination_hash, const Interface& interface) {
+	PathResponseEntry& response_entry = _instance->_path_responses[destination_hash];
+	response_entry._timestamp = OS::seconds();
+	response_entry._interface_hash = interface.get_hash();
+}
+
+// CBA Announces for destinations reached over the backbone must pass the announce filter rules
+/*static*/ bool Transport::filter_announce(const Packet& packet) {
+	if (_instance->_announce_filter.empty() || packet.hops() == 0) {
+		return true;
+	}
+	auto iter = _instance->_destination_table.find(packet.destination_hash());
+	if (iter == _instance->_destination_table.end()) {
+		return true;
+	}
+	const DestinationEntry& destination_entry = (*iter).second;
+	const Interface& receiving_interface = destination_entry.receiving_interface();
+	if (!receiving_interface || !is_backbone_interface(receiving_interface)) {
+		return true;
+	}
+	return _instance->_announce_filter.allow(packet.destination_hash(), packet.data(), packet.hops(), destination_entry._received_from);
+}
+
 /*static*/ void Transport::path_request_handler(const Bytes& data, const Packet& packet) {
 	TRACE("Transport::path_request_handler");
 	if (data.size() >= 16) { DEBUG("DIAG: PATH-REQ for " + data.left(16).toHex().substr(0,8) + " from " + packet.receiving_interface().toString()); }
@@ -3605,9 +4296,9 @@ will announce it.
 				Bytes unique_tag = destination_hash + tag_bytes;
 				//TRACE("Transport::path_request_handler: unique_tag: " + unique_tag.toHex());
 
-				if (_discovery_pr_tags.find(unique_tag) == _discovery_pr_tags.end()) {
+				if (_instance->_discovery_pr_tags.find(unique_tag) == _instance->_discovery_pr_tags.end()) {
 					// CBA ACCUMULATES
-					_discovery_pr_tags.insert(unique_tag);
+					_instance->_discovery_pr_tags.insert(unique_tag);
 
 					path_request(
 						destination_hash,
@@ -3647,16 +4338,23 @@ will announce it.
 
 	DEBUG("Path request for destination " + destination_hash.toHex() + interface_str);
 
+	if (attached_interface && !is_backbone_interface(attached_interface)) {
+		_instance->_announce_filter.requested(destination_hash);
+		if (Reticulum::transport_enabled() && !is_from_local_client) {
+			record_path_request(destination_hash);
+		}
+	}
+
 	bool destination_exists_on_local_client = false;
-	if (_local_client_interfaces.size() > 0) {
-		auto iter = _destination_table.find(destination_hash);
-		if (iter != _destination_table.end()) {
+	if (_instance->_local_client_interfaces.size() > 0) {
+		auto iter = _instance->_destination_table.find(destination_hash);
+		if (iter != _instance->_destination_table.end()) {
 			TRACE("Transport::path_request_handler: entry found for destination " + destination_hash.toHex());
 			DestinationEntry& destination_entry = (*iter).second;
 			if (is_local_client_interface(destination_entry.receiving_interface())) {
 				destination_exists_on_local_client = true;
 				// CBA ACCUMULATES
-				_pending_local_path_requests.insert({destination_hash, attached_interface});
+				_instance->_pending_local_path_requests.insert({destination_hash, attached_interface});
 			}
 		}
 		else {
@@ -3664,11 +4362,11 @@ will announce it.
 		}
 	}
 
-	auto destination_iter = _destination_table.find(destination_hash);
+	auto destination_iter = _instance->_destination_table.find(destination_hash);
 	//local_destination = next((d for d in Transport.destinations if d.hash == destination_hash), None)
 #if defined(DESTINATIONS_SET)
 	Destination local_destination({Type::NONE});
-	for (auto& destination : _destinations) {
+	for (auto& destination : _instance->_destinations) {
 		if (destination.hash() == destination_hash) {
 			local_destination = destination;
 			break;
@@ -3677,15 +4375,15 @@ will announce it.
     //if local_destination != None:
 	if (local_destination) {
 #elif defined(DESTINATIONS_MAP)
-	auto iter = _destinations.find(destination_hash);
-	if (iter != _destinations.end()) {
+	auto iter = _instance->_destinations.find(destination_hash);
+	if (iter != _instance->_destinations.end()) {
 		auto& local_destination = (*iter).second;
 #endif
 		local_destination.announce({Bytes::NONE}, true, attached_interface, tag);
 		DEBUG("Answering path request for destination " + destination_hash.toHex() + interface_str + ", destination is local to this system");
 	}
     //p elif (RNS.Reticulum.transport_enabled() or is_from_local_client) and (destination_hash in Transport.destination_table):
-	else if ((Reticulum::transport_enabled() || is_from_local_client) && destination_iter != _destination_table.end()) {
+	else if ((Reticulum::transport_enabled() || is_from_local_client) && destination_iter != _instance->_destination_table.end()) {
 		TRACE("Transport::path_request_handler: entry found for destination " + destination_hash.toHex());
 		DestinationEntry& destination_entry = (*destination_iter).second;
 		const Packet& announce_packet = destination_entry.announce_packet();
@@ -3705,11 +4403,16 @@ will announce it.
 				// convergence time. Maybe just drop it?
 				DEBUG("Not answering path request for destination " + destination_hash.toHex() + interface_str + ", since next hop is the requestor");
 			}
+			else if (!is_from_local_client && attached_interface && path_response_pending(destination_hash, attached_interface)) {
+				// CBA Everyone on the interface hears the one pending or just sent response
+				++_instance->_path_requests_coalesced;
+				DEBUG("Coalescing path request for destination " + destination_hash.toHex() + interface_str + ", a path response was already sent or is pending");
+			}
 			else {
 				DEBUG("Answering path request for destination " + destination_hash.toHex() + interface_str + ", path is known");
 				DEBUG("DIAG: PATH-RESP for " + destination_hash.toHex().substr(0,8) + interface_str);
 
-				double now = OS::time();
+				uint32_t now = OS::seconds();
 				uint8_t retries = Type::Transport::PATHFINDER_R;
 				uint8_t local_rebroadcasts = 0;
 				bool block_rebroadcasts = true;
@@ -3723,13 +4426,14 @@ will announce it.
 				// LRPROOF hop-count validation to fail silently.
 				uint8_t announce_hops = destination_entry._hops;
 
-				double retransmit_timeout = 0;
+				// CBA Announce retransmit times are in ms of OS::ticks()
+				uint32_t retransmit_timeout = 0;
 				if (is_from_local_client) {
-					retransmit_timeout = now;
+					retransmit_timeout = OS::ticks();
 				}
 				else {
 					// TODO: Look at this timing
-					retransmit_timeout = now + Type::Transport::PATH_REQUEST_GRACE /*+ (RNS.rand() * Transport.PATHFINDER_RW)*/;
+					retransmit_timeout = OS::ticks() + (uint32_t)(Type::Transport::PATH_REQUEST_GRACE * 1000) /*+ (RNS.rand() * Transport.PATHFINDER_RW)*/;
 				}
 
 				// This handles an edge case where a peer sends a past
@@ -3738,30 +4442,33 @@ will announce it.
 				// rebroadcast locally. In such a case the actual announce
 				// is temporarily held, and then reinserted when the path
 				// request has been served to the peer.
-				auto announce_iter = _announce_table.find(announce_packet.destination_hash());
-				if (announce_iter != _announce_table.end()) {
+				auto announce_iter = _instance->_announce_table.find(announce_packet.destination_hash());
+				if (announce_iter != _instance->_announce_table.end()) {
 					AnnounceEntry& held_entry = (*announce_iter).second;
 					// CBA ACCUMULATES
-					_held_announces.insert({announce_packet.destination_hash(), held_entry});
+					_instance->_held_announces.insert({announce_packet.destination_hash(), held_entry});
 					// BUG FIX: Must erase old entry before insert(),
 					// since std::map::insert() is a no-op when key exists.
 					// Python dict assignment overwrites, but C++ insert does not.
-					_announce_table.erase(announce_iter);
+					_instance->_announce_table.erase(announce_iter);
 				}
 
-				AnnounceEntry announce_entry(
-					now,
-					retransmit_timeout,
-					retries,
-					destination_entry._received_from,
-					announce_hops,
-					announce_packet,
-					local_rebroadcasts,
-					block_rebroadcasts,
-					attached_interface
-				);
-				// CBA ACCUMULATES
-				_announce_table.insert({announce_packet.destination_hash(), announce_entry});
+				{
+					RNS_ALLOC_SCOPE(TAG_ANNOUNCE_TABLE);
+					AnnounceEntry announce_entry(
+						now,
+						retransmit_timeout,
+						retries,
+						destination_entry._received_from,
+						announce_hops,
+						announce_packet,
+						local_rebroadcasts,
+						block_rebroadcasts,
+						attached_interface
+					);
+					// CBA ACCUMULATES
+					insert_announce(announce_packet.destination_hash(), announce_entry);
+				}
 
 				// ESP32 FIX: For requests from local clients, send the
 				// PATH_RESPONSE immediately rather than waiting for the
@@ -3780,7 +4487,7 @@ will announce it.
 							Type::Packet::PATH_RESPONSE,
 							Type::Transport::TRANSPORT,
 							Type::Packet::HEADER_2,
-							_identity.hash(),
+							_instance->_identity.hash(),
 							true,
 							announce_packet.context_flag()
 						);
@@ -3789,7 +4496,7 @@ will announce it.
 						DEBUG("DIAG: PATH-RESP immediate send for " + announce_packet.destination_hash().toHex().substr(0,8) + " hops=" + std::to_string(announce_hops) + " to " + attached_interface.toString());
 
 						// Remove from announce_table since we already sent it
-						_announce_table.erase(announce_packet.destination_hash());
+						_instance->_announce_table.erase(announce_packet.destination_hash());
 					}
 				}
 			}
@@ -3801,11 +4508,11 @@ will announce it.
 		DEBUG("Forwarding path request from local client for destination " + destination_hash.toHex() + interface_str + " to all other interfaces");
 		Bytes request_tag = Identity::get_random_hash();
 #if defined(INTERFACES_SET)
-		for (const Interface& interface : _interfaces) {
+		for (const Interface& interface : _instance->_interfaces) {
 #elif defined(INTERFACES_LIST)
-		for (Interface& interface : _interfaces) {
+		for (Interface& interface : _instance->_interfaces) {
 #elif defined(INTERFACES_MAP)
-		for (auto& [hash, interface] : _interfaces) {
+		for (auto& [hash, interface] : _instance->_interfaces) {
 #endif
 			if (interface != attached_interface) {
 				request_path(destination_hash, interface, request_tag);
@@ -3814,34 +4521,41 @@ will announce it.
 	}
 	else if (should_search_for_unknown) {
 		TRACE("Transport::path_request_handler: searching for unknown path to " + destination_hash.toHex());
-		if (_discovery_path_requests.find(destination_hash) != _discovery_path_requests.end()) {
+		auto pr_iter = _instance->_discovery_path_requests.find(destination_hash);
+		if (pr_iter != _instance->_discovery_path_requests.end()) {
 			DEBUG("There is already a waiting path request for destination " + destination_hash.toHex() + " on behalf of path request" + interface_str);
+			// CBA Coalesce into the waiting request, the answer goes to every interface that asked
+			PathRequestEntry& pr_entry = (*pr_iter).second;
+			++_instance->_path_requests_coalesced;
+			if (attached_interface && attached_interface != pr_entry._requesting_interface && std::find(pr_entry._coalesced_interfaces.begin(), pr_entry._coalesced_interfaces.end(), attached_interface) == pr_entry._coalesced_interfaces.end()) {
+				pr_entry._coalesced_interfaces.push_back(attached_interface);
+			}
 		}
 		else {
 			// Forward path request on all interfaces
 			// except the requestor interface
 			DEBUG("Attempting to discover unknown path to destination " + destination_hash.toHex() + " on behalf of path request" + interface_str);
 			//p pr_entry = { "destination_hash": destination_hash, "timeout": time.time()+Transport.PATH_REQUEST_TIMEOUT, "requesting_interface": attached_interface }
-			//p _discovery_path_requests[destination_hash] = pr_entry;
+			//p _instance->_discovery_path_requests[destination_hash] = pr_entry;
 			// CBA ACCUMULATES
-			_discovery_path_requests.insert({destination_hash, {
+			_instance->_discovery_path_requests.insert({destination_hash, {
 				destination_hash,
-				OS::time() + Type::Transport::PATH_REQUEST_TIMEOUT,
+				OS::seconds() + Type::Transport::PATH_REQUEST_TIMEOUT,
 				attached_interface
 			}});
 
 #if defined(BOUNDARY_MODE)
 			// BOUNDARY: Track this destination in Whitelist 2 so the path
 			// response announce from the backbone will be allowed through
-			_boundary_mentioned_addresses.insert(destination_hash);
+			_instance->_boundary_whitelist.insert(destination_hash, Utilities::Whitelist::CLASS_MENTIONED);
 #endif
 
 #if defined(INTERFACES_SET)
-			for (const Interface& interface : _interfaces) {
+			for (const Interface& interface : _instance->_interfaces) {
 #elif defined(INTERFACES_LIST)
-			for (Interface& interface : _interfaces) {
+			for (Interface& interface : _instance->_interfaces) {
 #elif defined(INTERFACES_MAP)
-			for (auto& [hash, interface] : _interfaces) {
+			for (auto& [hash, interface] : _instance->_interfaces) {
 #endif
 				// CBA EXPERIMENTAL forwarding path requests even on requestor interface in order to support
 				//  path-finding over LoRa mesh
@@ -3858,11 +4572,11 @@ will announce it.
 			}
 		}
 	}
-	else if (!is_from_local_client && _local_client_interfaces.size() > 0) {
+	else if (!is_from_local_client && _instance->_local_client_interfaces.size() > 0) {
 		// Forward the path request on all local
 		// client interfaces
 		DEBUG("Forwarding path request for destination " + destination_hash.toHex() + interface_str + " to local clients");
-		for (const Interface& interface : _local_client_interfaces) {
+		for (const Interface& interface : _instance->_local_client_interfaces) {
 			request_path(destination_hash, interface);
 		}
 	}
@@ -3989,7 +4703,37 @@ will announce it.
 
 /*static*/ void Transport::write_packet_hashlist() {
 #if defined(RNS_USE_FS) && defined(RNS_PERSIST_PATHS)
-// TODO
+	if (_instance->_owner->is_connected_to_shared_instance()) {
+		return;
+	}
+	// CBA Data is persisted every minute, but the hashlist is only worth the flash wear
+	// once per save interval since duplicates older than that are long gone from the mesh
+	if (OS::seconds() < (_instance->_hashlist_last_saved + _instance->_save_interval)) {
+		return;
+	}
+	_instance->_hashlist_last_saved = OS::seconds();
+	if (!Reticulum::transport_enabled()) {
+		_instance->_packet_hashlist.clear();
+	}
+	else {
+		DEBUG("Saving packet hashlist to storage...");
+	}
+	try {
+		uint32_t save_start = OS::ticks();
+		char packet_hashlist_path[Type::Reticulum::FILEPATH_MAXSIZE];
+		snprintf(packet_hashlist_path, Type::Reticulum::FILEPATH_MAXSIZE, "%s/packet_hashlist", Reticulum::_storagepath);
+		// raw fixed-size records, no serialization overhead
+		Bytes data = _instance->_packet_hashlist.serialize();
+		if (OS::write_file(packet_hashlist_path, data) == data.size()) {
+			DEBUGF("Saved %u packet hashes in %d ms", _instance->_packet_hashlist.size(), (int)OS::elapsed(save_start));
+		}
+		else {
+			ERROR("Could not save packet hashlist to storage, write failed");
+		}
+	}
+	catch (std::exception& e) {
+		ERRORF("Could not save packet hashlist to storage, the contained exception was: %s", e.what());
+	}
 /*p
 	if not Transport.owner.is_connected_to_shared_instance:
 		if hasattr(Transport, "saving_packet_hashlist"):
@@ -4035,10 +4779,15 @@ will announce it.
 
 /*static*/ bool Transport::read_path_table() {
 	DEBUG("Transport::read_path_table");
+	RNS_ALLOC_SCOPE(TAG_PATH_TABLE);
 #if defined(RNS_USE_FS) && defined(RNS_PERSIST_PATHS)
 	char destination_table_path[Type::Reticulum::FILEPATH_MAXSIZE];
-	snprintf(destination_table_path, Type::Reticulum::FILEPATH_MAXSIZE, "%s/destination_table", Reticulum::_storagepath);
-	if (!_owner.is_connected_to_shared_instance() && OS::file_exists(destination_table_path)) {
+	snprintf(destination_table_path, Type::Reticulum::FILEPATH_MAXSIZE, "%s/path_table", Reticulum::_storagepath);
+	// CBA Legacy JSON/MsgPack path table, only read if no binary path table exists yet
+	char legacy_table_path[Type::Reticulum::FILEPATH_MAXSIZE];
+	snprintf(legacy_table_path, Type::Reticulum::FILEPATH_MAXSIZE, "%s/destination_table", Reticulum::_storagepath);
+	bool binary_table = OS::file_exists(destination_table_path);
+	if (!_instance->_owner->is_connected_to_shared_instance() && (binary_table || OS::file_exists(legacy_table_path))) {
 /*p
 		serialised_destinations = []
 		try:
@@ -4076,6 +4825,8 @@ will announce it.
 */
 
 		try {
+			// CBA Persistence deals in std::map, entries are moved into the hash table after loading
+			std::map<Bytes, DestinationEntry> loaded_table;
 #if CUSTOM
 TRACEF("Transport::start: buffer capacity %d bytes", Persistence::_buffer.capacity());
 			if (RNS::Utilities::OS::read_file(destination_table_path, Persistence::_buffer) > 0) {
@@ -4095,16 +4846,37 @@ TRACEF("Transport::start: buffer size %d bytes", Persistence::_buffer.size());
 				TRACEF("Transport::start: doc size: %d bytes", Persistence::_buffer.size());
 				if (!error) {
 					// Calculate crc for dirty-checking before write
-					_destination_table_crc = Crc::crc32(0, Persistence::_buffer.data(), Persistence::_buffer.size());
-					_destination_table = Persistence::_document.as<std::map<Bytes, DestinationEntry>>();
+					_instance->_destination_table_crc = Crc::crc32(0, Persistence::_buffer.data(), Persistence::_buffer.size());
+					loaded_table = Persistence::_document.as<std::map<Bytes, DestinationEntry>>();
 #else	// CUSTOM
-				// Calculate crc for dirty-checking before write
-				if (Persistence::deserialize(_destination_table, destination_table_path, _destination_table_crc) > 0) {
+				size_t loaded = 0;
+				if (binary_table) {
+					loaded = _instance->_path_store->load(destination_table_path, loaded_table);
+				}
+				else if (Persistence::deserialize(loaded_table, legacy_table_path, _instance->_destination_table_crc) > 0) {
+					VERBOSE("Migrating legacy path table to binary format");
+					loaded = loaded_table.size();
+				}
+				if (loaded > 0) {
 #endif	// CUSTOM
 
-					TRACEF("Transport::start: successfully deserialized path table with %d entries", _destination_table.size());
+					// Insert oldest-first so that if the table capacity is exceeded its
+					// LRU eviction discards the oldest paths rather than arbitrary ones
+					std::vector<std::pair<Bytes, DestinationEntry>> loaded_entries(loaded_table.begin(), loaded_table.end());
+					loaded_table.clear();
+					std::sort(loaded_entries.begin(), loaded_entries.end(), [](const std::pair<Bytes, DestinationEntry>& a, const std::pair<Bytes, DestinationEntry>& b) {
+						return a.second._timestamp < b.second._timestamp;
+					});
+					_instance->_destination_table.clear();
+					_instance->_newest_path.clear();
+					_instance->_oldest_path.clear();
+					for (auto& entry : loaded_entries) {
+						_instance->_destination_table.insert({entry.first, std::move(entry.second)});
+					}
+
+					TRACEF("Transport::start: successfully deserialized path table with %d entries", _instance->_destination_table.size());
 					std::vector<Bytes> invalid_paths;
-					for (auto& [destination_hash, destination_entry] : _destination_table) {
+					for (auto& [destination_hash, destination_entry] : _instance->_destination_table) {
 #ifndef NDEBUG
 						TRACEF("Transport::start: entry: %s = %s", destination_hash.toHex().c_str(), destination_entry.debugString().c_str());
 #endif
@@ -4122,22 +4894,33 @@ TRACEF("Transport::start: buffer size %d bytes", Persistence::_buffer.size());
 						}
 					}
 					for (const auto& destination_hash : invalid_paths) {
-						_destination_table.erase(destination_hash);
+						_instance->_destination_table.erase(destination_hash);
+					}
+					// Link the survivors into the recency list, still in timestamp order
+					for (const auto& entry : loaded_entries) {
+						DestinationEntry* destination_entry = find_path_entry(entry.first);
+						if (destination_entry) {
+							link_path(entry.first, *destination_entry);
+						}
+					}
+
+					for (auto& [destination_hash, destination_entry] : _instance->_destination_table) {
+						schedule_path(destination_hash, destination_entry);
 					}
 
 					// Enforce maxsize on loaded paths (trim oldest if over limit)
-					if (_destination_table.size() > _path_table_maxsize) {
-						DEBUGF("Transport::start: trimming loaded path table from %d to %d entries", _destination_table.size(), _path_table_maxsize);
+					if (_instance->_destination_table.size() > _instance->_path_table_maxsize) {
+						DEBUGF("Transport::start: trimming loaded path table from %d to %d entries", _instance->_destination_table.size(), _instance->_path_table_maxsize);
 						cull_path_table();
 					}
 
 					// Memory diagnostic after path table load
 					size_t total_blobs = 0;
-					for (const auto& [hash, entry] : _destination_table) {
+					for (const auto& [hash, entry] : _instance->_destination_table) {
 						total_blobs += entry._random_blobs.size();
 					}
-					DEBUGF("Transport::start: path table: %d entries, %d total random_blobs (est. %d bytes)",
-						_destination_table.size(), total_blobs, total_blobs * 90);
+					DEBUGF("Transport::start: path table: %d entries, %d total random_blobs (%d bytes per entry)",
+						_instance->_destination_table.size(), total_blobs, sizeof(DestinationEntry));
 
 					return true;
 				}
@@ -4152,7 +4935,7 @@ TRACEF("Transport::start: buffer size %d bytes", Persistence::_buffer.size());
 #else	// CUSTOM
 #endif	// CUSTOM
 
-			VERBOSEF("Loaded %d valid path table entries from storage", _destination_table.size());
+			VERBOSEF("Loaded %d valid path table entries from storage", _instance->_destination_table.size());
 
 		}
 		catch (std::exception& e) {
@@ -4166,17 +4949,17 @@ TRACEF("Transport::start: buffer size %d bytes", Persistence::_buffer.size());
 /*static*/ bool Transport::write_path_table() {
 	DEBUG("Transport::write_path_table");
 
-	if (Transport::_owner.is_connected_to_shared_instance()) {
+	if (_instance->_owner->is_connected_to_shared_instance()) {
 		return true;
 	}
 
 	bool success = false;
 #if defined(RNS_USE_FS) && defined(RNS_PERSIST_PATHS)
-	if (_saving_path_table) {
+	if (_instance->_saving_path_table) {
 		double wait_interval = 0.2;
 		double wait_timeout = 5;
 		double wait_start = OS::time();
-		while (_saving_path_table) {
+		while (_instance->_saving_path_table) {
 			OS::sleep(wait_interval);
 			if (OS::time() > (wait_start + wait_timeout)) {
 				ERROR("Could not save path table to storage, waiting for previous save operation timed out.");
@@ -4185,27 +4968,34 @@ TRACEF("Transport::start: buffer size %d bytes", Persistence::_buffer.size());
 		}
 	}
 
+	// CBA Nothing was added, removed or touched since the last save, so there is nothing to serialize
+	if (_instance->_path_table_epoch == _instance->_path_table_saved_epoch) {
+		TRACE("Transport::write_path_table: path table unchanged since last save, skipping");
+		return true;
+	}
+
 	try {
-		_saving_path_table = true;
+		_instance->_saving_path_table = true;
 		double save_start = OS::time();
-		DEBUGF("Saving %d path table entries to storage...", _destination_table.size());
-
-		// Enforce maxpersist: create a trimmed copy for serialization
-		// keeping only the most recently used entries (by timestamp)
-		std::map<Bytes, DestinationEntry> persist_table;
-		if (_destination_table.size() <= _path_table_maxpersist) {
-			persist_table = _destination_table;
-		}
-		else {
-			// Sort by timestamp descending, keep only maxpersist entries
-			std::vector<std::pair<Bytes, DestinationEntry>> sorted_entries(_destination_table.begin(), _destination_table.end());
-			std::sort(sorted_entries.begin(), sorted_entries.end(), [](const std::pair<Bytes, DestinationEntry>& a, const std::pair<Bytes, DestinationEntry>& b) {
-				return a.second._timestamp > b.second._timestamp;
-			});
-			for (size_t i = 0; i < _path_table_maxpersist && i < sorted_entries.size(); i++) {
-				persist_table.insert(sorted_entries[i]);
+		// changes made while saving are picked up by the next save
+		uint32_t save_epoch = _instance->_path_table_epoch;
+		DEBUGF("Saving %d path table entries to storage...", _instance->_destination_table.size());
+
+		// Enforce maxpersist: only the most recently used entries (by timestamp)
+		// are persisted, found by timestamp cutoff walking the recency list from its newest end
+		double min_timestamp = 0.0;
+		if (_instance->_destination_table.size() > _instance->_path_table_maxpersist) {
+			min_timestamp = std::numeric_limits<double>::infinity();
+			Bytes destination_hash = _instance->_newest_path;
+			for (uint16_t kept = 0; kept < _instance->_path_table_maxpersist && destination_hash; kept++) {
+				const DestinationEntry* destination_entry = find_path_entry(destination_hash);
+				if (destination_entry == nullptr) {
+					break;
+				}
+				min_timestamp = destination_entry->_timestamp;
+				destination_hash = destination_entry->_older;
 			}
-			DEBUGF("Trimmed path table from %d to %d entries for persistence", _destination_table.size(), persist_table.size());
+			DEBUGF("Trimmed path table from %d to %d entries for persistence", _instance->_destination_table.size(), _instance->_path_table_maxpersist);
 		}
 
 /*p
@@ -4250,6 +5040,12 @@ TRACEF("Transport::start: buffer size %d bytes", Persistence::_buffer.size());
 */
 
 #if CUSTOM
+		std::map<Bytes, DestinationEntry> persist_table;
+		for (const auto& [destination_hash, destination_entry] : _instance->_destination_table) {
+			if (destination_entry._timestamp >= min_timestamp) {
+				persist_table.insert({destination_hash, destination_entry});
+			}
+		}
 		{
 			Persistence::_document.set(persist_table);
 			TRACEF("Transport::write_path_table: doc size %d bytes", Persistence::_document.memoryUsage());
@@ -4281,12 +5077,12 @@ TRACE("Transport::write_path_table: buffer size " + std::to_string(Persistence::
 #endif
 			// Check crc to see if data has changed before writing
 			uint32_t crc = Crc::crc32(0, Persistence::_buffer.data(), Persistence::_buffer.size());
-			if (_destination_table_crc > 0 && crc == _destination_table_crc) {
+			if (_instance->_destination_table_crc > 0 && crc == _instance->_destination_table_crc) {
 				TRACE("Transport::write_path_table: no change detected, skipping write");
 			}
 			else if (RNS::Utilities::OS::write_file(destination_table_path, Persistence::_buffer) == Persistence::_buffer.size()) {
-				TRACEF("Transport::write_path_table: wrote %d entries, %d bytes", _destination_table.size(), Persistence::_buffer.size());
-				_destination_table_crc = crc;
+				TRACEF("Transport::write_path_table: wrote %d entries, %d bytes", _instance->_destination_table.size(), Persistence::_buffer.size());
+				_instance->_destination_table_crc = crc;
 				success = true;
 
 #ifndef NDEBUG
@@ -4305,30 +5101,37 @@ TRACE("Transport::write_path_table: buffer size " + std::to_string(Persistence::
 			TRACE("Transport::write_path_table: failed to serialize");
 		}
 #else	// CUSTOM
-		uint32_t crc = Persistence::crc(persist_table);
-		if (_destination_table_crc > 0 && crc == _destination_table_crc) {
-			TRACE("Transport::write_path_table: no change detected, skipping write");
+		// CBA Announce packets of the persisted paths must be on flash as well
+		_instance->_packet_cache->flush();
+		// CBA Binary path table only appends records for paths that changed since the last save
+		char destination_table_path[Type::Reticulum::FILEPATH_MAXSIZE];
+		snprintf(destination_table_path, Type::Reticulum::FILEPATH_MAXSIZE, "%s/path_table", Reticulum::_storagepath);
+		if (_instance->_path_store->save(destination_table_path, _instance->_destination_table, min_timestamp)) {
+			TRACEF("Transport::write_path_table: %d paths in %d records", _instance->_path_store->size(), _instance->_path_store->records());
+			success = true;
+
+			// Legacy path table has been superseded
+			char legacy_table_path[Type::Reticulum::FILEPATH_MAXSIZE];
+			snprintf(legacy_table_path, Type::Reticulum::FILEPATH_MAXSIZE, "%s/destination_table", Reticulum::_storagepath);
+			if (OS::file_exists(legacy_table_path)) {
+				OS::remove_file(legacy_table_path);
+			}
 		}
 		else {
-			TRACE("Transport::write_path_table: change detected, writing...");
-			char destination_table_path[Type::Reticulum::FILEPATH_MAXSIZE];
-			snprintf(destination_table_path, Type::Reticulum::FILEPATH_MAXSIZE, "%s/destination_table", Reticulum::_storagepath);
-			if (Persistence::serialize(persist_table, destination_table_path, _destination_table_crc) > 0) {
-				TRACEF("Transport::write_path_table: wrote %d entries, %d bytes", persist_table.size(), Persistence::_buffer.size());
-				success = true;
-			}
+			TRACE("Transport::write_path_table: write failed");
 		}
 #endif	// CUSTOM
 
 		if (success) {
+			_instance->_path_table_saved_epoch = save_epoch;
 			double save_time = OS::time() - save_start;
 			if (save_time < 1.0) {
-				//DEBUG("Saved " + std::to_string(_destination_table.size()) + " path table entries in " + std::to_string(OS::round(save_time * 1000, 1)) + " ms");
-				DEBUGF("Saved %d path table entries in %d ms", _destination_table.size(), (int)(save_time*1000));
+				//DEBUG("Saved " + std::to_string(_instance->_destination_table.size()) + " path table entries in " + std::to_string(OS::round(save_time * 1000, 1)) + " ms");
+				DEBUGF("Saved %d path table entries in %d ms", _instance->_destination_table.size(), (int)(save_time*1000));
 			}
 			else {
-				//DEBUG("Saved " + std::to_string(_destination_table.size()) + " path table entries in " + std::to_string(OS::round(save_time, 1)) + " s");
-				DEBUGF("Saved %d path table entries in %d s", _destination_table.size(), save_time);
+				//DEBUG("Saved " + std::to_string(_instance->_destination_table.size()) + " path table entries in " + std::to_string(OS::round(save_time, 1)) + " s");
+				DEBUGF("Saved %d path table entries in %d s", _instance->_destination_table.size(), save_time);
 			}
 		}
 	}
@@ -4337,7 +5140,7 @@ TRACE("Transport::write_path_table: buffer size " + std::to_string(Persistence::
 	}
 #endif
 
-	_saving_path_table = false;
+	_instance->_saving_path_table = false;
 
 	return success;
 }
@@ -4489,101 +5292,106 @@ TRACE("Transport::write_path_table: buffer size " + std::to_string(Persistence::
 
 /*static*/ void Transport::clean_caches() {
 	TRACE("Transport::clean_caches()");
-#if defined(RNS_USE_FS) && defined(RNS_PERSIST_PATHS)
-	// CBA Remove cached packets no longer in path list
-	std::list<std::string> files = OS::list_directory(Reticulum::_cachepath);
-    for (auto& file : files) {
-		TRACE("Transport::clean_caches: Checking for use of cached packet " + file);
-		bool found = false;
-		for (auto& [destination_hash, destination_entry] : _destination_table) {
-			if (file.compare(destination_entry._announce_packet.toHex()) == 0) {
-				found = true;
-				break;
-			}
-		}
-		if (!found) {
-			TRACE("Transport::clean_caches: No matching path found, removing cached packet " + file);
-			char packet_cache_path[Type::Reticulum::FILEPATH_MAXSIZE];
-			snprintf(packet_cache_path, Type::Reticulum::FILEPATH_MAXSIZE, "%s/%s", Reticulum::_cachepath, file.c_str());
-			OS::remove_file(packet_cache_path);
-		}
+	// CBA Drop cached packets no longer referenced by a path, one pass over each table
+	HashTable<uint8_t> referenced(_instance->_destination_table.size() + 1);
+	for (const auto& [destination_hash, destination_entry] : _instance->_destination_table) {
+		referenced.insert({destination_entry._announce_packet, 0});
+	}
+	size_t dropped = _instance->_packet_cache->retain([&referenced](const Bytes& packet_hash) {
+		return referenced.contains(packet_hash);
+	});
+	if (dropped > 0) {
+		TRACEF("Transport::clean_caches: removed %u unreferenced cached packets", dropped);
 	}
-#endif
 }
 
 /*static*/ void Transport::dump_stats() {
 
 	OS::dump_heap_stats();
+#if defined(RNS_USE_POOLS)
+	Packet::dump_pool_stats();
+#endif
+	_instance->_announce_filter.dump_stats();
 
 	size_t memory = OS::heap_available();
 	size_t flash = OS::storage_available();
 
-	if (_last_memory == 0) {
-		_last_memory = memory;
+	if (_instance->_last_memory == 0) {
+		_instance->_last_memory = memory;
 	}
-	if (_last_flash == 0) {
-		_last_flash = flash;
+	if (_instance->_last_flash == 0) {
+		_instance->_last_flash = flash;
 	}
 
 	// memory
 	// storage
-	// _destinations
-	// _destination_table
-	// _reverse_table
-	// _announce_table
-	// _held_announces
-	HEADF(LOG_VERBOSE, "mem: %u (%u%%) [%d] flash: %u (%u%%) [%d] paths: %u dsts: %u revr: %u annc: %u held: %u", memory, (int)((double)memory / (double)OS::heap_size() * 100.0), memory - _last_memory, flash, (int)((double)flash / (double)OS::storage_size() * 100.0), flash - _last_flash, _destination_table.size(), _destinations.size(), _reverse_table.size(), _announce_table.size(), _held_announces.size());
-
-	// _path_requests
-	// _discovery_path_requests
-	// _pending_local_path_requests
-	// _discovery_pr_tags
-	// _control_destinations
-	// _control_hashes
-	VERBOSEF("preqs: %u dpreqs: %u ppreqs: %u dprt: %u cdsts: %u chshs: %u", _path_requests.size(), _discovery_path_requests.size(), _pending_local_path_requests.size(), _discovery_pr_tags.size(), _control_destinations.size(), _control_hashes.size());
-
-	// _packet_hashlist
-	// _receipts
-	// _link_table
-	// _pending_links
-	// _active_links
-	// _tunnels
+	// _instance->_destinations
+	// _instance->_destination_table
+	// _instance->_reverse_table
+	// _instance->_announce_table
+	// _instance->_held_announces
+	HEADF(LOG_VERBOSE, "mem: %u (%u%%) [%d] flash: %u (%u%%) [%d] paths: %u dsts: %u revr: %u annc: %u held: %u", memory, (int)((double)memory / (double)OS::heap_size() * 100.0), memory - _instance->_last_memory, flash, (int)((double)flash / (double)OS::storage_size() * 100.0), flash - _instance->_last_flash, _instance->_destination_table.size(), _instance->_destinations.size(), _instance->_reverse_table.size(), _instance->_announce_table.size(), _instance->_held_announces.size());
+
+	// _instance->_path_requests
+	// _instance->_discovery_path_requests
+	// _instance->_pending_local_path_requests
+	// _instance->_discovery_pr_tags
+	// _instance->_control_destinations
+	// _instance->_control_hashes
+	VERBOSEF("preqs: %u dpreqs: %u ppreqs: %u dprt: %u cdsts: %u chshs: %u", _instance->_path_requests.size(), _instance->_discovery_path_requests.size(), _instance->_pending_local_path_requests.size(), _instance->_discovery_pr_tags.size(), _instance->_control_destinations.size(), _instance->_control_hashes.size());
+	VERBOSEF("presp: %u coalesced: %u fast: %u", _instance->_path_responses.size(), _instance->_path_requests_coalesced, _instance->_packets_fast_forwarded);
+	VERBOSEF("heat: %u warmed: %u promoted: %u", _instance->_path_heat_table.size(), _instance->_paths_warmed, _instance->_path_announces_promoted);
+	VERBOSEF("prefilter ifac: %u short: %u scope: %u dup: %u blocked: %u", _instance->_prefilter_rejects[PREFILTER_IFAC], _instance->_prefilter_rejects[PREFILTER_MALFORMED], _instance->_prefilter_rejects[PREFILTER_SCOPE], _instance->_prefilter_rejects[PREFILTER_DUPLICATE], _instance->_prefilter_rejects[PREFILTER_BLOCKED]);
+	VERBOSEF("timers paths: %u revr: %u rcpts: %u", _instance->_path_timers.size(), _instance->_reverse_timers.size(), _instance->_receipt_timers.size());
+	VERBOSEF("annc verified: %u cached: %u queued: %u shed: %u", Identity::announces_verified(), Identity::announces_cached(), _instance->_announces_queued, _instance->_announces_shed);
+	VERBOSEF("keypool x25519: %u (%u/%u) ed25519: %u (%u/%u)", Cryptography::X25519KeyPool::size(), Cryptography::X25519KeyPool::hits(), Cryptography::X25519KeyPool::misses(), Cryptography::Ed25519KeyPool::size(), Cryptography::Ed25519KeyPool::hits(), Cryptography::Ed25519KeyPool::misses());
+
+	// _instance->_packet_hashlist
+	// _instance->_receipts
+	// _instance->_link_table
+	// _instance->_pending_links
+	// _instance->_active_links
+	// _instance->_tunnels
 	uint32_t destination_path_responses = 0;
-	for (auto& [destination_hash, destination] : _destinations) {
+	for (auto& [destination_hash, destination] : _instance->_destinations) {
 		destination_path_responses += destination.path_responses().size();
 	}
 	uint32_t interface_announces = 0;
-	for (auto& [interface_hash, interface] : _interfaces) {
+	for (auto& [interface_hash, interface] : _instance->_interfaces) {
 		interface_announces += interface.announce_queue().size();
 	}
-	VERBOSEF("phl: %u rcp: %u lt: %u pl: %u al: %u tun: %u", _packet_hashlist.size(), _receipts.size(), _link_table.size(), _pending_links.size(), _active_links.size(), _tunnels.size());
-	VERBOSEF("bla: %u bma: %u", _boundary_local_addresses.size(), _boundary_mentioned_addresses.size());
-	VERBOSEF("pin: %u pout: %u padd: %u dpr: %u ikd: %u ia: %u\r\n", _packets_received, _packets_sent, _destinations_added, destination_path_responses, Identity::_known_destinations.size(), interface_announces);
+	VERBOSEF("phl: %u rcp: %u lt: %u pl: %u al: %u tun: %u", _instance->_packet_hashlist.size(), _instance->_receipts.size(), _instance->_link_table.size(), _instance->_pending_links.size(), _instance->_active_links.size(), _instance->_tunnels.size());
+	for (auto& [link_id, link] : _instance->_active_links) {
+		VERBOSEF("link %s rtt: %.3f ka: %u stale: %u kas: %u kad: %u", link_id.toHex().substr(0, 8).c_str(), link.rtt(), link.keepalive(), link.stale_time(), link.keepalives_sent(), link.keepalives_deferred());
+	}
+	VERBOSEF("bwl: %u (%u bytes) bwe: %u bwx: %u", _instance->_boundary_whitelist.size(), _instance->_boundary_whitelist.memory_usage(), _instance->_boundary_whitelist.evictions(), _instance->_boundary_whitelist.expirations());
+	VERBOSEF("pin: %u pout: %u padd: %u dpr: %u ikd: %u ia: %u\r\n", _instance->_packets_received, _instance->_packets_sent, _instance->_destinations_added, destination_path_responses, Identity::_known_destinations.size(), interface_announces);
 
-	_last_memory = memory;
-	_last_flash = flash;
+	_instance->_last_memory = memory;
+	_instance->_last_flash = flash;
 
 }
 
 /*static*/ void Transport::exit_handler() {
 	TRACE("Transport::exit_handler()");
-	if (!_owner.is_connected_to_shared_instance()) {
+	if (!_instance->_owner->is_connected_to_shared_instance()) {
 		persist_data();
 	}
+	Utilities::OS::sync_filesystem();
 }
 
 /*static*/ Destination Transport::find_destination_from_hash(const Bytes& destination_hash) {
 	TRACE("Transport::find_destination_from_hash: Searching for destination " + destination_hash.toHex());
 #if defined(DESTINATIONS_SET)
-	for (const Destination& destination : _destinations) {
+	for (const Destination& destination : _instance->_destinations) {
 		if (destination.get_hash() == destination_hash) {
 			TRACE("Transport::find_destination_from_hash: Found destination " + destination.toString());
 			return destination;
 		}
 	}
 #elif defined(DESTINATIONS_MAP)
-	auto iter = _destinations.find(destination_hash);
-	if (iter != _destinations.end()) {
+	auto iter = _instance->_destinations.find(destination_hash);
+	if (iter != _instance->_destinations.end()) {
 		TRACE("Transport::find_destination_from_hash: Found destination " + (*iter).second.toString());
 		return (*iter).second;
 	}
@@ -4594,77 +5402,50 @@ TRACE("Transport::write_path_table: buffer size " + std::to_string(Persistence::
 
 /*static*/ void Transport::cull_path_table() {
 	TRACE("Transport::cull_path_table()");
-	if (_destination_table.size() > _path_table_maxsize) {
+	if (_instance->_destination_table.size() > _instance->_path_table_maxsize) {
 		// TODO prune by age, or better yet by last use
 /*
-		std::map<Bytes, DestinationEntry>::iterator iter = _destination_table.begin();
+		std::map<Bytes, DestinationEntry>::iterator iter = _instance->_destination_table.begin();
 		// naively erase from front of table
-		std::advance(iter, _destination_table.size() - _path_table_maxsize + 1);
-		_destination_table.erase(_destination_table.begin(), iter);
+		std::advance(iter, _instance->_destination_table.size() - _instance->_path_table_maxsize + 1);
+		_instance->_destination_table.erase(_instance->_destination_table.begin(), iter);
 */
 /*
 		uint16_t count = 0;
 		std::set<DestinationEntry> sorted_values;
-		MapToValues(_destination_table, sorted_values);
+		MapToValues(_instance->_destination_table, sorted_values);
 		for (auto& destination_entry : sorted_values) {
 			Packet announce_packet = destination_entry.announce_packet();
 			TRACE("Transport::cull_path_table: Removing destination " + announce_packet.destination_hash().toHex() + " from path table");
 			// Remove destination from path table
-			if (_destination_table.erase(announce_packet.destination_hash()) < 1) {
+			if (_instance->_destination_table.erase(announce_packet.destination_hash()) < 1) {
 				WARNING("Failed to remove destination " + announce_packet.destination_hash().toHex() + " from path table");
 			}
 			// Remove announce packet from packet table
-			//if (_packet_table.erase(destination_entry._announce_packet) < 1) {
+			//if (_instance->_packet_table.erase(destination_entry._announce_packet) < 1) {
 			//	WARNING("Failed to remove packet " + destination_entry._announce_packet.toHex() + " from packet table");
 			//}
-#if defined(RNS_USE_FS) && defined(RNS_PERSIST_PATHS)
-			// Remove cached packet file
-			char packet_cache_path[Type::Reticulum::FILEPATH_MAXSIZE];
-			snprintf(packet_cache_path, Type::Reticulum::FILEPATH_MAXSIZE, "%s/%s", Reticulum::_cachepath, destination_entry._announce_packet.toHex().c_str());
-			if (OS::file_exists(packet_cache_path)) {
-				OS::remove_file(packet_cache_path);
-			}
-#endif
+			// CBA Remove cached announce packet, from RAM and the spill file index
+			_instance->_packet_cache->erase(destination_entry._announce_packet);
 			++count;
-			if (_destination_table.size() <= _path_table_maxsize) {
+			if (_instance->_destination_table.size() <= _instance->_path_table_maxsize) {
 				break;
 			}
 		}
 		DEBUG("Removed " + std::to_string(count) + " path(s) from path table");
 */
 		uint16_t count = 0;
-		std::vector<std::pair<Bytes,DestinationEntry>> sorted_pairs;
-		// Copy key/value pairs from map into vector
-		std::for_each(_destination_table.begin(), _destination_table.end(), [&](const std::pair<const Bytes, DestinationEntry>& ref) {
-			sorted_pairs.push_back(ref);
-		});
-		// Sort vector using specified comparator
-		std::sort(sorted_pairs.begin(), sorted_pairs.end(), [](const std::pair<Bytes,DestinationEntry> &left, const std::pair<Bytes,DestinationEntry> &right) {
-			return left.second._timestamp < right.second._timestamp;
-		});
-		// Iterate vector of sorted values
-		for (auto& [destination_hash, destination_entry] : sorted_pairs) {
+		// Pop from the oldest end of the recency list
+		while (_instance->_destination_table.size() > _instance->_path_table_maxsize && _instance->_oldest_path) {
+			Bytes destination_hash = _instance->_oldest_path;
 			TRACE("Transport::cull_path_table: Removing destination " + destination_hash.toHex() + " from path table");
-			// Remove destination from path table
-			if (_destination_table.erase(destination_hash) < 1) {
-				WARNING("Failed to remove destination " + destination_hash.toHex() + " from path table");
-			}
-			// Remove announce packet from packet table
-			//if (_packet_table.erase(destination_entry._announce_packet) < 1) {
-			//	WARNING("Failed to remove packet " + destination_entry._announce_packet.toHex() + " from packet table");
-			//}
-#if defined(RNS_USE_FS) && defined(RNS_PERSIST_PATHS)
-			// Remove cached packet file
-			char packet_cache_path[Type::Reticulum::FILEPATH_MAXSIZE];
-			snprintf(packet_cache_path, Type::Reticulum::FILEPATH_MAXSIZE, "%s/%s", Reticulum::_cachepath, destination_entry._announce_packet.toHex().c_str());
-			if (OS::file_exists(packet_cache_path)) {
-				OS::remove_file(packet_cache_path);
-			}
-#endif
-			++count;
-			if (_destination_table.size() <= _path_table_maxsize) {
+			// Removes the cached announce packet as well
+			if (!remove_path(destination_hash)) {
+				ERROR("Transport::cull_path_table: recency list out of step with path table");
+				_instance->_oldest_path.clear();
 				break;
 			}
+			++count;
 		}
 		DEBUG("Removed " + std::to_string(count) + " path(s) from path table");
 	}
@@ -4673,7 +5454,7 @@ TRACE("Transport::write_path_table: buffer size " + std::to_string(Persistence::
 /*static*/ uint16_t Transport::remove_reverse_entries(const std::vector<Bytes>& hashes) {
 	uint16_t count = 0;
 	for (const auto& truncated_packet_hash : hashes) {
-		_reverse_table.erase(truncated_packet_hash);
+		_instance->_reverse_table.erase(truncated_packet_hash);
 		++count;
 	}
 	if (count > 0) {
@@ -4685,7 +5466,7 @@ TRACE("Transport::write_path_table: buffer size " + std::to_string(Persistence::
 /*static*/ uint16_t Transport::remove_links(const std::vector<Bytes>& hashes) {
 	uint16_t count = 0;
 	for (const auto& link_id : hashes) {
-		_link_table.erase(link_id);
+		_instance->_link_table.erase(link_id);
 		++count;
 	}
 	if (count > 0) {
@@ -4697,7 +5478,7 @@ TRACE("Transport::write_path_table: buffer size " + std::to_string(Persistence::
 /*static*/ uint16_t Transport::remove_paths(const std::vector<Bytes>& hashes) {
 	uint16_t count = 0;
 	for (const auto& destination_hash : hashes) {
-		//_destination_table.erase(destination_hash);
+		//_instance->_destination_table.erase(destination_hash);
 		remove_path(destination_hash);
 		++count;
 	}
@@ -4710,7 +5491,7 @@ TRACE("Transport::write_path_table: buffer size " + std::to_string(Persistence::
 /*static*/ uint16_t Transport::remove_discovery_path_requests(const std::vector<Bytes>& hashes) {
 	uint16_t count = 0;
 	for (const auto& destination_hash : hashes) {
-		_discovery_path_requests.erase(destination_hash);
+		_instance->_discovery_path_requests.erase(destination_hash);
 		++count;
 	}
 	if (count > 0) {
@@ -4722,7 +5503,7 @@ TRACE("Transport::write_path_table: buffer size " + std::to_string(Persistence::
 /*static*/ uint16_t Transport::remove_tunnels(const std::vector<Bytes>& hashes) {
 	uint16_t count = 0;
 	for (const auto& tunnel_id : hashes) {
-		_tunnels.erase(tunnel_id);
+		_instance->_tunnels.erase(tunnel_id);
 		++count;
 	}
 	if (count > 0) {
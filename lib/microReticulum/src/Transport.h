@@ -2,7 +2,13 @@
 
 #include "Packet.h"
 #include "Bytes.h"
+#include "Hash.h"
 #include "Type.h"
+#include "Utilities/HashTable.h"
+#include "Utilities/HashList.h"
+#include "Utilities/AnnounceFilter.h"
+#include "Utilities/TimerWheel.h"
+#include "Utilities/Whitelist.h"
 
 #include <map>
 #include <vector>
@@ -29,6 +35,7 @@ namespace RNS {
 	class Link;
 	class Packet;
 	class PacketReceipt;
+	namespace Utilities { class PathStore; class PacketCache; }
 
 	class AnnounceHandler {
 	public:
@@ -61,10 +68,15 @@ namespace RNS {
 			using receive_packet = void(*)(const Bytes& raw, const Interface& interface);
 			using transmit_packet = void(*)(const Bytes& raw, const Interface& interface);
 			using filter_packet = bool(*)(const Packet& packet);
+			// CBA Called with -1 when jobs() starts, with the job_types value after each job has
+			// run and with JOB_COUNT once the rest of the tick is done, so time between calls
+			// belongs to the stage passed
+			using jobs_profile = void(*)(int8_t stage);
 		public:
 			receive_packet _receive_packet = nullptr;
 			transmit_packet _transmit_packet = nullptr;
 			filter_packet _filter_packet = nullptr;
+			jobs_profile _jobs_profile = nullptr;
 		friend class Transport;
 		};
 
@@ -100,12 +112,66 @@ namespace RNS {
 #endif
 		};
 
-		// CBA TODO Analyze safety of using Inrerface references here
+		// CBA Inline ring of the last MAX_RANDOM_BLOBS announce random blobs heard for a path,
+		// replacing std::set<Bytes> (a tree node and a heap buffer per blob). Replay checks are
+		// a linear scan and the oldest blob is overwritten once the ring is full.
+		class RandomBlobs {
+		public:
+			static const uint8_t BLOB_SIZE = Type::Identity::RANDOM_HASH_LENGTH/8;
+			static const uint8_t CAPACITY = Type::Transport::MAX_RANDOM_BLOBS;
+		public:
+			inline bool contains(const uint8_t* blob) const {
+				for (uint8_t i = 0; i < _count; i++) {
+					if (memcmp(_blobs[i], blob, BLOB_SIZE) == 0) {
+						return true;
+					}
+				}
+				return false;
+			}
+			inline bool contains(const Bytes& blob) const { return blob.size() == BLOB_SIZE && contains(blob.data()); }
+			inline void insert(const uint8_t* blob) {
+				if (contains(blob)) {
+					return;
+				}
+				memcpy(_blobs[_next], blob, BLOB_SIZE);
+				_next = (_next + 1) % CAPACITY;
+				if (_count < CAPACITY) {
+					++_count;
+				}
+			}
+			inline void insert(const Bytes& blob) { if (blob.size() == BLOB_SIZE) insert(blob.data()); }
+			inline void clear() { _count = 0; _next = 0; }
+			inline uint8_t size() const { return _count; }
+			// Blobs in slot order, not in order of arrival
+			inline const uint8_t* operator[](uint8_t index) const { return _blobs[index]; }
+			// Emission timestamp carried in bytes 5-9 of a blob
+			static inline uint64_t emitted(const uint8_t* blob) {
+				uint64_t value = 0;
+				for (uint8_t i = 5; i < BLOB_SIZE; i++) {
+					value = (value << 8) | blob[i];
+				}
+				return value;
+			}
+			inline uint64_t latest_emitted() const {
+				uint64_t latest = 0;
+				for (uint8_t i = 0; i < _count; i++) {
+					latest = std::max(latest, emitted(_blobs[i]));
+				}
+				return latest;
+			}
+		private:
+			uint8_t _blobs[CAPACITY][BLOB_SIZE];
+			uint8_t _count = 0;
+			uint8_t _next = 0;
+		};
+
 		// CBA TODO Analyze safety of using Packet references here
+		// CBA Timestamps are OS::seconds(), the receiving interface is a registry id and the
+		// announce packet is referenced by hash (see get_cached_packet())
 		class DestinationEntry {
 		public:
 			DestinationEntry() {}
-			DestinationEntry(double timestamp, const Bytes& received_from, uint8_t announce_hops, double expires, const std::set<Bytes>& random_blobs, const Bytes& receiving_interface, const Bytes& packet) :
+			DestinationEntry(uint32_t timestamp, const Bytes& received_from, uint8_t announce_hops, uint32_t expires, const RandomBlobs& random_blobs, uint8_t receiving_interface, const Bytes& packet) :
 				_timestamp(timestamp),
 				_received_from(received_from),
 				_hops(announce_hops),
@@ -116,19 +182,25 @@ namespace RNS {
 			{
 			}
 		public:
-			inline Interface receiving_interface() const { return find_interface_from_hash(_receiving_interface); }
+			inline Interface receiving_interface() const { return find_interface_from_id(_receiving_interface); }
 			inline Packet announce_packet() const { return get_cached_packet(_announce_packet); }
 		public:
-			double _timestamp = 0;
+			uint32_t _timestamp = 0;
 			Bytes _received_from;
 			uint8_t _hops = 0;
-			double _expires = 0;
-			std::set<Bytes> _random_blobs;
+			uint32_t _expires = 0;
+			RandomBlobs _random_blobs;
 			//Interface _receiving_interface = {Type::NONE};
-			Bytes _receiving_interface;
+			// CBA Registry id of the interface, its hash is only stored when persisted
+			uint8_t _receiving_interface = 0;
+			// CBA Deadline of the live timer on _instance->_path_timers (0 = none), others for this path are stale
+			uint32_t _cull_at = 0;
 			//const Packet& _announce_packet;
 			//Packet _announce_packet = {Type::NONE};
 			Bytes _announce_packet;
+			// CBA Neighbours in the path table's recency list (see touch_path()), empty at either end
+			Bytes _newer;
+			Bytes _older;
 			inline bool operator < (const DestinationEntry& entry) const {
 				// sort by ascending timestamp (oldest entries at the top)
 				return _timestamp < entry._timestamp;
@@ -141,11 +213,11 @@ namespace RNS {
 					" hops=" + std::to_string(_hops) +
 					" expires=" + std::to_string(_expires) +
 					//" random_blobs=" + _random_blobs +
-					" receiving_interface=" + _receiving_interface.toHex() +
+					" receiving_interface=" + std::to_string(_receiving_interface) +
 					" announce_packet=" + _announce_packet.toHex();
 				dump += " random_blobs=(";
-				for (auto& blob : _random_blobs) {
-					dump += blob.toHex() + ",";
+				for (uint8_t i = 0; i < _random_blobs.size(); i++) {
+					dump += Bytes(_random_blobs[i], RandomBlobs::BLOB_SIZE).toHex() + ",";
 				}
 				dump += ")";
 				return dump;
@@ -155,9 +227,11 @@ namespace RNS {
 
 		// CBA TODO Analyze safety of using Inrerface references here
 		// CBA TODO Analyze safety of using Packet references here
+		// CBA Times in this and the entries below are OS::seconds(), apart from
+		// _retransmit_timeout which is ms of OS::ticks() so the rebroadcast jitter survives
 		class AnnounceEntry {
 		public:
-			AnnounceEntry(double timestamp, double retransmit_timeout, uint8_t retries, const Bytes& received_from, uint8_t hops, const Packet& packet, uint8_t local_rebroadcasts, bool block_rebroadcasts, const Interface& attached_interface) :
+			AnnounceEntry(uint32_t timestamp, uint32_t retransmit_timeout, uint8_t retries, const Bytes& received_from, uint8_t hops, const Packet& packet, uint8_t local_rebroadcasts, bool block_rebroadcasts, const Interface& attached_interface) :
 				_timestamp(timestamp),
 				_retransmit_timeout(retransmit_timeout),
 				_retries(retries),
@@ -170,8 +244,8 @@ namespace RNS {
 			{
 			}
 		public:
-			double _timestamp = 0;
-			double _retransmit_timeout = 0;
+			uint32_t _timestamp = 0;
+			uint32_t _retransmit_timeout = 0;
 			uint8_t _retries = 0;
 			const Bytes _received_from;
 			uint8_t _hops = 0;
@@ -182,12 +256,14 @@ namespace RNS {
 			uint8_t _local_rebroadcasts = 0;
 			bool _block_rebroadcasts = false;
 			const Interface _attached_interface = {Type::NONE};
+			// CBA Rebroadcast packet, packed on the first retransmission and sent as is on retries
+			Packet _rebroadcast = {Type::NONE};
 		};
 
 		// CBA TODO Analyze safety of using Inrerface references here
 		class LinkEntry {
 		public:
-			LinkEntry(double timestamp, const Bytes& next_hop, const Interface& outbound_interface, uint8_t remaining_hops, const Interface& receiving_interface, uint8_t hops, const Bytes& destination_hash, bool validated, double proof_timeout) :
+			LinkEntry(uint32_t timestamp, const Bytes& next_hop, const Interface& outbound_interface, uint8_t remaining_hops, const Interface& receiving_interface, uint8_t hops, const Bytes& destination_hash, bool validated, uint32_t proof_timeout) :
 				_timestamp(timestamp),
 				_next_hop(next_hop),
 				_outbound_interface(outbound_interface),
@@ -200,7 +276,7 @@ namespace RNS {
 			{
 			}
 		public:
-			double _timestamp = 0;
+			uint32_t _timestamp = 0;
 			const Bytes _next_hop;
 			const Interface _outbound_interface = {Type::NONE};
 			uint8_t _remaining_hops = 0;
@@ -208,13 +284,13 @@ namespace RNS {
 			uint8_t _hops = 0;
 			const Bytes _destination_hash;
 			bool _validated = false;
-			double _proof_timeout = 0;
+			uint32_t _proof_timeout = 0;
 		};
 
 		// CBA TODO Analyze safety of using Inrerface references here
 		class ReverseEntry {
 		public:
-			ReverseEntry(const Interface& receiving_interface, const Interface& outbound_interface, double timestamp) :
+			ReverseEntry(const Interface& receiving_interface, const Interface& outbound_interface, uint32_t timestamp) :
 				_receiving_interface(receiving_interface),
 				_outbound_interface(outbound_interface),
 				_timestamp(timestamp)
@@ -223,13 +299,13 @@ namespace RNS {
 		public:
 			Interface _receiving_interface = {Type::NONE};
 			const Interface _outbound_interface = {Type::NONE};
-			double _timestamp = 0;
+			uint32_t _timestamp = 0;
 		};
 
 		// CBA TODO Analyze safety of using Inrerface references here
 		class PathRequestEntry {
 		public:
-			PathRequestEntry(const Bytes& destination_hash, double timeout, const Interface& requesting_interface) :
+			PathRequestEntry(const Bytes& destination_hash, uint32_t timeout, const Interface& requesting_interface) :
 				_destination_hash(destination_hash),
 				_timeout(timeout),
 				_requesting_interface(requesting_interface)
@@ -237,8 +313,17 @@ namespace RNS {
 			}
 		public:
 			const Bytes _destination_hash;
-			double _timeout = 0;
+			uint32_t _timeout = 0;
 			const Interface _requesting_interface = {Type::NONE};
+			// CBA Other interfaces that asked for the same path while this request was waiting
+			std::vector<Interface> _coalesced_interfaces;
+		};
+
+		// CBA Last path response sent for a destination, used to coalesce repeated path requests
+		class PathResponseEntry {
+		public:
+			uint32_t _timestamp = 0;
+			Bytes _interface_hash;
 		};
 
 /*
@@ -270,7 +355,7 @@ namespace RNS {
 		// CBA TODO Analyze safety of using Inrerface references here
 		class TunnelEntry {
 		public:
-			TunnelEntry(const Bytes& tunnel_id, const Bytes& interface_hash, double expires) :
+			TunnelEntry(const Bytes& tunnel_id, const Bytes& interface_hash, uint32_t expires) :
 				_tunnel_id(tunnel_id),
 				_interface_hash(interface_hash),
 				_expires(expires)
@@ -280,28 +365,105 @@ namespace RNS {
 			const Bytes _tunnel_id;
 			const Bytes _interface_hash;
 			std::map<Bytes, DestinationEntry> _serialised_paths;
-			double _expires = 0;
+			uint32_t _expires = 0;
 		};
 
+		// CBA Fixed-size announce rate state of one destination. RNS also keeps the last
+		// MAX_RATE_TIMESTAMPS announce times but only ever reads the latest, which is all that is
+		// kept here. Violations count up for each announce sooner than the interface's rate target
+		// after the last accepted one and decay by one for each that isn't.
 		class RateEntry {
 		public:
-			RateEntry(double now) :
+			RateEntry() {}
+			RateEntry(uint32_t now) :
 				_last(now)
 			{
-				_timestamps.push_back(now);
 			}
 		public:
-			double _last = 0.0;
-			double _rate_violations = 0.0;
-			double _blocked_until = 0.0;
-			std::vector<double> _timestamps;
+			uint32_t _last = 0;
+			uint32_t _blocked_until = 0;
+			uint8_t _rate_violations = 0;
+		};
+
+		// CBA Path request count of one destination asked for by clients on a non-backbone
+		// interface, halved every PATH_WARM_DECAY seconds
+		class HeatEntry {
+		public:
+			HeatEntry() {}
+			HeatEntry(uint32_t now) :
+				_decayed_at(now)
+			{
+			}
+		public:
+			uint32_t _decayed_at = 0;
+			uint32_t _warmed_at = 0;
+			uint16_t _requests = 0;
+		};
+
+		// CBA Announce received on a registered interface waiting for validation, raw is the unmasked frame
+		class QueuedAnnounce {
+		public:
+			QueuedAnnounce(const Bytes& raw, uint8_t interface_id) :
+				_raw(raw),
+				_interface_id(interface_id)
+			{
+			}
+		public:
+			Bytes _raw;
+			uint8_t _interface_id = 0;
+		};
+
+		// CBA Time-sliced job state (see jobs()). A job becomes due every _interval ms of
+		// OS::ticks(), then processes at most _budget entries per tick, resuming from _cursor on
+		// the next tick until its pass is complete.
+		class Job {
+		public:
+			Job(uint32_t interval, uint16_t budget) : _interval(interval), _budget(budget) {}
+		public:
+			inline bool due(uint32_t now) const { return _active || (uint32_t)(now - _last_run) > _interval; }
+			inline void finish(uint32_t now) { _active = false; _cursor = 0; _last_run = now; }
+			// make due on the next tick (as if a pass had started)
+			inline void trigger() { _active = true; }
+		public:
+			uint32_t _interval = 0;
+			uint16_t _budget = 0;		// entries per tick (0 = unbounded)
+			uint32_t _last_run = 0;
+			size_t _cursor = 0;
+			bool _active = false;
+		};
+
+		enum job_types : uint8_t {
+			JOB_PENDING_LINKS = 0,
+			JOB_ACTIVE_LINKS,
+			JOB_RECEIPTS,
+			JOB_ANNOUNCES,
+			JOB_REVERSE_CULL,
+			JOB_LINK_CULL,
+			JOB_PATH_CULL,
+			JOB_DISCOVERY_CULL,
+			JOB_PATH_REQUEST_CULL,
+			JOB_LOCAL_REQUEST_CULL,
+			JOB_TUNNEL_CULL,
+			JOB_PATH_WARM,
+			JOB_COUNT
+		};
+
+		// Why inbound() dropped a frame before building a Packet from it
+		enum prefilter_reasons : uint8_t {
+			PREFILTER_IFAC = 0,		// IFAC missing, unexpected or failing authentication
+			PREFILTER_MALFORMED,	// shorter than its header
+			PREFILTER_SCOPE,		// PLAIN or GROUP beyond one hop, or announced
+			PREFILTER_DUPLICATE,	// in the packet hashlist
+			PREFILTER_BLOCKED,		// BOUNDARY firewall
+			PREFILTER_COUNT
 		};
 
 	public:
 		static void start(const Reticulum& reticulum_instance);
 		static void loop();
 		static void jobs();
-		static void transmit(Interface& interface, const Bytes& raw);
+		// CBA False if the frame was not handed to the interface (refused by its can_send())
+		static bool transmit(Interface& interface, const Bytes& raw);
 		static bool outbound(Packet& packet);
 		static bool packet_filter(const Packet& packet);
 		//static void inbound(const Bytes& raw, const Interface& interface = {Type::NONE});
@@ -312,8 +474,8 @@ namespace RNS {
 		static void handle_tunnel(const Bytes& tunnel_id, const Interface& interface);
 		static void register_interface(Interface& interface);
 		static void deregister_interface(const Interface& interface);
-		static void register_local_client_interface(const Interface& interface) { _local_client_interfaces.insert(std::cref(interface)); }
-		inline static const std::map<Bytes, Interface&> get_interfaces() { return _interfaces; }
+		static void register_local_client_interface(const Interface& interface) { _instance->_local_client_interfaces.insert(std::cref(interface)); }
+		inline static const std::map<Bytes, Interface&> get_interfaces() { return _instance->_interfaces; }
 		static void register_destination(Destination& destination);
 		static void deregister_destination(const Destination& destination);
 		static void register_link(Link& link);
@@ -321,12 +483,18 @@ namespace RNS {
 		static void register_announce_handler(HAnnounceHandler handler);
 		static void deregister_announce_handler(HAnnounceHandler handler);
 		static Interface find_interface_from_hash(const Bytes& interface_hash);
+		static Interface find_interface_from_id(uint8_t interface_id);
+		// Registry id for a registered interface hash, 0 if not registered
+		static uint8_t interface_id_from_hash(const Bytes& interface_hash);
+		// Hash of the interface registered under interface_id, empty if none
+		static Bytes interface_hash_from_id(uint8_t interface_id);
 		static bool should_cache_packet(const Packet& packet);
 		static bool cache_packet(const Packet& packet, bool force_cache = false);
 		static Packet get_cached_packet(const Bytes& packet_hash);
 		static bool clear_cached_packet(const Bytes& packet_hash);
 		static bool cache_request_packet(const Packet& packet);
 		static void cache_request(const Bytes& packet_hash, const Destination& destination);
+		static void cache_request(const Bytes& packet_hash, const Link& link);
 		static bool remove_path(const Bytes& destination_hash);
 		static bool has_path(const Bytes& destination_hash);
 		static uint8_t hops_to(const Bytes& destination_hash);
@@ -336,6 +504,7 @@ namespace RNS {
 		static uint16_t next_hop_interface_hw_mtu(const Bytes& destination_hash);
 		static double next_hop_per_bit_latency(const Bytes& destination_hash);
 		static double next_hop_per_byte_latency(const Bytes& destination_hash);
+		static double next_hop_rtt(const Bytes& destination_hash);
 		static double first_hop_timeout(const Bytes& destination_hash);
 		static double extra_link_proof_timeout(const Interface& interface);
 		static bool expire_path(const Bytes& destination_hash);
@@ -374,119 +543,270 @@ namespace RNS {
 		static void cull_path_table();
 
 		// getters/setters
-		static inline void set_receive_packet_callback(Callbacks::receive_packet callback) { _callbacks._receive_packet = callback; }
-		static inline void set_transmit_packet_callback(Callbacks::transmit_packet callback) { _callbacks._transmit_packet = callback; }
-		static inline void set_filter_packet_callback(Callbacks::filter_packet callback) { _callbacks._filter_packet = callback; }
-		static inline const Reticulum& reticulum() { return _owner; }
-		static inline const Identity& identity() { return _identity; }
-		inline static uint16_t path_table_maxsize() { return _path_table_maxsize; }
-		inline static void path_table_maxsize(uint16_t path_table_maxsize) { _path_table_maxsize = path_table_maxsize; }
-		inline static uint16_t probe_destination_enabled() { return _path_table_maxpersist; }
-		inline static void path_table_maxpersist(uint16_t path_table_maxpersist) { _path_table_maxpersist = path_table_maxpersist; }
+		static inline void set_receive_packet_callback(Callbacks::receive_packet callback) { _instance->_callbacks._receive_packet = callback; }
+		static inline void set_transmit_packet_callback(Callbacks::transmit_packet callback) { _instance->_callbacks._transmit_packet = callback; }
+		static inline void set_filter_packet_callback(Callbacks::filter_packet callback) { _instance->_callbacks._filter_packet = callback; }
+		static inline void set_jobs_profile_callback(Callbacks::jobs_profile callback) { _instance->_callbacks._jobs_profile = callback; }
+		static inline const Reticulum& reticulum() { return *_instance->_owner; }
+		static inline const Identity& identity() { return _instance->_identity; }
+		inline static uint16_t path_table_maxsize() { return _instance->_path_table_maxsize; }
+		// CBA Stats
+		inline static uint32_t packets_sent() { return _instance->_packets_sent; }
+		inline static uint32_t packets_received() { return _instance->_packets_received; }
+		inline static uint32_t packets_fast_forwarded() { return _instance->_packets_fast_forwarded; }
+		inline static uint32_t prefilter_rejects(prefilter_reasons reason) { return _instance->_prefilter_rejects[reason]; }
+		inline static uint32_t announces_shed() { return _instance->_announces_shed; }
+		inline static uint32_t announces_rate_blocked() { return _instance->_announces_rate_blocked; }
+		inline static uint32_t destinations_added() { return _instance->_destinations_added; }
+		// CBA Path table capacity tracks maxsize with one slot of headroom so that a new path can be inserted before cull_path_table() trims by age
+		// (culled first, so that shrinking the table drops paths from the oldest end of the recency list)
+		inline static void path_table_maxsize(uint16_t path_table_maxsize) { _instance->_path_table_maxsize = path_table_maxsize; cull_path_table(); _instance->_destination_table.capacity(path_table_maxsize + 1); }
+		inline static uint16_t hashlist_maxsize() { return _instance->_hashlist_maxsize; }
+		inline static void hashlist_maxsize(uint16_t hashlist_maxsize) { _instance->_hashlist_maxsize = hashlist_maxsize; _instance->_packet_hashlist.capacity(hashlist_maxsize); }
+		inline static uint16_t probe_destination_enabled() { return _instance->_path_table_maxpersist; }
+		inline static void path_table_maxpersist(uint16_t path_table_maxpersist) { _instance->_path_table_maxpersist = path_table_maxpersist; }
 		// CBA TEST
-		static inline void identity(Identity& identity) { _identity = identity; }
-
-		inline static const std::map<Bytes, DestinationEntry>& get_destination_table() { return _destination_table; }
-		inline static const std::map<Bytes, RateEntry>& get_announce_rate_table() { return _announce_rate_table; }
-		inline static const std::map<Bytes, LinkEntry>& get_link_table() { return _link_table; }
+		static inline void identity(Identity& identity) { _instance->_identity = identity; }
+
+		inline static const Utilities::HashTable<DestinationEntry>& get_destination_table() { return _instance->_destination_table; }
+		inline static const Utilities::HashTable<RateEntry>& get_announce_rate_table() { return _instance->_announce_rate_table; }
+		inline static const Utilities::HashTable<LinkEntry>& get_link_table() { return _instance->_link_table; }
+		inline static uint32_t path_requests_coalesced() { return _instance->_path_requests_coalesced; }
+		inline static const Utilities::HashTable<HeatEntry>& get_path_heat_table() { return _instance->_path_heat_table; }
+		inline static uint32_t paths_warmed() { return _instance->_paths_warmed; }
+		inline static uint32_t path_announces_promoted() { return _instance->_path_announces_promoted; }
+		// CBA Rules for rebroadcasting backbone announces on interfaces with filter_announces() set
+		inline static Utilities::AnnounceFilter& announce_filter() { return _instance->_announce_filter; }
+		// CBA Announce packets served to path responses (see Utilities/PacketCache.h)
+		inline static const Utilities::PacketCache& packet_cache() { return *_instance->_packet_cache; }
+		// CBA Memory pressure shedding, called on the task that runs Transport. Each returns the number of entries dropped.
+		static size_t shed_held_announces();
+		static size_t shed_announce_queue(size_t keep);
+		static size_t shed_packet_cache();
+		// CBA While false, link requests for local destinations are dropped
+		inline static void accept_link_requests(bool accept) { _instance->_accept_link_requests = accept; }
+		inline static bool accept_link_requests() { return _instance->_accept_link_requests; }
+		inline static uint32_t link_requests_rejected() { return _instance->_link_requests_rejected; }
 
 	private:
-		// CBA MUST use references to interfaces here in order for virtul overrides for send/receive to work
+		// CBA Time-sliced jobs
+		static void run_job(job_types job);
+		static void run_links_job(job_types job, Utilities::HashTable<Link>& links, bool pending);
+		static void run_receipts_job();
+		// CBA Expiry timers, deadlines are the first whole second at which the entry has expired
+		static uint32_t path_deadline(const DestinationEntry& destination_entry);
+		static void schedule_path(const Bytes& destination_hash, DestinationEntry& destination_entry);
+		// CBA Path choice between equal-hop paths by the interfaces' link estimates
+		static bool prefer_current_path(const DestinationEntry& destination_entry, const Interface& candidate);
+		// CBA Recency list of the path table, newest first, kept in timestamp order
+		static DestinationEntry* find_path_entry(const Bytes& destination_hash);
+		static void link_path(const Bytes& destination_hash, DestinationEntry& destination_entry, bool newest = true);
+		static void unlink_path(const Bytes& destination_hash, DestinationEntry& destination_entry);
+		static void touch_path(const Bytes& destination_hash, DestinationEntry& destination_entry);
+		static uint32_t announce_deadline(const AnnounceEntry& announce_entry);
+		static void insert_announce(const Bytes& destination_hash, const AnnounceEntry& announce_entry);
+		static uint32_t reverse_deadline(const ReverseEntry& reverse_entry);
+		static void schedule_receipt(const PacketReceipt& receipt);
+		static void remove_receipt(const PacketReceipt& receipt);
+		static void run_announces_job();
+		static void run_table_cull_job(job_types job);
+		static void run_request_cull_job(job_types job);
+		static void run_tunnel_cull_job();
+		static void run_path_warm_job();
+		static void record_path_request(const Bytes& destination_hash);
+		static void queue_path_request(const Bytes& destination_hash);
+		static bool filter_announce(const Packet& packet);
+		static bool prefilter(const Bytes& raw, const Interface& interface, uint8_t* packet_hash, bool& hashed);
+		static bool forward_fast(const Bytes& raw, const Interface& interface, const uint8_t* known_hash);
+		static void process_inbound(const Bytes& raw, const Interface& interface, const uint8_t* known_hash = nullptr);
+		static bool queue_announce_validation(const Bytes& raw, const Interface& interface);
+		static uint16_t announce_shed_score(const Bytes& raw, uint32_t now);
+		static void process_announce_validation();
+		static bool path_response_pending(const Bytes& destination_hash, const Interface& interface);
+		static void path_response_sent(const Bytes& destination_hash, const Interface& interface);
+
+	public:
+		// CBA Everything one Transport holds. The static API below works on the active
+		// instance, which is a default singleton unless another is made active with use(),
+		// so separate Transports (a simulator, host benchmarks, a policy per radio) can live
+		// in one address space. Keeping it in one object also keeps it together in memory.
+		class Instance {
+		public:
+			Instance();
+			~Instance();
+			Instance(const Instance&) = delete;
+			Instance& operator=(const Instance&) = delete;
+
+		public:
+			// CBA MUST use references to interfaces here in order for virtul overrides for send/receive to work
 #if defined(INTERFACES_SET)
-		// set sorted, can use find
-		//static std::set<std::reference_wrapper<const Interface>, std::less<const Interface>> _interfaces;           // All active interfaces
-		static std::set<std::reference_wrapper<Interface>, std::less<Interface>> _interfaces;           // All active interfaces
+			// set sorted, can use find
+			//static std::set<std::reference_wrapper<const Interface>, std::less<const Interface>> _interfaces;           // All active interfaces
+			std::set<std::reference_wrapper<Interface>, std::less<Interface>> _interfaces;           // All active interfaces
 #elif defined(INTERFACES_LIST)
-		// list is unsorted, can't use find
-		static std::list<std::reference_wrapper<Interface>> _interfaces;           // All active interfaces
+			// list is unsorted, can't use find
+			std::list<std::reference_wrapper<Interface>> _interfaces;           // All active interfaces
 #elif defined(INTERFACES_MAP)
-		// map is sorted, can use find
-		static std::map<Bytes, Interface&> _interfaces;           // All active interfaces
+			// map is sorted, can use find
+			std::map<Bytes, Interface&> _interfaces;           // All active interfaces
 #endif
+			// CBA Registered interfaces indexed by id - 1, and interface hash -> id
+			Interface* _interfaces_by_id[Type::Transport::INTERFACES_MAXSIZE] = {nullptr};
+			Utilities::HashTable<uint8_t> _interface_ids{Type::Transport::INTERFACES_MAXSIZE};
+			// CBA Expiry timers, the cull jobs only check the entries whose timer came due
+			Utilities::TimerWheel<Bytes> _path_timers;
+			Utilities::TimerWheel<Bytes> _reverse_timers;
+			Utilities::TimerWheel<PacketReceipt> _receipt_timers;
+			Utilities::TimerWheel<Bytes> _announce_timers;		// ms of OS::ticks(), the others run on OS::seconds()
+			// CBA Announces are validated from loop() at a capped rate rather than inline in inbound()
+			std::vector<QueuedAnnounce> _announce_validation_queue;
 #if defined(DESTINATIONS_SET)
-		static std::set<Destination> _destinations;           // All active destinations
+			std::set<Destination> _destinations;           // All active destinations
 #elif defined(DESTINATIONS_MAP)
-		static std::map<Bytes, Destination> _destinations;           // All active destinations
+			std::map<TruncatedHash, Destination> _destinations;           // All active destinations
 #endif
-		// CBA TODO: Reconsider using std::set for enforcing uniqueness. Maybe consider std::map keyed on hash instead
-		static std::set<Link> _pending_links;           // Links that are being established
-		static std::set<Link> _active_links;           // Links that are active
-		static std::set<Bytes> _packet_hashlist;           // A list of packet hashes for duplicate detection
-		static std::list<PacketReceipt> _receipts;           // Receipts of all outgoing packets for proof processing
-
-		// TODO: "destination_table" should really be renamed to "path_table"
-		// Notes on memory usage: 1 megabyte of memory can store approximately
-		// 55.100 path table entries or approximately 22.300 link table entries.
-
-		static std::map<Bytes, AnnounceEntry> _announce_table;           // A table for storing announces currently waiting to be retransmitted
-		static std::map<Bytes, DestinationEntry> _destination_table;           // A lookup table containing the next hop to a given destination
-		static std::map<Bytes, ReverseEntry> _reverse_table;           // A lookup table for storing packet hashes used to return proofs and replies
-		static std::map<Bytes, LinkEntry> _link_table;           // A lookup table containing hops for links
-		static std::map<Bytes, AnnounceEntry> _held_announces;           // A table containing temporarily held announce-table entries
-		static std::set<HAnnounceHandler> _announce_handlers;           // A table storing externally registered announce handlers
-		static std::map<Bytes, TunnelEntry> _tunnels;           // A table storing tunnels to other transport instances
-		static std::map<Bytes, RateEntry> _announce_rate_table;           // A table for keeping track of announce rates
-		static std::map<Bytes, double> _path_requests;           // A table for storing path request timestamps
-
-		static std::map<Bytes, PathRequestEntry> _discovery_path_requests;       // A table for keeping track of path requests on behalf of other nodes
-		static std::set<Bytes> _discovery_pr_tags;       // A table for keeping track of tagged path requests
-
-		// Transport control destinations are used
-		// for control purposes like path requests
-		static std::set<Destination> _control_destinations;
-		static std::set<Bytes> _control_hashes;
-
-		// Interfaces for communicating with
-		// local clients connected to a shared
-		// Reticulum instance
-		//static std::set<Interface> _local_client_interfaces;
-		static std::set<std::reference_wrapper<const Interface>, std::less<const Interface>> _local_client_interfaces;
-
-		static std::map<Bytes, const Interface&> _pending_local_path_requests;
-
-		// CBA
-		static std::map<Bytes, PacketEntry> _packet_table;           // A lookup table containing announce packets for known paths
-
-		//z _local_client_rssi_cache    = []
-		//z _local_client_snr_cache     = []
-		static uint16_t _LOCAL_CLIENT_CACHE_MAXSIZE;
-
-		static double _start_time;
-		static bool _jobs_locked;
-		static bool _jobs_running;
-		static float _job_interval;
-		static double _jobs_last_run;
-		static double _links_last_checked;
-		static float _links_check_interval;
-		static double _receipts_last_checked;
-		static float _receipts_check_interval;
-		static double _announces_last_checked;
-		static float _announces_check_interval;
-		static double _tables_last_culled;
-		static float _tables_cull_interval;
-		static bool _saving_path_table;
-		static uint16_t _hashlist_maxsize;
-		static uint16_t _max_pr_tags;
-
-		// CBA
-		static uint16_t _path_table_maxsize;
-		static uint16_t _path_table_maxpersist;
-		static double _last_saved;
-		static float _save_interval;
-		static uint32_t _destination_table_crc;
+			// CBA Links are keyed on link_id so inbound link traffic is a single lookup. Closed
+			// links stay in place until the links jobs sweep them out.
+			Utilities::HashTable<Link> _pending_links;           // Links that are being established
+			Utilities::HashTable<Link> _active_links;           // Links that are active
+			Utilities::HashList _packet_hashlist;           // A list of packet hashes for duplicate detection
+			Utilities::HashTable<PacketReceipt> _receipts;           // Receipts of all outgoing packets for proof processing, keyed by truncated packet hash
+
+			// TODO: "destination_table" should really be renamed to "path_table"
+			// Notes on memory usage: 1 megabyte of memory can store approximately
+			// 55.100 path table entries or approximately 22.300 link table entries.
+			// CBA Hot lookup tables are flat open-addressing hash tables (see Utilities/HashTable.h)
+			// rather than std::map, avoiding a node allocation per entry and a Bytes compare per tree level.
+
+			Utilities::HashTable<AnnounceEntry> _announce_table;           // A table for storing announces currently waiting to be retransmitted
+			Utilities::HashTable<DestinationEntry> _destination_table;           // A lookup table containing the next hop to a given destination
+			Bytes _newest_path;                                                 // Ends of the path table's recency list
+			Bytes _oldest_path;
+			Utilities::HashTable<ReverseEntry> _reverse_table{0, Utilities::OS::PLACE_HOT};           // A lookup table for storing packet hashes used to return proofs and replies
+			Utilities::HashTable<LinkEntry> _link_table{0, Utilities::OS::PLACE_HOT};           // A lookup table containing hops for links
+			std::map<TruncatedHash, AnnounceEntry> _held_announces;           // A table containing temporarily held announce-table entries
+			std::set<HAnnounceHandler> _announce_handlers;           // A table storing externally registered announce handlers
+			std::map<FullHash, TunnelEntry> _tunnels;           // A table storing tunnels to other transport instances
+			Utilities::HashTable<RateEntry> _announce_rate_table{Type::Transport::ANNOUNCE_RATE_TABLE_MAXSIZE};           // A table for keeping track of announce rates, least recently announcing evicted when full
+			Utilities::HashTable<HeatEntry> _path_heat_table{Type::Transport::PATH_HEAT_MAXSIZE};           // Path request counts from non-backbone interfaces, least recently requested evicted when full
+			Utilities::AnnounceFilter _announce_filter;               // Backbone announce rebroadcast rules
+			std::map<TruncatedHash, uint32_t> _path_requests;         // A table for storing path request timestamps
+
+			std::map<TruncatedHash, PathRequestEntry> _discovery_path_requests;       // A table for keeping track of path requests on behalf of other nodes
+			std::set<Bytes> _discovery_pr_tags;       // A table for keeping track of tagged path requests
+			Utilities::HashTable<PathResponseEntry> _path_responses{Type::Transport::PATH_RESPONSES_MAXSIZE};       // Recently sent path responses, for coalescing path requests
+			uint32_t _path_requests_coalesced = 0;
+
+			// Transport control destinations are used
+			// for control purposes like path requests
+			std::set<Destination> _control_destinations;
+			std::set<TruncatedHash> _control_hashes;
+
+			// Interfaces for communicating with
+			// local clients connected to a shared
+			// Reticulum instance
+			//static std::set<Interface> _local_client_interfaces;
+			std::set<std::reference_wrapper<const Interface>, std::less<const Interface>> _local_client_interfaces;
+
+			std::map<TruncatedHash, const Interface&> _pending_local_path_requests;
+
+			// CBA
+			Utilities::HashTable<PacketEntry> _packet_table{0, Utilities::OS::PLACE_COLD};           // A lookup table containing announce packets for known paths
+
+			//z _local_client_rssi_cache    = []
+			//z _local_client_snr_cache     = []
+			uint16_t _LOCAL_CLIENT_CACHE_MAXSIZE = 512;
+
+			uint32_t _start_time = 0;
+			bool _jobs_locked = false;
+			bool _jobs_running = false;
+			// CBA Job timing is in ms of OS::ticks()
+			uint32_t _job_interval = 250;
+			uint32_t _jobs_last_run = 0;
+			// CBA Time-sliced jobs
+			Job _jobs[JOB_COUNT] = {
+				{1000,	16},	// JOB_PENDING_LINKS
+				{1000,	16},	// JOB_ACTIVE_LINKS
+				{1000,	16},	// JOB_RECEIPTS
+				{250,	0},		// JOB_ANNOUNCES, timer driven, ms deadlines
+				{60000,	32},	// JOB_REVERSE_CULL
+				{60000,	16},	// JOB_LINK_CULL
+				{60000,	32},	// JOB_PATH_CULL
+				{60000,	32},	// JOB_DISCOVERY_CULL
+				{60000,	32},	// JOB_PATH_REQUEST_CULL
+				{60000,	32},	// JOB_LOCAL_REQUEST_CULL
+				{60000,	8},		// JOB_TUNNEL_CULL
+				{60000,	16}		// JOB_PATH_WARM
+			};
+			uint8_t _jobs_next = 0;
+			uint16_t _jobs_time_budget = 10;
+			std::vector<Packet> _jobs_outgoing;
+			std::vector<Bytes> _jobs_path_requests;
+			bool _saving_path_table = false;
+			uint16_t _hashlist_maxsize = 1024;
+			uint32_t _hashlist_last_saved = 0;
+			uint16_t _max_pr_tags = 32;
+
+			// CBA
+			uint16_t _path_table_maxsize = 100;
+			uint16_t _path_table_maxpersist = 100;
+			uint32_t _last_saved = 0;
+			uint32_t _save_interval = 3600;
+			uint32_t _destination_table_crc = 0;
+			// CBA Bumped whenever a path is added, removed or touched (link_path(), unlink_path(),
+			// touch_path()), write_path_table() skips while it matches the last saved one
+			uint32_t _path_table_epoch = 1;
+			uint32_t _path_table_saved_epoch = 0;
+
+			std::unique_ptr<Reticulum> _owner;		// a handle, held by pointer since Reticulum includes this header
+			Identity _identity{Type::NONE};
+
+			// CBA
+			Callbacks _callbacks;
+
+			// CBA Stats
+			uint32_t _packets_sent = 0;
+			uint32_t _packets_received = 0;
+			uint32_t _packets_fast_forwarded = 0;
+			uint32_t _paths_warmed = 0;
+			uint32_t _path_announces_promoted = 0;
+			uint32_t _prefilter_rejects[PREFILTER_COUNT] = {};
+			uint32_t _announces_queued = 0;
+			uint32_t _announces_shed = 0;
+			uint32_t _announces_rate_blocked = 0;
+			uint32_t _destinations_added = 0;
+			uint32_t _link_requests_rejected = 0;
+			bool _accept_link_requests = true;
+			size_t _last_memory = 0;
+			size_t _last_flash = 0;
+			// BOUNDARY MODE Whitelist: addresses of local devices (from LoRa and LocalTCP interfaces,
+			// CLASS_LOCAL), addresses mentioned in packets from local devices (CLASS_MENTIONED) and our
+			// own control and registered destinations (CLASS_PINNED), aged out when unseen
+			Utilities::Whitelist _boundary_whitelist{
+				Type::Transport::BOUNDARY_WHITELIST_MAXSIZE,
+				Type::Transport::BOUNDARY_MENTIONED_TIMEOUT,
+				Type::Transport::BOUNDARY_LOCAL_TIMEOUT
+			};
+			// CBA Binary path table file (see Utilities/PathStore.h), which includes this header
+			std::unique_ptr<Utilities::PathStore> _path_store;
+			// CBA Raw announce frames by packet hash, in RAM with a single spill file on flash
+			std::unique_ptr<Utilities::PacketCache> _packet_cache;
+			// CBA Scratch list of stale keys collected by the table cull jobs
+			std::vector<Bytes> _stale_entries;
+			// CBA Scratch list of the links swept by a links job, their watchdogs run after the sweep
+			std::vector<Link> _watchdog_links;
+		};
 
-		static Reticulum _owner;
-		static Identity _identity;
+		// CBA The instance the static API currently works on
+		inline static Instance& instance() { return *_instance; }
+		inline static Instance& default_instance() { return _default_instance; }
+		// CBA Makes instance the active one and returns the one that was active. Not
+		// synchronised: only switch while no other task can be inside Transport.
+		static Instance& use(Instance& instance);
 
-		// CBA
-		static Callbacks _callbacks;
-
-		// CBA Stats
-		static uint32_t _packets_sent;
-		static uint32_t _packets_received;
-		static uint32_t _destinations_added;
-		static size_t _last_memory;
-		static size_t _last_flash;
+	private:
+		static Instance _default_instance;
+		static Instance* _instance;
 	};
 
 	template <typename M, typename S> 
@@ -17,7 +17,24 @@ namespace RNS { namespace Type {
 		//static const uint16_t DOCUMENT_MAXSIZE = 1024;
 		static const uint16_t DOCUMENT_MAXSIZE = 8192;
 		//static const uint16_t DOCUMENT_MAXSIZE = 16384;
-		static const uint16_t BUFFER_MAXSIZE = Persistence::DOCUMENT_MAXSIZE * 1.5;	// Json write buffer of 1.5 times document seems to be sufficient
+		static const uint16_t WRITE_CHUNK_SIZE = 256;	// Streaming serializer chunk, bounds write memory regardless of document size
+	}
+
+	namespace Pool {
+		// Slab pools behind packet-sized Bytes buffers (RNS_USE_POOLS)
+		static const uint16_t BUFFER_MIN_SIZE = 128;	// smaller buffers keep using the heap
+		static const uint16_t LORA_BUFFER_SIZE = 512;	// covers the 508 byte LoRa MTU
+		static const uint8_t LORA_BUFFERS = 16;
+		static const uint16_t TCP_BUFFER_SIZE = 1064;	// TCP interface hardware MTU
+		static const uint8_t TCP_BUFFERS = 8;
+		static const uint8_t PACKET_OBJECTS = 24;
+	}
+
+	namespace AnnounceFilter {
+		// Backbone announce filtering on LoRa interfaces (Utilities/AnnounceFilter.h)
+		static const uint16_t REQUESTED_LIFE = 120;		// seconds a local path request lets its announce through
+		static const uint8_t REQUESTED_MAXSIZE = 64;	// path requests remembered, oldest evicted first
+		static const uint8_t SOURCES_MAXSIZE = 32;		// source transport ids tracked per rate rule
 	}
 
 	namespace Cryptography {
@@ -160,6 +177,12 @@ namespace RNS { namespace Type {
 		static const uint16_t DERIVED_KEY_LENGTH        = 512/8;
 		static const uint16_t DERIVED_KEY_LENGTH_LEGACY = 256/8;
 
+		// CBA Recently verified announce hashes and destination to public key bindings kept by validate_announce()
+		static const uint16_t VERIFIED_ANNOUNCES_MAXSIZE = 64;
+		static const uint16_t ANNOUNCE_KEYS_MAXSIZE      = 64;
+		// CBA Identities constructed by recall() kept for hot destinations
+		static const uint16_t RECALLED_IDENTITIES_MAXSIZE = 16;
+
 	}
 
 	namespace Destination {
@@ -216,6 +239,9 @@ namespace RNS { namespace Type {
 		static const uint8_t STALE_GRACE = 2;
 		// Interval for sending keep-alive packets on established links in seconds.
 		static const uint16_t KEEPALIVE = 360;
+		// CBA As RNS, the interval follows the link RTT between these (Link::update_keepalive())
+		static const uint16_t KEEPALIVE_MAX = KEEPALIVE;
+		static const uint8_t KEEPALIVE_MIN  = 5;
 		/*
 		If no traffic or keep-alive packets are received within this period, the
 		link will be marked as stale, and a final keep-alive packet will be sent.
@@ -301,6 +327,10 @@ namespace RNS { namespace Type {
 			MODE_GATEWAY        = 0x40,
 		};
 
+		// Announce scheduler (see Interface::queue_announce())
+		static const uint16_t ANNOUNCE_QUEUE_MAXSIZE = 32;	// announces queued per interface
+		static const uint16_t ANNOUNCE_BURST = 1000;		// bytes that may be sent at once before the cap applies
+
 	}
 
 	namespace Packet {
@@ -423,13 +453,23 @@ namespace RNS { namespace Type {
 		static constexpr const float PATH_REQUEST_GRACE     = 0.35;         // Grace time before a path announcement is made, allows directly reachable peers to respond first
 		static const uint8_t PATH_REQUEST_RW      = 2;            // Path request random window
 		static const uint8_t PATH_REQUEST_MI      = 5;            // Minimum interval in seconds for automated path requests
+		static const uint8_t PATH_REQUEST_COALESCE = 5;           // Path requests for a destination answered on the same interface this recently are not answered again
+		static const uint8_t PATH_RESPONSES_MAXSIZE = 32;         // Recently sent path responses remembered for coalescing
+		static const uint8_t PATH_COST_MARGIN     = 2;            // Equal-hop announces via an interface this many times slower than the current (online) path's don't replace it
+		static const uint8_t INTERFACES_MAXSIZE = 16;             // Registered interfaces addressable by id, ids are 1..INTERFACES_MAXSIZE
 
 		static constexpr const float LINK_TIMEOUT  = Link::STALE_TIME * 1.25;
 		static const uint16_t REVERSE_TIMEOUT      = 30*60;        // Reverse table entries are removed after 30 minutes
 		// CBA MCU
 		//static const uint16_t MAX_RECEIPTS         = 1024;         // Maximum number of receipts to keep track of
 		static const uint16_t MAX_RECEIPTS         = 20;         // Maximum number of receipts to keep track of
-		static const uint8_t MAX_RATE_TIMESTAMPS   = 16;           // Maximum number of announce timestamps to keep per destination
+		static const uint8_t MAX_RATE_TIMESTAMPS   = 16;           // Maximum number of announce timestamps to keep per destination (RNS, only the last is kept here)
+		static const uint16_t ANNOUNCE_RATE_TABLE_MAXSIZE = 256;   // Destinations whose announce rate is tracked
+		// CBA Path warming (see Transport::run_path_warm_job())
+		static const uint8_t PATH_HEAT_MAXSIZE    = 64;           // Destinations whose path request count is tracked
+		static const uint8_t PATH_WARM_THRESHOLD  = 3;            // Requests (decayed) that make a destination hot
+		static const uint16_t PATH_WARM_DECAY     = 60*60;        // Request counts halve after this many seconds
+		static const uint16_t PATH_WARM_INTERVAL  = 2*60;         // Minimum seconds between warming path requests for one destination
 		static const uint8_t PERSIST_RANDOM_BLOBS  = 8;            // Maximum number of random blobs per destination to persist to disk (reduced for MCU memory)
 		static const uint8_t MAX_RANDOM_BLOBS      = 16;           // Maximum number of random blobs per destination to keep in memory (reduced for MCU memory)
 
@@ -444,6 +484,20 @@ namespace RNS { namespace Type {
 		static const uint32_t ROAMING_PATH_TIME = 60*60*1;    // Path expiration of 1 hour for Roaming paths
 
 		static const uint16_t LOCAL_CLIENT_CACHE_MAXSIZE = 512;
+
+		// CBA Boundary firewall whitelist: entries, and how long unseen identifiers stay allowed
+		static const uint16_t BOUNDARY_WHITELIST_MAXSIZE = 384;
+		static const uint32_t BOUNDARY_MENTIONED_TIMEOUT = 30*60;       // Mentioned identifiers, as long as reverse table entries live
+		static const uint32_t BOUNDARY_LOCAL_TIMEOUT     = DESTINATION_TIMEOUT;  // Local device addresses
+		static const uint16_t BOUNDARY_WHITELIST_CULL    = 32;          // Slots checked for expiry per jobs() tick
+
+		// CBA Announces staged for validation from loop(), and how many are validated per loop() pass
+		static const uint8_t ANNOUNCE_VALIDATION_MAXSIZE  = 32;
+		static const uint8_t ANNOUNCE_VALIDATIONS_PER_LOOP = 2;
+
+		// CBA Announce packets kept in RAM for path responses, and further ones indexed in the spill file
+		static const uint16_t PACKET_CACHE_MAXSIZE       = 32;
+		static const uint16_t PACKET_CACHE_SPILL_MAXSIZE = 256;
 	}
 
 	namespace Resource {
@@ -515,6 +569,18 @@ namespace RNS { namespace Type {
 		static const float PER_RETRY_DELAY               = 0.5;
 
 		static const uint8_t WATCHDOG_MAX_SLEEP            = 1;
+		static const uint8_t PROOF_TIMEOUT_FACTOR          = 3;
+		static const float PROCESSING_GRACE              = 1.0;
+
+		// CBA Largest transfer size accepted from a peer, the advertisement is dropped above it
+		static const uint32_t MAX_INCOMING_SIZE            = 1024 * 1024;
+		// CBA Resources whose transfer size exceeds this are spooled to a file in the
+		// cache directory (when a filesystem is registered) instead of being held in RAM
+		static const uint16_t SPOOL_THRESHOLD              = 8 * 1024;
+		// CBA Bytes read from a spooled source per pass while hashing and encrypting
+		static const uint16_t SPOOL_CHUNK_SIZE             = 512;
+		// CBA Attempts at finding a random hash without map hash collisions
+		static const uint8_t HASHMAP_ATTEMPTS              = 4;
 
 		static const uint8_t HASHMAP_IS_NOT_EXHAUSTED = 0x00;
 		static const uint8_t HASHMAP_IS_EXHAUSTED = 0xFF;
@@ -544,6 +610,63 @@ namespace RNS { namespace Type {
 	}
 
 	namespace Channel {
+
+		enum MessageState {
+			MSGSTATE_NEW       = 0,
+			MSGSTATE_SENT      = 1,
+			MSGSTATE_DELIVERED = 2,
+			MSGSTATE_FAILED    = 3,
+		};
+
+		// Message types at or above this value are reserved for system messages
+		static const uint16_t SMT_RESERVED         = 0xf000;
+		static const uint16_t SMT_STREAM_DATA      = 0xff00;
+
+		// Envelope header: msgtype, sequence and length, 16 bits each, big-endian
+		static const uint8_t ENVELOPE_HEADER_SIZE  = 6;
+
+		// The initial window size at channel setup
+		static const uint8_t WINDOW                = 2;
+
+		// Absolute minimum window size
+		static const uint8_t WINDOW_MIN            = 2;
+		static const uint8_t WINDOW_MIN_LIMIT_SLOW   = 2;
+		static const uint8_t WINDOW_MIN_LIMIT_MEDIUM = 5;
+		static const uint8_t WINDOW_MIN_LIMIT_FAST   = 16;
+
+		// The maximum window size for transfers on slow links
+		static const uint8_t WINDOW_MAX_SLOW       = 5;
+
+		// The maximum window size for transfers on mid-speed links
+		static const uint8_t WINDOW_MAX_MEDIUM     = 12;
+
+		// The maximum window size for transfers on fast links
+		static const uint8_t WINDOW_MAX_FAST       = 48;
+
+		// The global maximum window, received envelopes are only
+		// buffered this far ahead of the next expected sequence.
+		static const uint8_t WINDOW_MAX            = WINDOW_MAX_FAST;
+
+		// If the RTT class is sustained for this many delivered
+		// messages, the larger window for that class is allowed.
+		static const uint8_t FAST_RATE_THRESHOLD   = 10;
+
+		// RTT thresholds in seconds for the link speed classes
+		static constexpr const float RTT_FAST      = 0.18;
+		static constexpr const float RTT_MEDIUM    = 0.75;
+		static constexpr const float RTT_SLOW      = 1.45;
+
+		// The minimum allowed flexibility of the window size.
+		// The difference between window_max and window_min
+		// will never be smaller than this value.
+		static const uint8_t WINDOW_FLEXIBILITY    = 4;
+
+		static const uint16_t SEQ_MAX              = 0xFFFF;
+		static const uint32_t SEQ_MODULUS          = 0x10000;
+
+		// Transmissions of an envelope before the link is torn down
+		static const uint8_t MAX_TRIES             = 5;
+
 	}
 
 } }
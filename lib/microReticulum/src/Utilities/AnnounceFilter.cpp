@@ -0,0 +1,136 @@
+#include "AnnounceFilter.h"
+
+#include "OS.h"
+#include "../Log.h"
+
+using namespace RNS;
+using namespace RNS::Utilities;
+
+// Announce payload starts with the public key followed by the name hash
+static const size_t NAME_HASH_OFFSET = Type::Identity::KEYSIZE/8;
+static const size_t NAME_HASH_SIZE = Type::Identity::NAME_HASH_LENGTH/8;
+
+size_t AnnounceFilter::add_hops_rule(uint8_t max_hops) {
+	Rule rule(RULE_HOPS, ACTION_DROP);
+	rule._max_hops = max_hops;
+	_rules.push_back(rule);
+	return _rules.size() - 1;
+}
+
+size_t AnnounceFilter::add_name_hash_rule(const Bytes& name_hash, actions action /*= ACTION_DROP*/) {
+	Rule rule(RULE_NAME_HASH, action);
+	rule._name_hash = name_hash.left(NAME_HASH_SIZE);
+	_rules.push_back(rule);
+	return _rules.size() - 1;
+}
+
+size_t AnnounceFilter::add_source_rate_rule(uint16_t count, double window) {
+	Rule rule(RULE_SOURCE_RATE, ACTION_DROP);
+	rule._count = count;
+	rule._window = window;
+	_rules.push_back(rule);
+	return _rules.size() - 1;
+}
+
+size_t AnnounceFilter::add_requested_rule() {
+	_rules.push_back(Rule(RULE_REQUESTED, ACTION_DROP));
+	return _rules.size() - 1;
+}
+
+void AnnounceFilter::clear() {
+	_rules.clear();
+	_requested.clear();
+	_evaluated = 0;
+	_dropped = 0;
+}
+
+bool AnnounceFilter::allow(const Bytes& destination_hash, const Bytes& announce_data, uint8_t hops, const Bytes& source) {
+	if (_rules.empty()) {
+		return true;
+	}
+	++_evaluated;
+	double now = OS::time();
+	bool allowed = true;
+	for (Rule& rule : _rules) {
+		++rule._evaluated;
+		if (matches(rule, destination_hash, announce_data, hops, source, now)) {
+			if (rule._action == ACTION_ACCEPT) {
+				++rule._accepted;
+			}
+			else {
+				++rule._dropped;
+				allowed = false;
+			}
+			break;
+		}
+	}
+	if (!allowed) {
+		++_dropped;
+		return false;
+	}
+	// Only announces that are actually forwarded count against the source rates
+	for (Rule& rule : _rules) {
+		if (rule._type == RULE_SOURCE_RATE && source) {
+			RateEntry& entry = rule._sources[source];
+			if (now - entry._window_start > rule._window) {
+				entry._window_start = now;
+				entry._count = 0;
+			}
+			++entry._count;
+		}
+	}
+	return true;
+}
+
+bool AnnounceFilter::matches(Rule& rule, const Bytes& destination_hash, const Bytes& announce_data, uint8_t hops, const Bytes& source, double now) {
+	switch (rule._type) {
+	case RULE_HOPS:
+		return hops > rule._max_hops;
+	case RULE_NAME_HASH:
+		return announce_data.size() >= NAME_HASH_OFFSET + NAME_HASH_SIZE && rule._name_hash == announce_data.mid(NAME_HASH_OFFSET, NAME_HASH_SIZE);
+	case RULE_SOURCE_RATE:
+	{
+		if (!source) {
+			return false;
+		}
+		auto iter = rule._sources.find(source);
+		if (iter == rule._sources.end()) {
+			return false;
+		}
+		const RateEntry& entry = (*iter).second;
+		return (now - entry._window_start <= rule._window) && entry._count >= rule._count;
+	}
+	case RULE_REQUESTED:
+	{
+		auto iter = _requested.find(destination_hash);
+		return iter == _requested.end() || now - (*iter).second > Type::AnnounceFilter::REQUESTED_LIFE;
+	}
+	}
+	return false;
+}
+
+void AnnounceFilter::requested(const Bytes& destination_hash) {
+	// CBA Fixed capacity, the oldest request is evicted when full
+	_requested.insert_or_assign(destination_hash, OS::time());
+}
+
+/*static*/ const char* AnnounceFilter::rule_name(rule_types type) {
+	switch (type) {
+	case RULE_HOPS:			return "hops";
+	case RULE_NAME_HASH:	return "name_hash";
+	case RULE_SOURCE_RATE:	return "source_rate";
+	case RULE_REQUESTED:	return "requested";
+	}
+	return "unknown";
+}
+
+void AnnounceFilter::dump_stats() const {
+	if (_rules.empty()) {
+		return;
+	}
+	VERBOSEF("announce filter: evaluated: %u dropped: %u requested: %u", _evaluated, _dropped, _requested.size());
+	for (size_t i = 0; i < _rules.size(); i++) {
+		const Rule& rule = _rules[i];
+		VERBOSEF("  rule %u %s: evaluated: %u accepted: %u dropped: %u", i, rule_name(rule._type), rule._evaluated, rule._accepted, rule._dropped);
+	}
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "../Bytes.h"
+#include "../Type.h"
+#include "HashTable.h"
+
+#include <vector>
+#include <stdint.h>
+
+namespace RNS { namespace Utilities {
+
+	// CBA Rule engine deciding which announces heard on the backbone are rebroadcast on
+	// interfaces that have filter_announces() set (the LoRa interface on a boundary node).
+	//
+	// Rules are evaluated in the order they were added and the first rule that matches
+	// decides, an announce that matches no rule is forwarded:
+	//
+	//   RULE_HOPS         drops announces that have travelled more than max_hops
+	//   RULE_NAME_HASH    accepts or drops announces for one app name/aspects hash
+	//   RULE_SOURCE_RATE  drops announces from a source transport instance once it has had
+	//                     more than count announces forwarded within window seconds
+	//   RULE_REQUESTED    drops announces for destinations that no local path request
+	//                     asked for within the last REQUESTED_LIFE seconds
+	//
+	// so a RULE_NAME_HASH accept rule added first exempts that app from all later rules.
+	// Every rule counts the announces it was evaluated for and the ones it decided.
+	class AnnounceFilter {
+
+	public:
+		enum rule_types : uint8_t {
+			RULE_HOPS = 0,
+			RULE_NAME_HASH,
+			RULE_SOURCE_RATE,
+			RULE_REQUESTED,
+		};
+
+		enum actions : uint8_t {
+			ACTION_DROP = 0,
+			ACTION_ACCEPT,
+		};
+
+		struct RateEntry {
+			double _window_start = 0;
+			uint16_t _count = 0;
+		};
+
+		class Rule {
+		public:
+			Rule(rule_types type, actions action) : _type(type), _action(action), _sources(Type::AnnounceFilter::SOURCES_MAXSIZE) {}
+		public:
+			rule_types _type;
+			actions _action;
+			uint8_t _max_hops = 0;
+			Bytes _name_hash;
+			uint16_t _count = 0;
+			double _window = 0;
+			HashTable<RateEntry> _sources;	// RULE_SOURCE_RATE, keyed on source transport id
+			uint32_t _evaluated = 0;
+			uint32_t _accepted = 0;
+			uint32_t _dropped = 0;
+		};
+
+	public:
+		AnnounceFilter() : _requested(Type::AnnounceFilter::REQUESTED_MAXSIZE) {}
+
+	private:
+		AnnounceFilter(const AnnounceFilter&) = delete;
+		AnnounceFilter& operator=(const AnnounceFilter&) = delete;
+
+	public:
+		// Each returns the index of the new rule
+		size_t add_hops_rule(uint8_t max_hops);
+		size_t add_name_hash_rule(const Bytes& name_hash, actions action = ACTION_DROP);
+		size_t add_source_rate_rule(uint16_t count, double window);
+		size_t add_requested_rule();
+		void clear();
+
+		// True if the announce for destination_hash (with announce payload data) may be forwarded
+		bool allow(const Bytes& destination_hash, const Bytes& announce_data, uint8_t hops, const Bytes& source);
+		// Record a local path request so that RULE_REQUESTED lets the answering announce through
+		void requested(const Bytes& destination_hash);
+
+		void dump_stats() const;
+
+		inline const std::vector<Rule>& rules() const { return _rules; }
+		inline bool empty() const { return _rules.empty(); }
+		inline uint32_t evaluated() const { return _evaluated; }
+		inline uint32_t dropped() const { return _dropped; }
+
+		static const char* rule_name(rule_types type);
+
+	private:
+		bool matches(Rule& rule, const Bytes& destination_hash, const Bytes& announce_data, uint8_t hops, const Bytes& source, double now);
+
+	private:
+		std::vector<Rule> _rules;
+		HashTable<double> _requested;			// destination hash -> time of the path request
+		uint32_t _evaluated = 0;
+		uint32_t _dropped = 0;
+
+	};
+
+} }
@@ -0,0 +1,168 @@
+#include "Compression.h"
+
+#include <algorithm>
+#include <string.h>
+
+using namespace RNS;
+using namespace RNS::Utilities;
+
+LzCompressor::LzCompressor() {
+	_group[0] = 0;
+	for (uint16_t i = 0; i < HASH_SIZE; i++) {
+		_head[i] = -1;
+	}
+}
+
+void LzCompressor::update(const uint8_t* data, size_t len, Bytes& output) {
+	while (len > 0) {
+		if (_length == sizeof(_buffer)) {
+			slide();
+		}
+		size_t size = std::min<size_t>(len, sizeof(_buffer) - _length);
+		memcpy(_buffer + _length, data, size);
+		_length += size;
+		data += size;
+		len -= size;
+		// Keep a whole match worth of lookahead
+		if (_length > _position + MAX_MATCH) {
+			encode(_length - MAX_MATCH, output);
+		}
+	}
+}
+
+void LzCompressor::finish(Bytes& output) {
+	encode(_length, output);
+	flush_group(output);
+}
+
+void LzCompressor::encode(size_t end, Bytes& output) {
+	while (_position < end) {
+		size_t best_length = 0;
+		size_t best_distance = 0;
+		size_t available = std::min<size_t>(_length - _position, MAX_MATCH);
+		if (available >= MIN_MATCH) {
+			const uint8_t* current = _buffer + _position;
+			uint32_t hash = ((uint32_t)current[0] | ((uint32_t)current[1] << 8) | ((uint32_t)current[2] << 16)) * 2654435761u >> 23;
+			int32_t candidate = _head[hash];
+			int32_t lowest = (int32_t)_position - WINDOW;
+			for (uint8_t chain = 0; candidate >= 0 && candidate >= lowest && chain < MAX_CHAIN; chain++) {
+				const uint8_t* match = _buffer + candidate;
+				size_t length = 0;
+				while (length < available && match[length] == current[length]) {
+					length++;
+				}
+				if (length > best_length) {
+					best_length = length;
+					best_distance = _position - candidate;
+					if (length == available) {
+						break;
+					}
+				}
+				candidate = _prev[candidate];
+			}
+		}
+
+		uint8_t item = _group_items++;
+		if (best_length >= MIN_MATCH) {
+			uint16_t reference = (uint16_t)(((best_distance - 1) << 6) | (best_length - MIN_MATCH));
+			_group[0] &= ~(1 << item);
+			_group[_group_size++] = (uint8_t)(reference >> 8);
+			_group[_group_size++] = (uint8_t)reference;
+		}
+		else {
+			best_length = 1;
+			_group[0] |= (1 << item);
+			_group[_group_size++] = _buffer[_position];
+		}
+		if (_group_items == 8) {
+			flush_group(output);
+		}
+		for (size_t i = 0; i < best_length; i++) {
+			insert(_position++);
+		}
+	}
+}
+
+void LzCompressor::insert(size_t position) {
+	if (position + MIN_MATCH > _length) {
+		return;
+	}
+	const uint8_t* current = _buffer + position;
+	uint32_t hash = ((uint32_t)current[0] | ((uint32_t)current[1] << 8) | ((uint32_t)current[2] << 16)) * 2654435761u >> 23;
+	_prev[position] = _head[hash];
+	_head[hash] = (int16_t)position;
+}
+
+// Drops the older half of the buffer, it is out of reach of the next position
+void LzCompressor::slide() {
+	memmove(_buffer, _buffer + WINDOW, WINDOW);
+	for (uint16_t i = 0; i < HASH_SIZE; i++) {
+		_head[i] = (_head[i] >= (int16_t)WINDOW) ? (int16_t)(_head[i] - WINDOW) : -1;
+	}
+	for (uint16_t i = 0; i < WINDOW; i++) {
+		int16_t prev = _prev[i + WINDOW];
+		_prev[i] = (prev >= (int16_t)WINDOW) ? (int16_t)(prev - WINDOW) : -1;
+	}
+	_position -= WINDOW;
+	_length -= WINDOW;
+}
+
+void LzCompressor::flush_group(Bytes& output) {
+	if (_group_items == 0) {
+		return;
+	}
+	output.append(_group, _group_size);
+	_group[0] = 0;
+	_group_size = 1;
+	_group_items = 0;
+}
+
+bool LzDecompressor::update(const uint8_t* data, size_t len, Bytes& output, size_t limit /*= SIZE_MAX*/) {
+	uint8_t decoded[128];
+	size_t count = 0;
+	auto put = [&](uint8_t byte) {
+		_window[_total++ % LzCompressor::WINDOW] = byte;
+		decoded[count++] = byte;
+		if (count == sizeof(decoded)) {
+			output.append(decoded, count);
+			count = 0;
+		}
+	};
+	for (size_t i = 0; i < len; i++) {
+		uint8_t byte = data[i];
+		if (_items == 0) {
+			_flags = byte;
+			_items = 8;
+			continue;
+		}
+		if (_flags & 0x01) {
+			if (_total >= limit) {
+				return false;
+			}
+			put(byte);
+		}
+		else if (!_have_high) {
+			_high = byte;
+			_have_high = true;
+			continue;
+		}
+		else {
+			uint16_t reference = ((uint16_t)_high << 8) | byte;
+			size_t distance = (reference >> 6) + 1;
+			size_t length = (reference & 0x3f) + LzCompressor::MIN_MATCH;
+			_have_high = false;
+			if (distance > _total || length > limit - _total) {
+				return false;
+			}
+			for (size_t n = 0; n < length; n++) {
+				put(_window[(_total - distance) % LzCompressor::WINDOW]);
+			}
+		}
+		_flags >>= 1;
+		_items--;
+	}
+	if (count > 0) {
+		output.append(decoded, count);
+	}
+	return true;
+}
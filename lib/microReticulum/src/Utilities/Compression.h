@@ -0,0 +1,86 @@
+#pragma once
+
+#include "../Bytes.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace RNS { namespace Utilities {
+
+	// CBA Streaming LZSS compressor and decompressor with a small window, in place of the
+	// bz2 RNS uses for resources, which needs several hundred kilobytes of RAM.
+	//
+	// The stream is a series of groups, each a flag byte followed by up to eight items. A
+	// set flag bit (LSB first) is a literal byte, a clear one a two byte back reference:
+	// distance - 1 in the high 10 bits and length - 3 in the low 6, both big endian. A
+	// reference may overlap the bytes it produces.
+	//
+	// Matches are found through hash chains over the last WINDOW bytes. The compressor
+	// holds about 6 KB of state, the decompressor only the window, so both can be kept for
+	// the length of a transfer. Data is passed through in pieces of any size and the output
+	// is appended as it is produced.
+	class LzCompressor {
+
+	public:
+		static const uint16_t WINDOW = 1024;
+		static const uint8_t MIN_MATCH = 3;
+		static const uint8_t MAX_MATCH = 66;
+
+	public:
+		LzCompressor();
+
+	public:
+		// Compresses data onto output, the last MAX_MATCH bytes are held back until more
+		// data or finish() arrives
+		void update(const uint8_t* data, size_t len, Bytes& output);
+		inline void update(const Bytes& data, Bytes& output) { update(data.data(), data.size(), output); }
+		// Compresses whatever is held back and ends the stream
+		void finish(Bytes& output);
+
+	private:
+		void encode(size_t end, Bytes& output);
+		void insert(size_t position);
+		void slide();
+		void flush_group(Bytes& output);
+
+	private:
+		static const uint16_t HASH_SIZE = 512;
+		static const uint8_t MAX_CHAIN = 32;
+
+		uint8_t _buffer[2 * WINDOW];
+		int16_t _head[HASH_SIZE];
+		int16_t _prev[2 * WINDOW];
+		size_t _position = 0;	// next byte of _buffer to encode
+		size_t _length = 0;		// bytes of _buffer in use
+
+		uint8_t _group[1 + 8 * 2];
+		uint8_t _group_size = 1;
+		uint8_t _group_items = 0;
+
+	};
+
+	class LzDecompressor {
+
+	public:
+		LzDecompressor() {}
+
+	public:
+		// Decompresses data onto output, returns false if the stream is malformed or would
+		// decompress to more than limit bytes in total
+		bool update(const uint8_t* data, size_t len, Bytes& output, size_t limit = SIZE_MAX);
+		inline bool update(const Bytes& data, Bytes& output, size_t limit = SIZE_MAX) { return update(data.data(), data.size(), output, limit); }
+		// false if the stream ended in the middle of a back reference
+		inline bool finished() const { return !_have_high; }
+		inline size_t total() const { return _total; }
+
+	private:
+		uint8_t _window[LzCompressor::WINDOW];
+		size_t _total = 0;
+		uint8_t _flags = 0;
+		uint8_t _items = 0;		// items left in the current group
+		uint8_t _high = 0;		// first byte of a back reference
+		bool _have_high = false;
+
+	};
+
+} }
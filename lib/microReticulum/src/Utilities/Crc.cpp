@@ -1,16 +1,70 @@
 #include "Crc.h"
 
+#if defined(ESP32)
+#include <esp_rom_crc.h>
+#endif
+
 using namespace RNS::Utilities;
 
+#if !defined(ESP32)
+namespace {
+
+	// CBA Slice-by-8 tables for the reflected polynomial 0xedb88320, built at compile time so
+	// they live in flash. Table k advances a byte through k further zero bytes.
+	struct CrcTables {
+		uint32_t _table[8][256];
+	};
+
+	constexpr CrcTables make_tables() {
+		CrcTables tables{};
+		for (uint32_t i = 0; i < 256; i++) {
+			uint32_t crc = i;
+			for (unsigned k = 0; k < 8; k++) {
+				crc = (crc & 1) ? (crc >> 1) ^ 0xedb88320 : crc >> 1;
+			}
+			tables._table[0][i] = crc;
+		}
+		for (uint32_t i = 0; i < 256; i++) {
+			for (unsigned k = 1; k < 8; k++) {
+				uint32_t previous = tables._table[k - 1][i];
+				tables._table[k][i] = (previous >> 8) ^ tables._table[0][previous & 0xff];
+			}
+		}
+		return tables;
+	}
+
+	constexpr CrcTables crc_tables = make_tables();
+
+}
+#endif
+
 /*static*/ uint32_t Crc::crc32(uint32_t crc, const uint8_t* buf, size_t size) {
 	const unsigned char *data = (const unsigned char *)buf;
 	if (data == NULL)
 		return 0;
+#if defined(ESP32)
+	// CBA ROM routine, same conditioning (inverted in and out) as below
+	return esp_rom_crc32_le(crc, data, size);
+#else
+	const auto& table = crc_tables._table;
 	crc ^= 0xffffffff;
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+	// CBA Eight bytes per step, the words are loaded with memcpy() so data needn't be aligned
+	while (size >= 8) {
+		uint32_t low;
+		uint32_t high;
+		memcpy(&low, data, sizeof(low));
+		memcpy(&high, data + 4, sizeof(high));
+		low ^= crc;
+		crc = table[7][low & 0xff] ^ table[6][(low >> 8) & 0xff] ^ table[5][(low >> 16) & 0xff] ^ table[4][low >> 24] ^
+			table[3][high & 0xff] ^ table[2][(high >> 8) & 0xff] ^ table[1][(high >> 16) & 0xff] ^ table[0][high >> 24];
+		data += 8;
+		size -= 8;
+	}
+#endif
 	while (size--) {
-		crc ^= *data++;
-		for (unsigned k = 0; k < 8; k++)
-			crc = crc & 1 ? (crc >> 1) ^ 0xedb88320 : crc >> 1;
+		crc = (crc >> 8) ^ table[0][(crc ^ *data++) & 0xff];
 	}
 	return crc ^ 0xffffffff;
+#endif
 }
@@ -0,0 +1,232 @@
+#include "HashList.h"
+
+#include "../Log.h"
+
+#include <string.h>
+
+using namespace RNS;
+using namespace RNS::Utilities;
+
+HashList::HashList(size_t capacity) {
+	// ring slots are addressed with 16-bit indexes, NIL is reserved
+	_capacity = (capacity < NIL) ? capacity : NIL - 1;
+	MEM("HashList object created");
+}
+
+HashList::~HashList() {
+	release();
+	MEM("HashList object destroyed");
+}
+
+void HashList::capacity(size_t capacity) {
+	if (capacity >= NIL) {
+		capacity = NIL - 1;
+	}
+	if (capacity == _capacity) {
+		return;
+	}
+	release();
+	_capacity = capacity;
+}
+
+size_t HashList::memory_usage() const {
+	if (_entries == nullptr) {
+		return 0;
+	}
+	return (_capacity * ENTRY_SIZE) + (_capacity * sizeof(uint16_t)) + (_bucket_count * sizeof(uint16_t)) + (_bloom_counters / 2);
+}
+
+bool HashList::allocate() {
+	if (_entries != nullptr) {
+		return true;
+	}
+	if (_capacity == 0) {
+		return false;
+	}
+	// roughly two entries per bucket
+	_bucket_count = 1;
+	while (_bucket_count * 2 < _capacity) {
+		_bucket_count <<= 1;
+	}
+	// 8 counters per entry with 3 hashes keeps false positives around 3%
+	_bloom_counters = 16;
+	while (_bloom_counters < _capacity * 8) {
+		_bloom_counters <<= 1;
+	}
+	_entries = new uint8_t[_capacity * ENTRY_SIZE];
+	_next = new uint16_t[_capacity];
+	_buckets = new uint16_t[_bucket_count];
+	_bloom = new uint8_t[_bloom_counters / 2];
+	if (_entries == nullptr || _next == nullptr || _buckets == nullptr || _bloom == nullptr) {
+		ERROR("HashList: failed to allocate storage");
+		release();
+		return false;
+	}
+	clear();
+	TRACEF("HashList: allocated %u entries (%u bytes)", _capacity, memory_usage());
+	return true;
+}
+
+void HashList::release() {
+	delete[] _entries;
+	delete[] _next;
+	delete[] _buckets;
+	delete[] _bloom;
+	_entries = nullptr;
+	_next = nullptr;
+	_buckets = nullptr;
+	_bloom = nullptr;
+	_bucket_count = 0;
+	_bloom_counters = 0;
+	_size = 0;
+	_head = 0;
+}
+
+void HashList::clear() {
+	_size = 0;
+	_head = 0;
+	if (_entries == nullptr) {
+		return;
+	}
+	for (uint32_t i = 0; i < _bucket_count; i++) {
+		_buckets[i] = NIL;
+	}
+	for (size_t i = 0; i < _capacity; i++) {
+		_next[i] = NIL;
+	}
+	memset(_bloom, 0, _bloom_counters / 2);
+}
+
+/*static*/ void HashList::normalize(const Bytes& hash, uint8_t* key) {
+	memset(key, 0, ENTRY_SIZE);
+	memcpy(key, hash.data(), (hash.size() < ENTRY_SIZE) ? hash.size() : ENTRY_SIZE);
+}
+
+void HashList::bloom_add(const uint8_t* key) {
+	for (uint8_t k = 0; k < BLOOM_HASHES; k++) {
+		const uint8_t* h = key + (k * 4);
+		uint32_t index = ((uint32_t)h[0] | ((uint32_t)h[1] << 8) | ((uint32_t)h[2] << 16) | ((uint32_t)h[3] << 24)) & (_bloom_counters - 1);
+		uint8_t value = counter(index);
+		// saturated counters stick, costing at most a false positive
+		if (value < 0x0F) {
+			_bloom[index >> 1] += (1 << ((index & 1) << 2));
+		}
+	}
+}
+
+void HashList::bloom_remove(const uint8_t* key) {
+	for (uint8_t k = 0; k < BLOOM_HASHES; k++) {
+		const uint8_t* h = key + (k * 4);
+		uint32_t index = ((uint32_t)h[0] | ((uint32_t)h[1] << 8) | ((uint32_t)h[2] << 16) | ((uint32_t)h[3] << 24)) & (_bloom_counters - 1);
+		uint8_t value = counter(index);
+		if (value > 0 && value < 0x0F) {
+			_bloom[index >> 1] -= (1 << ((index & 1) << 2));
+		}
+	}
+}
+
+bool HashList::bloom_test(const uint8_t* key) const {
+	for (uint8_t k = 0; k < BLOOM_HASHES; k++) {
+		const uint8_t* h = key + (k * 4);
+		uint32_t index = ((uint32_t)h[0] | ((uint32_t)h[1] << 8) | ((uint32_t)h[2] << 16) | ((uint32_t)h[3] << 24)) & (_bloom_counters - 1);
+		if (counter(index) == 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+int32_t HashList::find_slot(const uint8_t* key) const {
+	uint16_t slot = _buckets[bucket_of(key)];
+	while (slot != NIL) {
+		if (memcmp(_entries + (slot * ENTRY_SIZE), key, ENTRY_SIZE) == 0) {
+			return slot;
+		}
+		slot = _next[slot];
+	}
+	return -1;
+}
+
+void HashList::unlink_slot(uint16_t slot) {
+	uint16_t* link = &_buckets[bucket_of(_entries + (slot * ENTRY_SIZE))];
+	while (*link != NIL) {
+		if (*link == slot) {
+			*link = _next[slot];
+			_next[slot] = NIL;
+			return;
+		}
+		link = &_next[*link];
+	}
+}
+
+bool HashList::contains(const Bytes& hash) const {
+	uint8_t key[ENTRY_SIZE];
+	normalize(hash, key);
+	return contains(key);
+}
+
+bool HashList::contains(const uint8_t* key) const {
+	if (_size == 0) {
+		return false;
+	}
+	if (!bloom_test(key)) {
+		++_bloom_rejects;
+		return false;
+	}
+	if (find_slot(key) < 0) {
+		++_bloom_false_positives;
+		return false;
+	}
+	return true;
+}
+
+bool HashList::insert(const Bytes& hash) {
+	if (!allocate()) {
+		return false;
+	}
+	uint8_t key[ENTRY_SIZE];
+	normalize(hash, key);
+	if (bloom_test(key) && find_slot(key) >= 0) {
+		return false;
+	}
+	uint16_t slot = (uint16_t)_head;
+	if (_size == _capacity) {
+		// overwrite oldest entry
+		bloom_remove(_entries + (slot * ENTRY_SIZE));
+		unlink_slot(slot);
+	}
+	else {
+		++_size;
+	}
+	memcpy(_entries + (slot * ENTRY_SIZE), key, ENTRY_SIZE);
+	uint32_t bucket = bucket_of(key);
+	_next[slot] = _buckets[bucket];
+	_buckets[bucket] = slot;
+	bloom_add(key);
+	_head = (_head + 1) % _capacity;
+	return true;
+}
+
+Bytes HashList::serialize() const {
+	Bytes data;
+	if (_size == 0) {
+		return data;
+	}
+	// oldest entry is at slot 0 until the ring wraps, then at _head
+	size_t start = (_size < _capacity) ? 0 : _head;
+	uint8_t* buffer = data.writable(_size * ENTRY_SIZE);
+	for (size_t i = 0; i < _size; i++) {
+		memcpy(buffer + (i * ENTRY_SIZE), _entries + (((start + i) % _capacity) * ENTRY_SIZE), ENTRY_SIZE);
+	}
+	return data;
+}
+
+size_t HashList::deserialize(const Bytes& data) {
+	size_t count = 0;
+	for (size_t offset = 0; offset + ENTRY_SIZE <= data.size(); offset += ENTRY_SIZE) {
+		if (insert(Bytes(data.data() + offset, ENTRY_SIZE))) {
+			++count;
+		}
+	}
+	return count;
+}
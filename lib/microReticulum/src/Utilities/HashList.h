@@ -0,0 +1,87 @@
+#pragma once
+
+#include "../Bytes.h"
+#include "../Type.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace RNS { namespace Utilities {
+
+	// CBA Fixed-size FIFO of packet hashes for duplicate detection.
+	//
+	// Hashes are stored as their leading ENTRY_SIZE bytes in a ring buffer, so once
+	// the list is full each insert overwrites the oldest entry (unlike the std::set it
+	// replaces, which culled the lexically smallest hashes). Ring slots are chained into
+	// hash buckets for O(1) membership checks, and a counting Bloom filter of 4-bit
+	// counters sits in front of the ring so that most unseen hashes are rejected
+	// without touching ring memory at all (which may live in PSRAM).
+	//
+	// Storage is allocated lazily on first insert.
+	class HashList {
+
+	public:
+		static const uint8_t ENTRY_SIZE = Type::Reticulum::TRUNCATED_HASHLENGTH / 8;
+
+	public:
+		HashList(size_t capacity = 0);
+		~HashList();
+
+	private:
+		HashList(const HashList&) = delete;
+		HashList& operator=(const HashList&) = delete;
+
+	public:
+		bool contains(const Bytes& hash) const;
+		// hash is at least ENTRY_SIZE bytes
+		bool contains(const uint8_t* hash) const;
+		// returns false if hash was already present
+		bool insert(const Bytes& hash);
+		void clear();
+
+		inline size_t size() const { return _size; }
+		inline bool empty() const { return _size == 0; }
+		inline size_t capacity() const { return _capacity; }
+		// changing capacity discards all entries
+		void capacity(size_t capacity);
+		size_t memory_usage() const;
+
+		// Entries are (de)serialized oldest-first as raw ENTRY_SIZE byte records
+		Bytes serialize() const;
+		size_t deserialize(const Bytes& data);
+
+		inline uint32_t bloom_rejects() const { return _bloom_rejects; }
+		inline uint32_t bloom_false_positives() const { return _bloom_false_positives; }
+
+	private:
+		bool allocate();
+		void release();
+		inline uint32_t bucket_of(const uint8_t* key) const { return ((uint32_t)key[12] | ((uint32_t)key[13] << 8) | ((uint32_t)key[14] << 16) | ((uint32_t)key[15] << 24)) & (_bucket_count - 1); }
+		inline uint8_t counter(uint32_t index) const { return (_bloom[index >> 1] >> ((index & 1) << 2)) & 0x0F; }
+		void bloom_add(const uint8_t* key);
+		void bloom_remove(const uint8_t* key);
+		bool bloom_test(const uint8_t* key) const;
+		int32_t find_slot(const uint8_t* key) const;
+		void unlink_slot(uint16_t slot);
+		static void normalize(const Bytes& hash, uint8_t* key);
+
+	private:
+		static const uint16_t NIL = 0xFFFF;
+		static const uint8_t BLOOM_HASHES = 3;
+
+		size_t _capacity = 0;
+		size_t _size = 0;
+		size_t _head = 0;			// next ring slot to write (oldest entry once full)
+		uint8_t* _entries = nullptr;	// _capacity * ENTRY_SIZE
+		uint16_t* _next = nullptr;		// per-slot bucket chain
+		uint16_t* _buckets = nullptr;	// bucket chain heads
+		uint32_t _bucket_count = 0;
+		uint8_t* _bloom = nullptr;		// packed 4-bit counters
+		uint32_t _bloom_counters = 0;
+
+		mutable uint32_t _bloom_rejects = 0;
+		mutable uint32_t _bloom_false_positives = 0;
+
+	};
+
+} }
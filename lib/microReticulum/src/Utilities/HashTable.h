@@ -0,0 +1,445 @@
+#pragma once
+
+#include "../Bytes.h"
+#include "../Type.h"
+#include "OS.h"
+
+#include <utility>
+#include <iterator>
+#include <new>
+#include <stdint.h>
+#include <string.h>
+
+namespace RNS { namespace Utilities {
+
+	// CBA Flat open-addressing hash table keyed on Bytes hashes.
+	//
+	// Drop-in replacement for the subset of std::map<Bytes, T> used by Transport for
+	// its hot lookup tables (path, link, reverse, announce and packet tables). All
+	// slots live in a single contiguous allocation (which lands in the PSRAM TLSF pool
+	// on boards that have one), and the first KEY_SIZE bytes of every key are stored
+	// inline in the slot so that probing compares raw bytes without dereferencing the
+	// Bytes shared data. Keys are themselves truncated SHA-256 hashes, so their
+	// leading bytes are used directly as the hash value.
+	//
+	// Capacity of zero (the default) lets the table grow by doubling. A non-zero
+	// capacity fixes the maximum number of entries, and inserting into a full table
+	// evicts the least-recently-used entry (entries are touched on insert and on
+	// non-const find). The slot array is allocated from the heap given by placement,
+	// so tables touched on every forwarded packet can be kept in internal SRAM.
+	//
+	// Iteration order is slot order, NOT key order. Erase never moves other entries,
+	// so iterators stay valid across erase; insert may rehash and invalidate them.
+	template <typename T>
+	class HashTable {
+
+	public:
+		using key_type = Bytes;
+		using mapped_type = T;
+		using value_type = std::pair<const Bytes, T>;
+		using size_type = size_t;
+
+		static const uint8_t KEY_SIZE = Type::Reticulum::TRUNCATED_HASHLENGTH / 8;
+		static const size_t MIN_SLOTS = 8;
+
+	private:
+		enum SlotState : uint8_t {
+			SLOT_EMPTY = 0,
+			SLOT_USED,
+			SLOT_DELETED
+		};
+
+		struct Slot {
+			uint8_t _state;
+			uint8_t _key_len;
+			uint8_t _key[KEY_SIZE];
+			uint32_t _stamp;
+			alignas(value_type) unsigned char _storage[sizeof(value_type)];
+
+			inline value_type& pair() { return *reinterpret_cast<value_type*>(_storage); }
+			inline const value_type& pair() const { return *reinterpret_cast<const value_type*>(_storage); }
+		};
+
+	public:
+		template <bool CONST>
+		class Iterator {
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = typename HashTable::value_type;
+			using difference_type = std::ptrdiff_t;
+			using pointer = typename std::conditional<CONST, const value_type*, value_type*>::type;
+			using reference = typename std::conditional<CONST, const value_type&, value_type&>::type;
+			using slot_pointer = typename std::conditional<CONST, const Slot*, Slot*>::type;
+
+		public:
+			Iterator() {}
+			Iterator(slot_pointer slot, slot_pointer end) : _slot(slot), _end(end) { skip(); }
+			// allow iterator -> const_iterator conversion
+			template <bool C = CONST, typename std::enable_if<C, int>::type = 0>
+			Iterator(const Iterator<false>& other) : _slot(other._slot), _end(other._end) {}
+
+			inline reference operator*() const { return _slot->pair(); }
+			inline pointer operator->() const { return &_slot->pair(); }
+			inline Iterator& operator++() { ++_slot; skip(); return *this; }
+			inline Iterator operator++(int) { Iterator tmp(*this); ++(*this); return tmp; }
+			inline bool operator==(const Iterator& other) const { return _slot == other._slot; }
+			inline bool operator!=(const Iterator& other) const { return _slot != other._slot; }
+
+		private:
+			inline void skip() { while (_slot != _end && _slot->_state != SLOT_USED) ++_slot; }
+
+		private:
+			slot_pointer _slot = nullptr;
+			slot_pointer _end = nullptr;
+
+		friend class HashTable;
+		friend class Iterator<true>;
+		};
+
+		using iterator = Iterator<false>;
+		using const_iterator = Iterator<true>;
+
+	public:
+		HashTable(size_t capacity = 0, OS::Placement placement = OS::PLACE_DEFAULT) : _capacity(capacity), _placement(placement) {
+			MEM("HashTable object created");
+		}
+		HashTable(const HashTable& other) : _capacity(other._capacity), _placement(other._placement) {
+			MEM("HashTable object copy created");
+			insert(other.begin(), other.end());
+		}
+		HashTable(HashTable&& other) noexcept {
+			MEM("HashTable object move created");
+			swap(other);
+		}
+		~HashTable() {
+			destroy();
+			MEM("HashTable object destroyed");
+		}
+
+		HashTable& operator=(const HashTable& other) {
+			if (this != &other) {
+				clear();
+				_capacity = other._capacity;
+				insert(other.begin(), other.end());
+			}
+			return *this;
+		}
+		HashTable& operator=(HashTable&& other) noexcept {
+			if (this != &other) {
+				destroy();
+				swap(other);
+			}
+			return *this;
+		}
+
+		void swap(HashTable& other) noexcept {
+			std::swap(_slots, other._slots);
+			std::swap(_slot_count, other._slot_count);
+			std::swap(_size, other._size);
+			std::swap(_deleted, other._deleted);
+			std::swap(_capacity, other._capacity);
+			std::swap(_placement, other._placement);
+			std::swap(_clock, other._clock);
+		}
+
+	public:
+		inline iterator begin() { return iterator(_slots, _slots + _slot_count); }
+		inline iterator end() { return iterator(_slots + _slot_count, _slots + _slot_count); }
+		inline const_iterator begin() const { return const_iterator(_slots, _slots + _slot_count); }
+		inline const_iterator end() const { return const_iterator(_slots + _slot_count, _slots + _slot_count); }
+		inline const_iterator cbegin() const { return begin(); }
+		inline const_iterator cend() const { return end(); }
+
+		// Resumable iteration for time-sliced scans. The position() of an iterator can be
+		// passed to from() later to continue from the same slot. Positions survive erase,
+		// but an insert that rehashes reshuffles slots (a resumed scan may then revisit or
+		// skip some entries).
+		inline iterator from(size_t position) { return iterator(_slots + ((position < _slot_count) ? position : _slot_count), _slots + _slot_count); }
+		inline const_iterator from(size_t position) const { return const_iterator(_slots + ((position < _slot_count) ? position : _slot_count), _slots + _slot_count); }
+		inline size_t position(const const_iterator& pos) const { return pos._slot - _slots; }
+
+		inline size_t size() const { return _size; }
+		inline bool empty() const { return _size == 0; }
+		inline size_t slot_count() const { return _slot_count; }
+		// approximate heap footprint of the slot array (excludes memory owned by keys/values)
+		inline size_t memory_usage() const { return _slot_count * sizeof(Slot); }
+
+		// Maximum number of entries (0 = unbounded)
+		inline size_t capacity() const { return _capacity; }
+		void capacity(size_t capacity) {
+			_capacity = capacity;
+			while (_capacity > 0 && _size > _capacity) {
+				erase(lru());
+			}
+			if (_capacity > 0) {
+				rehash(slots_for(_capacity));
+			}
+		}
+
+		iterator find(const Bytes& key) {
+			Slot* slot = lookup(key);
+			if (slot == nullptr) {
+				return end();
+			}
+			slot->_stamp = ++_clock;
+			return iterator(slot, _slots + _slot_count);
+		}
+		const_iterator find(const Bytes& key) const {
+			const Slot* slot = const_cast<HashTable*>(this)->lookup(key);
+			if (slot == nullptr) {
+				return end();
+			}
+			return const_iterator(slot, _slots + _slot_count);
+		}
+		// Find by raw key bytes, e.g. a hash still inside a received frame. Only keys that fit
+		// the inline prefix (KEY_SIZE bytes or less) can be found this way.
+		iterator find(const uint8_t* key, size_t len) {
+			Slot* slot = (len <= KEY_SIZE) ? lookup(key, len, nullptr) : nullptr;
+			if (slot == nullptr) {
+				return end();
+			}
+			slot->_stamp = ++_clock;
+			return iterator(slot, _slots + _slot_count);
+		}
+		const_iterator find(const uint8_t* key, size_t len) const {
+			const Slot* slot = (len <= KEY_SIZE) ? const_cast<HashTable*>(this)->lookup(key, len, nullptr) : nullptr;
+			if (slot == nullptr) {
+				return end();
+			}
+			return const_iterator(slot, _slots + _slot_count);
+		}
+		inline size_t count(const Bytes& key) const { return (const_cast<HashTable*>(this)->lookup(key) != nullptr) ? 1 : 0; }
+		inline bool contains(const Bytes& key) const { return count(key) > 0; }
+
+		std::pair<iterator, bool> insert(const value_type& value) {
+			Slot* slot = lookup(value.first);
+			if (slot != nullptr) {
+				return {iterator(slot, _slots + _slot_count), false};
+			}
+			slot = claim(value.first);
+			new (slot->_storage) value_type(value);
+			return {iterator(slot, _slots + _slot_count), true};
+		}
+		std::pair<iterator, bool> insert(value_type&& value) {
+			Slot* slot = lookup(value.first);
+			if (slot != nullptr) {
+				return {iterator(slot, _slots + _slot_count), false};
+			}
+			slot = claim(value.first);
+			new (slot->_storage) value_type(std::move(value));
+			return {iterator(slot, _slots + _slot_count), true};
+		}
+		template <typename InputIt>
+		void insert(InputIt first, InputIt last) {
+			for (; first != last; ++first) {
+				insert(value_type(first->first, first->second));
+			}
+		}
+
+		std::pair<iterator, bool> insert_or_assign(const Bytes& key, const T& value) {
+			Slot* slot = lookup(key);
+			if (slot != nullptr) {
+				slot->pair().second = value;
+				slot->_stamp = ++_clock;
+				return {iterator(slot, _slots + _slot_count), false};
+			}
+			return insert(value_type(key, value));
+		}
+
+		T& operator[](const Bytes& key) {
+			Slot* slot = lookup(key);
+			if (slot == nullptr) {
+				slot = claim(key);
+				new (slot->_storage) value_type(key, T());
+			}
+			slot->_stamp = ++_clock;
+			return slot->pair().second;
+		}
+
+		size_t erase(const Bytes& key) {
+			Slot* slot = lookup(key);
+			if (slot == nullptr) {
+				return 0;
+			}
+			release(slot);
+			return 1;
+		}
+		iterator erase(const_iterator pos) {
+			Slot* slot = const_cast<Slot*>(pos._slot);
+			release(slot);
+			return iterator(slot + 1, _slots + _slot_count);
+		}
+		iterator erase(iterator pos) {
+			return erase(const_iterator(pos));
+		}
+
+		void clear() {
+			for (size_t i = 0; i < _slot_count; i++) {
+				if (_slots[i]._state == SLOT_USED) {
+					_slots[i].pair().~value_type();
+				}
+				_slots[i]._state = SLOT_EMPTY;
+			}
+			_size = 0;
+			_deleted = 0;
+		}
+
+		// Least-recently-used entry (eviction candidate)
+		iterator lru() {
+			Slot* oldest = nullptr;
+			for (size_t i = 0; i < _slot_count; i++) {
+				if (_slots[i]._state == SLOT_USED && (oldest == nullptr || _slots[i]._stamp < oldest->_stamp)) {
+					oldest = &_slots[i];
+				}
+			}
+			return (oldest != nullptr) ? iterator(oldest, _slots + _slot_count) : end();
+		}
+
+	private:
+		static inline uint32_t hash_key(const uint8_t* key, size_t len) {
+			// keys are already uniformly distributed hashes, use leading bytes directly
+			if (len >= sizeof(uint32_t)) {
+				return (uint32_t)key[0] | ((uint32_t)key[1] << 8) | ((uint32_t)key[2] << 16) | ((uint32_t)key[3] << 24);
+			}
+			// FNV-1a for short (non-hash) keys
+			uint32_t hash = 2166136261u;
+			for (size_t i = 0; i < len; i++) {
+				hash = (hash ^ key[i]) * 16777619u;
+			}
+			return hash;
+		}
+
+		static inline size_t slots_for(size_t entries) {
+			// keep load factor at or below 3/4
+			size_t slots = MIN_SLOTS;
+			while (slots * 3 < entries * 4 + 4) {
+				slots <<= 1;
+			}
+			return slots;
+		}
+
+		inline bool matches(const Slot& slot, const uint8_t* key, size_t len, const Bytes* full_key) const {
+			if (slot._key_len != (uint8_t)(len > 0xFF ? 0xFF : len)) return false;
+			if (memcmp(slot._key, key, (len < KEY_SIZE) ? len : KEY_SIZE) != 0) return false;
+			// only keys longer than the inline prefix need the full comparison
+			return (len <= KEY_SIZE) || (full_key != nullptr && slot.pair().first == *full_key);
+		}
+
+		inline Slot* lookup(const Bytes& key) {
+			return lookup(key.data(), key.size(), &key);
+		}
+
+		Slot* lookup(const uint8_t* data, size_t len, const Bytes* full_key) {
+			if (_slot_count == 0 || _size == 0) {
+				return nullptr;
+			}
+			size_t mask = _slot_count - 1;
+			size_t index = hash_key(data, len) & mask;
+			for (size_t probe = 0; probe < _slot_count; probe++) {
+				Slot& slot = _slots[index];
+				if (slot._state == SLOT_EMPTY) {
+					return nullptr;
+				}
+				if (slot._state == SLOT_USED && matches(slot, data, len, full_key)) {
+					return &slot;
+				}
+				index = (index + 1) & mask;
+			}
+			return nullptr;
+		}
+
+		// Reserve a slot for a key known not to be present. Caller constructs the value.
+		Slot* claim(const Bytes& key) {
+			if (_capacity > 0 && _size >= _capacity) {
+				TRACE("HashTable: capacity reached, evicting least-recently-used entry");
+				erase(lru());
+			}
+			if (_slot_count == 0 || (_size + _deleted + 1) * 4 > _slot_count * 3) {
+				// grow if live entries alone need it, otherwise just purge tombstones
+				size_t wanted = slots_for((_capacity > 0) ? _capacity : _size + 1);
+				rehash((wanted > _slot_count) ? wanted : _slot_count);
+			}
+			const uint8_t* data = key.data();
+			size_t len = key.size();
+			size_t mask = _slot_count - 1;
+			size_t index = hash_key(data, len) & mask;
+			while (_slots[index]._state == SLOT_USED) {
+				index = (index + 1) & mask;
+			}
+			Slot& slot = _slots[index];
+			if (slot._state == SLOT_DELETED) {
+				--_deleted;
+			}
+			slot._state = SLOT_USED;
+			slot._key_len = (uint8_t)(len > 0xFF ? 0xFF : len);
+			memset(slot._key, 0, KEY_SIZE);
+			memcpy(slot._key, data, (len < KEY_SIZE) ? len : KEY_SIZE);
+			slot._stamp = ++_clock;
+			++_size;
+			return &slot;
+		}
+
+		void release(Slot* slot) {
+			slot->pair().~value_type();
+			slot->_state = SLOT_DELETED;
+			--_size;
+			++_deleted;
+		}
+
+		void rehash(size_t slot_count) {
+			if (slot_count < _size + 1) {
+				slot_count = slots_for(_size + 1);
+			}
+			Slot* old_slots = _slots;
+			size_t old_count = _slot_count;
+			_slots = static_cast<Slot*>(OS::placed_allocate(sizeof(Slot) * slot_count, _placement));
+			_slot_count = slot_count;
+			for (size_t i = 0; i < _slot_count; i++) {
+				_slots[i]._state = SLOT_EMPTY;
+			}
+			_deleted = 0;
+			if (old_slots == nullptr) {
+				return;
+			}
+			size_t mask = _slot_count - 1;
+			for (size_t i = 0; i < old_count; i++) {
+				Slot& old_slot = old_slots[i];
+				if (old_slot._state != SLOT_USED) {
+					continue;
+				}
+				size_t index = hash_key(old_slot._key, (old_slot._key_len < KEY_SIZE) ? old_slot._key_len : KEY_SIZE) & mask;
+				while (_slots[index]._state == SLOT_USED) {
+					index = (index + 1) & mask;
+				}
+				Slot& slot = _slots[index];
+				slot._state = SLOT_USED;
+				slot._key_len = old_slot._key_len;
+				memcpy(slot._key, old_slot._key, KEY_SIZE);
+				slot._stamp = old_slot._stamp;
+				new (slot._storage) value_type(std::move(old_slot.pair()));
+				old_slot.pair().~value_type();
+			}
+			::operator delete(old_slots);
+		}
+
+		void destroy() {
+			if (_slots != nullptr) {
+				clear();
+				::operator delete(_slots);
+				_slots = nullptr;
+			}
+			_slot_count = 0;
+		}
+
+	private:
+		Slot* _slots = nullptr;
+		size_t _slot_count = 0;
+		size_t _size = 0;
+		size_t _deleted = 0;
+		size_t _capacity = 0;
+		OS::Placement _placement = OS::PLACE_DEFAULT;
+		uint32_t _clock = 0;
+
+	};
+
+} }
@@ -0,0 +1,222 @@
+#include "KnownDestinationStore.h"
+
+#include "OS.h"
+#include "../Log.h"
+
+#include <algorithm>
+#include <string.h>
+
+using namespace RNS;
+using namespace RNS::Utilities;
+
+static const uint8_t KNOWN_DESTINATION_STORE_MAGIC[4] = {'R', 'N', 'K', 'D'};
+
+/*static*/ void KnownDestinationStore::header(Header& header) {
+	memset(&header, 0, sizeof(header));
+	memcpy(header._magic, KNOWN_DESTINATION_STORE_MAGIC, sizeof(header._magic));
+	header._version = VERSION;
+	header._record_size = sizeof(Record);
+	header._crc = Crc::crc32(0, (const uint8_t*)&header, offsetof(Header, _crc));
+}
+
+/*static*/ bool KnownDestinationStore::write(FileStream& stream, const TruncatedHash& destination_hash, const Identity::IdentityEntry& entry) {
+	if (entry._public_key.size() != sizeof(Record::_public_key) ||
+		entry._packet_hash.size() > sizeof(Record::_packet_hash)) {
+		// not representable, skipped rather than failing the save
+		return true;
+	}
+	// zero everything so unused fields don't change the CRC
+	Record record;
+	memset(&record, 0, sizeof(record));
+	record._timestamp = entry._timestamp;
+	record._type = RECORD_DESTINATION;
+	record._packet_hash_len = (uint8_t)entry._packet_hash.size();
+	record._app_data_len = (uint16_t)std::min<size_t>(entry._app_data.size(), APP_DATA_MAXSIZE);
+	memcpy(record._destination_hash, destination_hash.data(), sizeof(record._destination_hash));
+	memcpy(record._packet_hash, entry._packet_hash.data(), entry._packet_hash.size());
+	memcpy(record._public_key, entry._public_key.data(), sizeof(record._public_key));
+
+	uint32_t crc = Crc::crc32(0, (const uint8_t*)&record, sizeof(record));
+	crc = Crc::crc32(crc, entry._app_data.data(), record._app_data_len);
+	return (stream.write((const uint8_t*)&record, sizeof(record)) == sizeof(record) &&
+		stream.write(entry._app_data.data(), record._app_data_len) == record._app_data_len &&
+		stream.write((const uint8_t*)&crc, sizeof(crc)) == sizeof(crc));
+}
+
+/*static*/ bool KnownDestinationStore::write_removal(FileStream& stream, const TruncatedHash& destination_hash) {
+	Record record;
+	memset(&record, 0, sizeof(record));
+	record._type = RECORD_REMOVE;
+	memcpy(record._destination_hash, destination_hash.data(), sizeof(record._destination_hash));
+	uint32_t crc = Crc::crc32(0, (const uint8_t*)&record, sizeof(record));
+	return (stream.write((const uint8_t*)&record, sizeof(record)) == sizeof(record) &&
+		stream.write((const uint8_t*)&crc, sizeof(crc)) == sizeof(crc));
+}
+
+void KnownDestinationStore::reset() {
+	_records = 0;
+	_dirty = true;
+}
+
+size_t KnownDestinationStore::load(const char* file_path, Identity::KnownDestinations& table) {
+	reset();
+
+	FileStream stream = OS::open_file(file_path, FileStream::MODE_READ);
+	if (!stream) {
+		TRACE("KnownDestinationStore::load: failed to open read stream");
+		return 0;
+	}
+
+	Header expected;
+	header(expected);
+	Header found;
+	// CBA Check available() first, Stream::readBytes() waits for its timeout at end of file
+	if (stream.available() < (int)sizeof(found) || stream.readBytes((uint8_t*)&found, sizeof(found)) != sizeof(found)) {
+		TRACE("KnownDestinationStore::load: file is empty");
+		return 0;
+	}
+	if (memcmp(&found, &expected, sizeof(found)) != 0) {
+		WARNING("KnownDestinationStore::load: unrecognized known destinations file header, ignoring file");
+		return 0;
+	}
+
+	bool intact = true;
+	Record record;
+	Bytes app_data;
+	uint32_t crc;
+	while (stream.available() > 0) {
+		if (stream.available() < (int)sizeof(record) || stream.readBytes((uint8_t*)&record, sizeof(record)) != sizeof(record)) {
+			intact = false;
+			break;
+		}
+		if (record._app_data_len > APP_DATA_MAXSIZE || record._packet_hash_len > sizeof(record._packet_hash) ||
+			stream.available() < (int)(record._app_data_len + sizeof(crc))) {
+			intact = false;
+			break;
+		}
+		app_data.clear();
+		if (record._app_data_len > 0 && stream.readBytes(app_data.writable(record._app_data_len), record._app_data_len) != record._app_data_len) {
+			intact = false;
+			break;
+		}
+		if (stream.readBytes((uint8_t*)&crc, sizeof(crc)) != sizeof(crc) ||
+			crc != Crc::crc32(Crc::crc32(0, (const uint8_t*)&record, sizeof(record)), app_data.data(), app_data.size())) {
+			intact = false;
+			break;
+		}
+		++_records;
+		TruncatedHash destination_hash(record._destination_hash);
+		if (record._type == RECORD_DESTINATION) {
+			Identity::IdentityEntry entry(
+				record._timestamp,
+				Bytes(record._packet_hash, record._packet_hash_len),
+				Bytes(record._public_key, sizeof(record._public_key)),
+				app_data
+			);
+			table.insert_or_assign(destination_hash, entry);
+		}
+		else if (record._type == RECORD_REMOVE) {
+			table.erase(destination_hash);
+		}
+		else {
+			intact = false;
+			break;
+		}
+	}
+	if (!intact) {
+		WARNINGF("KnownDestinationStore::load: known destinations file is truncated or corrupt after %u records", _records);
+	}
+	// a damaged tail must be rewritten before new records can be appended after it
+	_dirty = !intact;
+	TRACEF("KnownDestinationStore::load: loaded %u destinations from %u records", table.size(), _records);
+	return table.size();
+}
+
+bool KnownDestinationStore::save(const char* file_path, const Identity::KnownDestinations& table, const std::set<TruncatedHash>& changed, const std::set<TruncatedHash>& removed) {
+	if (_dirty || !OS::file_exists(file_path)) {
+		return compact(file_path, table);
+	}
+	if (changed.empty() && removed.empty()) {
+		return true;
+	}
+
+	FileStream stream = OS::open_file(file_path, FileStream::MODE_APPEND);
+	if (!stream) {
+		TRACE("KnownDestinationStore::save: failed to open append stream");
+		return false;
+	}
+
+	uint32_t appended = 0;
+	for (const TruncatedHash& destination_hash : changed) {
+		auto iter = table.find(destination_hash);
+		if (iter == table.end()) {
+			continue;
+		}
+		if (!write(stream, destination_hash, (*iter).second)) {
+			ERROR("KnownDestinationStore::save: failed to append destination record");
+			_dirty = true;
+			return false;
+		}
+		++appended;
+	}
+	for (const TruncatedHash& destination_hash : removed) {
+		if (!write_removal(stream, destination_hash)) {
+			ERROR("KnownDestinationStore::save: failed to append removal record");
+			_dirty = true;
+			return false;
+		}
+		++appended;
+	}
+	stream.close();
+	_records += appended;
+	_appended += appended;
+	TRACEF("KnownDestinationStore::save: appended %u records, file now holds %u records for %u destinations", appended, _records, table.size());
+
+	if (_records > (table.size() * (1 + COMPACT_RATIO)) + COMPACT_SLACK) {
+		return compact(file_path, table);
+	}
+	return true;
+}
+
+bool KnownDestinationStore::compact(const char* file_path, const Identity::KnownDestinations& table) {
+	char temp_path[Type::Reticulum::FILEPATH_MAXSIZE];
+	snprintf(temp_path, Type::Reticulum::FILEPATH_MAXSIZE, "%s.tmp", file_path);
+
+	FileStream stream = OS::open_file(temp_path, FileStream::MODE_WRITE);
+	if (!stream) {
+		TRACE("KnownDestinationStore::compact: failed to open write stream");
+		return false;
+	}
+
+	reset();
+	Header file_header;
+	header(file_header);
+	bool success = (stream.write((const uint8_t*)&file_header, sizeof(file_header)) == sizeof(file_header));
+	for (const auto& [destination_hash, identity_entry] : table) {
+		if (!success) {
+			break;
+		}
+		success = write(stream, destination_hash, identity_entry);
+		++_records;
+	}
+	stream.close();
+
+	if (!success) {
+		ERROR("KnownDestinationStore::compact: failed to write known destinations file");
+		OS::remove_file(temp_path);
+		reset();
+		return false;
+	}
+	if (OS::file_exists(file_path)) {
+		OS::remove_file(file_path);
+	}
+	if (!OS::rename_file(temp_path, file_path)) {
+		ERROR("KnownDestinationStore::compact: failed to replace known destinations file");
+		reset();
+		return false;
+	}
+	_dirty = false;
+	++_compactions;
+	TRACEF("KnownDestinationStore::compact: wrote %u destinations", _records);
+	return true;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "../Identity.h"
+#include "../Bytes.h"
+#include "../FileStream.h"
+#include "../Type.h"
+#include "Crc.h"
+
+#include <set>
+#include <stdint.h>
+#include <stddef.h>
+
+namespace RNS { namespace Utilities {
+
+	// CBA Binary, append-only known destinations file.
+	//
+	// Same layout as the path table file (see PathStore.h): a header followed by records
+	// that each carry their own CRC, later records superseding earlier ones for the same
+	// destination. Records are variable length since they carry the app data. Rather than
+	// comparing the whole table against what was written, the owner tracks which
+	// destinations changed or were removed since the last save and only those are
+	// appended. Once dead records outnumber live ones the file is compacted.
+	class KnownDestinationStore {
+
+	public:
+		static const uint8_t VERSION = 1;
+		static const uint8_t RECORD_DESTINATION = 0x01;
+		static const uint8_t RECORD_REMOVE = 0x02;
+		static const uint16_t APP_DATA_MAXSIZE = Type::Reticulum::MDU;
+		// compact once the file holds more than this many dead records per live record
+		static const uint8_t COMPACT_RATIO = 1;
+		static const uint8_t COMPACT_SLACK = 16;
+
+		struct Header {
+			uint8_t _magic[4];
+			uint8_t _version;
+			uint8_t _reserved;
+			uint16_t _record_size;
+			uint32_t _reserved2;
+			uint32_t _crc;				// of the preceding header bytes
+		};
+
+		// Fixed part of a record, followed by _app_data_len bytes of app data and a CRC of both
+		struct Record {
+			double _timestamp;
+			uint8_t _type;
+			uint8_t _packet_hash_len;
+			uint16_t _app_data_len;
+			uint32_t _reserved;
+			uint8_t _destination_hash[Type::Reticulum::DESTINATION_LENGTH];
+			uint8_t _packet_hash[Type::Reticulum::HASHLENGTH/8];
+			uint8_t _public_key[Type::Identity::KEYSIZE/8];
+		};
+
+	public:
+		KnownDestinationStore() {}
+
+	private:
+		KnownDestinationStore(const KnownDestinationStore&) = delete;
+		KnownDestinationStore& operator=(const KnownDestinationStore&) = delete;
+
+	public:
+		// Stream the file into table, returns the number of destinations loaded
+		size_t load(const char* file_path, Identity::KnownDestinations& table);
+		// Append records for the changed and removed destinations, returns false on write failure
+		bool save(const char* file_path, const Identity::KnownDestinations& table, const std::set<TruncatedHash>& changed, const std::set<TruncatedHash>& removed);
+		// Discard file state so the next save rewrites the whole file
+		void reset();
+
+		inline size_t records() const { return _records; }
+		inline uint32_t appended() const { return _appended; }
+		inline uint32_t compactions() const { return _compactions; }
+
+	private:
+		bool compact(const char* file_path, const Identity::KnownDestinations& table);
+		static bool write(FileStream& stream, const TruncatedHash& destination_hash, const Identity::IdentityEntry& entry);
+		static bool write_removal(FileStream& stream, const TruncatedHash& destination_hash);
+		static void header(Header& header);
+
+	private:
+		size_t _records = 0;				// records currently in the file
+		bool _dirty = true;					// file needs rewriting before it can be appended to
+		uint32_t _appended = 0;
+		uint32_t _compactions = 0;
+
+	};
+
+} }
@@ -2,6 +2,9 @@
 
 #include "../Type.h"
 #include "../Log.h"
+#if defined(RNS_USE_POOLS)
+#include "Pool.h"
+#endif
 
 #if defined(ESP32)
 #include <esp_heap_caps.h>
@@ -28,9 +31,22 @@ using namespace RNS::Utilities;
 #endif
 
 bool _tlsf_init = false;
+#if defined(ESP32)
+// TLSF is not thread-safe and operator new/delete are reached from every task
+// (loop, transport task, WiFi/BLE callbacks), so pool access is serialized.
+// tlsf_malloc()/tlsf_free() are O(1) so a spinlock is cheap here.
+static portMUX_TYPE _tlsf_mux = portMUX_INITIALIZER_UNLOCKED;
+#define TLSF_LOCK() portENTER_CRITICAL(&_tlsf_mux)
+#define TLSF_UNLOCK() portEXIT_CRITICAL(&_tlsf_mux)
+#else
+#define TLSF_LOCK()
+#define TLSF_UNLOCK()
+#endif
 //char _tlsf_msg[256] = "";
 size_t _buffer_size = BUFFER_SIZE;
 size_t _contiguous_size = 0;
+// start of the TLSF pool, frees outside it are placed (non-TLSF) allocations
+uint8_t* _tlsf_buffer = nullptr;
 
 /*static*/ //tlsf_t OS::_tlsf = tlsf_create_with_pool(malloc(1024 * 1024), 1024 * 1024);
 /*static*/ tlsf_t OS::_tlsf = nullptr;
@@ -44,6 +60,151 @@ uint32_t _delete_fault = 0;
 size_t _min_size = 0;
 size_t _max_size = 0;
 
+// Allocation below operator new: the TLSF pool, then malloc
+static inline void* raw_allocate(size_t size) {
+	void* p;
+#if defined(RNS_USE_TLSF)
+	if (OS::_tlsf != nullptr) {
+		//TRACEF("--- allocating memory from tlsf (%u bytes)", size);
+		TLSF_LOCK();
+		p = tlsf_malloc(OS::_tlsf, size);
+		TLSF_UNLOCK();
+		//TRACEF("--- allocated memory from tlsf (%u bytes) (addr=%lx)", size, p);
+	}
+	else {
+		//TRACEF("--- allocating memory (%u bytes)", size);
+		p = malloc(size);
+		//TRACEF("--- allocated memory (%u bytes) (addr=%lx)", size, p);
+		++_new_fault;
+	}
+#else
+	//TRACEF("--- allocating memory (%u bytes)", size);
+	p = malloc(size);
+	//TRACEF("--- allocated memory (%u bytes) (addr=%lx)", size, p);
+#endif
+	return p;
+}
+
+static inline void raw_free(void* p) {
+#if defined(RNS_USE_TLSF)
+	if (OS::_tlsf != nullptr && (uint8_t*)p >= _tlsf_buffer && (uint8_t*)p < _tlsf_buffer + _buffer_size) {
+		//TRACEF("--- freeing memory from tlsf (addr=%lx)", p);
+		TLSF_LOCK();
+		tlsf_free(OS::_tlsf, p);
+		TLSF_UNLOCK();
+	}
+	else {
+		//TRACEF("--- freeing memory (addr=%lx)", p);
+		free(p);
+		if (OS::_tlsf == nullptr) {
+			++_delete_fault;
+		}
+	}
+#else
+	//TRACEF("--- freeing memory (addr=%lx)", p);
+	//TRACE("--- freeing memory");
+	free(p);
+#endif
+}
+
+#if defined(RNS_USE_ALLOC_TAGS)
+// Header in front of every tagged allocation, keeps the returned pointer 8 byte aligned
+struct AllocHeader {
+	uint32_t size;
+	uint8_t tag;
+	uint8_t reserved[3];
+};
+static_assert(sizeof(AllocHeader) == OS::ALLOC_HEADER_SIZE, "AllocHeader must match OS::ALLOC_HEADER_SIZE");
+
+#if defined(ESP32)
+#define ALLOC_CORES portNUM_PROCESSORS
+#define ALLOC_CORE() xPortGetCoreID()
+static portMUX_TYPE _alloc_mux = portMUX_INITIALIZER_UNLOCKED;
+#define ALLOC_LOCK() portENTER_CRITICAL(&_alloc_mux)
+#define ALLOC_UNLOCK() portEXIT_CRITICAL(&_alloc_mux)
+#else
+#define ALLOC_CORES 1
+#define ALLOC_CORE() 0
+#define ALLOC_LOCK()
+#define ALLOC_UNLOCK()
+#endif
+
+static OS::AllocTag _alloc_tag[ALLOC_CORES] = {OS::TAG_OTHER};
+static OS::AllocTagStats _alloc_tag_stats[OS::TAG_COUNT];
+static uint32_t _live_count = 0;
+static uint32_t _live_size = 0;
+static uint32_t _live_high_water = 0;
+
+static inline void* alloc_tag_attach(void* p, size_t size) {
+	AllocHeader* header = (AllocHeader*)p;
+	uint8_t tag = _alloc_tag[ALLOC_CORE()];
+	header->size = size;
+	header->tag = tag;
+	ALLOC_LOCK();
+	OS::AllocTagStats& stats = _alloc_tag_stats[tag];
+	++stats.count;
+	stats.size += size;
+	if (stats.size > stats.high_water) {
+		stats.high_water = stats.size;
+	}
+	++_live_count;
+	_live_size += size;
+	if (_live_size > _live_high_water) {
+		_live_high_water = _live_size;
+	}
+	ALLOC_UNLOCK();
+	return header + 1;
+}
+
+static inline void* alloc_tag_detach(void* p) {
+	AllocHeader* header = (AllocHeader*)p - 1;
+	ALLOC_LOCK();
+	OS::AllocTagStats& stats = _alloc_tag_stats[header->tag < OS::TAG_COUNT ? header->tag : OS::TAG_OTHER];
+	--stats.count;
+	stats.size -= header->size;
+	--_live_count;
+	_live_size -= header->size;
+	ALLOC_UNLOCK();
+	return header;
+}
+#endif
+
+#if defined(ESP32)
+// Allocation from a specific heap, released by operator delete like any other allocation
+static void* placed_new(size_t size, OS::Placement placement) {
+#if defined(RNS_USE_ALLOC_TAGS)
+	size_t request = size;
+	size += OS::ALLOC_HEADER_SIZE;
+#endif
+	void* p = nullptr;
+	if (placement == OS::PLACE_HOT) {
+		p = heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+	}
+	else {
+#if defined(RNS_USE_TLSF)
+		// the TLSF pool is in PSRAM whenever it exists
+		if (OS::_tlsf != nullptr) {
+			TLSF_LOCK();
+			p = tlsf_malloc(OS::_tlsf, size);
+			TLSF_UNLOCK();
+		}
+#endif
+		if (p == nullptr) {
+			p = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+		}
+	}
+	if (p == nullptr) {
+		return nullptr;
+	}
+	++_new_count;
+	_new_size += size;
+#if defined(RNS_USE_ALLOC_TAGS)
+	p = alloc_tag_attach(p, request);
+#endif
+	return p;
+}
+#endif
+
 // CBA Added attribute weak to avoid collision with new override on nrf52
 void* operator new(size_t size) {
 //__attribute__((weak)) void* operator new(size_t size) {
@@ -97,6 +258,7 @@ void* operator new(size_t size) {
 		else {
 #if 1
 			OS::_tlsf = tlsf_create_with_pool(raw_buffer, _buffer_size);
+			_tlsf_buffer = (uint8_t*)raw_buffer;
 			//if (OS::_tlsf == nullptr) {
 			//	sprintf(_tlsf_msg, "initialization of tlsf with align=%d, contiguous=%d, size=%d FAILED!!!", tlsf_align_size(), _contiguous_size, _buffer_size);
 			//}
@@ -129,23 +291,15 @@ void* operator new(size_t size) {
 	if (size < 4192 && size > _max_size) {
 		_max_size = size;
 	}
-	void* p;
-#if defined(RNS_USE_TLSF)
-	if (OS::_tlsf != nullptr) {
-		//TRACEF("--- allocating memory from tlsf (%u bytes)", size);
-    	p = tlsf_malloc(OS::_tlsf, size);
-		//TRACEF("--- allocated memory from tlsf (%u bytes) (addr=%lx)", size, p);
-	}
-	else {
-		//TRACEF("--- allocating memory (%u bytes)", size);
-		p = malloc(size);
-		//TRACEF("--- allocated memory (%u bytes) (addr=%lx)", size, p);
-		++_new_fault;
+#if defined(RNS_USE_ALLOC_TAGS)
+	size_t request = size;
+	size += OS::ALLOC_HEADER_SIZE;
+#endif
+	void* p = raw_allocate(size);
+#if defined(RNS_USE_ALLOC_TAGS)
+	if (p != nullptr) {
+		p = alloc_tag_attach(p, request);
 	}
-#else
-	//TRACEF("--- allocating memory (%u bytes)", size);
-	p = malloc(size);
-	//TRACEF("--- allocated memory (%u bytes) (addr=%lx)", size, p);
 #endif
 	return p;
 }
@@ -153,21 +307,13 @@ void* operator new(size_t size) {
 // CBA Added attribute weak to avoid collision with new override on nrf52
 void operator delete(void* p) {
 //__attribute__((weak)) void operator delete(void* p) {
-#if defined(RNS_USE_TLSF)
-	if (OS::_tlsf != nullptr) {
-		//TRACEF("--- freeing memory from tlsf (addr=%lx)", p);
-		tlsf_free(OS::_tlsf, p);
-	}
-	else {
-		//TRACEF("--- freeing memory (addr=%lx)", p);
-		free(p);
-		++_delete_fault;
+	if (p == nullptr) {
+		return;
 	}
-#else
-	//TRACEF("--- freeing memory (addr=%lx)", p);
-	//TRACE("--- freeing memory");
-	free(p);
+#if defined(RNS_USE_ALLOC_TAGS)
+	p = alloc_tag_detach(p);
 #endif
+	raw_free(p);
 	++_delete_count;
 #if defined(RNS_USE_TLSF)
 	//if (_delete_count == _new_count) {
@@ -209,7 +355,9 @@ void dump_tlsf_stats() {
 	if (OS::_tlsf == nullptr) {
 		return;
 	}
+	TLSF_LOCK();
 	tlsf_walk_pool(tlsf_get_pool(OS::_tlsf), tlsf_mem_walker, nullptr);
+	TLSF_UNLOCK();
 	HEAD("TLSF Stats", LOG_TRACE);
 	TRACEF("Buffer Size:     %u", _buffer_size);
 	TRACEF("Contiguous Size: %u", _contiguous_size);
@@ -234,10 +382,121 @@ void dump_tlsf_stats() {
 #if defined(RNS_USE_TLSF)
 	dump_tlsf_stats();
 #endif
+#if defined(RNS_USE_POOLS)
+	HEAD("Pool Stats", LOG_TRACE);
+	Pool::dump_buffer_stats();
+#endif
+#if defined(RNS_USE_ALLOC_TAGS)
+	dump_alloc_tag_stats();
+#endif
+}
+
+/*static*/ void OS::allocator_report(AllocatorReport& report) {
+	report = AllocatorReport();
+	report.live_count = _new_count - _delete_count;
+	report.faults = _new_fault;
+#if defined(RNS_USE_ALLOC_TAGS)
+	report.live_count = _live_count;
+	report.live_size = _live_size;
+	report.high_water = _live_high_water;
+#endif
+#if defined(RNS_USE_TLSF)
+	if (OS::_tlsf != nullptr) {
+		_tlsf_used_count = 0;
+		_tlsf_used_size = 0;
+		_tlsf_free_count = 0;
+		_tlsf_free_size = 0;
+		_tlsf_free_max_size = 0;
+		// the walk must not race a tlsf_malloc()/tlsf_free() on the other core
+		TLSF_LOCK();
+		tlsf_walk_pool(tlsf_get_pool(OS::_tlsf), tlsf_mem_walker, nullptr);
+		TLSF_UNLOCK();
+		report.pool_size = _buffer_size;
+		report.pool_free = _tlsf_free_size;
+		report.pool_max_free = _tlsf_free_max_size;
+		if (_tlsf_free_size > 0) {
+			report.fragmentation = (uint8_t)(100 - (uint64_t)_tlsf_free_max_size * 100 / _tlsf_free_size);
+		}
+#if !defined(RNS_USE_ALLOC_TAGS)
+		// without tagging only the TLSF pool usage is known, sampled at each report
+		static uint32_t sampled_high_water = 0;
+		if (_tlsf_used_size > sampled_high_water) {
+			sampled_high_water = _tlsf_used_size;
+		}
+		report.live_size = _tlsf_used_size;
+		report.high_water = sampled_high_water;
+#endif
+	}
+#endif
+}
+
+#if defined(RNS_USE_ALLOC_TAGS)
+/*static*/ OS::AllocTag OS::alloc_tag(AllocTag tag) {
+	AllocTag previous = _alloc_tag[ALLOC_CORE()];
+	_alloc_tag[ALLOC_CORE()] = tag;
+	return previous;
+}
+
+/*static*/ const char* OS::alloc_tag_name(uint8_t tag) {
+	switch (tag) {
+	case TAG_PATH_TABLE:
+		return "path_table";
+	case TAG_KNOWN_DESTINATIONS:
+		return "known_dests";
+	case TAG_ANNOUNCE_TABLE:
+		return "announces";
+	case TAG_LINK_TABLE:
+		return "link_table";
+	case TAG_LINK:
+		return "links";
+	case TAG_RESOURCE:
+		return "resources";
+	case TAG_PACKETS:
+		return "packets";
+	default:
+		return "other";
+	}
 }
 
+/*static*/ OS::AllocTagStats OS::alloc_tag_stats(uint8_t tag) {
+	if (tag >= TAG_COUNT) {
+		return AllocTagStats();
+	}
+	ALLOC_LOCK();
+	AllocTagStats stats = _alloc_tag_stats[tag];
+	ALLOC_UNLOCK();
+	return stats;
+}
+
+/*static*/ void OS::dump_alloc_tag_stats() {
+	HEAD("Allocation Tags", LOG_TRACE);
+	TRACEF("Live:         %u allocations, %u bytes, high water %u bytes", _live_count, _live_size, _live_high_water);
+	for (uint8_t tag = 0; tag < TAG_COUNT; tag++) {
+		AllocTagStats stats = alloc_tag_stats(tag);
+		TRACEF("%-13s %u allocations, %u bytes, high water %u bytes", alloc_tag_name(tag), stats.count, stats.size, stats.high_water);
+	}
+}
+#endif
+
 #endif	// RNS_USE_ALLOCATOR
 
+/*static*/ void* OS::placed_allocate(size_t size, Placement placement) {
+#if defined(ESP32)
+	if (placement != PLACE_DEFAULT) {
+#if defined(RNS_USE_ALLOCATOR)
+		void* p = placed_new(size, placement);
+#else
+		void* p = heap_caps_malloc(size, (placement == PLACE_HOT) ? (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT) : (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+#endif
+		if (p != nullptr) {
+			return p;
+		}
+		// requested heap is missing or exhausted
+	}
+#endif
+	return ::operator new(size);
+}
+
 
 size_t maxContiguousAllocation() {
 	// Brute-force determine maximum allocation size
@@ -18,6 +18,13 @@
 
 #undef round
 
+// Attribute allocations made in the enclosing block to a subsystem, e.g. RNS_ALLOC_SCOPE(TAG_PATH_TABLE)
+#if defined(RNS_USE_ALLOC_TAGS)
+#define RNS_ALLOC_SCOPE(tag) RNS::Utilities::OS::AllocScope _alloc_scope(RNS::Utilities::OS::tag)
+#else
+#define RNS_ALLOC_SCOPE(tag)
+#endif
+
 namespace RNS { namespace Utilities {
 
 	class OS {
@@ -56,6 +63,17 @@ namespace RNS { namespace Utilities {
 		static inline double time() { timeval time; ::gettimeofday(&time, NULL); return (double)time.tv_sec + ((double)time.tv_usec / 1000000); }
 #endif
 
+		// CBA Integer clocks for timestamps that are only compared and offset. time() builds a
+		// double on every call, and neither the ESP32-S3 nor the Cortex-M4 has a double FPU, so
+		// each conversion, addition and comparison is a soft-float call. ticks() is ltime()
+		// truncated to 32 bits and wraps after about 49 days: compare with elapsed(), never
+		// with < or >. seconds() is whole seconds on the same clock as time() and does not wrap
+		// for the life of a device. double stays at the persistence and wire boundaries, where
+		// RNS expects it.
+		static inline uint32_t ticks() { return (uint32_t)ltime(); }
+		static inline uint32_t elapsed(uint32_t since) { return ticks() - since; }
+		static inline uint32_t seconds() { return (uint32_t)(ltime() / 1000); }
+
         // sleep for specified milliseconds
 		//static inline void sleep(float seconds) { ::sleep(seconds); }
 #ifdef ARDUINO
@@ -114,8 +132,79 @@ namespace RNS { namespace Utilities {
 			return is_big_endian() ? val : swap32(val);
 		}
 
+		// CBA Placement of long-lived tables.
+		// On boards with PSRAM the TLSF pool (and so every operator new) lives in PSRAM,
+		// which is slow for tables touched on every forwarded packet, while boards without
+		// it have too little internal SRAM for large tables. Tables ask for the heap that
+		// suits them and get the default one if it is missing or exhausted.
+		enum Placement : uint8_t {
+			PLACE_DEFAULT = 0,	// wherever operator new allocates
+			PLACE_HOT,			// internal SRAM
+			PLACE_COLD			// PSRAM
+		};
+		// memory is released with plain operator delete
+		static void* placed_allocate(size_t size, Placement placement);
+
 #if defined(RNS_USE_ALLOCATOR)
 		static void dump_allocator_stats();
+
+		// Allocator totals and TLSF pool fragmentation, filled by allocator_report()
+		struct AllocatorReport {
+			uint32_t live_count = 0;		// allocations currently outstanding
+			uint32_t live_size = 0;			// bytes currently allocated through operator new
+			uint32_t high_water = 0;		// peak of live_size
+			uint32_t faults = 0;			// allocations that missed the TLSF pool
+			uint32_t pool_size = 0;			// TLSF pool size, 0 if TLSF is not in use
+			uint32_t pool_free = 0;
+			uint32_t pool_max_free = 0;		// largest free TLSF block
+			uint8_t fragmentation = 0;		// percent of free TLSF space not in the largest block
+		};
+		// walks the TLSF pool, so call it periodically rather than in a hot path
+		static void allocator_report(AllocatorReport& report);
+#endif
+
+#if defined(RNS_USE_ALLOC_TAGS)
+		// CBA Per-subsystem memory accounting.
+		// Each allocation made through operator new carries a small header recording its
+		// size and the tag that was current when it was made, so live bytes and high water
+		// marks can be kept per subsystem. The current tag is set with an AllocScope and is
+		// kept per core, which matches the loop/transport task split; allocations made by
+		// other tasks preempting a scope on the same core are attributed to that scope.
+		enum AllocTag : uint8_t {
+			TAG_OTHER = 0,
+			TAG_PATH_TABLE,
+			TAG_KNOWN_DESTINATIONS,
+			TAG_ANNOUNCE_TABLE,
+			TAG_LINK_TABLE,
+			TAG_LINK,
+			TAG_RESOURCE,
+			TAG_PACKETS,
+			TAG_COUNT
+		};
+
+		struct AllocTagStats {
+			uint32_t count = 0;				// live allocations
+			uint32_t size = 0;				// live bytes
+			uint32_t high_water = 0;		// peak of size
+		};
+
+		class AllocScope {
+		public:
+			AllocScope(AllocTag tag) : _previous(alloc_tag(tag)) {}
+			~AllocScope() { alloc_tag(_previous); }
+		private:
+			AllocScope(const AllocScope&) = delete;
+			AllocScope& operator=(const AllocScope&) = delete;
+			AllocTag _previous;
+		};
+
+		static const size_t ALLOC_HEADER_SIZE = 8;
+
+		// sets the current tag for this core, returns the previous one
+		static AllocTag alloc_tag(AllocTag tag);
+		static const char* alloc_tag_name(uint8_t tag);
+		static AllocTagStats alloc_tag_stats(uint8_t tag);
+		static void dump_alloc_tag_stats();
 #endif
 
 		inline static void register_filesystem(FileSystem& filesystem) {
@@ -139,6 +228,13 @@ namespace RNS { namespace Utilities {
 			return _filesystem;
 		}
 
+		// Flushes writes the filesystem is holding back, for shutdown and reboot paths
+		inline static void sync_filesystem() {
+			if (_filesystem) {
+				_filesystem.sync();
+			}
+		}
+
 
 		inline static bool file_exists(const char* file_path) {
 			if (!_filesystem) {
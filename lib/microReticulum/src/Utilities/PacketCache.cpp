@@ -0,0 +1,379 @@
+#include "PacketCache.h"
+
+#include "OS.h"
+#include "Crc.h"
+#include "../Log.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include <string.h>
+
+using namespace RNS;
+using namespace RNS::Utilities;
+
+static const uint8_t PACKET_CACHE_MAGIC[4] = {'R', 'N', 'P', 'C'};
+
+PacketCache::PacketCache(size_t capacity, size_t spill_capacity) :
+	_frames(std::max<size_t>(capacity, 1)),
+	_index(spill_capacity)
+{
+}
+
+/*static*/ void PacketCache::header(Header& header) {
+	memset(&header, 0, sizeof(header));
+	memcpy(header._magic, PACKET_CACHE_MAGIC, sizeof(header._magic));
+	header._version = VERSION;
+	header._crc = Crc::crc32(0, (const uint8_t*)&header, offsetof(Header, _crc));
+}
+
+size_t PacketCache::open(const char* file_path) {
+	_path.clear();
+	_index.clear();
+	_records = 0;
+	_file_size = 0;
+	// a capacity of 0 would leave the index unbounded
+	if (_index.capacity() == 0) {
+		return 0;
+	}
+	_path = file_path;
+
+	FileStream stream = OS::open_file(file_path, FileStream::MODE_READ);
+	if (!stream) {
+		// created by the first spill
+		TRACE("PacketCache::open: no spill file yet");
+		return 0;
+	}
+
+	Header expected;
+	header(expected);
+	Header found;
+	// CBA Check available() first, Stream::readBytes() waits for its timeout at end of file
+	if (stream.available() < (int)sizeof(found) || stream.readBytes((uint8_t*)&found, sizeof(found)) != sizeof(found)) {
+		stream.close();
+		TRACE("PacketCache::open: spill file is empty");
+		return 0;
+	}
+	if (memcmp(&found, &expected, sizeof(found)) != 0) {
+		stream.close();
+		WARNING("PacketCache::open: unrecognized spill file header, discarding file");
+		OS::remove_file(file_path);
+		return 0;
+	}
+
+	// Only the record headers are read here, frames are checked against their CRC when read back
+	bool intact = true;
+	uint32_t offset = sizeof(found);
+	Record record;
+	Bytes packet_hash;
+	while (stream.available() > 0) {
+		if (stream.available() < (int)sizeof(record) || stream.readBytes((uint8_t*)&record, sizeof(record)) != sizeof(record) ||
+			record._length > FRAME_MAXSIZE || stream.available() < (int)record._length ||
+			!stream.seek(offset + sizeof(record) + record._length)) {
+			intact = false;
+			break;
+		}
+		packet_hash.assign(record._hash, sizeof(record._hash));
+		// later records supersede earlier ones for the same packet
+		_index.insert_or_assign(packet_hash, offset);
+		offset += sizeof(record) + record._length;
+		++_records;
+	}
+	stream.close();
+	_file_size = offset;
+
+	if (!intact) {
+		WARNINGF("PacketCache::open: spill file is truncated or corrupt after %u records", _records);
+		// records appended after a damaged tail could never be indexed again
+		compact();
+	}
+	TRACEF("PacketCache::open: indexed %u frames from %u records", _index.size(), _records);
+	return _index.size();
+}
+
+void PacketCache::insert(const Bytes& packet_hash, const Bytes& raw) {
+	auto iter = _frames.find(packet_hash);
+	if (iter != _frames.end()) {
+		if ((*iter).second == raw) {
+			return;
+		}
+		(*iter).second = raw;
+	}
+	else {
+		while (_frames.size() >= _frames.capacity()) {
+			evict();
+		}
+		_frames.insert({packet_hash, raw});
+	}
+	// the same packet may arrive again with another hop count, the spilled copy is stale
+	_index.erase(packet_hash);
+}
+
+bool PacketCache::get(const Bytes& packet_hash, Bytes& raw) {
+	auto iter = _frames.find(packet_hash);
+	if (iter != _frames.end()) {
+		raw = (*iter).second;
+		++_hits;
+		return true;
+	}
+
+	auto spilled = _index.find(packet_hash);
+	if (spilled != _index.end()) {
+		uint32_t offset = (*spilled).second;
+		FileStream stream = OS::open_file(_path.c_str(), FileStream::MODE_READ);
+		bool found = stream && read(stream, offset, packet_hash, raw);
+		if (stream) {
+			stream.close();
+		}
+		if (found) {
+			++_spill_reads;
+			// the record stays indexed, so evicting the frame again costs no write
+			while (_frames.size() >= _frames.capacity()) {
+				evict();
+			}
+			_frames.insert({packet_hash, raw});
+			return true;
+		}
+		WARNING("PacketCache::get: unreadable spill record for " + packet_hash.toHex());
+		_index.erase(packet_hash);
+	}
+	++_misses;
+	return false;
+}
+
+bool PacketCache::contains(const Bytes& packet_hash) const {
+	return _frames.contains(packet_hash) || _index.contains(packet_hash);
+}
+
+bool PacketCache::erase(const Bytes& packet_hash) {
+	size_t erased = _frames.erase(packet_hash);
+	if (_index.erase(packet_hash) > 0) {
+		++erased;
+		compact_if_wasteful();
+	}
+	return (erased > 0);
+}
+
+size_t PacketCache::flush() {
+	if (!spilling()) {
+		return 0;
+	}
+	size_t pending = 0;
+	for (const auto& [packet_hash, raw] : _frames) {
+		if (raw.size() <= FRAME_MAXSIZE && !_index.contains(packet_hash)) {
+			++pending;
+		}
+	}
+	if (pending == 0) {
+		return 0;
+	}
+
+	FileStream stream = open_append();
+	if (!stream) {
+		TRACE("PacketCache::flush: failed to open spill file");
+		return 0;
+	}
+	size_t written = 0;
+	for (const auto& [packet_hash, raw] : _frames) {
+		if (raw.size() > FRAME_MAXSIZE || _index.contains(packet_hash)) {
+			continue;
+		}
+		if (!append(stream, packet_hash, raw)) {
+			ERROR("PacketCache::flush: failed to append frame");
+			break;
+		}
+		++written;
+	}
+	stream.close();
+	TRACEF("PacketCache::flush: appended %u frames, spill file now holds %u records", written, _records);
+	compact_if_wasteful();
+	return written;
+}
+
+size_t PacketCache::shed() {
+	if (!spilling()) {
+		return 0;
+	}
+	flush();
+	size_t released = 0;
+	for (auto iter = _frames.begin(); iter != _frames.end(); ) {
+		// frames that could not be spilled stay, dropping them would lose the path
+		if (!_index.contains((*iter).first)) {
+			++iter;
+			continue;
+		}
+		iter = _frames.erase(iter);
+		++released;
+	}
+	return released;
+}
+
+void PacketCache::clear() {
+	_frames.clear();
+	_index.clear();
+	_records = 0;
+	_file_size = 0;
+	if (spilling() && OS::file_exists(_path.c_str())) {
+		OS::remove_file(_path.c_str());
+	}
+}
+
+void PacketCache::evict() {
+	auto victim = _frames.lru();
+	if (victim == _frames.end()) {
+		return;
+	}
+	if (spilling() && (*victim).second.size() <= FRAME_MAXSIZE && !_index.contains((*victim).first)) {
+		FileStream stream = open_append();
+		bool spilled = stream && append(stream, (*victim).first, (*victim).second);
+		if (stream) {
+			stream.close();
+		}
+		if (!spilled) {
+			WARNING("PacketCache::evict: failed to spill frame " + (*victim).first.toHex());
+		}
+	}
+	_frames.erase(victim);
+	compact_if_wasteful();
+}
+
+bool PacketCache::append(FileStream& stream, const Bytes& packet_hash, const Bytes& raw) {
+	Record record;
+	if (packet_hash.size() != sizeof(record._hash) || raw.size() > FRAME_MAXSIZE) {
+		return false;
+	}
+	memset(&record, 0, sizeof(record));
+	memcpy(record._hash, packet_hash.data(), sizeof(record._hash));
+	record._length = (uint16_t)raw.size();
+	record._crc = Crc::crc32(Crc::crc32(0, (const uint8_t*)&record, offsetof(Record, _crc)), raw.data(), raw.size());
+	if (stream.write((const uint8_t*)&record, sizeof(record)) != sizeof(record) ||
+		stream.write(raw.data(), raw.size()) != raw.size()) {
+		// the partial record ends the index rebuild on the next open()
+		return false;
+	}
+	_index.insert_or_assign(packet_hash, _file_size);
+	_file_size += sizeof(record) + raw.size();
+	++_records;
+	return true;
+}
+
+bool PacketCache::read(FileStream& stream, uint32_t offset, const Bytes& packet_hash, Bytes& raw) {
+	Record record;
+	uint8_t frame[FRAME_MAXSIZE];
+	if (!stream.seek(offset) ||
+		stream.available() < (int)sizeof(record) || stream.readBytes((uint8_t*)&record, sizeof(record)) != sizeof(record)) {
+		return false;
+	}
+	if (record._length > FRAME_MAXSIZE || packet_hash.size() != sizeof(record._hash) ||
+		memcmp(record._hash, packet_hash.data(), sizeof(record._hash)) != 0) {
+		return false;
+	}
+	if (stream.available() < (int)record._length || stream.readBytes(frame, record._length) != record._length) {
+		return false;
+	}
+	if (Crc::crc32(Crc::crc32(0, (const uint8_t*)&record, offsetof(Record, _crc)), frame, record._length) != record._crc) {
+		return false;
+	}
+	raw.assign(frame, record._length);
+	return true;
+}
+
+FileStream PacketCache::open_append() {
+	if (_file_size > 0 && OS::file_exists(_path.c_str())) {
+		return OS::open_file(_path.c_str(), FileStream::MODE_APPEND);
+	}
+	// new (or vanished) file, whatever was indexed is gone
+	_index.clear();
+	_records = 0;
+	_file_size = 0;
+	FileStream stream = OS::open_file(_path.c_str(), FileStream::MODE_WRITE);
+	if (!stream) {
+		return {Type::NONE};
+	}
+	Header file_header;
+	header(file_header);
+	if (stream.write((const uint8_t*)&file_header, sizeof(file_header)) != sizeof(file_header)) {
+		stream.close();
+		return {Type::NONE};
+	}
+	_file_size = sizeof(file_header);
+	return stream;
+}
+
+void PacketCache::compact_if_wasteful() {
+	if (!spilling() || _records == 0) {
+		return;
+	}
+	if (_index.size() == 0) {
+		// every record is dead, nothing worth keeping on flash
+		TRACEF("PacketCache::compact_if_wasteful: removing spill file of %u dead records", _records);
+		if (OS::file_exists(_path.c_str())) {
+			OS::remove_file(_path.c_str());
+		}
+		_records = 0;
+		_file_size = 0;
+	}
+	else if (_records > (_index.size() * (1 + COMPACT_RATIO)) + COMPACT_SLACK) {
+		compact();
+	}
+}
+
+bool PacketCache::compact() {
+	std::string temp_path = _path + ".tmp";
+
+	// copy in file order so the old file is read front to back
+	std::vector<std::pair<uint32_t, Bytes>> live;
+	live.reserve(_index.size());
+	for (const auto& [packet_hash, offset] : _index) {
+		live.push_back({offset, packet_hash});
+	}
+	std::sort(live.begin(), live.end(), [](const std::pair<uint32_t, Bytes>& a, const std::pair<uint32_t, Bytes>& b) {
+		return a.first < b.first;
+	});
+
+	FileStream target = OS::open_file(temp_path.c_str(), FileStream::MODE_WRITE);
+	if (!target) {
+		TRACE("PacketCache::compact: failed to open write stream");
+		return false;
+	}
+	FileStream source = OS::open_file(_path.c_str(), FileStream::MODE_READ);
+
+	_index.clear();
+	_records = 0;
+	Header file_header;
+	header(file_header);
+	bool success = (target.write((const uint8_t*)&file_header, sizeof(file_header)) == sizeof(file_header));
+	_file_size = sizeof(file_header);
+	Bytes raw;
+	for (const auto& [offset, packet_hash] : live) {
+		if (!success) {
+			break;
+		}
+		// records that no longer read back are dropped
+		if (!source || !read(source, offset, packet_hash, raw)) {
+			continue;
+		}
+		success = append(target, packet_hash, raw);
+	}
+	if (source) {
+		source.close();
+	}
+	target.close();
+
+	if (success) {
+		if (OS::file_exists(_path.c_str())) {
+			OS::remove_file(_path.c_str());
+		}
+		success = OS::rename_file(temp_path.c_str(), _path.c_str());
+	}
+	if (!success) {
+		ERROR("PacketCache::compact: failed to rewrite spill file");
+		OS::remove_file(temp_path.c_str());
+		_index.clear();
+		_records = 0;
+		_file_size = 0;
+		return false;
+	}
+	TRACEF("PacketCache::compact: wrote %u records", _records);
+	return true;
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "../Bytes.h"
+#include "../Type.h"
+#include "../FileStream.h"
+#include "HashTable.h"
+
+#include <string>
+#include <stdint.h>
+#include <stddef.h>
+
+namespace RNS { namespace Utilities {
+
+	// CBA Bounded cache of raw packet frames keyed by packet hash.
+	//
+	// Announce packets referenced by the path table are kept exactly as they arrived,
+	// in an LRU table of at most capacity frames, and path responses are served from
+	// there without touching flash. With a spill file opened, frames pushed out of RAM
+	// are appended to that single file and found again through an index of packet
+	// hash to file offset, itself bounded to spill_capacity entries and LRU. A frame
+	// read back from the file is promoted into RAM again. flush() appends every frame
+	// not in the file yet, so paths persisted alongside find their announce after a
+	// reboot.
+	//
+	// The spill file is a small header followed by records of {hash, length, CRC,
+	// frame}. Records are only ever appended; frames dropped from the index leave dead
+	// records behind, and once those outnumber the live ones the file is compacted by
+	// copying the live records to a temporary file which then replaces it; once none
+	// are left alive the file is removed altogether. A truncated record ends the index
+	// rebuild on open(), one with a bad CRC is refused when read.
+	class PacketCache {
+
+	public:
+		static const uint8_t VERSION = 1;
+		// frames longer than this stay in RAM only
+		static const uint16_t FRAME_MAXSIZE = Type::Reticulum::MTU;
+		// compact once the file holds more than this many dead records per live record
+		static const uint8_t COMPACT_RATIO = 1;
+		static const uint8_t COMPACT_SLACK = 16;
+
+		struct Header {
+			uint8_t _magic[4];
+			uint8_t _version;
+			uint8_t _reserved[3];
+			uint32_t _crc;				// of the preceding header bytes
+		};
+
+		struct Record {
+			uint8_t _hash[Type::Reticulum::HASHLENGTH/8];
+			uint16_t _length;
+			uint16_t _reserved;
+			uint32_t _crc;				// of the preceding record bytes and the frame
+		};
+
+	public:
+		PacketCache(size_t capacity, size_t spill_capacity);
+
+	private:
+		PacketCache(const PacketCache&) = delete;
+		PacketCache& operator=(const PacketCache&) = delete;
+
+	public:
+		// Use file_path as spill file and index the records already in it, returns the number
+		// indexed. Without a spill file (or with a spill_capacity of 0) frames only live in RAM.
+		size_t open(const char* file_path);
+		// Store a frame, pushing the least recently used one out to the spill file if RAM is full
+		void insert(const Bytes& packet_hash, const Bytes& raw);
+		// Frame for packet_hash from RAM or the spill file, false if unknown
+		bool get(const Bytes& packet_hash, Bytes& raw);
+		bool contains(const Bytes& packet_hash) const;
+		// True if the frame for packet_hash is held in RAM
+		inline bool resident(const Bytes& packet_hash) const { return _frames.contains(packet_hash); }
+		// Forget packet_hash, its spill record becomes dead
+		bool erase(const Bytes& packet_hash);
+		// Append every frame held only in RAM to the spill file, returns the number written
+		size_t flush();
+		// Move everything to the spill file and free RAM, returns the frames released
+		size_t shed();
+		void clear();
+
+		// Drop every frame for which keep(packet_hash) is false, returns the number dropped
+		template <typename Keep>
+		size_t retain(Keep keep) {
+			size_t dropped = 0;
+			for (auto iter = _frames.begin(); iter != _frames.end(); ) {
+				if (keep((*iter).first)) {
+					++iter;
+					continue;
+				}
+				_index.erase((*iter).first);
+				iter = _frames.erase(iter);
+				++dropped;
+			}
+			for (auto iter = _index.begin(); iter != _index.end(); ) {
+				if (keep((*iter).first)) {
+					++iter;
+					continue;
+				}
+				iter = _index.erase(iter);
+				++dropped;
+			}
+			if (dropped > 0) {
+				compact_if_wasteful();
+			}
+			return dropped;
+		}
+
+		inline bool spilling() const { return !_path.empty(); }
+		inline size_t size() const { return _frames.size(); }
+		inline size_t spilled() const { return _index.size(); }
+		inline size_t records() const { return _records; }
+		inline uint32_t hits() const { return _hits; }
+		inline uint32_t spill_reads() const { return _spill_reads; }
+		inline uint32_t misses() const { return _misses; }
+
+	private:
+		void evict();
+		bool append(FileStream& stream, const Bytes& packet_hash, const Bytes& raw);
+		bool read(FileStream& stream, uint32_t offset, const Bytes& packet_hash, Bytes& raw);
+		FileStream open_append();
+		void compact_if_wasteful();
+		bool compact();
+		static void header(Header& header);
+
+	private:
+		HashTable<Bytes> _frames;
+		HashTable<uint32_t> _index;		// packet hash to spill record offset
+		std::string _path;
+		uint32_t _file_size = 0;
+		size_t _records = 0;				// records currently in the spill file
+		uint32_t _hits = 0;
+		uint32_t _spill_reads = 0;
+		uint32_t _misses = 0;
+
+	};
+
+} }
@@ -0,0 +1,264 @@
+#include "PathStore.h"
+
+#include "OS.h"
+#include "../FileStream.h"
+#include "../Log.h"
+
+#include <algorithm>
+#include <vector>
+#include <string.h>
+
+using namespace RNS;
+using namespace RNS::Utilities;
+
+static const uint8_t PATH_STORE_MAGIC[4] = {'R', 'N', 'P', 'T'};
+
+/*static*/ void PathStore::header(Header& header) {
+	memset(&header, 0, sizeof(header));
+	memcpy(header._magic, PATH_STORE_MAGIC, sizeof(header._magic));
+	header._version = VERSION;
+	header._record_size = sizeof(Record);
+	header._crc = Crc::crc32(0, (const uint8_t*)&header, offsetof(Header, _crc));
+}
+
+/*static*/ bool PathStore::encode(const Bytes& destination_hash, const Transport::DestinationEntry& entry, Record& record) {
+	// Interface ids are only valid for this boot, the record keeps the interface hash
+	Bytes interface_hash = Transport::interface_hash_from_id(entry._receiving_interface);
+	if (destination_hash.size() != sizeof(record._destination_hash) ||
+		entry._received_from.size() > sizeof(record._received_from) ||
+		interface_hash.size() != sizeof(record._interface_hash) ||
+		entry._announce_packet.size() != sizeof(record._packet_hash)) {
+		return false;
+	}
+	// zero everything so unused fields don't change the CRC
+	memset(&record, 0, sizeof(record));
+	record._timestamp = entry._timestamp;
+	record._expires = entry._expires;
+	record._type = RECORD_PATH;
+	record._hops = entry._hops;
+	record._received_from_len = (uint8_t)entry._received_from.size();
+	memcpy(record._destination_hash, destination_hash.data(), sizeof(record._destination_hash));
+	memcpy(record._received_from, entry._received_from.data(), entry._received_from.size());
+	memcpy(record._interface_hash, interface_hash.data(), sizeof(record._interface_hash));
+	memcpy(record._packet_hash, entry._announce_packet.data(), sizeof(record._packet_hash));
+
+	// Keep the newest PERSIST_RANDOM_BLOBS blobs (by embedded timestamp)
+	const uint8_t* blobs[Transport::RandomBlobs::CAPACITY];
+	uint8_t blob_count = entry._random_blobs.size();
+	for (uint8_t i = 0; i < blob_count; i++) {
+		blobs[i] = entry._random_blobs[i];
+	}
+	uint8_t persist_count = std::min<uint8_t>(blob_count, Type::Transport::PERSIST_RANDOM_BLOBS);
+	std::partial_sort(blobs, blobs + persist_count, blobs + blob_count, [](const uint8_t* a, const uint8_t* b) {
+		uint64_t ts_a = Transport::RandomBlobs::emitted(a);
+		uint64_t ts_b = Transport::RandomBlobs::emitted(b);
+		// fall back to blob order so that the record (and its CRC) is deterministic
+		return (ts_a != ts_b) ? (ts_a > ts_b) : (memcmp(a, b, RANDOM_BLOB_SIZE) < 0);
+	});
+	for (uint8_t i = 0; i < persist_count; i++) {
+		memcpy(record._random_blobs[i], blobs[i], RANDOM_BLOB_SIZE);
+	}
+	record._blob_count = persist_count;
+
+	record._crc = record_crc(record);
+	return true;
+}
+
+/*static*/ void PathStore::encode_removal(const Bytes& destination_hash, Record& record) {
+	memset(&record, 0, sizeof(record));
+	record._type = RECORD_REMOVE;
+	memcpy(record._destination_hash, destination_hash.data(), std::min(destination_hash.size(), sizeof(record._destination_hash)));
+	record._crc = record_crc(record);
+}
+
+/*static*/ void PathStore::decode(const Record& record, Bytes& destination_hash, Transport::DestinationEntry& entry) {
+	destination_hash.assign(record._destination_hash, sizeof(record._destination_hash));
+	entry._timestamp = (uint32_t)record._timestamp;
+	entry._expires = (uint32_t)record._expires;
+	entry._hops = record._hops;
+	entry._received_from.assign(record._received_from, std::min<size_t>(record._received_from_len, sizeof(record._received_from)));
+	entry._receiving_interface = Transport::interface_id_from_hash(Bytes(record._interface_hash, sizeof(record._interface_hash)));
+	entry._announce_packet.assign(record._packet_hash, sizeof(record._packet_hash));
+	// Records hold the newest blob first, the ring wants them oldest first
+	entry._random_blobs.clear();
+	uint8_t blob_count = std::min<uint8_t>(record._blob_count, Type::Transport::PERSIST_RANDOM_BLOBS);
+	for (uint8_t i = blob_count; i > 0; i--) {
+		entry._random_blobs.insert(record._random_blobs[i - 1]);
+	}
+}
+
+void PathStore::reset() {
+	_persisted.clear();
+	_records = 0;
+	_dirty = true;
+}
+
+size_t PathStore::load(const char* file_path, std::map<Bytes, Transport::DestinationEntry>& table) {
+	reset();
+	table.clear();
+
+	FileStream stream = OS::open_file(file_path, FileStream::MODE_READ);
+	if (!stream) {
+		TRACE("PathStore::load: failed to open read stream");
+		return 0;
+	}
+
+	Header expected;
+	header(expected);
+	Header found;
+	// CBA Check available() first, Stream::readBytes() waits for its timeout at end of file
+	if (stream.available() < (int)sizeof(found) || stream.readBytes((uint8_t*)&found, sizeof(found)) != sizeof(found)) {
+		TRACE("PathStore::load: file is empty");
+		return 0;
+	}
+	if (memcmp(&found, &expected, sizeof(found)) != 0) {
+		WARNING("PathStore::load: unrecognized path table file header, ignoring file");
+		return 0;
+	}
+
+	bool intact = true;
+	Record record;
+	Bytes destination_hash;
+	while (stream.available() > 0) {
+		if (stream.available() < (int)sizeof(record) || stream.readBytes((uint8_t*)&record, sizeof(record)) != sizeof(record)) {
+			intact = false;
+			break;
+		}
+		if (record_crc(record) != record._crc) {
+			intact = false;
+			break;
+		}
+		++_records;
+		if (record._type == RECORD_PATH) {
+			Transport::DestinationEntry entry;
+			decode(record, destination_hash, entry);
+			table.insert_or_assign(destination_hash, entry);
+			_persisted[destination_hash]._crc = record._crc;
+		}
+		else if (record._type == RECORD_REMOVE) {
+			destination_hash.assign(record._destination_hash, sizeof(record._destination_hash));
+			table.erase(destination_hash);
+			_persisted.erase(destination_hash);
+		}
+		else {
+			intact = false;
+			break;
+		}
+	}
+	if (!intact) {
+		WARNINGF("PathStore::load: path table file is truncated or corrupt after %u records", _records);
+	}
+	// a damaged tail must be rewritten before new records can be appended after it
+	_dirty = !intact;
+	TRACEF("PathStore::load: loaded %u paths from %u records", table.size(), _records);
+	return table.size();
+}
+
+bool PathStore::save(const char* file_path, const HashTable<Transport::DestinationEntry>& table, double min_timestamp /*= 0.0*/) {
+	if (_dirty || !OS::file_exists(file_path)) {
+		return compact(file_path, table, min_timestamp);
+	}
+
+	FileStream stream = OS::open_file(file_path, FileStream::MODE_APPEND);
+	if (!stream) {
+		TRACE("PathStore::save: failed to open append stream");
+		return false;
+	}
+
+	++_generation;
+	uint32_t appended = 0;
+	Record record;
+	for (const auto& [destination_hash, destination_entry] : table) {
+		if (destination_entry._timestamp < min_timestamp || !encode(destination_hash, destination_entry, record)) {
+			continue;
+		}
+		Persisted& persisted = _persisted[destination_hash];
+		persisted._generation = _generation;
+		if (persisted._crc == record._crc) {
+			// unchanged since last written
+			continue;
+		}
+		if (stream.write((const uint8_t*)&record, sizeof(record)) != sizeof(record)) {
+			ERROR("PathStore::save: failed to append path record");
+			_dirty = true;
+			return false;
+		}
+		persisted._crc = record._crc;
+		++_records;
+		++appended;
+	}
+
+	// Paths written previously that are now gone (or trimmed) get a removal record
+	auto iter = _persisted.begin();
+	while (iter != _persisted.end()) {
+		if ((*iter).second._generation == _generation) {
+			++iter;
+			continue;
+		}
+		encode_removal((*iter).first, record);
+		if (stream.write((const uint8_t*)&record, sizeof(record)) != sizeof(record)) {
+			ERROR("PathStore::save: failed to append removal record");
+			_dirty = true;
+			return false;
+		}
+		++_records;
+		++appended;
+		iter = _persisted.erase(iter);
+	}
+	stream.close();
+	_appended += appended;
+	TRACEF("PathStore::save: appended %u records, file now holds %u records for %u paths", appended, _records, _persisted.size());
+
+	if (_records > (_persisted.size() * (1 + COMPACT_RATIO)) + COMPACT_SLACK) {
+		return compact(file_path, table, min_timestamp);
+	}
+	return true;
+}
+
+bool PathStore::compact(const char* file_path, const HashTable<Transport::DestinationEntry>& table, double min_timestamp) {
+	char temp_path[Type::Reticulum::FILEPATH_MAXSIZE];
+	snprintf(temp_path, Type::Reticulum::FILEPATH_MAXSIZE, "%s.tmp", file_path);
+
+	FileStream stream = OS::open_file(temp_path, FileStream::MODE_WRITE);
+	if (!stream) {
+		TRACE("PathStore::compact: failed to open write stream");
+		return false;
+	}
+
+	reset();
+	Header file_header;
+	header(file_header);
+	bool success = (stream.write((const uint8_t*)&file_header, sizeof(file_header)) == sizeof(file_header));
+	Record record;
+	for (const auto& [destination_hash, destination_entry] : table) {
+		if (!success) {
+			break;
+		}
+		if (destination_entry._timestamp < min_timestamp || !encode(destination_hash, destination_entry, record)) {
+			continue;
+		}
+		success = (stream.write((const uint8_t*)&record, sizeof(record)) == sizeof(record));
+		_persisted[destination_hash]._crc = record._crc;
+		++_records;
+	}
+	stream.close();
+
+	if (!success) {
+		ERROR("PathStore::compact: failed to write path table file");
+		OS::remove_file(temp_path);
+		reset();
+		return false;
+	}
+	if (OS::file_exists(file_path)) {
+		OS::remove_file(file_path);
+	}
+	if (!OS::rename_file(temp_path, file_path)) {
+		ERROR("PathStore::compact: failed to replace path table file");
+		reset();
+		return false;
+	}
+	_dirty = false;
+	++_compactions;
+	TRACEF("PathStore::compact: wrote %u paths", _records);
+	return true;
+}
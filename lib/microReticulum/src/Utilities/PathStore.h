@@ -0,0 +1,108 @@
+#pragma once
+
+#include "../Transport.h"
+#include "../Bytes.h"
+#include "../Type.h"
+#include "HashTable.h"
+#include "Crc.h"
+
+#include <map>
+#include <stdint.h>
+#include <stddef.h>
+
+namespace RNS { namespace Utilities {
+
+	// CBA Binary, append-only path table file.
+	//
+	// The file is a small header (magic, version, record size and a CRC of the header)
+	// followed by fixed-size path records, each carrying its own CRC. A save only appends
+	// records for paths whose content changed since the last load/save, plus removal
+	// records for paths that are gone, so an unchanged table costs no flash writes at all.
+	// Once dead records outnumber live ones the file is compacted by rewriting only the
+	// live records to a temporary file which then replaces the original.
+	//
+	// Loading streams one record at a time, later records superseding earlier ones for
+	// the same destination. A record with a bad CRC (e.g. a write cut short by a reset)
+	// ends the load, and the following save compacts the file.
+	class PathStore {
+
+	public:
+		static const uint8_t VERSION = 1;
+		static const uint8_t RECORD_PATH = 0x01;
+		static const uint8_t RECORD_REMOVE = 0x02;
+		// random blobs are 5 random bytes followed by a 5 byte big-endian timestamp
+		static const uint8_t RANDOM_BLOB_SIZE = 10;
+		// compact once the file holds more than this many dead records per live record
+		static const uint8_t COMPACT_RATIO = 1;
+		static const uint8_t COMPACT_SLACK = 16;
+
+		struct Header {
+			uint8_t _magic[4];
+			uint8_t _version;
+			uint8_t _reserved;
+			uint16_t _record_size;
+			uint32_t _reserved2;
+			uint32_t _crc;				// of the preceding header bytes
+		};
+
+		// Doubles first so the record has no padding
+		struct Record {
+			double _timestamp;
+			double _expires;
+			uint8_t _type;
+			uint8_t _hops;
+			uint8_t _received_from_len;
+			uint8_t _blob_count;
+			uint8_t _destination_hash[Type::Reticulum::DESTINATION_LENGTH];
+			uint8_t _received_from[Type::Reticulum::DESTINATION_LENGTH];
+			uint8_t _interface_hash[Type::Reticulum::HASHLENGTH/8];
+			uint8_t _packet_hash[Type::Reticulum::HASHLENGTH/8];
+			uint8_t _random_blobs[Type::Transport::PERSIST_RANDOM_BLOBS][RANDOM_BLOB_SIZE];
+			uint32_t _crc;				// of the preceding record bytes
+		};
+
+	public:
+		PathStore() {}
+
+	private:
+		PathStore(const PathStore&) = delete;
+		PathStore& operator=(const PathStore&) = delete;
+
+	public:
+		// Stream the file into table, returns the number of paths loaded
+		size_t load(const char* file_path, std::map<Bytes, Transport::DestinationEntry>& table);
+		// Persist all paths with a timestamp of at least min_timestamp, returns false on write failure
+		bool save(const char* file_path, const HashTable<Transport::DestinationEntry>& table, double min_timestamp = 0.0);
+		// Discard change tracking so the next save rewrites the whole file
+		void reset();
+
+		inline size_t records() const { return _records; }
+		inline size_t size() const { return _persisted.size(); }
+		inline uint32_t appended() const { return _appended; }
+		inline uint32_t compactions() const { return _compactions; }
+
+	private:
+		bool compact(const char* file_path, const HashTable<Transport::DestinationEntry>& table, double min_timestamp);
+		static bool encode(const Bytes& destination_hash, const Transport::DestinationEntry& entry, Record& record);
+		static void decode(const Record& record, Bytes& destination_hash, Transport::DestinationEntry& entry);
+		static void encode_removal(const Bytes& destination_hash, Record& record);
+		static void header(Header& header);
+		static inline uint32_t record_crc(const Record& record) { return Crc::crc32(0, (const uint8_t*)&record, offsetof(Record, _crc)); }
+
+	private:
+		struct Persisted {
+			uint32_t _crc = 0;			// of the last record written for this path
+			uint32_t _generation = 0;	// save in which this path was last seen
+		};
+
+	private:
+		HashTable<Persisted> _persisted;
+		uint32_t _generation = 0;
+		size_t _records = 0;				// records currently in the file
+		bool _dirty = true;					// file needs rewriting before it can be appended to
+		uint32_t _appended = 0;
+		uint32_t _compactions = 0;
+
+	};
+
+} }
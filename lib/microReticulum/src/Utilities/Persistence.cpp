@@ -4,6 +4,5 @@
 
 using namespace RNS;
 
-/*static*/ //DynamicJsonDocument _document(Type::Persistence::DOCUMENT_MAXSIZE);
-/*static*/ JsonDocument _document;
-/*static*/ Bytes _buffer(Type::Persistence::BUFFER_MAXSIZE);
+//DynamicJsonDocument Persistence::_document(Type::Persistence::DOCUMENT_MAXSIZE);
+JsonDocument RNS::Persistence::_document;
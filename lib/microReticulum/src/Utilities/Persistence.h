@@ -5,6 +5,8 @@
 #include "Transport.h"
 #include "Type.h"
 #include "Utilities/OS.h"
+#include "Utilities/Crc.h"
+#include "../FileStream.h"
 
 #include <ArduinoJson.h>
 
@@ -12,6 +14,8 @@
 #include <vector>
 #include <set>
 #include <string>
+#include <algorithm>
+#include <string.h>
 
 namespace ArduinoJson {
 
@@ -275,27 +279,23 @@ namespace ArduinoJson {
 	struct Converter<RNS::Transport::DestinationEntry> {
 		static bool toJson(const RNS::Transport::DestinationEntry& src, JsonVariant dst) {
 			//TRACE("<<< Serializing Transport::DestinationEntry");
-			dst["timestamp"] = src._timestamp;
+			dst["timestamp"] = (double)src._timestamp;
 			dst["received_from"] = src._received_from;
 			dst["announce_hops"] = src._hops;
-			dst["expires"] = src._expires;
-			// Trim random_blobs to PERSIST_RANDOM_BLOBS before writing to disk
-			if (src._random_blobs.size() > RNS::Type::Transport::PERSIST_RANDOM_BLOBS) {
-				std::vector<RNS::Bytes> blob_vec(src._random_blobs.begin(), src._random_blobs.end());
-				std::sort(blob_vec.begin(), blob_vec.end(), [](const RNS::Bytes& a, const RNS::Bytes& b) {
-					uint64_t ts_a = RNS::Utilities::OS::from_bytes_big_endian(a.data() + 5, 5);
-					uint64_t ts_b = RNS::Utilities::OS::from_bytes_big_endian(b.data() + 5, 5);
-					return ts_a > ts_b;
-				});
-				std::set<RNS::Bytes> trimmed;
-				for (size_t i = 0; i < RNS::Type::Transport::PERSIST_RANDOM_BLOBS && i < blob_vec.size(); i++) {
-					trimmed.insert(blob_vec[i]);
-				}
-				dst["random_blobs"] = trimmed;
+			dst["expires"] = (double)src._expires;
+			// Keep the newest PERSIST_RANDOM_BLOBS random_blobs when writing to disk
+			std::vector<const uint8_t*> blob_vec;
+			for (uint8_t i = 0; i < src._random_blobs.size(); i++) {
+				blob_vec.push_back(src._random_blobs[i]);
 			}
-			else {
-				dst["random_blobs"] = src._random_blobs;
+			std::sort(blob_vec.begin(), blob_vec.end(), [](const uint8_t* a, const uint8_t* b) {
+				return RNS::Transport::RandomBlobs::emitted(a) > RNS::Transport::RandomBlobs::emitted(b);
+			});
+			std::set<RNS::Bytes> trimmed;
+			for (size_t i = 0; i < RNS::Type::Transport::PERSIST_RANDOM_BLOBS && i < blob_vec.size(); i++) {
+				trimmed.insert(RNS::Bytes(blob_vec[i], RNS::Transport::RandomBlobs::BLOB_SIZE));
 			}
+			dst["random_blobs"] = trimmed;
 /*
 			//dst["interface_hash"] = src._receiving_interface;
 			if (src._receiving_interface) {
@@ -324,7 +324,7 @@ namespace ArduinoJson {
 				dst["packet_hash"] = nullptr;
 			}
 */
-			dst["interface_hash"] = src._receiving_interface;
+			dst["interface_hash"] = RNS::Transport::interface_hash_from_id(src._receiving_interface);
 			dst["packet_hash"] = src._announce_packet;
 			//TRACE("<<< Finished Serializing Transport::DestinationEntry");
 			return true;
@@ -332,24 +332,24 @@ namespace ArduinoJson {
 		static RNS::Transport::DestinationEntry fromJson(JsonVariantConst src) {
 			//TRACE(">>> Deserializing Transport::DestinationEntry");
 			RNS::Transport::DestinationEntry dst;
-			dst._timestamp = src["timestamp"];
+			dst._timestamp = (uint32_t)src["timestamp"].as<double>();
 			dst._received_from = src["received_from"];
 			dst._hops = src["announce_hops"];
-			dst._expires = src["expires"];
-			dst._random_blobs = src["random_blobs"].as<std::set<RNS::Bytes>>();
-			// Trim random_blobs loaded from flash to MAX_RANDOM_BLOBS
-			if (dst._random_blobs.size() > RNS::Type::Transport::MAX_RANDOM_BLOBS) {
-				std::vector<RNS::Bytes> blob_vec(dst._random_blobs.begin(), dst._random_blobs.end());
-				std::sort(blob_vec.begin(), blob_vec.end(), [](const RNS::Bytes& a, const RNS::Bytes& b) {
-					uint64_t ts_a = RNS::Utilities::OS::from_bytes_big_endian(a.data() + 5, 5);
-					uint64_t ts_b = RNS::Utilities::OS::from_bytes_big_endian(b.data() + 5, 5);
-					return ts_a > ts_b;
-				});
-				dst._random_blobs.clear();
-				for (size_t i = 0; i < RNS::Type::Transport::MAX_RANDOM_BLOBS && i < blob_vec.size(); i++) {
-					dst._random_blobs.insert(blob_vec[i]);
+			dst._expires = (uint32_t)src["expires"].as<double>();
+			// Oldest first so that the ring ends up holding the newest MAX_RANDOM_BLOBS
+			std::vector<RNS::Bytes> blob_vec;
+			for (const RNS::Bytes& blob : src["random_blobs"].as<std::set<RNS::Bytes>>()) {
+				if (blob.size() == RNS::Transport::RandomBlobs::BLOB_SIZE) {
+					blob_vec.push_back(blob);
 				}
 			}
+			std::sort(blob_vec.begin(), blob_vec.end(), [](const RNS::Bytes& a, const RNS::Bytes& b) {
+				return RNS::Transport::RandomBlobs::emitted(a.data()) < RNS::Transport::RandomBlobs::emitted(b.data());
+			});
+			dst._random_blobs.clear();
+			for (const RNS::Bytes& blob : blob_vec) {
+				dst._random_blobs.insert(blob);
+			}
 /*
 			//dst._receiving_interface = src["interface_hash"];
 			RNS::Bytes interface_hash = src["interface_hash"];
@@ -364,7 +364,7 @@ namespace ArduinoJson {
 				dst._announce_packet = RNS::Transport::get_cached_packet(packet_hash);
 			}
 */
-			dst._receiving_interface = src["interface_hash"];
+			dst._receiving_interface = RNS::Transport::interface_id_from_hash(src["interface_hash"].as<RNS::Bytes>());
 			dst._announce_packet = src["packet_hash"];
 /*
 			//RNS::Transport::DestinationEntry dst(src["timestamp"], src["received_from"], src["announce_hops"], src["expires"], src["random_blobs"], src["receiving_interface"], src["packet"]);
@@ -434,7 +434,7 @@ namespace RNS {
 			dst["packet_hash"] = nullptr;
 		}
 */
-		dst["interface_hash"] = src._receiving_interface;
+		dst["interface_hash"] = RNS::Transport::interface_hash_from_id(src._receiving_interface);
 		dst["packet_hash"] = src._announce_packet;
 		//TRACE("<<< Finished Serializing Transport::DestinationEntry");
 		return true;
@@ -461,7 +461,7 @@ namespace RNS {
 			dst._announce_packet = RNS::Transport::get_cached_packet(packet_hash);
 		}
 */
-		dst._receiving_interface = src["interface_hash"];
+		dst._receiving_interface = RNS::Transport::interface_id_from_hash(src["interface_hash"].as<RNS::Bytes>());
 		dst._announce_packet = src["packet_hash"];
 /*
 		//RNS::Transport::DestinationEntry dst(src["timestamp"], src["received_from"], src["announce_hops"], src["expires"], src["random_blobs"], src["receiving_interface"], src["packet"]);
@@ -495,82 +495,154 @@ namespace RNS {
 namespace RNS { namespace Persistence {
 
 	//static DynamicJsonDocument _document(Type::Persistence::DOCUMENT_MAXSIZE);
-	static JsonDocument _document;
-	static Bytes _buffer(Type::Persistence::BUFFER_MAXSIZE);
+	// CBA Single shared document (defined in Persistence.cpp) that replaces the old shared _buffer.
+	// It only holds the object (or, for maps, the entry) being converted during one call and is
+	// cleared before that call returns, so nothing stays allocated between saves. Not reentrant.
+	extern JsonDocument _document;
+
+	// CBA Serializer sink that only computes the CRC32 of what is written to it, so that
+	// crc() needs no output buffer
+	class CrcWriter {
+	public:
+		CrcWriter(uint32_t crc = 0) : _crc(crc) {}
+	public:
+		inline size_t write(uint8_t byte) { _crc = Utilities::Crc::crc32(_crc, byte); ++_size; return 1; }
+		inline size_t write(const uint8_t* buffer, size_t length) { _crc = Utilities::Crc::crc32(_crc, buffer, length); _size += length; return length; }
+		inline size_t write(const char* str) { return write((const uint8_t*)str, strlen(str)); }
+		inline uint32_t crc() const { return _crc; }
+		inline size_t size() const { return _size; }
+	private:
+		uint32_t _crc = 0;
+		size_t _size = 0;
+	};
+
+	// CBA Serializer sink that collects output into a small fixed chunk before handing it to
+	// the file stream, so writing costs WRITE_CHUNK_SIZE bytes of memory however large the
+	// serialized object is (instead of a shared buffer big enough for the whole document)
+	class ChunkedFileWriter {
+	public:
+		ChunkedFileWriter(FileStream& stream) : _stream(stream) {}
+		~ChunkedFileWriter() { flush(); }
+	private:
+		ChunkedFileWriter(const ChunkedFileWriter&) = delete;
+		ChunkedFileWriter& operator=(const ChunkedFileWriter&) = delete;
+	public:
+		inline size_t write(uint8_t byte) {
+			if (_length == sizeof(_chunk) && !flush()) {
+				return 0;
+			}
+			_chunk[_length++] = byte;
+			return 1;
+		}
+		size_t write(const uint8_t* buffer, size_t length) {
+			size_t written = 0;
+			while (written < length) {
+				if (_length == sizeof(_chunk) && !flush()) {
+					break;
+				}
+				size_t count = std::min(length - written, sizeof(_chunk) - _length);
+				memcpy(_chunk + _length, buffer + written, count);
+				_length += count;
+				written += count;
+			}
+			return written;
+		}
+		inline size_t write(const char* str) { return write((const uint8_t*)str, strlen(str)); }
+		bool flush() {
+			if (_length > 0 && !_failed) {
+				if (_stream.write(_chunk, _length) != _length) {
+					TRACE("Persistence::ChunkedFileWriter: write failed");
+					_failed = true;
+				}
+				_length = 0;
+			}
+			return !_failed;
+		}
+		inline bool failed() const { return _failed; }
+	private:
+		FileStream& _stream;
+		uint8_t _chunk[Type::Persistence::WRITE_CHUNK_SIZE];
+		size_t _length = 0;
+		bool _failed = false;
+	};
 
 	template <typename T> size_t crc(const T& obj) {
 		//TRACE("Persistence::crc<T>");
 		_document.set(obj);
-		size_t size = _buffer.capacity();
+		CrcWriter writer;
 #ifdef USE_MSGPACK
-		size_t length = serializeMsgPack(_document, _buffer.writable(size), size);
+		size_t length = serializeMsgPack(_document, writer);
 #else
-		size_t length = serializeJson(_document, _buffer.writable(size), size);
+		size_t length = serializeJson(_document, writer);
 #endif
-		if (length < size) {
-			_buffer.resize(length);
-		}
+		_document.clear();
 		TRACEF("Persistence::crc: serialized %d bytes", length);
-		return Utilities::Crc::crc32(0, _buffer.data(), _buffer.size());
+		return writer.crc();
 	}
 
 	template <typename T> size_t serialize(const T& obj, const char* file_path) {
 		//TRACE("Persistence::serialize<T>");
+		RNS::FileStream stream = RNS::Utilities::OS::open_file(file_path, RNS::FileStream::MODE_WRITE);
+		if (!stream) {
+			TRACE("Persistence::serialize: failed to open write stream");
+			return 0;
+		}
 		_document.set(obj);
-		size_t size = _buffer.capacity();
+		size_t length;
+		{
+			ChunkedFileWriter writer(stream);
 #ifdef USE_MSGPACK
-		size_t length = serializeMsgPack(_document, _buffer.writable(size), size);
+			length = serializeMsgPack(_document, writer);
 #else
-		size_t length = serializeJson(_document, _buffer.writable(size), size);
+			length = serializeJson(_document, writer);
 #endif
-		if (length < size) {
-			_buffer.resize(length);
-		}
-		TRACEF("Persistence::serialize: serialized %d bytes", length);
-		size_t wrote = 0;
-		if (length > 0) {
-			wrote = RNS::Utilities::OS::write_file(file_path, _buffer);
-			if (wrote == _buffer.size()) {
-				TRACEF("Persistence::serialize: wrote %d bytes", _buffer.size());
-			}
-			else {
+			if (!writer.flush()) {
+				_document.clear();
 				TRACE("Persistence::serialize: write failed");
 				return 0;
 			}
 		}
-		else {
+		_document.clear();
+		if (length == 0) {
 			TRACE("Persistence::serialize: failed to serialize");
 			return 0;
 		}
-		return wrote;
+		TRACEF("Persistence::serialize: wrote %d bytes", length);
+		return length;
 	}
 
 	template <typename T> size_t deserialize(T& obj, const char* file_path) {
 		//TRACE("Persistence::deserialize<T>");
-		size_t read = RNS::Utilities::OS::read_file(file_path, _buffer);
-		if (read > 0) {
-			TRACEF("Persistence::deserialize: read: %d bytes", _buffer.size());
-			//TRACE("testDeserializeVector: data: " + _buffer.toString());
+		RNS::FileStream stream = RNS::Utilities::OS::open_file(file_path, RNS::FileStream::MODE_READ);
+		if (!stream) {
+			TRACE("Persistence::deserialize: failed to open read stream");
+			return 0;
+		}
+		size_t read = stream.size();
+		if (read == 0) {
+			TRACE("Persistence::deserialize: read stream is empty");
+			return 0;
+		}
+		TRACEF("Persistence::deserialize: size: %d bytes", read);
+		// CBA Parse straight from the file stream rather than reading the whole file into a buffer first
 #ifdef USE_MSGPACK
-			DeserializationError error = deserializeMsgPack(_document, _buffer.data());
+		DeserializationError error = deserializeMsgPack(_document, stream);
 #else
-			DeserializationError error = deserializeJson(_document, _buffer.data());
+		DeserializationError error = deserializeJson(_document, stream);
 #endif
-			if (!error) {
-				TRACE("Persistence::deserialize: successfully deserialized document");
-				obj = _document.as<T>();
-				// CBA Following obj check doesn't work when T is a collection
-				//if (obj) {
-					return read;
-				//}
-				TRACE("Persistence::deserialize: failed to compose object");
-			}
-			else {
-				TRACE("Persistence::deserialize: failed to deserialize");
-			}
+		if (!error) {
+			TRACE("Persistence::deserialize: successfully deserialized document");
+			obj = _document.as<T>();
+			_document.clear();
+			// CBA Following obj check doesn't work when T is a collection
+			//if (obj) {
+				return read;
+			//}
+			TRACE("Persistence::deserialize: failed to compose object");
 		}
 		else {
-			TRACE("Persistence::deserialize: read failed");
+			_document.clear();
+			TRACE("Persistence::deserialize: failed to deserialize");
 		}
 		return 0;
 	}
@@ -579,75 +651,85 @@ namespace RNS { namespace Persistence {
 	template <typename T> size_t crc(std::map<Bytes, T>& map) {
 		//TRACE("Persistence::crc<map<Bytes, T>>");
 
-		uint32_t crc = 0;
-		crc = Utilities::Crc::crc32(crc, '{');
+		CrcWriter writer;
+		writer.write('{');
 		for (const auto& [key, value] : map) {
-			crc = Utilities::Crc::crc32(crc, '"');
+			writer.write('"');
 			std::string hex = key.toHex();
-			crc = Utilities::Crc::crc32(crc, hex.c_str());
-			crc = Utilities::Crc::crc32(crc, '"');
-			crc = Utilities::Crc::crc32(crc, ':');
+			writer.write(hex.c_str());
+			writer.write('"');
+			writer.write(':');
 
 			_document.set(value);
-			size_t size = _buffer.capacity();
 #ifdef USE_MSGPACK
-			size_t length = serializeMsgPack(_document, _buffer.writable(size), size);
+			size_t length = serializeMsgPack(_document, writer);
 #else
-			size_t length = serializeJson(_document, _buffer.writable(size), size);
+			size_t length = serializeJson(_document, writer);
 #endif
-			if (length < size) {
-				_buffer.resize(length);
-			}
 			TRACEF("Persistence::crc: serialized entry %d bytes", length);
 
-			if (length > 0) {
-				crc = Utilities::Crc::crc32(crc, _buffer.data(), _buffer.size());
-			}
-			else {
+			if (length == 0) {
 				// if failed to serialize entry then write empty entry
-				crc = Utilities::Crc::crc32(crc, "{}");
+				writer.write("{}");
 			}
-			crc = Utilities::Crc::crc32(crc, ',');
+			writer.write(',');
 		}
-		return Utilities::Crc::crc32(crc, '}');
+		writer.write('}');
+		_document.clear();
+		return writer.crc();
 	}
 
 	template <typename T> size_t serialize(std::map<Bytes, T>& map, const char* file_path, uint32_t& crc) {
 		//TRACE("Persistence::serialize<map<Bytes,T>>");
 
-		// CBA TODO: Use stream here instead to avoid having to buffer entire structure
+		// CBA Entries are serialized one at a time through a chunked writer, so memory use is
+		// bounded by the largest single entry rather than the whole map
 		RNS::FileStream stream = RNS::Utilities::OS::open_file(file_path, RNS::FileStream::MODE_WRITE);
 		if (!stream) {
 			TRACE("Persistence::serialize: failed to open write stream");
 			return 0;
 		}
 
-		stream.write('{');
-		for (const auto& [key, value] : map) {
-			stream.write('"');
-			std::string hex = key.toHex();
-			stream.write(hex.c_str());
-			stream.write('"');
-			stream.write(':');
+		size_t size = 0;
+		{
+			ChunkedFileWriter writer(stream);
+			size += writer.write('{');
+			for (const auto& [key, value] : map) {
+				size += writer.write('"');
+				std::string hex = key.toHex();
+				size += writer.write(hex.c_str());
+				size += writer.write('"');
+				size += writer.write(':');
 
-			_document.set(value);
+				_document.set(value);
 #ifdef USE_MSGPACK
-			size_t length = serializeMsgPack(_document, stream);
+				size_t length = serializeMsgPack(_document, writer);
 #else
-			size_t length = serializeJson(_document, stream);
+				size_t length = serializeJson(_document, writer);
 #endif
-			TRACEF("Persistence::serialize: serialized entry %d bytes", length);
+				TRACEF("Persistence::serialize: serialized entry %d bytes", length);
 
-			if (length == 0) {
-				// if failed to serialize entry then write empty entry
-				stream.write("{}");
+				if (length == 0) {
+					// if failed to serialize entry then write empty entry
+					length = writer.write("{}");
+				}
+				size += length;
+				size += writer.write(',');
+				if (writer.failed()) {
+					break;
+				}
+			}
+			size += writer.write('}');
+			if (!writer.flush()) {
+				TRACE("Persistence::serialize: write failed");
+				_document.clear();
+				return 0;
 			}
-			stream.write(',');
 		}
-		stream.write('}');
-		TRACEF("Persistence::serialize: stream size: %d bytes", stream.size());
+		_document.clear();
+		TRACEF("Persistence::serialize: stream size: %d bytes", size);
 		crc = stream.crc();
-		return stream.size();
+		return size;
 	}
 
 	template <typename T> size_t serialize(std::map<Bytes, T>& map, const char* file_path) {
@@ -658,7 +740,7 @@ namespace RNS { namespace Persistence {
 	template <typename T> size_t deserialize(std::map<Bytes, T>& map, const char* file_path, uint32_t& crc) {
 		//TRACE("Persistence::deserialize<map<Bytes,T>>");
 
-		// CBA TODO: Use stream here instead to avoid having to buffer entire structure
+		// CBA Entries are parsed one at a time straight from the file stream
 		RNS::FileStream stream = RNS::Utilities::OS::open_file(file_path, RNS::FileStream::MODE_READ);
 		if (!stream) {
 			TRACE("Persistence::deserialize: failed to open read stream");
@@ -686,10 +768,8 @@ namespace RNS { namespace Persistence {
 						TRACEF("Persistence::deserialize: key: %s", key.toHex().c_str());
 						if (stream.find(':')) {
 #ifdef USE_MSGPACK
-							//DeserializationError error = deserializeMsgPack(_document, _buffer.data());
 							DeserializationError error = deserializeMsgPack(_document, stream);
 #else
-							//DeserializationError error = deserializeJson(_document, _buffer.data());
 							DeserializationError error = deserializeJson(_document, stream);
 #endif
 							if (!error) {
@@ -716,6 +796,7 @@ namespace RNS { namespace Persistence {
 				}
 			} while (key_str[0] != 0);
 		}
+		_document.clear();
 		crc = stream.crc();
 		return stream.size();
 	}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "OS.h"
+
+#include <map>
+#include <new>
+#include <stddef.h>
+
+namespace RNS { namespace Utilities {
+
+	// CBA Standard container allocator placing nodes in a specific heap (see OS::Placement).
+	template <typename T, OS::Placement P>
+	class PlacedAllocator {
+
+	public:
+		using value_type = T;
+
+		template <typename U>
+		struct rebind {
+			using other = PlacedAllocator<U, P>;
+		};
+
+	public:
+		PlacedAllocator() noexcept {}
+		template <typename U>
+		PlacedAllocator(const PlacedAllocator<U, P>&) noexcept {}
+
+		inline T* allocate(size_t n) {
+			void* p = OS::placed_allocate(n * sizeof(T), P);
+			if (p == nullptr) {
+				throw std::bad_alloc();
+			}
+			return static_cast<T*>(p);
+		}
+		inline void deallocate(T* p, size_t) noexcept { ::operator delete(p); }
+
+		template <typename U>
+		inline bool operator==(const PlacedAllocator<U, P>&) const noexcept { return true; }
+		template <typename U>
+		inline bool operator!=(const PlacedAllocator<U, P>&) const noexcept { return false; }
+
+	};
+
+	// std::map with its nodes in the given heap
+	template <typename K, typename V, OS::Placement P>
+	using PlacedMap = std::map<K, V, std::less<K>, PlacedAllocator<std::pair<const K, V>, P>>;
+
+} }
@@ -0,0 +1,108 @@
+#include "Pool.h"
+#include "OS.h"
+
+#include "../Type.h"
+#include "../Log.h"
+
+#include <stdlib.h>
+
+using namespace RNS;
+using namespace RNS::Utilities;
+
+#if defined(ESP32)
+// Pools are reached from every task, block list updates are O(1)
+static portMUX_TYPE _pool_mux = portMUX_INITIALIZER_UNLOCKED;
+#define POOL_LOCK() portENTER_CRITICAL(&_pool_mux)
+#define POOL_UNLOCK() portEXIT_CRITICAL(&_pool_mux)
+#else
+#define POOL_LOCK()
+#define POOL_UNLOCK()
+#endif
+
+/*static*/ Pool Pool::_lora_buffers("LoRa buffers", Type::Pool::LORA_BUFFER_SIZE, Type::Pool::LORA_BUFFERS);
+/*static*/ Pool Pool::_tcp_buffers("TCP buffers", Type::Pool::TCP_BUFFER_SIZE, Type::Pool::TCP_BUFFERS);
+
+bool Pool::init() {
+	if (_failed) {
+		return false;
+	}
+	// malloc (not new) so the storage stays out of the allocation accounting, and outside
+	// the lock since malloc may block
+	uint8_t* storage = (uint8_t*)malloc(_block_size * _block_count);
+	POOL_LOCK();
+	if (_storage != nullptr || storage == nullptr) {
+		_failed = (_storage == nullptr);
+		POOL_UNLOCK();
+		// lost the race to another task, or out of memory
+		free(storage);
+		return !_failed;
+	}
+	for (size_t i = 0; i < _block_count; i++) {
+		void* block = storage + (i * _block_size);
+		*(void**)block = _free;
+		_free = block;
+	}
+	_storage = storage;
+	POOL_UNLOCK();
+	return true;
+}
+
+void* Pool::allocate() {
+	if (_storage == nullptr && !init()) {
+		++_exhausted;
+		return nullptr;
+	}
+	POOL_LOCK();
+	void* block = _free;
+	if (block == nullptr) {
+		++_exhausted;
+		POOL_UNLOCK();
+		return nullptr;
+	}
+	_free = *(void**)block;
+	++_allocations;
+	if (++_used > _high_water) {
+		_high_water = _used;
+	}
+	POOL_UNLOCK();
+	return block;
+}
+
+bool Pool::release(void* p) {
+	if (!owns(p)) {
+		return false;
+	}
+	POOL_LOCK();
+	*(void**)p = _free;
+	_free = p;
+	--_used;
+	POOL_UNLOCK();
+	return true;
+}
+
+void Pool::dump_stats() const {
+	TRACEF("%-16s %u x %u bytes, used %u, high water %u, allocations %u, exhausted %u", _name, _block_count, _block_size, _used, _high_water, _allocations, _exhausted);
+}
+
+/*static*/ void* Pool::buffer_allocate(size_t size) {
+	if (size < Type::Pool::BUFFER_MIN_SIZE || size > _tcp_buffers.block_size()) {
+		return nullptr;
+	}
+	void* p = nullptr;
+	if (size <= _lora_buffers.block_size()) {
+		p = _lora_buffers.allocate();
+	}
+	if (p == nullptr) {
+		p = _tcp_buffers.allocate();
+	}
+	return p;
+}
+
+/*static*/ bool Pool::buffer_release(void* p) {
+	return _lora_buffers.release(p) || _tcp_buffers.release(p);
+}
+
+/*static*/ void Pool::dump_buffer_stats() {
+	_lora_buffers.dump_stats();
+	_tcp_buffers.dump_stats();
+}
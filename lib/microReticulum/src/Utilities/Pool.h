@@ -0,0 +1,104 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <new>
+
+namespace RNS { namespace Utilities {
+
+	// CBA Fixed-size block (slab) pool.
+	//
+	// Blocks are carved from a single allocation made on first use and recycled through
+	// an intrusive free list, so a steady stream of same-sized allocations (packet
+	// buffers, packet objects) no longer fragments the heap. allocate() never falls back
+	// to the heap itself and returns nullptr when the pool is exhausted, callers do that
+	// and the miss is counted.
+	//
+	// The constructor is constexpr so pools defined at namespace scope are constant
+	// initialized and usable before any static constructor has run.
+	class Pool {
+
+	public:
+		constexpr Pool(const char* name, size_t block_size, size_t block_count) :
+			_name(name),
+			_block_size((block_size + ALIGN - 1) & ~(ALIGN - 1)),
+			_block_count(block_count) {}
+
+	private:
+		Pool(const Pool&) = delete;
+		Pool& operator=(const Pool&) = delete;
+
+	public:
+		void* allocate();
+		// returns false if p was not allocated from this pool
+		bool release(void* p);
+		inline bool owns(const void* p) const { return _storage != nullptr && (const uint8_t*)p >= _storage && (const uint8_t*)p < _storage + (_block_size * _block_count); }
+
+		inline const char* name() const { return _name; }
+		inline size_t block_size() const { return _block_size; }
+		inline size_t block_count() const { return _block_count; }
+		inline uint32_t used() const { return _used; }
+		inline uint32_t high_water() const { return _high_water; }
+		inline uint32_t allocations() const { return _allocations; }
+		inline uint32_t exhausted() const { return _exhausted; }
+
+		void dump_stats() const;
+
+	public:
+		// Packet-sized Bytes buffers (BufferAllocator), nullptr if size isn't pooled
+		static void* buffer_allocate(size_t size);
+		// returns false if p is not a pooled buffer
+		static bool buffer_release(void* p);
+		static void dump_buffer_stats();
+
+	private:
+		bool init();
+
+	private:
+		static const size_t ALIGN = 8;
+
+		const char* _name;
+		size_t _block_size;
+		size_t _block_count;
+		uint8_t* _storage = nullptr;
+		void* _free = nullptr;
+		bool _failed = false;
+		uint32_t _used = 0;
+		uint32_t _high_water = 0;
+		uint32_t _allocations = 0;
+		uint32_t _exhausted = 0;
+
+		static Pool _lora_buffers;
+		static Pool _tcp_buffers;
+
+	};
+
+	// CBA Allocator for the storage behind Bytes, so only packet buffers are served from the
+	// buffer pools; other allocations (lwIP, WiFi, String) never see them. Sizes outside the
+	// pooled range and misses on an exhausted pool go to operator new.
+	template <typename T>
+	struct BufferAllocator {
+		using value_type = T;
+
+		BufferAllocator() noexcept {}
+		template <typename U> BufferAllocator(const BufferAllocator<U>&) noexcept {}
+
+		T* allocate(size_t n) {
+			void* p = Pool::buffer_allocate(n * sizeof(T));
+			if (p == nullptr) {
+				p = ::operator new(n * sizeof(T));
+			}
+			return (T*)p;
+		}
+		void deallocate(T* p, size_t n) noexcept {
+			if (!Pool::buffer_release(p)) {
+				::operator delete(p);
+			}
+		}
+	};
+	template <typename T, typename U>
+	inline bool operator == (const BufferAllocator<T>&, const BufferAllocator<U>&) { return true; }
+	template <typename T, typename U>
+	inline bool operator != (const BufferAllocator<T>&, const BufferAllocator<U>&) { return false; }
+
+} }
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace RNS { namespace Utilities {
+
+	// CBA Hierarchical timer wheel. A tick is whatever the owner advances it by: whole
+	// seconds of OS::seconds() for the table timers, ms of OS::ticks() for announces.
+	// Deadlines are compared as signed differences from the wheel's clock, so a clock that
+	// wraps like OS::ticks() works as long as deadlines stay within 2^31 ticks of it.
+	//
+	// LEVELS wheels of SLOTS slots each; level n slots span SLOTS^n ticks, so with the
+	// defaults (4 x 32) deadlines up to 2^20 ticks (~12 days in seconds, ~17 minutes in ms)
+	// ahead are placed directly and anything further out waits in the last level-3 slot
+	// and is re-placed when that slot comes round. Each advance() only touches the slots for the ticks that passed
+	// plus the higher level slots cascading down on them, so the cost follows the number
+	// of timers that actually expire rather than the number scheduled.
+	//
+	// Timers can't be cancelled. Owners store the deadline they scheduled (or derive it
+	// from their own state) and treat a timer whose deadline no longer matches as stale,
+	// rescheduling when an entry turned out to have been refreshed. T is copied into the
+	// wheel, so it should be a small key (a table key or a shared handle).
+	template <typename T>
+	class TimerWheel {
+
+	public:
+		static const uint8_t LEVEL_BITS = 5;
+		static const uint8_t SLOTS = 1 << LEVEL_BITS;
+		static const uint8_t LEVELS = 4;
+
+		struct Timer {
+			T _item;
+			uint32_t _deadline;
+		};
+
+	public:
+		TimerWheel() {}
+
+	private:
+		TimerWheel(const TimerWheel&) = delete;
+		TimerWheel& operator=(const TimerWheel&) = delete;
+
+	public:
+		// Deadline in ticks of the clock passed to advance(), deadlines not in the future fire on the next tick
+		void schedule(const T& item, uint32_t deadline) {
+			++_size;
+			place({item, deadline}, _now + 1);
+		}
+
+		// Advance to now and call fire(item, deadline) for every timer that is due
+		template <typename F>
+		size_t advance(uint32_t now, F fire) {
+			if (now == 0) {
+				return 0;
+			}
+			if (!_started || (int32_t)(now - _now) > (int32_t)span()) {
+				// First advance, or the clock jumped past the whole wheel: place every timer again
+				rebase(now - 1);
+				_started = true;
+			}
+			if ((int32_t)(now - _now) <= 0) {
+				return 0;
+			}
+			size_t fired = 0;
+			std::vector<Timer> due;
+			while (_now != now) {
+				++_now;
+				// Higher levels first so cascaded timers land in lower slots before those are visited
+				for (uint8_t level = LEVELS - 1; level > 0; level--) {
+					if ((_now & ((1UL << (LEVEL_BITS * level)) - 1)) == 0) {
+						cascade(level, (_now >> (LEVEL_BITS * level)) & (SLOTS - 1));
+					}
+				}
+				due.clear();
+				due.swap(_slots[0][_now & (SLOTS - 1)]);
+				for (const Timer& timer : due) {
+					if ((int32_t)(timer._deadline - _now) > 0) {
+						// parked beyond the wheel, not due yet
+						place(timer, _now + 1);
+						continue;
+					}
+					--_size;
+					++fired;
+					fire(timer._item, timer._deadline);
+				}
+			}
+			return fired;
+		}
+
+		inline size_t size() const { return _size; }
+		inline uint32_t now() const { return _now; }
+
+		void clear() {
+			for (uint8_t level = 0; level < LEVELS; level++) {
+				for (uint8_t slot = 0; slot < SLOTS; slot++) {
+					_slots[level][slot].clear();
+				}
+			}
+			_size = 0;
+		}
+
+	private:
+		static inline uint32_t span() { return 1UL << (LEVEL_BITS * LEVELS); }
+
+		// Timers keep the deadline they were scheduled with, only the slot uses the clamped one.
+		// Cascades run before the current tick's slot is visited and may place into it.
+		void place(const Timer& timer, uint32_t earliest) {
+			uint32_t deadline = timer._deadline;
+			if ((int32_t)(deadline - earliest) < 0) {
+				deadline = earliest;
+			}
+			// Lowest level whose window (the current block and the SLOTS-1 blocks after it) holds the deadline.
+			// Block numbers are taken modulo the 32-bit clock's block count, so a window across the wrap still matches
+			for (uint8_t level = 0; level < LEVELS; level++) {
+				uint8_t shift = LEVEL_BITS * level;
+				uint32_t blocks = 0xFFFFFFFFUL >> shift;
+				if ((((deadline >> shift) - (_now >> shift)) & blocks) < SLOTS) {
+					_slots[level][(deadline >> shift) & (SLOTS - 1)].push_back(timer);
+					return;
+				}
+			}
+			// Beyond the wheel, park in the furthest top-level slot
+			uint8_t shift = LEVEL_BITS * (LEVELS - 1);
+			_slots[LEVELS - 1][((_now >> shift) + SLOTS - 1) & (SLOTS - 1)].push_back(timer);
+		}
+
+		void rebase(uint32_t now) {
+			std::vector<Timer> timers;
+			for (uint8_t level = 0; level < LEVELS; level++) {
+				for (uint8_t slot = 0; slot < SLOTS; slot++) {
+					timers.insert(timers.end(), _slots[level][slot].begin(), _slots[level][slot].end());
+					_slots[level][slot].clear();
+				}
+			}
+			_now = now;
+			for (const Timer& timer : timers) {
+				place(timer, _now + 1);
+			}
+		}
+
+		void cascade(uint8_t level, uint32_t slot) {
+			std::vector<Timer> timers;
+			timers.swap(_slots[level][slot]);
+			for (const Timer& timer : timers) {
+				place(timer, _now);
+			}
+		}
+
+	private:
+		std::vector<Timer> _slots[LEVELS][SLOTS];
+		uint32_t _now = 0;
+		size_t _size = 0;
+		bool _started = false;
+
+	};
+
+} }
@@ -0,0 +1,234 @@
+#include "Whitelist.h"
+
+#include "OS.h"
+#include "../Log.h"
+
+#include <string.h>
+
+using namespace RNS;
+using namespace RNS::Utilities;
+
+Whitelist::Whitelist(size_t capacity, uint32_t mentioned_ttl, uint32_t local_ttl) :
+	_capacity(capacity),
+	_mentioned_ttl(mentioned_ttl),
+	_local_ttl(local_ttl)
+{
+	MEM("Whitelist object created");
+}
+
+Whitelist::~Whitelist() {
+	delete[] _entries;
+	MEM("Whitelist object destroyed");
+}
+
+size_t Whitelist::memory_usage() const {
+	if (_entries == nullptr) {
+		return 0;
+	}
+	return _slot_count * sizeof(Entry);
+}
+
+bool Whitelist::allocate() {
+	if (_entries != nullptr) {
+		return true;
+	}
+	if (_capacity == 0) {
+		return false;
+	}
+	// keep the table at most 75% full so probe runs stay short
+	_slot_count = 8;
+	while (_slot_count * 3 < _capacity * 4) {
+		_slot_count <<= 1;
+	}
+	_entries = new Entry[_slot_count];
+	if (_entries == nullptr) {
+		ERROR("Whitelist: failed to allocate storage");
+		_slot_count = 0;
+		return false;
+	}
+	clear();
+	TRACEF("Whitelist: allocated %u entries (%u bytes)", _capacity, memory_usage());
+	return true;
+}
+
+void Whitelist::clear() {
+	_size = 0;
+	_hand = 0;
+	_cull_next = 0;
+	if (_entries == nullptr) {
+		return;
+	}
+	for (uint32_t i = 0; i < _slot_count; i++) {
+		_entries[i]._flags = 0;
+	}
+}
+
+/*static*/ void Whitelist::normalize(const uint8_t* id, size_t len, uint8_t* key) {
+	memset(key, 0, ENTRY_SIZE);
+	memcpy(key, id, (len < ENTRY_SIZE) ? len : ENTRY_SIZE);
+}
+
+/*static*/ uint32_t Whitelist::now() {
+	return (uint32_t)(OS::ltime() / 1000);
+}
+
+int32_t Whitelist::find_slot(const uint8_t* key) const {
+	uint32_t mask = _slot_count - 1;
+	for (uint32_t slot = home_of(key), n = 0; n < _slot_count; slot = (slot + 1) & mask, n++) {
+		const Entry& entry = _entries[slot];
+		if (entry._flags == 0) {
+			return -1;
+		}
+		if (memcmp(entry._key, key, ENTRY_SIZE) == 0) {
+			return slot;
+		}
+	}
+	return -1;
+}
+
+bool Whitelist::expired(const Entry& entry, uint32_t now) const {
+	if (entry._flags & CLASS_PINNED) {
+		return false;
+	}
+	uint32_t ttl = (entry._flags & CLASS_LOCAL) ? _local_ttl : _mentioned_ttl;
+	return (now - entry._seen) > ttl;
+}
+
+bool Whitelist::allowed(const uint8_t* id, size_t len, uint8_t classes) {
+	if (_entries == nullptr || _size == 0) {
+		return false;
+	}
+	uint8_t key[ENTRY_SIZE];
+	normalize(id, len, key);
+	int32_t slot = find_slot(key);
+	if (slot < 0) {
+		return false;
+	}
+	Entry& entry = _entries[slot];
+	if (!(entry._flags & classes)) {
+		return false;
+	}
+	uint32_t time = now();
+	if (expired(entry, time)) {
+		return false;
+	}
+	entry._seen = time;
+	entry._flags |= FLAG_REFERENCED;
+	return true;
+}
+
+bool Whitelist::insert(const uint8_t* id, size_t len, uint8_t cls) {
+	if (!allocate()) {
+		return false;
+	}
+	uint8_t key[ENTRY_SIZE];
+	normalize(id, len, key);
+	uint32_t time = now();
+
+	int32_t slot = find_slot(key);
+	if (slot >= 0) {
+		Entry& entry = _entries[slot];
+		// an expired entry starts over rather than keeping its old classes
+		if (expired(entry, time)) {
+			entry._flags = 0;
+		}
+		entry._flags |= cls | FLAG_REFERENCED;
+		entry._seen = time;
+		return true;
+	}
+
+	if (_size >= _capacity && !evict(time)) {
+		return false;
+	}
+	uint32_t mask = _slot_count - 1;
+	uint32_t free_slot = home_of(key);
+	while (_entries[free_slot]._flags != 0) {
+		free_slot = (free_slot + 1) & mask;
+	}
+	Entry& entry = _entries[free_slot];
+	memcpy(entry._key, key, ENTRY_SIZE);
+	entry._seen = time;
+	// new entries start unreferenced so one-off identifiers are the first evicted
+	entry._flags = cls;
+	++_size;
+	return true;
+}
+
+void Whitelist::remove(const Bytes& id, uint8_t cls) {
+	if (_entries == nullptr || _size == 0) {
+		return;
+	}
+	uint8_t key[ENTRY_SIZE];
+	normalize(id.data(), id.size(), key);
+	int32_t slot = find_slot(key);
+	if (slot < 0) {
+		return;
+	}
+	_entries[slot]._flags &= ~cls;
+	if ((_entries[slot]._flags & CLASS_ANY) == 0) {
+		remove_slot(slot);
+	}
+}
+
+void Whitelist::remove_slot(uint32_t slot) {
+	uint32_t mask = _slot_count - 1;
+	_entries[slot]._flags = 0;
+	--_size;
+	// backward-shift the rest of the probe run into the hole
+	for (uint32_t next = (slot + 1) & mask; _entries[next]._flags != 0; next = (next + 1) & mask) {
+		uint32_t home = home_of(_entries[next]._key);
+		if (((next - home) & mask) >= ((next - slot) & mask)) {
+			_entries[slot] = _entries[next];
+			_entries[next]._flags = 0;
+			slot = next;
+		}
+	}
+}
+
+bool Whitelist::evict(uint32_t now) {
+	uint32_t mask = _slot_count - 1;
+	// two sweeps: the first may only clear referenced bits
+	for (uint32_t n = 0; n < _slot_count * 2; n++) {
+		Entry& entry = _entries[_hand];
+		if (entry._flags == 0 || (entry._flags & CLASS_PINNED)) {
+			_hand = (_hand + 1) & mask;
+			continue;
+		}
+		if (expired(entry, now)) {
+			remove_slot(_hand);
+			++_expirations;
+			return true;
+		}
+		if (entry._flags & FLAG_REFERENCED) {
+			entry._flags &= ~FLAG_REFERENCED;
+			_hand = (_hand + 1) & mask;
+			continue;
+		}
+		remove_slot(_hand);
+		++_evictions;
+		return true;
+	}
+	WARNING("Whitelist: full of pinned entries, insert dropped");
+	return false;
+}
+
+size_t Whitelist::cull(size_t max_slots) {
+	if (_entries == nullptr || _size == 0) {
+		return 0;
+	}
+	uint32_t mask = _slot_count - 1;
+	uint32_t time = now();
+	size_t removed = 0;
+	for (size_t n = 0; n < max_slots && n < _slot_count; n++) {
+		Entry& entry = _entries[_cull_next];
+		if (entry._flags != 0 && expired(entry, time)) {
+			// the slot is refilled by the shift, look at it again
+			remove_slot(_cull_next);
+			++_expirations;
+			++removed;
+			continue;
+		}
+		_cull_next = (_cull_next + 1) & mask;
+	}
+	return removed;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "../Bytes.h"
+#include "../Type.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace RNS { namespace Utilities {
+
+	// CBA Fixed-capacity aged whitelist for the boundary firewall.
+	//
+	// Replaces the pair of std::set<Bytes> that whitelisted local and mentioned
+	// addresses, which cost a tree node and a Bytes allocation per insert and were
+	// trimmed in lexical order rather than by age. Every identifier is stored as its
+	// leading ENTRY_SIZE bytes in one open-addressing table (linear probing, at most
+	// 75% full, backward-shift deletion so there are no tombstones), with a class mask
+	// and the second it was last seen. One probe answers whether an identifier is
+	// allowed, whatever list it came from.
+	//
+	// Entries age out TTL seconds after they were last seen (local addresses and
+	// mentioned identifiers have separate TTLs, pinned entries never expire). When
+	// the table is full an insert evicts with CLOCK: hits set a referenced bit, the
+	// hand clears it as it passes, and the first unpinned entry found unreferenced or
+	// expired is replaced, so identifiers in active use survive.
+	//
+	// Storage is allocated lazily on first insert.
+	class Whitelist {
+
+	public:
+		static const uint8_t ENTRY_SIZE = Type::Reticulum::TRUNCATED_HASHLENGTH / 8;
+
+		enum Class : uint8_t {
+			CLASS_MENTIONED = 0x01,		// mentioned in traffic from a local interface
+			CLASS_LOCAL     = 0x02,		// announced on a local interface
+			CLASS_PINNED    = 0x04,		// our own destinations, never aged or evicted
+			CLASS_ANY       = 0x07,
+		};
+
+	public:
+		Whitelist(size_t capacity, uint32_t mentioned_ttl, uint32_t local_ttl);
+		~Whitelist();
+
+	private:
+		Whitelist(const Whitelist&) = delete;
+		Whitelist& operator=(const Whitelist&) = delete;
+
+	public:
+		// True if id carries any of classes and has not expired; a hit refreshes it
+		bool allowed(const uint8_t* id, size_t len, uint8_t classes = CLASS_ANY);
+		inline bool allowed(const Bytes& id, uint8_t classes = CLASS_ANY) { return allowed(id.data(), id.size(), classes); }
+		// Adds cls to id (creating it if needed) and marks it seen now
+		bool insert(const uint8_t* id, size_t len, uint8_t cls);
+		inline bool insert(const Bytes& id, uint8_t cls) { return insert(id.data(), id.size(), cls); }
+		// Clears cls from id, the entry goes once no class is left
+		void remove(const Bytes& id, uint8_t cls);
+		// Drops expired entries from the next max_slots slots, returns how many
+		size_t cull(size_t max_slots);
+		void clear();
+
+		inline size_t size() const { return _size; }
+		inline size_t capacity() const { return _capacity; }
+		size_t memory_usage() const;
+		inline uint32_t evictions() const { return _evictions; }
+		inline uint32_t expirations() const { return _expirations; }
+
+	private:
+		struct Entry {
+			uint8_t _key[ENTRY_SIZE];
+			uint32_t _seen;		// seconds
+			uint8_t _flags;		// Class bits, FLAG_REFERENCED; 0 is an empty slot
+		};
+
+		static const uint8_t FLAG_REFERENCED = 0x80;
+
+		bool allocate();
+		inline uint32_t home_of(const uint8_t* key) const { return ((uint32_t)key[0] | ((uint32_t)key[1] << 8) | ((uint32_t)key[2] << 16) | ((uint32_t)key[3] << 24)) & (_slot_count - 1); }
+		int32_t find_slot(const uint8_t* key) const;
+		bool expired(const Entry& entry, uint32_t now) const;
+		void remove_slot(uint32_t slot);
+		bool evict(uint32_t now);
+		static void normalize(const uint8_t* id, size_t len, uint8_t* key);
+		static uint32_t now();
+
+	private:
+		size_t _capacity = 0;
+		size_t _size = 0;
+		uint32_t _slot_count = 0;
+		Entry* _entries = nullptr;
+		uint32_t _hand = 0;			// CLOCK hand
+		uint32_t _cull_next = 0;	// resume point for cull()
+		uint32_t _mentioned_ttl = 0;
+		uint32_t _local_ttl = 0;
+
+		uint32_t _evictions = 0;
+		uint32_t _expirations = 0;
+
+	};
+
+} }
@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+# Generates src/Cryptography/Fast25519Tables.h, the curve constants and precomputed
+# multiples of the Ed25519 base point used by Fast25519.cpp.
+#
+#   cd lib/microReticulum
+#   python3 tools/fast25519_tables.py > src/Cryptography/Fast25519Tables.h
+#
+# Field elements are written in the radix 2^25.5 form of Fast25519.cpp: ten signed
+# 32 bit limbs of alternately 26 and 25 bits.
+
+p = 2**255 - 19
+d = (-121665 * pow(121666, p - 2, p)) % p
+sqrtm1 = pow(2, (p - 1) // 4, p)
+
+def inv(x):
+    return pow(x, p - 2, p)
+
+def recover_x(y):
+    x2 = (y * y - 1) * inv(d * y * y + 1) % p
+    x = pow(x2, (p + 3) // 8, p)
+    if (x * x - x2) % p != 0:
+        x = x * sqrtm1 % p
+    if x & 1:
+        x = p - x
+    return x
+
+By = 4 * inv(5) % p
+Bx = recover_x(By)
+B = (Bx, By)
+
+def add(P, Q):
+    (x1, y1), (x2, y2) = P, Q
+    t = d * x1 * x2 * y1 * y2 % p
+    x3 = (x1 * y2 + x2 * y1) * inv(1 + t) % p
+    y3 = (y1 * y2 + x1 * x2) * inv(1 - t) % p
+    return (x3, y3)
+
+def limbs(x):
+    out = []
+    for i in range(10):
+        bits = 26 if i % 2 == 0 else 25
+        out.append(x & ((1 << bits) - 1))
+        x >>= bits
+    assert x == 0
+    return out
+
+def fe(x):
+    return "{" + ", ".join(str(v) for v in limbs(x % p)) + "}"
+
+def precomp(P):
+    x, y = P
+    return "{%s, %s, %s}" % (fe(y + x), fe(y - x), fe(2 * d * x * y))
+
+def main():
+    print("#pragma once")
+    print()
+    print("// CBA Generated by tools/fast25519_tables.py, do not edit.")
+    print()
+    print("#include <stdint.h>")
+    print()
+    print("namespace RNS { namespace Cryptography { namespace Fast25519Tables {")
+    print()
+    print("\t// d = -121665/121666")
+    print("\tstatic const int32_t d[10] = %s;" % fe(d))
+    print("\tstatic const int32_t d2[10] = %s;" % fe(2 * d))
+    print("\t// sqrt(-1)")
+    print("\tstatic const int32_t sqrtm1[10] = %s;" % fe(sqrtm1))
+    print()
+    print("\t// base[i][j] = (j+1) * 256^i * B as (y+x, y-x, 2dxy)")
+    print("\tstatic const int32_t base[32][8][3][10] = {")
+    P = B
+    for i in range(32):
+        print("\t\t{")
+        Q = P
+        for j in range(8):
+            print("\t\t\t%s," % precomp(Q))
+            Q = add(Q, P)
+        print("\t\t},")
+        for _ in range(8):
+            P = add(P, P)
+    print("\t};")
+    print()
+    print("\t// bi[i] = (2i+1) * B, for the sliding window in verification")
+    print("\tstatic const int32_t bi[8][3][10] = {")
+    P = B
+    B2 = add(B, B)
+    for i in range(8):
+        print("\t\t%s," % precomp(P))
+        P = add(P, B2)
+    print("\t};")
+    print()
+    print("} } }")
+
+if __name__ == "__main__":
+    main()
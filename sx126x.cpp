@@ -20,6 +20,7 @@
 #define OP_STANDBY_6X               0x80
 #define OP_TX_6X                    0x83
 #define OP_RX_6X                    0x82
+#define OP_RX_DUTY_CYCLE_6X         0x94
 #define OP_PA_CONFIG_6X             0x95
 #define OP_SET_IRQ_FLAGS_6X         0x08 // Also provides info such as
                                          // preamble detection, etc for
@@ -59,6 +60,7 @@
 
 #define OP_FIFO_WRITE_6X            0x0E
 #define OP_FIFO_READ_6X             0x1E
+#define SPI_FRAME_MAX_6X            16   // opcode, parameters and status NOP of one command
 #define REG_OCP_6X                0x08E7
 #define REG_LNA_6X                0x08AC // No agc in sx1262
 #define REG_SYNC_WORD_MSB_6X      0x0740
@@ -116,9 +118,23 @@ sx126x::sx126x() :
   _crcMode(1),
   _fifo_tx_addr_ptr(0),
   _fifo_rx_addr_ptr(0),
-  _packet({0}),
+  _rxPacketLength(0),
   _preinit_done(false),
   _dio0_risen(false),
+  _tx_done(false),
+  _transmitting(false),
+  _tx_started(0),
+  _tx_polled(0),
+  _preamble_detected_at(0),
+  _false_preamble_detected(false),
+  _dcd_window_ms(0),
+  _sniff_rx_us(0),
+  _sniff_sleep_us(0),
+  _receiving(false),
+  _sniffing(false),
+  _sniff_header(false),
+  _sniff_carrier_at(0),
+  _dio_mask(0),
   _onReceive(NULL)
 { setTimeout(0); }
 
@@ -166,20 +182,21 @@ void sx126x::writeRegister(uint16_t address, uint8_t value) {
 
 uint8_t ISR_VECT sx126x::singleTransfer(uint8_t opcode, uint16_t address, uint8_t value) {
   waitOnBusy();
-  
-  uint8_t response;
+
+  // Opcode, address, the status NOP on reads and the value go out as
+  // one frame, a single EasyDMA transaction on nRF52
+  uint8_t frame[5] = {opcode, (uint8_t)((address & 0xFF00) >> 8), (uint8_t)(address & 0x00FF), 0x00, 0x00};
+  size_t len = 3;
+  if (opcode == OP_READ_REGISTER_6X) { len++; }
+  frame[len++] = value;
+
   digitalWrite(_ss, LOW);
   SPI.beginTransaction(_spiSettings);
-  SPI.transfer(opcode);
-  SPI.transfer((address & 0xFF00) >> 8);
-  SPI.transfer(address & 0x00FF);
-  if (opcode == OP_READ_REGISTER_6X) { SPI.transfer(0x00); }
-  response = SPI.transfer(value);
+  SPI.transfer(frame, len);
   SPI.endTransaction();
-
   digitalWrite(_ss, HIGH);
 
-  return response;
+  return frame[len-1];
 }
 
 void sx126x::rxAntEnable() {
@@ -201,46 +218,82 @@ void sx126x::waitOnBusy() {
   }
 }
 
+// Commands and their parameters are clocked as one frame rather
+// than a transfer per byte. No command takes more than 9 parameters.
 void sx126x::executeOpcode(uint8_t opcode, uint8_t *buffer, uint8_t size) {
+  uint8_t frame[SPI_FRAME_MAX_6X];
   waitOnBusy();
   digitalWrite(_ss, LOW);
   SPI.beginTransaction(_spiSettings);
-  SPI.transfer(opcode);
-  for (int i = 0; i < size; i++) { SPI.transfer(buffer[i]); }
+  if (size < sizeof(frame)) {
+    frame[0] = opcode;
+    memcpy(frame+1, buffer, size);
+    SPI.transfer(frame, size+1);
+  } else {
+    SPI.transfer(opcode);
+    writeBurst(buffer, size);
+  }
   SPI.endTransaction();
   digitalWrite(_ss, HIGH);
 }
 
 void sx126x::executeOpcodeRead(uint8_t opcode, uint8_t *buffer, uint8_t size) {
+  uint8_t frame[SPI_FRAME_MAX_6X];
   waitOnBusy();
   digitalWrite(_ss, LOW);
   SPI.beginTransaction(_spiSettings);
-  SPI.transfer(opcode);
-  SPI.transfer(0x00);
-  for (int i = 0; i < size; i++) { buffer[i] = SPI.transfer(0x00); }
+  if (size < sizeof(frame)-1) {
+    // Opcode and status NOP, then NOPs while the response is read
+    memset(frame, 0x00, size+2);
+    frame[0] = opcode;
+    SPI.transfer(frame, size+2);
+    memcpy(buffer, frame+2, size);
+  } else {
+    SPI.transfer(opcode);
+    SPI.transfer(0x00);
+    memset(buffer, 0x00, size);
+    SPI.transfer(buffer, size);
+  }
   SPI.endTransaction();
   digitalWrite(_ss, HIGH);
 }
 
+// Clocks out a buffer in one burst under the current CS assertion,
+// a single EasyDMA transfer on nRF52
+void sx126x::writeBurst(const uint8_t* buffer, size_t size) {
+  #if MCU_VARIANT == MCU_ESP32
+    SPI.writeBytes(buffer, size);
+  #elif MCU_VARIANT == MCU_NRF52
+    SPI.transfer(buffer, NULL, size);
+  #else
+    for (int i = 0; i < size; i++) { SPI.transfer(buffer[i]); }
+  #endif
+}
+
 void sx126x::writeBuffer(const uint8_t* buffer, size_t size) {
   waitOnBusy();
   digitalWrite(_ss, LOW);
   SPI.beginTransaction(_spiSettings);
-  SPI.transfer(OP_FIFO_WRITE_6X);
-  SPI.transfer(_fifo_tx_addr_ptr);
-  for (int i = 0; i < size; i++) { SPI.transfer(buffer[i]); _fifo_tx_addr_ptr++; }
+  uint8_t header[2] = {OP_FIFO_WRITE_6X, _fifo_tx_addr_ptr};
+  SPI.transfer(header, sizeof(header));
+  // The whole fragment goes out in one burst under a single CS assertion
+  writeBurst(buffer, size);
+  _fifo_tx_addr_ptr += size;
   SPI.endTransaction();
   digitalWrite(_ss, HIGH);
 }
 
-void sx126x::readBuffer(uint8_t* buffer, size_t size) {
+void sx126x::readBuffer(uint8_t* buffer, size_t size) { readBuffer(_fifo_rx_addr_ptr, buffer, size); }
+void sx126x::readBuffer(uint8_t offset, uint8_t* buffer, size_t size) {
   waitOnBusy();
   digitalWrite(_ss, LOW);
   SPI.beginTransaction(_spiSettings);
-  SPI.transfer(OP_FIFO_READ_6X);
-  SPI.transfer(_fifo_rx_addr_ptr);
-  SPI.transfer(0x00);
-  for (int i = 0; i < size; i++) { buffer[i] = SPI.transfer(0x00); }
+  uint8_t header[3] = {OP_FIFO_READ_6X, offset, 0x00};
+  SPI.transfer(header, sizeof(header));
+  // Clock the whole payload in one burst, NOPs go out while it is read.
+  // On nRF52 this is a single EasyDMA transfer.
+  memset(buffer, 0x00, size);
+  SPI.transfer(buffer, size);
   SPI.endTransaction();
   digitalWrite(_ss, HIGH);
 }
@@ -400,43 +453,71 @@ int sx126x::beginPacket(int implicitHeader) {
 }
 
 int sx126x::endPacket() {
+  startTransmit();
+  int result;
+  while ((result = pollTransmit()) == 0) { yield(); }
+  return result > 0 ? 1 : 0;
+}
+
+void sx126x::startTransmit() {
   setPacketParams(_preambleLength, _implicitHeaderMode, _payloadLength, _crcMode);
+  _tx_done = false;
+  _transmitting = true;
+  _tx_started = millis();
+  _tx_polled = _tx_started;
   uint8_t timeout[3] = {0}; // Put in single TX mode
   executeOpcode(OP_TX_6X, timeout, 3);
+}
 
-  uint8_t buf[2];
-  buf[0] = 0x00;
-  buf[1] = 0x00;
-  executeOpcodeRead(OP_GET_IRQ_STATUS_6X, buf, 2);
+// TxDone is routed to the DIO pin along with RxDone, so completion
+// normally arrives through pollDio0(). The IRQ status is only read
+// directly when no interrupt is attached, or as a slow fallback.
+int sx126x::pollTransmit() {
+  if (!_transmitting) { return 1; }
+  if (_dio0_risen) { pollDio0(); }
 
-  // Wait for TX done
-  bool timed_out = false;
-  uint32_t w_timeout = millis()+LORA_MODEM_TIMEOUT_MS;
-  while ((millis() < w_timeout) && ((buf[1] & IRQ_TX_DONE_MASK_6X) == 0)) {
-    buf[0] = 0x00;
-    buf[1] = 0x00;
+  uint32_t now = millis();
+  if (!_tx_done && (_onReceive == NULL || now - _tx_polled >= LORA_TX_POLL_MS)) {
+    _tx_polled = now;
+    uint8_t buf[2] = {0};
     executeOpcodeRead(OP_GET_IRQ_STATUS_6X, buf, 2);
-    yield();
+    if ((buf[1] & IRQ_TX_DONE_MASK_6X) != 0) {
+      uint8_t mask[2] = {0x00, IRQ_TX_DONE_MASK_6X};
+      executeOpcode(OP_CLEAR_IRQ_STATUS_6X, mask, 2);
+      _tx_done = true;
+    }
   }
 
-  if (!(millis() < w_timeout)) { timed_out = true; }
-
-  // Clear IRQs
-  uint8_t mask[2];
-  mask[0] = 0x00;
-  mask[1] = IRQ_TX_DONE_MASK_6X;
-  executeOpcode(OP_CLEAR_IRQ_STATUS_6X, mask, 2);
-  if (timed_out) { return 0; } else { return 1; }
+  if (_tx_done) { _transmitting = false; return 1; }
+  if (now - _tx_started >= (uint32_t)LORA_MODEM_TIMEOUT_MS) {
+    _transmitting = false;
+    uint8_t mask[2] = {0x00, IRQ_TX_DONE_MASK_6X};
+    executeOpcode(OP_CLEAR_IRQ_STATUS_6X, mask, 2);
+    return -1;
+  }
+  return 0;
 }
 
-unsigned long preamble_detected_at = 0;
 extern long lora_preamble_time_ms;
 extern long lora_header_time_ms;
-bool false_preamble_detected = false;
 
 bool sx126x::dcd() {
-  uint8_t buf[2] = {0}; executeOpcodeRead(OP_GET_IRQ_STATUS_6X, buf, 2);
   uint32_t now = millis();
+  long dcd_window_ms = (this == &sx126x_modem) ? lora_preamble_time_ms + lora_header_time_ms : _dcd_window_ms;
+
+  // Reading the IRQ status would wake the modem, so while it sniffs the
+  // carrier is what pollDio0() saw of preamble and header interrupts
+  if (_sniffing) {
+    if (_sniff_carrier_at == 0) { return false; }
+    if (_sniff_header) { return true; }
+    if (now - _sniff_carrier_at <= dcd_window_ms) { return true; }
+    // A preamble without a header leaves the modem listening outside its
+    // cycle, put it back to sleep
+    receive();
+    return false;
+  }
+
+  uint8_t buf[2] = {0}; executeOpcodeRead(OP_GET_IRQ_STATUS_6X, buf, 2);
 
   bool header_detected = false;
   bool carrier_detected = false;
@@ -446,10 +527,10 @@ bool sx126x::dcd() {
 
   if ((buf[1] & IRQ_PREAMBLE_DET_MASK_6X) != 0) {
     carrier_detected = true;
-    if (preamble_detected_at == 0) { preamble_detected_at = now; }
-    if (now - preamble_detected_at > lora_preamble_time_ms + lora_header_time_ms) {
-      preamble_detected_at = 0;
-      if (!header_detected) { false_preamble_detected = true; }
+    if (_preamble_detected_at == 0) { _preamble_detected_at = now; }
+    if (now - _preamble_detected_at > dcd_window_ms) {
+      _preamble_detected_at = 0;
+      if (!header_detected) { _false_preamble_detected = true; }
       uint8_t clearbuf[2] = {0};
       clearbuf[1] = IRQ_PREAMBLE_DET_MASK_6X;
       executeOpcode(OP_CLEAR_IRQ_STATUS_6X, clearbuf, 2);
@@ -458,7 +539,7 @@ bool sx126x::dcd() {
 
   // TODO: Maybe there's a way of unlatching the RSSI
   // status without re-activating receive mode?
-  if (false_preamble_detected) { sx126x_modem.receive(); false_preamble_detected = false; }
+  if (_false_preamble_detected) { receive(); _false_preamble_detected = false; }
   return carrier_detected;
 }
 
@@ -528,38 +609,33 @@ size_t sx126x::write(const uint8_t *buffer, size_t size) {
   return size;
 }
 
+// Length and FIFO position of the received packet are latched by
+// pollDio0(), so reading a packet costs no further status queries.
 int ISR_VECT sx126x::available() {
-  uint8_t buf[2] = {0};
-  executeOpcodeRead(OP_RX_BUFFER_STATUS_6X, buf, 2);
-  return buf[0] - _packetIndex;
+  return _rxPacketLength - _packetIndex;
 }
 
 int ISR_VECT sx126x::read(){
-  if (!available()) { return -1; }
-  if (_packetIndex == 0) {
-    uint8_t rxbuf[2] = {0};
-    executeOpcodeRead(OP_RX_BUFFER_STATUS_6X, rxbuf, 2);
-    int size = rxbuf[0];
-    _fifo_rx_addr_ptr = rxbuf[1];
-    readBuffer(_packet, size);
-  }
-
-  uint8_t byte = _packet[_packetIndex];
-  _packetIndex++;
+  uint8_t byte;
+  if (readPayload(&byte, 1) != 1) { return -1; }
   return byte;
 }
 
+// Read the next size bytes of the received packet straight from the
+// modem FIFO into buffer, in a single SPI transaction
+size_t ISR_VECT sx126x::readPayload(uint8_t* buffer, size_t size) {
+  int remaining = available();
+  if (remaining <= 0) { return 0; }
+  if (size > (size_t)remaining) { size = remaining; }
+  readBuffer((uint8_t)(_fifo_rx_addr_ptr + _packetIndex), buffer, size);
+  _packetIndex += size;
+  return size;
+}
+
 int sx126x::peek() {
   if (!available()) { return -1; }
-  if (_packetIndex == 0) {
-      uint8_t rxbuf[2] = {0};
-      executeOpcodeRead(OP_RX_BUFFER_STATUS_6X, rxbuf, 2);
-      int size = rxbuf[0];
-      _fifo_rx_addr_ptr = rxbuf[1];
-      readBuffer(_packet, size);
-  }
-
-  uint8_t b = _packet[_packetIndex];
+  uint8_t b;
+  readBuffer((uint8_t)(_fifo_rx_addr_ptr + _packetIndex), &b, 1);
   return b;
 }
 
@@ -574,7 +650,8 @@ void sx126x::onReceive(void(*callback)(int)){
     buf[0] = 0xFF;  // Set irq masks, enable all
     buf[1] = 0xFF;
     buf[2] = 0x00;  // Set dio0 masks
-    buf[3] = IRQ_RX_DONE_MASK_6X; 
+    buf[3] = IRQ_RX_DONE_MASK_6X | IRQ_TX_DONE_MASK_6X;
+    _dio_mask = buf[3];
     buf[4] = 0x00;  // Set dio1 masks
     buf[5] = 0x00;
     buf[6] = 0x00;  // Set dio2 masks 
@@ -584,7 +661,11 @@ void sx126x::onReceive(void(*callback)(int)){
     #ifdef SPI_HAS_NOTUSINGINTERRUPT
       SPI.usingInterrupt(digitalPinToInterrupt(_dio0));
     #endif
-    attachInterrupt(digitalPinToInterrupt(_dio0), sx126x::onDio0Rise, RISING);
+    #if MCU_VARIANT == MCU_ESP32
+      attachInterruptArg(digitalPinToInterrupt(_dio0), sx126x::onDio0RiseArg, this, RISING);
+    #else
+      attachInterrupt(digitalPinToInterrupt(_dio0), sx126x::onDio0Rise, RISING);
+    #endif
 
   } else {
     detachInterrupt(digitalPinToInterrupt(_dio0));
@@ -614,16 +695,58 @@ void sx126x::receive(int size) {
   } else { explicitHeaderMode(); }
 
   if (_rxen != -1) { rxAntEnable(); }
-  uint8_t mode[3] = {0xFF, 0xFF, 0xFF}; // Continuous mode
-  executeOpcode(OP_RX_6X, mode, 3);
+  _receiving = true;
+  _sniff_carrier_at = 0;
+  _sniff_header = false;
+  if (size == 0 && _sniff_sleep_us > 0 && _onReceive) {
+    // The modem only wakes the MCU once it hears a preamble, and the
+    // header interrupt keeps dcd() from re-arming under a packet
+    setDioMask(IRQ_RX_DONE_MASK_6X | IRQ_TX_DONE_MASK_6X | IRQ_PREAMBLE_DET_MASK_6X | IRQ_HEADER_DET_MASK_6X);
+    // Periods are given in steps of 15.625 us
+    uint32_t rx_steps = _sniff_rx_us*64/1000;
+    uint32_t sleep_steps = _sniff_sleep_us*64/1000;
+    uint8_t periods[6] = {
+      (uint8_t)(rx_steps >> 16), (uint8_t)(rx_steps >> 8), (uint8_t)rx_steps,
+      (uint8_t)(sleep_steps >> 16), (uint8_t)(sleep_steps >> 8), (uint8_t)sleep_steps
+    };
+    executeOpcode(OP_RX_DUTY_CYCLE_6X, periods, 6);
+    _sniffing = true;
+  } else {
+    if (_onReceive) { setDioMask(IRQ_RX_DONE_MASK_6X | IRQ_TX_DONE_MASK_6X); }
+    uint8_t mode[3] = {0xFF, 0xFF, 0xFF}; // Continuous mode
+    executeOpcode(OP_RX_6X, mode, 3);
+    _sniffing = false;
+  }
+}
+
+void sx126x::setRxDutyCycle(uint32_t rx_us, uint32_t sleep_us) {
+  // Clamped to the 24 bit period registers
+  if (rx_us > 0xFFFFFF/64*1000) { rx_us = 0xFFFFFF/64*1000; }
+  if (sleep_us > 0xFFFFFF/64*1000) { sleep_us = 0xFFFFFF/64*1000; }
+  if (rx_us == 0) { sleep_us = 0; }
+  bool changed = rx_us != _sniff_rx_us || sleep_us != _sniff_sleep_us;
+  _sniff_rx_us = rx_us;
+  _sniff_sleep_us = sleep_us;
+  // Settings written since the last receive() woke the modem out of its
+  // cycle, so re-arm whenever it was sniffing, not only on a change
+  if (_receiving && !_implicitHeaderMode && (changed || _sniffing)) { receive(); }
+}
+
+void sx126x::setDioMask(uint8_t mask) {
+  if (mask == _dio_mask) { return; }
+  uint8_t buf[8] = {0xFF, 0xFF, 0x00, mask, 0x00, 0x00, 0x00, 0x00};
+  executeOpcode(OP_SET_IRQ_FLAGS_6X, buf, 8);
+  _dio_mask = mask;
 }
 
 void sx126x::standby() {
   uint8_t byte = MODE_STDBY_XOSC_6X; // STDBY_XOSC
   executeOpcode(OP_STANDBY_6X, &byte, 1); 
+  _receiving = false;
+  _sniffing = false;
 }
 
-void sx126x::sleep() { uint8_t byte = 0x00; executeOpcode(OP_SLEEP_6X, &byte, 1); }
+void sx126x::sleep() { uint8_t byte = 0x00; executeOpcode(OP_SLEEP_6X, &byte, 1); _receiving = false; _sniffing = false; }
 
 void sx126x::enableTCXO() {
   #if HAS_TCXO
@@ -725,8 +848,9 @@ long sx126x::getSignalBandwidth() {
 extern bool lora_low_datarate;
 void sx126x::handleLowDataRate() {
   if ( long( (1<<_sf) / (getSignalBandwidth()/1000)) > 16)
-         { _ldro = 0x01; lora_low_datarate = true;  }
-    else { _ldro = 0x00; lora_low_datarate = false; }
+         { _ldro = 0x01; }
+    else { _ldro = 0x00; }
+  if (this == &sx126x_modem) { lora_low_datarate = _ldro; }
 }
 
 // TODO: Check if there's anything the sx1262 can do here
@@ -802,16 +926,37 @@ void sx126x::pollDio0() {
   executeOpcodeRead(OP_GET_IRQ_STATUS_6X, buf, 2);
   executeOpcode(OP_CLEAR_IRQ_STATUS_6X, buf, 2);
 
+  if ((buf[1] & IRQ_TX_DONE_MASK_6X) != 0) { _tx_done = true; return; }
+  // Nothing is received while on air
+  if (_transmitting) { return; }
+
+  if ((buf[1] & IRQ_RX_DONE_MASK_6X) == 0 && (_dio_mask & IRQ_PREAMBLE_DET_MASK_6X) != 0) {
+    // A preamble or header heard while sniffing. The modem is awake and
+    // receiving once it has found one, the status reads above don't
+    // disturb it.
+    if (_sniffing) {
+      if (_sniff_carrier_at == 0) { _sniff_carrier_at = millis(); }
+      if ((buf[1] & IRQ_HEADER_DET_MASK_6X) != 0) { _sniff_header = true; }
+    }
+    return;
+  }
+
   if ((buf[1] & IRQ_PAYLOAD_CRC_ERROR_MASK_6X) == 0) {
     _packetIndex = 0;
-    uint8_t rxbuf[2] = {0}; // Read packet length
+    uint8_t rxbuf[2] = {0}; // Read packet length and FIFO start
     executeOpcodeRead(OP_RX_BUFFER_STATUS_6X, rxbuf, 2);
-    int packetLength = rxbuf[0];
-    if (_onReceive) { _onReceive(packetLength); }
+    _rxPacketLength = rxbuf[0];
+    _fifo_rx_addr_ptr = rxbuf[1];
+    if (_onReceive) { _onReceive(_rxPacketLength); }
   }
+
+  // The modem drops out of its cycle with each packet, good or not. The
+  // callback may have started a transmission, which re-arms on its own.
+  if (_sniffing && !_transmitting) { receive(); }
 }
 
 void ISR_VECT sx126x::onDio0Rise() { sx126x_modem.handleDio0Rise(); }
+void ISR_VECT sx126x::onDio0RiseArg(void* modem) { ((sx126x*)modem)->handleDio0Rise(); }
 void sx126x::setSPIFrequency(uint32_t frequency) { _spiSettings = SPISettings(frequency, MSBFIRST, SPI_MODE0); }
 void sx126x::enableCrc() { _crcMode = 1; setPacketParams(_preambleLength, _implicitHeaderMode, _payloadLength, _crcMode); }
 void sx126x::disableCrc() { _crcMode = 0; setPacketParams(_preambleLength, _implicitHeaderMode, _payloadLength, _crcMode); }
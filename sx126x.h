@@ -15,6 +15,7 @@
 #define LORA_DEFAULT_TXEN_PIN  -1
 #define LORA_DEFAULT_BUSY_PIN  -1
 #define LORA_MODEM_TIMEOUT_MS 20E3
+#define LORA_TX_POLL_MS 100   // status read while on air, in case a TxDone edge goes missing
 
 #define PA_OUTPUT_RFO_PIN      0
 #define PA_OUTPUT_PA_BOOST_PIN 1
@@ -30,6 +31,11 @@ public:
 
   int beginPacket(int implicitHeader = false);
   int endPacket();
+  // Non-blocking transmit: startTransmit() puts the written packet on air,
+  // pollTransmit() returns 0 while it is on air, 1 once sent, -1 on timeout
+  void startTransmit();
+  int pollTransmit();
+  bool transmitting() { return _transmitting; }
 
   int parsePacket(int size = 0);
   int packetRssi();
@@ -70,6 +76,17 @@ public:
   void setPreambleLength(long preamble_symbols);
   void setSyncWord(uint16_t sw);
   bool dcd();
+  // Time a detected preamble may go without a header before dcd() treats
+  // it as false, for modems other than the primary sx126x_modem
+  void setDcdWindow(long ms) { _dcd_window_ms = ms; }
+  // Receive duty cycle: with both periods set, receive() has the modem
+  // listen for rx_us, sleep for sleep_us and repeat until it detects a
+  // preamble, which must be longer than 2*rx_us + sleep_us to be caught.
+  // 0, 0 restores continuous receive.
+  void setRxDutyCycle(uint32_t rx_us, uint32_t sleep_us);
+  // True while the modem cycles on its own. Any SPI access wakes it out of
+  // the cycle, so callers leave RSSI reads and register polls alone.
+  bool sniffing() { return _sniffing; }
   void enableCrc();
   void disableCrc();
   void enableTCXO();
@@ -81,7 +98,10 @@ public:
   void executeOpcode(uint8_t opcode, uint8_t *buffer, uint8_t size);
   void executeOpcodeRead(uint8_t opcode, uint8_t *buffer, uint8_t size);
   void writeBuffer(const uint8_t* buffer, size_t size);
+  void writeBurst(const uint8_t* buffer, size_t size);
   void readBuffer(uint8_t* buffer, size_t size);
+  void readBuffer(uint8_t offset, uint8_t* buffer, size_t size);
+  size_t readPayload(uint8_t* buffer, size_t size);
   void setPacketParams(long preamble_symbols, uint8_t headermode, uint8_t payload_length, uint8_t crc);
 
   void setModulationParams(uint8_t sf, uint8_t bw, uint8_t cr, int ldro);
@@ -102,16 +122,21 @@ private:
   void implicitHeaderMode();
 
   void handleDio0Rise();
+  void setDioMask(uint8_t mask);
 
 public:
   // Poll for deferred DIO0 interrupt (call from main loop)
   void pollDio0();
+  // Catch a DIO0 rise that happened while its interrupt was off,
+  // e.g. during light sleep
+  void checkDio0() { if (_dio0 != -1 && digitalRead(_dio0) == HIGH) { _dio0_risen = true; } }
 
 private:  uint8_t readRegister(uint16_t address);
   void writeRegister(uint16_t address, uint8_t value);
   uint8_t singleTransfer(uint8_t opcode, uint16_t address, uint8_t value);
 
   static void onDio0Rise();
+  static void onDio0RiseArg(void* modem);
 
   void handleLowDataRate();
   void optimizeModemSensitivity();
@@ -139,9 +164,23 @@ private:
   int _crcMode;
   int _fifo_tx_addr_ptr;
   int _fifo_rx_addr_ptr;
-  uint8_t _packet[255];
+  int _rxPacketLength;
   bool _preinit_done;
   volatile bool _dio0_risen;
+  bool _tx_done;
+  bool _transmitting;
+  uint32_t _tx_started;
+  uint32_t _tx_polled;
+  uint32_t _preamble_detected_at;
+  bool _false_preamble_detected;
+  long _dcd_window_ms;
+  uint32_t _sniff_rx_us;
+  uint32_t _sniff_sleep_us;
+  bool _receiving;
+  bool _sniffing;
+  bool _sniff_header;
+  uint32_t _sniff_carrier_at;
+  uint8_t _dio_mask;
   void (*_onReceive)(int);
 };
 
@@ -78,7 +78,7 @@ extern SPIClass SPI;
 sx127x::sx127x() :
   _spiSettings(8E6, MSBFIRST, SPI_MODE0),
   _ss(LORA_DEFAULT_SS_PIN), _reset(LORA_DEFAULT_RESET_PIN), _dio0(LORA_DEFAULT_DIO0_PIN),
-  _frequency(0), _packetIndex(0), _preinit_done(false), _onReceive(NULL) { setTimeout(0); }
+  _frequency(0), _packetIndex(0), _preinit_done(false), _tx_done(false), _transmitting(false), _tx_started(0), _onReceive(NULL) { setTimeout(0); }
 
 void sx127x::setSPIFrequency(uint32_t frequency) { _spiSettings = SPISettings(frequency, MSBFIRST, SPI_MODE0); }
 void sx127x::setPins(int ss, int reset, int dio0, int busy) { _ss = ss; _reset = reset; _dio0 = dio0; _busy = busy; }
@@ -121,16 +121,16 @@ bool sx127x::preInit() {
 }
 
 uint8_t ISR_VECT sx127x::singleTransfer(uint8_t address, uint8_t value) {
-  uint8_t response;
+  // Address and value as one frame, a single EasyDMA transaction on nRF52
+  uint8_t frame[2] = {address, value};
 
   digitalWrite(_ss, LOW);
   SPI.beginTransaction(_spiSettings);
-  SPI.transfer(address);
-  response = SPI.transfer(value);
+  SPI.transfer(frame, sizeof(frame));
   SPI.endTransaction();
   digitalWrite(_ss, HIGH);
 
-  return response;
+  return frame[1];
 }
 
 int sx127x::begin(long frequency) {
@@ -181,17 +181,31 @@ int sx127x::beginPacket(int implicitHeader) {
 }
 
 int sx127x::endPacket() {
+  startTransmit();
+  int result;
+  while ((result = pollTransmit()) == 0) { yield(); }
+  return result > 0 ? 1 : 0;
+}
+
+void sx127x::startTransmit() {
+  _tx_done = false;
+  _transmitting = true;
+  _tx_started = millis();
   // Enter TX mode
   writeRegister(REG_OP_MODE_7X, MODE_LONG_RANGE_MODE_7X | MODE_TX_7X);
+}
 
-  // Wait for TX completion
-  while ((readRegister(REG_IRQ_FLAGS_7X) & IRQ_TX_DONE_MASK_7X) == 0) {
-    yield();
+// DIO0 maps to TxDone in TX mode, the ISR may have taken the flag already
+int sx127x::pollTransmit() {
+  if (!_transmitting) { return 1; }
+  if (!_tx_done && (readRegister(REG_IRQ_FLAGS_7X) & IRQ_TX_DONE_MASK_7X) != 0) {
+    // Clear TX complete IRQ
+    writeRegister(REG_IRQ_FLAGS_7X, IRQ_TX_DONE_MASK_7X);
+    _tx_done = true;
   }
-
-  // Clear TX complete IRQ
-  writeRegister(REG_IRQ_FLAGS_7X, IRQ_TX_DONE_MASK_7X);
-  return 1;
+  if (_tx_done) { _transmitting = false; return 1; }
+  if (millis() - _tx_started >= (uint32_t)LORA_MODEM_TIMEOUT_MS) { _transmitting = false; return -1; }
+  return 0;
 }
 
 bool sx127x::dcd() {
@@ -293,6 +307,25 @@ int ISR_VECT sx127x::read() {
   return readRegister(REG_FIFO_7X);
 }
 
+// Read the next size bytes of the received packet in one burst.
+// The FIFO address pointer advances with every byte clocked out.
+size_t ISR_VECT sx127x::readPayload(uint8_t* buffer, size_t size) {
+  int remaining = available();
+  if (remaining <= 0) { return 0; }
+  if (size > (size_t)remaining) { size = remaining; }
+
+  digitalWrite(_ss, LOW);
+  SPI.beginTransaction(_spiSettings);
+  SPI.transfer(REG_FIFO_7X & 0x7f);
+  memset(buffer, 0x00, size);
+  SPI.transfer(buffer, size);
+  SPI.endTransaction();
+  digitalWrite(_ss, HIGH);
+
+  _packetIndex += size;
+  return size;
+}
+
 int sx127x::peek() {
   if (!available()) { return -1; }
 
@@ -487,6 +520,7 @@ void ISR_VECT sx127x::handleDio0Rise() {
 
   // Clear IRQs
   writeRegister(REG_IRQ_FLAGS_7X, irqFlags);
+  if ((irqFlags & IRQ_TX_DONE_MASK_7X) != 0) { _tx_done = true; return; }
   if ((irqFlags & IRQ_PAYLOAD_CRC_ERROR_MASK_7X) == 0) {
     _packetIndex = 0;
     int packetLength = _implicitHeaderMode ? readRegister(REG_PAYLOAD_LENGTH_7X) : readRegister(REG_RX_NB_BYTES_7X);
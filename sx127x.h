@@ -13,6 +13,8 @@
 #define LORA_DEFAULT_DIO0_PIN  2
 #define LORA_DEFAULT_BUSY_PIN  -1
 
+#define LORA_MODEM_TIMEOUT_MS  20E3
+
 #define PA_OUTPUT_RFO_PIN      0
 #define PA_OUTPUT_PA_BOOST_PIN 1
 
@@ -32,6 +34,11 @@ public:
 
   int beginPacket(int implicitHeader = false);
   int endPacket();
+  // Non-blocking transmit: startTransmit() puts the written packet on air,
+  // pollTransmit() returns 0 while it is on air, 1 once sent, -1 on timeout
+  void startTransmit();
+  int pollTransmit();
+  bool transmitting() { return _transmitting; }
 
   int parsePacket(int size = 0);
   int packetRssi();
@@ -53,6 +60,8 @@ public:
   virtual int peek();
   virtual void flush();
 
+  size_t readPayload(uint8_t* buffer, size_t size);
+
   void onReceive(void(*callback)(int));
 
   void receive(int size = 0);
@@ -106,6 +115,9 @@ private:
   int _packetIndex;
   int _implicitHeaderMode;
   bool _preinit_done;
+  volatile bool _tx_done;
+  bool _transmitting;
+  uint32_t _tx_started;
   void (*_onReceive)(int);
 };
 
@@ -67,7 +67,21 @@
 
 #define OP_FIFO_WRITE_8X            0x1A
 #define OP_FIFO_READ_8X             0x1B
+#define SPI_FRAME_MAX_8X            16   // opcode, parameters and status NOP of one command
 #define IRQ_PREAMBLE_DET_MASK_8X    0x80
+#define IRQ_SYNCWORD_VALID_MASK_8X  0x04
+
+#define PACKET_TYPE_GFSK_8X         0x00
+#define GFSK_MOD_INDEX_0_5_8X       0x01
+#define GFSK_BT_0_5_8X              0x20
+#define GFSK_PREAMBLE_32_BITS_8X    0x70
+#define GFSK_SYNC_WORD_4_BYTES_8X   0x06
+#define GFSK_MATCH_SYNC_WORD_1_8X   0x10
+#define GFSK_VARIABLE_LENGTH_8X     0x20
+#define GFSK_WHITENING_ON_8X        0x00
+#define REG_SYNC_WORD_1_8X          0x9CF
+#define REG_CRC_POLY_8X             0x9C6
+#define REG_CRC_INIT_8X             0x9C8
 
 #define REG_PACKET_SIZE             0x901
 #define REG_FIRM_VER_MSB            0x154
@@ -90,7 +104,8 @@ sx128x::sx128x() :
   _spiSettings(8E6, MSBFIRST, SPI_MODE0),
   _ss(LORA_DEFAULT_SS_PIN), _reset(LORA_DEFAULT_RESET_PIN), _dio0(LORA_DEFAULT_DIO0_PIN), _rxen(pin_rxen), _busy(LORA_DEFAULT_BUSY_PIN), _txen(pin_txen),
   _frequency(0), _txp(0), _sf(0x05), _bw(0x34), _cr(0x01), _packetIndex(0), _implicitHeaderMode(0), _payloadLength(255), _crcMode(0), _fifo_tx_addr_ptr(0),
-  _fifo_rx_addr_ptr(0), _rxPacketLength(0), _preinit_done(false), _tcxo(false) { setTimeout(0); }
+  _fifo_rx_addr_ptr(0), _rxPacketLength(0), _preinit_done(false), _tcxo(false), _transmitting(false), _tx_started(0),
+  _fsk_bitrate(0), _fsk_br_bw(0) { setTimeout(0); }
 
 bool ISR_VECT sx128x::getPacketValidity() {
     uint8_t buf[2];
@@ -164,19 +179,21 @@ void sx128x::writeRegister(uint16_t address, uint8_t value) { singleTransfer(OP_
 
 uint8_t ISR_VECT sx128x::singleTransfer(uint8_t opcode, uint16_t address, uint8_t value) {
     waitOnBusy();
-    uint8_t response;
-    digitalWrite(_ss, LOW);
 
+    // Opcode, address, the status NOP on reads and the value go out as
+    // one frame, a single EasyDMA transaction on nRF52
+    uint8_t frame[5] = {opcode, (uint8_t)((address & 0xFF00) >> 8), (uint8_t)(address & 0x00FF), 0x00, 0x00};
+    size_t len = 3;
+    if (opcode == OP_READ_REGISTER_8X) { len++; }
+    frame[len++] = value;
+
+    digitalWrite(_ss, LOW);
     SPI.beginTransaction(_spiSettings);
-    SPI.transfer(opcode);
-    SPI.transfer((address & 0xFF00) >> 8);
-    SPI.transfer(address & 0x00FF);
-    if (opcode == OP_READ_REGISTER_8X) { SPI.transfer(0x00); }
-    response = SPI.transfer(value);
+    SPI.transfer(frame, len);
     SPI.endTransaction();
     digitalWrite(_ss, HIGH);
 
-    return response;
+    return frame[len-1];
 }
 
 void sx128x::rxAntEnable() {
@@ -190,8 +207,32 @@ void sx128x::txAntEnable() {
 }
 
 void sx128x::loraMode() {
-    uint8_t mode = MODE_LONG_RANGE_MODE_8X;
+    uint8_t mode = _fsk_bitrate ? PACKET_TYPE_GFSK_8X : MODE_LONG_RANGE_MODE_8X;
     executeOpcode(OP_PACKET_TYPE_8X, &mode, 1);
+
+    if (_fsk_bitrate) {
+      // "RNOD" as sync word, CCITT CRC-16
+      const uint8_t sync[4] = { 0x52, 0x4E, 0x4F, 0x44 };
+      for (uint8_t i = 0; i < 4; i++) { writeRegister(REG_SYNC_WORD_1_8X + i, sync[i]); }
+      writeRegister(REG_CRC_POLY_8X, 0x10); writeRegister(REG_CRC_POLY_8X + 1, 0x21);
+      writeRegister(REG_CRC_INIT_8X, 0x1D); writeRegister(REG_CRC_INIT_8X + 1, 0x0F);
+    }
+}
+
+// Bitrate and receiver bandwidth pairs for GFSK, see SX1280 datasheet
+// v3.2, table 14-1
+void sx128x::setFskMode(uint32_t bitrate) {
+  static const struct { uint32_t bitrate; uint8_t br_bw; } rates[] = {
+    { 2000000, 0x04 }, { 1600000, 0x28 }, { 1000000, 0x4C }, { 800000, 0x70 },
+    { 500000,  0x8D }, { 400000,  0xB1 }, { 250000,  0xCE }, { 125000, 0xEF },
+  };
+  _fsk_bitrate = 0;
+  if (bitrate == 0) { return; }
+  for (uint8_t i = 0; i < sizeof(rates)/sizeof(rates[0]); i++) {
+    _fsk_bitrate = rates[i].bitrate;
+    _fsk_br_bw = rates[i].br_bw;
+    if (bitrate >= rates[i].bitrate) { break; }
+  }
 }
 
 void sx128x::waitOnBusy() {
@@ -201,34 +242,67 @@ void sx128x::waitOnBusy() {
   }
 }
 
+// Commands and their parameters are clocked as one frame rather
+// than a transfer per byte. No command takes more than 9 parameters.
 void sx128x::executeOpcode(uint8_t opcode, uint8_t *buffer, uint8_t size) {
+    uint8_t frame[SPI_FRAME_MAX_8X];
     waitOnBusy();
     digitalWrite(_ss, LOW);
     SPI.beginTransaction(_spiSettings);
-    SPI.transfer(opcode);
-    for (int i = 0; i < size; i++) { SPI.transfer(buffer[i]); }
+    if (size < sizeof(frame)) {
+        frame[0] = opcode;
+        memcpy(frame+1, buffer, size);
+        SPI.transfer(frame, size+1);
+    } else {
+        SPI.transfer(opcode);
+        writeBurst(buffer, size);
+    }
     SPI.endTransaction();
     digitalWrite(_ss, HIGH);
 }
 
 void sx128x::executeOpcodeRead(uint8_t opcode, uint8_t *buffer, uint8_t size) {
+    uint8_t frame[SPI_FRAME_MAX_8X];
     waitOnBusy();
     digitalWrite(_ss, LOW);
     SPI.beginTransaction(_spiSettings);
-    SPI.transfer(opcode);
-    SPI.transfer(0x00);
-    for (int i = 0; i < size; i++) { buffer[i] = SPI.transfer(0x00); }
+    if (size < sizeof(frame)-1) {
+        // Opcode and status NOP, then NOPs while the response is read
+        memset(frame, 0x00, size+2);
+        frame[0] = opcode;
+        SPI.transfer(frame, size+2);
+        memcpy(buffer, frame+2, size);
+    } else {
+        SPI.transfer(opcode);
+        SPI.transfer(0x00);
+        memset(buffer, 0x00, size);
+        SPI.transfer(buffer, size);
+    }
     SPI.endTransaction();
     digitalWrite(_ss, HIGH);
 }
 
+// Clocks out a buffer in one burst under the current CS assertion,
+// a single EasyDMA transfer on nRF52
+void sx128x::writeBurst(const uint8_t* buffer, size_t size) {
+    #if MCU_VARIANT == MCU_ESP32
+      SPI.writeBytes(buffer, size);
+    #elif MCU_VARIANT == MCU_NRF52
+      SPI.transfer(buffer, NULL, size);
+    #else
+      for (int i = 0; i < size; i++) { SPI.transfer(buffer[i]); }
+    #endif
+}
+
 void sx128x::writeBuffer(const uint8_t* buffer, size_t size) {
     waitOnBusy();
     digitalWrite(_ss, LOW);
     SPI.beginTransaction(_spiSettings);
-    SPI.transfer(OP_FIFO_WRITE_8X);
-    SPI.transfer(_fifo_tx_addr_ptr);
-    for (int i = 0; i < size; i++) { SPI.transfer(buffer[i]); _fifo_tx_addr_ptr++; }
+    uint8_t header[2] = {OP_FIFO_WRITE_8X, _fifo_tx_addr_ptr};
+    SPI.transfer(header, sizeof(header));
+    // The whole fragment goes out in one burst under a single CS assertion
+    writeBurst(buffer, size);
+    _fifo_tx_addr_ptr += size;
     SPI.endTransaction();
     digitalWrite(_ss, HIGH);
 }
@@ -237,10 +311,11 @@ void sx128x::readBuffer(uint8_t* buffer, size_t size) {
     waitOnBusy();
     digitalWrite(_ss, LOW);
     SPI.beginTransaction(_spiSettings);
-    SPI.transfer(OP_FIFO_READ_8X);
-    SPI.transfer(_fifo_rx_addr_ptr);
-    SPI.transfer(0x00);
-    for (int i = 0; i < size; i++) { buffer[i] = SPI.transfer(0x00); }
+    uint8_t header[3] = {OP_FIFO_READ_8X, _fifo_rx_addr_ptr, 0x00};
+    SPI.transfer(header, sizeof(header));
+    // Clock the whole payload in one burst, NOPs go out while it is read
+    memset(buffer, 0x00, size);
+    SPI.transfer(buffer, size);
     SPI.endTransaction();
     digitalWrite(_ss, HIGH);
 }
@@ -249,6 +324,14 @@ void sx128x::setModulationParams(uint8_t sf, uint8_t bw, uint8_t cr) {
   // because there is no access to these registers on the sx1280, we have
   // to set all these parameters at once or not at all.
   uint8_t buf[3];
+  if (_fsk_bitrate) {
+    buf[0] = _fsk_br_bw;
+    buf[1] = GFSK_MOD_INDEX_0_5_8X;
+    buf[2] = GFSK_BT_0_5_8X;
+    executeOpcode(OP_MODULATION_PARAMS_8X, buf, 3);
+    return;
+  }
+
   buf[0] = sf << 4;
   buf[1] = bw;
   buf[2] = cr;
@@ -265,6 +348,20 @@ uint8_t preamble_m = 0;
 uint32_t last_me_result_target = 0;
 extern long lora_preamble_symbols;
 void sx128x::setPacketParams(uint32_t target_preamble_symbols, uint8_t headermode, uint8_t payload_length, uint8_t crc) {  
+  if (_fsk_bitrate) {
+    // Fixed 32 bit preamble, the LoRa preamble settings don't apply
+    uint8_t buf[7];
+    buf[0] = GFSK_PREAMBLE_32_BITS_8X;
+    buf[1] = GFSK_SYNC_WORD_4_BYTES_8X;
+    buf[2] = GFSK_MATCH_SYNC_WORD_1_8X;
+    buf[3] = GFSK_VARIABLE_LENGTH_8X;
+    buf[4] = payload_length;
+    buf[5] = crc;   // 0x20 is a 2 byte CRC in both modes
+    buf[6] = GFSK_WHITENING_ON_8X;
+    executeOpcode(OP_PACKET_PARAMS_8X, buf, 7);
+    return;
+  }
+
   if (last_me_result_target != target_preamble_symbols) {
     // Calculate exponent and mantissa values for modem
     if (target_preamble_symbols >= 0xF000) target_preamble_symbols = 0xF000;
@@ -367,38 +464,39 @@ int sx128x::beginPacket(int implicitHeader) {
 }
 
 int sx128x::endPacket() {
+  startTransmit();
+  int result;
+  while ((result = pollTransmit()) == 0) { yield(); }
+  return result > 0 ? 1 : 0;
+}
+
+void sx128x::startTransmit() {
   setPacketParams(_preambleLength, _implicitHeaderMode, _payloadLength, _crcMode);
   txAntEnable();
+  _transmitting = true;
+  _tx_started = millis();
 
   // Put in single TX mode
   uint8_t timeout[3] = {0};
   executeOpcode(OP_TX_8X, timeout, 3);
+}
 
-  uint8_t buf[2];
-  buf[0] = 0x00;
-  buf[1] = 0x00;
+// TxDone is not routed to a DIO pin here, one status read per call
+int sx128x::pollTransmit() {
+  if (!_transmitting) { return 1; }
+  uint8_t buf[2] = {0};
   executeOpcodeRead(OP_GET_IRQ_STATUS_8X, buf, 2);
-
-  // Wait for TX done
-  bool timed_out = false;
-  uint32_t w_timeout = millis()+LORA_MODEM_TIMEOUT_MS;
-  while ((millis() < w_timeout) && ((buf[1] & IRQ_TX_DONE_MASK_8X) == 0)) {
-    buf[0] = 0x00;
-    buf[1] = 0x00;
-    executeOpcodeRead(OP_GET_IRQ_STATUS_8X, buf, 2);
-    yield();
-  }
-
-  if (!(millis() < w_timeout)) { timed_out = true; }
+  bool done = (buf[1] & IRQ_TX_DONE_MASK_8X) != 0;
+  bool timed_out = !done && millis() - _tx_started >= (uint32_t)LORA_MODEM_TIMEOUT_MS;
+  if (!done && !timed_out) { return 0; }
 
   // clear IRQ's
   uint8_t mask[2];
   mask[0] = 0x00;
   mask[1] = IRQ_TX_DONE_MASK_8X;
   executeOpcode(OP_CLEAR_IRQ_STATUS_8X, mask, 2);
-  
-  if (timed_out) { return 0; }
-  else           { return 1; }
+  _transmitting = false;
+  return done ? 1 : -1;
 }
 
 unsigned long preamble_detected_at = 0;
@@ -412,7 +510,9 @@ bool sx128x::dcd() {
   bool header_detected = false;
   bool carrier_detected = false;
 
-  if ((buf[1] & IRQ_HEADER_DET_MASK_8X) != 0) { header_detected = true; carrier_detected = true; }
+  // A valid sync word plays the part of the LoRa header in GFSK mode
+  uint8_t header_mask = _fsk_bitrate ? IRQ_SYNCWORD_VALID_MASK_8X : IRQ_HEADER_DET_MASK_8X;
+  if ((buf[1] & header_mask) != 0) { header_detected = true; carrier_detected = true; }
   else { header_detected = false; }
 
   if ((buf[0] & IRQ_PREAMBLE_DET_MASK_8X) != 0) {
@@ -449,24 +549,27 @@ int ISR_VECT sx128x::currentRssi() {
 uint8_t sx128x::packetRssiRaw() {
     uint8_t buf[5] = {0};
     executeOpcodeRead(OP_PACKET_STATUS_8X, buf, 5);
-    return buf[0];
+    return _fsk_bitrate ? buf[1] : buf[0];
 }
 
 int ISR_VECT sx128x::packetRssi(uint8_t pkt_snr_raw) {
     // TODO: May need more calculations here
     uint8_t buf[5] = {0};
     executeOpcodeRead(OP_PACKET_STATUS_8X, buf, 5);
-    int pkt_rssi = -buf[0] / 2;
+    // GFSK reports the RSSI at sync word detection in the second byte
+    int pkt_rssi = -(_fsk_bitrate ? buf[1] : buf[0]) / 2;
     return pkt_rssi;
 }
 
 uint8_t ISR_VECT sx128x::packetSnrRaw() {
+    if (_fsk_bitrate) { return 0; }   // No SNR estimate outside LoRa
     uint8_t buf[5] = {0};
     executeOpcodeRead(OP_PACKET_STATUS_8X, buf, 5);
     return buf[1];
 }
 
 float ISR_VECT sx128x::packetSnr() {
+    if (_fsk_bitrate) { return 0.0; }
     uint8_t buf[5] = {0};
     executeOpcodeRead(OP_PACKET_STATUS_8X, buf, 5);
     return float(buf[1]) * 0.25;
@@ -490,31 +593,41 @@ size_t sx128x::write(const uint8_t *buffer, size_t size) {
 }
 
 int ISR_VECT sx128x::read() {
-  if (!available()) { return -1; }
+  uint8_t byte;
+  if (readPayload(&byte, 1) != 1) { return -1; }
+  return byte;
+}
+
+// Copy the next size bytes of the received packet into buffer. The
+// packet is fetched from the modem FIFO in one burst on the first read.
+size_t ISR_VECT sx128x::readPayload(uint8_t* buffer, size_t size) {
+  int remaining = available();
+  if (remaining <= 0) { return 0; }
+  if (size > (size_t)remaining) { size = remaining; }
 
   // If received new packet
   if (_packetIndex == 0) {
     uint8_t rxbuf[2] = {0};
     executeOpcodeRead(OP_RX_BUFFER_STATUS_8X, rxbuf, 2);
-    int size;
+    int pkt_size;
     
     // If implicit header mode is enabled, read packet length as payload length instead.
     // See SX1280 datasheet v3.2, page 92
     if (_implicitHeaderMode == 0x80) {
-      size = _payloadLength;
+      pkt_size = _payloadLength;
     } else {
-      size = rxbuf[0];
+      pkt_size = rxbuf[0];
     }
 
     _fifo_rx_addr_ptr = rxbuf[1];
-    if (size > 255) { size = 255; }
+    if (pkt_size > 255) { pkt_size = 255; }
 
-    readBuffer(_packet, size);
+    readBuffer(_packet, pkt_size);
   }
 
-  uint8_t byte = _packet[_packetIndex];
-  _packetIndex++;
-  return byte;
+  memcpy(buffer, _packet + _packetIndex, size);
+  _packetIndex += size;
+  return size;
 }
 
 int sx128x::peek() {
@@ -29,6 +29,11 @@ public:
 
   int beginPacket(int implicitHeader = false);
   int endPacket();
+  // Non-blocking transmit: startTransmit() puts the written packet on air,
+  // pollTransmit() returns 0 while it is on air, 1 once sent, -1 on timeout
+  void startTransmit();
+  int pollTransmit();
+  bool transmitting() { return _transmitting; }
 
   int parsePacket(int size = 0);
   int packetRssi();
@@ -69,6 +74,11 @@ public:
   uint8_t getCodingRate4();
   void setPreambleLength(long preamble_symbols);
   void setSyncWord(int sw);
+  // High-speed GFSK instead of LoRa, bitrate in bits/s, 0 for LoRa.
+  // Set before begin(); SF, bandwidth and coding rate are kept for a
+  // later switch back but have no effect while GFSK is selected.
+  void setFskMode(uint32_t bitrate);
+  uint32_t getFskBitrate() { return _fsk_bitrate; }
   bool dcd();
   void clearIRQStatus();
   void enableCrc();
@@ -83,7 +93,9 @@ public:
   void executeOpcode(uint8_t opcode, uint8_t *buffer, uint8_t size);
   void executeOpcodeRead(uint8_t opcode, uint8_t *buffer, uint8_t size);
   void writeBuffer(const uint8_t* buffer, size_t size);
+  void writeBurst(const uint8_t* buffer, size_t size);
   void readBuffer(uint8_t* buffer, size_t size);
+  size_t readPayload(uint8_t* buffer, size_t size);
   void setPacketParams(uint32_t target_preamble_symbols, uint8_t headermode, uint8_t payload_length, uint8_t crc);
   void setModulationParams(uint8_t sf, uint8_t bw, uint8_t cr);
 
@@ -138,6 +150,10 @@ private:
   bool _radio_online;
   int _rxPacketLength;
   uint32_t _bitrate;
+  bool _transmitting;
+  uint32_t _tx_started;
+  uint32_t _fsk_bitrate;
+  uint8_t _fsk_br_bw;
   void (*_receive_callback)(int);
 };
 
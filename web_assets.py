@@ -0,0 +1,79 @@
+# Copyright (C) 2026, Boundary Mode Extension
+# Based on microReticulum_Firmware by Mark Qvist
+#
+# web_assets.py — Compresses the pages in Web/ into WebAssetsData.h.
+#
+# Every file is gzipped (with a zero timestamp, so the output only
+# changes when a page does) and written as a flash array together with
+# its content type and an ETag taken from the compressed bytes. Runs as
+# a PlatformIO pre: script of the boundary builds, or by hand:
+#
+#   python web_assets.py
+#
+# WebAssetsData.h is checked in so builds without PlatformIO (arduino-cli)
+# have it too; it is only rewritten when its content changes.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+
+import gzip
+import hashlib
+import os
+
+CONTENT_TYPES = {
+    ".html": "text/html",
+    ".css":  "text/css",
+    ".js":   "application/javascript",
+    ".json": "application/json",
+    ".svg":  "image/svg+xml",
+    ".ico":  "image/x-icon",
+}
+
+try:
+    Import("env")
+    ROOT = env.subst("$PROJECT_DIR")
+except NameError:
+    ROOT = os.path.dirname(os.path.abspath(__file__))
+
+SOURCE_DIR = os.path.join(ROOT, "Web")
+OUTPUT = os.path.join(ROOT, "WebAssetsData.h")
+
+def symbol(name):
+    return "WEB_" + "".join(c.upper() if c.isalnum() else "_" for c in name)
+
+def generate():
+    names = sorted(n for n in os.listdir(SOURCE_DIR) if os.path.splitext(n)[1] in CONTENT_TYPES)
+    out = []
+    out.append("// Generated by web_assets.py from the files in Web/, do not edit.\n")
+    out.append("#pragma once\n\n")
+    table = []
+    for name in names:
+        with open(os.path.join(SOURCE_DIR, name), "rb") as f:
+            raw = f.read()
+        packed = gzip.compress(raw, compresslevel=9, mtime=0)
+        etag = hashlib.sha256(packed).hexdigest()[:16]
+        sym = symbol(name)
+        out.append("// %s, %d bytes, %d gzipped\n" % (name, len(raw), len(packed)))
+        out.append("static const uint8_t %s[] PROGMEM = {\n" % sym)
+        for i in range(0, len(packed), 16):
+            out.append("    " + ", ".join("0x%02x" % b for b in packed[i:i+16]) + ",\n")
+        out.append("};\n\n")
+        table.append('    { "/%s", "%s", %s, sizeof(%s), "\\"%s\\"" },\n' %
+                     (name, CONTENT_TYPES[os.path.splitext(name)[1]], sym, sym, etag))
+    out.append("static const WebAsset WEB_ASSETS[] = {\n")
+    out.extend(table)
+    out.append("};\n")
+    out.append("static const uint8_t WEB_ASSET_COUNT = sizeof(WEB_ASSETS) / sizeof(WEB_ASSETS[0]);\n")
+    text = "".join(out)
+
+    if os.path.exists(OUTPUT):
+        with open(OUTPUT, "r") as f:
+            if f.read() == text:
+                return
+    with open(OUTPUT, "w") as f:
+        f.write(text)
+    print("web_assets: wrote %s (%d assets)" % (OUTPUT, len(names)))
+
+generate()